@@ -29,8 +29,12 @@ list (APPEND MAIN_SOURCE_FILES
   opm/autodiff/VFPProdProperties.cpp
   opm/autodiff/VFPInjProperties.cpp
   opm/autodiff/MissingFeatures.cpp
+  opm/autodiff/WellStateFullyImplicitBlackoil.cpp
   opm/core/props/rock/RockFromDeck.cpp
   opm/core/props/satfunc/RelpermDiagnostics.cpp
+  opm/core/simulator/PerformanceComparison.cpp
+  opm/core/simulator/PerformanceReport.cpp
+  opm/core/simulator/ScalingStudy.cpp
   opm/core/simulator/SimulatorReport.cpp
   opm/core/wells/InjectionSpecification.cpp
   opm/core/wells/ProductionSpecification.cpp
@@ -41,7 +45,9 @@ list (APPEND MAIN_SOURCE_FILES
   opm/core/wells/wells.c
   opm/simulators/WellSwitchingLogger.cpp
   opm/simulators/DeferredLogger.cpp
+  opm/simulators/GatheringLog.cpp
   opm/simulators/timestepping/TimeStepControl.cpp
+  opm/simulators/timestepping/ConvergenceRiskPredictor.cpp
   opm/simulators/timestepping/AdaptiveSimulatorTimer.cpp
   opm/simulators/timestepping/SimulatorTimer.cpp
   opm/simulators/timestepping/gatherConvergenceReport.cpp
@@ -55,12 +61,47 @@ list (APPEND TEST_SOURCE_FILES
   tests/test_graphcoloring.cpp
   tests/test_vfpproperties.cpp
   tests/test_milu.cpp
+  tests/test_pressuresolverbackend.cpp
   tests/test_multmatrixtransposed.cpp
   tests/test_wellmodel.cpp
   tests/test_wellswitchlogger.cpp
   tests/test_deferredlogger.cpp
   tests/test_timer.cpp
   tests/test_invert.cpp
+  tests/test_condensedwellsystem.cpp
+  tests/test_paddedevaluation.cpp
+  tests/test_fusedbicgstab.cpp
+  tests/test_quasiimpesoperator.cpp
+  tests/test_amgsmoothers.cpp
+  tests/test_recyclinggcr.cpp
+  tests/test_restrictedadditiveschwarz.cpp
+  tests/test_blockcsrmatrix.cpp
+  tests/test_partitionedpreconditioner.cpp
+  tests/test_linearsolverautotuner.cpp
+  tests/test_linearsolverfallback.cpp
+  tests/test_ensemblesolver.cpp
+  tests/test_sparsedirectsolver.cpp
+  tests/test_activesubdomain.cpp
+  tests/test_graphpartition.cpp
+  tests/test_loadimbalancemonitor.cpp
+  tests/test_processtimingstatistics.cpp
+  tests/test_performancereport.cpp
+  tests/test_scalingstudy.cpp
+  tests/test_amghierarchystatistics.cpp
+  tests/test_memoryregistry.cpp
+  tests/test_tracerecorder.cpp
+  tests/test_sequentialsplitting.cpp
+  tests/test_newtontrace.cpp
+  tests/test_convergencehotspots.cpp
+  tests/test_andersonacceleration.cpp
+  tests/test_adaptiveimplicit.cpp
+  tests/test_equationscaling.cpp
+  tests/test_wellworkcost.cpp
+  tests/test_cartesiancellindexmap.cpp
+  tests/test_segmenttreesolver.cpp
+  tests/test_timestepcontrol.cpp
+  tests/test_parareal.cpp
+  tests/test_linearsystemio.cpp
   tests/test_wells.cpp
   tests/test_wellsmanager.cpp
   tests/test_wellcontrols.cpp
@@ -120,14 +161,50 @@ list (APPEND PUBLIC_HEADER_FILES
   opm/autodiff/ISTLSolverEbos.hpp
   opm/autodiff/IterationReport.hpp
   opm/autodiff/MatrixBlock.hpp
+  opm/autodiff/MixedPrecisionPreconditioner.hpp
   opm/autodiff/moduleVersion.hpp
   opm/autodiff/MPIUtilities.hpp
   opm/autodiff/NonlinearSolverEbos.hpp
+  opm/autodiff/NonlinearSolverDomainDecompositionEbos.hpp
+  opm/autodiff/PackedWellContributions.hpp
   opm/autodiff/ParallelOverlappingILU0.hpp
   opm/autodiff/ParallelRestrictedAdditiveSchwarz.hpp
+  opm/autodiff/RestrictedAdditiveSchwarz.hpp
   opm/autodiff/RateConverter.hpp
   opm/autodiff/SimFIBODetails.hpp
   opm/autodiff/SimulatorFullyImplicitBlackoilEbos.hpp
+  opm/autodiff/MemoryRegistry.hpp
+  opm/autodiff/TimingRegistry.hpp
+  opm/autodiff/TraceRecorder.hpp
+  opm/autodiff/ProfilingMarkers.hpp
+  opm/autodiff/LinearSystemIO.hpp
+  opm/autodiff/PressureSolverBackend.hpp
+  opm/autodiff/FusedBiCGSTABSolver.hpp
+  opm/autodiff/AmgHierarchyStatistics.hpp
+  opm/autodiff/AmgSmoothers.hpp
+  opm/autodiff/RecyclingGCRSolver.hpp
+  opm/autodiff/AsyncHaloExchange.hpp
+  opm/autodiff/ReductionBatch.hpp
+  opm/autodiff/BlockCSRMatrix.hpp
+  opm/autodiff/PartitionedPreconditioner.hpp
+  opm/autodiff/LinearSolverAutoTuner.hpp
+  opm/autodiff/LinearSolverFallback.hpp
+  opm/autodiff/EnsembleSolver.hpp
+  opm/autodiff/SparseDirectSolver.hpp
+  opm/autodiff/ActiveSubdomain.hpp
+  opm/autodiff/GraphPartition.hpp
+  opm/autodiff/LoadImbalanceMonitor.hpp
+  opm/autodiff/ProcessTimingStatistics.hpp
+  opm/autodiff/SequentialSplitting.hpp
+  opm/autodiff/NewtonTrace.hpp
+  opm/autodiff/ConvergenceHotSpots.hpp
+  opm/autodiff/AndersonAcceleration.hpp
+  opm/autodiff/AdaptiveImplicit.hpp
+  opm/autodiff/EquationScaling.hpp
+  opm/autodiff/WellWorkCost.hpp
+  opm/autodiff/CartesianCellIndexMap.hpp
+  opm/autodiff/ActivePhases.hpp
+  opm/autodiff/SegmentTreeSolver.hpp
   opm/autodiff/WellConnectionAuxiliaryModule.hpp
   opm/autodiff/WellStateFullyImplicitBlackoil.hpp
   opm/autodiff/VFPProperties.hpp
@@ -143,6 +220,8 @@ list (APPEND PUBLIC_HEADER_FILES
   opm/autodiff/MultisegmentWell_impl.hpp
   opm/autodiff/StandardWellV.hpp
   opm/autodiff/StandardWellV_impl.hpp
+  opm/autodiff/CondensedWellSystem.hpp
+  opm/autodiff/PaddedEvaluation.hpp
   opm/autodiff/MSWellHelpers.hpp
   opm/autodiff/BlackoilWellModel.hpp
   opm/autodiff/BlackoilWellModel_impl.hpp
@@ -153,6 +232,10 @@ list (APPEND PUBLIC_HEADER_FILES
   opm/core/props/rock/RockFromDeck.hpp
   opm/core/props/satfunc/RelpermDiagnostics.hpp
   opm/core/props/satfunc/RelpermDiagnostics_impl.hpp
+  opm/core/simulator/BinarySerialization.hpp
+  opm/core/simulator/PerformanceComparison.hpp
+  opm/core/simulator/PerformanceReport.hpp
+  opm/core/simulator/ScalingStudy.hpp
   opm/core/simulator/SimulatorReport.hpp
   opm/core/simulator/WellState.hpp
   opm/core/well_controls.h
@@ -164,11 +247,14 @@ list (APPEND PUBLIC_HEADER_FILES
   opm/core/wells/WellsManager.hpp
   opm/core/wells/WellsManager_impl.hpp
   opm/simulators/ParallelFileMerger.hpp
+  opm/simulators/GatheringLog.hpp
   opm/simulators/WellSwitchingLogger.hpp
   opm/simulators/DeferredLogger.hpp
   opm/simulators/timestepping/AdaptiveSimulatorTimer.hpp
   opm/simulators/timestepping/AdaptiveTimeSteppingEbos.hpp
   opm/simulators/timestepping/ConvergenceReport.hpp
+  opm/simulators/timestepping/ConvergenceRiskPredictor.hpp
+  opm/simulators/timestepping/Parareal.hpp
   opm/simulators/timestepping/TimeStepControl.hpp
   opm/simulators/timestepping/TimeStepControlInterface.hpp
   opm/simulators/timestepping/SimulatorTimer.hpp
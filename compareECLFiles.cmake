@@ -132,6 +132,42 @@ function(add_test_compare_parallel_restarted_simulation)
                TEST_ARGS ${TEST_ARGS})
 endfunction()
 
+###########################################################################
+# TEST: add_test_comparePerformance
+###########################################################################
+
+# Input:
+#   - casename: basename (no extension)
+#
+# Details:
+#   - This test class compares the iterations and the calibrated times of
+#     the performance report of a simulation to a reference report. The
+#     tests are labelled as performance and run serially, as the times
+#     would suffer from concurrent tests.
+function(add_test_comparePerformance)
+  set(oneValueArgs CASENAME FILENAME SIMULATOR ITERATION_BUDGET TIME_BUDGET DIR)
+  set(multiValueArgs TEST_ARGS)
+  cmake_parse_arguments(PARAM "$" "${oneValueArgs}" "${multiValueArgs}" ${ARGN} )
+  if(NOT PARAM_DIR)
+    set(PARAM_DIR ${PARAM_CASENAME})
+  endif()
+  set(RESULT_PATH ${BASE_RESULT_PATH}/performance/${PARAM_SIMULATOR}+${PARAM_CASENAME})
+  set(TEST_ARGS ${OPM_TESTS_ROOT}/${PARAM_DIR}/${PARAM_FILENAME} ${PARAM_TEST_ARGS})
+  set(TEST_NAME comparePerformance_${PARAM_SIMULATOR}+${PARAM_FILENAME})
+  opm_add_test(${TEST_NAME} NO_COMPILE
+               EXE_NAME ${PARAM_SIMULATOR}
+               DRIVER_ARGS ${OPM_TESTS_ROOT}/${PARAM_DIR} ${RESULT_PATH}
+                           ${PROJECT_BINARY_DIR}/bin
+                           ${PARAM_FILENAME}
+                           ${PARAM_ITERATION_BUDGET} ${PARAM_TIME_BUDGET}
+                           ${PROJECT_BINARY_DIR}/bin/compare_performance
+               TEST_ARGS ${TEST_ARGS})
+  set_tests_properties(${TEST_NAME} PROPERTIES
+                       LABELS performance
+                       RUN_SERIAL TRUE
+                       SKIP_RETURN_CODE 77)
+endfunction()
+
 if(NOT TARGET test-suite)
   add_custom_target(test-suite)
 endif()
@@ -331,6 +367,45 @@ add_test_compareECLFiles(CASENAME norne
                          PREFIX compareECLInitFiles
                          DIR_PREFIX /init)
 
+# Performance tests, run by ctest -L performance
+opm_set_test_driver(${PROJECT_SOURCE_DIR}/tests/run-performanceTest.sh "")
+
+# The budgets of the iterations and of the times relative to the calibration kernel
+set(iteration_budget 0.1)
+set(time_budget 0.25)
+
+add_test_comparePerformance(CASENAME spe1
+                            FILENAME SPE1CASE2
+                            SIMULATOR flow
+                            ITERATION_BUDGET ${iteration_budget}
+                            TIME_BUDGET ${time_budget})
+
+add_test_comparePerformance(CASENAME spe9
+                            FILENAME SPE9_CP_SHORT
+                            SIMULATOR flow
+                            ITERATION_BUDGET ${iteration_budget}
+                            TIME_BUDGET ${time_budget})
+
+add_test_comparePerformance(CASENAME msw_3d_hfa
+                            FILENAME 3D_MSW
+                            SIMULATOR flow
+                            ITERATION_BUDGET ${iteration_budget}
+                            TIME_BUDGET ${time_budget}
+                            TEST_ARGS --use-multisegment-well=true)
+
+add_test_comparePerformance(CASENAME polymer_simple2D
+                            FILENAME 2D_THREEPHASE_POLY_HETER
+                            SIMULATOR flow
+                            ITERATION_BUDGET ${iteration_budget}
+                            TIME_BUDGET ${time_budget}
+                            TEST_ARGS --flow-newton-max-iterations=20)
+
+add_test_comparePerformance(CASENAME norne
+                            FILENAME NORNE_ATW2013
+                            SIMULATOR flow
+                            ITERATION_BUDGET ${iteration_budget}
+                            TIME_BUDGET ${time_budget})
+
 # Parallel tests
 if(MPI_FOUND)
   opm_set_test_driver(${PROJECT_SOURCE_DIR}/tests/run-restart-regressionTest.sh "")
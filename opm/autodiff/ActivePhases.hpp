@@ -0,0 +1,56 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_ACTIVEPHASES_HEADER_INCLUDED
+#define OPM_ACTIVEPHASES_HEADER_INCLUDED
+
+namespace Opm
+{
+
+/// \brief The active phases of a model, as far as they are known at compile time.
+///
+/// The indices of the two-phase models do not have the primary variables and
+/// equations of one phase, which hence is never active. isActive() returns
+/// false for such a phase without asking the fluid system, such that the
+/// branches of the inactive phase vanish from loops over the phases.
+template <class FluidSystem, class Indices>
+struct ActivePhases
+{
+    static const bool waterEnabled = Indices::waterEnabled;
+    static const bool oilEnabled = Indices::oilEnabled;
+    static const bool gasEnabled = Indices::gasEnabled;
+
+    /// \brief Whether the indices of the model have a phase.
+    static constexpr bool enabled(const unsigned phaseIdx)
+    {
+        return phaseIdx == FluidSystem::waterPhaseIdx ? waterEnabled
+            : (phaseIdx == FluidSystem::oilPhaseIdx ? oilEnabled : gasEnabled);
+    }
+
+    /// \brief Whether a phase is active, FluidSystem::phaseIsActive() for the
+    ///        phases that the indices of the model have.
+    static bool isActive(const unsigned phaseIdx)
+    {
+        return enabled(phaseIdx) && FluidSystem::phaseIsActive(phaseIdx);
+    }
+};
+
+} // namespace Opm
+
+#endif // OPM_ACTIVEPHASES_HEADER_INCLUDED
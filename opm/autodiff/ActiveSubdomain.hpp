@@ -0,0 +1,285 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_ACTIVESUBDOMAIN_HEADER_INCLUDED
+#define OPM_ACTIVESUBDOMAIN_HEADER_INCLUDED
+
+#include <opm/common/ErrorMacros.hpp>
+
+#include <opm/common/utility/platform_dependent/disable_warnings.h>
+#include <dune/common/version.hh>
+#include <dune/istl/operators.hh>
+#include <dune/istl/solvercategory.hh>
+#include <opm/common/utility/platform_dependent/reenable_warnings.h>
+
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+namespace Opm
+{
+
+/// \brief The rows and columns of a matrix belonging to a set of active cells.
+///
+/// The active set is given by a mask of seed cells, which is grown by a
+/// number of layers of neighbours in the sparsity pattern of the matrix.
+/// The submatrix couples the active cells only, i.e. the unknowns of the
+/// inactive cells are frozen at a zero update.
+/// \tparam Matrix The type of the (sequential) matrix.
+template<class Matrix>
+class ActiveSubdomain
+{
+public:
+    /// \brief Determine the active cells and extract the submatrix.
+    /// \param A The full matrix. Its sparsity pattern has to be symmetric.
+    /// \param seeds Nonzero for the cells that are active in any case.
+    /// \param haloLayers The number of layers of neighbours added to the seeds.
+    void setup(const Matrix& A, std::vector<char> seeds, int haloLayers)
+    {
+        if ( seeds.size() != A.N() )
+        {
+            OPM_THROW(std::logic_error, "The mask of the active cells does not match the matrix");
+        }
+        for ( int layer = 0; layer < haloLayers; ++layer )
+        {
+            std::vector<char> grown = seeds;
+            for ( auto row = A.begin(), rowEnd = A.end(); row != rowEnd; ++row )
+            {
+                if ( !seeds[row.index()] )
+                {
+                    continue;
+                }
+                for ( auto col = row->begin(), colEnd = row->end(); col != colEnd; ++col )
+                {
+                    grown[col.index()] = 1;
+                }
+            }
+            seeds.swap(grown);
+        }
+
+        local_.assign(A.N(), -1);
+        cells_.clear();
+        for ( std::size_t i = 0; i < seeds.size(); ++i )
+        {
+            if ( seeds[i] )
+            {
+                local_[i] = cells_.size();
+                cells_.push_back(i);
+            }
+        }
+
+        std::size_t nonzeroes = 0;
+        for ( const auto cell : cells_ )
+        {
+            const auto& row = A[cell];
+            for ( auto col = row.begin(), colEnd = row.end(); col != colEnd; ++col )
+            {
+                nonzeroes += local_[col.index()] >= 0;
+            }
+        }
+
+        matrix_ = Matrix();
+        matrix_.setSize(cells_.size(), cells_.size(), nonzeroes);
+        matrix_.setBuildMode(Matrix::row_wise);
+        std::size_t localRow = 0;
+        for ( auto row = matrix_.createbegin(), rowEnd = matrix_.createend(); row != rowEnd; ++row, ++localRow )
+        {
+            const auto& fromRow = A[cells_[localRow]];
+            for ( auto col = fromRow.begin(), colEnd = fromRow.end(); col != colEnd; ++col )
+            {
+                if ( local_[col.index()] >= 0 )
+                {
+                    row.insert(local_[col.index()]);
+                }
+            }
+        }
+        copyValues(A);
+    }
+
+    /// \brief Copy the entries of the active rows and columns of A.
+    void copyValues(const Matrix& A)
+    {
+        for ( std::size_t i = 0; i < cells_.size(); ++i )
+        {
+            const auto& fromRow = A[cells_[i]];
+            auto& toRow = matrix_[i];
+            for ( auto col = fromRow.begin(), colEnd = fromRow.end(); col != colEnd; ++col )
+            {
+                if ( local_[col.index()] >= 0 )
+                {
+                    toRow[local_[col.index()]] = *col;
+                }
+            }
+        }
+    }
+
+    /// \brief The number of active cells.
+    std::size_t size() const
+    {
+        return cells_.size();
+    }
+
+    /// \brief The number of cells of the full matrix.
+    std::size_t fullSize() const
+    {
+        return local_.size();
+    }
+
+    /// \brief The indices of the active cells in the full matrix, in increasing order.
+    const std::vector<std::size_t>& cells() const
+    {
+        return cells_;
+    }
+
+    /// \brief Whether a cell of the full matrix is active.
+    bool active(std::size_t cell) const
+    {
+        return local_[cell] >= 0;
+    }
+
+    /// \brief The submatrix of the active cells.
+    const Matrix& matrix() const
+    {
+        return matrix_;
+    }
+
+    /// \brief Copy the entries of the active cells of a full vector.
+    template<class V>
+    void restrict(const V& full, V& sub) const
+    {
+        sub.resize(cells_.size());
+        for ( std::size_t i = 0; i < cells_.size(); ++i )
+        {
+            sub[i] = full[cells_[i]];
+        }
+    }
+
+    /// \brief Copy a vector of the active cells to a full vector.
+    ///
+    /// The entries of the inactive cells are set to zero.
+    template<class V>
+    void prolongate(const V& sub, V& full) const
+    {
+        full.resize(local_.size());
+        full = 0.0;
+        for ( std::size_t i = 0; i < cells_.size(); ++i )
+        {
+            full[cells_[i]] = sub[i];
+        }
+    }
+
+private:
+    std::vector<int> local_;
+    std::vector<std::size_t> cells_;
+    Matrix matrix_;
+};
+
+/// \brief The operator of the system restricted to an active subdomain.
+///
+/// Applies the submatrix and, if given, the well contributions that are not
+/// part of the matrix. The latter are applied to full vectors holding the
+/// active entries only, hence all perforated cells have to be active.
+/// \tparam Matrix The type of the (sequential) matrix.
+/// \tparam X The type of the domain and the range.
+/// \tparam WellModel The type of the well model, with apply(x, Ax).
+template<class Matrix, class X, class WellModel>
+class ActiveSubdomainOperator
+    : public Dune::AssembledLinearOperator<Matrix, X, X>
+{
+public:
+    typedef Matrix matrix_type;
+    typedef X domain_type;
+    typedef X range_type;
+    typedef typename X::field_type field_type;
+
+#if DUNE_VERSION_NEWER(DUNE_ISTL, 2, 6)
+    Dune::SolverCategory::Category category() const override
+    {
+        return Dune::SolverCategory::sequential;
+    }
+#else
+    enum {
+        //! \brief The solver category.
+        category = Dune::SolverCategory::sequential
+    };
+#endif
+
+    /// \brief Constructor.
+    /// \param subdomain The active cells with their submatrix.
+    /// \param wellModel The well model or nullptr if the matrix contains the wells.
+    ActiveSubdomainOperator(const ActiveSubdomain<Matrix>& subdomain, const WellModel* wellModel)
+        : subdomain_(subdomain), wellModel_(wellModel)
+    {
+        if ( wellModel_ )
+        {
+            fullX_.resize(subdomain_.fullSize());
+            fullY_.resize(subdomain_.fullSize());
+            fullX_ = 0.0;
+            fullY_ = 0.0;
+        }
+    }
+
+    virtual void apply( const X& x, X& y ) const
+    {
+        subdomain_.matrix().mv(x, y);
+        addWells(1.0, x, y);
+    }
+
+    // y += \alpha * A * x
+    virtual void applyscaleadd (field_type alpha, const X& x, X& y) const
+    {
+        subdomain_.matrix().usmv(alpha, x, y);
+        addWells(alpha, x, y);
+    }
+
+    virtual const matrix_type& getmat() const
+    {
+        return subdomain_.matrix();
+    }
+
+private:
+    void addWells(field_type alpha, const X& x, X& y) const
+    {
+        if ( !wellModel_ )
+        {
+            return;
+        }
+        // Only the active entries of fullX_ are ever written, the others stay zero.
+        const auto& cells = subdomain_.cells();
+        for ( std::size_t i = 0; i < cells.size(); ++i )
+        {
+            fullX_[cells[i]] = x[i];
+            fullY_[cells[i]] = 0.0;
+        }
+        wellModel_->apply(fullX_, fullY_);
+        for ( std::size_t i = 0; i < cells.size(); ++i )
+        {
+            y[i].axpy(alpha, fullY_[cells[i]]);
+        }
+    }
+
+    const ActiveSubdomain<Matrix>& subdomain_;
+    const WellModel* wellModel_;
+    mutable X fullX_;
+    mutable X fullY_;
+};
+
+} // end namespace Opm
+
+#endif // OPM_ACTIVESUBDOMAIN_HEADER_INCLUDED
@@ -0,0 +1,334 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_ADAPTIVEIMPLICIT_HEADER_INCLUDED
+#define OPM_ADAPTIVEIMPLICIT_HEADER_INCLUDED
+
+#include <opm/common/ErrorMacros.hpp>
+#include <opm/common/Exceptions.hpp>
+
+#include <opm/common/utility/platform_dependent/disable_warnings.h>
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <opm/common/utility/platform_dependent/reenable_warnings.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace Opm
+{
+
+/// \brief Adaptive implicit (AIM) reduction of the Newton system.
+///
+/// In the cells selected as IMPES, the unknowns other than the pressure
+/// (saturations, ratios, ...) are lagged to the previous Newton iterate in
+/// all equations but the cell's own: their columns are dropped from the
+/// other rows. The equations of an IMPES cell are combined by weights w
+/// with D^T w = e_p (D the diagonal block), which gives a pressure equation
+/// free of the cell's other unknowns. Hence the matrix only has a pressure
+/// unknown in these cells; the rows of the other unknowns are replaced by
+/// the identity. After the solve, the other unknowns of an IMPES cell follow
+/// explicitly from its own equations with the new pressures of it and of its
+/// neighbours (recover()).
+///
+/// Only the linearization is changed, hence a converged Newton iteration
+/// still gives the fully implicit solution.
+/// \tparam Matrix The type of the (sequential) Jacobian.
+/// \tparam Vector The type of the vectors of the Jacobian.
+template<class Matrix, class Vector>
+class AdaptiveImplicitReduction
+{
+public:
+    typedef typename Vector::field_type field_type;
+    typedef typename Matrix::block_type Block;
+    static const int numEq = Vector::block_type::dimension;
+    static_assert(numEq > 1, "The adaptive implicit reduction needs more than one equation per cell");
+
+    /// \brief The throughput CFL number of each cell, estimated from the Jacobian.
+    ///
+    /// The column of a cell holds the derivatives of the accumulation and of
+    /// the fluxes with respect to its unknowns. As each flux enters the two
+    /// cells of its face with opposite signs, the column sum is the
+    /// derivative of the accumulation. The estimate is the largest ratio,
+    /// over the unknowns other than the pressure, of the derivatives of the
+    /// fluxes into the neighbours to that of the accumulation.
+    /// \param J The Jacobian, without well contributions.
+    /// \param pressureIndex The index of the pressure unknown.
+    static std::vector<double> throughputCfl(const Matrix& J, const int pressureIndex)
+    {
+        const std::size_t n = J.N();
+        std::vector<Block> columnSum(n, Block(0.0));
+        std::vector<Block> outflow(n, Block(0.0));
+        for ( auto row = J.begin(), rowEnd = J.end(); row != rowEnd; ++row )
+        {
+            for ( auto col = row->begin(), colEnd = row->end(); col != colEnd; ++col )
+            {
+                columnSum[col.index()] += *col;
+                if ( col.index() != row.index() )
+                {
+                    for ( int eq = 0; eq < numEq; ++eq )
+                    {
+                        for ( int k = 0; k < numEq; ++k )
+                        {
+                            outflow[col.index()][eq][k] += std::abs((*col)[eq][k]);
+                        }
+                    }
+                }
+            }
+        }
+
+        std::vector<double> cfl(n, 0.0);
+        for ( std::size_t i = 0; i < n; ++i )
+        {
+            for ( int k = 0; k < numEq; ++k )
+            {
+                if ( k == pressureIndex )
+                {
+                    continue;
+                }
+                double flux = 0.0;
+                double accumulation = 0.0;
+                for ( int eq = 0; eq < numEq; ++eq )
+                {
+                    flux += outflow[i][eq][k];
+                    accumulation += std::abs(columnSum[i][eq][k]);
+                }
+                if ( flux > 0.0 )
+                {
+                    cfl[i] = std::max(cfl[i], accumulation > 0.0 ? flux / accumulation
+                                                                 : std::numeric_limits<double>::max());
+                }
+            }
+        }
+        return cfl;
+    }
+
+    /// \brief Reduce the system to the pressure in the IMPES cells.
+    /// \param J The Jacobian, changed in place.
+    /// \param r The residual, changed in place.
+    /// \param impes Nonzero for the cells to treat IMPES. Cells whose diagonal
+    ///              block does not determine the weights stay implicit.
+    /// \param pressureIndex The index of the pressure unknown.
+    /// \return The number of IMPES cells.
+    std::size_t reduce(Matrix& J, Vector& r, std::vector<char> impes, const int pressureIndex)
+    {
+        if ( impes.size() != J.N() )
+        {
+            OPM_THROW(std::logic_error, "The mask of the IMPES cells does not match the matrix");
+        }
+        pressureIndex_ = pressureIndex;
+        cells_.clear();
+        weights_.clear();
+        droppedEq_.clear();
+        for ( std::size_t i = 0; i < impes.size(); ++i )
+        {
+            if ( !impes[i] )
+            {
+                continue;
+            }
+            typename Vector::block_type w(0.0);
+            typename Vector::block_type unit(0.0);
+            unit[pressureIndex] = 1.0;
+            Block diagonalT;
+            const Block& diagonal = J[i][i];
+            for ( int eq = 0; eq < numEq; ++eq )
+            {
+                for ( int k = 0; k < numEq; ++k )
+                {
+                    diagonalT[k][eq] = diagonal[eq][k];
+                }
+            }
+            try
+            {
+                diagonalT.solve(w, unit);
+            }
+            catch ( const Dune::FMatrixError& )
+            {
+                impes[i] = 0;
+                continue;
+            }
+            int dropped = 0;
+            for ( int eq = 1; eq < numEq; ++eq )
+            {
+                if ( std::abs(w[eq]) > std::abs(w[dropped]) )
+                {
+                    dropped = eq;
+                }
+            }
+            cells_.push_back(i);
+            weights_.push_back(w);
+            droppedEq_.push_back(dropped);
+        }
+
+        // lag the other unknowns of the IMPES cells in the equations of their neighbours
+        for ( auto row = J.begin(), rowEnd = J.end(); row != rowEnd; ++row )
+        {
+            for ( auto col = row->begin(), colEnd = row->end(); col != colEnd; ++col )
+            {
+                if ( col.index() == row.index() || !impes[col.index()] )
+                {
+                    continue;
+                }
+                for ( int eq = 0; eq < numEq; ++eq )
+                {
+                    for ( int k = 0; k < numEq; ++k )
+                    {
+                        if ( k != pressureIndex )
+                        {
+                            (*col)[eq][k] = 0.0;
+                        }
+                    }
+                }
+            }
+        }
+
+        // keep the rows for recover(), then replace them by the pressure equation
+        rowStart_.assign(1, 0);
+        rowColumns_.clear();
+        rowBlocks_.clear();
+        residuals_.clear();
+        for ( std::size_t c = 0; c < cells_.size(); ++c )
+        {
+            const std::size_t i = cells_[c];
+            const auto& w = weights_[c];
+            residuals_.push_back(r[i]);
+            auto& row = J[i];
+            for ( auto col = row.begin(), colEnd = row.end(); col != colEnd; ++col )
+            {
+                rowColumns_.push_back(col.index());
+                rowBlocks_.push_back(*col);
+
+                Block& block = *col;
+                typename Vector::block_type combined(0.0);
+                for ( int eq = 0; eq < numEq; ++eq )
+                {
+                    combined.axpy(w[eq], block[eq]);
+                }
+                block = 0.0;
+                if ( col.index() == i )
+                {
+                    // the identity for the other unknowns, which are computed by recover()
+                    for ( int k = 0; k < numEq; ++k )
+                    {
+                        block[k][k] = 1.0;
+                    }
+                    combined = 0.0;
+                    combined[pressureIndex] = 1.0;
+                }
+                block[pressureIndex] = combined;
+            }
+            rowStart_.push_back(rowColumns_.size());
+
+            const field_type pressureRhs = w * r[i];
+            r[i] = 0.0;
+            r[i][pressureIndex] = pressureRhs;
+        }
+        return cells_.size();
+    }
+
+    /// \brief Compute the other unknowns of the IMPES cells from their equations.
+    /// \param x The solution of the reduced system, completed in place.
+    void recover(Vector& x) const
+    {
+        typedef Dune::FieldMatrix<field_type, numEq - 1, numEq - 1> LocalMatrix;
+        typedef Dune::FieldVector<field_type, numEq - 1> LocalVector;
+        for ( std::size_t c = 0; c < cells_.size(); ++c )
+        {
+            const std::size_t i = cells_[c];
+            // the residual without the contributions of the cell's other unknowns
+            auto rhs = residuals_[c];
+            Block diagonal(0.0);
+            for ( std::size_t pos = rowStart_[c]; pos < rowStart_[c + 1]; ++pos )
+            {
+                const Block& block = rowBlocks_[pos];
+                if ( rowColumns_[pos] == i )
+                {
+                    diagonal = block;
+                    for ( int eq = 0; eq < numEq; ++eq )
+                    {
+                        rhs[eq] -= block[eq][pressureIndex_] * x[i][pressureIndex_];
+                    }
+                }
+                else
+                {
+                    block.mmv(x[rowColumns_[pos]], rhs);
+                }
+            }
+
+            LocalMatrix local;
+            LocalVector localRhs;
+            for ( int eq = 0, e = 0; eq < numEq; ++eq )
+            {
+                if ( eq == droppedEq_[c] )
+                {
+                    continue;
+                }
+                for ( int k = 0, l = 0; k < numEq; ++k )
+                {
+                    if ( k != pressureIndex_ )
+                    {
+                        local[e][l++] = diagonal[eq][k];
+                    }
+                }
+                localRhs[e++] = rhs[eq];
+            }
+            LocalVector update;
+            try
+            {
+                local.solve(update, localRhs);
+            }
+            catch ( const Dune::FMatrixError& )
+            {
+                OPM_THROW(NumericalIssue, "Singular explicit update in IMPES cell " << i);
+            }
+            for ( int k = 0, l = 0; k < numEq; ++k )
+            {
+                if ( k != pressureIndex_ )
+                {
+                    x[i][k] = update[l++];
+                }
+            }
+        }
+    }
+
+    /// \brief The IMPES cells of the last reduce().
+    const std::vector<std::size_t>& cells() const
+    {
+        return cells_;
+    }
+
+private:
+    int pressureIndex_ = 0;
+    std::vector<std::size_t> cells_;
+    std::vector<typename Vector::block_type> weights_;
+    std::vector<int> droppedEq_;
+    // the rows of the IMPES cells before the reduction, in compressed row format
+    std::vector<std::size_t> rowStart_;
+    std::vector<std::size_t> rowColumns_;
+    std::vector<Block> rowBlocks_;
+    std::vector<typename Vector::block_type> residuals_;
+};
+
+} // end namespace Opm
+
+#endif // OPM_ADAPTIVEIMPLICIT_HEADER_INCLUDED
@@ -0,0 +1,137 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_AMGHIERARCHYSTATISTICS_HEADER_INCLUDED
+#define OPM_AMGHIERARCHYSTATISTICS_HEADER_INCLUDED
+
+#include <algorithm>
+#include <cstddef>
+#include <iomanip>
+#include <limits>
+#include <numeric>
+#include <ostream>
+#include <vector>
+
+namespace Opm
+{
+
+    /// \brief The sizes of the levels of the CPR hierarchy, for tuning its coarsening.
+    ///
+    /// The matrices of the fine level and of the first (pressure) coarse
+    /// level are known to CPR, the levels of the AMG of the pressure system
+    /// below it only by their number and the aggregates of the coarsest one.
+    /// The operator complexity is that of the known levels.
+    struct AmgHierarchyStatistics
+    {
+        /// The number of levels including the fine level.
+        std::size_t levels = 0;
+        /// The rows and nonzero blocks of the known levels, the fine level first.
+        std::vector<std::size_t> rows;
+        std::vector<std::size_t> nonzeroes;
+        /// The rows of the coarsest level.
+        std::size_t coarsestRows = 0;
+        /// The smallest and largest number of rows of the level it was built
+        /// from in an aggregate of the coarsest level.
+        std::size_t minAggregateSize = 0;
+        std::size_t maxAggregateSize = 0;
+        /// The rows of the level the coarsest was built from in aggregates, i.e. not isolated.
+        std::size_t aggregatedRows = 0;
+
+        /// \brief Set the coarsest level from its row of each row of the level
+        ///        it was built from. Numbers beyond the rows mark isolated ones.
+        void setCoarsestAggregates(const std::vector<std::size_t>& aggregateOfRow)
+        {
+            std::vector<std::size_t> sizes;
+            for ( const auto aggregate : aggregateOfRow )
+            {
+                if ( aggregate >= aggregateOfRow.size() )
+                {
+                    continue;
+                }
+                if ( aggregate >= sizes.size() )
+                {
+                    sizes.resize(aggregate + 1, 0);
+                }
+                ++sizes[aggregate];
+            }
+            sizes.erase(std::remove(sizes.begin(), sizes.end(), 0), sizes.end());
+            coarsestRows = sizes.size();
+            aggregatedRows = std::accumulate(sizes.begin(), sizes.end(), std::size_t(0));
+            minAggregateSize = sizes.empty() ? 0 : *std::min_element(sizes.begin(), sizes.end());
+            maxAggregateSize = sizes.empty() ? 0 : *std::max_element(sizes.begin(), sizes.end());
+        }
+
+        /// \brief The sum of the nonzeroes of the known levels relative to the fine level.
+        double operatorComplexity() const
+        {
+            if ( nonzeroes.empty() || nonzeroes[0] == 0 )
+            {
+                return 0.0;
+            }
+            return std::accumulate(nonzeroes.begin(), nonzeroes.end(), 0.0) / nonzeroes[0];
+        }
+
+        /// \brief Reduce the statistics of the processes, which have to know the same levels.
+        ///        Collective on the communication.
+        template <class Comm>
+        void reduce(const Comm& comm)
+        {
+            levels = comm.max(levels);
+            for ( auto& r : rows )
+            {
+                r = comm.sum(r);
+            }
+            for ( auto& n : nonzeroes )
+            {
+                n = comm.sum(n);
+            }
+            coarsestRows = comm.sum(coarsestRows);
+            aggregatedRows = comm.sum(aggregatedRows);
+            // processes without aggregates do not count for the minimum
+            minAggregateSize = comm.min(minAggregateSize > 0 ? minAggregateSize : std::numeric_limits<std::size_t>::max());
+            if ( minAggregateSize == std::numeric_limits<std::size_t>::max() )
+            {
+                minAggregateSize = 0;
+            }
+            maxAggregateSize = comm.max(maxAggregateSize);
+        }
+
+        /// \brief Print the statistics.
+        void report(std::ostream& os) const
+        {
+            os << "CPR hierarchy: " << levels << " levels";
+            for ( std::size_t level = 0; level < rows.size(); ++level )
+            {
+                os << "\n  level " << level << ": " << rows[level] << " rows, " << nonzeroes[level] << " nonzeroes";
+            }
+            os << "\n  coarsest level: " << coarsestRows << " rows";
+            if ( coarsestRows > 0 )
+            {
+                os << ", aggregates of " << minAggregateSize << " to " << maxAggregateSize
+                   << " (mean " << std::fixed << std::setprecision(1)
+                   << static_cast<double>(aggregatedRows) / coarsestRows << ") rows";
+            }
+            os << "\n  operator complexity of the levels listed: " << std::fixed << std::setprecision(2)
+               << operatorComplexity();
+        }
+    };
+
+} // namespace Opm
+
+#endif // OPM_AMGHIERARCHYSTATISTICS_HEADER_INCLUDED
@@ -0,0 +1,673 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef OPM_AMGSMOOTHERS_HEADER_INCLUDED
+#define OPM_AMGSMOOTHERS_HEADER_INCLUDED
+
+#include <opm/autodiff/ParallelOverlappingILU0.hpp>
+#include <opm/autodiff/FusedBiCGSTABSolver.hpp>
+#include <opm/autodiff/TimingRegistry.hpp>
+#include <opm/common/ErrorMacros.hpp>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/version.hh>
+#include <dune/istl/ilu.hh>
+#include <dune/istl/istlexception.hh>
+#include <dune/istl/preconditioner.hh>
+#include <dune/istl/paamg/smoother.hh>
+#include <dune/istl/paamg/pinfo.hh>
+
+#if HAVE_OPENMP
+#include <omp.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Opm
+{
+
+enum class AMG_SMOOTHER{
+    /// \brief ParallelOverlappingILU0 (sequential within a process)
+    ILU0 = 0,
+    /// \brief Block-Jacobi with an ILU0 on each block, one block per thread
+    BLOCK_JACOBI_ILU0 = 1,
+    /// \brief Chebyshev polynomial of the block-Jacobi preconditioned matrix
+    CHEBYSHEV = 2
+};
+
+inline AMG_SMOOTHER convertString2AmgSmoother(const std::string& smoother)
+{
+    if ( smoother.empty() || smoother == "ILU0" )
+    {
+        return AMG_SMOOTHER::ILU0;
+    }
+    if ( smoother == "BlockJacobiILU0" )
+    {
+        return AMG_SMOOTHER::BLOCK_JACOBI_ILU0;
+    }
+    if ( smoother == "Chebyshev" )
+    {
+        return AMG_SMOOTHER::CHEBYSHEV;
+    }
+    OPM_THROW(std::invalid_argument, "Unknown AMG smoother '" << smoother
+              << "'. Available are: ILU0 BlockJacobiILU0 Chebyshev");
+}
+
+/// \brief The arguments for constructing an AmgLevelSmoother.
+template<class F>
+class AmgLevelSmootherArgs
+    : public ParallelOverlappingILU0Args<F>
+{
+ public:
+    AmgLevelSmootherArgs(MILU_VARIANT milu = MILU_VARIANT::ILU )
+        : ParallelOverlappingILU0Args<F>(milu), smoother_(AMG_SMOOTHER::ILU0),
+          chebyshevDegree_(3)
+    {
+        this->setN(0);
+    }
+    void setSmoother(AMG_SMOOTHER smoother)
+    {
+        smoother_ = smoother;
+    }
+    AMG_SMOOTHER getSmoother() const
+    {
+        return smoother_;
+    }
+    void setChebyshevDegree(int degree)
+    {
+        chebyshevDegree_ = degree;
+    }
+    int getChebyshevDegree() const
+    {
+        return chebyshevDegree_;
+    }
+ private:
+    AMG_SMOOTHER smoother_;
+    int chebyshevDegree_;
+};
+
+namespace detail
+{
+    //! \brief The number of threads available to the smoothers.
+    inline int numSmootherThreads()
+    {
+#if HAVE_OPENMP
+        return omp_get_max_threads();
+#else
+        return 1;
+#endif
+    }
+
+    //! \brief Throws on all processes if the setup failed on at least one of them.
+    template<class ParallelInfo>
+    void checkSmootherSetup(const ParallelInfo& comm, bool success, const std::string& name)
+    {
+        if ( comm.communicator().min(static_cast<int>(success)) == 0 )
+        {
+            DUNE_THROW(Dune::MatrixBlockError, "Setup of the " << name << " smoother failed");
+        }
+    }
+} // end namespace detail
+
+/// \brief Block-Jacobi smoother with an ILU0 on each block.
+///
+/// The local rows are split into contiguous blocks of similar size, one
+/// per OpenMP thread. The couplings between the blocks are dropped and each
+/// block is factorized and solved by its own thread. Hence this is weaker
+/// than a global ILU0 but both setup and application scale within a node.
+/// The factors are stored separately, the matrix is only used in update().
+/// \tparam Matrix The type of the Matrix.
+/// \tparam Domain The type of the Vector representing the domain.
+/// \tparam Range The type of the Vector representing the range.
+/// \tparam ParallelInfo The type of the parallel information object
+///         used, e.g. Dune::OwnerOverlapCommunication
+template<class Matrix, class Domain, class Range, class ParallelInfo>
+class BlockJacobiILU0
+    : public Dune::Preconditioner<Domain,Range>
+{
+public:
+    typedef typename std::remove_const<Matrix>::type matrix_type;
+    typedef Domain domain_type;
+    typedef Range range_type;
+    typedef typename Domain::field_type field_type;
+
+#if DUNE_VERSION_NEWER(DUNE_ISTL, 2, 6)
+    Dune::SolverCategory::Category category() const override
+    {
+      return std::is_same<ParallelInfo, Dune::Amg::SequentialInformation>::value ?
+              Dune::SolverCategory::sequential : Dune::SolverCategory::overlapping;
+    }
+#else
+    enum {
+        //! \brief The category the preconditioner is part of.
+        category = std::is_same<ParallelInfo, Dune::Amg::SequentialInformation>::value ?
+            Dune::SolverCategory::sequential : Dune::SolverCategory::overlapping
+    };
+#endif
+
+    /// \brief Constructor.
+    /// \param A The matrix to operate on. It has to be valid for update().
+    /// \param comm The information about the parallelization.
+    /// \param w The relaxation factor.
+    /// \param milu The modified ILU variant used on the blocks.
+    /// \param numBlocks The number of blocks. Zero uses one block per thread.
+    BlockJacobiILU0(const matrix_type& A, const ParallelInfo& comm, field_type w,
+                    MILU_VARIANT milu, int numBlocks = 0)
+        : A_(&A), comm_(comm), w_(w), milu_(milu)
+    {
+        const std::size_t rows = A.N();
+        std::size_t blocks = numBlocks > 0 ? numBlocks : detail::numSmootherThreads();
+        blocks = std::max(std::size_t(1), std::min(blocks, rows));
+        blockStart_.resize(blocks + 1);
+        for ( std::size_t b = 0; b <= blocks; ++b )
+        {
+            blockStart_[b] = b * rows / blocks;
+        }
+
+        localMatrices_.resize(blocks);
+        localD_.resize(blocks);
+        localV_.resize(blocks);
+
+        // the sparsity pattern of the blocks
+        for ( std::size_t b = 0; b < blocks; ++b )
+        {
+            const std::size_t start = blockStart_[b], end = blockStart_[b+1];
+            localMatrices_[b].reset(new matrix_type(end - start, end - start, matrix_type::row_wise));
+            auto& local = *localMatrices_[b];
+            for ( auto row = local.createbegin(); row != local.createend(); ++row )
+            {
+                const auto& fineRow = A[start + row.index()];
+                for ( auto col = fineRow.begin(), cend = fineRow.end(); col != cend; ++col )
+                {
+                    if ( col.index() >= start && col.index() < end )
+                    {
+                        row.insert(col.index() - start);
+                    }
+                }
+            }
+            localD_[b].resize(end - start);
+            localV_[b].resize(end - start);
+        }
+        update();
+    }
+
+    /// \brief Recompute the decomposition for changed matrix entries.
+    void update()
+    {
+        static auto& timing = TimingRegistry::instance().entry("bjilu.factorize");
+        ScopedTiming scopedTiming(timing);
+
+        const int blocks = localMatrices_.size();
+        int success = 1;
+#if HAVE_OPENMP
+#pragma omp parallel for schedule(static) reduction(min:success)
+#endif // HAVE_OPENMP
+        for ( int b = 0; b < blocks; ++b )
+        {
+            const std::size_t start = blockStart_[b], end = blockStart_[b+1];
+            auto& local = *localMatrices_[b];
+            for ( auto row = local.begin(); row != local.end(); ++row )
+            {
+                const auto& fineRow = (*A_)[start + row.index()];
+                auto col = row->begin();
+                for ( auto fineCol = fineRow.begin(), cend = fineRow.end(); fineCol != cend; ++fineCol )
+                {
+                    if ( fineCol.index() >= start && fineCol.index() < end )
+                    {
+                        *col = *fineCol;
+                        ++col;
+                    }
+                }
+            }
+            try
+            {
+                detail::ilu0_decomposition(local, milu_);
+            }
+            catch ( const Dune::MatrixBlockError& )
+            {
+                success = 0;
+            }
+            catch ( const std::logic_error& )
+            {
+                success = 0;
+            }
+        }
+        detail::checkSmootherSetup(comm_, success != 0, "block-Jacobi ILU0");
+    }
+
+    virtual void pre (Domain& x, Range& b)
+    {
+        DUNE_UNUSED_PARAMETER(x);
+        DUNE_UNUSED_PARAMETER(b);
+    }
+
+    virtual void apply (Domain& v, const Range& d)
+    {
+        static auto& timing = TimingRegistry::instance().entry("bjilu.apply");
+        ScopedTiming scopedTiming(timing);
+
+        Range md(d);
+        comm_.copyOwnerToAll(md, md);
+
+        const int blocks = localMatrices_.size();
+#if HAVE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif // HAVE_OPENMP
+        for ( int b = 0; b < blocks; ++b )
+        {
+            const std::size_t start = blockStart_[b], end = blockStart_[b+1];
+            auto& localD = localD_[b];
+            auto& localV = localV_[b];
+            for ( std::size_t i = start; i < end; ++i )
+            {
+                localD[i - start] = md[i];
+            }
+            Dune::bilu_backsolve(*localMatrices_[b], localV, localD);
+            for ( std::size_t i = start; i < end; ++i )
+            {
+                v[i] = localV[i - start];
+                v[i] *= w_;
+            }
+        }
+
+        comm_.copyOwnerToAll(v, v);
+    }
+
+    virtual void post (Range& x)
+    {
+        DUNE_UNUSED_PARAMETER(x);
+    }
+
+private:
+    const matrix_type* A_;
+    const ParallelInfo& comm_;
+    field_type w_;
+    MILU_VARIANT milu_;
+    std::vector<std::size_t> blockStart_;
+    std::vector<std::unique_ptr<matrix_type> > localMatrices_;
+    std::vector<Range> localD_;
+    std::vector<Domain> localV_;
+};
+
+/// \brief Chebyshev polynomial smoother.
+///
+/// Applies a Chebyshev polynomial of degree k in \f$D^{-1}A\f$, where D is
+/// the block diagonal of A. The polynomial damps the error components with
+/// eigenvalues in \f$[\lambda_{max}/30, \lambda_{max}]\f$, the upper end is
+/// estimated with a few power iterations during the setup.
+/// Only matrix-vector products are needed, all of them threaded. The
+/// matrix has to stay valid and unchanged between update() and apply().
+/// \tparam Matrix The type of the Matrix.
+/// \tparam Domain The type of the Vector representing the domain.
+/// \tparam Range The type of the Vector representing the range.
+/// \tparam ParallelInfo The type of the parallel information object
+///         used, e.g. Dune::OwnerOverlapCommunication
+template<class Matrix, class Domain, class Range, class ParallelInfo>
+class ChebyshevSmoother
+    : public Dune::Preconditioner<Domain,Range>
+{
+public:
+    typedef typename std::remove_const<Matrix>::type matrix_type;
+    typedef Domain domain_type;
+    typedef Range range_type;
+    typedef typename Domain::field_type field_type;
+    typedef typename matrix_type::block_type block_type;
+
+#if DUNE_VERSION_NEWER(DUNE_ISTL, 2, 6)
+    Dune::SolverCategory::Category category() const override
+    {
+      return std::is_same<ParallelInfo, Dune::Amg::SequentialInformation>::value ?
+              Dune::SolverCategory::sequential : Dune::SolverCategory::overlapping;
+    }
+#else
+    enum {
+        //! \brief The category the preconditioner is part of.
+        category = std::is_same<ParallelInfo, Dune::Amg::SequentialInformation>::value ?
+            Dune::SolverCategory::sequential : Dune::SolverCategory::overlapping
+    };
+#endif
+
+    /// \brief Constructor.
+    /// \param A The matrix to operate on.
+    /// \param comm The information about the parallelization.
+    /// \param degree The degree of the polynomial.
+    ChebyshevSmoother(const matrix_type& A, const ParallelInfo& comm, int degree)
+        : A_(&A), comm_(comm), dots_(comm), degree_(std::max(degree, 1)),
+          inverseDiagonal_(A.N()), r_(A.N()), p_(A.N()), q_(A.N())
+    {
+        update();
+    }
+
+    /// \brief Recompute the inverse diagonal and the eigenvalue estimate.
+    void update()
+    {
+        static auto& timing = TimingRegistry::instance().entry("chebyshev.setup");
+        ScopedTiming scopedTiming(timing);
+
+        const auto& A = *A_;
+        const int rows = A.N();
+        int success = 1;
+#if HAVE_OPENMP
+#pragma omp parallel for schedule(static) reduction(min:success)
+#endif // HAVE_OPENMP
+        for ( int i = 0; i < rows; ++i )
+        {
+            const auto diag = A[i].find(i);
+            if ( diag == A[i].end() )
+            {
+                success = 0;
+                continue;
+            }
+            inverseDiagonal_[i] = *diag;
+            try
+            {
+                inverseDiagonal_[i].invert();
+            }
+            catch ( const Dune::FMatrixError& )
+            {
+                success = 0;
+            }
+        }
+        detail::checkSmootherSetup(comm_, success != 0, "Chebyshev");
+
+        // Power iteration for the largest eigenvalue of D^{-1}A.
+        typedef std::pair<const Domain*, const Domain*> Pair;
+        for ( int i = 0; i < rows; ++i )
+        {
+            for ( std::size_t k = 0; k < p_[i].size(); ++k )
+            {
+                p_[i][k] = 1.0 + 0.5 * ((i + 3 * k) % 7) / 7.0;
+            }
+        }
+        comm_.copyOwnerToAll(p_, p_);
+        double norm = std::sqrt(dots_.compute(std::array<Pair, 1>{{ Pair(&p_, &p_) }})[0]);
+        double lambda = 1.0;
+        for ( int it = 0; it < powerIterations && norm > 0.0; ++it )
+        {
+            p_ *= 1.0 / norm;
+            applyPreconditionedMatrix(p_, q_);
+            norm = std::sqrt(dots_.compute(std::array<Pair, 1>{{ Pair(&q_, &q_) }})[0]);
+            lambda = norm;
+            p_ = q_;
+        }
+        // The estimate from below is enlarged as the polynomial
+        // amplifies the error components above the interval.
+        lambdaMax_ = 1.1 * lambda;
+        lambdaMin_ = lambdaMax_ / eigenvalueRatio;
+    }
+
+    virtual void pre (Domain& x, Range& b)
+    {
+        DUNE_UNUSED_PARAMETER(x);
+        DUNE_UNUSED_PARAMETER(b);
+    }
+
+    virtual void apply (Domain& v, const Range& d)
+    {
+        static auto& timing = TimingRegistry::instance().entry("chebyshev.apply");
+        ScopedTiming scopedTiming(timing);
+
+        const int rows = v.size();
+        const double theta = 0.5 * (lambdaMax_ + lambdaMin_);
+        const double delta = 0.5 * (lambdaMax_ - lambdaMin_);
+        const double sigma = theta / delta;
+        double rho = 1.0 / sigma;
+
+        // p = D^{-1} d / theta, v = p, r = d - A v
+        r_ = d;
+        comm_.copyOwnerToAll(r_, r_);
+#if HAVE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif // HAVE_OPENMP
+        for ( int i = 0; i < rows; ++i )
+        {
+            inverseDiagonal_[i].mv(r_[i], p_[i]);
+            p_[i] *= 1.0 / theta;
+            v[i] = p_[i];
+        }
+        comm_.copyOwnerToAll(p_, p_);
+
+        for ( int k = 1; k < degree_; ++k )
+        {
+            // r -= A p
+            multiply(p_, q_);
+            const double rhoNew = 1.0 / (2.0 * sigma - rho);
+            const double pFactor = rhoNew * rho;
+            const double rFactor = 2.0 * rhoNew / delta;
+#if HAVE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif // HAVE_OPENMP
+            for ( int i = 0; i < rows; ++i )
+            {
+                r_[i] -= q_[i];
+                const auto previous = p_[i];
+                inverseDiagonal_[i].mv(r_[i], p_[i]);
+                p_[i] *= rFactor;
+                p_[i].axpy(pFactor, previous);
+                v[i] += p_[i];
+            }
+            comm_.copyOwnerToAll(p_, p_);
+            rho = rhoNew;
+        }
+        comm_.copyOwnerToAll(v, v);
+    }
+
+    virtual void post (Range& x)
+    {
+        DUNE_UNUSED_PARAMETER(x);
+    }
+
+private:
+    static constexpr int powerIterations = 10;
+    static constexpr double eigenvalueRatio = 30.0;
+
+    //! \brief y = A x, with x consistent.
+    void multiply(const Domain& x, Range& y) const
+    {
+        const auto& A = *A_;
+        const int rows = A.N();
+#if HAVE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif // HAVE_OPENMP
+        for ( int i = 0; i < rows; ++i )
+        {
+            y[i] = 0.0;
+            const auto& row = A[i];
+            for ( auto col = row.begin(), cend = row.end(); col != cend; ++col )
+            {
+                col->umv(x[col.index()], y[i]);
+            }
+        }
+    }
+
+    //! \brief y = D^{-1} A x, y is made consistent.
+    void applyPreconditionedMatrix(const Domain& x, Range& y)
+    {
+        multiply(x, r_);
+        const int rows = y.size();
+#if HAVE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif // HAVE_OPENMP
+        for ( int i = 0; i < rows; ++i )
+        {
+            inverseDiagonal_[i].mv(r_[i], y[i]);
+        }
+        comm_.copyOwnerToAll(y, y);
+    }
+
+    const matrix_type* A_;
+    const ParallelInfo& comm_;
+    Detail::FusedDotProducts<ParallelInfo> dots_;
+    int degree_;
+    std::vector<block_type> inverseDiagonal_;
+    double lambdaMax_;
+    double lambdaMin_;
+    Range r_;
+    Domain p_;
+    Range q_;
+};
+
+/// \brief The smoother used on the levels of the AMG of CPR.
+///
+/// Dispatches at run time to ParallelOverlappingILU0, BlockJacobiILU0 or
+/// ChebyshevSmoother as selected with AmgLevelSmootherArgs (see the
+/// parameter CprSmoother). This keeps the AMG types independent of the choice.
+/// \tparam Matrix The type of the Matrix.
+/// \tparam Domain The type of the Vector representing the domain.
+/// \tparam Range The type of the Vector representing the range.
+/// \tparam ParallelInfo The type of the parallel information object
+///         used, e.g. Dune::OwnerOverlapCommunication
+template<class Matrix, class Domain, class Range, class ParallelInfo = Dune::Amg::SequentialInformation>
+class AmgLevelSmoother
+    : public Dune::Preconditioner<Domain,Range>
+{
+public:
+    typedef typename std::remove_const<Matrix>::type matrix_type;
+    typedef Domain domain_type;
+    typedef Range range_type;
+    typedef typename Domain::field_type field_type;
+
+#if DUNE_VERSION_NEWER(DUNE_ISTL, 2, 6)
+    Dune::SolverCategory::Category category() const override
+    {
+      return std::is_same<ParallelInfo, Dune::Amg::SequentialInformation>::value ?
+              Dune::SolverCategory::sequential : Dune::SolverCategory::overlapping;
+    }
+#else
+    enum {
+        //! \brief The category the preconditioner is part of.
+        category = std::is_same<ParallelInfo, Dune::Amg::SequentialInformation>::value ?
+            Dune::SolverCategory::sequential : Dune::SolverCategory::overlapping
+    };
+#endif
+
+    AmgLevelSmoother(const matrix_type& A, const ParallelInfo& comm,
+                     const AmgLevelSmootherArgs<field_type>& args)
+        : type_(args.getSmoother())
+    {
+        switch ( type_ )
+        {
+        case AMG_SMOOTHER::BLOCK_JACOBI_ILU0:
+            {
+                auto smoother = new BlockJacobiILU0<Matrix,Domain,Range,ParallelInfo>(A, comm,
+                                                                                      args.relaxationFactor,
+                                                                                      args.getMilu());
+                smoother_.reset(smoother);
+                update_ = [smoother]() { smoother->update(); };
+            }
+            break;
+        case AMG_SMOOTHER::CHEBYSHEV:
+            {
+                auto smoother = new ChebyshevSmoother<Matrix,Domain,Range,ParallelInfo>(A, comm,
+                                                                                        args.getChebyshevDegree());
+                smoother_.reset(smoother);
+                update_ = [smoother]() { smoother->update(); };
+            }
+            break;
+        default:
+            {
+                auto smoother = new ParallelOverlappingILU0<Matrix,Domain,Range,ParallelInfo>(A, comm,
+                                                                                              args.getN(),
+                                                                                              args.relaxationFactor,
+                                                                                              args.getMilu());
+                smoother_.reset(smoother);
+                update_ = [smoother]() { smoother->update(); };
+            }
+            break;
+        }
+    }
+
+    /// \brief Recompute the smoother for changed matrix entries.
+    void update()
+    {
+        update_();
+    }
+
+    /// \brief Whether the smoother accesses the matrix in apply().
+    bool needsMatrix() const
+    {
+        return type_ == AMG_SMOOTHER::CHEBYSHEV;
+    }
+
+    virtual void pre (Domain& x, Range& b)
+    {
+        smoother_->pre(x, b);
+    }
+
+    virtual void apply (Domain& v, const Range& d)
+    {
+        smoother_->apply(v, d);
+    }
+
+    virtual void post (Range& x)
+    {
+        smoother_->post(x);
+    }
+
+private:
+    AMG_SMOOTHER type_;
+    std::unique_ptr<Dune::Preconditioner<Domain,Range> > smoother_;
+    std::function<void()> update_;
+};
+
+} // end namespace Opm
+
+namespace Dune
+{
+
+namespace Amg
+{
+
+template<class M, class X, class Y, class C>
+struct SmootherTraits<Opm::AmgLevelSmoother<M,X,Y,C> >
+{
+    using Arguments = Opm::AmgLevelSmootherArgs<typename M::field_type>;
+};
+
+/// \brief Tells AMG how to construct the Opm::AmgLevelSmoother
+template<class Matrix, class Domain, class Range, class ParallelInfo>
+struct ConstructionTraits<Opm::AmgLevelSmoother<Matrix,Domain,Range,ParallelInfo> >
+{
+    typedef Opm::AmgLevelSmoother<Matrix,Domain,Range,ParallelInfo> T;
+    typedef DefaultParallelConstructionArgs<T,ParallelInfo> Arguments;
+    static inline T* construct(Arguments& args)
+    {
+        return new T(args.getMatrix(), args.getComm(), args.getArgs());
+    }
+
+    static inline void deconstruct(T* bp)
+    {
+        delete bp;
+    }
+};
+
+} // end namespace Amg
+
+} // end namespace Dune
+
+#endif // OPM_AMGSMOOTHERS_HEADER_INCLUDED
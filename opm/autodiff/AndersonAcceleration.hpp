@@ -0,0 +1,233 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_ANDERSONACCELERATION_HEADER_INCLUDED
+#define OPM_ANDERSONACCELERATION_HEADER_INCLUDED
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <deque>
+#include <utility>
+#include <vector>
+
+namespace Opm
+{
+
+/// \brief Anderson acceleration of the Newton updates of a time step.
+///
+/// The Newton iteration is seen as the fixed point iteration
+/// x_{k+1} = x_k + f_k with f_k = -dx_k. With the differences of the last m
+/// steps Delta x_i = x_{i+1} - x_i and of their fixed point residuals
+/// Delta f_i = f_{i+1} - f_i, the accelerated step is
+/// f_k - (Delta X + Delta F) gamma, where gamma minimizes
+/// |f_k - Delta F gamma|. This combines the last updates such that the
+/// oscillating components of consecutive updates cancel.
+///
+/// The least squares problem is solved with the normal equations. The inner
+/// products only run over the given cells (those owned by the process) and
+/// are summed by the communication, hence all processes agree on gamma.
+/// \tparam Vector The type of the (block) vectors of the updates.
+template<class Vector>
+class AndersonAcceleration
+{
+public:
+    typedef typename Vector::field_type field_type;
+
+    /// \param depth The number of previous steps m combined with the current one.
+    explicit AndersonAcceleration(int depth)
+        : depth_(depth), haveLast_(false)
+    {}
+
+    /// \brief Forget the steps, e.g. at the start of a time step.
+    void reset()
+    {
+        deltaX_.clear();
+        deltaF_.clear();
+        haveLast_ = false;
+    }
+
+    /// \brief The number of previous steps in the history.
+    std::size_t historySize() const
+    {
+        return deltaF_.size();
+    }
+
+    /// \brief Record a Newton update and optionally replace it by the accelerated one.
+    /// \param dx The Newton update (x_new = x - dx). If mix is true it is replaced
+    ///           by the accelerated update, otherwise it is unchanged.
+    /// \param cells The indices of the entries entering the inner products.
+    /// \param comm The communication whose sum() adds the inner products of the processes.
+    /// \param mix Whether to replace dx by the accelerated update.
+    template<class Cells, class Comm>
+    void apply(Vector& dx, const Cells& cells, const Comm& comm, const bool mix)
+    {
+        // f = -dx is the fixed point residual of the current iterate
+        if ( haveLast_ && depth_ > 0 )
+        {
+            if ( deltaF_.size() == static_cast<std::size_t>(depth_) )
+            {
+                // reuse the storage of the oldest step
+                deltaF_.push_back(std::move(deltaF_.front()));
+                deltaX_.push_back(std::move(deltaX_.front()));
+                deltaF_.pop_front();
+                deltaX_.pop_front();
+            }
+            else
+            {
+                deltaF_.emplace_back();
+                deltaX_.emplace_back();
+            }
+            Vector& df = deltaF_.back();
+            df = dx;
+            df += lastF_;
+            df *= -1.0;
+            // the step from the last iterate to the current one
+            deltaX_.back() = lastStep_;
+        }
+
+        lastF_ = dx;
+        lastF_ *= -1.0;
+
+        std::vector<field_type> gamma;
+        if ( mix && !deltaF_.empty() )
+        {
+            gamma = mixingCoefficients(cells, comm);
+        }
+        if ( !gamma.empty() )
+        {
+            // step = f - sum_i (Delta x_i + Delta f_i) gamma_i
+            Vector& step = lastStep_;
+            step = lastF_;
+            for ( std::size_t i = 0; i < gamma.size(); ++i )
+            {
+                step.axpy(-gamma[i], deltaX_[i]);
+                step.axpy(-gamma[i], deltaF_[i]);
+            }
+            dx = step;
+            dx *= -1.0;
+        }
+        else
+        {
+            lastStep_ = lastF_;
+        }
+        haveLast_ = true;
+    }
+
+private:
+    template<class Cells>
+    static field_type dot(const Vector& a, const Vector& b, const Cells& cells)
+    {
+        field_type result = 0.0;
+        for ( const auto cell : cells )
+        {
+            result += a[cell] * b[cell];
+        }
+        return result;
+    }
+
+    /// \brief Solve the normal equations of min |f - Delta F gamma|.
+    /// \return gamma, or empty if the differences are (nearly) linearly dependent.
+    template<class Cells, class Comm>
+    std::vector<field_type> mixingCoefficients(const Cells& cells, const Comm& comm) const
+    {
+        const std::size_t m = deltaF_.size();
+        // the normal matrix in the first m*m entries, the right hand side in the last m
+        std::vector<field_type> data(m * m + m);
+        for ( std::size_t i = 0; i < m; ++i )
+        {
+            for ( std::size_t j = 0; j <= i; ++j )
+            {
+                data[i * m + j] = dot(deltaF_[i], deltaF_[j], cells);
+            }
+            data[m * m + i] = dot(deltaF_[i], lastF_, cells);
+        }
+        comm.sum(data.data(), data.size());
+        for ( std::size_t i = 0; i < m; ++i )
+        {
+            for ( std::size_t j = 0; j < i; ++j )
+            {
+                data[j * m + i] = data[i * m + j];
+            }
+        }
+
+        // Gaussian elimination with partial pivoting
+        std::vector<field_type> gamma(data.begin() + m * m, data.end());
+        field_type scale = 0.0;
+        for ( std::size_t i = 0; i < m; ++i )
+        {
+            scale = std::max(scale, std::abs(data[i * m + i]));
+        }
+        const field_type tolerance = 1e-12 * scale;
+        for ( std::size_t k = 0; k < m; ++k )
+        {
+            std::size_t pivot = k;
+            for ( std::size_t i = k + 1; i < m; ++i )
+            {
+                if ( std::abs(data[i * m + k]) > std::abs(data[pivot * m + k]) )
+                {
+                    pivot = i;
+                }
+            }
+            if ( !(std::abs(data[pivot * m + k]) > tolerance) )
+            {
+                return std::vector<field_type>();
+            }
+            if ( pivot != k )
+            {
+                for ( std::size_t j = 0; j < m; ++j )
+                {
+                    std::swap(data[k * m + j], data[pivot * m + j]);
+                }
+                std::swap(gamma[k], gamma[pivot]);
+            }
+            for ( std::size_t i = k + 1; i < m; ++i )
+            {
+                const field_type factor = data[i * m + k] / data[k * m + k];
+                for ( std::size_t j = k; j < m; ++j )
+                {
+                    data[i * m + j] -= factor * data[k * m + j];
+                }
+                gamma[i] -= factor * gamma[k];
+            }
+        }
+        for ( std::size_t k = m; k-- > 0; )
+        {
+            for ( std::size_t j = k + 1; j < m; ++j )
+            {
+                gamma[k] -= data[k * m + j] * gamma[j];
+            }
+            gamma[k] /= data[k * m + k];
+        }
+        return gamma;
+    }
+
+    int depth_;
+    bool haveLast_;
+    // the differences of the last steps and of their fixed point residuals
+    std::deque<Vector> deltaX_;
+    std::deque<Vector> deltaF_;
+    // the fixed point residual and the step of the last iterate
+    Vector lastF_;
+    Vector lastStep_;
+};
+
+} // end namespace Opm
+
+#endif // OPM_ANDERSONACCELERATION_HEADER_INCLUDED
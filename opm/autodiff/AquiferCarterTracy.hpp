@@ -24,6 +24,9 @@
 #include <opm/parser/eclipse/EclipseState/AquiferCT.hpp>
 #include <opm/parser/eclipse/EclipseState/Aquancon.hpp>
 #include <opm/autodiff/BlackoilAquiferModel.hpp>
+#include <opm/autodiff/CartesianCellIndexMap.hpp>
+#include <opm/autodiff/MemoryRegistry.hpp>
+#include <opm/core/simulator/BinarySerialization.hpp>
 #include <opm/common/utility/numeric/linearInterpolation.hpp>
 
 #include <opm/material/densead/Math.hpp>
@@ -32,7 +35,8 @@
 
 #include <vector>
 #include <algorithm>
-#include <unordered_map>
+#include <istream>
+#include <ostream>
 
 namespace Opm
 {
@@ -65,7 +69,7 @@ namespace Opm
 
             AquiferCarterTracy( const AquiferCT::AQUCT_data& aquct_data,
                                 const Aquancon::AquanconOutput& connection,
-                                const std::unordered_map<int, int>& cartesian_to_compressed,
+                                const CartesianCellIndexMap& cartesian_to_compressed,
                                 const Simulator& ebosSimulator)
             : ebos_simulator_ (ebosSimulator)
             , aquct_data_ (aquct_data)
@@ -80,23 +84,21 @@ namespace Opm
 
             void beginTimeStep()
             {
-                ElementContext elemCtx(ebos_simulator_);
-                auto elemIt = ebos_simulator_.gridView().template begin<0>();
-                const auto& elemEndIt = ebos_simulator_.gridView().template end<0>();
-                for (; elemIt != elemEndIt; ++elemIt) {
-                    const auto& elem = *elemIt;
-
-                    elemCtx.updatePrimaryStencil(elem);
+                forEachConnection_([this](int idx, const IntensiveQuantities& iq) {
+                    pressure_previous_[idx] = Opm::getValue(iq.fluidState().pressure(waterPhaseIdx));
+                });
 
-                    int cellIdx = elemCtx.globalSpaceIndex(0, 0);
-                    int idx = cellToConnectionIdx_[cellIdx];
-                    if (idx < 0)
-                        continue;
+                // the time and the step size are known from here on
+                beginIteration();
+            }
 
-                    elemCtx.updateIntensiveQuantities(0);
-                    const auto& iq = elemCtx.intensiveQuantities(0, 0);
-                    pressure_previous_[idx] = Opm::getValue(iq.fluidState().pressure(waterPhaseIdx));
-                }
+            // The influence function only depends on the time, hence it is evaluated
+            // once for all connections before the source terms are assembled.
+            void beginIteration()
+            {
+                const Scalar td_plus_dt = (ebos_simulator_.timeStepSize() + ebos_simulator_.time()) / Tc_;
+                td_ = ebos_simulator_.time() / Tc_;
+                getInfluenceTableValues(PItd_, PItdprime_, td_plus_dt);
             }
 
             template <class Context>
@@ -108,13 +110,11 @@ namespace Opm
                 if (idx < 0)
                     return;
 
-                // We are dereferencing the value of IntensiveQuantities because cachedIntensiveQuantities return a const pointer to
-                // IntensiveQuantities of that particular cell_id
-                const IntensiveQuantities intQuants = context.intensiveQuantities(spaceIdx, timeIdx);
+                const IntensiveQuantities& intQuants = context.intensiveQuantities(spaceIdx, timeIdx);
                 // This is the pressure at td + dt
                 updateCellPressure(pressure_current_,idx,intQuants);
                 updateCellDensity(idx,intQuants);
-                calculateInflowRate(idx, context.simulator());
+                calculateInflowRate(idx);
 
                 rates[BlackoilIndices::conti0EqIdx + FluidSystem::waterCompIdx] +=
                     Qai_[idx]/context.dofVolume(spaceIdx, timeIdx);
@@ -127,6 +127,34 @@ namespace Opm
                 }
             }
 
+            // the cumulative influx is the state of the aquifer between the time steps
+            void serialize(std::ostream& os) const
+            {
+                BinarySerialization::write(os, Scalar(W_flux_.value()));
+            }
+
+            void deserialize(std::istream& is)
+            {
+                Scalar flux = 0.0;
+                BinarySerialization::read(is, flux);
+                W_flux_ = flux;
+            }
+
+            // the bytes of the arrays of the connections, for the memory report
+            std::size_t memory() const
+            {
+                return Opm::memoryBytes(cell_idx_) + Opm::memoryBytes(faceArea_connected_) + Opm::memoryBytes(cell_depth_)
+                    + Opm::memoryBytes(pressure_previous_) + Opm::memoryBytes(pressure_current_) + Opm::memoryBytes(Qai_)
+                    + Opm::memoryBytes(rhow_) + Opm::memoryBytes(alphai_) + Opm::memoryBytes(cellToConnectionIdx_)
+                    + Opm::memoryBytes(connectionCells_);
+            }
+
+            // the compressed indices of the connected cells, set by initialSolutionApplied()
+            const std::vector<int>& connectionCells() const
+            {
+                return connectionCells_;
+            }
+
         private:
             const Simulator& ebos_simulator_;
 
@@ -150,9 +178,15 @@ namespace Opm
             Scalar Tc_; // Time constant
             Scalar pa0_; // initial aquifer pressure
 
+            // the influence function and its derivative at the end of the time step
+            // and the dimensionless time at its start, set by beginIteration()
+            Scalar PItd_ = 0.;
+            Scalar PItdprime_ = 0.;
+            Scalar td_ = 0.;
+
             Eval W_flux_;
 
-            const std::unordered_map<int, int>& cartesian_to_compressed_;
+            const CartesianCellIndexMap& cartesian_to_compressed_;
 
             Scalar gravity_() const
             { return ebos_simulator_.problem().gravity()[2]; }
@@ -206,22 +240,17 @@ namespace Opm
             }
 
             // This function implements Eqs 5.8 and 5.9 of the EclipseTechnicalDescription
-            inline void calculateEqnConstants(Scalar& a, Scalar& b, const int idx, const Simulator& simulator)
+            inline void calculateEqnConstants(Scalar& a, Scalar& b, const int idx)
             {
-                const Scalar td_plus_dt = (simulator.timeStepSize() + simulator.time()) / Tc_;
-                const Scalar td = simulator.time() / Tc_;
-                Scalar PItdprime = 0.;
-                Scalar PItd = 0.;
-                getInfluenceTableValues(PItd, PItdprime, td_plus_dt);
-                a = 1.0/Tc_ * ( (beta_ * dpai(idx)) - (W_flux_.value() * PItdprime) ) / ( PItd - td*PItdprime );
-                b = beta_ / (Tc_ * ( PItd - td*PItdprime));
+                a = 1.0/Tc_ * ( (beta_ * dpai(idx)) - (W_flux_.value() * PItdprime_) ) / ( PItd_ - td_*PItdprime_ );
+                b = beta_ / (Tc_ * ( PItd_ - td_*PItdprime_));
             }
 
             // This function implements Eq 5.7 of the EclipseTechnicalDescription
-            inline void calculateInflowRate(int idx, const Simulator& simulator)
+            inline void calculateInflowRate(int idx)
             {
                 Scalar a, b;
-                calculateEqnConstants(a,b,idx,simulator);
+                calculateEqnConstants(a,b,idx);
                 Qai_.at(idx) = alphai_.at(idx)*( a - b * ( pressure_current_.at(idx) - pressure_previous_.at(idx) ) );
             }
 
@@ -293,10 +322,12 @@ namespace Opm
                 // denom_face_areas is the sum of the areas connected to an aquifer
                 Scalar denom_face_areas = 0.;
                 cellToConnectionIdx_.resize(ebos_simulator_.gridView().size(/*codim=*/0), -1);
+                connectionCells_.resize(cell_idx_.size());
                 for (size_t idx = 0; idx < cell_idx_.size(); ++idx)
                 {
                     const int cell_index = cartesian_to_compressed_.at(cell_idx_[idx]);
                     cellToConnectionIdx_[cell_index] = idx;
+                    connectionCells_[idx] = cell_index;
 
                     const auto cellFacesRange = cell2Faces[cell_index];
                     for(auto cellFaceIter = cellFacesRange.begin(); cellFaceIter != cellFacesRange.end(); ++cellFaceIter)
@@ -390,6 +421,41 @@ namespace Opm
                 std::vector<Scalar> pw_aquifer;
                 Scalar water_pressure_reservoir;
 
+                forEachConnection_([&](int idx, const IntensiveQuantities& iq0) {
+                    const auto& fs = iq0.fluidState();
+
+                    water_pressure_reservoir = fs.pressure(waterPhaseIdx).value();
+                    rhow_[idx] = fs.density(waterPhaseIdx);
+                    pw_aquifer.push_back( (water_pressure_reservoir - rhow_[idx].value()*gravity_()*(cell_depth_[idx] - aquct_data_.d0))*alphai_[idx] );
+                });
+
+                // We take the average of the calculated equilibrium pressures.
+                Scalar aquifer_pres_avg = std::accumulate(pw_aquifer.begin(), pw_aquifer.end(), 0.)/pw_aquifer.size();
+                return aquifer_pres_avg;
+            }
+
+            // Call function(idx, intQuants) for the connections, one per connected cell.
+            // The cached intensive quantities of the cells are used if they are
+            // available, such that the cost scales with the number of connections.
+            // Otherwise the grid is swept once to update them for the connected cells.
+            template <class Function>
+            void forEachConnection_(const Function& function) const
+            {
+                const auto& model = ebos_simulator_.model();
+                const bool cached = std::all_of(connectionCells_.begin(), connectionCells_.end(),
+                                                [&model](int cellIdx) {
+                                                    return model.cachedIntensiveQuantities(cellIdx, /*timeIdx=*/0) != nullptr;
+                                                });
+                if (cached) {
+                    for (size_t idx = 0; idx < connectionCells_.size(); ++idx) {
+                        const int cellIdx = connectionCells_[idx];
+                        if (cellToConnectionIdx_[cellIdx] == static_cast<int>(idx)) {
+                            function(idx, *model.cachedIntensiveQuantities(cellIdx, /*timeIdx=*/0));
+                        }
+                    }
+                    return;
+                }
+
                 ElementContext elemCtx(ebos_simulator_);
                 const auto& gridView = ebos_simulator_.gridView();
                 auto elemIt = gridView.template begin</*codim=*/0>();
@@ -404,21 +470,14 @@ namespace Opm
                         continue;
 
                     elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
-                    const auto& iq0 = elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
-                    const auto& fs = iq0.fluidState();
-
-                    water_pressure_reservoir = fs.pressure(waterPhaseIdx).value();
-                    rhow_[idx] = fs.density(waterPhaseIdx);
-                    pw_aquifer.push_back( (water_pressure_reservoir - rhow_[idx].value()*gravity_()*(cell_depth_[idx] - aquct_data_.d0))*alphai_[idx] );
+                    function(idx, elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0));
                 }
-
-                // We take the average of the calculated equilibrium pressures.
-                Scalar aquifer_pres_avg = std::accumulate(pw_aquifer.begin(), pw_aquifer.end(), 0.)/pw_aquifer.size();
-                return aquifer_pres_avg;
             }
 
             const Aquancon::AquanconOutput connection_;
             std::vector<int> cellToConnectionIdx_;
+            // the compressed index of the cell of each connection
+            std::vector<int> connectionCells_;
     }; // class AquiferCarterTracy
 
 
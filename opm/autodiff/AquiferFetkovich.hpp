@@ -24,6 +24,9 @@ along with OPM.  If not, see <http://www.gnu.org/licenses/>.
 #include <opm/parser/eclipse/EclipseState/Aquifetp.hpp>
 #include <opm/parser/eclipse/EclipseState/Aquancon.hpp>
 #include <opm/autodiff/BlackoilAquiferModel.hpp>
+#include <opm/autodiff/CartesianCellIndexMap.hpp>
+#include <opm/autodiff/MemoryRegistry.hpp>
+#include <opm/core/simulator/BinarySerialization.hpp>
 #include <opm/common/utility/numeric/linearInterpolation.hpp>
 
 #include <opm/material/common/MathToolbox.hpp>
@@ -33,7 +36,8 @@ along with OPM.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <vector>
 #include <algorithm>
-#include <unordered_map>
+#include <istream>
+#include <ostream>
 
 namespace Opm
 {
@@ -65,7 +69,7 @@ namespace Opm
 
     AquiferFetkovich( const Aquifetp::AQUFETP_data& aqufetp_data,
       const Aquancon::AquanconOutput& connection,
-      const std::unordered_map<int, int>& cartesian_to_compressed,
+      const CartesianCellIndexMap& cartesian_to_compressed,
       const Simulator& ebosSimulator)
       : ebos_simulator_ (ebosSimulator)
       , aqufetp_data_ (aqufetp_data)
@@ -80,23 +84,21 @@ namespace Opm
 
         void beginTimeStep()
         {
-          ElementContext elemCtx(ebos_simulator_);
-          auto elemIt = ebos_simulator_.gridView().template begin<0>();
-          const auto& elemEndIt = ebos_simulator_.gridView().template end<0>();
-          for (; elemIt != elemEndIt; ++elemIt) {
-            const auto& elem = *elemIt;
-
-            elemCtx.updatePrimaryStencil(elem);
+          forEachConnection_([this](int idx, const IntensiveQuantities& iq) {
+            pressure_previous_[idx] = Opm::getValue(iq.fluidState().pressure(waterPhaseIdx));
+          });
 
-            int cellIdx = elemCtx.globalSpaceIndex(0, 0);
-            int idx = cellToConnectionIdx_[cellIdx];
-            if (idx < 0)
-            continue;
+          // the step size is known from here on
+          beginIteration();
+        }
 
-            elemCtx.updateIntensiveQuantities(0);
-            const auto& iq = elemCtx.intensiveQuantities(0, 0);
-            pressure_previous_[idx] = Opm::getValue(iq.fluidState().pressure(waterPhaseIdx));
-          }
+        // The time factor of the inflow only depends on the time step size, hence
+        // it is evaluated once for all connections before the source terms are assembled.
+        void beginIteration()
+        {
+          Tc_ = ( aqufetp_data_.C_t * aqufetp_data_.V0 ) / aqufetp_data_.J ;
+          const Scalar td_Tc_ = ebos_simulator_.timeStepSize() / Tc_ ;
+          inflowFactor_ = aqufetp_data_.J * (1 - exp(-td_Tc_)) / td_Tc_;
         }
 
         template <class Context>
@@ -108,13 +110,11 @@ namespace Opm
           if (idx < 0)
           return;
 
-          // We are dereferencing the value of IntensiveQuantities because cachedIntensiveQuantities return a const pointer to
-          // IntensiveQuantities of that particular cell_id
-          const IntensiveQuantities intQuants = context.intensiveQuantities(spaceIdx, timeIdx);
+          const IntensiveQuantities& intQuants = context.intensiveQuantities(spaceIdx, timeIdx);
           // This is the pressure at td + dt
           updateCellPressure(pressure_current_,idx,intQuants);
           updateCellDensity(idx,intQuants);
-          calculateInflowRate(idx, context.simulator());
+          calculateInflowRate(idx);
           rates[BlackoilIndices::conti0EqIdx + FluidSystem::waterCompIdx] +=
           Qai_[idx]/context.dofVolume(spaceIdx, timeIdx);
         }
@@ -126,9 +126,40 @@ namespace Opm
             aquifer_pressure_ = aquiferPressure();
           }
         }
+
+        // the cumulative influx and the aquifer pressure are the state of the
+        // aquifer between the time steps
+        void serialize(std::ostream& os) const
+        {
+          BinarySerialization::write(os, Scalar(W_flux_.value()));
+          BinarySerialization::write(os, aquifer_pressure_);
+        }
+
+        void deserialize(std::istream& is)
+        {
+          Scalar flux = 0.0;
+          BinarySerialization::read(is, flux);
+          W_flux_ = flux;
+          BinarySerialization::read(is, aquifer_pressure_);
+        }
+
+        // the bytes of the arrays of the connections, for the memory report
+        std::size_t memory() const
+        {
+          return Opm::memoryBytes(cell_idx_) + Opm::memoryBytes(faceArea_connected_) + Opm::memoryBytes(cell_depth_)
+              + Opm::memoryBytes(pressure_previous_) + Opm::memoryBytes(pressure_current_) + Opm::memoryBytes(Qai_)
+              + Opm::memoryBytes(rhow_) + Opm::memoryBytes(alphai_) + Opm::memoryBytes(cellToConnectionIdx_)
+              + Opm::memoryBytes(connectionCells_);
+        }
+
+        // the compressed indices of the connected cells, set by initialSolutionApplied()
+        const std::vector<int>& connectionCells() const
+        {
+          return connectionCells_;
+        }
       private:
         const Simulator& ebos_simulator_;
-        const std::unordered_map<int, int>& cartesian_to_compressed_;
+        const CartesianCellIndexMap& cartesian_to_compressed_;
 
         // Grid variables
         std::vector<size_t> cell_idx_;
@@ -142,6 +173,8 @@ namespace Opm
         std::vector<Eval> rhow_;
         std::vector<Scalar> alphai_;
         std::vector<int> cellToConnectionIdx_;
+        // the compressed index of the cell of each connection
+        std::vector<int> connectionCells_;
 
         // Variables constants
         const Aquifetp::AQUFETP_data aqufetp_data_;
@@ -149,6 +182,7 @@ namespace Opm
 
         Scalar mu_w_; //water viscosity
         Scalar Tc_;   // Time Constant
+        Scalar inflowFactor_ = 0.; // productivity index times the time factor, set by beginIteration()
         Scalar pa0_;    // initial aquifer pressure
         Scalar aquifer_pressure_; // aquifer pressure
 
@@ -203,12 +237,9 @@ namespace Opm
           return pa_;
         }
         // This function implements Eq 5.14 of the EclipseTechnicalDescription
-        inline void calculateInflowRate(int idx, const Simulator& simulator)
+        inline void calculateInflowRate(int idx)
         {
-          Tc_ = ( aqufetp_data_.C_t * aqufetp_data_.V0 ) / aqufetp_data_.J ;
-          Scalar td_Tc_ = simulator.timeStepSize() / Tc_ ;
-          Scalar exp_ = (1 - exp(-td_Tc_)) / td_Tc_;
-          Qai_.at(idx) = alphai_.at(idx) * aqufetp_data_.J * dpai(idx) * exp_;
+          Qai_.at(idx) = alphai_.at(idx) * inflowFactor_ * dpai(idx);
         }
 
         template<class faceCellType, class ugridType>
@@ -265,10 +296,12 @@ namespace Opm
             // denom_face_areas is the sum of the areas connected to an aquifer
             Scalar denom_face_areas = 0.;
             cellToConnectionIdx_.resize(ebos_simulator_.gridView().size(/*codim=*/0), -1);
+            connectionCells_.resize(cell_idx_.size());
             for (size_t idx = 0; idx < cell_idx_.size(); ++idx)
             {
               const int cell_index = cartesian_to_compressed_.at(cell_idx_[idx]);
               cellToConnectionIdx_[cell_index] = idx;
+              connectionCells_[idx] = cell_index;
               const auto cellFacesRange = cell2Faces[cell_index];
               for(auto cellFaceIter = cellFacesRange.begin(); cellFaceIter != cellFacesRange.end(); ++cellFaceIter)
               {
@@ -355,6 +388,41 @@ namespace Opm
             std::vector<Scalar> pw_aquifer;
             Scalar water_pressure_reservoir;
 
+            forEachConnection_([&](int idx, const IntensiveQuantities& iq0) {
+              const auto& fs = iq0.fluidState();
+
+              water_pressure_reservoir = fs.pressure(waterPhaseIdx).value();
+              rhow_[idx] = fs.density(waterPhaseIdx);
+              pw_aquifer.push_back( (water_pressure_reservoir - rhow_[idx].value()*gravity_()*(cell_depth_[idx] - aqufetp_data_.d0))*alphai_[idx] );
+            });
+
+            // We take the average of the calculated equilibrium pressures.
+            Scalar aquifer_pres_avg = std::accumulate(pw_aquifer.begin(), pw_aquifer.end(), 0.)/pw_aquifer.size();
+            return aquifer_pres_avg;
+          }
+
+          // Call function(idx, intQuants) for the connections, one per connected cell.
+          // The cached intensive quantities of the cells are used if they are
+          // available, such that the cost scales with the number of connections.
+          // Otherwise the grid is swept once to update them for the connected cells.
+          template <class Function>
+          void forEachConnection_(const Function& function) const
+          {
+            const auto& model = ebos_simulator_.model();
+            const bool cached = std::all_of(connectionCells_.begin(), connectionCells_.end(),
+                                            [&model](int cellIdx) {
+                                              return model.cachedIntensiveQuantities(cellIdx, /*timeIdx=*/0) != nullptr;
+                                            });
+            if (cached) {
+              for (size_t idx = 0; idx < connectionCells_.size(); ++idx) {
+                const int cellIdx = connectionCells_[idx];
+                if (cellToConnectionIdx_[cellIdx] == static_cast<int>(idx)) {
+                  function(idx, *model.cachedIntensiveQuantities(cellIdx, /*timeIdx=*/0));
+                }
+              }
+              return;
+            }
+
             ElementContext elemCtx(ebos_simulator_);
             const auto& gridView = ebos_simulator_.gridView();
             auto elemIt = gridView.template begin</*codim=*/0>();
@@ -369,17 +437,8 @@ namespace Opm
               continue;
 
               elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
-              const auto& iq0 = elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
-              const auto& fs = iq0.fluidState();
-
-              water_pressure_reservoir = fs.pressure(waterPhaseIdx).value();
-              rhow_[idx] = fs.density(waterPhaseIdx);
-              pw_aquifer.push_back( (water_pressure_reservoir - rhow_[idx].value()*gravity_()*(cell_depth_[idx] - aqufetp_data_.d0))*alphai_[idx] );
+              function(idx, elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0));
             }
-
-            // We take the average of the calculated equilibrium pressures.
-            Scalar aquifer_pres_avg = std::accumulate(pw_aquifer.begin(), pw_aquifer.end(), 0.)/pw_aquifer.size();
-            return aquifer_pres_avg;
           }
         }; //Class AquiferFetkovich
       } // namespace Opm
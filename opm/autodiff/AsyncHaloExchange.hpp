@@ -0,0 +1,208 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_ASYNCHALOEXCHANGE_HEADER_INCLUDED
+#define OPM_ASYNCHALOEXCHANGE_HEADER_INCLUDED
+
+#if HAVE_MPI
+
+#include <opm/common/utility/platform_dependent/disable_warnings.h>
+#include <dune/common/enumset.hh>
+#include <dune/common/parallel/interface.hh>
+#include <dune/common/parallel/mpitraits.hh>
+#include <dune/istl/owneroverlapcopy.hh>
+#include <opm/common/utility/platform_dependent/reenable_warnings.h>
+
+#include <mpi.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace Opm
+{
+
+/// \brief Non-blocking variant of OwnerOverlapCopyCommunication::copyOwnerToAll.
+///
+/// begin() posts the messages and returns, end() waits for them and writes
+/// the values received from the owners. In between the caller can do work
+/// that does not need the received values, e.g. the rows of a mat-vec
+/// product without ghost columns (see receivesValue()).
+///
+/// The messages are persistent requests on buffers kept between the
+/// exchanges, as the pattern is fixed. They are set up by the first
+/// exchange and again if the block size of the vectors changes.
+template<class GlobalIndex, class LocalIndex>
+class AsyncHaloExchange
+{
+public:
+    typedef Dune::OwnerOverlapCopyCommunication<GlobalIndex, LocalIndex> Communication;
+
+    /// \brief Constructor.
+    ///
+    /// The remote indices of the communication have to be set up already.
+    /// \param comm The parallel information.
+    /// \param size The number of (block) entries of the vectors.
+    AsyncHaloExchange(const Communication& comm, std::size_t size)
+        : mpiComm_(comm.communicator()), receives_(size, false), blockSize_(0)
+    {
+        typedef Dune::OwnerOverlapCopyAttributeSet::AttributeSet Attribute;
+        Dune::EnumItem<Attribute, Dune::OwnerOverlapCopyAttributeSet::owner> ownerFlags;
+        Dune::AllSet<Attribute> allFlags;
+        Dune::Interface interface;
+        interface.build(comm.remoteIndices(), ownerFlags, allFlags);
+
+        for ( const auto& entry : interface.interfaces() )
+        {
+            Neighbor neighbor;
+            neighbor.rank = entry.first;
+            const auto& sendInfo = entry.second.first;
+            const auto& receiveInfo = entry.second.second;
+            for ( std::size_t i = 0; i < sendInfo.size(); ++i )
+            {
+                neighbor.send.push_back(sendInfo[i]);
+            }
+            for ( std::size_t i = 0; i < receiveInfo.size(); ++i )
+            {
+                neighbor.receive.push_back(receiveInfo[i]);
+                receives_[receiveInfo[i]] = true;
+            }
+            if ( !neighbor.send.empty() || !neighbor.receive.empty() )
+            {
+                neighbors_.push_back(neighbor);
+            }
+        }
+    }
+
+    ~AsyncHaloExchange()
+    {
+        freeRequests_();
+    }
+
+    AsyncHaloExchange(const AsyncHaloExchange&) = delete;
+    AsyncHaloExchange& operator=(const AsyncHaloExchange&) = delete;
+
+    /// \brief Whether entry i is overwritten by a value of its owner.
+    bool receivesValue(std::size_t i) const
+    {
+        return receives_[i];
+    }
+
+    /// \brief Post the messages with the owner values of x.
+    ///
+    /// x is only read here, it may change before end() is called.
+    template<class X>
+    void begin(const X& x)
+    {
+        const std::size_t blockSize = X::block_type::dimension;
+        if ( blockSize != blockSize_ )
+        {
+            initRequests_(blockSize);
+        }
+        for ( auto& neighbor : neighbors_ )
+        {
+            std::size_t pos = 0;
+            for ( const auto index : neighbor.send )
+            {
+                for ( std::size_t k = 0; k < blockSize; ++k )
+                {
+                    neighbor.sendBuffer[pos++] = x[index][k];
+                }
+            }
+        }
+        if ( !requests_.empty() )
+        {
+            MPI_Startall(requests_.size(), requests_.data());
+        }
+    }
+
+    /// \brief Wait for the messages posted by begin() and copy the owner values to y.
+    template<class X>
+    void end(X& y)
+    {
+        const std::size_t blockSize = X::block_type::dimension;
+        MPI_Waitall(requests_.size(), requests_.data(), MPI_STATUSES_IGNORE);
+        for ( const auto& neighbor : neighbors_ )
+        {
+            std::size_t pos = 0;
+            for ( const auto index : neighbor.receive )
+            {
+                for ( std::size_t k = 0; k < blockSize; ++k )
+                {
+                    y[index][k] = neighbor.receiveBuffer[pos++];
+                }
+            }
+        }
+    }
+
+private:
+    static const int tag = 4712;
+
+    // create the persistent requests on buffers for vectors with the given block size
+    void initRequests_(std::size_t blockSize)
+    {
+        freeRequests_();
+        const MPI_Datatype type = Dune::MPITraits<double>::getType();
+        requests_.assign(2 * neighbors_.size(), MPI_REQUEST_NULL);
+        for ( std::size_t n = 0; n < neighbors_.size(); ++n )
+        {
+            auto& neighbor = neighbors_[n];
+            neighbor.receiveBuffer.resize(neighbor.receive.size() * blockSize);
+            neighbor.sendBuffer.resize(neighbor.send.size() * blockSize);
+            MPI_Recv_init(neighbor.receiveBuffer.data(), neighbor.receiveBuffer.size(), type,
+                          neighbor.rank, tag, mpiComm_, &requests_[2 * n]);
+            MPI_Send_init(neighbor.sendBuffer.data(), neighbor.sendBuffer.size(), type,
+                          neighbor.rank, tag, mpiComm_, &requests_[2 * n + 1]);
+        }
+        blockSize_ = blockSize;
+    }
+
+    void freeRequests_()
+    {
+        for ( auto& request : requests_ )
+        {
+            if ( request != MPI_REQUEST_NULL )
+            {
+                MPI_Request_free(&request);
+            }
+        }
+        requests_.clear();
+        blockSize_ = 0;
+    }
+
+    struct Neighbor
+    {
+        int rank;
+        std::vector<std::size_t> send;
+        std::vector<std::size_t> receive;
+        std::vector<double> sendBuffer;
+        std::vector<double> receiveBuffer;
+    };
+
+    MPI_Comm mpiComm_;
+    std::vector<bool> receives_;
+    std::vector<Neighbor> neighbors_;
+    std::vector<MPI_Request> requests_;
+    std::size_t blockSize_;
+};
+
+} // end namespace Opm
+
+#endif // HAVE_MPI
+
+#endif // OPM_ASYNCHALOEXCHANGE_HEADER_INCLUDED
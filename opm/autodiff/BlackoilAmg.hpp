@@ -20,8 +20,12 @@
 #define OPM_AMG_HEADER_INCLUDED
 
 #include <ewoms/linear/matrixblock.hh>
+#include <opm/autodiff/AmgSmoothers.hpp>
 #include <opm/autodiff/ParallelOverlappingILU0.hpp>
 #include <opm/autodiff/CPRPreconditioner.hpp>
+#include <opm/autodiff/PressureSolverBackend.hpp>
+#include <opm/autodiff/AmgHierarchyStatistics.hpp>
+#include <opm/autodiff/TimingRegistry.hpp>
 #include <dune/istl/paamg/twolevelmethod.hh>
 #include <dune/istl/paamg/aggregates.hh>
 #include <dune/istl/bvector.hh>
@@ -32,6 +36,11 @@
 #include <dune/istl/scalarproducts.hh>
 #include <dune/common/fvector.hh>
 #include <dune/common/fmatrix.hh>
+
+#include <memory>
+#include <type_traits>
+#include <vector>
+
 namespace Dune
 {
 namespace Amg
@@ -81,24 +90,18 @@ Dune::OverlappingSchwarzOperator<M,X,Y,T> createOperator(const Dune::Overlapping
     return Dune::OverlappingSchwarzOperator<M,X,Y,T>(matrix, comm);
 }
 
-//! \brief Applies diagonal scaling to the discretization Matrix (Scheichl, 2003)
+//! \brief Applies diagonal scaling to the entries of a matrix in place (Scheichl, 2003)
 //!
 //! See section 3.2.3 of Scheichl, Masson: Decoupling and Block Preconditioning for
 //! Sedimentary Basin Simulations, 2003.
-//! \param op The operator that stems from the discretization.
-//! \param comm The communication objecte describing the data distribution.
+//! \param matrix The matrix to scale.
 //! \param pressureIndex The index of the pressure in the matrix block
-//! \retun A pair of the scaled matrix and the associated operator-
-template<class Operator, class Communication>
-std::tuple<std::unique_ptr<typename Operator::matrix_type>, Operator>
-scaleMatrixQuasiImpes(const Operator& op, const Communication& comm,
-                      std::size_t pressureIndex)
+template<class Matrix>
+void scaleMatrixEntriesQuasiImpes(Matrix& matrix, std::size_t pressureIndex)
 {
-    using Matrix = typename Operator::matrix_type;
     using Block = typename Matrix::block_type;
-    std::unique_ptr<Matrix> matrix(new Matrix(op.getmat()));
 
-    for ( auto& row : *matrix )
+    for ( auto& row : matrix )
     {
         for ( auto& block : row )
         {
@@ -114,7 +117,31 @@ scaleMatrixQuasiImpes(const Operator& op, const Communication& comm,
             }
         }
     }
-    return std::make_tuple(std::move(matrix), createOperator(op, *matrix, comm));
+}
+
+//! \brief Copies the entries of a matrix to one with the same sparsity pattern.
+//!
+//! In contrast to the assignment operator of the BCRSMatrix no memory is
+//! reallocated.
+//! \param from The matrix to copy the entries from.
+//! \param to The matrix to copy the entries to.
+template<class Matrix>
+void copyMatrixEntries(const Matrix& from, Matrix& to)
+{
+    assert( from.N() == to.N() && from.nonzeroes() == to.nonzeroes() );
+    auto toRow = to.begin();
+
+    for ( const auto& row: from )
+    {
+        auto toCol = toRow->begin();
+
+        for ( auto col = row.begin(), cend = row.end(); col != cend; ++col, ++toCol )
+        {
+            assert( col.index() == toCol.index() );
+            *toCol = *col;
+        }
+        ++toRow;
+    }
 }
 
 //! \brief Applies diagonal scaling to the discretization Matrix (Scheichl, 2003)
@@ -140,6 +167,270 @@ void scaleVectorQuasiImpes(Vector& vector, std::size_t pressureIndex)
     }
 }
 
+//! \brief Applies the true-IMPES decoupling to the entries of a matrix in place.
+//!
+//! The pressure row of each block in block row i is replaced by the combination
+//! of all rows of the block with the weights of cell i. The weights stem from the
+//! derivatives of the accumulation terms (see BlackoilModelEbos). With all weights
+//! being one this is scaleMatrixEntriesQuasiImpes.
+//! \param matrix The matrix to scale.
+//! \param weights The weights of the equations of each cell.
+//! \param pressureIndex The index of the pressure in the matrix block
+template<class Matrix, class Vector>
+void scaleMatrixEntriesTrueImpes(Matrix& matrix, const Vector& weights, std::size_t pressureIndex)
+{
+    using Block = typename Matrix::block_type;
+    using Row = Dune::FieldVector<typename Matrix::field_type, Block::cols>;
+
+    for ( auto row = matrix.begin(), rowEnd = matrix.end(); row != rowEnd; ++row )
+    {
+        const auto& weight = weights[row.index()];
+        for ( auto& block : *row )
+        {
+            Row pressureRow(0.0);
+            for ( std::size_t i = 0; i < Block::rows; i++ )
+            {
+                pressureRow.axpy(weight[i], block[i]);
+            }
+            block[pressureIndex] = pressureRow;
+        }
+    }
+}
+
+//! \brief Applies the true-IMPES decoupling to a vector in place.
+//!
+//! \see scaleMatrixEntriesTrueImpes
+//! \param vector The vector to scale
+//! \param weights The weights of the equations of each cell.
+//! \param pressureIndex The index of the pressure in the matrix block
+template<class Vector>
+void scaleVectorTrueImpes(Vector& vector, const Vector& weights, std::size_t pressureIndex)
+{
+    using Block = typename Vector::block_type;
+
+    for ( std::size_t row = 0; row < vector.size(); ++row )
+    {
+        auto& block = vector[row];
+        typename Vector::field_type pressure = 0.0;
+        for ( std::size_t i = 0; i < Block::dimension; i++ )
+        {
+            pressure += weights[row][i] * block[i];
+        }
+        block[pressureIndex] = pressure;
+    }
+}
+
+//! \brief Whether a smoother copies the matrix entries it needs during its setup.
+//!
+//! Such smoothers do not access the matrix in apply() and can be set up from
+//! a matrix that is scaled only temporarily. Smoothers like SSOR or Jacobi apply
+//! the matrix itself and need a permanently scaled copy.
+template<class Smoother>
+struct SmootherCopiesMatrix
+{
+    template<class Args>
+    static bool value(const Args&)
+    {
+        return false;
+    }
+};
+
+template<class M, class X, class Y, class C>
+struct SmootherCopiesMatrix<ParallelOverlappingILU0<M,X,Y,C> >
+{
+    template<class Args>
+    static bool value(const Args&)
+    {
+        return true;
+    }
+};
+
+template<class M, class X, class Y, class C>
+struct SmootherCopiesMatrix<AmgLevelSmoother<M,X,Y,C> >
+{
+    template<class Args>
+    static bool value(const Args& args)
+    {
+        return args.getSmoother() != AMG_SMOOTHER::CHEBYSHEV;
+    }
+};
+
+/**
+ * \brief The operator of the system scaled with the quasi-IMPES weights (Scheichl, 2003).
+ *
+ * If weights are given, the true-IMPES weights of each cell are used instead
+ * (see scaleMatrixEntriesTrueImpes).
+ * The scaled matrix is only needed explicitly while the smoother and
+ * the coarse level system are set up. Instead of copying the whole matrix,
+ * scale() scales the matrix of the fine operator in place and restore()
+ * restores it exactly, which only saves the pressure row of each block.
+ * In between, apply() multiplies with the original matrix and scales the
+ * result. If the smoother needs the scaled matrix during its application
+ * (see SmootherCopiesMatrix), a scaled copy is used as before.
+ * \tparam Operator The type of the fine operator.
+ * \tparam Communication The type of the information about the parallelization.
+ */
+template<class Operator, class Communication>
+class QuasiImpesOperator
+    : public Operator
+{
+public:
+    using Matrix = typename Operator::matrix_type;
+    using domain_type = typename Operator::domain_type;
+    using range_type = typename Operator::range_type;
+    using field_type = typename Operator::field_type;
+
+    /**
+     * \brief Constructor. The matrix of the operator is scaled afterwards.
+     * \param op The operator that stems from the discretization.
+     * \param comm The communication object describing the data distribution.
+     * \param pressureIndex The index of the pressure in the matrix block.
+     * \param inPlace Whether to scale the matrix of op in place instead of copying it.
+     * \param weights The true-IMPES weights of each cell or nullptr to use the
+     *                quasi-IMPES weights. The entries may change between calls
+     *                of scale(), but have to outlive the operator.
+     */
+    QuasiImpesOperator(const Operator& op, const Communication& comm,
+                       std::size_t pressureIndex, bool inPlace,
+                       const range_type* weights = nullptr)
+        : Operator(op), comm_(&comm), weights_(weights), pressureIndex_(pressureIndex),
+          inPlace_(inPlace), scaled_(false)
+    {
+        scale(op.getmat());
+    }
+
+    ~QuasiImpesOperator()
+    {
+        restore();
+    }
+
+    /**
+     * \brief Scales the matrix (or a copy of it).
+     * \param matrix The matrix to scale. It must have the sparsity pattern
+     *               of the one used for construction.
+     */
+    void scale(const Matrix& matrix)
+    {
+        restore();
+        original_ = &matrix;
+
+        if ( !inPlace_ )
+        {
+            if ( copy_ )
+            {
+                copyMatrixEntries(matrix, *copy_);
+            }
+            else
+            {
+                copy_.reset(new Matrix(matrix));
+            }
+            scaleMatrixEntries(*copy_);
+            return;
+        }
+
+        pressureRows_.resize(matrix.nonzeroes());
+        auto saved = pressureRows_.begin();
+        for ( const auto& row : matrix )
+        {
+            for ( const auto& block : row )
+            {
+                *saved++ = block[pressureIndex_];
+            }
+        }
+        // The matrix is owned by the caller and not const itself.
+        scaleMatrixEntries(const_cast<Matrix&>(matrix));
+        scaled_ = true;
+    }
+
+    /// \brief Applies the same scaling as for the matrix to a vector.
+    void scaleVector(range_type& vector) const
+    {
+        if ( weights_ )
+        {
+            scaleVectorTrueImpes(vector, *weights_, pressureIndex_);
+        }
+        else
+        {
+            scaleVectorQuasiImpes(vector, pressureIndex_);
+        }
+    }
+
+    /// \brief Whether the matrix is scaled in place instead of copied.
+    bool inPlace() const
+    {
+        return inPlace_;
+    }
+
+    /// \brief Restores the original entries of a matrix scaled in place.
+    void restore()
+    {
+        if ( !scaled_ )
+        {
+            return;
+        }
+        auto saved = pressureRows_.cbegin();
+        for ( auto& row : const_cast<Matrix&>(*original_) )
+        {
+            for ( auto& block : row )
+            {
+                block[pressureIndex_] = *saved++;
+            }
+        }
+        scaled_ = false;
+    }
+
+    const Matrix& getmat() const override
+    {
+        return copy_ ? *copy_ : *original_;
+    }
+
+    void apply(const domain_type& x, range_type& y) const override
+    {
+        createOperator(static_cast<const Operator&>(*this), getmat(), *comm_).apply(x, y);
+        if ( !copy_ && !scaled_ )
+        {
+            scaleVector(y);
+        }
+    }
+
+    void applyscaleadd(field_type alpha, const domain_type& x, range_type& y) const override
+    {
+        if ( copy_ || scaled_ )
+        {
+            createOperator(static_cast<const Operator&>(*this), getmat(), *comm_).applyscaleadd(alpha, x, y);
+            return;
+        }
+        tmp_.resize(y.size());
+        apply(x, tmp_);
+        y.axpy(alpha, tmp_);
+    }
+
+private:
+    using PressureRow = Dune::FieldVector<typename Matrix::field_type, Matrix::block_type::cols>;
+
+    void scaleMatrixEntries(Matrix& matrix) const
+    {
+        if ( weights_ )
+        {
+            scaleMatrixEntriesTrueImpes(matrix, *weights_, pressureIndex_);
+        }
+        else
+        {
+            scaleMatrixEntriesQuasiImpes(matrix, pressureIndex_);
+        }
+    }
+
+    const Matrix* original_;
+    std::unique_ptr<Matrix> copy_;
+    std::vector<PressureRow> pressureRows_;
+    const Communication* comm_;
+    const range_type* weights_;
+    std::size_t pressureIndex_;
+    bool inPlace_;
+    bool scaled_;
+    mutable range_type tmp_;
+};
+
 //! \brief TMP to create the scalar pendant to a real block matrix, vector, smoother, etc.
 //!
 //! \code
@@ -272,6 +563,15 @@ struct ScalarType<ParallelOverlappingILU0<M,X,Y,C> >
                                     C> value;
 };
 
+template<class M, class X, class Y, class C>
+struct ScalarType<AmgLevelSmoother<M,X,Y,C> >
+{
+    typedef AmgLevelSmoother<typename ScalarType<M>::value,
+                             typename ScalarType<X>::value,
+                             typename ScalarType<Y>::value,
+                             C> value;
+};
+
 template<class B, class N>
 struct ScalarType<Dune::Amg::CoarsenCriterion<Dune::Amg::SymmetricCriterion<Dune::BCRSMatrix<B>,N> > >
 {
@@ -337,12 +637,13 @@ public:
      * @param c The crition used for the aggregation within AMG.
      */
     OneStepAMGCoarseSolverPolicy(const CPRParameter* param, const SmootherArgs& args, const Criterion& c)
-        : param_(param), smootherArgs_(args), criterion_(c)
+        : param_(param), smootherArgs_(args), criterion_(c),
+          transferPolicy_(nullptr), coarseSolver_(nullptr)
     {}
     /** @brief Copy constructor. */
     OneStepAMGCoarseSolverPolicy(const OneStepAMGCoarseSolverPolicy& other)
-        : param_(other.param_), coarseOperator_(other.coarseOperator_), smootherArgs_(other.smootherArgs_),
-          criterion_(other.criterion_)
+        : coarseOperator_(other.coarseOperator_), param_(other.param_), smootherArgs_(other.smootherArgs_),
+          criterion_(other.criterion_), transferPolicy_(nullptr), coarseSolver_(nullptr)
     {}
 private:
     /**
@@ -358,19 +659,42 @@ private:
                            const Criterion& crit,
                            const typename AMGType::SmootherArgs& args,
                            const Communication& comm)
-            : param_(param), amg_(), smoother_(), op_(op), comm_(comm)
+            : param_(param), amg_(), smoother_(), op_(op), comm_(comm), args_(args)
         {
-            if ( param_->cpr_use_amg_ )
+            if ( !param_->cpr_pressure_solver_.empty() )
+            {
+                backend_ = PressureSolverRegistry<typename AMGType::Operator, X, Communication>
+                    ::create(param_->cpr_pressure_solver_, op, comm, *param_);
+            }
+            else if ( param_->cpr_use_amg_ )
             {
                 amg_.reset(new AMGType(op, crit,args, comm));
             }
             else
             {
-                typename Dune::Amg::ConstructionTraits<Smoother>::Arguments cargs;
-                cargs.setMatrix(op.getmat());
-                cargs.setComm(comm);
-                cargs.setArgs(args);
-                smoother_.reset(Dune::Amg::ConstructionTraits<Smoother>::construct(cargs));
+                setupSmoother();
+            }
+        }
+
+        /**
+         * @brief Updates the solver after the entries of the coarse matrix changed.
+         *
+         * For AMG only the Galerkin products of the hierarchy are recomputed.
+         * The smoothers on the levels of AMG are kept from the last setup.
+         */
+        void updatePreconditioner()
+        {
+            if ( backend_ )
+            {
+                backend_->update();
+            }
+            else if ( amg_ )
+            {
+                amg_->recalculateHierarchy();
+            }
+            else
+            {
+                setupSmoother();
             }
         }
 
@@ -387,6 +711,15 @@ private:
             DUNE_UNUSED_PARAMETER(reduction);
             DUNE_UNUSED_PARAMETER(res);
 
+            static auto& timing = TimingRegistry::instance().entry("cpr.coarse_solve");
+            ScopedTiming scopedTiming(timing);
+
+            if ( backend_ )
+            {
+                backend_->apply(x, b, res);
+                return;
+            }
+
 #if DUNE_VERSION_NEWER(DUNE_ISTL, 2, 6)
             auto sp = Dune::createScalarProduct<X,Communication>(comm_, op_.category());
 #else
@@ -464,6 +797,14 @@ private:
             return apply(x,b,1e-8,res);
         }
 
+        /**
+         * @brief The AMG of the coarse level, nullptr if it is solved otherwise.
+         */
+        AMGType* amg() const
+        {
+            return amg_.get();
+        }
+
         ~AMGInverseOperator()
         {}
         AMGInverseOperator(const AMGInverseOperator& other)
@@ -471,12 +812,24 @@ private:
         {
         }
     private:
+        void setupSmoother()
+        {
+            typename Dune::Amg::ConstructionTraits<Smoother>::Arguments cargs;
+            cargs.setMatrix(op_.getmat());
+            cargs.setComm(comm_);
+            cargs.setArgs(args_);
+            smoother_.reset(Dune::Amg::ConstructionTraits<Smoother>::construct(cargs));
+        }
+
         const CPRParameter* param_;
         X x_;
         std::unique_ptr<AMGType> amg_;
         std::unique_ptr<Smoother> smoother_;
+        //! \brief The external pressure solver (if cpr_pressure_solver_ is set).
+        std::unique_ptr<PressureSolverBackend<X> > backend_;
         const typename AMGType::Operator& op_;
         const Communication& comm_;
+        typename AMGType::SmootherArgs args_;
     };
 
 public:
@@ -493,18 +846,57 @@ public:
     CoarseLevelSolver* createCoarseLevelSolver(LTP& transferPolicy)
     {
         coarseOperator_=transferPolicy.getCoarseLevelOperator();
-        const LevelTransferPolicy& transfer =
-            reinterpret_cast<const LevelTransferPolicy&>(transferPolicy);
+        LevelTransferPolicy& transfer =
+            reinterpret_cast<LevelTransferPolicy&>(transferPolicy);
         AMGInverseOperator* inv = new AMGInverseOperator(param_,
                                                          *coarseOperator_,
                                                          criterion_,
                                                          smootherArgs_,
                                                          transfer.getCoarseLevelCommunication());
+        // remember both to be able to update them later on.
+        transferPolicy_ = &transfer;
+        coarseSolver_ = inv;
 
         return inv; //std::shared_ptr<InverseOperator<X,X> >(inv);
 
     }
 
+    /**
+     * @brief Updates the coarse level system and solver for new fine level entries.
+     *
+     * The aggregates and the sparsity pattern of the coarse level system
+     * created with createCoarseLevelSolver are kept. Only the entries of the
+     * coarse level matrix and of the solver are recomputed.
+     * @param fineOperator The fine level operator with the new entries.
+     */
+    template<class FineOperator>
+    void updateCoarseLevelSolver(const FineOperator& fineOperator)
+    {
+        assert( transferPolicy_ && coarseSolver_ );
+        transferPolicy_->calculateCoarseEntries(fineOperator.getmat());
+        coarseSolver_->updatePreconditioner();
+    }
+
+    /**
+     * @brief Add the levels of the AMG of the coarse level to the statistics.
+     *
+     * The coarsest level becomes that of the AMG, its aggregates are in rows
+     * of the coarse level. Nothing is added if the coarse level is solved otherwise.
+     */
+    void addCoarseLevelStatistics(AmgHierarchyStatistics& statistics) const
+    {
+        AMGType* amg = coarseSolver_ ? coarseSolver_->amg() : nullptr;
+        if ( !amg )
+        {
+            return;
+        }
+        // the first level of the AMG is the coarse level of CPR
+        statistics.levels += amg->levels() - 1;
+        std::vector<std::size_t> aggregateOfRow;
+        amg->getCoarsestAggregateNumbers(aggregateOfRow);
+        statistics.setCoarsestAggregates(aggregateOfRow);
+    }
+
 private:
     /** @brief The coarse level operator. */
     std::shared_ptr<Operator> coarseOperator_;
@@ -514,6 +906,10 @@ private:
     SmootherArgs smootherArgs_;
     /** @brief The coarsening criterion. */
     Criterion criterion_;
+    /** @brief The transfer policy used to create the coarse level system (not owned). */
+    LevelTransferPolicy* transferPolicy_;
+    /** @brief The last coarse level solver created (owned by the two level method). */
+    AMGInverseOperator* coarseSolver_;
 };
 
 template<class Smoother, class Operator, class Communication>
@@ -637,6 +1033,43 @@ void buildCoarseSparseMatrix(M& coarseMatrix, G& fineGraph, const V& visitedMap,
         ::examine(fineGraph, visitedMap, pinfo, aggregates, sparsityBuilder);
 }
 
+/**
+ * \brief Computes a fingerprint of the sparsity pattern and the signs of the
+ *        couplings of one component of a block matrix.
+ *
+ * Aggregates computed for a matrix with the same fingerprint are considered
+ * to be still suitable for coarsening.
+ * \tparam COMPONENT_INDEX The index of the component used for coarsening.
+ */
+template<std::size_t COMPONENT_INDEX, class M>
+std::size_t pressureCouplingFingerprint(const M& matrix)
+{
+    std::size_t hash = matrix.N();
+    auto combine = [&hash](std::size_t value)
+        {
+            hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+        };
+    combine(matrix.nonzeroes());
+    for ( const auto& row: matrix )
+    {
+        for ( auto col = row.begin(), cend = row.end(); col != cend; ++col )
+        {
+            combine(2 * col.index() + ((*col)[COMPONENT_INDEX][COMPONENT_INDEX] < 0));
+        }
+    }
+    return hash;
+}
+
+template<class T>
+struct IsSequentialInformation
+    : public std::false_type
+{};
+
+template<>
+struct IsSequentialInformation<Dune::Amg::SequentialInformation>
+    : public std::true_type
+{};
+
 } // end namespace Detail
 
 /**
@@ -655,6 +1088,39 @@ public:
     typedef Dune::Amg::LevelTransferPolicy<Operator,CoarseOperator> FatherType;
     typedef Communication ParallelInformation;
 
+private:
+    using CoarseMatrix = typename CoarseOperator::matrix_type;
+
+    /// \brief The fine rows of each aggregate in compressed form.
+    struct AggregateRows
+    {
+        std::vector<std::size_t> start;
+        std::vector<std::size_t> rows;
+    };
+
+    /// \brief The result of the last aggregation in a sequential run.
+    struct AggregationCache
+    {
+        std::size_t fingerprint = 0;
+        std::shared_ptr<AggregatesMap> aggregatesMap;
+        std::shared_ptr<const AggregateRows> aggregateRows;
+        std::shared_ptr<const CoarseMatrix> coarseMatrix;
+    };
+
+    /// \brief The cache shared by all instances.
+    ///
+    /// The preconditioner is usually recreated for each linear solve,
+    /// but the pressure couplings rarely change between them. Hence
+    /// the aggregates and the coarse sparsity pattern are reused as long as
+    /// the fingerprint of the fine matrix is unchanged. This is only done in
+    /// sequential runs, as in parallel the aggregates are tied to the
+    /// communication objects.
+    static AggregationCache& aggregationCache()
+    {
+        static AggregationCache cache;
+        return cache;
+    }
+
 public:
     OneComponentAggregationLevelTransferPolicy(const Criterion& crit, const Communication& comm,
                                                bool cpr_pressure_aggregation)
@@ -666,7 +1132,26 @@ public:
     {
         prolongDamp_ = 1;
 
-        if ( cpr_pressure_aggregation_ )
+        const bool useCache = Detail::IsSequentialInformation<Communication>::value;
+        std::size_t fingerprint = 0;
+        if ( cpr_pressure_aggregation_ && useCache )
+        {
+            fingerprint = Detail::pressureCouplingFingerprint<COMPONENT_INDEX>(fineOperator.getmat());
+        }
+        auto& cache = aggregationCache();
+
+        if ( cpr_pressure_aggregation_ && useCache && cache.aggregatesMap
+             && cache.fingerprint == fingerprint )
+        {
+            aggregatesMap_ = cache.aggregatesMap;
+            aggregateRows_ = cache.aggregateRows;
+            coarseLevelMatrix_.reset(new CoarseMatrix(*cache.coarseMatrix));
+            using CommunicationArgs = typename Dune::Amg::ConstructionTraits<Communication>::Arguments;
+            CommunicationArgs commArgs(communication_->communicator(), communication_->getSolverCategory());
+            coarseLevelCommunication_.reset(Dune::Amg::ConstructionTraits<Communication>::construct(commArgs));
+            calculateCoarseEntries(fineOperator.getmat());
+        }
+        else if ( cpr_pressure_aggregation_ )
         {
 #if DUNE_VERSION_NEWER(DUNE_ISTL, 2, 6)
             typedef Dune::Amg::PropertiesGraphCreator<Operator,Communication> GraphCreator;
@@ -716,7 +1201,6 @@ public:
 
             Dune::IteratorPropertyMap<Iterator, Dune::IdentityMap>
                 visitedMap2(visited.begin(), Dune::IdentityMap());
-            using CoarseMatrix = typename CoarseOperator::matrix_type;
             coarseLevelMatrix_.reset(new CoarseMatrix(aggregates, aggregates,
                                                       CoarseMatrix::row_wise));
             Detail::buildCoarseSparseMatrix(*coarseLevelMatrix_, *get<0>(graphs), visitedMap2,
@@ -730,11 +1214,19 @@ public:
             {
                 coarseLevelCommunication_->freeGlobalLookup();
             }
+            aggregateRows_ = createAggregateRows(fineOperator.getmat().N(), aggregates);
             calculateCoarseEntries(fineOperator.getmat());
+
+            if ( useCache )
+            {
+                cache.fingerprint = fingerprint;
+                cache.aggregatesMap = aggregatesMap_;
+                cache.aggregateRows = aggregateRows_;
+                cache.coarseMatrix = coarseLevelMatrix_;
+            }
         }
         else
         {
-            using CoarseMatrix = typename CoarseOperator::matrix_type;
             const auto& fineLevelMatrix = fineOperator.getmat();
             coarseLevelMatrix_.reset(new CoarseMatrix(fineLevelMatrix.N(), fineLevelMatrix.M(), CoarseMatrix::row_wise));
             auto createIter = coarseLevelMatrix_->createbegin();
@@ -748,18 +1240,7 @@ public:
                 ++createIter;
             }
 
-            auto coarseRow = coarseLevelMatrix_->begin();
-            for ( const auto& row: fineLevelMatrix )
-            {
-                auto coarseCol = coarseRow->begin();
-
-                for ( auto col = row.begin(), cend = row.end(); col != cend; ++col, ++coarseCol )
-                {
-                    assert( col.index() == coarseCol.index() );
-                    *coarseCol = (*col)[COMPONENT_INDEX][COMPONENT_INDEX];
-                }
-                ++coarseRow;
-            }
+            calculateCoarseEntries(fineLevelMatrix);
             coarseLevelCommunication_.reset(communication_, [](Communication*){});
         }
 
@@ -770,27 +1251,68 @@ public:
         this->operator_.reset(Dune::Amg::ConstructionTraits<CoarseOperator>::construct(oargs));
     }
 
+    /**
+     * \brief Calculates the entries of the coarse level matrix.
+     *
+     * The sparsity pattern of the coarse level matrix has to be set up
+     * already by createCoarseLevelSystem. Therefore this can be used to
+     * update the coarse level system if only the entries of the fine level
+     * matrix changed.
+     * \param fineMatrix The matrix of the fine level.
+     */
     template<class M>
     void calculateCoarseEntries(const M& fineMatrix)
     {
-      *coarseLevelMatrix_ = 0;
-        for(auto row = fineMatrix.begin(), rowEnd = fineMatrix.end();
-            row != rowEnd; ++row)
+        // Each coarse row is computed by one thread only.
+        if ( cpr_pressure_aggregation_ )
         {
-            const auto& i = (*aggregatesMap_)[row.index()];
-            if(i != AggregatesMap::ISOLATED)
+            const auto& aggregateRows = *aggregateRows_;
+            const int numAggregates = coarseLevelMatrix_->N();
+#if HAVE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif // HAVE_OPENMP
+            for ( int i = 0; i < numAggregates; ++i )
             {
-                for(auto entry = row->begin(), entryEnd = row->end();
-                    entry != entryEnd; ++entry)
+                auto& coarseRow = (*coarseLevelMatrix_)[i];
+                for ( auto coarseCol = coarseRow.begin(), cend = coarseRow.end(); coarseCol != cend; ++coarseCol )
                 {
-                    const auto& j = (*aggregatesMap_)[entry.index()];
-                    if ( j != AggregatesMap::ISOLATED )
+                    *coarseCol = 0;
+                }
+
+                for ( std::size_t k = aggregateRows.start[i]; k < aggregateRows.start[i+1]; ++k )
+                {
+                    const auto& row = fineMatrix[aggregateRows.rows[k]];
+                    for(auto entry = row.begin(), entryEnd = row.end();
+                        entry != entryEnd; ++entry)
                     {
-                        (*coarseLevelMatrix_)[i][j] += (*entry)[COMPONENT_INDEX][COMPONENT_INDEX];
+                        const auto& j = (*aggregatesMap_)[entry.index()];
+                        if ( j != AggregatesMap::ISOLATED )
+                        {
+                            coarseRow[j] += (*entry)[COMPONENT_INDEX][COMPONENT_INDEX];
+                        }
                     }
                 }
             }
         }
+        else
+        {
+            const int numRows = fineMatrix.N();
+#if HAVE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif // HAVE_OPENMP
+            for ( int rowIdx = 0; rowIdx < numRows; ++rowIdx )
+            {
+                const auto& row = fineMatrix[rowIdx];
+                auto& coarseRow = (*coarseLevelMatrix_)[rowIdx];
+                auto coarseCol = coarseRow.begin();
+
+                for ( auto col = row.begin(), cend = row.end(); col != cend; ++col, ++coarseCol )
+                {
+                    assert( col.index() == coarseCol.index() );
+                    *coarseCol = (*col)[COMPONENT_INDEX][COMPONENT_INDEX];
+                }
+            }
+        }
     }
 
     void moveToCoarseLevel(const typename FatherType::FineRangeType& fine)
@@ -859,13 +1381,62 @@ public:
     {
         return *coarseLevelCommunication_;
     }
+
+    const CoarseMatrix& getCoarseLevelMatrix() const
+    {
+        return *coarseLevelMatrix_;
+    }
+
+    /// \brief The coarse row of each fine row, a number beyond the fine rows for isolated ones.
+    std::vector<std::size_t> getCoarseRowOfFineRows(const std::size_t numFineRows) const
+    {
+        std::vector<std::size_t> coarseRows(numFineRows);
+        for ( std::size_t row = 0; row < numFineRows; ++row )
+        {
+            coarseRows[row] = aggregatesMap_ ? std::size_t((*aggregatesMap_)[row]) : row;
+        }
+        return coarseRows;
+    }
 private:
+    /// \brief Collect the fine rows of each aggregate (skipping isolated ones).
+    std::shared_ptr<const AggregateRows> createAggregateRows(std::size_t numFineRows,
+                                                             std::size_t numAggregates) const
+    {
+        auto aggregateRows = std::make_shared<AggregateRows>();
+        auto& start = aggregateRows->start;
+        start.assign(numAggregates + 1, 0);
+        for ( std::size_t row = 0; row < numFineRows; ++row )
+        {
+            const auto& i = (*aggregatesMap_)[row];
+            if ( i != AggregatesMap::ISOLATED )
+            {
+                ++start[i + 1];
+            }
+        }
+        for ( std::size_t i = 0; i < numAggregates; ++i )
+        {
+            start[i + 1] += start[i];
+        }
+        aggregateRows->rows.resize(start.back());
+        std::vector<std::size_t> next(start.begin(), start.end() - 1);
+        for ( std::size_t row = 0; row < numFineRows; ++row )
+        {
+            const auto& i = (*aggregatesMap_)[row];
+            if ( i != AggregatesMap::ISOLATED )
+            {
+                aggregateRows->rows[next[i]++] = row;
+            }
+        }
+        return aggregateRows;
+    }
+
     typename Operator::matrix_type::field_type prolongDamp_;
     std::shared_ptr<AggregatesMap> aggregatesMap_;
+    std::shared_ptr<const AggregateRows> aggregateRows_;
     Criterion criterion_;
     Communication* communication_;
     std::shared_ptr<Communication> coarseLevelCommunication_;
-    std::shared_ptr<typename CoarseOperator::matrix_type> coarseLevelMatrix_;
+    std::shared_ptr<CoarseMatrix> coarseLevelMatrix_;
     bool cpr_pressure_aggregation_;
 };
 
@@ -873,7 +1444,8 @@ private:
  * \brief An algebraic twolevel or multigrid approach for solving blackoil (supports CPR with and without AMG)
  *
  * This preconditioner first decouples the component used for coarsening using a simple scaling
- * approach (e.g. Scheichl, Masson 2013,\see scaleMatrixQuasiImpes). Then it constructs the first
+ * approach (e.g. Scheichl, Masson 2013,\see scaleMatrixQuasiImpes) or with true-IMPES
+ * weights (\see scaleMatrixEntriesTrueImpes). Then it constructs the first
  * coarse level system, either by simply extracting the coupling between the components at COMPONENT_INDEX
  * in the matrix blocks or by extracting them and applying aggregation to them directly. This coarse level
  * can be solved either by AMG or by ILU. The preconditioner is configured using CPRParameter.
@@ -942,21 +1514,27 @@ public:
      * \param criterion The criterion describing the coarsening approach.
      * \param smargs The arguments for constructing the smoother.
      * \param comm The information about the parallelization.
+     * \param weights The true-IMPES weights of each cell, or nullptr to use
+     *                the quasi-IMPES weights. Has to outlive the preconditioner,
+     *                updatePreconditioner() uses the current entries.
      */
     BlackoilAmg(const CPRParameter& param,
                 const Operator& fineOperator, const Criterion& criterion,
-                const SmootherArgs& smargs, const Communication& comm)
+                const SmootherArgs& smargs, const Communication& comm,
+                const typename Operator::range_type* weights = nullptr)
         : param_(param),
-          scaledMatrixOperator_(Detail::scaleMatrixQuasiImpes(fineOperator, comm,
-                                                              COMPONENT_INDEX)),
-          smoother_(Detail::constructSmoother<Smoother>(std::get<1>(scaledMatrixOperator_),
-                                                        smargs, comm)),
+          scaledOperator_(fineOperator, comm, COMPONENT_INDEX,
+                          Detail::SmootherCopiesMatrix<Smoother>::value(smargs), weights),
+          smoother_(Detail::constructSmoother<Smoother>(scaledOperator_, smargs, comm)),
           levelTransferPolicy_(criterion, comm, param.cpr_pressure_aggregation_),
           coarseSolverPolicy_(&param, smargs, criterion),
-          twoLevelMethod_(std::get<1>(scaledMatrixOperator_), smoother_,
+          twoLevelMethod_(scaledOperator_, smoother_,
                           levelTransferPolicy_,
                           coarseSolverPolicy_, 0, 1)
-    {}
+    {
+        // Everything that needs the scaled entries is set up.
+        scaledOperator_.restore();
+    }
 
     void pre(typename TwoLevelMethod::FineDomainType& x,
              typename TwoLevelMethod::FineRangeType& b)
@@ -972,13 +1550,59 @@ public:
     void apply(typename TwoLevelMethod::FineDomainType& v,
                const typename TwoLevelMethod::FineRangeType& d)
     {
+        static auto& timing = TimingRegistry::instance().entry("cpr.apply");
+        ScopedTiming scopedTiming(timing);
+
         auto scaledD = d;
-        Detail::scaleVectorQuasiImpes(scaledD, COMPONENT_INDEX);
+        scaledOperator_.scaleVector(scaledD);
         twoLevelMethod_.apply(v, scaledD);
     }
+
+    /**
+     * \brief Updates the preconditioner for new matrix entries.
+     *
+     * The sparsity pattern of the matrix has to be the same as for the
+     * operator used during construction. The aggregates and the sparsity
+     * pattern of the coarse levels are kept. Only the smoother on the fine
+     * level and the entries of the coarse level systems are recomputed from
+     * the scaled matrix. If the matrix is scaled in place (see
+     * Detail::QuasiImpesOperator) it has to be the one used during
+     * construction, as the smoother refers to it.
+     * \param fineOperator The operator of the fine level with the new entries.
+     */
+    void updatePreconditioner(const Operator& fineOperator)
+    {
+        static auto& timing = TimingRegistry::instance().entry("cpr.update");
+        ScopedTiming scopedTiming(timing);
+
+        assert( !scaledOperator_.inPlace()
+                || &fineOperator.getmat() == &scaledOperator_.getmat() );
+        scaledOperator_.scale(fineOperator.getmat());
+        smoother_->update();
+        coarseSolverPolicy_.updateCoarseLevelSolver(scaledOperator_);
+        scaledOperator_.restore();
+    }
+
+    /**
+     * \brief The sizes of the levels of the hierarchy of the last setup.
+     *
+     * Without an AMG for the coarse level the first coarse level is the coarsest.
+     */
+    AmgHierarchyStatistics hierarchyStatistics() const
+    {
+        AmgHierarchyStatistics statistics;
+        const auto& fine = scaledOperator_.getmat();
+        const auto& coarse = levelTransferPolicy_.getCoarseLevelMatrix();
+        statistics.levels = 2;
+        statistics.rows = { fine.N(), coarse.N() };
+        statistics.nonzeroes = { fine.nonzeroes(), coarse.nonzeroes() };
+        statistics.setCoarsestAggregates(levelTransferPolicy_.getCoarseRowOfFineRows(fine.N()));
+        coarseSolverPolicy_.addCoarseLevelStatistics(statistics);
+        return statistics;
+    }
 private:
     const CPRParameter& param_;
-    std::tuple<std::unique_ptr<Matrix>, Operator> scaledMatrixOperator_;
+    Detail::QuasiImpesOperator<Operator, Communication> scaledOperator_;
     std::shared_ptr<Smoother> smoother_;
     LevelTransferPolicy levelTransferPolicy_;
     CoarseSolverPolicy coarseSolverPolicy_;
@@ -1004,7 +1628,7 @@ struct BlackoilAmgSelector
     using Selector = CPRSelector<M,X,Y,P>;
     using ParallelInformation = typename Selector::ParallelInformation;
     using Operator = typename Selector::Operator;
-    using Smoother = typename Selector::EllipticPreconditioner;
+    using Smoother = typename Selector::Smoother;
     using AMG = BlackoilAmg<Operator,Smoother,Criterion,ParallelInformation,index>;
 };
 } // end namespace ISTLUtility
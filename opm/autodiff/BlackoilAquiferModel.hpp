@@ -32,6 +32,8 @@
 #include <opm/simulators/timestepping/SimulatorTimer.hpp>
 #include <opm/autodiff/AquiferCarterTracy.hpp>
 #include <opm/autodiff/AquiferFetkovich.hpp>
+#include <opm/autodiff/CartesianCellIndexMap.hpp>
+#include <opm/autodiff/MemoryRegistry.hpp>
 #include <opm/material/densead/Math.hpp>
 
 namespace Opm {
@@ -60,6 +62,12 @@ namespace Opm {
             void endTimeStep();
             void endEpisode();
 
+            // write and read the state of the aquifers for a restart of the simulation
+            template <class Restarter>
+            void serialize(Restarter& res);
+            template <class Restarter>
+            void deserialize(Restarter& res);
+
         protected:
             // ---------      Types      ---------
             typedef typename GET_PROP_TYPE(TypeTag, ElementContext)      ElementContext;
@@ -70,10 +78,22 @@ namespace Opm {
 
             Simulator& simulator_;
 
-            std::unordered_map<int, int> cartesian_to_compressed_;
+            CartesianCellIndexMap cartesian_to_compressed_;
             mutable  std::vector<AquiferCarterTracy_object> aquifers_CarterTracy;
             mutable  std::vector<AquiferFetkovich_object> aquifers_Fetkovich;
 
+            // The aquifers connected to each cell in compressed row storage: the
+            // aquifers of cell c are cell_aquifers_[cell_aquifer_offsets_[c]] to
+            // cell_aquifers_[cell_aquifer_offsets_[c + 1] - 1], where the Carter-Tracy
+            // aquifers come first and the Fetkovich ones follow.
+            std::vector<int> cell_aquifer_offsets_;
+            std::vector<int> cell_aquifers_;
+            // the memory of the aquifers, for the memory report
+            MemoryAccount memory_{ MemoryRegistry::instance().entry("aquifers") };
+
+            // set up the aquifers of each cell once their connections are known
+            void setupCellAquifers();
+
             // This initialization function is used to connect the parser objects with the ones needed by AquiferCarterTracy
             void init();
 
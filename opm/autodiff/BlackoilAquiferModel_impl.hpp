@@ -1,4 +1,3 @@
-#include <opm/grid/utility/cartesianToCompressed.hpp>
 namespace Opm {
 
   template<typename TypeTag>
@@ -27,6 +26,52 @@ namespace Opm {
         aquifer->initialSolutionApplied();
       }
     }
+    setupCellAquifers();
+  }
+
+  template<typename TypeTag>
+  void
+  BlackoilAquiferModel<TypeTag>::setupCellAquifers()
+  {
+    const int number_of_cells = simulator_.gridView().size(0);
+    std::vector<std::vector<int>> aquifers_of_cell(number_of_cells);
+    const int num_carter_tracy = aquifers_CarterTracy.size();
+    for (int i = 0; i < num_carter_tracy; ++i)
+    {
+      for (const int cell : aquifers_CarterTracy[i].connectionCells())
+      {
+        aquifers_of_cell[cell].push_back(i);
+      }
+    }
+    for (size_t i = 0; i < aquifers_Fetkovich.size(); ++i)
+    {
+      for (const int cell : aquifers_Fetkovich[i].connectionCells())
+      {
+        aquifers_of_cell[cell].push_back(num_carter_tracy + i);
+      }
+    }
+
+    cell_aquifer_offsets_.assign(number_of_cells + 1, 0);
+    cell_aquifers_.clear();
+    for (int cell = 0; cell < number_of_cells; ++cell)
+    {
+      // an aquifer may have several connections to a cell, but adds its source once
+      auto& aquifers = aquifers_of_cell[cell];
+      aquifers.erase(std::unique(aquifers.begin(), aquifers.end()), aquifers.end());
+      cell_aquifers_.insert(cell_aquifers_.end(), aquifers.begin(), aquifers.end());
+      cell_aquifer_offsets_[cell + 1] = cell_aquifers_.size();
+    }
+
+    std::size_t bytes = memoryBytes(cell_aquifer_offsets_) + memoryBytes(cell_aquifers_);
+    for (const auto& aquifer : aquifers_CarterTracy)
+    {
+      bytes += aquifer.memory();
+    }
+    for (const auto& aquifer : aquifers_Fetkovich)
+    {
+      bytes += aquifer.memory();
+    }
+    memory_.set(bytes);
   }
 
   template<typename TypeTag>
@@ -37,7 +82,22 @@ namespace Opm {
   template<typename TypeTag>
   void
   BlackoilAquiferModel<TypeTag>::beginIteration()
-  { }
+  {
+    if(aquiferCarterTracyActive())
+    {
+      for (auto aquifer = aquifers_CarterTracy.begin(); aquifer != aquifers_CarterTracy.end(); ++aquifer)
+      {
+        aquifer->beginIteration();
+      }
+    }
+    if(aquiferFetkovichActive())
+    {
+      for (auto aquifer = aquifers_Fetkovich.begin(); aquifer != aquifers_Fetkovich.end(); ++aquifer)
+      {
+        aquifer->beginIteration();
+      }
+    }
+  }
 
   template<typename TypeTag>
   void BlackoilAquiferModel<TypeTag>:: beginTimeStep()
@@ -62,6 +122,26 @@ namespace Opm {
   template<class Context>
   void BlackoilAquiferModel<TypeTag>:: addToSource(RateVector& rates, const Context& context, unsigned spaceIdx, unsigned timeIdx) const
   {
+    if (!cell_aquifer_offsets_.empty())
+    {
+      // only the aquifers connected to the cell contribute to its source
+      const unsigned cellIdx = context.globalSpaceIndex(spaceIdx, timeIdx);
+      const int num_carter_tracy = aquifers_CarterTracy.size();
+      for (int i = cell_aquifer_offsets_[cellIdx]; i < cell_aquifer_offsets_[cellIdx + 1]; ++i)
+      {
+        const int aquifer = cell_aquifers_[i];
+        if (aquifer < num_carter_tracy)
+        {
+          aquifers_CarterTracy[aquifer].addToSource(rates, context, spaceIdx, timeIdx);
+        }
+        else
+        {
+          aquifers_Fetkovich[aquifer - num_carter_tracy].addToSource(rates, context, spaceIdx, timeIdx);
+        }
+      }
+      return;
+    }
+
     if(aquiferCarterTracyActive())
     {
       for (auto& aquifer : aquifers_CarterTracy)
@@ -106,6 +186,43 @@ namespace Opm {
   BlackoilAquiferModel<TypeTag>::endEpisode()
   { }
 
+  template<typename TypeTag>
+  template<class Restarter>
+  void
+  BlackoilAquiferModel<TypeTag>::serialize(Restarter& res)
+  {
+    res.serializeSectionBegin("BlackoilAquiferModel");
+    std::ostream& os = res.serializeStream();
+    for (const auto& aquifer : aquifers_CarterTracy)
+    {
+      aquifer.serialize(os);
+    }
+    for (const auto& aquifer : aquifers_Fetkovich)
+    {
+      aquifer.serialize(os);
+    }
+    res.serializeSectionEnd();
+  }
+
+  template<typename TypeTag>
+  template<class Restarter>
+  void
+  BlackoilAquiferModel<TypeTag>::deserialize(Restarter& res)
+  {
+    // the aquifers are set up from the deck in the constructor, in the same order
+    res.deserializeSectionBegin("BlackoilAquiferModel");
+    std::istream& is = res.deserializeStream();
+    for (auto& aquifer : aquifers_CarterTracy)
+    {
+      aquifer.deserialize(is);
+    }
+    for (auto& aquifer : aquifers_Fetkovich)
+    {
+      aquifer.deserialize(is);
+    }
+    res.deserializeSectionEnd();
+  }
+
   // Initialize the aquifers in the deck
   template<typename TypeTag>
   void
@@ -128,7 +245,8 @@ namespace Opm {
       const auto& gridView = simulator_.gridView();
       const int number_of_cells = gridView.size(0);
 
-      cartesian_to_compressed_ = cartesianToCompressed(number_of_cells,
+      const int* cartDims = Opm::UgGridHelpers::cartDims(ugrid);
+      cartesian_to_compressed_ = CartesianCellIndexMap(cartDims[0]*cartDims[1]*cartDims[2], number_of_cells,
                                                        Opm::UgGridHelpers::globalCell(ugrid));
 
       for (size_t i = 0; i < aquifersData.size(); ++i)
@@ -155,7 +273,8 @@ namespace Opm {
       const auto& gridView = simulator_.gridView();
       const int number_of_cells = gridView.size(0);
 
-      cartesian_to_compressed_ = cartesianToCompressed(number_of_cells,
+      const int* cartDims = Opm::UgGridHelpers::cartDims(ugrid);
+      cartesian_to_compressed_ = CartesianCellIndexMap(cartDims[0]*cartDims[1]*cartDims[2], number_of_cells,
                                                        Opm::UgGridHelpers::globalCell(ugrid));
 
       for (size_t i = 0; i < aquifersData.size(); ++i)
@@ -35,6 +35,7 @@
 #include <opm/autodiff/BlackoilAquiferModel.hpp>
 #include <opm/autodiff/WellConnectionAuxiliaryModule.hpp>
 #include <opm/autodiff/BlackoilDetails.hpp>
+#include <opm/autodiff/ActivePhases.hpp>
 
 #include <opm/grid/UnstructuredGrid.h>
 #include <opm/core/simulator/SimulatorReport.hpp>
@@ -50,6 +51,19 @@
 #include <opm/parser/eclipse/EclipseState/Tables/TableManager.hpp>
 
 #include <opm/autodiff/ISTLSolverEbos.hpp>
+#include <opm/autodiff/MemoryRegistry.hpp>
+#include <opm/autodiff/TimingRegistry.hpp>
+#include <opm/autodiff/LinearSystemIO.hpp>
+#include <opm/autodiff/AsyncHaloExchange.hpp>
+#include <opm/autodiff/BlockCSRMatrix.hpp>
+#include <opm/autodiff/ActiveSubdomain.hpp>
+#include <opm/autodiff/GraphPartition.hpp>
+#include <opm/autodiff/SequentialSplitting.hpp>
+#include <opm/autodiff/AdaptiveImplicit.hpp>
+#include <opm/autodiff/EquationScaling.hpp>
+#include <opm/autodiff/NewtonTrace.hpp>
+#include <opm/autodiff/ConvergenceHotSpots.hpp>
+#include <opm/autodiff/ReductionBatch.hpp>
 #include <opm/common/data/SimulationDataContainer.hpp>
 
 #include <dune/istl/owneroverlapcopy.hh>
@@ -57,11 +71,15 @@
 #include <dune/common/timer.hh>
 #include <dune/common/unused.hh>
 
+#include <array>
 #include <cassert>
 #include <cmath>
+#include <fstream>
+#include <future>
 #include <iostream>
 #include <iomanip>
 #include <limits>
+#include <sstream>
 #include <vector>
 #include <algorithm>
 //#include <fstream>
@@ -114,6 +132,8 @@ namespace Opm {
         typedef typename GET_PROP_TYPE(TypeTag, Indices)           Indices;
         typedef typename GET_PROP_TYPE(TypeTag, MaterialLaw)       MaterialLaw;
         typedef typename GET_PROP_TYPE(TypeTag, MaterialLawParams) MaterialLawParams;
+        typedef typename GET_PROP_TYPE(TypeTag, Evaluation)        Evaluation;
+        typedef typename GET_PROP_TYPE(TypeTag, IntensiveQuantities) IntensiveQuantities;
 
         typedef double Scalar;
         static const int numEq = Indices::numEq;
@@ -126,10 +146,25 @@ namespace Opm {
         static const int polymerMoleWeightIdx = Indices::polymerMoleWeightIdx;
         static const int temperatureIdx = Indices::temperatureIdx;
 
+        // the extra equations of the model, for the loops over the cells
+        static const bool enableSolvent = GET_PROP_VALUE(TypeTag, EnableSolvent);
+        static const bool enablePolymer = GET_PROP_VALUE(TypeTag, EnablePolymer);
+        static const bool enablePolymerMW = GET_PROP_VALUE(TypeTag, EnablePolymerMW);
+        static const bool enableEnergy = GET_PROP_VALUE(TypeTag, EnableEnergy);
+
+        // whether a phase is active, false at compile time for the phase a two-phase model does not have
+        static bool phaseIsActive(const unsigned phaseIdx)
+        {
+            return ActivePhases<FluidSystem, Indices>::isActive(phaseIdx);
+        }
+
         typedef Dune::FieldVector<Scalar, numEq >        VectorBlockType;
         typedef typename SparseMatrixAdapter::MatrixBlock MatrixBlockType;
         typedef typename SparseMatrixAdapter::IstlMatrix Mat;
         typedef Dune::BlockVector<VectorBlockType>      BVector;
+        // the CNV residuals of one Newton iteration, by component
+        typedef std::array<double, numEq>               ResidualNorms;
+        typedef BlockCSRMatrix<MatrixBlockType>         CompressedMat;
 
         typedef ISTLSolverEbos<TypeTag> ISTLSolverType;
         //typedef typename SolutionVector :: value_type            PrimaryVariables ;
@@ -166,16 +201,24 @@ namespace Opm {
         , terminal_output_ (terminal_output)
         , current_relaxation_(1.0)
         , dx_old_(UgGridHelpers::numCells(grid_))
+        , newton_update_(UgGridHelpers::numCells(grid_))
+        , forcing_term_(1.0)
+        , conv_R_sum_(numEq, 0.0)
+        , conv_max_coeff_(numEq, 0.0)
+        , B_avg_(numEq, 0.0)
         {
             // compute global sum of number of cells
             global_nc_ = detail::countGlobalCells(grid_);
-            //find rows of matrix corresponding to overlap
-            detail::findOverlapRowsAndColumns(grid_,overlapRowAndColumns_);
             if (!istlSolver_)
             {
                 OPM_THROW(std::logic_error,"solver down cast to ISTLSolver failed");
             }
+            //find rows of matrix corresponding to overlap, once for the whole simulation
+            overlapRowAndColumns_ = &istlSolver().overlapRowsAndColumns(
+                [this](typename ISTLSolverType::OverlapRows& rows) { detail::findOverlapRowsAndColumns(grid_, rows); });
+            istlSolver().keepPreconditioner(chordNewtonPossible());
             convergence_reports_.reserve(300); // Often insufficient, but avoids frequent moves.
+            residual_norms_history_.reserve(64); // more than the Newton iterations of a time step
         }
 
         bool isParallel() const
@@ -188,11 +231,24 @@ namespace Opm {
         /// \param[in] timer                  simulation timer
         void prepareStep(const SimulatorTimerInterface& timer)
         {
+            // the wells of the time step are set up below, no task may still read them
+            waitForPreconditionerMatrix();
 
             // update the solution variables in ebos
             if ( timer.lastStepFailed() ) {
                 ebosSimulator_.model().updateFailed();
             } else {
+                if (param_.predict_solution_) {
+                    // the start of the last time step, which ends at the new old solution,
+                    // the time steps of the last report step had other wells and controls
+                    if (timer.reportStepNum() == older_solution_report_step_) {
+                        older_solution_ = ebosSimulator_.model().solution(/*timeIdx=*/1);
+                        older_solution_dt_ = ebosSimulator_.timeStepSize();
+                        older_switched_ = wasSwitched_;
+                    } else {
+                        older_solution_dt_ = 0.0;
+                    }
+                }
                 ebosSimulator_.model().advanceTimeLevel();
             }
 
@@ -209,14 +265,18 @@ namespace Opm {
 
             ebosSimulator_.problem().beginTimeStep();
 
+            // the structure of the system is kept, restarted and shorter steps can
+            // start from the preconditioner of the previous step
+            istlSolver().setTimeStepSize(timer.currentStepLength());
+
+            if (param_.predict_solution_ && older_solution_dt_ > 0.0) {
+                predictSolution(timer.currentStepLength());
+            }
+            older_solution_report_step_ = timer.reportStepNum();
+
             unsigned numDof = ebosSimulator_.model().numGridDof();
             wasSwitched_.resize(numDof);
             std::fill(wasSwitched_.begin(), wasSwitched_.end(), false);
-
-            if (param_.update_equations_scaling_) {
-                std::cout << "equation scaling not suported yet" << std::endl;
-                //updateEquationsScaling();
-            }
         }
 
 
@@ -240,6 +300,8 @@ namespace Opm {
 
             perfTimer.start();
             if (iteration == 0) {
+                last_update_switched_cells_ = 0;
+                last_update_chopped_cells_ = 0;
                 // For each iteration we store in a vector the norms of the residual of
                 // the mass balance for each active phase, the well flux and the well equations.
                 residual_norms_history_.clear();
@@ -249,26 +311,38 @@ namespace Opm {
                 convergence_reports_.back().report.reserve(11);
             }
 
-            report.total_linearizations = 1;
+            // a chord iteration keeps the Jacobian and the preconditioner of the last iteration
+            const bool chord = chordIteration(iteration);
 
             try {
-                report += assemble(timer, iteration);
+                if (chord) {
+                    evaluateChordResidual(timer.currentStepLength(), iteration);
+                    ++chord_iterations_;
+                }
+                else {
+                    report.total_linearizations = 1;
+                    report += assemble(timer, iteration);
+                    chord_iterations_ = 0;
+                }
                 report.assemble_time += perfTimer.stop();
             }
             catch (...) {
                 report.assemble_time += perfTimer.stop();
                 failureReport_ += report;
+                abandonPreconditionerMatrix();
                 // todo (?): make the report an attribute of the class
                 throw; // continue throwing the stick
             }
 
-            std::vector<double> residual_norms;
+            ResidualNorms residual_norms;
+            int wellFailures = 0;
             perfTimer.reset();
             perfTimer.start();
             // the step is not considered converged until at least minIter iterations is done
-            {
+            try {
                 auto convrep = getConvergence(timer, iteration,residual_norms);
                 report.converged = convrep.converged()  && iteration > nonlinear_solver.minIter();;
+                wellFailures = convrep.wellFailures().size();
                 ConvergenceReport::Severity severity = convrep.severityOfWorstFailure();
                 convergence_reports_.back().report.push_back(std::move(convrep));
 
@@ -279,14 +353,27 @@ namespace Opm {
                     OPM_THROW(Opm::NumericalIssue, "Too large residual found!");
                 }
             }
+            catch (...) {
+                // the time step is restarted with new wells, which the task must not read
+                abandonPreconditionerMatrix();
+                throw;
+            }
 
              // checking whether the group targets are converged
              if (wellModel().wellCollection().groupControlActive()) {
                   report.converged = report.converged && wellModel().wellCollection().groupTargetConverged(wellModel().wellState().wellRates());
              }
 
+            // the linear solve and the updates need the matrix of the preconditioner
+            // and may modify the Jacobian
+            waitForPreconditionerMatrix();
+
             report.update_time += perfTimer.stop();
             residual_norms_history_.push_back(residual_norms);
+            if (!report.converged && nonlinear_solver.detectDivergence(residual_norms_history_, iteration)) {
+                failureReport_ += report;
+                OPM_THROW_NOLOG(Opm::NumericalIssue, "Solver convergence failure - Diverging Newton iterations.");
+            }
             if (!report.converged) {
                 perfTimer.reset();
                 perfTimer.start();
@@ -295,18 +382,38 @@ namespace Opm {
                 // enable single precision for solvers when dt is smaller then 20 days
                 //residual_.singlePrecision = (unit::convert::to(dt, unit::day) < 20.) ;
 
+                if (istlSolver().parameters().linear_solver_adaptive_reduction_) {
+                    istlSolver().setReduction(forcingTerm(iteration));
+                }
+
                 // Compute the nonlinear update.
-                const int nc = UgGridHelpers::numCells(grid_);
-                BVector x(nc);
+                BVector& x = newton_update_;
+                x = 0.0;
 
                 try {
-                    solveJacobianSystem(x);
-                    report.linear_solve_time += perfTimer.stop();
-                    report.total_linear_iterations += linearIterationsLastSolve();
+                    if ( sequentialUpdate(iteration, x) ) {
+                        report.linear_solve_time += perfTimer.stop();
+                        report.total_linear_iterations += sequential_linear_iterations_;
+                    }
+                    else {
+                        if ( chord ) {
+                            istlSolver().reuseKeptPreconditioner();
+                            solveJacobianSystem(x);
+                        }
+                        else if ( ! solveLocalizedJacobianSystem(timer.currentStepLength(), iteration, x) ) {
+                            solveJacobianSystem(x);
+                            chord_jacobian_valid_ = chordNewtonPossible();
+                        }
+                        report.linear_solve_time += perfTimer.stop();
+                        report.total_linear_iterations += linearIterationsLastSolve();
+                        countPreconditionerLastSolve(report);
+                    }
                 }
                 catch (...) {
                     report.linear_solve_time += perfTimer.stop();
                     report.total_linear_iterations += linearIterationsLastSolve();
+                    countPreconditionerLastSolve(report);
+                    traceIteration(timer, iteration, report, wellFailures);
 
                     failureReport_ += report;
                     throw; // re-throw up
@@ -337,12 +444,200 @@ namespace Opm {
                     nonlinear_solver.stabilizeNonlinearUpdate(x, dx_old_, current_relaxation_);
                 }
 
+                if (param_.localized_newton_threshold_ > 0.0) {
+                    last_update_ = x;
+                }
+
                 // Apply the update, with considering model-dependent limitations and
                 // chopping of the update.
                 updateSolution(x);
 
                 report.update_time += perfTimer.stop();
             }
+            traceIteration(timer, iteration, report, wellFailures);
+
+            return report;
+        }
+
+        /// Queue the line of a Newton iteration for the trace, if there is one.
+        void traceIteration(const SimulatorTimerInterface& timer,
+                            const int iteration,
+                            const SimulatorReport& report,
+                            const int wellFailures)
+        {
+            if (!newton_trace_) {
+                return;
+            }
+            NewtonTrace::Record record;
+            record.report_step = timer.reportStepNum();
+            record.sub_step = timer.currentStepNum();
+            record.iteration = iteration;
+            record.dt = timer.currentStepLength();
+            record.converged = report.converged;
+            record.mass_balance.assign(trace_mass_balance_.begin(), trace_mass_balance_.end());
+            record.cnv.assign(trace_cnv_.begin(), trace_cnv_.end());
+            record.well_failures = wellFailures;
+            record.linear_iterations = report.total_linear_iterations;
+            record.relaxation = current_relaxation_;
+            record.assemble_time = report.assemble_time;
+            record.linear_solve_time = report.linear_solve_time;
+            record.update_time = report.update_time;
+            record.switched_cells = last_update_switched_cells_;
+            record.chopped_cells = last_update_chopped_cells_;
+            newton_trace_->push(std::move(record));
+        }
+
+        /// One iteration on the subdomains of the nonlinear domain decomposition
+        /// (see NonlinearSolverDomainDecompositionEbos).
+        ///
+        /// The model is assembled for all cells. Each subdomain with a cell that
+        /// does not satisfy the CNV tolerance gets the Newton update of its own
+        /// equations, with the unknowns of the other subdomains and of the wells
+        /// fixed. The subdomain systems are solved independently with ILU(0)
+        /// preconditioned BiCGSTAB, by several threads if OpenMP is enabled.
+        /// Parallel runs skip the iterations on the subdomains.
+        /// \param[in] iteration   iteration on the subdomains, 0 for the first one of a time step
+        /// \param[in] timer       simulation timer
+        /// \param[in] numDomains  the number of subdomains
+        /// \return The statistics, converged if no subdomain needs an update.
+        SimulatorReport nonlinearIterationDomains(const int iteration,
+                                                  const SimulatorTimerInterface& timer,
+                                                  const int numDomains)
+        {
+            SimulatorReport report;
+            failureReport_ = SimulatorReport();
+            if (isParallel()) {
+                report.converged = true;
+                return report;
+            }
+
+            Dune::Timer perfTimer;
+            perfTimer.start();
+            report.total_linearizations = 1;
+            try {
+                report += assemble(timer, iteration);
+                report.assemble_time += perfTimer.stop();
+            }
+            catch (...) {
+                report.assemble_time += perfTimer.stop();
+                failureReport_ += report;
+                throw;
+            }
+
+            perfTimer.reset();
+            perfTimer.start();
+            {
+                ResidualNorms residual_norms;
+                const auto convrep = getConvergence(timer, iteration, residual_norms);
+                const ConvergenceReport::Severity severity = convrep.severityOfWorstFailure();
+                if (severity == ConvergenceReport::Severity::NotANumber) {
+                    OPM_THROW(Opm::NumericalIssue, "NaN residual found!");
+                } else if (severity == ConvergenceReport::Severity::TooLarge) {
+                    OPM_THROW(Opm::NumericalIssue, "Too large residual found!");
+                }
+                if (convrep.converged()) {
+                    report.update_time += perfTimer.stop();
+                    report.converged = true;
+                    return report;
+                }
+            }
+            waitForPreconditionerMatrix();
+
+            const auto& ebosModel = ebosSimulator_.model();
+            const Mat& ebosJac = ebosModel.linearizer().jacobian().istlMatrix();
+            const auto& ebosResid = ebosModel.linearizer().residual();
+            const int nc = UgGridHelpers::numCells(grid_);
+
+            // The sparsity pattern does not change, hence the subdomains are kept.
+            if (domain_systems_.size() != static_cast<std::size_t>(numDomains)
+                || domain_of_cell_.size() != static_cast<std::size_t>(nc)) {
+                domain_of_cell_ = partitionDomains_(ebosJac, numDomains);
+                domain_systems_.assign(numDomains, ActiveSubdomain<Mat>());
+                for (int domain = 0; domain < numDomains; ++domain) {
+                    std::vector<char> cells(nc, 0);
+                    for (int cell_idx = 0; cell_idx < nc; ++cell_idx) {
+                        cells[cell_idx] = domain_of_cell_[cell_idx] == domain;
+                    }
+                    domain_systems_[domain].setup(ebosJac, std::move(cells), /*haloLayers=*/0);
+                }
+            }
+
+            // the subdomains with a cell that is not converged
+            const double dt = timer.currentStepLength();
+            std::vector<char> domainActive(numDomains, 0);
+            for (int cell_idx = 0; cell_idx < nc; ++cell_idx) {
+                const double pvValue = ebosSimulator_.problem().porosity(cell_idx) * ebosModel.dofTotalVolume(cell_idx);
+                for (int eqIdx = 0; eqIdx < numEq; ++eqIdx) {
+                    if (pvValue > 0.0 && B_avg_[eqIdx] * dt * std::abs(ebosResid[cell_idx][eqIdx]) / pvValue
+                        > param_.tolerance_cnv_) {
+                        domainActive[domain_of_cell_[cell_idx]] = 1;
+                    }
+                }
+            }
+            const int activeDomains = std::count(domainActive.begin(), domainActive.end(), 1);
+            report.update_time += perfTimer.stop();
+            if (activeDomains == 0) {
+                report.converged = true;
+                return report;
+            }
+            if (terminalOutputEnabled()) {
+                OpmLog::debug("Nonlinear domain iteration " + std::to_string(iteration) + ": "
+                              + std::to_string(activeDomains) + " of " + std::to_string(numDomains)
+                              + " subdomains not converged");
+            }
+
+            perfTimer.reset();
+            perfTimer.start();
+            report.total_newton_iterations = 1;
+            BVector& x = newton_update_;
+            x = 0.0;
+            const auto& linearParam = istlSolver().parameters();
+            int linearIterations = 0;
+            bool failed = false;
+#if HAVE_OPENMP
+#pragma omp parallel for schedule(dynamic,1) reduction(+:linearIterations) reduction(||:failed)
+#endif // HAVE_OPENMP
+            for (int domain = 0; domain < numDomains; ++domain) {
+                if (!domainActive[domain]) {
+                    continue;
+                }
+                auto& subdomain = domain_systems_[domain];
+                subdomain.copyValues(ebosJac);
+                BVector b;
+                subdomain.restrict(ebosResid, b);
+                BVector xDomain(subdomain.size());
+                xDomain = 0.0;
+                try {
+                    Dune::MatrixAdapter<Mat, BVector, BVector> opA(subdomain.matrix());
+                    Dune::SeqILU0<Mat, BVector, BVector> precond(subdomain.matrix(), 1.0);
+                    Dune::BiCGSTABSolver<BVector> linsolve(opA, precond, linearParam.linear_solver_reduction_,
+                                                           linearParam.linear_solver_maxiter_, /*verbose=*/0);
+                    Dune::InverseOperatorResult result;
+                    linsolve.apply(xDomain, b, result);
+                    linearIterations += result.iterations;
+                    failed = failed || !result.converged;
+                }
+                catch (...) {
+                    // e.g. a singular diagonal block, exceptions must not leave the parallel region
+                    failed = true;
+                }
+                // the subdomains do not overlap
+                const auto& cells = subdomain.cells();
+                for (std::size_t i = 0; i < cells.size(); ++i) {
+                    x[cells[i]] = xDomain[i];
+                }
+            }
+            report.linear_solve_time += perfTimer.stop();
+            report.total_linear_iterations += linearIterations;
+            if (failed) {
+                failureReport_ += report;
+                OPM_THROW(LinearSolverProblem, "Linear solve of a nonlinear subdomain did not converge");
+            }
+
+            perfTimer.reset();
+            perfTimer.start();
+            updateSolution(x);
+            report.update_time += perfTimer.stop();
 
             return report;
         }
@@ -369,6 +664,13 @@ namespace Opm {
         SimulatorReport assemble(const SimulatorTimerInterface& timer,
                                  const int iterationIdx)
         {
+            static auto& timing = TimingRegistry::instance().entry("newton.assemble");
+            ScopedTiming scopedTiming(timing);
+
+            // the task of the last iteration reads the Jacobian
+            waitForPreconditionerMatrix();
+            chord_jacobian_valid_ = false;
+
             // -------- Mass balance equations --------
             ebosSimulator_.model().newtonMethod().setIterationIndex(iterationIdx);
             ebosSimulator_.problem().beginIteration();
@@ -376,89 +678,240 @@ namespace Opm {
             ebosSimulator_.problem().endIteration();
 
             auto& ebosJac = ebosSimulator_.model().linearizer().jacobian();
+            if ( ! param_.matrix_add_well_contributions_ && addWellContributionsToPreconditioner() ) {
+                // Only reads the Jacobian and the wells, hence it can run while the
+                // IMPES weights and the convergence are computed.
+                if ( param_.overlap_newton_tasks_ ) {
+                    preconditioner_matrix_task_ = std::async(std::launch::async,
+                                                             [this]() { buildPreconditionerMatrix(); });
+                }
+                else {
+                    buildPreconditionerMatrix();
+                }
+            }
+            else {
+                matrix_for_preconditioner_.reset();
+                preconditioner_matrix_memory_.set(0);
+            }
+
+            const auto& linearParam = istlSolver().parameters();
+            if ( linearParam.use_cpr_ && linearParam.cpr_use_true_impes_ ) {
+                const bool reuse = linearParam.cpr_reuse_weights_ && iterationIdx > 0
+                    && impes_weights_.size() == UgGridHelpers::numCells(grid_);
+                if ( ! reuse ) {
+                    computeTrueImpesWeights(impes_weights_);
+                }
+                istlSolver().setImpesWeights(&impes_weights_);
+            }
+            else {
+                istlSolver().setImpesWeights(nullptr);
+            }
+
             if (param_.matrix_add_well_contributions_) {
                 wellModel().addWellContributions(ebosJac.istlMatrix());
             }
-            if ( param_.preconditioner_add_well_contributions_ &&
-                                  ! param_.matrix_add_well_contributions_ ) {
-                matrix_for_preconditioner_ .reset(new Mat(ebosJac.istlMatrix()));
-                wellModel().addWellContributions(*matrix_for_preconditioner_);
-            }
+            jacobian_memory_.set(matrixMemoryBytes(ebosJac.istlMatrix()));
 
             return wellModel().lastReport();
         }
 
-        // compute the "relative" change of the solution between time steps
-        double relativeChange() const
+        /// Copy the Jacobian to the matrix of the preconditioner and add the
+        /// contributions of the wells to it.
+        void buildPreconditionerMatrix()
         {
-            Scalar resultDelta = 0.0;
-            Scalar resultDenom = 0.0;
+            static auto& timing = TimingRegistry::instance().entry("newton.preconditioner_matrix");
+            ScopedTiming scopedTiming(timing);
+
+            const auto& jac = ebosSimulator_.model().linearizer().jacobian().istlMatrix();
+            // reuse the matrix as long as the sparsity pattern does not change.
+            if ( matrix_for_preconditioner_ && matrix_for_preconditioner_->N() == jac.N()
+                 && matrix_for_preconditioner_->nonzeroes() == jac.nonzeroes() ) {
+                Detail::copyMatrixEntries(jac, *matrix_for_preconditioner_);
+            }
+            else {
+                matrix_for_preconditioner_.reset(new Mat(jac));
+            }
+            wellModel().addWellContributions(*matrix_for_preconditioner_);
+            preconditioner_matrix_memory_.set(matrixMemoryBytes(*matrix_for_preconditioner_));
+        }
 
-            const auto& elemMapper = ebosSimulator_.model().elementMapper();
-            const auto& gridView = ebosSimulator_.gridView();
-            auto elemIt = gridView.template begin</*codim=*/0>();
-            const auto& elemEndIt = gridView.template end</*codim=*/0>();
-            for (; elemIt != elemEndIt; ++elemIt) {
-                const auto& elem = *elemIt;
-                if (elem.partitionType() != Dune::InteriorEntity)
-                    continue;
+        /// Wait for the matrix of the preconditioner if it is built on another
+        /// thread (overlap_newton_tasks_), rethrowing its exceptions.
+        void waitForPreconditionerMatrix()
+        {
+            if ( preconditioner_matrix_task_.valid() ) {
+                preconditioner_matrix_task_.get();
+            }
+        }
+
+        /// Wait for the matrix of the preconditioner if it is built on another
+        /// thread, discarding its exceptions, when the iteration fails anyway.
+        void abandonPreconditionerMatrix()
+        {
+            if ( preconditioner_matrix_task_.valid() ) {
+                preconditioner_matrix_task_.wait();
+                preconditioner_matrix_task_ = std::future<void>();
+            }
+        }
 
-                unsigned globalElemIdx = elemMapper.index(elem);
-                const auto& priVarsNew = ebosSimulator_.model().solution(/*timeIdx=*/0)[globalElemIdx];
+        /// Compute the true-IMPES weights of each cell for the CPR preconditioner.
+        ///
+        /// The weights w of a cell solve D^T w = e_p, where D holds the
+        /// derivatives of the accumulation terms of the cell with respect to
+        /// the primary variables. The weighted sum of the equations then has
+        /// an accumulation term depending on the pressure only. Only the
+        /// intensive quantities are needed, no extra pass over the Jacobian.
+        /// The weights are scaled to a maximum magnitude of one. Cells with
+        /// singular D and ghost cells keep the quasi-IMPES weights.
+        void computeTrueImpesWeights(BVector& weights)
+        {
+            static auto& timing = TimingRegistry::instance().entry("cpr.impes_weights");
+            ScopedTiming scopedTiming(timing);
 
-                Scalar pressureNew;
-                pressureNew = priVarsNew[Indices::pressureSwitchIdx];
+            const int pressureVarIndex = Indices::pressureSwitchIdx;
+            weights.resize(UgGridHelpers::numCells(grid_));
+            weights = 1.0;
 
-                Scalar saturationsNew[FluidSystem::numPhases] = { 0.0 };
-                Scalar oilSaturationNew = 1.0;
-                if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
-                    saturationsNew[FluidSystem::waterPhaseIdx] = priVarsNew[Indices::waterSaturationIdx];
-                    oilSaturationNew -= saturationsNew[FluidSystem::waterPhaseIdx];
-                }
+            VectorBlockType rhs(0.0);
+            rhs[pressureVarIndex] = 1.0;
 
-                if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx) && priVarsNew.primaryVarsMeaning() == PrimaryVariables::Sw_po_Sg) {
-                    saturationsNew[FluidSystem::gasPhaseIdx] = priVarsNew[Indices::compositionSwitchIdx];
-                    oilSaturationNew -= saturationsNew[FluidSystem::gasPhaseIdx];
+            ElementContext elemCtx(ebosSimulator_);
+            const auto& localResidual = ebosSimulator_.model().localLinearizer(/*threadId=*/0).localResidual();
+            const auto& gridView = ebosSimulator_.gridView();
+            const auto& elemEndIt = gridView.template end</*codim=*/0, Dune::Interior_Partition>();
+            for (auto elemIt = gridView.template begin</*codim=*/0, Dune::Interior_Partition>();
+                 elemIt != elemEndIt;
+                 ++elemIt)
+            {
+                elemCtx.updatePrimaryStencil(*elemIt);
+                elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
+                const unsigned cell_idx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
+
+                Dune::FieldVector<Evaluation, numEq> storage;
+                localResidual.computeStorage(storage, elemCtx, /*spaceIdx=*/0, /*timeIdx=*/0);
+
+                Dune::FieldMatrix<Scalar, numEq, numEq> blockTransposed;
+                for (int eqIdx = 0; eqIdx < numEq; ++eqIdx) {
+                    for (int pvIdx = 0; pvIdx < numEq; ++pvIdx) {
+                        blockTransposed[pvIdx][eqIdx] = storage[eqIdx].derivative(pvIdx);
+                    }
                 }
 
-                if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx)) {
-                    saturationsNew[FluidSystem::oilPhaseIdx] = oilSaturationNew;
+                VectorBlockType cellWeights;
+                try {
+                    blockTransposed.solve(cellWeights, rhs);
+                }
+                catch (const Dune::FMatrixError&) {
+                    continue;
+                }
+                const double maxWeight = cellWeights.infinity_norm();
+                if (maxWeight > 0.0 && std::isfinite(maxWeight)) {
+                    cellWeights /= maxWeight;
+                    weights[cell_idx] = cellWeights;
                 }
+            }
+        }
+
+        /// Whether the preconditioner is computed from a matrix with the
+        /// well contributions added. Besides explicitly requesting it, it is
+        /// done automatically if a well has many perforations, as such
+        /// wells couple the cells too strongly for a preconditioner without them.
+        bool addWellContributionsToPreconditioner() const
+        {
+            if ( param_.preconditioner_add_well_contributions_ ) {
+                return true;
+            }
+            const int min_perfs = param_.preconditioner_add_well_contributions_min_perfs_;
+            return min_perfs > 0 && wellModel().maxNumberOfPerforations() >= min_perfs;
+        }
+
+        // compute the "relative" change of the solution between time steps
+        double relativeChange() const
+        {
+            const auto& cells = interiorCells();
+            const std::size_t numChunks = (cells.size() + reductionChunkSize - 1) / reductionChunkSize;
+            std::vector<Scalar> partialDelta(numChunks, 0.0);
+            std::vector<Scalar> partialDenom(numChunks, 0.0);
+
+#if HAVE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif // HAVE_OPENMP
+            for (std::ptrdiff_t chunk = 0; chunk < static_cast<std::ptrdiff_t>(numChunks); ++chunk) {
+                Scalar& resultDelta = partialDelta[chunk];
+                Scalar& resultDenom = partialDenom[chunk];
+                const std::size_t end = std::min((chunk + 1) * reductionChunkSize, cells.size());
+                for (std::size_t i = chunk * reductionChunkSize; i < end; ++i) {
+                    const unsigned globalElemIdx = cells[i];
+                    const auto& priVarsNew = ebosSimulator_.model().solution(/*timeIdx=*/0)[globalElemIdx];
+
+                    Scalar pressureNew;
+                    pressureNew = priVarsNew[Indices::pressureSwitchIdx];
+
+                    Scalar saturationsNew[FluidSystem::numPhases] = { 0.0 };
+                    Scalar oilSaturationNew = 1.0;
+                    if (phaseIsActive(FluidSystem::waterPhaseIdx)) {
+                        saturationsNew[FluidSystem::waterPhaseIdx] = priVarsNew[Indices::waterSaturationIdx];
+                        oilSaturationNew -= saturationsNew[FluidSystem::waterPhaseIdx];
+                    }
 
-                const auto& priVarsOld = ebosSimulator_.model().solution(/*timeIdx=*/1)[globalElemIdx];
+                    if (phaseIsActive(FluidSystem::gasPhaseIdx) && priVarsNew.primaryVarsMeaning() == PrimaryVariables::Sw_po_Sg) {
+                        saturationsNew[FluidSystem::gasPhaseIdx] = priVarsNew[Indices::compositionSwitchIdx];
+                        oilSaturationNew -= saturationsNew[FluidSystem::gasPhaseIdx];
+                    }
 
-                Scalar pressureOld;
-                pressureOld = priVarsOld[Indices::pressureSwitchIdx];
+                    if (phaseIsActive(FluidSystem::oilPhaseIdx)) {
+                        saturationsNew[FluidSystem::oilPhaseIdx] = oilSaturationNew;
+                    }
 
-                Scalar saturationsOld[FluidSystem::numPhases] = { 0.0 };
-                Scalar oilSaturationOld = 1.0;
-                if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
-                    saturationsOld[FluidSystem::waterPhaseIdx] = priVarsOld[Indices::waterSaturationIdx];
-                    oilSaturationOld -= saturationsOld[FluidSystem::waterPhaseIdx];
-                }
+                    const auto& priVarsOld = ebosSimulator_.model().solution(/*timeIdx=*/1)[globalElemIdx];
 
-                if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx) && priVarsOld.primaryVarsMeaning() == PrimaryVariables::Sw_po_Sg) {
-                    saturationsOld[FluidSystem::gasPhaseIdx] = priVarsOld[Indices::compositionSwitchIdx];
-                    oilSaturationOld -= saturationsOld[FluidSystem::gasPhaseIdx];
-                }
+                    Scalar pressureOld;
+                    pressureOld = priVarsOld[Indices::pressureSwitchIdx];
 
-                if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx)) {
-                    saturationsOld[FluidSystem::oilPhaseIdx] = oilSaturationOld;
-                }
+                    Scalar saturationsOld[FluidSystem::numPhases] = { 0.0 };
+                    Scalar oilSaturationOld = 1.0;
+                    if (phaseIsActive(FluidSystem::waterPhaseIdx)) {
+                        saturationsOld[FluidSystem::waterPhaseIdx] = priVarsOld[Indices::waterSaturationIdx];
+                        oilSaturationOld -= saturationsOld[FluidSystem::waterPhaseIdx];
+                    }
+
+                    if (phaseIsActive(FluidSystem::gasPhaseIdx) && priVarsOld.primaryVarsMeaning() == PrimaryVariables::Sw_po_Sg) {
+                        saturationsOld[FluidSystem::gasPhaseIdx] = priVarsOld[Indices::compositionSwitchIdx];
+                        oilSaturationOld -= saturationsOld[FluidSystem::gasPhaseIdx];
+                    }
 
-                Scalar tmp = pressureNew - pressureOld;
-                resultDelta += tmp*tmp;
-                resultDenom += pressureNew*pressureNew;
+                    if (phaseIsActive(FluidSystem::oilPhaseIdx)) {
+                        saturationsOld[FluidSystem::oilPhaseIdx] = oilSaturationOld;
+                    }
 
-                for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++ phaseIdx) {
-                    Scalar tmp = saturationsNew[phaseIdx] - saturationsOld[phaseIdx];
+                    Scalar tmp = pressureNew - pressureOld;
                     resultDelta += tmp*tmp;
-                    resultDenom += saturationsNew[phaseIdx]*saturationsNew[phaseIdx];
+                    resultDenom += pressureNew*pressureNew;
+
+                    for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++ phaseIdx) {
+                        Scalar tmp = saturationsNew[phaseIdx] - saturationsOld[phaseIdx];
+                        resultDelta += tmp*tmp;
+                        resultDenom += saturationsNew[phaseIdx]*saturationsNew[phaseIdx];
+                    }
                 }
             }
 
-            resultDelta = gridView.comm().sum(resultDelta);
-            resultDenom = gridView.comm().sum(resultDenom);
+            // add the partial sums in a fixed order
+            Scalar resultDelta = 0.0;
+            Scalar resultDenom = 0.0;
+            for (std::size_t chunk = 0; chunk < numChunks; ++chunk) {
+                resultDelta += partialDelta[chunk];
+                resultDenom += partialDenom[chunk];
+            }
+
+            const auto& gridView = ebosSimulator_.gridView();
+            reduction_batch_.clear();
+            const auto deltaIdx = reduction_batch_.addSum(resultDelta);
+            const auto denomIdx = reduction_batch_.addSum(resultDenom);
+            reduction_batch_.begin(gridView.comm());
+            reduction_batch_.end();
+            resultDelta = reduction_batch_.sum(deltaIdx);
+            resultDenom = reduction_batch_.sum(denomIdx);
 
             if (resultDenom > 0.0)
                 return resultDelta/resultDenom;
@@ -466,12 +919,59 @@ namespace Opm {
         }
 
 
+        /// The reduction of the linear solver for a Newton iteration as proposed
+        /// by Eisenstat and Walker (choice 2 with gamma = 0.9 and alpha = 2).
+        /// The largest CNV residual measures the nonlinear residual. The result is
+        /// bounded by linear_solver_reduction_ and linear_solver_max_reduction_.
+        double forcingTerm(const int iteration)
+        {
+            const auto& linearParam = istlSolver().parameters();
+            const double etaMin = linearParam.linear_solver_reduction_;
+            const double etaMax = std::max(linearParam.linear_solver_max_reduction_, etaMin);
+
+            if (iteration == 0 || residual_norms_history_.size() < 2) {
+                forcing_term_ = etaMax;
+                return forcing_term_;
+            }
+
+            const auto& current = residual_norms_history_.back();
+            const auto& previous = residual_norms_history_[residual_norms_history_.size() - 2];
+            const double currentNorm = current.empty() ? 0.0 : *std::max_element(current.begin(), current.end());
+            const double previousNorm = previous.empty() ? 0.0 : *std::max_element(previous.begin(), previous.end());
+            if (previousNorm <= 0.0) {
+                forcing_term_ = etaMin;
+                return forcing_term_;
+            }
+
+            const double gamma = 0.9;
+            const double alpha = 2.0;
+            double eta = gamma * std::pow(currentNorm / previousNorm, alpha);
+            // safeguard against a too fast decrease of the forcing term
+            const double safeguard = gamma * std::pow(forcing_term_, alpha);
+            if (safeguard > 0.1) {
+                eta = std::max(eta, safeguard);
+            }
+            forcing_term_ = std::min(std::max(eta, etaMin), etaMax);
+            return forcing_term_;
+        }
+
         /// Number of linear iterations used in last call to solveJacobianSystem().
         int linearIterationsLastSolve() const
         {
             return istlSolver().iterations();
         }
 
+        /// Count the preconditioner of the last call to solveJacobianSystem() as
+        /// a full setup or a reuse.
+        void countPreconditionerLastSolve(SimulatorReport& report) const
+        {
+            if (istlSolver().preconditionerReused()) {
+                ++report.total_preconditioner_reuses;
+            } else {
+                ++report.total_preconditioner_setups;
+            }
+        }
+
         /// Zero out off-diagonal blocks on rows corresponding to overlap cells
         /// Diagonal blocks on ovelap rows are set to diag(1e100).
         void makeOverlapRowsInvalid(Mat& ebosJacIgnoreOverlap) const
@@ -482,7 +982,7 @@ namespace Opm {
                 diag_block[eq][eq] = 1.0e100;
 
             //loop over precalculated overlap rows and columns
-            for (auto row = overlapRowAndColumns_.begin(); row != overlapRowAndColumns_.end(); row++ )
+            for (auto row = overlapRowAndColumns_->begin(); row != overlapRowAndColumns_->end(); row++ )
             {
                 int lcell = row->first;
                 //diagonal block set to large value diagonal
@@ -498,10 +998,117 @@ namespace Opm {
             }
         }
 
+        /// Whether the chord iterations are available, i.e. the linear solve
+        /// leaves the Jacobian as it is (chord_newton_max_iterations_).
+        bool chordNewtonPossible() const
+        {
+            return param_.chord_newton_max_iterations_ > 0 && !isParallel()
+                && !param_.update_equations_scaling_ && param_.adaptive_implicit_cfl_ <= 0.0;
+        }
+
+        /// Whether a Newton iteration is a chord iteration, which only evaluates
+        /// the residual and solves with the Jacobian and the preconditioner of
+        /// the last iteration.
+        ///
+        /// The last iteration has to be a full one or a chord iteration itself,
+        /// with a Newton update from the whole system. At most
+        /// chord_newton_max_iterations_ chord iterations follow each other, and
+        /// only as long as the largest residual norm of the last iteration is
+        /// reduced by at least chord_newton_max_rate_ relative to the one before.
+        bool chordIteration(const int iteration) const
+        {
+            if (iteration == 0 || !chord_jacobian_valid_
+                || chord_iterations_ >= param_.chord_newton_max_iterations_
+                || residual_norms_history_.size() < 2) {
+                return false;
+            }
+            const auto& current = residual_norms_history_.back();
+            const auto& previous = residual_norms_history_[residual_norms_history_.size() - 2];
+            const double currentNorm = current.empty() ? 0.0 : *std::max_element(current.begin(), current.end());
+            const double previousNorm = previous.empty() ? 0.0 : *std::max_element(previous.begin(), previous.end());
+            return previousNorm > 0.0 && currentNorm <= param_.chord_newton_max_rate_ * previousNorm;
+        }
+
+        /// Evaluate the residual of the cells and of the wells for the current
+        /// solution into the residual of the linearizer, keeping the Jacobian
+        /// of the last assemble(), for a chord iteration.
+        ///
+        /// Like evaluateResidual(), but the residual of the cells is not
+        /// reduced by the wells, as solveJacobianSystem() does it, and the
+        /// intensive quantities go into the cache for the convergence check.
+        /// The well controls are not updated.
+        void evaluateChordResidual(const double dt, const int iterationIdx)
+        {
+            static auto& timing = TimingRegistry::instance().entry("newton.chord_residual");
+            ScopedTiming scopedTiming(timing);
+
+            ebosSimulator_.model().newtonMethod().setIterationIndex(iterationIdx);
+            wellModel().assembleWellResidual(dt);
+            evaluateCellResidual(ebosSimulator_.model().linearizer().residual(), /*updateCache=*/true);
+        }
+
+        /// Evaluate the residual of the reduced system for the current solution
+        /// without assembling the Jacobian.
+        ///
+        /// The well equations are assembled first, as the source terms of the
+        /// cells depend on the well rates, but the well controls are not
+        /// updated. The well residual is then eliminated from the residual of
+        /// the cells as in solveJacobianSystem(). Meant for trial solutions,
+        /// e.g. of a line search. The intensive quantities still carry the
+        /// derivatives (their type is fixed by the type tag), but no local
+        /// Jacobian is formed and nothing is written to the global Jacobian
+        /// or residual, hence the state of the last assemble() stays valid.
+        /// \param[in]  dt        the time step size
+        /// \param[out] residual  the residual of the interior cells (ghost entries are zero)
+        void evaluateResidual(const double dt, BVector& residual)
+        {
+            static auto& timing = TimingRegistry::instance().entry("newton.residual");
+            ScopedTiming scopedTiming(timing);
+
+            wellModel().assembleWellResidual(dt);
+            evaluateCellResidual(residual, /*updateCache=*/false);
+            wellModel().apply(residual);
+        }
+
+        /// Evaluate the residual of the interior cells for the current solution,
+        /// with zero ghost entries.
+        /// \param[in] updateCache  store the intensive quantities in the cache of the model
+        void evaluateCellResidual(BVector& residual, const bool updateCache)
+        {
+            residual.resize(UgGridHelpers::numCells(grid_));
+            residual = 0.0;
+
+            auto& ebosModel = ebosSimulator_.model();
+            const bool storeIntensiveQuantities = updateCache && ebosModel.storeIntensiveQuantities();
+            ElementContext elemCtx(ebosSimulator_);
+            auto& localResidual = ebosModel.localLinearizer(/*threadId=*/0).localResidual();
+            const auto& gridView = ebosSimulator_.gridView();
+            const auto& elemEndIt = gridView.template end</*codim=*/0, Dune::Interior_Partition>();
+            for (auto elemIt = gridView.template begin</*codim=*/0, Dune::Interior_Partition>();
+                 elemIt != elemEndIt;
+                 ++elemIt)
+            {
+                elemCtx.updateAll(*elemIt);
+                localResidual.eval(elemCtx);
+                const unsigned cell_idx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
+                const auto& cellResidual = localResidual.residual(/*dofIdx=*/0);
+                for (int eqIdx = 0; eqIdx < numEq; ++eqIdx) {
+                    residual[cell_idx][eqIdx] = Opm::getValue(cellResidual[eqIdx]);
+                }
+                if (storeIntensiveQuantities) {
+                    ebosModel.updateCachedIntensiveQuantities(elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0),
+                                                              cell_idx, /*timeIdx=*/0);
+                }
+            }
+        }
+
         /// Solve the Jacobian system Jx = r where J is the Jacobian and
         /// r is the residual.
         void solveJacobianSystem(BVector& x) const
         {
+            static auto& timing = TimingRegistry::instance().entry("newton.linear_solve");
+            ScopedTiming scopedTiming(timing);
+
             // J = [A, B; C, D], where A is the reservoir equations, B and C the interaction of well
             // with the reservoir and D is the wells itself.
             // The full system is reduced to a number of cells X number of cells system via Schur complement
@@ -516,59 +1123,380 @@ namespace Opm {
 
             wellModel().apply(ebosResid);
 
+            if ( !param_.linear_system_dump_dir_.empty() ) {
+                dumpLinearSystem(ebosJac.istlMatrix(), ebosResid);
+            }
+
+            const bool adaptiveImplicit = reduceAdaptiveImplicit(ebosJac.istlMatrix(), ebosResid);
+            const bool scaled = !adaptiveImplicit && scaleEquations(ebosJac.istlMatrix(), ebosResid);
+
             // set initial guess
             x = 0.0;
 
             const Mat& actual_mat_for_prec = matrix_for_preconditioner_ ? *matrix_for_preconditioner_.get() : ebosJac.istlMatrix();
+            const bool compressed = istlSolver().parameters().linear_solver_compressed_matrix_;
             // Solve system.
             if( isParallel() )
             {
                 typedef WellModelMatrixAdapter< Mat, BVector, BVector, BlackoilWellModel<TypeTag>, true > Operator;
 
-                auto ebosJacIgnoreOverlap = Mat(ebosJac.istlMatrix());
-                //remove ghost rows in local matrix
+                // Remove ghost rows in the local matrix. This is done in place to
+                // avoid holding a second copy of the Jacobian. The overlap rows are
+                // not needed anymore as the Jacobian is reassembled before it is used
+                // again.
+                auto& ebosJacIgnoreOverlap = ebosJac.istlMatrix();
                 makeOverlapRowsInvalid(ebosJacIgnoreOverlap);
+                const CompressedMat* compressedJac = compressed ? &compressedJacobian(ebosJacIgnoreOverlap) : nullptr;
 
                 //Not sure what actual_mat_for_prec is, so put ebosJacIgnoreOverlap as both variables
                 //to be certain that correct matrix is used for preconditioning.
+#if HAVE_MPI
+                // kept by the linear solver between the solves
+                auto* comm = &istlSolver().parallelCommunication(ebosJacIgnoreOverlap.N());
+#else
+                typename Operator::communication_type* comm = nullptr;
+#endif
                 Operator opA(ebosJacIgnoreOverlap, ebosJacIgnoreOverlap, wellModel(),
-                             istlSolver().parallelInformation() );
+                             comm, istlSolver().overlapHaloExchange(),
+                             compressedJac );
                 assert( opA.comm() );
                 istlSolver().solve( opA, x, ebosResid, *(opA.comm()) );
             }
             else
             {
                 typedef WellModelMatrixAdapter< Mat, BVector, BVector, BlackoilWellModel<TypeTag>, false > Operator;
-                Operator opA(ebosJac.istlMatrix(), actual_mat_for_prec, wellModel());
+                const CompressedMat* compressedJac = compressed ? &compressedJacobian(ebosJac.istlMatrix()) : nullptr;
+                Operator opA(ebosJac.istlMatrix(), actual_mat_for_prec, wellModel(), nullptr,
+                             false, compressedJac, scaled ? &equation_scaling_ : nullptr);
                 istlSolver().solve( opA, x, ebosResid );
             }
+
+            if ( adaptiveImplicit ) {
+                adaptive_implicit_.recover(x);
+            }
+            if ( scaled ) {
+                equation_scaling_.unscaleSolution(x);
+            }
         }
 
-        //=====================================================================
-        // Implementation for ISTL-matrix based operator
-        //=====================================================================
+        /// Scale the equations of the components by B_avg times the time step over
+        /// the pore volume of the cell, and the unknowns such that the diagonal
+        /// blocks are balanced (see EquationScaling), if update_equations_scaling_
+        /// is set. The factors are computed from each Jacobian.
+        ///
+        /// Parallel runs and runs with a separate matrix for the preconditioner
+        /// solve the unscaled system.
+        /// \return Whether the system is scaled, i.e. the solution needs unscaleSolution().
+        bool scaleEquations(Mat& jacobian, BVector& residual) const
+        {
+            if ( !param_.update_equations_scaling_ || isParallel() || matrix_for_preconditioner_
+                 || B_avg_.size() != static_cast<std::size_t>(numEq) ) {
+                return false;
+            }
 
-        /*!
-           \brief Adapter to turn a matrix into a linear operator.
+            static auto& timing = TimingRegistry::instance().entry("newton.equation_scaling");
+            ScopedTiming scopedTiming(timing);
 
-           Adapts a matrix to the assembled linear operator interface
-         */
-        template<class M, class X, class Y, class WellModel, bool overlapping >
-        class WellModelMatrixAdapter : public Dune::AssembledLinearOperator<M,X,Y>
-        {
-          typedef Dune::AssembledLinearOperator<M,X,Y> BaseType;
+            const auto& ebosModel = ebosSimulator_.model();
+            const double dt = ebosSimulator_.timeStepSize();
+            std::vector<double> weights(numEq);
+            for ( int eqIdx = 0; eqIdx < numEq; ++eqIdx ) {
+                weights[eqIdx] = B_avg_[eqIdx] * dt;
+            }
+            std::vector<double> poreVolumes(jacobian.N());
+            for ( std::size_t cell_idx = 0; cell_idx < poreVolumes.size(); ++cell_idx ) {
+                poreVolumes[cell_idx] = ebosSimulator_.problem().porosity(cell_idx) * ebosModel.dofTotalVolume(cell_idx);
+            }
 
-        public:
-          typedef M matrix_type;
-          typedef X domain_type;
-          typedef Y range_type;
-          typedef typename X::field_type field_type;
+            equation_scaling_.update(jacobian, weights, poreVolumes);
+            equation_scaling_.scaleSystem(jacobian, residual);
+
+            // the true-IMPES weights refer to the rows of the unscaled Jacobian, a
+            // copy is scaled as the weights may be reused in the next iteration
+            const auto& linearParam = istlSolver().parameters();
+            if ( linearParam.use_cpr_ && linearParam.cpr_use_true_impes_
+                 && impes_weights_.size() == jacobian.N() ) {
+                scaled_impes_weights_ = impes_weights_;
+                equation_scaling_.scaleRowWeights(scaled_impes_weights_);
+                istlSolver().setImpesWeights(&scaled_impes_weights_);
+            }
+            return true;
+        }
 
-#if HAVE_MPI
-          typedef Dune::OwnerOverlapCopyCommunication<int,int> communication_type;
-#else
-          typedef Dune::CollectiveCommunication< Grid > communication_type;
-#endif
+        /// Reduce the Jacobian system to the pressure in the cells with a small
+        /// throughput CFL number (see AdaptiveImplicitReduction), if the adaptive
+        /// implicit mode is enabled (adaptive_implicit_cfl_).
+        ///
+        /// Perforated cells stay implicit, as the wells couple all their unknowns.
+        /// Parallel runs and runs with a separate matrix for the preconditioner
+        /// are fully implicit.
+        /// \return Whether cells are IMPES, i.e. the solution needs recover().
+        bool reduceAdaptiveImplicit(Mat& jacobian, BVector& residual) const
+        {
+            const double threshold = param_.adaptive_implicit_cfl_;
+            if ( threshold <= 0.0 || isParallel() || matrix_for_preconditioner_ ) {
+                return false;
+            }
+
+            static auto& timing = TimingRegistry::instance().entry("newton.adaptive_implicit");
+            ScopedTiming scopedTiming(timing);
+
+            typedef AdaptiveImplicitReduction<Mat, BVector> Reduction;
+            const int pressureIndex = Indices::pressureSwitchIdx;
+            const std::vector<double> cfl = Reduction::throughputCfl(jacobian, pressureIndex);
+            std::vector<char> impes(cfl.size(), 0);
+            wellModel().markPerforatedCells(impes);
+            for ( std::size_t cell_idx = 0; cell_idx < cfl.size(); ++cell_idx ) {
+                impes[cell_idx] = !impes[cell_idx] && cfl[cell_idx] < threshold;
+            }
+            const std::size_t numImpes = adaptive_implicit_.reduce(jacobian, residual, std::move(impes), pressureIndex);
+            if ( terminalOutputEnabled() ) {
+                OpmLog::debug("Adaptive implicit: " + std::to_string(numImpes) + " of "
+                              + std::to_string(cfl.size()) + " cells IMPES");
+            }
+            return numImpes > 0;
+        }
+
+        /// The copy of the Jacobian with compact indices used for the products
+        /// of the linear solver. The storage is kept between the solves.
+        const CompressedMat& compressedJacobian(const Mat& jacobian) const
+        {
+            if ( ! compressed_jacobian_ ) {
+                compressed_jacobian_.reset(new CompressedMat(jacobian));
+                compressed_jacobian_memory_.set(memoryBytes(compressed_jacobian_->rowStarts())
+                                                + memoryBytes(compressed_jacobian_->colIndices())
+                                                + memoryBytes(compressed_jacobian_->values()));
+            }
+            else {
+                compressed_jacobian_->updateValues(jacobian);
+            }
+            return *compressed_jacobian_;
+        }
+
+        /// Compute the Newton update by the sequential splitting of the Jacobian
+        /// system (see SequentialSplitting) if it is enabled (sequential_implicit_).
+        ///
+        /// The pressure system is solved with AMG, then the other unknowns by
+        /// sweeps over the cells in the order of decreasing updated pressure.
+        /// The split updates are used for the first sequential_max_iterations_
+        /// iterations of a time step. If an iteration does not reduce the CNV
+        /// residuals, the coupling between pressure and transport is too strong
+        /// and the other iterations of the time step are fully implicit.
+        /// \return Whether the update was computed. If not, the caller has to
+        ///         solve the Jacobian system.
+        bool sequentialUpdate(const int iteration, BVector& x)
+        {
+            if ( ! param_.sequential_implicit_ || isParallel()
+                 || iteration >= param_.sequential_max_iterations_ ) {
+                return false;
+            }
+            if ( iteration == 0 ) {
+                sequential_fallback_ = false;
+            }
+            else if ( ! sequential_fallback_ && residual_norms_history_.size() >= 2 ) {
+                const auto& current = residual_norms_history_.back();
+                const auto& previous = residual_norms_history_[residual_norms_history_.size() - 2];
+                sequential_fallback_ = *std::max_element(current.begin(), current.end())
+                    >= *std::max_element(previous.begin(), previous.end());
+                if ( sequential_fallback_ && terminalOutputEnabled() ) {
+                    OpmLog::debug("The sequential update did not reduce the residual, using fully implicit updates");
+                }
+            }
+            if ( sequential_fallback_ ) {
+                return false;
+            }
+
+            static auto& timing = TimingRegistry::instance().entry("newton.sequential");
+            ScopedTiming scopedTiming(timing);
+
+            const auto& ebosModel = ebosSimulator_.model();
+            const Mat& jacobian = matrix_for_preconditioner_ ? *matrix_for_preconditioner_
+                                                             : ebosModel.linearizer().jacobian().istlMatrix();
+            // the linearizer's residual is left unchanged for a fully implicit solve
+            BVector residual = ebosModel.linearizer().residual();
+            wellModel().apply(residual);
+
+            const int pressureIndex = Indices::pressureSwitchIdx;
+            computeTrueImpesWeights(sequential_weights_);
+            splitting_.assemblePressure(jacobian, residual, sequential_weights_, pressureIndex);
+
+            const auto& linearParam = istlSolver().parameters();
+            typename SequentialSplitting<Mat, BVector>::PressureVector dp;
+            const auto result = splitting_.solvePressure(dp, linearParam.linear_solver_reduction_,
+                                                         linearParam.linear_solver_maxiter_,
+                                                         linearParam.ilu_relaxation_, linearParam.ilu_milu_);
+            sequential_linear_iterations_ = result.iterations;
+            if ( ! result.converged ) {
+                if ( terminalOutputEnabled() ) {
+                    OpmLog::debug("The pressure solve of the sequential update did not converge, using a fully implicit update");
+                }
+                return false;
+            }
+
+            const int nc = UgGridHelpers::numCells(grid_);
+            x.resize(nc);
+            x = 0.0;
+            std::vector<double> pressure(nc);
+            for (int cell_idx = 0; cell_idx < nc; ++cell_idx) {
+                x[cell_idx][pressureIndex] = dp[cell_idx];
+                // the update is subtracted from the solution
+                pressure[cell_idx] = ebosModel.solution(/*timeIdx=*/0)[cell_idx][pressureIndex] - dp[cell_idx];
+            }
+
+            const int referenceEq = phaseIsActive(FluidSystem::oilPhaseIdx) ?
+                Indices::conti0EqIdx + Indices::canonicalToActiveComponentIndex(FluidSystem::oilCompIdx) :
+                Indices::conti0EqIdx;
+            SequentialSplitting<Mat, BVector>::transportSweeps(jacobian, residual,
+                                                               SequentialSplitting<Mat, BVector>::upstreamOrder(pressure),
+                                                               pressureIndex, referenceEq,
+                                                               param_.sequential_transport_sweeps_, x);
+            return true;
+        }
+
+        /// Solve the Jacobian system for an active subdomain only, if the
+        /// localized Newton updates are enabled (localized_newton_threshold_).
+        ///
+        /// A cell is active if its last update exceeded the threshold (for the
+        /// pressure relative to the pressure of the cell) or if its residual
+        /// does not satisfy the CNV tolerance. The active set is grown by
+        /// localized_newton_halo_ layers of neighbours and contains the
+        /// perforated cells. The update of the other cells is zero. Only the
+        /// linear solve is localized, the assembly still covers all cells.
+        /// \return Whether the system was solved. If not, the caller has to
+        ///         solve the full system.
+        bool solveLocalizedJacobianSystem(const double dt, const int iteration, BVector& x)
+        {
+            const double threshold = param_.localized_newton_threshold_;
+            const int nc = UgGridHelpers::numCells(grid_);
+            // The recycled subspace of the linear solver belongs to the full system.
+            if ( threshold <= 0.0 || iteration == 0 || isParallel()
+                 || last_update_.size() != static_cast<std::size_t>(nc)
+                 || B_avg_.size() != static_cast<std::size_t>(numEq)
+                 || istlSolver().parameters().linear_solver_recycle_size_ > 0 ) {
+                return false;
+            }
+
+            static auto& timing = TimingRegistry::instance().entry("newton.localized_solve");
+            ScopedTiming scopedTiming(timing);
+
+            const auto& ebosModel = ebosSimulator_.model();
+            const Mat& ebosJac = ebosModel.linearizer().jacobian().istlMatrix();
+            auto& ebosResid = ebosSimulator_.model().linearizer().residual();
+
+            std::vector<char> seeds(nc, 0);
+            for (int cell_idx = 0; cell_idx < nc; ++cell_idx) {
+                const auto& dx = last_update_[cell_idx];
+                const auto& priVars = ebosModel.solution(/*timeIdx=*/0)[cell_idx];
+                bool active = std::abs(dx[Indices::pressureSwitchIdx])
+                    > threshold * std::abs(priVars[Indices::pressureSwitchIdx]);
+                const double pvValue = ebosSimulator_.problem().porosity(cell_idx) * ebosModel.dofTotalVolume(cell_idx);
+                for (int eqIdx = 0; eqIdx < numEq && !active; ++eqIdx) {
+                    active = (eqIdx != Indices::pressureSwitchIdx && std::abs(dx[eqIdx]) > threshold)
+                        || (pvValue > 0.0 && B_avg_[eqIdx] * dt * std::abs(ebosResid[cell_idx][eqIdx]) / pvValue
+                            > param_.tolerance_cnv_);
+                }
+                seeds[cell_idx] = active;
+            }
+            // The operator applies the wells to the active entries only.
+            wellModel().markPerforatedCells(seeds);
+
+            subdomain_.setup(ebosJac, std::move(seeds), param_.localized_newton_halo_);
+            if ( subdomain_.size() > param_.localized_newton_max_fraction_ * nc ) {
+                return false;
+            }
+            if ( terminalOutputEnabled() ) {
+                OpmLog::debug("Localized Newton update for " + std::to_string(subdomain_.size())
+                              + " of " + std::to_string(nc) + " cells");
+            }
+
+            wellModel().apply(ebosResid);
+
+            BVector b;
+            subdomain_.restrict(ebosResid, b);
+            BVector xActive(subdomain_.size());
+            xActive = 0.0;
+
+            typedef ActiveSubdomainOperator<Mat, BVector, BlackoilWellModel<TypeTag> > Operator;
+            Operator opA(subdomain_, param_.matrix_add_well_contributions_ ? nullptr : &wellModel());
+            // The preconditioners kept between the solves belong to the full system.
+            istlSolver().invalidatePreconditioner();
+            try {
+                istlSolver().solve(opA, xActive, b);
+            }
+            catch (...) {
+                istlSolver().invalidatePreconditioner();
+                throw;
+            }
+            istlSolver().invalidatePreconditioner();
+
+            subdomain_.prolongate(xActive, x);
+            return true;
+        }
+
+        /// Write the reduced system solved by solveJacobianSystem() to a binary file
+        /// if the current report step and Newton iteration are selected.
+        /// The file contains the Jacobian of the reservoir equations, the residual
+        /// with the well contributions applied and the packed well contributions.
+        /// It can be replayed with the program replay_linear_system.
+        void dumpLinearSystem(const Mat& jacobian, const BVector& residual) const
+        {
+            const int reportStep = ebosSimulator_.episodeIndex();
+            const int iteration = ebosSimulator_.model().newtonMethod().numIterations();
+            if ( (param_.linear_system_dump_report_step_ >= 0 && param_.linear_system_dump_report_step_ != reportStep)
+                 || (param_.linear_system_dump_newton_iteration_ >= 0 && param_.linear_system_dump_newton_iteration_ != iteration) ) {
+                return;
+            }
+
+            if ( isParallel() ) {
+                if ( terminal_output_ ) {
+                    OpmLog::warning("Writing the linear systems is only supported for sequential runs");
+                }
+                return;
+            }
+
+            if ( !wellModel().allWellContributionsPacked() ) {
+                OpmLog::warning("The contributions of multi-segment wells are not written to the linear system files");
+            }
+
+            std::ostringstream fileName;
+            fileName << param_.linear_system_dump_dir_ << "/linsys_step" << reportStep
+                     << "_ts" << ebosSimulator_.timeStepIndex() << "_it" << iteration << ".bin";
+            std::ofstream os(fileName.str(), std::ios::binary);
+            if ( !os ) {
+                OPM_THROW(std::runtime_error, "Could not open " << fileName.str() << " for writing the linear system");
+            }
+
+            LinearSystemIO::writeHeader(os, numEq);
+            LinearSystemIO::writeMatrix(os, jacobian);
+            LinearSystemIO::writeVector(os, residual);
+            wellModel().packedWellContributions().write(os);
+        }
+
+        //=====================================================================
+        // Implementation for ISTL-matrix based operator
+        //=====================================================================
+
+        /*!
+           \brief Adapter to turn a matrix into a linear operator.
+
+           Adapts a matrix to the assembled linear operator interface
+         */
+        template<class M, class X, class Y, class WellModel, bool overlapping >
+        class WellModelMatrixAdapter : public Dune::AssembledLinearOperator<M,X,Y>
+        {
+          typedef Dune::AssembledLinearOperator<M,X,Y> BaseType;
+
+        public:
+          typedef M matrix_type;
+          typedef X domain_type;
+          typedef Y range_type;
+          typedef typename X::field_type field_type;
+
+#if HAVE_MPI
+          typedef Dune::OwnerOverlapCopyCommunication<int,int> communication_type;
+#else
+          typedef Dune::CollectiveCommunication< Grid > communication_type;
+#endif
 
 #if DUNE_VERSION_NEWER(DUNE_ISTL, 2, 6)
           Dune::SolverCategory::Category category() const override
@@ -586,68 +1514,266 @@ namespace Opm {
 #endif
 
           //! constructor: just store a reference to a matrix
+          //! If overlapHaloExchange is true the operator makes its input consistent
+          //! itself: the ghost values are exchanged while the rows without ghost
+          //! columns are multiplied. The preconditioner does not need to copy its
+          //! result to the ghost entries then.
+          //! If compressed is given, the products use this copy of A with compact
+          //! indices instead of A itself.
+          //! If scaling is given, A is the scaled Jacobian and the wells are
+          //! scaled alike.
           WellModelMatrixAdapter (const M& A,
                                   const M& A_for_precond,
                                   const WellModel& wellMod,
-                                  const boost::any& parallelInformation = boost::any() )
-              : A_( A ), A_for_precond_(A_for_precond), wellMod_( wellMod ), comm_()
+                                  communication_type* comm = nullptr,
+                                  const bool overlapHaloExchange = false,
+                                  const BlockCSRMatrix<typename M::block_type>* compressed = nullptr,
+                                  const EquationScaling<M, X>* scaling = nullptr )
+              : A_( A ), A_for_precond_(A_for_precond), wellMod_( wellMod ), comm_( comm ),
+                overlapHaloExchange_( overlapHaloExchange ), compressed_( compressed ),
+                scaling_( scaling )
+          {
+          }
+
+          virtual void apply( const X& x, Y& y ) const
           {
+            const X* xConsistent = &x;
 #if HAVE_MPI
-            if( parallelInformation.type() == typeid(ParallelISTLInformation) )
+            if( exchangesInput() )
             {
-              const ParallelISTLInformation& info =
-                  boost::any_cast<const ParallelISTLInformation&>( parallelInformation);
-              comm_.reset( new communication_type( info.communicator() ) );
+              xConsistent = &splitMatVec( 1.0, x, y, false );
             }
+            else
 #endif
-          }
+            {
+              static auto& timing = TimingRegistry::instance().entry("spmv");
+              ScopedTiming scopedTiming(timing);
+              if( compressed_ )
+              {
+                compressed_->mv( x, y );
+              }
+              else
+              {
+                A_.mv( x, y );
+              }
+            }
 
-          virtual void apply( const X& x, Y& y ) const
-          {
-            A_.mv( x, y );
+            {
+              // add well model modification to y
+              static auto& timing = TimingRegistry::instance().entry("well.apply");
+              ScopedTiming scopedTiming(timing);
+              if( scaling_ )
+              {
+                scaling_->applyWells( wellMod_, 1.0, *xConsistent, y );
+              }
+              else
+              {
+                wellMod_.apply(*xConsistent, y );
+              }
+            }
 
-            // add well model modification to y
-            wellMod_.apply(x, y );
+            project( y );
+          }
 
+          // y += \alpha * A * x
+          virtual void applyscaleadd (field_type alpha, const X& x, Y& y) const
+          {
+            const X* xConsistent = &x;
 #if HAVE_MPI
-            if( comm_ )
-              comm_->project( y );
+            if( exchangesInput() )
+            {
+              xConsistent = &splitMatVec( alpha, x, y, true );
+            }
+            else
 #endif
+            {
+              static auto& timing = TimingRegistry::instance().entry("spmv");
+              ScopedTiming scopedTiming(timing);
+              if( compressed_ )
+              {
+                compressed_->usmv( alpha, x, y );
+              }
+              else
+              {
+                A_.usmv(alpha,x,y);
+              }
+            }
+
+            {
+              // add scaled well model modification to y
+              static auto& timing = TimingRegistry::instance().entry("well.apply");
+              ScopedTiming scopedTiming(timing);
+              if( scaling_ )
+              {
+                scaling_->applyWells( wellMod_, alpha, *xConsistent, y );
+              }
+              else
+              {
+                wellMod_.applyScaleAdd( alpha, *xConsistent, y );
+              }
+            }
+
+            project( y );
           }
 
-          // y += \alpha * A * x
-          virtual void applyscaleadd (field_type alpha, const X& x, Y& y) const
+          virtual const matrix_type& getmat() const { return A_for_precond_; }
+
+          communication_type* comm()
           {
-            A_.usmv(alpha,x,y);
+              return comm_;
+          }
 
-            // add scaled well model modification to y
-            wellMod_.applyScaleAdd( alpha, x, y );
+          //! \brief Whether the ghost values of the input are exchanged by this operator.
+          bool exchangesInput() const
+          {
+#if HAVE_MPI
+            return overlapHaloExchange_ && comm_;
+#else
+            return false;
+#endif
+          }
 
+        protected:
+          void project( Y& y ) const
+          {
 #if HAVE_MPI
             if( comm_ )
+            {
+              static auto& timing = TimingRegistry::instance().entry("mpi.project");
+              ScopedTiming scopedTiming(timing);
               comm_->project( y );
+            }
+#else
+            DUNE_UNUSED_PARAMETER(y);
 #endif
           }
 
-          virtual const matrix_type& getmat() const { return A_for_precond_; }
+#if HAVE_MPI
+          //! \brief Compute y = A x (or y += alpha A x if scaleAdd is true) for
+          //!        an input x whose ghost values are not up to date.
+          //! \return x with the ghost values of the owners.
+          const X& splitMatVec( field_type alpha, const X& x, Y& y, bool scaleAdd ) const
+          {
+            static auto& spmvTiming = TimingRegistry::instance().entry("spmv");
+            static auto& haloTiming = TimingRegistry::instance().entry("mpi.halo_exchange");
+            if( ! exchange_ )
+            {
+              setupSplitMatVec( x.size() );
+            }
 
-          communication_type* comm()
+            {
+              ScopedTiming scopedTiming(haloTiming);
+              exchange_->begin( x );
+            }
+            {
+              ScopedTiming scopedTiming(spmvTiming);
+              multiplyRows( interiorRows_, alpha, x, y, scaleAdd );
+            }
+            {
+              ScopedTiming scopedTiming(haloTiming);
+              xConsistent_ = x;
+              exchange_->end( xConsistent_ );
+            }
+            {
+              ScopedTiming scopedTiming(spmvTiming);
+              multiplyRows( borderRows_, alpha, xConsistent_, y, scaleAdd );
+              if( ! scaleAdd )
+              {
+                // removed by project() anyway
+                for( const auto row : ghostRows_ )
+                {
+                  y[ row ] = 0.0;
+                }
+              }
+            }
+            return xConsistent_;
+          }
+
+          //! \brief Sort the rows into the ones without ghost columns, the ones
+          //!        with ghost columns and the ghost rows.
+          void setupSplitMatVec( std::size_t size ) const
+          {
+            // The remote indices are only complete when the operator is applied.
+            exchange_.reset( new AsyncHaloExchange<int,int>( *comm_, size ) );
+            for( auto row = A_.begin(); row != A_.end(); ++row )
+            {
+              if( exchange_->receivesValue( row.index() ) )
+              {
+                ghostRows_.push_back( row.index() );
+                continue;
+              }
+              bool border = false;
+              for( auto col = row->begin(); col != row->end() && !border; ++col )
+              {
+                border = exchange_->receivesValue( col.index() );
+              }
+              ( border ? borderRows_ : interiorRows_ ).push_back( row.index() );
+            }
+          }
+
+          void multiplyRows( const std::vector<std::size_t>& rows, field_type alpha,
+                             const X& x, Y& y, bool scaleAdd ) const
           {
-              return comm_.operator->();
+            for( const auto i : rows )
+            {
+              auto& yi = y[ i ];
+              if( ! scaleAdd )
+              {
+                yi = 0.0;
+              }
+              if( compressed_ )
+              {
+                if( scaleAdd )
+                {
+                  compressed_->usmvRow( i, alpha, x, yi );
+                }
+                else
+                {
+                  compressed_->umvRow( i, x, yi );
+                }
+                continue;
+              }
+              const auto& row = A_[ i ];
+              for( auto col = row.begin(), end = row.end(); col != end; ++col )
+              {
+                if( scaleAdd )
+                {
+                  col->usmv( alpha, x[ col.index() ], yi );
+                }
+                else
+                {
+                  col->umv( x[ col.index() ], yi );
+                }
+              }
+            }
           }
+#endif
 
-        protected:
           const matrix_type& A_ ;
           const matrix_type& A_for_precond_ ;
           const WellModel& wellMod_;
-          std::unique_ptr< communication_type > comm_;
+          //! \brief The communication of a parallel run, owned by the linear solver.
+          communication_type* comm_;
+          const bool overlapHaloExchange_;
+          const BlockCSRMatrix<typename M::block_type>* compressed_;
+          const EquationScaling<M, X>* scaling_;
+#if HAVE_MPI
+          mutable std::unique_ptr< AsyncHaloExchange<int,int> > exchange_;
+          mutable std::vector<std::size_t> interiorRows_;
+          mutable std::vector<std::size_t> borderRows_;
+          mutable std::vector<std::size_t> ghostRows_;
+          //! \brief The input with the ghost values of the owners.
+          mutable X xConsistent_;
+#endif
         };
 
         /// Apply an update to the primary variables.
         void updateSolution(const BVector& dx)
         {
-            auto& ebosNewtonMethod = ebosSimulator_.model().newtonMethod();
-            SolutionVector& solution = ebosSimulator_.model().solution(/*timeIdx=*/0);
+            auto& ebosModel = ebosSimulator_.model();
+            auto& ebosNewtonMethod = ebosModel.newtonMethod();
+            SolutionVector& solution = ebosModel.solution(/*timeIdx=*/0);
+            solution_before_update_ = solution;
 
             ebosNewtonMethod.update_(/*nextSolution=*/solution,
                                      /*curSolution=*/solution,
@@ -656,7 +1782,131 @@ namespace Opm {
                                                     // oil model do not care about the
                                                     // residual
 
-            // if the solution is updated, the intensive quantities need to be recalculated
+            // The update of each cell is classified concurrently: whether its primary
+            // variables changed by more than the tolerance, switched their meaning or
+            // were chopped, i.e. moved by other than the Newton update.
+            enum { Changed = 1, Switched = 2, Chopped = 4 };
+            const Scalar tolerance = param_.intensive_quantities_tolerance_;
+            const std::ptrdiff_t numCells = solution.size();
+            update_status_.resize(numCells);
+            int numSwitched = 0;
+            int numChopped = 0;
+#if HAVE_OPENMP
+#pragma omp parallel for schedule(static) reduction(+:numSwitched,numChopped)
+#endif // HAVE_OPENMP
+            for (std::ptrdiff_t cellIdx = 0; cellIdx < numCells; ++cellIdx) {
+                const auto& priVars = solution[cellIdx];
+                const auto& priVarsBefore = solution_before_update_[cellIdx];
+                unsigned char status = 0;
+                if (priVars.primaryVarsMeaning() != priVarsBefore.primaryVarsMeaning()) {
+                    status = Changed | Switched;
+                } else {
+                    for (int eqIdx = 0; eqIdx < numEq; ++eqIdx) {
+                        const Scalar change = priVarsBefore[eqIdx] - priVars[eqIdx];
+                        const Scalar scale = std::max(std::abs(priVarsBefore[eqIdx]), Scalar(1.0));
+                        if (std::abs(change) > tolerance*scale) {
+                            status |= Changed;
+                        }
+                        if (std::abs(change - dx[cellIdx][eqIdx]) > 1e-10*std::max(std::abs(dx[cellIdx][eqIdx]), scale)) {
+                            status |= Chopped;
+                        }
+                    }
+                }
+                numSwitched += (status & Switched) != 0;
+                numChopped += (status & Chopped) != 0;
+                update_status_[cellIdx] = status;
+            }
+
+            // if the solution of a cell is updated, its intensive quantities need to be
+            // recalculated. Late Newton iterations change the primary variables of few cells.
+            // The flags are not safe to write concurrently.
+            for (std::ptrdiff_t cellIdx = 0; cellIdx < numCells; ++cellIdx) {
+                if (update_status_[cellIdx] & Changed) {
+                    ebosModel.setIntensiveQuantitiesCacheEntryValidity(cellIdx, /*timeIdx=*/0, false);
+                }
+                if ((update_status_[cellIdx] & Switched) && static_cast<std::size_t>(cellIdx) < wasSwitched_.size()) {
+                    wasSwitched_[cellIdx] = true;
+                }
+            }
+
+            // the summary of the update is global, like the residuals of the trace
+            if (!param_.newton_trace_file_.empty()) {
+                int counts[2] = { numSwitched, numChopped };
+                grid_.comm().sum(counts, 2);
+                numSwitched = counts[0];
+                numChopped = counts[1];
+            }
+            last_update_switched_cells_ = numSwitched;
+            last_update_chopped_cells_ = numChopped;
+        }
+
+        /// The number of cells whose primary variables switched their meaning in
+        /// the last Newton update, over all processes if there is a Newton trace.
+        int lastUpdateSwitchedCells() const
+        { return last_update_switched_cells_; }
+
+        /// The number of cells whose last Newton update was chopped, e.g. by
+        /// the limits of the pressure and saturation changes, over all processes
+        /// if there is a Newton trace.
+        int lastUpdateChoppedCells() const
+        { return last_update_chopped_cells_; }
+
+        /// Extrapolate the primary variables linearly from the start and the end of
+        /// the last time step as the initial guess of a time step of length dt.
+        /// The cells whose primary variables switched in the last time step start
+        /// from the old solution, and the saturations are kept within [0, 1].
+        void predictSolution(const Scalar dt)
+        {
+            // the extrapolation is limited to the length of the last time step
+            const Scalar factor = std::min(dt / older_solution_dt_, 1.0);
+            SolutionVector& solution = ebosSimulator_.model().solution(/*timeIdx=*/0);
+            const SolutionVector& oldSolution = ebosSimulator_.model().solution(/*timeIdx=*/1);
+            const std::size_t numCells = std::min(oldSolution.size(), older_solution_.size());
+            const auto clamp = [](const Scalar value, const Scalar lower, const Scalar upper) {
+                return std::max(lower, std::min(value, upper));
+            };
+
+#if HAVE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif // HAVE_OPENMP
+            for (std::ptrdiff_t cellIdx = 0; cellIdx < static_cast<std::ptrdiff_t>(numCells); ++cellIdx) {
+                const auto& priVarsOld = oldSolution[cellIdx];
+                const auto& priVarsOlder = older_solution_[cellIdx];
+                if (priVarsOld.primaryVarsMeaning() != priVarsOlder.primaryVarsMeaning()
+                    || (static_cast<std::size_t>(cellIdx) < older_switched_.size() && older_switched_[cellIdx])) {
+                    continue;
+                }
+
+                auto& priVars = solution[cellIdx];
+                for (int eqIdx = 0; eqIdx < numEq; ++eqIdx) {
+                    priVars[eqIdx] = priVarsOld[eqIdx] + factor*(priVarsOld[eqIdx] - priVarsOlder[eqIdx]);
+                }
+
+                if (priVars[Indices::pressureSwitchIdx] <= 0.0) {
+                    priVars[Indices::pressureSwitchIdx] = priVarsOld[Indices::pressureSwitchIdx];
+                }
+                Scalar sw = 0.0;
+                if (phaseIsActive(FluidSystem::waterPhaseIdx)) {
+                    sw = clamp(priVars[Indices::waterSaturationIdx], 0.0, 1.0);
+                    priVars[Indices::waterSaturationIdx] = sw;
+                }
+                if (phaseIsActive(FluidSystem::gasPhaseIdx)) {
+                    if (priVars.primaryVarsMeaning() == PrimaryVariables::Sw_po_Sg) {
+                        priVars[Indices::compositionSwitchIdx] = clamp(priVars[Indices::compositionSwitchIdx], 0.0, 1.0 - sw);
+                    } else {
+                        // Rs or Rv
+                        priVars[Indices::compositionSwitchIdx] = std::max(priVars[Indices::compositionSwitchIdx], 0.0);
+                    }
+                }
+                if (enableSolvent) {
+                    priVars[solventSaturationIdx] = clamp(priVars[solventSaturationIdx], 0.0, 1.0);
+                }
+                if (enablePolymer) {
+                    priVars[polymerConcentrationIdx] = std::max(priVars[polymerConcentrationIdx], 0.0);
+                }
+            }
+
+            // the intensive quantities of the initial guess need to be recalculated
             ebosSimulator_.model().invalidateIntensiveQuantitiesCache(/*timeIdx=*/0);
         }
 
@@ -678,151 +1928,245 @@ namespace Opm {
 
             if( comm.size() > 1 )
             {
-                // global reduction
-                std::vector< Scalar > sumBuffer;
-                std::vector< Scalar > maxBuffer;
+                // global reduction of the sums and maxima in one collective,
+                // the sums are B_avg and R_sum of each component and pvSum
                 const int numComp = B_avg.size();
-                sumBuffer.reserve( 2*numComp + 1 ); // +1 for pvSum
-                maxBuffer.reserve( numComp );
+                assert( numComp == numEq );
+                reduction_batch_.clear();
                 for( int compIdx = 0; compIdx < numComp; ++compIdx )
                 {
-                    sumBuffer.push_back( B_avg[ compIdx ] );
-                    sumBuffer.push_back( R_sum[ compIdx ] );
-                    maxBuffer.push_back( maxCoeff[ compIdx ] );
+                    reduction_batch_.addSum( B_avg[ compIdx ] );
+                    reduction_batch_.addSum( R_sum[ compIdx ] );
+                    reduction_batch_.addMax( maxCoeff[ compIdx ] );
                 }
+                const auto pvSumIdx = reduction_batch_.addSum( pvSum );
 
-                // Compute total pore volume
-                sumBuffer.push_back( pvSum );
-
-                // compute global sum
-                comm.sum( sumBuffer.data(), sumBuffer.size() );
-
-                // compute global max
-                comm.max( maxBuffer.data(), maxBuffer.size() );
+                reduction_batch_.begin( comm );
+                reduction_batch_.end();
 
                 // restore values to local variables
-                for( int compIdx = 0, buffIdx = 0; compIdx < numComp; ++compIdx, ++buffIdx )
-                {
-                    B_avg[ compIdx ]    = sumBuffer[ buffIdx ];
-                    ++buffIdx;
-
-                    R_sum[ compIdx ]       = sumBuffer[ buffIdx ];
-                }
-
                 for( int compIdx = 0; compIdx < numComp; ++compIdx )
                 {
-                    maxCoeff[ compIdx ] = maxBuffer[ compIdx ];
+                    B_avg[ compIdx ]    = reduction_batch_.sum( 2*compIdx );
+                    R_sum[ compIdx ]    = reduction_batch_.sum( 2*compIdx + 1 );
+                    maxCoeff[ compIdx ] = reduction_batch_.max( compIdx );
                 }
 
                 // restore global pore volume
-                pvSum = sumBuffer.back();
+                pvSum = reduction_batch_.sum( pvSumIdx );
             }
 
             // return global pore volume
             return pvSum;
         }
 
-        // Get reservoir quantities on this process needed for convergence calculations.
-        double localConvergenceData(std::vector<Scalar>& R_sum,
-                                    std::vector<Scalar>& maxCoeff,
-                                    std::vector<Scalar>& B_avg)
+        /// The sums and maxima of the convergence data of a range of cells.
+        struct ConvergenceSums
         {
-            double pvSumLocal = 0.0;
-            const auto& ebosModel = ebosSimulator_.model();
-            const auto& ebosProblem = ebosSimulator_.problem();
+            ConvergenceSums()
+                : pvSum(0.0)
+            {
+                R_sum.fill(0.0);
+                B_avg.fill(0.0);
+                maxCoeff.fill(std::numeric_limits<Scalar>::lowest());
+            }
 
-            const auto& ebosResid = ebosSimulator_.model().linearizer().residual();
+            void add(const ConvergenceSums& other)
+            {
+                pvSum += other.pvSum;
+                for (int i = 0; i < numEq; ++i) {
+                    R_sum[i] += other.R_sum[i];
+                    B_avg[i] += other.B_avg[i];
+                    maxCoeff[i] = std::max(maxCoeff[i], other.maxCoeff[i]);
+                }
+            }
 
-            ElementContext elemCtx(ebosSimulator_);
-            const auto& gridView = ebosSimulator().gridView();
-            const auto& elemEndIt = gridView.template end</*codim=*/0, Dune::Interior_Partition>();
+            double pvSum;
+            std::array<Scalar, numEq> R_sum;
+            std::array<Scalar, numEq> B_avg;
+            std::array<Scalar, numEq> maxCoeff;
+        };
 
-            for (auto elemIt = gridView.template begin</*codim=*/0, Dune::Interior_Partition>();
-                 elemIt != elemEndIt;
-                 ++elemIt)
+        /// Add the convergence data of one cell.
+        void addConvergenceData(const unsigned cell_idx, const IntensiveQuantities& intQuants,
+                                ConvergenceSums& sums) const
+        {
+            const auto& ebosModel = ebosSimulator_.model();
+            const auto& ebosResid = ebosModel.linearizer().residual();
+            const auto& fs = intQuants.fluidState();
+
+            const double pvValue = ebosSimulator_.problem().porosity(cell_idx) * ebosModel.dofTotalVolume( cell_idx );
+            sums.pvSum += pvValue;
+
+            // all the equations of the cell are added in one pass over its residual,
+            // the terms of the disabled components are removed at compile time
+            const auto& cellResid = ebosResid[cell_idx];
+            const auto addEquation = [&sums, pvValue](const int eqIdx, const double b, const double R2) {
+                sums.B_avg[ eqIdx ] += b;
+                sums.R_sum[ eqIdx ] += R2;
+                sums.maxCoeff[ eqIdx ] = std::max( sums.maxCoeff[ eqIdx ], std::abs( R2 ) / pvValue );
+            };
+
+            for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx)
             {
-                const auto& elem = *elemIt;
-                elemCtx.updatePrimaryStencil(elem);
-                elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
-                const unsigned cell_idx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
-                const auto& intQuants = elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
-                const auto& fs = intQuants.fluidState();
+                if (!phaseIsActive(phaseIdx)) {
+                    continue;
+                }
 
-                const double pvValue = ebosProblem.porosity(cell_idx) * ebosModel.dofTotalVolume( cell_idx );
-                pvSumLocal += pvValue;
+                const unsigned compIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::solventComponentIndex(phaseIdx));
+                addEquation(compIdx, 1.0 / fs.invB(phaseIdx).value(), cellResid[compIdx]);
+            }
 
-                for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx)
-                {
-                    if (!FluidSystem::phaseIsActive(phaseIdx)) {
-                        continue;
-                    }
+            if ( enableSolvent ) {
+                addEquation(contiSolventEqIdx, 1.0 / intQuants.solventInverseFormationVolumeFactor().value(),
+                            cellResid[contiSolventEqIdx]);
+            }
+            if ( enablePolymer ) {
+                addEquation(contiPolymerEqIdx, 1.0 / fs.invB(FluidSystem::waterPhaseIdx).value(),
+                            cellResid[contiPolymerEqIdx]);
+            }
 
-                    const unsigned compIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::solventComponentIndex(phaseIdx));
+            if ( enablePolymerMW ) {
+                assert( enablePolymer );
 
-                    B_avg[ compIdx ] += 1.0 / fs.invB(phaseIdx).value();
-                    const auto R2 = ebosResid[cell_idx][compIdx];
+                // the residual of the polymer molecular equation is scaled down by a 100, since molecular weight
+                // can be much bigger than 1, and this equation shares the same tolerance with other mass balance equations
+                // TODO: there should be a more general way to determine the scaling-down coefficient
+                addEquation(contiPolymerMWEqIdx, 1.0 / fs.invB(FluidSystem::waterPhaseIdx).value(),
+                            cellResid[contiPolymerMWEqIdx] / 100.);
+            }
 
-                    R_sum[ compIdx ] += R2;
-                    maxCoeff[ compIdx ] = std::max( maxCoeff[ compIdx ], std::abs( R2 ) / pvValue );
-                }
+            if ( enableEnergy ) {
+                addEquation(contiEnergyEqIdx, 1.0, cellResid[contiEnergyEqIdx]);
+            }
+        }
 
-                if ( has_solvent_ ) {
-                    B_avg[ contiSolventEqIdx ] += 1.0 / intQuants.solventInverseFormationVolumeFactor().value();
-                    const auto R2 = ebosResid[cell_idx][contiSolventEqIdx];
-                    R_sum[ contiSolventEqIdx ] += R2;
-                    maxCoeff[ contiSolventEqIdx ] = std::max( maxCoeff[ contiSolventEqIdx ], std::abs( R2 ) / pvValue );
-                }
-                if (has_polymer_ ) {
-                    B_avg[ contiPolymerEqIdx ] += 1.0 / fs.invB(FluidSystem::waterPhaseIdx).value();
-                    const auto R2 = ebosResid[cell_idx][contiPolymerEqIdx];
-                    R_sum[ contiPolymerEqIdx ] += R2;
-                    maxCoeff[ contiPolymerEqIdx ] = std::max( maxCoeff[ contiPolymerEqIdx ], std::abs( R2 ) / pvValue );
+        /// The indices of the interior cells of this process, in grid order.
+        const std::vector<unsigned>& interiorCells() const
+        {
+            if (interior_cells_.empty()) {
+                const auto& elemMapper = ebosSimulator_.model().elementMapper();
+                const auto& gridView = ebosSimulator_.gridView();
+                const auto& elemEndIt = gridView.template end</*codim=*/0, Dune::Interior_Partition>();
+                for (auto elemIt = gridView.template begin</*codim=*/0, Dune::Interior_Partition>();
+                     elemIt != elemEndIt;
+                     ++elemIt)
+                {
+                    interior_cells_.push_back(elemMapper.index(*elemIt));
                 }
+            }
+            return interior_cells_;
+        }
 
-                if (has_polymermw_) {
-                    assert(has_polymer_);
+        /// The number of interior cells per partial sum of the threaded reductions.
+        ///
+        /// The partial sums are added in a fixed order, hence the results do
+        /// not depend on the number of threads.
+        static const std::size_t reductionChunkSize = 1024;
 
-                    B_avg[contiPolymerMWEqIdx] += 1.0 / fs.invB(FluidSystem::waterPhaseIdx).value();
-                    // the residual of the polymer molecular equation is scaled down by a 100, since molecular weight
-                    // can be much bigger than 1, and this equation shares the same tolerance with other mass balance equations
-                    // TODO: there should be a more general way to determine the scaling-down coefficient
-                    const auto R2 = ebosResid[cell_idx][contiPolymerMWEqIdx] / 100.;
-                    R_sum[contiPolymerMWEqIdx] += R2;
-                    maxCoeff[contiPolymerMWEqIdx] = std::max( maxCoeff[contiPolymerMWEqIdx], std::abs( R2 ) / pvValue );
+        // Split the cells into subdomains of nearly equal cost, whose boundaries
+        // cross the weakest transmissibilities.
+        std::vector<int> partitionDomains_(const Mat& ebosJac, const int numDomains) const
+        {
+            const auto& ebosModel = ebosSimulator_.model();
+            const int nc = UgGridHelpers::numCells(grid_);
+            std::vector<int> phasesPresent(nc, 1);
+            if (nc > 0 && ebosModel.cachedIntensiveQuantities(0, /*timeIdx=*/0)) {
+                for (int cell_idx = 0; cell_idx < nc; ++cell_idx) {
+                    const auto& fs = ebosModel.cachedIntensiveQuantities(cell_idx, /*timeIdx=*/0)->fluidState();
+                    int present = 0;
+                    for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx) {
+                        if (phaseIsActive(phaseIdx) && Opm::getValue(fs.saturation(phaseIdx)) > 0.0) {
+                            ++present;
+                        }
+                    }
+                    phasesPresent[cell_idx] = std::max(present, 1);
                 }
+            }
+            const std::vector<double> weights =
+                CellCostModel().weights(phasesPresent, wellModel().numberOfPerforationsPerCell(nc), {});
+
+            const auto& transmissibilities = ebosSimulator_.problem().eclTransmissibilities();
+            const auto connection = [&transmissibilities](std::size_t i, std::size_t j) {
+                return transmissibilities.transmissibility(i, j);
+            };
+            return partitionWeightedMatrixGraph(ebosJac, numDomains, weights, connection);
+        }
 
-                if (has_energy_ ) {
-                    B_avg[ contiEnergyEqIdx ] += 1.0;
-                    const auto R2 = ebosResid[cell_idx][contiEnergyEqIdx];
-                    R_sum[ contiEnergyEqIdx ] += R2;
-                    maxCoeff[ contiEnergyEqIdx ] = std::max( maxCoeff[ contiEnergyEqIdx ], std::abs( R2 ) / pvValue );
-                }
+        // Get reservoir quantities on this process needed for convergence calculations.
+        double localConvergenceData(std::vector<Scalar>& R_sum,
+                                    std::vector<Scalar>& maxCoeff,
+                                    std::vector<Scalar>& B_avg)
+        {
+            static auto& timing = TimingRegistry::instance().entry("newton.convergence_data");
+            ScopedTiming scopedTiming(timing);
 
+            const auto& ebosModel = ebosSimulator_.model();
+            const auto& cells = interiorCells();
+            ConvergenceSums sums;
+
+            if (cells.empty() || ebosModel.cachedIntensiveQuantities(cells.front(), /*timeIdx=*/0)) {
+                // The linearizer has just computed the intensive quantities of all
+                // cells, use them instead of updating an element context per cell.
+                const std::size_t numChunks = (cells.size() + reductionChunkSize - 1) / reductionChunkSize;
+                auto& partialSums = partial_convergence_sums_;
+                partialSums.assign(numChunks, ConvergenceSums());
+#if HAVE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif // HAVE_OPENMP
+                for (std::ptrdiff_t chunk = 0; chunk < static_cast<std::ptrdiff_t>(numChunks); ++chunk) {
+                    const std::size_t end = std::min((chunk + 1) * reductionChunkSize, cells.size());
+                    for (std::size_t i = chunk * reductionChunkSize; i < end; ++i) {
+                        addConvergenceData(cells[i], *ebosModel.cachedIntensiveQuantities(cells[i], /*timeIdx=*/0),
+                                           partialSums[chunk]);
+                    }
+                }
+                for (const auto& partial : partialSums) {
+                    sums.add(partial);
+                }
+            }
+            else {
+                // no cache, e.g. if it is disabled
+                ElementContext elemCtx(ebosSimulator_);
+                const auto& gridView = ebosSimulator().gridView();
+                const auto& elemEndIt = gridView.template end</*codim=*/0, Dune::Interior_Partition>();
+                for (auto elemIt = gridView.template begin</*codim=*/0, Dune::Interior_Partition>();
+                     elemIt != elemEndIt;
+                     ++elemIt)
+                {
+                    elemCtx.updatePrimaryStencil(*elemIt);
+                    elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
+                    const unsigned cell_idx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
+                    addConvergenceData(cell_idx, elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0), sums);
+                }
             }
 
             // compute local average in terms of global number of elements
             const int bSize = B_avg.size();
             for ( int i = 0; i<bSize; ++i )
             {
-                B_avg[ i ] /= Scalar( global_nc_ );
+                R_sum[ i ] += sums.R_sum[ i ];
+                maxCoeff[ i ] = std::max( maxCoeff[ i ], sums.maxCoeff[ i ] );
+                B_avg[ i ] = ( B_avg[ i ] + sums.B_avg[ i ] ) / Scalar( global_nc_ );
             }
 
-            return pvSumLocal;
+            return sums.pvSum;
         }
 
         ConvergenceReport getReservoirConvergence(const double dt,
                                                   const int iteration,
                                                   std::vector<Scalar>& B_avg,
-                                                  std::vector<Scalar>& residual_norms)
+                                                  ResidualNorms& residual_norms)
         {
-            typedef std::vector< Scalar > Vector;
-
             const double tol_mb  = param_.tolerance_mb_;
             const double tol_cnv = (iteration < param_.max_strict_iter_) ? param_.tolerance_cnv_ : param_.tolerance_cnv_relaxed_;
 
             const int numComp = numEq;
-            Vector R_sum(numComp, 0.0 );
-            Vector maxCoeff(numComp, std::numeric_limits< Scalar >::lowest() );
+            // the buffers are owned by the model to keep the Newton iterations free of allocations
+            auto& R_sum = conv_R_sum_;
+            auto& maxCoeff = conv_max_coeff_;
+            R_sum.assign(numComp, 0.0);
+            maxCoeff.assign(numComp, std::numeric_limits< Scalar >::lowest());
             const double pvSumLocal = localConvergenceData(R_sum, maxCoeff, B_avg);
 
             // compute global sum and max of quantities
@@ -830,40 +2174,19 @@ namespace Opm {
                                                       R_sum, maxCoeff, B_avg);
 
             // Finish computation
-            std::vector<Scalar> CNV(numComp);
-            std::vector<Scalar> mass_balance_residual(numComp);
+            std::array<Scalar, numEq> CNV;
+            std::array<Scalar, numEq> mass_balance_residual;
             for ( int compIdx = 0; compIdx < numComp; ++compIdx )
             {
                 CNV[compIdx]                    = B_avg[compIdx] * dt * maxCoeff[compIdx];
                 mass_balance_residual[compIdx]  = std::abs(B_avg[compIdx]*R_sum[compIdx]) * dt / pvSum;
-                residual_norms.push_back(CNV[compIdx]);
+                residual_norms[compIdx] = CNV[compIdx];
             }
 
-            // Setup component names, only the first time the function is run.
-            static std::vector<std::string> compNames;
-            if (compNames.empty()) {
-                compNames.resize(numComp);
-                for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx) {
-                    if (!FluidSystem::phaseIsActive(phaseIdx)) {
-                        continue;
-                    }
-                    const unsigned canonicalCompIdx = FluidSystem::solventComponentIndex(phaseIdx);
-                    const unsigned compIdx = Indices::canonicalToActiveComponentIndex(canonicalCompIdx);
-                    compNames[compIdx] = FluidSystem::componentName(canonicalCompIdx);
-                }
-                if (has_solvent_) {
-                    compNames[solventSaturationIdx] = "Solvent";
-                }
-                if (has_polymer_) {
-                    compNames[polymerConcentrationIdx] = "Polymer";
-                }
-                if (has_polymermw_) {
-                    assert(has_polymer_);
-                    compNames[polymerMoleWeightIdx] = "MolecularWeightP";
-                }
-                if (has_energy_) {
-                    compNames[temperatureIdx] = "Energy";
-                }
+            const auto& compNames = componentNames();
+            if (newton_trace_) {
+                trace_mass_balance_.assign(mass_balance_residual.begin(), mass_balance_residual.end());
+                trace_cnv_.assign(CNV.begin(), CNV.end());
             }
 
             // Create convergence report.
@@ -939,15 +2262,156 @@ namespace Opm {
         /// \param[out]  residual_norms   CNV residuals by phase
         ConvergenceReport getConvergence(const SimulatorTimerInterface& timer,
                                          const int iteration,
-                                         std::vector<double>& residual_norms)
+                                         ResidualNorms& residual_norms)
         {
+            static auto& timing = TimingRegistry::instance().entry("newton.convergence");
+            ScopedTiming scopedTiming(timing);
+
             // Get convergence reports for reservoir and wells.
-            std::vector<Scalar> B_avg(numEq, 0.0);
-            auto report = getReservoirConvergence(timer.currentStepLength(), iteration, B_avg, residual_norms);
-            report += wellModel().getWellConvergence(B_avg);
+            B_avg_.assign(numEq, 0.0);
+            auto report = getReservoirConvergence(timer.currentStepLength(), iteration, B_avg_, residual_norms);
+            report += wellModel().getWellConvergence(B_avg_);
+            if (hot_spots_ && !report.converged()) {
+                recordHotSpots(timer.currentStepLength(), report);
+            }
             return report;
         }
 
+        /// Add the failed wells of a Newton iteration which did not converge to
+        /// the hot spots, and the cells with the largest CNV residual over all
+        /// processes if the CNV tolerance is not met.
+        ///
+        /// Only the cells above the strict CNV tolerance are candidates. Each
+        /// process sends its worst cells to all the others, as the convergence
+        /// report is the same on all of them.
+        void recordHotSpots(const double dt, const ConvergenceReport& report)
+        {
+            static auto& timing = TimingRegistry::instance().entry("newton.hot_spots");
+            ScopedTiming scopedTiming(timing);
+
+            typedef ConvergenceHotSpots::Cell Cell;
+            const std::size_t numReported = hot_spots_->numReported();
+            auto& cells = hot_spot_cells_;
+            cells.clear();
+
+            const auto& failures = report.reservoirFailures();
+            const bool cnvFailed = std::any_of(failures.begin(), failures.end(),
+                                               [](const ConvergenceReport::ReservoirFailure& failure) {
+                                                   return failure.type() == ConvergenceReport::ReservoirFailure::Type::Cnv;
+                                               });
+            if (cnvFailed) {
+                const auto& ebosModel = ebosSimulator_.model();
+                const auto& ebosResid = ebosModel.linearizer().residual();
+                const int* globalCell = UgGridHelpers::globalCell(grid_);
+                const auto& regions = hotSpotRegions();
+                for (const unsigned cell_idx : interiorCells()) {
+                    const double pvValue = ebosSimulator_.problem().porosity(cell_idx) * ebosModel.dofTotalVolume(cell_idx);
+                    Cell cell{ globalCell ? globalCell[cell_idx] : static_cast<int>(cell_idx), regions[cell_idx], -1, 0.0 };
+                    for (int compIdx = 0; compIdx < numEq; ++compIdx) {
+                        const double cnv = B_avg_[compIdx] * dt * std::abs(ebosResid[cell_idx][compIdx]) / pvValue;
+                        if (cnv > cell.cnv) {
+                            cell.cnv = cnv;
+                            cell.component = compIdx;
+                        }
+                    }
+                    if (cell.cnv > param_.tolerance_cnv_) {
+                        cells.push_back(cell);
+                    }
+                }
+                ConvergenceHotSpots::keepLargest(cells, numReported);
+
+                if (isParallel()) {
+                    // a negative residual marks an unused entry
+                    const int entries = 4 * numReported;
+                    std::vector<double> send(entries, -1.0);
+                    for (std::size_t i = 0; i < cells.size(); ++i) {
+                        send[4 * i] = cells[i].cnv;
+                        send[4 * i + 1] = cells[i].cartesian_index;
+                        send[4 * i + 2] = cells[i].region;
+                        send[4 * i + 3] = cells[i].component;
+                    }
+                    std::vector<double> received(entries * grid_.comm().size());
+                    grid_.comm().allgather(send.data(), entries, received.data());
+                    cells.clear();
+                    for (std::size_t i = 0; i < received.size(); i += 4) {
+                        if (received[i] >= 0.0) {
+                            cells.push_back({ static_cast<int>(received[i + 1]), static_cast<int>(received[i + 2]),
+                                              static_cast<int>(received[i + 3]), received[i] });
+                        }
+                    }
+                    ConvergenceHotSpots::keepLargest(cells, numReported);
+                }
+            }
+
+            std::vector<std::string> wells;
+            for (const auto& failure : report.wellFailures()) {
+                wells.push_back(failure.wellName());
+            }
+            hot_spots_->addIteration(cells, std::move(wells));
+        }
+
+        /// The FIPNUM region of each cell, for the hot spots.
+        const std::vector<int>& hotSpotRegions()
+        {
+            if (hot_spot_regions_.empty()) {
+                const int nc = UgGridHelpers::numCells(grid_);
+                const int* globalCell = UgGridHelpers::globalCell(grid_);
+                const auto& fipnum = eclState().get3DProperties().getIntGridProperty("FIPNUM").getData();
+                hot_spot_regions_.resize(nc);
+                for (int cell_idx = 0; cell_idx < nc; ++cell_idx) {
+                    hot_spot_regions_[cell_idx] = fipnum[globalCell ? globalCell[cell_idx] : cell_idx];
+                }
+            }
+            return hot_spot_regions_;
+        }
+
+
+        /// The names of the components, in the order of the equations.
+        const std::vector<std::string>& componentNames() const
+        {
+            // Setup component names, only the first time the function is run.
+            static std::vector<std::string> compNames;
+            if (compNames.empty()) {
+                compNames.resize(numEq);
+                for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx) {
+                    if (!phaseIsActive(phaseIdx)) {
+                        continue;
+                    }
+                    const unsigned canonicalCompIdx = FluidSystem::solventComponentIndex(phaseIdx);
+                    const unsigned compIdx = Indices::canonicalToActiveComponentIndex(canonicalCompIdx);
+                    compNames[compIdx] = FluidSystem::componentName(canonicalCompIdx);
+                }
+                if (has_solvent_) {
+                    compNames[solventSaturationIdx] = "Solvent";
+                }
+                if (has_polymer_) {
+                    compNames[polymerConcentrationIdx] = "Polymer";
+                }
+                if (has_polymermw_) {
+                    assert(has_polymer_);
+                    compNames[polymerMoleWeightIdx] = "MolecularWeightP";
+                }
+                if (has_energy_) {
+                    compNames[temperatureIdx] = "Energy";
+                }
+            }
+            return compNames;
+        }
+
+        /// Write a line to the trace for each Newton iteration (nullptr: no trace).
+        /// The trace has to outlive the model.
+        void setNewtonTrace(NewtonTrace* trace)
+        {
+            newton_trace_ = trace;
+        }
+
+        /// Record the cells and wells of the Newton iterations which did not
+        /// converge (nullptr: no record). Has to be the same on all processes
+        /// and to outlive the model.
+        void setConvergenceHotSpots(ConvergenceHotSpots* hotSpots)
+        {
+            hot_spots_ = hotSpots;
+        }
 
         /// The number of active fluid phases in the model.
         int numPhases() const
@@ -1026,14 +2490,81 @@ namespace Opm {
         /// \brief The number of cells of the global grid.
         long int global_nc_;
 
-        std::vector<std::vector<double>> residual_norms_history_;
+        std::vector<ResidualNorms> residual_norms_history_;
         double current_relaxation_;
         BVector dx_old_;
+        // the Newton update of the current iteration
+        BVector newton_update_;
+        // the reduction of the linear solver in the last Newton iteration
+        double forcing_term_;
 
         std::unique_ptr<Mat> matrix_for_preconditioner_;
-        std::vector<std::pair<int,std::vector<int>>> overlapRowAndColumns_;
+        // builds matrix_for_preconditioner_ while the convergence is checked (overlap_newton_tasks_)
+        std::future<void> preconditioner_matrix_task_;
+        // the consecutive chord iterations and whether the Jacobian and the
+        // preconditioner of the last solve can be kept (chord_newton_max_iterations_)
+        int chord_iterations_ = 0;
+        bool chord_jacobian_valid_ = false;
+        // the true-IMPES weights of the CPR preconditioner (cpr_use_true_impes_)
+        BVector impes_weights_;
+        // the true-IMPES weights for the scaled rows (update_equations_scaling_)
+        mutable BVector scaled_impes_weights_;
+        // the Jacobian with compact indices (linear_solver_compressed_matrix_)
+        mutable std::unique_ptr<CompressedMat> compressed_jacobian_;
+        // the memory of the Jacobian and of its copies, for the memory report
+        MemoryAccount jacobian_memory_{ MemoryRegistry::instance().entry("jacobian") };
+        MemoryAccount preconditioner_matrix_memory_{ MemoryRegistry::instance().entry("jacobian.preconditioner_copy") };
+        mutable MemoryAccount compressed_jacobian_memory_{ MemoryRegistry::instance().entry("jacobian.compressed_copy") };
+        /// The interior cells of this process (see interiorCells()).
+        mutable std::vector<unsigned> interior_cells_;
+        // the buffers of the convergence check, kept between the iterations
+        std::vector<ConvergenceSums> partial_convergence_sums_;
+        std::vector<Scalar> conv_R_sum_;
+        std::vector<Scalar> conv_max_coeff_;
+        // the batch of the global sums and maxima of an iteration
+        mutable ReductionBatch reduction_batch_;
+        // the last Newton update and the average formation volume factors of the
+        // last convergence check, which select the cells of a localized update
+        BVector last_update_;
+        std::vector<Scalar> B_avg_;
+        ActiveSubdomain<Mat> subdomain_;
+        // the subdomain of each cell and the systems of the subdomains of the
+        // nonlinear domain decomposition
+        std::vector<int> domain_of_cell_;
+        std::vector<ActiveSubdomain<Mat> > domain_systems_;
+        // the IMPES cells of the last Newton update (adaptive_implicit_cfl_)
+        mutable AdaptiveImplicitReduction<Mat, BVector> adaptive_implicit_;
+        // the factors of the last scaled Newton system (update_equations_scaling_)
+        mutable EquationScaling<Mat, BVector> equation_scaling_;
+        // the state of the sequential updates (sequential_implicit_)
+        SequentialSplitting<Mat, BVector> splitting_;
+        BVector sequential_weights_;
+        int sequential_linear_iterations_ = 0;
+        bool sequential_fallback_ = false;
+        // owned by the linear solver, which lives for the whole simulation
+        const std::vector<std::pair<int,std::vector<int>>>* overlapRowAndColumns_;
+        // the trace of the Newton iterations and the residuals of the last convergence check
+        NewtonTrace* newton_trace_ = nullptr;
+        // the record of the cells and wells which did not converge, their buffer and the regions of the cells
+        ConvergenceHotSpots* hot_spots_ = nullptr;
+        std::vector<ConvergenceHotSpots::Cell> hot_spot_cells_;
+        std::vector<int> hot_spot_regions_;
+        std::vector<Scalar> trace_mass_balance_;
+        std::vector<Scalar> trace_cnv_;
 
         std::vector<StepReport> convergence_reports_;
+
+        // the solution before the last Newton update, to find the cells it changed
+        SolutionVector solution_before_update_;
+        std::vector<unsigned char> update_status_;
+        int last_update_switched_cells_ = 0;
+        int last_update_chopped_cells_ = 0;
+
+        // the start of the last time step of the report step and its length, for the predictor
+        SolutionVector older_solution_;
+        Scalar older_solution_dt_ = 0.0;
+        std::vector<bool> older_switched_;
+        int older_solution_report_step_ = -1;
     public:
         /// return the StandardWells object
         BlackoilWellModel<TypeTag>&
@@ -45,10 +45,37 @@ NEW_PROP_TAG(UseMultisegmentWell);
 NEW_PROP_TAG(MaxSinglePrecisionDays);
 NEW_PROP_TAG(MaxStrictIter);
 NEW_PROP_TAG(SolveWelleqInitially);
+NEW_PROP_TAG(SolveWelleqEachIteration);
 NEW_PROP_TAG(UpdateEquationsScaling);
 NEW_PROP_TAG(UseUpdateStabilization);
 NEW_PROP_TAG(MatrixAddWellContributions);
 NEW_PROP_TAG(PreconditionerAddWellContributions);
+NEW_PROP_TAG(PreconditionerAddWellContributionsMinPerfs);
+NEW_PROP_TAG(ThreadedWellAssembly);
+NEW_PROP_TAG(ExplicitWellEnergyFlux);
+NEW_PROP_TAG(LinearSystemDumpDir);
+NEW_PROP_TAG(LinearSystemDumpReportStep);
+NEW_PROP_TAG(LinearSystemDumpNewtonIteration);
+NEW_PROP_TAG(LocalizedNewtonThreshold);
+NEW_PROP_TAG(LocalizedNewtonHalo);
+NEW_PROP_TAG(LocalizedNewtonMaxFraction);
+NEW_PROP_TAG(SequentialImplicit);
+NEW_PROP_TAG(SequentialMaxIterations);
+NEW_PROP_TAG(SequentialTransportSweeps);
+NEW_PROP_TAG(NewtonTraceFile);
+NEW_PROP_TAG(ConvergenceHotSpots);
+NEW_PROP_TAG(AdaptiveImplicitCfl);
+NEW_PROP_TAG(ConnectionPressureTolerance);
+NEW_PROP_TAG(WellPotentialTolerance);
+NEW_PROP_TAG(GroupControlTolerance);
+NEW_PROP_TAG(PredictWellState);
+NEW_PROP_TAG(KeepFailedWellState);
+NEW_PROP_TAG(PredictSolution);
+NEW_PROP_TAG(RateConversionTolerance);
+NEW_PROP_TAG(IntensiveQuantitiesTolerance);
+NEW_PROP_TAG(OverlapNewtonTasks);
+NEW_PROP_TAG(ChordNewtonMaxIterations);
+NEW_PROP_TAG(ChordNewtonMaxRate);
 
 // parameters for multisegment wells
 NEW_PROP_TAG(TolerancePressureMsWells);
@@ -69,10 +96,37 @@ SET_BOOL_PROP(FlowModelParameters, UseMultisegmentWell, false);
 SET_SCALAR_PROP(FlowModelParameters, MaxSinglePrecisionDays, 20.0);
 SET_INT_PROP(FlowModelParameters, MaxStrictIter, 8);
 SET_BOOL_PROP(FlowModelParameters, SolveWelleqInitially, true);
+SET_BOOL_PROP(FlowModelParameters, SolveWelleqEachIteration, false);
 SET_BOOL_PROP(FlowModelParameters, UpdateEquationsScaling, false);
 SET_BOOL_PROP(FlowModelParameters, UseUpdateStabilization, true);
 SET_BOOL_PROP(FlowModelParameters, MatrixAddWellContributions, false);
 SET_BOOL_PROP(FlowModelParameters, PreconditionerAddWellContributions, false);
+SET_INT_PROP(FlowModelParameters, PreconditionerAddWellContributionsMinPerfs, 0);
+SET_BOOL_PROP(FlowModelParameters, ThreadedWellAssembly, false);
+SET_BOOL_PROP(FlowModelParameters, ExplicitWellEnergyFlux, false);
+SET_STRING_PROP(FlowModelParameters, LinearSystemDumpDir, "");
+SET_INT_PROP(FlowModelParameters, LinearSystemDumpReportStep, -1);
+SET_INT_PROP(FlowModelParameters, LinearSystemDumpNewtonIteration, -1);
+SET_SCALAR_PROP(FlowModelParameters, LocalizedNewtonThreshold, 0.0);
+SET_INT_PROP(FlowModelParameters, LocalizedNewtonHalo, 1);
+SET_SCALAR_PROP(FlowModelParameters, LocalizedNewtonMaxFraction, 0.5);
+SET_BOOL_PROP(FlowModelParameters, SequentialImplicit, false);
+SET_INT_PROP(FlowModelParameters, SequentialMaxIterations, 6);
+SET_INT_PROP(FlowModelParameters, SequentialTransportSweeps, 2);
+SET_STRING_PROP(FlowModelParameters, NewtonTraceFile, "");
+SET_INT_PROP(FlowModelParameters, ConvergenceHotSpots, 0);
+SET_SCALAR_PROP(FlowModelParameters, AdaptiveImplicitCfl, 0.0);
+SET_SCALAR_PROP(FlowModelParameters, ConnectionPressureTolerance, 0.0);
+SET_SCALAR_PROP(FlowModelParameters, WellPotentialTolerance, 0.0);
+SET_SCALAR_PROP(FlowModelParameters, GroupControlTolerance, 0.0);
+SET_BOOL_PROP(FlowModelParameters, PredictWellState, false);
+SET_BOOL_PROP(FlowModelParameters, KeepFailedWellState, false);
+SET_BOOL_PROP(FlowModelParameters, PredictSolution, false);
+SET_SCALAR_PROP(FlowModelParameters, RateConversionTolerance, 0.0);
+SET_SCALAR_PROP(FlowModelParameters, IntensiveQuantitiesTolerance, 0.0);
+SET_BOOL_PROP(FlowModelParameters, OverlapNewtonTasks, false);
+SET_INT_PROP(FlowModelParameters, ChordNewtonMaxIterations, 0);
+SET_SCALAR_PROP(FlowModelParameters, ChordNewtonMaxRate, 0.5);
 SET_SCALAR_PROP(FlowModelParameters, TolerancePressureMsWells, 0.01 *1e5);
 SET_SCALAR_PROP(FlowModelParameters, MaxPressureChangeMsWells, 2.0 *1e5);
 SET_BOOL_PROP(FlowModelParameters, UseInnerIterationsMsWells, true);
@@ -136,7 +190,10 @@ namespace Opm
         /// Solve well equation initially
         bool solve_welleq_initially_;
 
-        /// Update scaling factors for mass balance equations
+        /// Solve the equations of each well on its own before the later Newton iterations
+        bool solve_welleq_each_iteration_;
+
+        /// Scale the rows and columns of the Newton systems before the linear solves
         bool update_equations_scaling_;
 
         /// Try to detect oscillation or stagnation.
@@ -158,6 +215,93 @@ namespace Opm
         // Whether to add influences of wells between cells to the preconditioner matrix only
         bool preconditioner_add_well_contributions_;
 
+        // Add influences of wells between cells to the preconditioner matrix if a well
+        // has at least this many perforations (0: never decide this automatically)
+        int preconditioner_add_well_contributions_min_perfs_;
+
+        // Whether the standard wells are assembled and solved by several threads
+        bool threaded_well_assembly_;
+
+        // Whether the energy flux of the standard wells enters the reservoir without derivatives
+        bool explicit_well_energy_flux_;
+
+        // Directory to write the linear systems solved to (empty: do not write them)
+        std::string linear_system_dump_dir_;
+
+        // Only write the linear systems of this report step (-1: all report steps)
+        int linear_system_dump_report_step_;
+
+        // Only write the linear systems of this Newton iteration (-1: all iterations)
+        int linear_system_dump_newton_iteration_;
+
+        // Solve for the cells whose last update exceeded this relative threshold only,
+        // or whose residual is not converged (0: always solve for all cells)
+        double localized_newton_threshold_;
+
+        // The number of layers of neighbours added to the active cells of a localized update
+        int localized_newton_halo_;
+
+        // Solve for all cells if more than this fraction of them are active
+        double localized_newton_max_fraction_;
+
+        // Whether the Newton updates are computed by a pressure solve followed by a transport solve
+        bool sequential_implicit_;
+
+        // The number of Newton iterations of a time step with sequential updates
+        int sequential_max_iterations_;
+
+        // The number of Gauss-Seidel sweeps of the transport step of a sequential update
+        int sequential_transport_sweeps_;
+
+        // CSV file to write a line for each Newton iteration to (empty: no trace)
+        std::string newton_trace_file_;
+
+        // Number of cells and wells recorded for each Newton iteration which did not converge and listed at the end of the run
+        int convergence_hot_spots_;
+
+        // Treat the cells with a smaller throughput CFL number IMPES (0: fully implicit)
+        double adaptive_implicit_cfl_;
+
+        // Relative change of the inputs below which the connection densities and pressure differences of a standard well are kept
+        double connection_pressure_tolerance_;
+
+        // Relative change of the controls and of the conditions in the perforated cells below which the well potentials are kept
+        double well_potential_tolerance_;
+
+        // Relative change of the well rates, BHPs and THPs below which the group controls are not applied again
+        double group_control_tolerance_;
+
+        // Extrapolate the BHPs and rates of the wells from the last two time steps as the initial guess of a time step
+        bool predict_well_state_;
+
+        // Restart a failed time step from the BHPs and rates of the wells interpolated towards the failed attempt
+        bool keep_failed_well_state_;
+
+        // Extrapolate the primary variables of the cells from the last two time steps as the initial guess of a time step
+        bool predict_solution_;
+
+        // Relative change of the average state of a region below which its surface to reservoir rate conversion coefficients are kept
+        double rate_conversion_tolerance_;
+
+        // Relative change of the primary variables of a cell below which its intensive quantities are kept after a Newton update
+        double intensive_quantities_tolerance_;
+
+        // Build the matrix of the preconditioner on a separate thread while the convergence is checked
+        bool overlap_newton_tasks_;
+
+        // Largest number of consecutive Newton iterations with the Jacobian and the preconditioner of the last full iteration
+        int chord_newton_max_iterations_;
+
+        // Largest ratio of the residual norms of two iterations for which the next iteration keeps the Jacobian
+        double chord_newton_max_rate_;
+
+        // Whether the sparsity pattern needs to contain the connections between the cells of a well
+        bool needWellConnectionsInMatrix() const
+        {
+            return matrix_add_well_contributions_ || preconditioner_add_well_contributions_
+                || preconditioner_add_well_contributions_min_perfs_ > 0;
+        }
+
         /// Construct from user parameters or defaults.
         BlackoilModelParametersEbos()
         {
@@ -178,10 +322,37 @@ namespace Opm
             maxSinglePrecisionTimeStep_ = EWOMS_GET_PARAM(TypeTag, Scalar, MaxSinglePrecisionDays) *24*60*60;
             max_strict_iter_ = EWOMS_GET_PARAM(TypeTag, int, MaxStrictIter);
             solve_welleq_initially_ = EWOMS_GET_PARAM(TypeTag, bool, SolveWelleqInitially);
+            solve_welleq_each_iteration_ = EWOMS_GET_PARAM(TypeTag, bool, SolveWelleqEachIteration);
             update_equations_scaling_ = EWOMS_GET_PARAM(TypeTag, bool, UpdateEquationsScaling);
             use_update_stabilization_ = EWOMS_GET_PARAM(TypeTag, bool, UseUpdateStabilization);
             matrix_add_well_contributions_ = EWOMS_GET_PARAM(TypeTag, bool, MatrixAddWellContributions);
             preconditioner_add_well_contributions_ = EWOMS_GET_PARAM(TypeTag, bool, PreconditionerAddWellContributions);
+            preconditioner_add_well_contributions_min_perfs_ = EWOMS_GET_PARAM(TypeTag, int, PreconditionerAddWellContributionsMinPerfs);
+            threaded_well_assembly_ = EWOMS_GET_PARAM(TypeTag, bool, ThreadedWellAssembly);
+            explicit_well_energy_flux_ = EWOMS_GET_PARAM(TypeTag, bool, ExplicitWellEnergyFlux);
+            linear_system_dump_dir_ = EWOMS_GET_PARAM(TypeTag, std::string, LinearSystemDumpDir);
+            linear_system_dump_report_step_ = EWOMS_GET_PARAM(TypeTag, int, LinearSystemDumpReportStep);
+            linear_system_dump_newton_iteration_ = EWOMS_GET_PARAM(TypeTag, int, LinearSystemDumpNewtonIteration);
+            localized_newton_threshold_ = EWOMS_GET_PARAM(TypeTag, Scalar, LocalizedNewtonThreshold);
+            localized_newton_halo_ = EWOMS_GET_PARAM(TypeTag, int, LocalizedNewtonHalo);
+            localized_newton_max_fraction_ = EWOMS_GET_PARAM(TypeTag, Scalar, LocalizedNewtonMaxFraction);
+            sequential_implicit_ = EWOMS_GET_PARAM(TypeTag, bool, SequentialImplicit);
+            sequential_max_iterations_ = EWOMS_GET_PARAM(TypeTag, int, SequentialMaxIterations);
+            sequential_transport_sweeps_ = EWOMS_GET_PARAM(TypeTag, int, SequentialTransportSweeps);
+            newton_trace_file_ = EWOMS_GET_PARAM(TypeTag, std::string, NewtonTraceFile);
+            convergence_hot_spots_ = EWOMS_GET_PARAM(TypeTag, int, ConvergenceHotSpots);
+            adaptive_implicit_cfl_ = EWOMS_GET_PARAM(TypeTag, Scalar, AdaptiveImplicitCfl);
+            connection_pressure_tolerance_ = EWOMS_GET_PARAM(TypeTag, Scalar, ConnectionPressureTolerance);
+            well_potential_tolerance_ = EWOMS_GET_PARAM(TypeTag, Scalar, WellPotentialTolerance);
+            group_control_tolerance_ = EWOMS_GET_PARAM(TypeTag, Scalar, GroupControlTolerance);
+            predict_well_state_ = EWOMS_GET_PARAM(TypeTag, bool, PredictWellState);
+            keep_failed_well_state_ = EWOMS_GET_PARAM(TypeTag, bool, KeepFailedWellState);
+            predict_solution_ = EWOMS_GET_PARAM(TypeTag, bool, PredictSolution);
+            rate_conversion_tolerance_ = EWOMS_GET_PARAM(TypeTag, Scalar, RateConversionTolerance);
+            intensive_quantities_tolerance_ = EWOMS_GET_PARAM(TypeTag, Scalar, IntensiveQuantitiesTolerance);
+            overlap_newton_tasks_ = EWOMS_GET_PARAM(TypeTag, bool, OverlapNewtonTasks);
+            chord_newton_max_iterations_ = EWOMS_GET_PARAM(TypeTag, int, ChordNewtonMaxIterations);
+            chord_newton_max_rate_ = EWOMS_GET_PARAM(TypeTag, Scalar, ChordNewtonMaxRate);
 
             deck_file_name_ = EWOMS_GET_PARAM(TypeTag, std::string, EclDeckFileName);
         }
@@ -205,10 +376,37 @@ namespace Opm
             EWOMS_REGISTER_PARAM(TypeTag, Scalar, MaxSinglePrecisionDays, "Maximum time step size where single precision floating point arithmetic can be used solving for the linear systems of equations");
             EWOMS_REGISTER_PARAM(TypeTag, int, MaxStrictIter, "Maximum number of Newton iterations before relaxed tolerances are used for the CNV convergence criterion");
             EWOMS_REGISTER_PARAM(TypeTag, bool, SolveWelleqInitially, "Fully solve the well equations before each iteration of the reservoir model");
-            EWOMS_REGISTER_PARAM(TypeTag, bool, UpdateEquationsScaling, "Update scaling factors for mass balance equations during the run");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, SolveWelleqEachIteration, "Also solve the equations of each well against the fixed reservoir state before the later Newton iterations of a time step. The wells are solved independently, and concurrently with ThreadedWellAssembly, unless group controls couple them");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, UpdateEquationsScaling, "Scale the equations of each Newton system by the average inverse formation volume factors times the time step over the pore volumes, and the unknowns by the magnitude of the scaled diagonal blocks, before the linear solve. Sequential runs only");
             EWOMS_REGISTER_PARAM(TypeTag, bool, UseUpdateStabilization, "Try to detect and correct oscillations or stagnation during the Newton method");
             EWOMS_REGISTER_PARAM(TypeTag, bool, MatrixAddWellContributions, "Explicitly specify the influences of wells between cells in the Jacobian and preconditioner matrices");
             EWOMS_REGISTER_PARAM(TypeTag, bool, PreconditionerAddWellContributions, "Explicitly specify the influences of wells between cells for the preconditioner matrix only");
+            EWOMS_REGISTER_PARAM(TypeTag, int, PreconditionerAddWellContributionsMinPerfs, "Explicitly specify the influences of wells between cells for the preconditioner matrix only if a well has at least this many perforations. 0 disables this");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, ExplicitWellEnergyFlux, "Add the energy flux of the standard wells to the reservoir as an explicit source term, computed from the values of the perforation rates only. The energy equation then has no coupling to the well unknowns in the Jacobian");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, ThreadedWellAssembly, "Assemble and solve the equations of the standard wells and compute their potentials with several threads. Each well is handled by one thread, hence the results do not depend on the number of threads");
+            EWOMS_REGISTER_PARAM(TypeTag, std::string, LinearSystemDumpDir, "Write the linear systems solved to binary files in this directory for replaying them. Empty disables this");
+            EWOMS_REGISTER_PARAM(TypeTag, int, LinearSystemDumpReportStep, "Only write the linear systems of this report step. -1 writes those of all report steps");
+            EWOMS_REGISTER_PARAM(TypeTag, int, LinearSystemDumpNewtonIteration, "Only write the linear systems of this Newton iteration. -1 writes those of all iterations");
+            EWOMS_REGISTER_PARAM(TypeTag, Scalar, LocalizedNewtonThreshold, "Solve the Newton updates after the first one only for the cells whose last update exceeded this threshold (relative for the pressure) or whose residual is not converged, plus a halo. 0 solves for all cells");
+            EWOMS_REGISTER_PARAM(TypeTag, int, LocalizedNewtonHalo, "The number of layers of neighbouring cells added to the active cells of a localized Newton update");
+            EWOMS_REGISTER_PARAM(TypeTag, Scalar, LocalizedNewtonMaxFraction, "Solve a localized Newton update for all cells if more than this fraction of the cells is active");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, SequentialImplicit, "Compute the first Newton updates of a time step by an AMG solve of the pressure system followed by transport sweeps over the cells ordered by pressure. Falls back to fully implicit updates if the residual is not reduced");
+            EWOMS_REGISTER_PARAM(TypeTag, int, SequentialMaxIterations, "The maximum number of sequential Newton updates per time step");
+            EWOMS_REGISTER_PARAM(TypeTag, int, SequentialTransportSweeps, "The number of Gauss-Seidel sweeps of the transport step of a sequential Newton update");
+            EWOMS_REGISTER_PARAM(TypeTag, std::string, NewtonTraceFile, "The name of a CSV file to write the residuals, linear iterations, relaxation and times of each Newton iteration to. Empty disables the trace");
+            EWOMS_REGISTER_PARAM(TypeTag, int, ConvergenceHotSpots, "The number of cells with the largest CNV residual over all processes recorded for each Newton iteration which did not converge, together with the failed wells. The cells and wells found in the most iterations are listed with their IJK, FIPNUM region, component and largest residual at the end of the run. 0 disables the report");
+            EWOMS_REGISTER_PARAM(TypeTag, Scalar, AdaptiveImplicitCfl, "Treat the cells whose throughput CFL number is below this threshold IMPES in the Newton updates: their unknowns other than the pressure are lagged in the equations of the neighbours and computed explicitly after the pressure solve. 0 is fully implicit");
+            EWOMS_REGISTER_PARAM(TypeTag, Scalar, ConnectionPressureTolerance, "The relative change of the pressures, rates and temperatures of a standard well below which its connection densities and pressure differences are not recomputed. 0 only reuses them for unchanged inputs");
+            EWOMS_REGISTER_PARAM(TypeTag, Scalar, WellPotentialTolerance, "The relative change of the controls, the well state and the pressures, mobilities and formation volume factors of the perforated cells of a well below which its potentials are not recomputed. 0 only reuses them for unchanged inputs");
+            EWOMS_REGISTER_PARAM(TypeTag, Scalar, GroupControlTolerance, "The relative change of the rates, BHPs and THPs of the wells below which the group targets are not distributed to the wells again within a time step, if no well changed its control. 0 only skips it for unchanged wells");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, PredictWellState, "Start a time step from the BHPs and rates of the wells extrapolated linearly from the last two time steps of the report step, for the wells whose control did not change");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, KeepFailedWellState, "Restart a chopped time step from the BHPs and rates of the wells interpolated between the start and the last Newton iterate of the failed attempt by the fraction of its length, for the wells whose control did not change");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, PredictSolution, "Start a time step from the primary variables of the cells extrapolated linearly from the last two time steps of the report step, for the cells whose primary variables did not switch. The saturations are kept within their bounds");
+            EWOMS_REGISTER_PARAM(TypeTag, Scalar, RateConversionTolerance, "The relative change of the average pressure, temperature, Rs and Rv of a region below which the coefficients converting the surface rates of the wells to reservoir rates are not computed again. 0 only reuses them for an unchanged state");
+            EWOMS_REGISTER_PARAM(TypeTag, Scalar, IntensiveQuantitiesTolerance, "The change of the primary variables of a cell by a Newton update, relative to their size or one if smaller, below which the intensive quantities of the cell are not computed again. 0 only reuses them for unchanged primary variables");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, OverlapNewtonTasks, "Copy the Jacobian to the matrix of the preconditioner and add the well contributions to it (PreconditionerAddWellContributions) on a separate thread, while the true-IMPES weights and the convergence with its collective communication are computed");
+            EWOMS_REGISTER_PARAM(TypeTag, int, ChordNewtonMaxIterations, "The largest number of consecutive Newton iterations which only evaluate the residual and solve with the Jacobian and the preconditioner of the last full iteration. Only used for sequential runs without UpdateEquationsScaling and AdaptiveImplicitCfl. 0 assembles the Jacobian in each iteration");
+            EWOMS_REGISTER_PARAM(TypeTag, Scalar, ChordNewtonMaxRate, "The largest ratio of the residual norm of a Newton iteration to the one of the previous iteration for which the next iteration keeps the Jacobian (see ChordNewtonMaxIterations)");
         }
     };
 } // namespace Opm
@@ -30,7 +30,12 @@
 #include <opm/common/utility/platform_dependent/disable_warnings.h>
 #include <opm/common/utility/platform_dependent/reenable_warnings.h>
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <exception>
+#include <map>
+#include <string>
 #include <tuple>
 
 #include <opm/parser/eclipse/EclipseState/Schedule/Schedule.hpp>
@@ -38,9 +43,11 @@
 
 #include <opm/core/wells.h>
 #include <opm/core/wells/WellCollection.hpp>
+#include <opm/core/simulator/BinarySerialization.hpp>
 #include <opm/core/simulator/SimulatorReport.hpp>
 #include <opm/autodiff/VFPInjProperties.hpp>
 #include <opm/autodiff/VFPProdProperties.hpp>
+#include <opm/autodiff/CartesianCellIndexMap.hpp>
 #include <opm/autodiff/BlackoilDetails.hpp>
 #include <opm/autodiff/WellStateFullyImplicitBlackoil.hpp>
 #include <opm/autodiff/RateConverter.hpp>
@@ -48,6 +55,9 @@
 #include <opm/autodiff/StandardWell.hpp>
 #include <opm/autodiff/StandardWellV.hpp>
 #include <opm/autodiff/MultisegmentWell.hpp>
+#include <opm/autodiff/PackedWellContributions.hpp>
+#include <opm/autodiff/MemoryRegistry.hpp>
+#include <opm/autodiff/TimingRegistry.hpp>
 #include <opm/simulators/timestepping/gatherConvergenceReport.hpp>
 #include<opm/autodiff/SimFIBODetails.hpp>
 #include<dune/common/fmatrix.hh>
@@ -76,6 +86,7 @@ namespace Opm {
             typedef BlackoilModelParametersEbos<TypeTag> ModelParameters;
 
             typedef typename GET_PROP_TYPE(TypeTag, Grid)                Grid;
+            typedef typename GET_PROP_TYPE(TypeTag, GridView)            GridView;
             typedef typename GET_PROP_TYPE(TypeTag, FluidSystem)         FluidSystem;
             typedef typename GET_PROP_TYPE(TypeTag, ElementContext)      ElementContext;
             typedef typename GET_PROP_TYPE(TypeTag, Indices)             Indices;
@@ -137,10 +148,26 @@ namespace Opm {
             // </ eWoms auxiliary module stuff>
             /////////////
 
+            /*!
+             * \brief This method reads the state of the wells written by
+             *        serialize(). The state is the one at the end of the last
+             *        time step, which every time step starts from.
+             */
             template <class Restarter>
             void deserialize(Restarter& res)
             {
-                // TODO (?)
+                res.deserializeSectionBegin("BlackoilWellModel");
+                std::istream& is = res.deserializeStream();
+                previous_well_state_.deserialize(is);
+                BinarySerialization::read(is, older_well_state_dt_);
+                if (older_well_state_dt_ > 0.0) {
+                    older_well_state_.deserialize(is);
+                }
+                res.deserializeSectionEnd();
+
+                well_state_ = previous_well_state_;
+                attempt_in_progress_ = false;
+                initial_step_ = false;
             }
 
             /*!
@@ -150,7 +177,14 @@ namespace Opm {
             template <class Restarter>
             void serialize(Restarter& res)
             {
-                // TODO (?)
+                res.serializeSectionBegin("BlackoilWellModel");
+                std::ostream& os = res.serializeStream();
+                previous_well_state_.serialize(os);
+                BinarySerialization::write(os, older_well_state_dt_);
+                if (older_well_state_dt_ > 0.0) {
+                    older_well_state_.serialize(os);
+                }
+                res.serializeSectionEnd();
             }
 
             void beginEpisode(const Opm::EclipseState& eclState,
@@ -203,6 +237,13 @@ namespace Opm {
             Opm::data::Wells wellData() const
             { return well_state_.report(phase_usage_, Opm::UgGridHelpers::globalCell(grid())); }
 
+            // assemble the well equations for the current reservoir solution without
+            // updating the controls or solving them first (for residual evaluations)
+            void assembleWellResidual(const double dt);
+
+            // set the entries of the cells perforated by the local wells to one
+            void markPerforatedCells(std::vector<char>& mask) const;
+
             // substract Binv(D)rw from r;
             void apply( BVector& r) const;
 
@@ -229,6 +270,26 @@ namespace Opm {
 
             const SimulatorReport& lastReport() const;
 
+            // the maximum number of perforations of all wells (on all processes)
+            int maxNumberOfPerforations() const;
+
+            // the number of perforations of the open wells in each cell of this process
+            std::vector<int> numberOfPerforationsPerCell(const int nc) const;
+
+            using PackedWells = PackedWellContributions<Scalar, numEq, StandardWell<TypeTag>::numWellEq>;
+
+            // the packed contributions of the standard wells of the last assembly
+            const PackedWells& packedWellContributions() const
+            {
+                return packed_wells_;
+            }
+
+            // whether the contributions of all wells are contained in packedWellContributions()
+            bool allWellContributionsPacked() const
+            {
+                return standard_wells_v_.empty() && multisegment_wells_.empty();
+            }
+
             void addWellContributions(Mat& mat)
             {
                 for ( const auto& well: well_container_ ) {
@@ -248,33 +309,6 @@ namespace Opm {
 
         protected:
 
-            void extractLegacyPressure_(std::vector<double>& cellPressure) const
-            {
-                size_t nc = number_of_cells_;
-                std::vector<double> cellPressures(nc, 0.0);
-                ElementContext elemCtx(ebosSimulator_);
-                const auto& gridView = ebosSimulator_.vanguard().gridView();
-                const auto& elemEndIt = gridView.template end</*codim=*/0>();
-                for (auto elemIt = gridView.template begin</*codim=*/0>();
-                     elemIt != elemEndIt;
-                     ++elemIt)
-                {
-                    const auto& elem = *elemIt;
-                    if (elem.partitionType() != Dune::InteriorEntity) {
-                        continue;
-                    }
-                    elemCtx.updatePrimaryStencil(elem);
-                    elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
-
-                    const unsigned cellIdx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
-                    const auto& intQuants = elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
-                    const auto& fs = intQuants.fluidState();
-
-                    const double p = fs.pressure(FluidSystem::oilPhaseIdx).value();
-                    cellPressures[cellIdx] = p;
-                }
-            }
-
             Simulator& ebosSimulator_;
             std::unique_ptr<WellsManager> wells_manager_;
             std::vector< const Well* > wells_ecl_;
@@ -285,23 +319,34 @@ namespace Opm {
             std::vector<WellInterfacePtr > well_container_;
 
             // map from logically cartesian cell indices to compressed ones
-            std::vector<int> cartesian_to_compressed_;
+            CartesianCellIndexMap cartesian_to_compressed_;
 
             std::vector<bool> is_cell_perforated_;
+            // the perforated interior elements, whose intensive quantities the wells use
+            typedef typename GridView::template Codim<0>::Entity::EntitySeed ElementSeed;
+            std::vector<ElementSeed> perforated_elements_;
 
-            // create the well container
+            // create the well container, taking over the unchanged wells of the current one
             std::vector<WellInterfacePtr > createWellContainer(const int time_step);
 
             WellInterfacePtr createWellForWellTest(const std::string& well_name, const int report_step) const;
 
             WellState well_state_;
             WellState previous_well_state_;
+            // the converged state before the last time step and the length of that
+            // step, 0 if there is none in the current report step (see PredictWellState)
+            WellState older_well_state_;
+            double older_well_state_dt_ = 0.0;
+            // the well state of the last failed attempt of the current time step and its
+            // length, and whether the current attempt has not succeeded yet (see KeepFailedWellState)
+            WellState failed_well_state_;
+            double attempt_dt_ = 0.0;
+            bool attempt_in_progress_ = false;
 
             const ModelParameters param_;
             bool terminal_output_;
             bool has_solvent_;
             bool has_polymer_;
-            std::vector<int> pvt_region_idx_;
             PhaseUsage phase_usage_;
             size_t global_nc_;
             // the number of the cells in the local grid
@@ -311,6 +356,10 @@ namespace Opm {
             bool initial_step_;
 
             std::unique_ptr<RateConverterType> rateConverter_;
+
+            // the well controls and groupControlInputs() after the group targets were last applied
+            std::vector<int> group_control_controls_;
+            std::vector<double> group_control_inputs_;
             std::unique_ptr<VFPProperties<VFPInjProperties,VFPProdProperties>> vfp_properties_;
 
             SimulatorReport last_report_;
@@ -320,6 +369,36 @@ namespace Opm {
             // used to better efficiency of calcuation
             mutable BVector scaleAddRes_;
 
+            // the contributions of the standard wells gathered once per assembly
+            // to apply them in one sweep.
+            PackedWells packed_wells_;
+
+            // the efficiency factors of the wells of the report step, and whether
+            // they changed since the well container was created
+            std::map<std::string, double> efficiency_factors_;
+            bool efficiency_factors_changed_ = true;
+            // the memory of the well matrices, including their packed copies, and of
+            // the well states, for the memory report
+            MemoryAccount well_matrix_memory_{ MemoryRegistry::instance().entry("wells.matrices") };
+            MemoryAccount well_state_memory_{ MemoryRegistry::instance().entry("wells.state") };
+            // the wells whose contributions are not packed, by type such that
+            // apply(x, Ax) calls them without virtual dispatch
+            std::vector<const StandardWellV<TypeTag>*> standard_wells_v_;
+            std::vector<const MultisegmentWell<TypeTag>*> multisegment_wells_;
+
+            // gather the contributions of the wells for apply(x, Ax)
+            void packWellContributions();
+
+            // Call function(well) for all wells. With threaded_well_assembly_ the
+            // standard wells are handled by concurrent threads, the others
+            // sequentially. The messages of the wells are logged afterwards, in
+            // the order of the wells.
+            template <class Function>
+            void forEachWell(const Function& function);
+
+            // write the messages of the wells to OpmLog
+            void logWellMessages() const;
+
             const Wells* wells() const { return wells_manager_->c_wells(); }
 
             const Grid& grid() const
@@ -350,6 +429,16 @@ namespace Opm {
 
             void updateGroupControls();
 
+            // extrapolate the initial guess of the well state of a time step of length dt
+            void predictWellState(const double dt);
+
+            // move the initial guess of the well state of a time step of length dt towards
+            // the well state of the failed attempt of the step
+            void keepFailedWellState(const double dt);
+
+            // the well rates, BHPs and THPs the application of the group targets depends on
+            std::vector<double> groupControlInputs() const;
+
             // setting the well_solutions_ based on well_state.
             void updatePrimaryVariables();
 
@@ -370,8 +459,13 @@ namespace Opm {
 
             const std::vector<double>& wellPerfEfficiencyFactors() const;
 
+            // calculate the accumulated efficiency factors of the wells through
+            // the group tree, called at the beginning of a report step
             void calculateEfficiencyFactors();
 
+            // the efficiency factor of a well of the current report step
+            double wellEfficiencyFactor(const std::string& well_name) const;
+
             // it should be able to go to prepareTimeStep(), however, the updateWellControls() and initPrimaryVariablesEvaluation()
             // makes it a little more difficult. unless we introduce if (iterationIdx != 0) to avoid doing the above functions
             // twice at the beginning of the time step
@@ -381,6 +475,11 @@ namespace Opm {
 
             SimulatorReport solveWellEq(const double dt);
 
+            // solve the equations of each well on its own against the fixed
+            // reservoir state, only the wells which did not converge yet are
+            // assembled again
+            SimulatorReport solveWellEqLocally(const double dt);
+
             void initPrimaryVariablesEvaluation() const;
 
             // The number of components in the model.
@@ -402,8 +501,6 @@ namespace Opm {
 
             void computeRESV(const std::size_t step);
 
-            void extractLegacyCellPvtRegionIndex_();
-
             void extractLegacyDepth_();
 
             /// return true if wells are available in the reservoir
@@ -419,6 +516,9 @@ namespace Opm {
 
             void updatePerforationIntensiveQuantities();
 
+            // collect the interior elements perforated by the wells of the container
+            void updatePerforatedElements();
+
             void wellTesting(const int timeStepIdx, const double simulationTime);
 
             // convert well data from opm-common to well state from opm-core
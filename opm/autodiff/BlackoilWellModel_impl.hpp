@@ -19,11 +19,6 @@ namespace Opm {
     BlackoilWellModel<TypeTag>::
     init(const Opm::EclipseState& eclState, const Opm::Schedule& schedule)
     {
-        gravity_ = ebosSimulator_.problem().gravity()[2];
-
-        extractLegacyCellPvtRegionIndex_();
-        extractLegacyDepth_();
-
         phase_usage_ = phaseUsageFromDeck(eclState);
 
         const auto& gridView = ebosSimulator_.gridView();
@@ -35,7 +30,8 @@ namespace Opm {
         global_nc_ = gridView.comm().sum(number_of_cells_);
         gravity_ = ebosSimulator_.problem().gravity()[2];
 
-        extractLegacyCellPvtRegionIndex_();
+        // the grid does not change during the run, hence the cell depths are
+        // extracted only once
         extractLegacyDepth_();
         initial_step_ = true;
 
@@ -55,7 +51,7 @@ namespace Opm {
     BlackoilWellModel<TypeTag>::
     addNeighbors(std::vector<NeighborSet>& neighbors) const
     {
-        if (!param_.matrix_add_well_contributions_) {
+        if (!param_.needWellConnectionsInMatrix()) {
             return;
         }
 
@@ -65,6 +61,9 @@ namespace Opm {
         const auto& cartesianSize = Opm::UgGridHelpers::cartDims(grid());
 
         // initialize the additional cell connections introduced by wells.
+        // The connections of the last time step are all the connections that
+        // the wells ever have, hence opening, shutting or adding connections
+        // by WELOPEN or COMPDAT during the run never changes the pattern.
         for (const auto well : schedule_wells)
         {
             std::vector<int> wellCells;
@@ -79,13 +78,18 @@ namespace Opm {
                 int j = connection.getJ();
                 int k = connection.getK();
                 int cart_grid_idx = i + cartesianSize[0]*(j + cartesianSize[1]*k);
-                int compressed_idx = cartesian_to_compressed_.at(cart_grid_idx);
+                int compressed_idx = cartesian_to_compressed_.compressed(cart_grid_idx);
 
                 if ( compressed_idx >= 0 ) { // Ignore connections in inactive/remote cells.
                     wellCells.push_back(compressed_idx);
                 }
             }
 
+            // Sorted inserts into the neighbor sets take constant time per cell.
+            std::sort(wellCells.begin(), wellCells.end());
+            wellCells.erase(std::unique(wellCells.begin(), wellCells.end()),
+                            wellCells.end());
+
             for (int cellIdx : wellCells) {
                 neighbors[cellIdx].insert(wellCells.begin(),
                                           wellCells.end());
@@ -116,6 +120,32 @@ namespace Opm {
     }
 
 
+    template<typename TypeTag>
+    int
+    BlackoilWellModel<TypeTag>::
+    maxNumberOfPerforations() const
+    {
+        int max_perfs = 0;
+        for (const auto& well : well_container_) {
+            max_perfs = std::max(max_perfs, static_cast<int>(well->cells().size()));
+        }
+        return ebosSimulator_.gridView().comm().max(max_perfs);
+    }
+
+    template<typename TypeTag>
+    std::vector<int>
+    BlackoilWellModel<TypeTag>::
+    numberOfPerforationsPerCell(const int nc) const
+    {
+        std::vector<int> perforations(nc, 0);
+        for (const auto& well : well_container_) {
+            for (const int cell : well->cells()) {
+                ++perforations[cell];
+            }
+        }
+        return perforations;
+    }
+
     /// Return true if any well has a THP constraint.
     template<typename TypeTag>
     bool
@@ -197,6 +227,10 @@ namespace Opm {
         wells_active_ = localWellsActive() ? 1 : 0;
         wells_active_ = grid.comm().max(wells_active_);
 
+        // the efficiency factors only change with the group tree of the
+        // schedule, they are set on the wells when the well container is created
+        calculateEfficiencyFactors();
+
         // The well state initialize bhp with the cell pressure in the top cell.
         // We must therefore provide it with updated cell pressures
         size_t nc = number_of_cells_;
@@ -239,10 +273,18 @@ namespace Opm {
 
         // update the previous well state. This is used to restart failed steps.
         previous_well_state_ = well_state_;
+        // the states of the last report step belong to other wells and controls
+        older_well_state_dt_ = 0.0;
+        attempt_in_progress_ = false;
 
         // Compute reservoir volumes for RESV controls.
-        rateConverter_.reset(new RateConverterType (phase_usage_,
-                                                    std::vector<int>(number_of_cells_, 0)));
+        // The converter is kept, as the wells taken over by the next
+        // well container refer to it.
+        if (!rateConverter_) {
+            rateConverter_.reset(new RateConverterType (phase_usage_,
+                                                        std::vector<int>(number_of_cells_, 0),
+                                                        param_.rate_conversion_tolerance_));
+        }
         computeRESV(timeStepIdx);
 
         // update VFP properties
@@ -260,6 +302,11 @@ namespace Opm {
     void
     BlackoilWellModel<TypeTag>::
     beginTimeStep() {
+        // an attempt which did not succeed is restarted
+        const bool restart = attempt_in_progress_ && param_.keep_failed_well_state_;
+        if (restart) {
+            failed_well_state_ = well_state_;
+        }
         well_state_ = previous_well_state_;
 
         const int reportStepIdx = ebosSimulator_.episodeIndex();
@@ -268,24 +315,30 @@ namespace Opm {
         // test wells
         wellTesting(reportStepIdx, simulationTime);
 
-        // create the well container
+        // create the well container, the new wells are initialized
         well_container_ = createWellContainer(reportStepIdx);
+        efficiency_factors_changed_ = false;
+        // the packed contributions refer to the old wells
+        packed_wells_.clear();
+        standard_wells_v_.clear();
+        multisegment_wells_.clear();
 
-        // do the initialization for all the wells
-        // TODO: to see whether we can postpone of the intialization of the well containers to
-        // optimize the usage of the following several member variables
-        for (auto& well : well_container_) {
-            well->init(&phase_usage_, depth_, gravity_, number_of_cells_);
+        if (param_.predict_well_state_ && older_well_state_dt_ > 0.0) {
+            predictWellState(ebosSimulator_.timeStepSize());
         }
 
+        if (restart) {
+            keepFailedWellState(ebosSimulator_.timeStepSize());
+        }
+        attempt_in_progress_ = true;
+        attempt_dt_ = ebosSimulator_.timeStepSize();
+
         // update the updated cell flag
         std::fill(is_cell_perforated_.begin(), is_cell_perforated_.end(), false);
         for (auto& well : well_container_) {
             well->updatePerforatedCell(is_cell_perforated_);
         }
-
-        // calculate the efficiency factors for each well
-        calculateEfficiencyFactors();
+        updatePerforatedElements();
 
         if (has_polymer_)
         {
@@ -304,6 +357,7 @@ namespace Opm {
             well->closeCompletions(wellTestState_);
         }
 
+        logWellMessages();
     }
 
 
@@ -331,9 +385,7 @@ namespace Opm {
 
             // some preparation before the well can be used
             well->init(&phase_usage_, depth_, gravity_, number_of_cells_);
-            const WellNode& well_node = wellCollection().findWellNode(well_name);
-            const double well_efficiency_factor = well_node.getAccumulativeEfficiencyFactor();
-            well->setWellEfficiencyFactor(well_efficiency_factor);
+            well->setWellEfficiencyFactor(wellEfficiencyFactor(well_name));
             well->setVFPProperties(vfp_properties_.get());
 
             const WellTestConfig::Reason testing_reason = testWell.second;
@@ -370,6 +422,7 @@ namespace Opm {
             }
         }
         updateWellTestState(simulationTime, wellTestState_);
+        logWellMessages();
 
         // calculate the well potentials for output
         // TODO: when necessary
@@ -383,7 +436,56 @@ namespace Opm {
             const std::string msg = "A zero well potential is returned for output purposes. ";
             OpmLog::warning("WELL_POTENTIAL_CALCULATION_FAILED", msg);
         }
+        if (param_.predict_well_state_) {
+            older_well_state_ = previous_well_state_;
+            older_well_state_dt_ = dt;
+        }
         previous_well_state_ = well_state_;
+        attempt_in_progress_ = false;
+    }
+
+
+
+
+
+    template<typename TypeTag>
+    void
+    BlackoilWellModel<TypeTag>::
+    predictWellState(const double dt)
+    {
+        // the extrapolation is limited to the length of the last time step
+        const double factor = std::min(dt / older_well_state_dt_, 1.0);
+        // both states belong to the wells struct of the current report step
+        for (const auto& well : well_container_) {
+            well->predictWellState(older_well_state_, factor, well_state_);
+        }
+    }
+
+
+
+
+
+    template<typename TypeTag>
+    void
+    BlackoilWellModel<TypeTag>::
+    keepFailedWellState(const double dt)
+    {
+        // a diverged attempt is no initial guess
+        const auto isFinite = [](const double value) { return std::isfinite(value); };
+        int finite = std::all_of(failed_well_state_.bhp().begin(), failed_well_state_.bhp().end(), isFinite)
+            && std::all_of(failed_well_state_.wellRates().begin(), failed_well_state_.wellRates().end(), isFinite);
+        finite = ebosSimulator_.vanguard().grid().comm().min(finite);
+        if (!finite || attempt_dt_ <= 0.0) {
+            return;
+        }
+
+        // the new step covers this fraction of the failed one, and the well state moves
+        // by the same fraction from the start of the step to the last Newton iterate
+        // of the failed attempt, which is the extrapolation away from it by -fraction
+        const double fraction = std::min(dt / attempt_dt_, 1.0);
+        for (const auto& well : well_container_) {
+            well->predictWellState(failed_well_state_, -fraction, well_state_);
+        }
     }
 
 
@@ -468,6 +570,12 @@ namespace Opm {
     {
         std::vector<WellInterfacePtr> well_container;
 
+        // the wells of the previous container, which are taken over if they did not change
+        std::map<std::string, WellInterfacePtr> previous_wells;
+        for (const auto& well : well_container_) {
+            previous_wells.emplace(well->name(), well);
+        }
+
         const int nw = numWells();
 
         if (nw > 0) {
@@ -534,10 +642,31 @@ namespace Opm {
 
                 // Use the pvtRegionIdx from the top cell
                 const int well_cell_top = wells()->well_cells[wells()->well_connpos[w]];
-                const int pvtreg = pvt_region_idx_[well_cell_top];
+                const int pvtreg = ebosSimulator_.problem().pvtRegionIndex(well_cell_top);
+
+                const bool multisegment = well_ecl->isMultiSegment(time_step) && param_.use_multisegment_well_;
+                const bool polymermw_injector = GET_PROP_VALUE(TypeTag, EnablePolymerMW) && well_ecl->isInjector(time_step);
+
+                // keep the well of the last time step, with its matrices and perforation
+                // data, if neither its model nor its perforations changed
+                const auto previous = previous_wells.find(well_name);
+                if (previous != previous_wells.end()) {
+                    const auto* well = previous->second.get();
+                    const bool same_model = multisegment ? dynamic_cast<const MultisegmentWell<TypeTag>*>(well) != nullptr
+                        : polymermw_injector ? dynamic_cast<const StandardWellV<TypeTag>*>(well) != nullptr
+                        : dynamic_cast<const StandardWell<TypeTag>*>(well) != nullptr;
+                    if (same_model && previous->second->rebind(well_ecl, time_step, wells())) {
+                        // the factor of a kept well is only updated at a new report step
+                        if (efficiency_factors_changed_) {
+                            previous->second->setWellEfficiencyFactor(wellEfficiencyFactor(well_name));
+                        }
+                        well_container.push_back(previous->second);
+                        continue;
+                    }
+                }
 
-                if ( !well_ecl->isMultiSegment(time_step) || !param_.use_multisegment_well_) {
-                    if ( GET_PROP_VALUE(TypeTag, EnablePolymerMW) && well_ecl->isInjector(time_step) ) {
+                if ( !multisegment ) {
+                    if ( polymermw_injector ) {
                         well_container.emplace_back(new StandardWellV<TypeTag>(well_ecl, time_step, wells(),
                                                     param_, *rateConverter_, pvtreg, numComponents() ) );
                     } else {
@@ -548,6 +677,8 @@ namespace Opm {
                     well_container.emplace_back(new MultisegmentWell<TypeTag>(well_ecl, time_step, wells(),
                                                 param_, *rateConverter_, pvtreg, numComponents() ) );
                 }
+                well_container.back()->init(&phase_usage_, depth_, gravity_, number_of_cells_);
+                well_container.back()->setWellEfficiencyFactor(wellEfficiencyFactor(well_name));
             }
         }
         return well_container;
@@ -594,7 +725,7 @@ namespace Opm {
 
         // Use the pvtRegionIdx from the top cell
         const int well_cell_top = wells()->well_cells[wells()->well_connpos[well_index_wells]];
-        const int pvtreg = pvt_region_idx_[well_cell_top];
+        const int pvtreg = ebosSimulator_.problem().pvtRegionIndex(well_cell_top);
 
         if ( !well_ecl->isMultiSegment(report_step) || !param_.use_multisegment_well_) {
              return WellInterfacePtr(new StandardWell<TypeTag>(well_ecl, report_step, wells(),
@@ -649,7 +780,13 @@ namespace Opm {
             // basically, this is a more updated state from the solveWellEq based on fixed
             // reservoir state, will tihs be a better place to inialize the explict information?
         }
+        else if (param_.solve_welleq_each_iteration_ && iterationIdx > 0) {
+            // the control switches and the limits of the wells are resolved here
+            // instead of by further global iterations
+            last_report_ = solveWellEqLocally(dt);
+        }
         assembleWellEq(dt);
+        packWellContributions();
 
         last_report_.converged = true;
     }
@@ -661,11 +798,153 @@ namespace Opm {
     template<typename TypeTag>
     void
     BlackoilWellModel<TypeTag>::
-    assembleWellEq(const double dt)
+    assembleWellResidual(const double dt)
     {
+        if ( ! wellsActive() ) {
+            return;
+        }
+
+        updatePerforationIntensiveQuantities();
+        initPrimaryVariablesEvaluation();
+        assembleWellEq(dt);
+    }
+
+
+
+
+
+    template<typename TypeTag>
+    void
+    BlackoilWellModel<TypeTag>::
+    markPerforatedCells(std::vector<char>& mask) const
+    {
+        for (const auto& well : well_container_) {
+            for (const int cell : well->cells()) {
+                mask[cell] = 1;
+            }
+        }
+    }
+
+
+
+
+    template<typename TypeTag>
+    void
+    BlackoilWellModel<TypeTag>::
+    packWellContributions()
+    {
+        packed_wells_.clear();
+        standard_wells_v_.clear();
+        multisegment_wells_.clear();
+
         for (auto& well : well_container_) {
-            well->assembleWellEq(ebosSimulator_, dt, well_state_);
+            if (auto standard_well = dynamic_cast<const StandardWell<TypeTag>*>(well.get())) {
+                standard_well->addToPackedWells(packed_wells_);
+            } else if (auto standard_well_v = dynamic_cast<const StandardWellV<TypeTag>*>(well.get())) {
+                standard_wells_v_.push_back(standard_well_v);
+            } else {
+                auto multisegment_well = dynamic_cast<const MultisegmentWell<TypeTag>*>(well.get());
+                assert(multisegment_well);
+                multisegment_wells_.push_back(multisegment_well);
+            }
         }
+
+        std::size_t matrixMemory = packed_wells_.memory();
+        for (const auto& well : well_container_) {
+            matrixMemory += well->wellMatrixMemory();
+        }
+        well_matrix_memory_.set(matrixMemory);
+        well_state_memory_.set(well_state_.memoryBytes() + previous_well_state_.memoryBytes()
+                               + older_well_state_.memoryBytes() + failed_well_state_.memoryBytes());
+    }
+
+
+
+
+
+    template<typename TypeTag>
+    template<class Function>
+    void
+    BlackoilWellModel<TypeTag>::
+    forEachWell(const Function& function)
+    {
+        if ( !param_.threaded_well_assembly_ ) {
+            for (auto& well : well_container_) {
+                function(*well);
+            }
+            logWellMessages();
+            return;
+        }
+
+        // A standard well only writes to its own matrices, to its own
+        // entries of the well state and to its own messages, so the wells
+        // can be handled concurrently. Each well is handled by one thread in
+        // the same way as sequentially, hence the results are the same for
+        // any number of threads. The other well models are handled sequentially.
+        std::vector<WellInterface<TypeTag>*> standardWells;
+        for (auto& well : well_container_) {
+            if (dynamic_cast<StandardWell<TypeTag>*>(well.get())) {
+                standardWells.push_back(well.get());
+            } else {
+                function(*well);
+            }
+        }
+
+        // exceptions must not leave the parallel region, the first one is rethrown
+        std::exception_ptr failure;
+        const int numStandardWells = standardWells.size();
+#if HAVE_OPENMP
+#pragma omp parallel for schedule(dynamic, 1)
+#endif // HAVE_OPENMP
+        for (int w = 0; w < numStandardWells; ++w) {
+            try {
+                function(*standardWells[w]);
+            }
+            catch (...) {
+#if HAVE_OPENMP
+#pragma omp critical(wellFailure)
+#endif // HAVE_OPENMP
+                if (!failure) {
+                    failure = std::current_exception();
+                }
+            }
+        }
+
+        logWellMessages();
+        if (failure) {
+            std::rethrow_exception(failure);
+        }
+    }
+
+
+
+
+
+    template<typename TypeTag>
+    void
+    BlackoilWellModel<TypeTag>::
+    logWellMessages() const
+    {
+        for (const auto& well : well_container_) {
+            well->logMessages();
+        }
+    }
+
+
+
+
+
+    template<typename TypeTag>
+    void
+    BlackoilWellModel<TypeTag>::
+    assembleWellEq(const double dt)
+    {
+        static auto& timing = TimingRegistry::instance().entry("wells.assemble");
+        ScopedTiming scopedTiming(timing);
+
+        forEachWell([this, dt](WellInterface<TypeTag>& well) {
+            well.assembleWellEq(ebosSimulator_, dt, well_state_);
+        });
     }
 
     template<typename TypeTag>
@@ -694,7 +973,13 @@ namespace Opm {
             return;
         }
 
-        for (auto& well : well_container_) {
+        packed_wells_.apply(x, Ax);
+
+        // the well classes are final, hence these calls are not dispatched virtually
+        for (const auto* well : standard_wells_v_) {
+            well->apply(x, Ax);
+        }
+        for (const auto* well : multisegment_wells_) {
             well->apply(x, Ax);
         }
     }
@@ -736,9 +1021,12 @@ namespace Opm {
         if (!localWellsActive())
             return;
 
-        for (auto& well : well_container_) {
-            well->recoverWellSolutionAndUpdateWellState(x, well_state_);
-        }
+        static auto& timing = TimingRegistry::instance().entry("wells.recover");
+        ScopedTiming scopedTiming(timing);
+
+        forEachWell([this, &x](WellInterface<TypeTag>& well) {
+            well.recoverWellSolutionAndUpdateWellState(x, well_state_);
+        });
     }
 
 
@@ -842,9 +1130,9 @@ namespace Opm {
             ++it;
             if( localWellsActive() )
             {
-                for (auto& well : well_container_) {
-                    well->solveEqAndUpdateWellState(well_state_);
-                }
+                forEachWell([this](WellInterface<TypeTag>& well) {
+                    well.solveEqAndUpdateWellState(well_state_);
+                });
             }
             // updateWellControls uses communication
             // Therefore the following is executed if there
@@ -885,6 +1173,91 @@ namespace Opm {
 
 
 
+    template<typename TypeTag>
+    SimulatorReport
+    BlackoilWellModel<TypeTag>::
+    solveWellEqLocally(const double dt)
+    {
+        // the wells are coupled by the group targets
+        if (wellCollection().groupControlActive()) {
+            return solveWellEq(dt);
+        }
+
+        WellState well_state0 = well_state_;
+
+        const int numComp = numComponents();
+        std::vector< Scalar > B_avg( numComp, Scalar() );
+        computeAverageFormationFactor(B_avg);
+
+        const int max_iter = param_.max_welleq_iter_;
+
+        // indexed by the position of the well in the Wells struct, the wells write
+        // to their own entries only
+        std::vector<char> well_converged(numWells(), 0);
+
+        int it = 0;
+        bool converged;
+        do {
+            forEachWell([this, dt, &B_avg, &well_converged](WellInterface<TypeTag>& well) {
+                char& well_done = well_converged[well.indexOfWell()];
+                if (well_done) {
+                    return;
+                }
+                well.assembleWellEq(ebosSimulator_, dt, well_state_);
+                well_done = !well.isOperable() || well.getWellConvergence(B_avg).converged();
+                if (!well_done) {
+                    well.solveEqAndUpdateWellState(well_state_);
+                }
+            });
+
+            // the number of iterations has to agree on all processes, since the
+            // switching logger communicates
+            const bool local_converged = std::all_of(well_converged.begin(), well_converged.end(),
+                                                     [](const char c) { return c != 0; });
+            converged = ebosSimulator_.gridView().comm().min(int(local_converged)) == 1;
+            if (converged) {
+                break;
+            }
+
+            ++it;
+            {
+                wellhelpers::WellSwitchingLogger logger;
+                for (const auto& well : well_container_) {
+                    if (!well_converged[well->indexOfWell()]) {
+                        well->updateWellControl(ebosSimulator_, well_state_, logger);
+                        well->initPrimaryVariablesEvaluation();
+                    }
+                }
+            }
+            logWellMessages();
+        } while (it < max_iter);
+
+        if ( terminal_output_ ) {
+            OpmLog::debug("Local well equation solutions " + std::string(converged ? "converged" : "failed in getting converged")
+                          + " with " + std::to_string(it) + " iterations");
+        }
+        if (!converged) {
+            well_state_ = well_state0;
+            updatePrimaryVariables();
+            // also recover the old well controls
+            for (const auto& well : well_container_) {
+                const int index_of_well = well->indexOfWell();
+                WellControls* wc = well->wellControls();
+                well_controls_set_current(wc, well_state_.currentControls()[index_of_well]);
+            }
+            initPrimaryVariablesEvaluation();
+        }
+
+        SimulatorReport report;
+        report.converged = converged;
+        report.total_well_iterations = it;
+        return report;
+    }
+
+
+
+
+
     template<typename TypeTag>
     ConvergenceReport
     BlackoilWellModel<TypeTag>::
@@ -943,9 +1316,11 @@ namespace Opm {
 
         wellhelpers::WellSwitchingLogger logger;
 
+        // the switching logger is shared by the wells, hence they are handled sequentially
         for (const auto& well : well_container_) {
             well->updateWellControl(ebosSimulator_, well_state_, logger);
         }
+        logWellMessages();
 
         updateGroupControls();
     }
@@ -977,26 +1352,27 @@ namespace Opm {
         well_potentials.resize(nw * np, 0.0);
 
         const Opm::SummaryConfig& summaryConfig = ebosSimulator_.vanguard().summaryConfig();
-        for (const auto& well : well_container_) {
+        const bool requireWellPotentials = wellCollection().requireWellPotentials();
+        forEachWell([&](WellInterface<TypeTag>& well) {
             // Only compute the well potential when asked for
-            bool needed_for_output = ((summaryConfig.hasSummaryKey( "WWPI:" + well->name()) ||
-                                       summaryConfig.hasSummaryKey( "WOPI:" + well->name()) ||
-                                       summaryConfig.hasSummaryKey( "WGPI:" + well->name())) && well->wellType() == INJECTOR) ||
-                                    ((summaryConfig.hasSummaryKey( "WWPP:" + well->name()) ||
-                                                       summaryConfig.hasSummaryKey( "WOPP:" + well->name()) ||
-                                                       summaryConfig.hasSummaryKey( "WGPP:" + well->name())) && well->wellType() == PRODUCER);
-
-            if (needed_for_output || wellCollection().requireWellPotentials())
+            bool needed_for_output = ((summaryConfig.hasSummaryKey( "WWPI:" + well.name()) ||
+                                       summaryConfig.hasSummaryKey( "WOPI:" + well.name()) ||
+                                       summaryConfig.hasSummaryKey( "WGPI:" + well.name())) && well.wellType() == INJECTOR) ||
+                                    ((summaryConfig.hasSummaryKey( "WWPP:" + well.name()) ||
+                                                       summaryConfig.hasSummaryKey( "WOPP:" + well.name()) ||
+                                                       summaryConfig.hasSummaryKey( "WGPP:" + well.name())) && well.wellType() == PRODUCER);
+
+            if (needed_for_output || requireWellPotentials)
             {
                 std::vector<double> potentials;
-                well->computeWellPotentials(ebosSimulator_, well_state_, potentials);
+                well.computeWellPotentialsIfChanged(ebosSimulator_, well_state_, potentials);
 
                 // putting the sucessfully calculated potentials to the well_potentials
                 for (int p = 0; p < np; ++p) {
-                    well_potentials[well->indexOfWell() * np + p] = std::abs(potentials[p]);
+                    well_potentials[well.indexOfWell() * np + p] = std::abs(potentials[p]);
                 }
             }
-        } // end of for (int w = 0; w < nw; ++w)
+        });
 
         // Store it in the well state
         well_state_.wellPotentials() = well_potentials;
@@ -1017,6 +1393,10 @@ namespace Opm {
             rateConverter_->template defineState<ElementContext>(ebosSimulator_);
         }
 
+        // the guide rates and group controls are set up again below
+        group_control_controls_.clear();
+        group_control_inputs_.clear();
+
         // after restarting, the well_controls can be modified while
         // the well_state still uses the old control index
         // we need to synchronize these two.
@@ -1154,18 +1534,35 @@ namespace Opm {
     BlackoilWellModel<TypeTag>::
     calculateEfficiencyFactors()
     {
+        efficiency_factors_.clear();
+        efficiency_factors_changed_ = true;
         if ( !localWellsActive() ) {
             return;
         }
 
-        for (auto& well : well_container_) {
-            const std::string& well_name = well->name();
+        const int nw = numWells();
+        for (int w = 0; w < nw; ++w) {
+            const std::string well_name = std::string(wells()->name[w]);
             const WellNode& well_node = wellCollection().findWellNode(well_name);
 
-            const double well_efficiency_factor = well_node.getAccumulativeEfficiencyFactor();
+            efficiency_factors_[well_name] = well_node.getAccumulativeEfficiencyFactor();
+        }
+    }
+
+
+
+
 
-            well->setWellEfficiencyFactor(well_efficiency_factor);
+    template<typename TypeTag>
+    double
+    BlackoilWellModel<TypeTag>::
+    wellEfficiencyFactor(const std::string& well_name) const
+    {
+        const auto factor = efficiency_factors_.find(well_name);
+        if (factor == efficiency_factors_.end()) {
+            OPM_THROW(std::logic_error, "No efficiency factor was calculated for well " << well_name);
         }
+        return factor->second;
     }
 
 
@@ -1196,13 +1593,23 @@ namespace Opm {
         voidage_conversion_coeffs.resize(nw * np, 1.0);
 
         std::vector<double> well_rates(np, 0.0);
-        std::vector<double> convert_coeff(np, 1.0);
 
-         for (auto& well : well_container_) {
+        // the conversion coefficients of all the wells at once,
+        // the average hydrocarbon conditions of the whole field will be used
+        std::vector<int> fipregs(well_container_.size(), 0); // Not considering FIP for the moment.
+        std::vector<int> pvtregs;
+        pvtregs.reserve(well_container_.size());
+        for (const auto& well : well_container_) {
+            pvtregs.push_back(ebosSimulator_.problem().pvtRegionIndex(well->cells()[0]));
+        }
+        std::vector<double> convert_coeffs;
+        rateConverter_->calcCoeffs(fipregs, pvtregs, convert_coeffs);
+
+        for (std::size_t i = 0; i < well_container_.size(); ++i) {
+            const auto& well = well_container_[i];
             const bool is_producer = well->wellType() == PRODUCER;
-            const int well_cell_top =well->cells()[0];
             const int w = well->indexOfWell();
-            const int pvtRegionIdx = pvt_region_idx_[well_cell_top];
+            const auto convert_coeff = convert_coeffs.begin() + np * i;
 
             // not sure necessary to change all the value to be positive
             if (is_producer) {
@@ -1210,22 +1617,15 @@ namespace Opm {
                                well_state_.wellRates().begin() + np * (w + 1),
                                well_rates.begin(), std::negate<double>());
 
-                // the average hydrocarbon conditions of the whole field will be used
-                const int fipreg = 0; // Not considering FIP for the moment.
-
-                rateConverter_->calcCoeff(fipreg, pvtRegionIdx, convert_coeff);
                 well_voidage_rates[w] = std::inner_product(well_rates.begin(), well_rates.end(),
-                                                           convert_coeff.begin(), 0.0);
+                                                           convert_coeff, 0.0);
             } else {
                 // TODO: Not sure whether will encounter situation with all zero rates
                 // and whether it will cause problem here.
                 std::copy(well_state_.wellRates().begin() + np * w,
                           well_state_.wellRates().begin() + np * (w + 1),
                           well_rates.begin());
-                // the average hydrocarbon conditions of the whole field will be used
-                const int fipreg = 0; // Not considering FIP for the moment.
-                rateConverter_->calcCoeff(fipreg, pvtRegionIdx, convert_coeff);
-                std::copy(convert_coeff.begin(), convert_coeff.end(),
+                std::copy(convert_coeff, convert_coeff + np,
                           voidage_conversion_coeffs.begin() + np * w);
             }
         }
@@ -1270,6 +1670,15 @@ namespace Opm {
     {
 
         if (wellCollection().groupControlActive()) {
+            // The targets only depend on the rates and controls of the wells. If these
+            // did not change since the targets were last applied, applying them again
+            // does not change the well state.
+            if (well_state_.currentControls() == group_control_controls_ &&
+                wellhelpers::withinRelativeTolerance(groupControlInputs(), group_control_inputs_,
+                                                     param_.group_control_tolerance_)) {
+                return;
+            }
+
            for (auto& well : well_container_) {
                 // update whether well is under group control
                 // get well node in the well collection
@@ -1296,6 +1705,9 @@ namespace Opm {
                 well->updateWellStateWithTarget(ebosSimulator_, well_state_);
                 well->updatePrimaryVariables(well_state_);
             }
+
+            group_control_controls_ = well_state_.currentControls();
+            group_control_inputs_ = groupControlInputs();
         }
     }
 
@@ -1303,23 +1715,27 @@ namespace Opm {
 
 
 
+    template<typename TypeTag>
+    std::vector<double>
+    BlackoilWellModel<TypeTag>::
+    groupControlInputs() const
+    {
+        std::vector<double> inputs(well_state_.wellRates());
+        inputs.insert(inputs.end(), well_state_.bhp().begin(), well_state_.bhp().end());
+        inputs.insert(inputs.end(), well_state_.thp().begin(), well_state_.thp().end());
+        return inputs;
+    }
+
+
+
+
+
     template<typename TypeTag>
     void
     BlackoilWellModel<TypeTag>::
     setupCartesianToCompressed_(const int* global_cell, int number_of_cartesian_cells)
     {
-        cartesian_to_compressed_.resize(number_of_cartesian_cells, -1);
-        if (global_cell) {
-            for (unsigned i = 0; i < number_of_cells_; ++i) {
-                cartesian_to_compressed_[global_cell[i]] = i;
-            }
-        }
-        else {
-            for (unsigned i = 0; i < number_of_cells_; ++i) {
-                cartesian_to_compressed_[i] = i;
-            }
-        }
-
+        cartesian_to_compressed_ = CartesianCellIndexMap(number_of_cartesian_cells, number_of_cells_, global_cell);
     }
 
     template<typename TypeTag>
@@ -1394,21 +1810,6 @@ namespace Opm {
         }
     }
 
-    template<typename TypeTag>
-    void
-    BlackoilWellModel<TypeTag>::extractLegacyCellPvtRegionIndex_()
-    {
-        const auto& grid = ebosSimulator_.vanguard().grid();
-        const auto& eclProblem = ebosSimulator_.problem();
-        const unsigned numCells = grid.size(/*codim=*/0);
-
-        pvt_region_idx_.resize(numCells);
-        for (unsigned cellIdx = 0; cellIdx < numCells; ++cellIdx) {
-            pvt_region_idx_[cellIdx] =
-                eclProblem.pvtRegionIndex(cellIdx);
-        }
-    }
-
     // The number of components in the model.
     template<typename TypeTag>
     int
@@ -1457,6 +1858,24 @@ namespace Opm {
     void
     BlackoilWellModel<TypeTag>::
     updatePerforationIntensiveQuantities() {
+        // only the perforated elements are visited, instead of the whole grid
+        ElementContext elemCtx(ebosSimulator_);
+        const auto& grid = ebosSimulator_.vanguard().grid();
+        for (const auto& seed : perforated_elements_) {
+            elemCtx.updatePrimaryStencil(grid.entity(seed));
+            elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
+        }
+    }
+
+
+
+
+
+    template<typename TypeTag>
+    void
+    BlackoilWellModel<TypeTag>::
+    updatePerforatedElements() {
+        perforated_elements_.clear();
         ElementContext elemCtx(ebosSimulator_);
         const auto& gridView = ebosSimulator_.gridView();
         const auto& elemEndIt = gridView.template end</*codim=*/0, Dune::Interior_Partition>();
@@ -1464,14 +1883,11 @@ namespace Opm {
              elemIt != elemEndIt;
              ++elemIt)
         {
-
             elemCtx.updatePrimaryStencil(*elemIt);
-            int elemIdx = elemCtx.globalSpaceIndex(0, 0);
-
-            if (!is_cell_perforated_[elemIdx]) {
-                continue;
+            const int elemIdx = elemCtx.globalSpaceIndex(0, 0);
+            if (is_cell_perforated_[elemIdx]) {
+                perforated_elements_.push_back(elemIt->seed());
             }
-            elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
         }
     }
 
@@ -1508,7 +1924,7 @@ namespace Opm {
                 WellControls* ctrl = wells()->ctrls[*rp];
                 const bool is_producer = wells()->type[*rp] == PRODUCER;
                 const int well_cell_top = wells()->well_cells[wells()->well_connpos[*rp]];
-                const int pvtreg = pvt_region_idx_[well_cell_top];
+                const int pvtreg = ebosSimulator_.problem().pvtRegionIndex(well_cell_top);
 
                 // RESV control mode, all wells
                 {
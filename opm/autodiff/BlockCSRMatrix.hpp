@@ -0,0 +1,227 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_BLOCKCSRMATRIX_HEADER_INCLUDED
+#define OPM_BLOCKCSRMATRIX_HEADER_INCLUDED
+
+#include <opm/common/ErrorMacros.hpp>
+#include <opm/common/Exceptions.hpp>
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace Opm
+{
+
+/// \brief A block compressed sparse row matrix with compact indices.
+///
+/// In contrast to Dune::BCRSMatrix the column indices are stored with
+/// the (usually 32 bit) Index type, and all blocks are stored in one
+/// contiguous array without row pointers. For the 3x3 and 4x4 blocks
+/// of the Jacobian this halves the memory traffic for the indices of a
+/// mat-vec product. The matrix is a copy of a BCRSMatrix used for the
+/// products only; the values can be updated as long as the sparsity
+/// pattern stays the same.
+/// \tparam Block The type of the matrix blocks (e.g. Dune::FieldMatrix).
+/// \tparam Index The type of the row offsets and column indices.
+template<class Block, class Index = std::uint32_t>
+class BlockCSRMatrix
+{
+public:
+    typedef Block block_type;
+    typedef Index index_type;
+    typedef typename Block::field_type field_type;
+    typedef std::size_t size_type;
+
+    BlockCSRMatrix()
+        : cols_(0)
+    {}
+
+    /// \brief Constructor copying the sparsity pattern and the entries of a matrix.
+    /// \param matrix A matrix with the BCRSMatrix interface and the same block type.
+    template<class Matrix>
+    explicit BlockCSRMatrix(const Matrix& matrix)
+    {
+        setup(matrix);
+    }
+
+    /// \brief Copy the sparsity pattern and the entries of a matrix.
+    template<class Matrix>
+    void setup(const Matrix& matrix)
+    {
+        if ( matrix.nonzeroes() > static_cast<std::size_t>(std::numeric_limits<Index>::max())
+             || matrix.M() > static_cast<std::size_t>(std::numeric_limits<Index>::max()) )
+        {
+            OPM_THROW(std::logic_error, "The matrix is too large for the index type of BlockCSRMatrix");
+        }
+        cols_ = matrix.M();
+        rowStart_.clear();
+        rowStart_.reserve(matrix.N() + 1);
+        colIndex_.clear();
+        colIndex_.reserve(matrix.nonzeroes());
+        values_.clear();
+        values_.reserve(matrix.nonzeroes());
+
+        rowStart_.push_back(0);
+        for ( auto row = matrix.begin(), rowEnd = matrix.end(); row != rowEnd; ++row )
+        {
+            for ( auto col = row->begin(), colEnd = row->end(); col != colEnd; ++col )
+            {
+                colIndex_.push_back(col.index());
+                values_.push_back(*col);
+            }
+            rowStart_.push_back(colIndex_.size());
+        }
+    }
+
+    /// \brief Copy the entries of a matrix with the same sparsity pattern.
+    ///
+    /// Falls back to setup() if the number of rows or nonzeroes differs.
+    template<class Matrix>
+    void updateValues(const Matrix& matrix)
+    {
+        if ( matrix.N() != N() || matrix.nonzeroes() != nonzeroes() )
+        {
+            setup(matrix);
+            return;
+        }
+        auto value = values_.begin();
+        for ( auto row = matrix.begin(), rowEnd = matrix.end(); row != rowEnd; ++row )
+        {
+            for ( auto col = row->begin(), colEnd = row->end(); col != colEnd; ++col, ++value )
+            {
+                assert( colIndex_[value - values_.begin()] == col.index() );
+                *value = *col;
+            }
+        }
+    }
+
+    /// \brief The number of block rows.
+    size_type N() const
+    {
+        return rowStart_.empty() ? 0 : rowStart_.size() - 1;
+    }
+
+    /// \brief The number of block columns.
+    size_type M() const
+    {
+        return cols_;
+    }
+
+    /// \brief The number of nonzero blocks.
+    size_type nonzeroes() const
+    {
+        return values_.size();
+    }
+
+    /// \brief y = A x
+    template<class X, class Y>
+    void mv(const X& x, Y& y) const
+    {
+        const std::ptrdiff_t rows = N();
+#if HAVE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif // HAVE_OPENMP
+        for ( std::ptrdiff_t i = 0; i < rows; ++i )
+        {
+            y[i] = 0.0;
+            umvRow(i, x, y[i]);
+        }
+    }
+
+    /// \brief y += A x
+    template<class X, class Y>
+    void umv(const X& x, Y& y) const
+    {
+        const std::ptrdiff_t rows = N();
+#if HAVE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif // HAVE_OPENMP
+        for ( std::ptrdiff_t i = 0; i < rows; ++i )
+        {
+            umvRow(i, x, y[i]);
+        }
+    }
+
+    /// \brief y += alpha A x
+    template<class X, class Y>
+    void usmv(field_type alpha, const X& x, Y& y) const
+    {
+        const std::ptrdiff_t rows = N();
+#if HAVE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif // HAVE_OPENMP
+        for ( std::ptrdiff_t i = 0; i < rows; ++i )
+        {
+            usmvRow(i, alpha, x, y[i]);
+        }
+    }
+
+    /// \brief yi += (A x)_i for block row i.
+    template<class X, class YBlock>
+    void umvRow(size_type i, const X& x, YBlock& yi) const
+    {
+        for ( Index k = rowStart_[i], end = rowStart_[i + 1]; k < end; ++k )
+        {
+            values_[k].umv(x[colIndex_[k]], yi);
+        }
+    }
+
+    /// \brief yi += alpha (A x)_i for block row i.
+    template<class X, class YBlock>
+    void usmvRow(size_type i, field_type alpha, const X& x, YBlock& yi) const
+    {
+        for ( Index k = rowStart_[i], end = rowStart_[i + 1]; k < end; ++k )
+        {
+            values_[k].usmv(alpha, x[colIndex_[k]], yi);
+        }
+    }
+
+    /// \brief The offsets of the rows in colIndices() and values() (N()+1 entries).
+    const std::vector<Index>& rowStarts() const
+    {
+        return rowStart_;
+    }
+
+    /// \brief The column index of each nonzero block.
+    const std::vector<Index>& colIndices() const
+    {
+        return colIndex_;
+    }
+
+    /// \brief The nonzero blocks, row by row.
+    const std::vector<Block>& values() const
+    {
+        return values_;
+    }
+
+private:
+    size_type cols_;
+    std::vector<Index> rowStart_;
+    std::vector<Index> colIndex_;
+    std::vector<Block> values_;
+};
+
+} // end namespace Opm
+
+#endif // OPM_BLOCKCSRMATRIX_HEADER_INCLUDED
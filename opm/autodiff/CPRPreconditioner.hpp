@@ -25,12 +25,16 @@
 #define OPM_CPRPRECONDITIONER_HEADER_INCLUDED
 
 #include <memory>
+#include <string>
 #include <type_traits>
 
 #include <opm/common/utility/platform_dependent/disable_warnings.h>
 #include <opm/common/utility/parameters/ParameterGroup.hpp>
+#include <opm/autodiff/AmgSmoothers.hpp>
 #include <opm/autodiff/ParallelOverlappingILU0.hpp>
+#include <opm/autodiff/TimingRegistry.hpp>
 #include <opm/autodiff/FlowLinearSolverParameters.hpp>
+#include <opm/autodiff/PressureSolverBackend.hpp>
 
 #include <dune/istl/bvector.hh>
 #include <dune/istl/bcrsmatrix.hh>
@@ -77,6 +81,24 @@ void setILUParameters(Opm::ParallelOverlappingILU0Args<T>& args,
     args.setMilu(milu);
 }
 
+template<class T>
+void setILUParameters(Opm::AmgLevelSmootherArgs<T>& args,
+                      const CPRParameter& params)
+{
+    args.setN(params.cpr_ilu_n_);
+    args.setMilu(params.cpr_ilu_milu_);
+    args.setSmoother(convertString2AmgSmoother(params.cpr_smoother_));
+    args.setChebyshevDegree(params.cpr_chebyshev_degree_);
+}
+
+template<class T>
+void setILUParameters(Opm::AmgLevelSmootherArgs<T>& args,
+                      MILU_VARIANT milu, int n=0)
+{
+    args.setN(n);
+    args.setMilu(milu);
+}
+
 template<class S, class P>
 void setILUParameters(S&, const P&)
 {}
@@ -106,7 +128,8 @@ struct CPRSelector
     typedef std::unique_ptr<EllipticPreconditioner>
     EllipticPreconditionerPointer;
 
-    typedef EllipticPreconditioner Smoother;
+    /// \brief The smoother used on the levels of AMG (see CPRParameter::cpr_smoother_).
+    typedef AmgLevelSmoother<M,X,X,ParallelInformation> Smoother;
     typedef Dune::Amg::AMG<Operator, X, Smoother, ParallelInformation> AMG;
 
     /// \brief creates an Operator from the matrix
@@ -131,8 +154,9 @@ struct CPRSelector<M,X,Y,Dune::Amg::SequentialInformation>
     /// \brief The type of the unique pointer to the preconditioner of the elliptic part.
     typedef std::unique_ptr<EllipticPreconditioner> EllipticPreconditionerPointer;
 
+    /// \brief The smoother used on the levels of AMG (see CPRParameter::cpr_smoother_).
+    typedef AmgLevelSmoother<M,X,X,ParallelInformation> Smoother;
     /// \brief type of AMG used to precondition the elliptic system.
-    typedef EllipticPreconditioner Smoother;
     typedef Dune::Amg::AMG<Operator, X, Smoother, ParallelInformation> AMG;
 
     /// \brief creates an Operator from the matrix
@@ -183,21 +207,45 @@ createEllipticPreconditionerPointer(const M& Ae, double relax,
     return EllipticPreconditionerPointer(new ParallelPreconditioner(Ae, comm, relax, milu));
 }
 
+/// \brief Set the coarsening of AMG to the one configured for CPR.
+///
+/// The defaults of CPRParameter are the values used before they were configurable.
+template <class Criterion>
+void setCoarseningParameters(Criterion& criterion, const CPRParameter& params)
+{
+    criterion.setMaxLevel( params.cpr_amg_max_level_ );
+    criterion.setCoarsenTarget( params.cpr_amg_coarsen_target_ );
+    criterion.setDebugLevel( 0 ); // no debug information, 1 for printing hierarchy information
+    if ( params.cpr_amg_aggregation_ == "isotropic" )
+    {
+        criterion.setDefaultValuesIsotropic( params.cpr_amg_aggregation_dimension_ );
+    }
+    else if ( params.cpr_amg_aggregation_ == "anisotropic" )
+    {
+        criterion.setDefaultValuesAnisotropic( params.cpr_amg_aggregation_dimension_ );
+    }
+    else
+    {
+        OPM_THROW(std::invalid_argument, "Unknown AMG aggregation '" << params.cpr_amg_aggregation_
+                  << "'. Available are: isotropic anisotropic");
+    }
+    criterion.setAlpha( params.cpr_amg_alpha_ );
+    criterion.setBeta( params.cpr_amg_beta_ );
+    criterion.setNoPostSmoothSteps( params.cpr_amg_smooth_steps_ );
+    criterion.setNoPreSmoothSteps( params.cpr_amg_smooth_steps_ );
+}
+
 template < class C, class Op, class P, class S, std::size_t index >
 inline void
 createAMGPreconditionerPointer(Op& opA, const double relax, const P& comm,
                                std::unique_ptr< BlackoilAmg<Op,S,C,P,index> >& amgPtr,
-                               const CPRParameter& params)
+                               const CPRParameter& params,
+                               const typename Op::range_type* weights = nullptr)
 {
     using AMG = BlackoilAmg<Op,S,C,P,index>;
-    // TODO: revise choice of parameters
-    int coarsenTarget=1200;
     using Criterion = C;
-    Criterion criterion(15, coarsenTarget);
-    criterion.setDebugLevel( 0 ); // no debug information, 1 for printing hierarchy information
-    criterion.setDefaultValuesIsotropic(2);
-    criterion.setNoPostSmoothSteps( 1 );
-    criterion.setNoPreSmoothSteps( 1 );
+    Criterion criterion(params.cpr_amg_max_level_, params.cpr_amg_coarsen_target_);
+    setCoarseningParameters(criterion, params);
 
     // Since DUNE 2.2 we also need to pass the smoother args instead of steps directly
     typedef typename AMG::Smoother Smoother;
@@ -207,7 +255,7 @@ createAMGPreconditionerPointer(Op& opA, const double relax, const P& comm,
     smootherArgs.relaxationFactor = relax;
     setILUParameters(smootherArgs, params);
 
-    amgPtr.reset( new AMG( params, opA, criterion, smootherArgs, comm ) );
+    amgPtr.reset( new AMG( params, opA, criterion, smootherArgs, comm, weights ) );
 }
 
 template < class C, class Op, class P, class AMG >
@@ -352,8 +400,14 @@ createAMGPreconditionerPointer( Op& opA, const double relax, const MILU_VARIANT
               comm_(comm),
               commAe_(commAe)
         {
-            // create appropriate preconditioner for elliptic system
-            createEllipticPreconditioner( param_.cpr_use_amg_, commAe_ );
+            // create appropriate preconditioner or solver for elliptic system
+            if( !param_.cpr_pressure_solver_.empty() ) {
+                pressureSolver_ = PressureSolverRegistry<Operator, X, P>
+                    ::create( param_.cpr_pressure_solver_, *opAe_, commAe_, param_ );
+            }
+            else {
+                createEllipticPreconditioner( param_.cpr_use_amg_, commAe_ );
+            }
 
             // create the preconditioner for the whole system.
             if( param_.cpr_ilu_n_ == 0 ) {
@@ -380,6 +434,9 @@ createAMGPreconditionerPointer( Op& opA, const double relax, const MILU_VARIANT
         */
         virtual void apply (X& v, const Y& d)
         {
+            static auto& timing = TimingRegistry::instance().entry("cpr.apply");
+            ScopedTiming scopedTiming(timing);
+
             // Extract part of d corresponding to elliptic part.
             // Note: Assumes that the elliptic part comes first.
             std::copy_n(d.begin(), de_.size(), de_.begin());
@@ -426,6 +483,9 @@ createAMGPreconditionerPointer( Op& opA, const double relax, const MILU_VARIANT
      protected:
         void solveElliptic(Y& x, Y& de)
         {
+            static auto& timing = TimingRegistry::instance().entry("cpr.coarse_solve");
+            ScopedTiming scopedTiming(timing);
+
             // Linear solver parameters
             const double tolerance = param_.cpr_solver_tol_;
             const int maxit        = param_.cpr_max_ell_iter_;
@@ -435,6 +495,15 @@ createAMGPreconditionerPointer( Op& opA, const double relax, const MILU_VARIANT
             // operator result containing iterations etc.
             Dune::InverseOperatorResult result;
 
+            if( pressureSolver_ )
+            {
+                pressureSolver_->apply(x, de, result);
+                if (!result.converged) {
+                    OPM_THROW(LinearSolverProblem, "CPRPreconditioner failed to solve elliptic subsystem.");
+                }
+                return;
+            }
+
             // the scalar product chooser
 #if DUNE_VERSION_NEWER(DUNE_ISTL, 2, 6)
             auto sp = Dune::createScalarProduct<X,ParallelInformation>(commAe_, category());
@@ -496,6 +565,8 @@ createAMGPreconditionerPointer( Op& opA, const double relax, const MILU_VARIANT
         EllipticPreconditionerPointer precond_;
         //! \brief AMG preconditioner with ILU0 smoother
         std::unique_ptr< AMG > amg_;
+        //! \brief The solver for the elliptic system if cpr_pressure_solver_ is set
+        std::unique_ptr< PressureSolverBackend<X> > pressureSolver_;
 
         //! \brief The preconditioner for the whole system
         //!
@@ -0,0 +1,166 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_CARTESIANCELLINDEXMAP_HEADER_INCLUDED
+#define OPM_CARTESIANCELLINDEXMAP_HEADER_INCLUDED
+
+#include <opm/common/ErrorMacros.hpp>
+
+#include <algorithm>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+namespace Opm
+{
+
+/// \brief The compressed index of the cells of a logically Cartesian grid.
+///
+/// The active cells are marked in a bitmap with one bit per Cartesian cell,
+/// and the number of active cells before each block of 512 bits is stored.
+/// The rank of an active cell among the active cells, i.e. its compressed
+/// index if the compressed cells are ordered like the Cartesian ones, is
+/// the count of its block plus the bits set before it in the block. If the
+/// compressed cells are in another order, e.g. on a process of a distributed
+/// grid, a permutation from the rank to the compressed index is kept as well.
+/// For a grid of 100 million Cartesian cells this needs about 13 MB plus four
+/// bytes per active cell for an unordered grid, instead of four bytes per
+/// Cartesian cell of a dense array or a hash map of the active cells.
+class CartesianCellIndexMap
+{
+public:
+    CartesianCellIndexMap() = default;
+
+    /// \param numCartesianCells The number of cells of the Cartesian grid.
+    /// \param numCells The number of active cells.
+    /// \param globalCell The Cartesian index of each active cell, or nullptr
+    ///                   if all Cartesian cells are active.
+    CartesianCellIndexMap(const int numCartesianCells, const int numCells, const int* globalCell)
+        : numCartesianCells_(numCartesianCells)
+        , words_((numCartesianCells + bitsPerWord - 1) / bitsPerWord, 0)
+        , blockCounts_((numCartesianCells + bitsPerBlock - 1) / bitsPerBlock + 1, 0)
+    {
+        bool ordered = true;
+        for ( int cell = 0; cell < numCells; ++cell )
+        {
+            const int cartesian = globalCell ? globalCell[cell] : cell;
+            if ( cartesian < 0 || cartesian >= numCartesianCells )
+            {
+                OPM_THROW(std::logic_error, "Cartesian index " << cartesian << " of cell " << cell
+                          << " is outside of a grid of " << numCartesianCells << " cells");
+            }
+            words_[cartesian / bitsPerWord] |= std::uint64_t(1) << (cartesian % bitsPerWord);
+            ordered = ordered && (!globalCell || cell == 0 || cartesian > globalCell[cell - 1]);
+        }
+
+        for ( std::size_t block = 0; block + 1 < blockCounts_.size(); ++block )
+        {
+            std::uint32_t count = blockCounts_[block];
+            for ( std::size_t w = block * wordsPerBlock; w < std::min((block + 1) * wordsPerBlock, words_.size()); ++w )
+            {
+                count += popcount_(words_[w]);
+            }
+            blockCounts_[block + 1] = count;
+        }
+
+        if ( !ordered )
+        {
+            rankToCompressed_.resize(numCells);
+            for ( int cell = 0; cell < numCells; ++cell )
+            {
+                rankToCompressed_[rank_(globalCell[cell])] = cell;
+            }
+        }
+    }
+
+    /// \brief The number of cells of the Cartesian grid.
+    int numCartesianCells() const
+    {
+        return numCartesianCells_;
+    }
+
+    /// \brief Whether a Cartesian cell is active.
+    bool active(const int cartesian) const
+    {
+        return cartesian >= 0 && cartesian < numCartesianCells_
+            && ((words_[cartesian / bitsPerWord] >> (cartesian % bitsPerWord)) & 1);
+    }
+
+    /// \brief The compressed index of a Cartesian cell, -1 if it is not active.
+    int compressed(const int cartesian) const
+    {
+        if ( !active(cartesian) )
+        {
+            return -1;
+        }
+        const int rank = rank_(cartesian);
+        return rankToCompressed_.empty() ? rank : rankToCompressed_[rank];
+    }
+
+    /// \brief The compressed index of a Cartesian cell, -1 if it is not active.
+    int operator[](const int cartesian) const
+    {
+        return compressed(cartesian);
+    }
+
+    /// \brief The compressed index of a Cartesian cell, which has to be active.
+    int at(const int cartesian) const
+    {
+        const int cell = compressed(cartesian);
+        if ( cell < 0 )
+        {
+            OPM_THROW(std::out_of_range, "Cartesian cell " << cartesian << " is not active");
+        }
+        return cell;
+    }
+
+private:
+    static const int bitsPerWord = 64;
+    static const std::size_t wordsPerBlock = 8;
+    static const int bitsPerBlock = bitsPerWord * wordsPerBlock;
+
+    static int popcount_(const std::uint64_t word)
+    {
+        return std::bitset<bitsPerWord>(word).count();
+    }
+
+    // the number of active cells before an active Cartesian cell
+    int rank_(const int cartesian) const
+    {
+        const std::size_t word = cartesian / bitsPerWord;
+        int rank = blockCounts_[cartesian / bitsPerBlock];
+        for ( std::size_t w = (cartesian / bitsPerBlock) * wordsPerBlock; w < word; ++w )
+        {
+            rank += popcount_(words_[w]);
+        }
+        const std::uint64_t below = (std::uint64_t(1) << (cartesian % bitsPerWord)) - 1;
+        return rank + popcount_(words_[word] & below);
+    }
+
+    int numCartesianCells_ = 0;
+    std::vector<std::uint64_t> words_;
+    std::vector<std::uint32_t> blockCounts_;
+    std::vector<int> rankToCompressed_;
+};
+
+} // namespace Opm
+
+#endif // OPM_CARTESIANCELLINDEXMAP_HEADER_INCLUDED
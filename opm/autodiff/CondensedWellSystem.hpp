@@ -0,0 +1,194 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_CONDENSEDWELLSYSTEM_HEADER_INCLUDED
+#define OPM_CONDENSEDWELLSYSTEM_HEADER_INCLUDED
+
+#include <dune/common/dynmatrix.hh>
+
+#include <vector>
+
+namespace Opm {
+
+namespace wellhelpers
+{
+    /// \brief Invert a well matrix with per perforation variables by static condensation.
+    ///
+    /// The first numCoreEq variables are those of the well as a whole (rates,
+    /// fractions, bhp), followed by numPerfEq groups of numPerforations
+    /// variables each, i.e. variable j of perforation p has the index
+    /// numCoreEq + j * numPerforations + p. The equations of a perforation may
+    /// depend on the core variables and on the variables of the same
+    /// perforation only, such that the perforation block of the matrix is
+    /// block diagonal. The perforation variables are then eliminated block by
+    /// block and only the Schur complement of the core variables is inverted,
+    /// which costs O(n^2 numCoreEq) instead of O(n^3) for n variables.
+    ///
+    /// \param D The matrix, replaced by its inverse on success.
+    /// \return False, with D unchanged, if the perforation block is not block
+    ///         diagonal. Throws like DynamicMatrix::invert() if a block is singular.
+    template <class Scalar>
+    bool invertCondensed(Dune::DynamicMatrix<Scalar>& D, const int numCoreEq,
+                         const int numPerforations, const int numPerfEq)
+    {
+        typedef Dune::DynamicMatrix<Scalar> Matrix;
+        const int k = numCoreEq;
+        const int m = numPerfEq;
+        const int n = k + m * numPerforations;
+        auto index = [k, numPerforations](const int perf, const int j) { return k + j * numPerforations + perf; };
+
+        if ( static_cast<int>(D.N()) != n || static_cast<int>(D.M()) != n )
+        {
+            return false;
+        }
+        for ( int row = k; row < n; ++row )
+        {
+            const int rowPerf = (row - k) % numPerforations;
+            for ( int col = k; col < n; ++col )
+            {
+                if ( (col - k) % numPerforations != rowPerf && D[row][col] != 0.0 )
+                {
+                    return false;
+                }
+            }
+        }
+
+        // W_p = P_p^-1 D_pc and V_p = D_cp P_p^-1 of each perforation p
+        std::vector<Matrix> invP(numPerforations, Matrix(m, m, 0.0));
+        std::vector<Matrix> W(numPerforations, Matrix(m, k, 0.0));
+        std::vector<Matrix> V(numPerforations, Matrix(k, m, 0.0));
+        Matrix S(k, k, 0.0);
+        for ( int r = 0; r < k; ++r )
+        {
+            for ( int c = 0; c < k; ++c )
+            {
+                S[r][c] = D[r][c];
+            }
+        }
+
+        for ( int perf = 0; perf < numPerforations; ++perf )
+        {
+            Matrix& P = invP[perf];
+            for ( int i = 0; i < m; ++i )
+            {
+                for ( int j = 0; j < m; ++j )
+                {
+                    P[i][j] = D[index(perf, i)][index(perf, j)];
+                }
+            }
+            P.invert();
+
+            for ( int i = 0; i < m; ++i )
+            {
+                for ( int c = 0; c < k; ++c )
+                {
+                    Scalar w = 0.0;
+                    Scalar v = 0.0;
+                    for ( int j = 0; j < m; ++j )
+                    {
+                        w += P[i][j] * D[index(perf, j)][c];
+                        v += D[c][index(perf, j)] * P[j][i];
+                    }
+                    W[perf][i][c] = w;
+                    V[perf][c][i] = v;
+                }
+            }
+
+            // S = D_cc - sum_p D_cp P_p^-1 D_pc
+            for ( int r = 0; r < k; ++r )
+            {
+                for ( int c = 0; c < k; ++c )
+                {
+                    for ( int j = 0; j < m; ++j )
+                    {
+                        S[r][c] -= D[r][index(perf, j)] * W[perf][j][c];
+                    }
+                }
+            }
+        }
+        S.invert();
+
+        // X_p = W_p S^-1, needed by both the lower left and the perforation blocks
+        std::vector<Matrix> X(numPerforations, Matrix(m, k, 0.0));
+        for ( int perf = 0; perf < numPerforations; ++perf )
+        {
+            for ( int i = 0; i < m; ++i )
+            {
+                for ( int c = 0; c < k; ++c )
+                {
+                    Scalar x = 0.0;
+                    for ( int l = 0; l < k; ++l )
+                    {
+                        x += W[perf][i][l] * S[l][c];
+                    }
+                    X[perf][i][c] = x;
+                }
+            }
+        }
+
+        // the inverse is
+        //   [ S^-1          -S^-1 V             ]
+        //   [ -W S^-1       P^-1 + W S^-1 V     ]
+        for ( int r = 0; r < k; ++r )
+        {
+            for ( int c = 0; c < k; ++c )
+            {
+                D[r][c] = S[r][c];
+            }
+        }
+        for ( int perf = 0; perf < numPerforations; ++perf )
+        {
+            for ( int j = 0; j < m; ++j )
+            {
+                const int col = index(perf, j);
+                for ( int r = 0; r < k; ++r )
+                {
+                    Scalar upper = 0.0;
+                    for ( int l = 0; l < k; ++l )
+                    {
+                        upper += S[r][l] * V[perf][l][j];
+                    }
+                    D[r][col] = -upper;
+                    D[col][r] = -X[perf][j][r];
+                }
+            }
+            for ( int other = 0; other < numPerforations; ++other )
+            {
+                for ( int i = 0; i < m; ++i )
+                {
+                    for ( int j = 0; j < m; ++j )
+                    {
+                        Scalar value = (other == perf) ? invP[perf][i][j] : 0.0;
+                        for ( int l = 0; l < k; ++l )
+                        {
+                            value += X[perf][i][l] * V[other][l][j];
+                        }
+                        D[index(perf, i)][index(other, j)] = value;
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+} // namespace wellhelpers
+
+} // namespace Opm
+
+#endif // OPM_CONDENSEDWELLSYSTEM_HEADER_INCLUDED
@@ -0,0 +1,186 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_CONVERGENCEHOTSPOTS_HEADER_INCLUDED
+#define OPM_CONVERGENCEHOTSPOTS_HEADER_INCLUDED
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace Opm
+{
+
+    /// \brief The cells and wells which keep the Newton iterations from converging.
+    ///
+    /// For each Newton iteration which did not converge the model adds the
+    /// wells which failed their convergence check and, if the CNV tolerance
+    /// is not met, the cells with the largest CNV residual of the whole grid.
+    /// The summary lists the cells and wells which appeared in the most
+    /// iterations, with the largest residual of each cell and its component.
+    /// The cells are identified by their global Cartesian index, hence the
+    /// records of all processes can be merged.
+    class ConvergenceHotSpots
+    {
+    public:
+        /// \brief The residual of a cell in one iteration.
+        struct Cell
+        {
+            int cartesian_index;
+            int region;
+            int component;
+            double cnv;
+        };
+
+        /// \brief Constructor.
+        /// \param numReported The number of cells taken from each iteration and
+        ///                    the number of cells and wells in the summary.
+        /// \param componentNames The names of the components, in the order of the equations.
+        /// \param cartesianDimensions The size of the Cartesian grid, for the IJK indices.
+        ConvergenceHotSpots(std::size_t numReported, const std::vector<std::string>& componentNames,
+                            const std::array<int, 3>& cartesianDimensions)
+            : numReported_(std::max(numReported, std::size_t(1)))
+            , componentNames_(componentNames)
+            , cartesianDimensions_(cartesianDimensions)
+            , iterations_(0)
+        {}
+
+        /// \brief The number of cells taken from each iteration.
+        std::size_t numReported() const
+        {
+            return numReported_;
+        }
+
+        /// \brief Keep the k cells with the largest residual, in descending order.
+        static void keepLargest(std::vector<Cell>& cells, std::size_t k)
+        {
+            const auto larger = [](const Cell& a, const Cell& b) { return a.cnv > b.cnv; };
+            if ( cells.size() > k )
+            {
+                std::nth_element(cells.begin(), cells.begin() + k, cells.end(), larger);
+                cells.resize(k);
+            }
+            std::sort(cells.begin(), cells.end(), larger);
+        }
+
+        /// \brief Record the worst cells and the failed wells of one iteration.
+        /// \param cells The worst cells of the grid, at most numReported().
+        /// \param wells The names of the failed wells, a well may appear more than once.
+        void addIteration(const std::vector<Cell>& cells, std::vector<std::string> wells)
+        {
+            ++iterations_;
+            for ( const auto& cell : cells )
+            {
+                auto& statistics = cells_[cell.cartesian_index];
+                ++statistics.iterations;
+                statistics.region = cell.region;
+                if ( cell.cnv > statistics.max_cnv )
+                {
+                    statistics.max_cnv = cell.cnv;
+                    statistics.component = cell.component;
+                }
+            }
+            std::sort(wells.begin(), wells.end());
+            wells.erase(std::unique(wells.begin(), wells.end()), wells.end());
+            for ( const auto& well : wells )
+            {
+                ++wells_[well];
+            }
+        }
+
+        /// \brief The (1-based) IJK indices of a global Cartesian index.
+        std::array<int, 3> ijk(int cartesianIndex) const
+        {
+            const int nx = cartesianDimensions_[0];
+            const int ny = cartesianDimensions_[1];
+            return {{ cartesianIndex % nx + 1, (cartesianIndex / nx) % ny + 1, cartesianIndex / (nx * ny) + 1 }};
+        }
+
+        /// \brief The table of the cells and wells which appeared in the most iterations.
+        std::string summary() const
+        {
+            typedef std::pair<int, CellStatistics> CellEntry;
+            std::vector<CellEntry> cells(cells_.begin(), cells_.end());
+            const std::size_t numCells = std::min(numReported_, cells.size());
+            std::partial_sort(cells.begin(), cells.begin() + numCells, cells.end(),
+                              [](const CellEntry& a, const CellEntry& b) {
+                                  return a.second.iterations > b.second.iterations
+                                      || (a.second.iterations == b.second.iterations && a.second.max_cnv > b.second.max_cnv);
+                              });
+
+            typedef std::pair<std::string, int> WellEntry;
+            std::vector<WellEntry> wells(wells_.begin(), wells_.end());
+            const std::size_t numWells = std::min(numReported_, wells.size());
+            std::partial_sort(wells.begin(), wells.begin() + numWells, wells.end(),
+                              [](const WellEntry& a, const WellEntry& b) { return a.second > b.second; });
+
+            std::ostringstream os;
+            os << "Convergence hot spots of " << iterations_ << " Newton iterations which did not converge:\n"
+               << std::setw(6) << "I" << std::setw(6) << "J" << std::setw(6) << "K"
+               << std::setw(8) << "Region" << std::setw(12) << "Iterations" << "  "
+               << std::left << std::setw(18) << "Component" << std::right << std::setw(12) << "Max CNV" << "\n";
+            for ( std::size_t c = 0; c < numCells; ++c )
+            {
+                const auto index = ijk(cells[c].first);
+                const auto& statistics = cells[c].second;
+                const int component = statistics.component;
+                const bool named = component >= 0 && component < static_cast<int>(componentNames_.size());
+                os << std::setw(6) << index[0] << std::setw(6) << index[1] << std::setw(6) << index[2]
+                   << std::setw(8) << statistics.region << std::setw(12) << statistics.iterations << "  "
+                   << std::left << std::setw(18) << (named ? componentNames_[component] : std::to_string(component))
+                   << std::right << std::scientific << std::setprecision(3) << std::setw(12) << statistics.max_cnv
+                   << std::defaultfloat << "\n";
+            }
+            if ( numWells > 0 )
+            {
+                os << std::left << std::setw(18) << "Well" << std::right << std::setw(12) << "Iterations" << "\n";
+                for ( std::size_t w = 0; w < numWells; ++w )
+                {
+                    os << std::left << std::setw(18) << wells[w].first << std::right
+                       << std::setw(12) << wells[w].second << "\n";
+                }
+            }
+            return os.str();
+        }
+
+    private:
+        struct CellStatistics
+        {
+            int iterations = 0;
+            int region = 0;
+            int component = -1;
+            double max_cnv = 0.0;
+        };
+
+        std::size_t numReported_;
+        std::vector<std::string> componentNames_;
+        std::array<int, 3> cartesianDimensions_;
+        int iterations_;
+        std::map<int, CellStatistics> cells_;
+        std::map<std::string, int> wells_;
+    };
+
+} // namespace Opm
+
+#endif // OPM_CONVERGENCEHOTSPOTS_HEADER_INCLUDED
@@ -0,0 +1,527 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_ENSEMBLESOLVER_HEADER_INCLUDED
+#define OPM_ENSEMBLESOLVER_HEADER_INCLUDED
+
+#include <opm/autodiff/TimingRegistry.hpp>
+#include <opm/common/ErrorMacros.hpp>
+#include <opm/common/Exceptions.hpp>
+
+#include <opm/common/utility/platform_dependent/disable_warnings.h>
+#include <dune/common/fvector.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/ilu.hh>
+#include <opm/common/utility/platform_dependent/reenable_warnings.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace Opm
+{
+
+/// \brief Several vectors with the same block structure stored interleaved.
+///
+/// Entry k of block i of lane r is stored at [i][k * lanes + r], hence the
+/// lanes of a block entry are contiguous and the loops over them can be
+/// vectorized.
+template<class Field, int n, int lanes>
+using EnsembleVector = Dune::BlockVector<Dune::FieldVector<Field, n * lanes> >;
+
+/// \brief Copy up to lanes vectors, starting with vectors[first], into the
+///        lanes of an ensemble vector.
+///
+/// Lanes without a vector are set to zero. The template arguments Field,
+/// n and lanes have to be given explicitly.
+template<class Field, int n, int lanes, class Vector>
+void interleave(const std::vector<Vector>& vectors, std::size_t first,
+                EnsembleVector<Field, n, lanes>& ensemble)
+{
+    const std::size_t size = vectors[first].size();
+    ensemble.resize(size);
+    ensemble = 0.0;
+    for ( int r = 0; r < lanes && first + r < vectors.size(); ++r )
+    {
+        const auto& vector = vectors[first + r];
+        for ( std::size_t i = 0; i < size; ++i )
+        {
+            for ( int k = 0; k < n; ++k )
+            {
+                ensemble[i][k * lanes + r] = vector[i][k];
+            }
+        }
+    }
+}
+
+/// \brief Copy the lanes of an ensemble vector back to the vectors.
+template<class Field, int n, int lanes, class Vector>
+void deinterleave(const EnsembleVector<Field, n, lanes>& ensemble, std::size_t first,
+                  std::vector<Vector>& vectors)
+{
+    for ( int r = 0; r < lanes && first + r < vectors.size(); ++r )
+    {
+        auto& vector = vectors[first + r];
+        vector.resize(ensemble.size());
+        for ( std::size_t i = 0; i < ensemble.size(); ++i )
+        {
+            for ( int k = 0; k < n; ++k )
+            {
+                vector[i][k] = ensemble[i][k * lanes + r];
+            }
+        }
+    }
+}
+
+/// \brief Up to lanes block sparse matrices with the same sparsity pattern,
+///        stored with one copy of the pattern and interleaved values.
+///
+/// A product with an ensemble vector reads each column index once for all
+/// lanes, and the innermost loop runs over the lanes.
+/// \tparam Field The field type of the matrix entries.
+/// \tparam n The size of the blocks.
+/// \tparam lanes The number of matrices and vectors processed together.
+template<class Field, int n, int lanes>
+class EnsembleMatrix
+{
+public:
+    typedef EnsembleVector<Field, n, lanes> vector_type;
+    typedef std::uint32_t index_type;
+    static const int blockValues = n * n * lanes;
+
+    /// \brief Copy the pattern of the first matrix and the entries of all of them.
+    ///
+    /// If there are fewer matrices than lanes, the remaining lanes get the
+    /// entries of the last one. All matrices must have the sparsity pattern
+    /// of the first one.
+    template<class Matrix>
+    void setup(const std::vector<const Matrix*>& matrices)
+    {
+        if ( matrices.empty() || matrices.size() > static_cast<std::size_t>(lanes) )
+        {
+            OPM_THROW(std::logic_error, "EnsembleMatrix needs between 1 and " << lanes << " matrices");
+        }
+        const Matrix& pattern = *matrices.front();
+        if ( pattern.nonzeroes() > static_cast<std::size_t>(std::numeric_limits<index_type>::max()) )
+        {
+            OPM_THROW(std::logic_error, "The matrix is too large for the index type of EnsembleMatrix");
+        }
+        rowStart_.assign(1, 0);
+        rowStart_.reserve(pattern.N() + 1);
+        colIndex_.clear();
+        colIndex_.reserve(pattern.nonzeroes());
+        diagonal_.clear();
+        diagonal_.reserve(pattern.N());
+        for ( auto row = pattern.begin(), rowEnd = pattern.end(); row != rowEnd; ++row )
+        {
+            diagonal_.push_back(std::numeric_limits<index_type>::max());
+            for ( auto col = row->begin(), colEnd = row->end(); col != colEnd; ++col )
+            {
+                if ( col.index() == row.index() )
+                {
+                    diagonal_.back() = colIndex_.size();
+                }
+                colIndex_.push_back(col.index());
+            }
+            rowStart_.push_back(colIndex_.size());
+        }
+        values_.resize(colIndex_.size() * blockValues);
+        for ( int r = 0; r < lanes; ++r )
+        {
+            setLane(r, *matrices[std::min(static_cast<std::size_t>(r), matrices.size() - 1)]);
+        }
+    }
+
+    /// \brief Copy the entries of a matrix with the pattern of setup() to one lane.
+    template<class Matrix>
+    void setLane(int r, const Matrix& matrix)
+    {
+        if ( matrix.N() != N() || matrix.nonzeroes() != colIndex_.size() )
+        {
+            OPM_THROW(std::logic_error, "The matrices of an ensemble need the same sparsity pattern");
+        }
+        std::size_t nz = 0;
+        for ( auto row = matrix.begin(), rowEnd = matrix.end(); row != rowEnd; ++row )
+        {
+            for ( auto col = row->begin(), colEnd = row->end(); col != colEnd; ++col, ++nz )
+            {
+                if ( col.index() != colIndex_[nz] )
+                {
+                    OPM_THROW(std::logic_error, "The matrices of an ensemble need the same sparsity pattern");
+                }
+                Field* block = &values_[nz * blockValues];
+                for ( int k = 0; k < n; ++k )
+                {
+                    for ( int l = 0; l < n; ++l )
+                    {
+                        block[(k * n + l) * lanes + r] = (*col)[k][l];
+                    }
+                }
+            }
+        }
+    }
+
+    /// \brief The number of block rows.
+    std::size_t N() const
+    {
+        return rowStart_.empty() ? 0 : rowStart_.size() - 1;
+    }
+
+    /// \brief y = A x for all lanes.
+    void mv(const vector_type& x, vector_type& y) const
+    {
+        static auto& timing = TimingRegistry::instance().entry("ensemble.spmv");
+        ScopedTiming scopedTiming(timing);
+
+        const std::ptrdiff_t rows = N();
+#if HAVE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif // HAVE_OPENMP
+        for ( std::ptrdiff_t i = 0; i < rows; ++i )
+        {
+            y[i] = 0.0;
+            for ( index_type k = rowStart_[i], end = rowStart_[i + 1]; k < end; ++k )
+            {
+                blockUmv(k, x[colIndex_[k]], y[i]);
+            }
+        }
+    }
+
+    /// \brief Compute the ILU(0) factorization of each lane in place.
+    ///
+    /// Uses Dune::bilu0_decomposition on a copy of the lane, hence the
+    /// diagonal blocks hold the inverses afterwards, as expected by
+    /// iluApply().
+    template<class Matrix>
+    void iluDecomposition(const std::vector<const Matrix*>& matrices)
+    {
+        setup(matrices);
+        for ( std::size_t i = 0; i < N(); ++i )
+        {
+            if ( diagonal_[i] == std::numeric_limits<index_type>::max() )
+            {
+                OPM_THROW(LinearSolverProblem, "ILU(0) of an ensemble needs all diagonal blocks, row " << i << " has none");
+            }
+        }
+        for ( int r = 0; r < lanes; ++r )
+        {
+            Matrix factor(*matrices[std::min(static_cast<std::size_t>(r), matrices.size() - 1)]);
+            try
+            {
+                Dune::bilu0_decomposition(factor);
+            }
+            catch ( const Dune::MatrixBlockError& error )
+            {
+                OPM_THROW(LinearSolverProblem, "ILU(0) of ensemble member " << r << " failed in row " << error.r);
+            }
+            setLane(r, factor);
+        }
+    }
+
+    /// \brief Solve L U v = d for all lanes with the factors of iluDecomposition().
+    void iluApply(vector_type& v, const vector_type& d) const
+    {
+        static auto& timing = TimingRegistry::instance().entry("ensemble.ilu_apply");
+        ScopedTiming scopedTiming(timing);
+
+        const std::size_t rows = N();
+        typename vector_type::block_type rhs;
+        // lower triangular part with unit diagonal
+        for ( std::size_t i = 0; i < rows; ++i )
+        {
+            rhs = d[i];
+            for ( index_type k = rowStart_[i]; k < diagonal_[i]; ++k )
+            {
+                blockUsmv(k, -1.0, v[colIndex_[k]], rhs);
+            }
+            v[i] = rhs;
+        }
+        // upper triangular part, the diagonal holds the inverse blocks
+        for ( std::size_t i = rows; i-- > 0; )
+        {
+            rhs = v[i];
+            for ( index_type k = diagonal_[i] + 1, end = rowStart_[i + 1]; k < end; ++k )
+            {
+                blockUsmv(k, -1.0, v[colIndex_[k]], rhs);
+            }
+            v[i] = 0.0;
+            blockUmv(diagonal_[i], rhs, v[i]);
+        }
+    }
+
+private:
+    template<class XBlock, class YBlock>
+    void blockUmv(index_type nz, const XBlock& x, YBlock& y) const
+    {
+        const Field* block = &values_[nz * blockValues];
+        for ( int k = 0; k < n; ++k )
+        {
+            for ( int l = 0; l < n; ++l )
+            {
+                const Field* a = block + (k * n + l) * lanes;
+                for ( int r = 0; r < lanes; ++r )
+                {
+                    y[k * lanes + r] += a[r] * x[l * lanes + r];
+                }
+            }
+        }
+    }
+
+    template<class XBlock, class YBlock>
+    void blockUsmv(index_type nz, Field alpha, const XBlock& x, YBlock& y) const
+    {
+        const Field* block = &values_[nz * blockValues];
+        for ( int k = 0; k < n; ++k )
+        {
+            for ( int l = 0; l < n; ++l )
+            {
+                const Field* a = block + (k * n + l) * lanes;
+                for ( int r = 0; r < lanes; ++r )
+                {
+                    y[k * lanes + r] += alpha * a[r] * x[l * lanes + r];
+                }
+            }
+        }
+    }
+
+    std::vector<index_type> rowStart_;
+    std::vector<index_type> colIndex_;
+    //! \brief The position of the diagonal block of each row.
+    std::vector<index_type> diagonal_;
+    std::vector<Field> values_;
+};
+
+/// \brief The result of an ensemble solve for each lane.
+template<int lanes>
+struct EnsembleSolverResult
+{
+    std::array<int, lanes> iterations;
+    std::array<double, lanes> reduction;
+    std::array<bool, lanes> converged;
+};
+
+/// \brief BiCGSTAB for the lanes of an ensemble, preconditioned with ILU(0).
+///
+/// The lanes are independent linear systems: all scalar products and
+/// coefficients are computed per lane, and a lane that has converged is
+/// not changed any more. Only the matrix and ILU products are shared, which
+/// is where the interleaved storage pays off.
+template<class Field, int n, int lanes>
+class EnsembleBiCGSTAB
+{
+public:
+    typedef EnsembleMatrix<Field, n, lanes> Matrix;
+    typedef EnsembleVector<Field, n, lanes> Vector;
+    typedef std::array<Field, lanes> LaneValues;
+
+    /// \brief Constructor.
+    /// \param A The matrices of the lanes.
+    /// \param ilu The ILU(0) factors of the lanes.
+    /// \param reduction The reduction of the residual norm to achieve.
+    /// \param maxIter The maximum number of iterations.
+    EnsembleBiCGSTAB(const Matrix& A, const Matrix& ilu, double reduction, int maxIter)
+        : A_(A), ilu_(ilu), reduction_(reduction), maxIter_(maxIter)
+    {}
+
+    /// \brief Solve A x = b for all lanes, x holds the initial guess.
+    EnsembleSolverResult<lanes> apply(Vector& x, const Vector& b) const
+    {
+        static auto& timing = TimingRegistry::instance().entry("ensemble.solve");
+        ScopedTiming scopedTiming(timing);
+
+        const std::size_t size = b.size();
+        Vector r(size), rt(size), p(size), v(size), y(size), s(size), t(size);
+        A_.mv(x, v);
+        r = b;
+        r -= v;
+        rt = r;
+        p = 0.0;
+        v = 0.0;
+
+        EnsembleSolverResult<lanes> result;
+        const LaneValues norm0 = norms(r);
+        LaneValues rhoOld, alpha, omega;
+        std::array<bool, lanes> active;
+        for ( int l = 0; l < lanes; ++l )
+        {
+            rhoOld[l] = alpha[l] = omega[l] = 1.0;
+            active[l] = norm0[l] > 0.0;
+            result.iterations[l] = 0;
+            result.reduction[l] = 0.0;
+            result.converged[l] = !active[l];
+        }
+
+        for ( int it = 1; it <= maxIter_ && anyActive(active); ++it )
+        {
+            // p = r + beta (p - omega v)
+            const LaneValues rho = dots(rt, r);
+            LaneValues beta;
+            for ( int l = 0; l < lanes; ++l )
+            {
+                beta[l] = active[l] ? (rho[l] / rhoOld[l]) * (alpha[l] / omega[l]) : 0.0;
+                omega[l] = active[l] ? omega[l] : 0.0;
+            }
+            for ( std::size_t i = 0; i < size; ++i )
+            {
+                for ( int k = 0; k < n; ++k )
+                {
+                    for ( int l = 0; l < lanes; ++l )
+                    {
+                        const int e = k * lanes + l;
+                        p[i][e] = r[i][e] + beta[l] * (p[i][e] - omega[l] * v[i][e]);
+                    }
+                }
+            }
+
+            ilu_.iluApply(y, p);
+            A_.mv(y, v);
+            const LaneValues rtv = dots(rt, v);
+            for ( int l = 0; l < lanes; ++l )
+            {
+                alpha[l] = ( active[l] && rtv[l] != 0.0 ) ? rho[l] / rtv[l] : 0.0;
+            }
+            // s = r - alpha v, x += alpha y
+            laneAxpy(s, r, alpha, v, -1.0);
+            laneAxpy(x, x, alpha, y, 1.0);
+
+            const LaneValues normS = norms(s);
+            for ( int l = 0; l < lanes; ++l )
+            {
+                if ( active[l] && normS[l] <= reduction_ * norm0[l] )
+                {
+                    finish(result, active, l, it, normS[l] / norm0[l]);
+                }
+            }
+
+            ilu_.iluApply(y, s);
+            A_.mv(y, t);
+            const LaneValues ts = dots(t, s);
+            const LaneValues tt = dots(t, t);
+            for ( int l = 0; l < lanes; ++l )
+            {
+                omega[l] = ( active[l] && tt[l] != 0.0 ) ? ts[l] / tt[l] : 0.0;
+            }
+            // x += omega y, r = s - omega t
+            laneAxpy(x, x, omega, y, 1.0);
+            laneAxpy(r, s, omega, t, -1.0);
+
+            const LaneValues normR = norms(r);
+            for ( int l = 0; l < lanes; ++l )
+            {
+                if ( active[l] )
+                {
+                    result.iterations[l] = it;
+                    result.reduction[l] = normR[l] / norm0[l];
+                    if ( normR[l] <= reduction_ * norm0[l] )
+                    {
+                        finish(result, active, l, it, result.reduction[l]);
+                    }
+                    else if ( omega[l] == 0.0 || !std::isfinite(normR[l]) )
+                    {
+                        // breakdown
+                        active[l] = false;
+                    }
+                }
+                rhoOld[l] = active[l] ? rho[l] : 1.0;
+                omega[l] = active[l] ? omega[l] : 1.0;
+            }
+        }
+        return result;
+    }
+
+private:
+    static bool anyActive(const std::array<bool, lanes>& active)
+    {
+        for ( int l = 0; l < lanes; ++l )
+        {
+            if ( active[l] )
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static void finish(EnsembleSolverResult<lanes>& result, std::array<bool, lanes>& active,
+                       int l, int it, double reduction)
+    {
+        active[l] = false;
+        result.converged[l] = true;
+        result.iterations[l] = it;
+        result.reduction[l] = reduction;
+    }
+
+    static LaneValues dots(const Vector& x, const Vector& y)
+    {
+        LaneValues sum;
+        sum.fill(0.0);
+        for ( std::size_t i = 0; i < x.size(); ++i )
+        {
+            for ( int k = 0; k < n; ++k )
+            {
+                for ( int l = 0; l < lanes; ++l )
+                {
+                    sum[l] += x[i][k * lanes + l] * y[i][k * lanes + l];
+                }
+            }
+        }
+        return sum;
+    }
+
+    static LaneValues norms(const Vector& x)
+    {
+        LaneValues norm = dots(x, x);
+        for ( auto& value : norm )
+        {
+            value = std::sqrt(value);
+        }
+        return norm;
+    }
+
+    /// \brief z = x + sign alpha_l y per lane. z may be x.
+    static void laneAxpy(Vector& z, const Vector& x, const LaneValues& alpha,
+                         const Vector& y, Field sign)
+    {
+        for ( std::size_t i = 0; i < x.size(); ++i )
+        {
+            for ( int k = 0; k < n; ++k )
+            {
+                for ( int l = 0; l < lanes; ++l )
+                {
+                    const int e = k * lanes + l;
+                    z[i][e] = x[i][e] + sign * alpha[l] * y[i][e];
+                }
+            }
+        }
+    }
+
+    const Matrix& A_;
+    const Matrix& ilu_;
+    double reduction_;
+    int maxIter_;
+};
+
+} // end namespace Opm
+
+#endif // OPM_ENSEMBLESOLVER_HEADER_INCLUDED
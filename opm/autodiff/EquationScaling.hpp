@@ -0,0 +1,200 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_EQUATIONSCALING_HEADER_INCLUDED
+#define OPM_EQUATIONSCALING_HEADER_INCLUDED
+
+#include <opm/common/ErrorMacros.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+namespace Opm
+{
+
+/// \brief Row and column scaling of the Newton system.
+///
+/// The equation of component c in cell i is scaled by w_c / pv_i, with the
+/// weight w_c, e.g. the average inverse formation volume factor of the
+/// component times the time step, and the pore volume pv_i of the cell. The
+/// scaled residual is hence the one of the CNV convergence criterion. The
+/// column of unknown k is then scaled by the inverse of the mean magnitude
+/// of its entries in the scaled diagonal blocks, which balances e.g. the
+/// pressures to the saturations. The scaled system R A S y = R b is solved
+/// for y, and the solution is x = S y.
+/// \tparam Matrix The type of the (sequential) Jacobian.
+/// \tparam Vector The type of the vectors of the Jacobian.
+template<class Matrix, class Vector>
+class EquationScaling
+{
+public:
+    typedef typename Vector::field_type field_type;
+    static const int numEq = Vector::block_type::dimension;
+
+    /// \brief Compute the scaling factors of a Jacobian.
+    /// \param A The Jacobian.
+    /// \param componentWeights The weight of each component.
+    /// \param poreVolume The pore volume of each cell.
+    void update(const Matrix& A,
+                const std::vector<double>& componentWeights,
+                const std::vector<double>& poreVolume)
+    {
+        const std::size_t n = A.N();
+        if ( componentWeights.size() != static_cast<std::size_t>(numEq) || poreVolume.size() != n )
+        {
+            OPM_THROW(std::logic_error, "The equation scaling needs " << numEq << " component weights and "
+                      << n << " pore volumes, got " << componentWeights.size() << " and " << poreVolume.size());
+        }
+
+        rowScale_.resize(n);
+        for ( std::size_t i = 0; i < n; ++i )
+        {
+            for ( int c = 0; c < numEq; ++c )
+            {
+                const double factor = componentWeights[c] / poreVolume[i];
+                rowScale_[i][c] = std::isfinite(factor) && factor > 0.0 ? factor : 1.0;
+            }
+        }
+
+        std::vector<double> magnitude(numEq, 0.0);
+        for ( std::size_t i = 0; i < n; ++i )
+        {
+            const auto& diagonal = A[i][i];
+            for ( int k = 0; k < numEq; ++k )
+            {
+                double largest = 0.0;
+                for ( int c = 0; c < numEq; ++c )
+                {
+                    largest = std::max(largest, std::abs(rowScale_[i][c] * diagonal[c][k]));
+                }
+                magnitude[k] += largest;
+            }
+        }
+        for ( int k = 0; k < numEq; ++k )
+        {
+            const double mean = n > 0 ? magnitude[k] / n : 0.0;
+            columnScale_[k] = mean > 0.0 && std::isfinite(mean) ? 1.0 / mean : 1.0;
+        }
+    }
+
+    /// \brief Scale the system, A becomes R A S and b becomes R b.
+    void scaleSystem(Matrix& A, Vector& b) const
+    {
+        for ( auto row = A.begin(), rowEnd = A.end(); row != rowEnd; ++row )
+        {
+            const auto& rowScale = rowScale_[row.index()];
+            for ( auto col = row->begin(), colEnd = row->end(); col != colEnd; ++col )
+            {
+                auto& block = *col;
+                for ( int c = 0; c < numEq; ++c )
+                {
+                    for ( int k = 0; k < numEq; ++k )
+                    {
+                        block[c][k] *= rowScale[c] * columnScale_[k];
+                    }
+                }
+            }
+            auto& rhs = b[row.index()];
+            for ( int c = 0; c < numEq; ++c )
+            {
+                rhs[c] *= rowScale[c];
+            }
+        }
+    }
+
+    /// \brief The solution x = S y of the system from that of the scaled one.
+    void unscaleSolution(Vector& x) const
+    {
+        scaleColumns_(x);
+    }
+
+    /// \brief Add the scaled contributions of the wells, y += alpha R (-C^T D^-1 B) S x.
+    ///
+    /// The wells are applied to the unscaled system, wellModel.apply(x, y)
+    /// subtracts C^T D^-1 B x from y.
+    template<class WellModel>
+    void applyWells(const WellModel& wellModel, const field_type alpha, const Vector& x, Vector& y) const
+    {
+        x_ = x;
+        scaleColumns_(x_);
+        y_.resize(y.size());
+        y_ = 0.0;
+        wellModel.apply(x_, y_);
+        for ( std::size_t i = 0; i < y.size(); ++i )
+        {
+            for ( int c = 0; c < numEq; ++c )
+            {
+                y[i][c] += alpha * rowScale_[i][c] * y_[i][c];
+            }
+        }
+    }
+
+    /// \brief The weights of the rows for the scaled system, w_c becomes w_c / R_c.
+    ///
+    /// A combination of the equations of a cell with the weights w, e.g. the
+    /// pressure equation of CPR with the true-IMPES weights, is then the same
+    /// for the rows of R A S as for those of A S.
+    void scaleRowWeights(Vector& weights) const
+    {
+        for ( std::size_t i = 0; i < weights.size(); ++i )
+        {
+            for ( int c = 0; c < numEq; ++c )
+            {
+                weights[i][c] /= rowScale_[i][c];
+            }
+        }
+    }
+
+    /// \brief The factor of the equation of a component in a cell.
+    field_type rowScale(const std::size_t cell, const int component) const
+    {
+        return rowScale_[cell][component];
+    }
+
+    /// \brief The factor of an unknown.
+    field_type columnScale(const int unknown) const
+    {
+        return columnScale_[unknown];
+    }
+
+private:
+    void scaleColumns_(Vector& x) const
+    {
+        for ( std::size_t i = 0; i < x.size(); ++i )
+        {
+            for ( int k = 0; k < numEq; ++k )
+            {
+                x[i][k] *= columnScale_[k];
+            }
+        }
+    }
+
+    Vector rowScale_;
+    typename Vector::block_type columnScale_;
+    // the scaled input and output of the wells
+    mutable Vector x_;
+    mutable Vector y_;
+};
+
+} // namespace Opm
+
+#endif // OPM_EQUATIONSCALING_HEADER_INCLUDED
@@ -31,6 +31,7 @@
 
 #include <array>
 #include <memory>
+#include <string>
 
 BEGIN_PROPERTIES
 
@@ -38,34 +39,98 @@ NEW_TYPE_TAG(FlowIstlSolverParams);
 
 NEW_PROP_TAG(Scalar);
 NEW_PROP_TAG(LinearSolverReduction);
+NEW_PROP_TAG(LinearSolverAdaptiveReduction);
+NEW_PROP_TAG(LinearSolverMaxReduction);
 NEW_PROP_TAG(IluRelaxation);
 NEW_PROP_TAG(LinearSolverMaxIter);
 NEW_PROP_TAG(LinearSolverRestart);
+NEW_PROP_TAG(LinearSolverRecycleSize);
 NEW_PROP_TAG(FlowLinearSolverVerbosity);
 NEW_PROP_TAG(IluFillinLevel);
 NEW_PROP_TAG(MiluVariant);
 NEW_PROP_TAG(IluRedblack);
 NEW_PROP_TAG(IluReorderSpheres);
+NEW_PROP_TAG(IluReorderRcm);
+NEW_PROP_TAG(IluSinglePrecision);
 NEW_PROP_TAG(UseGmres);
+NEW_PROP_TAG(UseFusedBicgstab);
+NEW_PROP_TAG(LinearSolverOverlapHaloExchange);
+NEW_PROP_TAG(LinearSolverCompressedMatrix);
 NEW_PROP_TAG(LinearSolverRequireFullSparsityPattern);
 NEW_PROP_TAG(LinearSolverIgnoreConvergenceFailure);
 NEW_PROP_TAG(UseAmg);
 NEW_PROP_TAG(UseCpr);
+NEW_PROP_TAG(UseRas);
+NEW_PROP_TAG(RasOverlap);
+NEW_PROP_TAG(RasLocalSolver);
+NEW_PROP_TAG(LinearSolverPartitioned);
+NEW_PROP_TAG(LinearSolverAutoTune);
+NEW_PROP_TAG(LinearSolverAutoTuneSolves);
+NEW_PROP_TAG(LinearSolverDirectMaxCells);
+NEW_PROP_TAG(LinearSolverFallback);
+NEW_PROP_TAG(CprReuseSetup);
+NEW_PROP_TAG(CprReuseMaxStepGrowth);
+NEW_PROP_TAG(CprPressureSolver);
+NEW_PROP_TAG(CprSmoother);
+NEW_PROP_TAG(CprChebyshevDegree);
+NEW_PROP_TAG(CprUseTrueImpes);
+NEW_PROP_TAG(CprReuseWeights);
+NEW_PROP_TAG(CprAmgCoarsenTarget);
+NEW_PROP_TAG(CprAmgMaxLevel);
+NEW_PROP_TAG(CprAmgAlpha);
+NEW_PROP_TAG(CprAmgBeta);
+NEW_PROP_TAG(CprAmgAggregation);
+NEW_PROP_TAG(CprAmgAggregationDimension);
+NEW_PROP_TAG(CprAmgSmoothSteps);
+NEW_PROP_TAG(LinearSolverTimingReport);
+NEW_PROP_TAG(LinearSolverTimingFile);
 
 SET_SCALAR_PROP(FlowIstlSolverParams, LinearSolverReduction, 1e-2);
+SET_BOOL_PROP(FlowIstlSolverParams, LinearSolverAdaptiveReduction, false);
+SET_SCALAR_PROP(FlowIstlSolverParams, LinearSolverMaxReduction, 0.1);
 SET_SCALAR_PROP(FlowIstlSolverParams, IluRelaxation, 0.9);
 SET_INT_PROP(FlowIstlSolverParams, LinearSolverMaxIter, 200);
 SET_INT_PROP(FlowIstlSolverParams, LinearSolverRestart, 40);
+SET_INT_PROP(FlowIstlSolverParams, LinearSolverRecycleSize, 0);
 SET_INT_PROP(FlowIstlSolverParams, FlowLinearSolverVerbosity, 0);
 SET_INT_PROP(FlowIstlSolverParams, IluFillinLevel, 0);
 SET_STRING_PROP(FlowIstlSolverParams, MiluVariant, "ILU");
 SET_BOOL_PROP(FlowIstlSolverParams, IluRedblack, false);
 SET_BOOL_PROP(FlowIstlSolverParams, IluReorderSpheres, false);
+SET_BOOL_PROP(FlowIstlSolverParams, IluReorderRcm, false);
+SET_BOOL_PROP(FlowIstlSolverParams, IluSinglePrecision, false);
 SET_BOOL_PROP(FlowIstlSolverParams, UseGmres, false);
+SET_BOOL_PROP(FlowIstlSolverParams, UseFusedBicgstab, false);
+SET_BOOL_PROP(FlowIstlSolverParams, LinearSolverOverlapHaloExchange, false);
+SET_BOOL_PROP(FlowIstlSolverParams, LinearSolverCompressedMatrix, false);
 SET_BOOL_PROP(FlowIstlSolverParams, LinearSolverRequireFullSparsityPattern, false);
 SET_BOOL_PROP(FlowIstlSolverParams, LinearSolverIgnoreConvergenceFailure, false);
 SET_BOOL_PROP(FlowIstlSolverParams, UseAmg, false);
 SET_BOOL_PROP(FlowIstlSolverParams, UseCpr, false);
+SET_BOOL_PROP(FlowIstlSolverParams, UseRas, false);
+SET_INT_PROP(FlowIstlSolverParams, RasOverlap, 1);
+SET_STRING_PROP(FlowIstlSolverParams, RasLocalSolver, "ILU0");
+SET_BOOL_PROP(FlowIstlSolverParams, LinearSolverPartitioned, false);
+SET_BOOL_PROP(FlowIstlSolverParams, LinearSolverAutoTune, false);
+SET_INT_PROP(FlowIstlSolverParams, LinearSolverAutoTuneSolves, 3);
+SET_INT_PROP(FlowIstlSolverParams, LinearSolverDirectMaxCells, 0);
+SET_STRING_PROP(FlowIstlSolverParams, LinearSolverFallback, "");
+SET_BOOL_PROP(FlowIstlSolverParams, CprReuseSetup, false);
+SET_SCALAR_PROP(FlowIstlSolverParams, CprReuseMaxStepGrowth, 0.0);
+SET_STRING_PROP(FlowIstlSolverParams, CprPressureSolver, "");
+SET_STRING_PROP(FlowIstlSolverParams, CprSmoother, "ILU0");
+SET_INT_PROP(FlowIstlSolverParams, CprChebyshevDegree, 3);
+SET_BOOL_PROP(FlowIstlSolverParams, CprUseTrueImpes, false);
+SET_BOOL_PROP(FlowIstlSolverParams, CprReuseWeights, false);
+SET_INT_PROP(FlowIstlSolverParams, CprAmgCoarsenTarget, 1200);
+SET_INT_PROP(FlowIstlSolverParams, CprAmgMaxLevel, 15);
+SET_SCALAR_PROP(FlowIstlSolverParams, CprAmgAlpha, 1.0/3.0);
+SET_SCALAR_PROP(FlowIstlSolverParams, CprAmgBeta, 1e-5);
+SET_STRING_PROP(FlowIstlSolverParams, CprAmgAggregation, "isotropic");
+SET_INT_PROP(FlowIstlSolverParams, CprAmgAggregationDimension, 2);
+SET_INT_PROP(FlowIstlSolverParams, CprAmgSmoothSteps, 1);
+SET_BOOL_PROP(FlowIstlSolverParams, LinearSolverTimingReport, false);
+SET_STRING_PROP(FlowIstlSolverParams, LinearSolverTimingFile, "");
 
 END_PROPERTIES
 
@@ -88,6 +153,20 @@ namespace Opm
         bool cpr_use_bicgstab_;
         bool cpr_solver_verbose_;
         bool cpr_pressure_aggregation_;
+        bool cpr_reuse_setup_;
+        double cpr_reuse_max_step_growth_;
+        std::string cpr_pressure_solver_;
+        std::string cpr_smoother_;
+        int cpr_chebyshev_degree_;
+        bool cpr_use_true_impes_;
+        bool cpr_reuse_weights_;
+        int cpr_amg_coarsen_target_;
+        int cpr_amg_max_level_;
+        double cpr_amg_alpha_;
+        double cpr_amg_beta_;
+        std::string cpr_amg_aggregation_;
+        int cpr_amg_aggregation_dimension_;
+        int cpr_amg_smooth_steps_;
 
         CPRParameter() { reset(); }
 
@@ -106,6 +185,20 @@ namespace Opm
             cpr_use_bicgstab_         = param.getDefault("cpr_use_bicgstab", cpr_use_bicgstab_);
             cpr_solver_verbose_       = param.getDefault("cpr_solver_verbose", cpr_solver_verbose_);
             cpr_pressure_aggregation_ = param.getDefault("cpr_pressure_aggregation", cpr_pressure_aggregation_);
+            cpr_reuse_setup_          = param.getDefault("cpr_reuse_setup", cpr_reuse_setup_);
+            cpr_reuse_max_step_growth_ = param.getDefault("cpr_reuse_max_step_growth", cpr_reuse_max_step_growth_);
+            cpr_pressure_solver_      = param.getDefault("cpr_pressure_solver", cpr_pressure_solver_);
+            cpr_smoother_             = param.getDefault("cpr_smoother", cpr_smoother_);
+            cpr_chebyshev_degree_     = param.getDefault("cpr_chebyshev_degree", cpr_chebyshev_degree_);
+            cpr_use_true_impes_       = param.getDefault("cpr_use_true_impes", cpr_use_true_impes_);
+            cpr_reuse_weights_        = param.getDefault("cpr_reuse_weights", cpr_reuse_weights_);
+            cpr_amg_coarsen_target_   = param.getDefault("cpr_amg_coarsen_target", cpr_amg_coarsen_target_);
+            cpr_amg_max_level_        = param.getDefault("cpr_amg_max_level", cpr_amg_max_level_);
+            cpr_amg_alpha_            = param.getDefault("cpr_amg_alpha", cpr_amg_alpha_);
+            cpr_amg_beta_             = param.getDefault("cpr_amg_beta", cpr_amg_beta_);
+            cpr_amg_aggregation_      = param.getDefault("cpr_amg_aggregation", cpr_amg_aggregation_);
+            cpr_amg_aggregation_dimension_ = param.getDefault("cpr_amg_aggregation_dimension", cpr_amg_aggregation_dimension_);
+            cpr_amg_smooth_steps_     = param.getDefault("cpr_amg_smooth_steps", cpr_amg_smooth_steps_);
 
             std::string milu("ILU");
             cpr_ilu_milu_ = convertString2Milu(param.getDefault("ilu_milu", milu));
@@ -124,6 +217,20 @@ namespace Opm
             cpr_use_bicgstab_         = true;
             cpr_solver_verbose_       = false;
             cpr_pressure_aggregation_ = false;
+            cpr_reuse_setup_          = false;
+            cpr_reuse_max_step_growth_ = 0.0;
+            cpr_pressure_solver_      = "";
+            cpr_smoother_             = "ILU0";
+            cpr_chebyshev_degree_     = 3;
+            cpr_use_true_impes_       = false;
+            cpr_reuse_weights_        = false;
+            cpr_amg_coarsen_target_   = 1200;
+            cpr_amg_max_level_        = 15;
+            cpr_amg_alpha_            = 1.0/3.0;
+            cpr_amg_beta_             = 1e-5;
+            cpr_amg_aggregation_      = "isotropic";
+            cpr_amg_aggregation_dimension_ = 2;
+            cpr_amg_smooth_steps_     = 1;
         }
     };
 
@@ -135,57 +242,139 @@ namespace Opm
         : public CPRParameter
     {
         double linear_solver_reduction_;
+        bool   linear_solver_adaptive_reduction_;
+        double linear_solver_max_reduction_;
         double ilu_relaxation_;
         int    linear_solver_maxiter_;
         int    linear_solver_restart_;
+        int    linear_solver_recycle_size_;
         int    linear_solver_verbosity_;
         int    ilu_fillin_level_;
         Opm::MILU_VARIANT   ilu_milu_;
         bool   ilu_redblack_;
         bool   ilu_reorder_sphere_;
+        bool   ilu_reorder_rcm_;
+        bool   ilu_single_precision_;
         bool   newton_use_gmres_;
+        bool   newton_use_fused_bicgstab_;
+        bool   linear_solver_overlap_halo_exchange_;
+        bool   linear_solver_compressed_matrix_;
         bool   require_full_sparsity_pattern_;
         bool   ignoreConvergenceFailure_;
         bool   linear_solver_use_amg_;
         bool   use_cpr_;
+        bool   use_ras_;
+        int    ras_overlap_;
+        std::string ras_local_solver_;
+        bool   linear_solver_partitioned_;
+        bool   linear_solver_auto_tune_;
+        int    linear_solver_auto_tune_solves_;
+        int    linear_solver_direct_max_cells_;
+        std::string linear_solver_fallback_;
+        bool   linear_solver_timing_;
+        std::string linear_solver_timing_file_;
 
         template <class TypeTag>
         void init()
         {
             // TODO: these parameters have undocumented non-trivial dependencies
             linear_solver_reduction_ = EWOMS_GET_PARAM(TypeTag, double, LinearSolverReduction);
+            linear_solver_adaptive_reduction_ = EWOMS_GET_PARAM(TypeTag, bool, LinearSolverAdaptiveReduction);
+            linear_solver_max_reduction_ = EWOMS_GET_PARAM(TypeTag, double, LinearSolverMaxReduction);
             ilu_relaxation_ = EWOMS_GET_PARAM(TypeTag, double, IluRelaxation);
             linear_solver_maxiter_ = EWOMS_GET_PARAM(TypeTag, int, LinearSolverMaxIter);
             linear_solver_restart_ = EWOMS_GET_PARAM(TypeTag, int, LinearSolverRestart);
+            linear_solver_recycle_size_ = EWOMS_GET_PARAM(TypeTag, int, LinearSolverRecycleSize);
             linear_solver_verbosity_ = EWOMS_GET_PARAM(TypeTag, int, FlowLinearSolverVerbosity);
             ilu_fillin_level_ = EWOMS_GET_PARAM(TypeTag, int, IluFillinLevel);
             ilu_milu_ = convertString2Milu(EWOMS_GET_PARAM(TypeTag, std::string, MiluVariant));
             ilu_redblack_ = EWOMS_GET_PARAM(TypeTag, bool, IluRedblack);
             ilu_reorder_sphere_ = EWOMS_GET_PARAM(TypeTag, bool, IluReorderSpheres);
+            ilu_reorder_rcm_ = EWOMS_GET_PARAM(TypeTag, bool, IluReorderRcm);
+            ilu_single_precision_ = EWOMS_GET_PARAM(TypeTag, bool, IluSinglePrecision);
             newton_use_gmres_ = EWOMS_GET_PARAM(TypeTag, bool, UseGmres);
+            newton_use_fused_bicgstab_ = EWOMS_GET_PARAM(TypeTag, bool, UseFusedBicgstab);
+            linear_solver_overlap_halo_exchange_ = EWOMS_GET_PARAM(TypeTag, bool, LinearSolverOverlapHaloExchange);
+            linear_solver_compressed_matrix_ = EWOMS_GET_PARAM(TypeTag, bool, LinearSolverCompressedMatrix);
             require_full_sparsity_pattern_ = EWOMS_GET_PARAM(TypeTag, bool, LinearSolverRequireFullSparsityPattern);
             ignoreConvergenceFailure_ = EWOMS_GET_PARAM(TypeTag, bool, LinearSolverIgnoreConvergenceFailure);
             linear_solver_use_amg_ = EWOMS_GET_PARAM(TypeTag, bool, UseAmg);
             use_cpr_ = EWOMS_GET_PARAM(TypeTag, bool, UseCpr);
+            use_ras_ = EWOMS_GET_PARAM(TypeTag, bool, UseRas);
+            ras_overlap_ = EWOMS_GET_PARAM(TypeTag, int, RasOverlap);
+            ras_local_solver_ = EWOMS_GET_PARAM(TypeTag, std::string, RasLocalSolver);
+            linear_solver_partitioned_ = EWOMS_GET_PARAM(TypeTag, bool, LinearSolverPartitioned);
+            linear_solver_auto_tune_ = EWOMS_GET_PARAM(TypeTag, bool, LinearSolverAutoTune);
+            linear_solver_auto_tune_solves_ = EWOMS_GET_PARAM(TypeTag, int, LinearSolverAutoTuneSolves);
+            linear_solver_direct_max_cells_ = EWOMS_GET_PARAM(TypeTag, int, LinearSolverDirectMaxCells);
+            linear_solver_fallback_ = EWOMS_GET_PARAM(TypeTag, std::string, LinearSolverFallback);
+            cpr_reuse_setup_ = EWOMS_GET_PARAM(TypeTag, bool, CprReuseSetup);
+            cpr_reuse_max_step_growth_ = EWOMS_GET_PARAM(TypeTag, double, CprReuseMaxStepGrowth);
+            cpr_pressure_solver_ = EWOMS_GET_PARAM(TypeTag, std::string, CprPressureSolver);
+            cpr_smoother_ = EWOMS_GET_PARAM(TypeTag, std::string, CprSmoother);
+            cpr_chebyshev_degree_ = EWOMS_GET_PARAM(TypeTag, int, CprChebyshevDegree);
+            cpr_use_true_impes_ = EWOMS_GET_PARAM(TypeTag, bool, CprUseTrueImpes);
+            cpr_reuse_weights_ = EWOMS_GET_PARAM(TypeTag, bool, CprReuseWeights);
+            cpr_amg_coarsen_target_ = EWOMS_GET_PARAM(TypeTag, int, CprAmgCoarsenTarget);
+            cpr_amg_max_level_ = EWOMS_GET_PARAM(TypeTag, int, CprAmgMaxLevel);
+            cpr_amg_alpha_ = EWOMS_GET_PARAM(TypeTag, double, CprAmgAlpha);
+            cpr_amg_beta_ = EWOMS_GET_PARAM(TypeTag, double, CprAmgBeta);
+            cpr_amg_aggregation_ = EWOMS_GET_PARAM(TypeTag, std::string, CprAmgAggregation);
+            cpr_amg_aggregation_dimension_ = EWOMS_GET_PARAM(TypeTag, int, CprAmgAggregationDimension);
+            cpr_amg_smooth_steps_ = EWOMS_GET_PARAM(TypeTag, int, CprAmgSmoothSteps);
+            linear_solver_timing_ = EWOMS_GET_PARAM(TypeTag, bool, LinearSolverTimingReport);
+            linear_solver_timing_file_ = EWOMS_GET_PARAM(TypeTag, std::string, LinearSolverTimingFile);
         }
 
         template <class TypeTag>
         static void registerParameters()
         {
             EWOMS_REGISTER_PARAM(TypeTag, double, LinearSolverReduction, "The minimum reduction of the residual which the linear solver must achieve");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, LinearSolverAdaptiveReduction, "Choose the reduction of the linear solver from the convergence of the Newton method (Eisenstat-Walker). The reduction is kept between LinearSolverReduction and LinearSolverMaxReduction");
+            EWOMS_REGISTER_PARAM(TypeTag, double, LinearSolverMaxReduction, "The loosest reduction of the residual used with LinearSolverAdaptiveReduction");
             EWOMS_REGISTER_PARAM(TypeTag, double, IluRelaxation, "The relaxation factor of the linear solver's ILU preconditioner");
             EWOMS_REGISTER_PARAM(TypeTag, int, LinearSolverMaxIter, "The maximum number of iterations of the linear solver");
             EWOMS_REGISTER_PARAM(TypeTag, int, LinearSolverRestart, "The number of iterations after which GMRES is restarted");
+            EWOMS_REGISTER_PARAM(TypeTag, int, LinearSolverRecycleSize, "The number of search directions kept from one linear solve to the next. A positive value uses GCR with the recycled directions (GCRO) as the linear solver instead of UseGmres or BiCGSTAB, it is restarted after LinearSolverRestart iterations. 0 disables recycling");
             EWOMS_REGISTER_PARAM(TypeTag, int, FlowLinearSolverVerbosity, "The verbosity level of the linear solver (0: off, 2: all)");
             EWOMS_REGISTER_PARAM(TypeTag, int, IluFillinLevel, "The fill-in level of the linear solver's ILU preconditioner");
             EWOMS_REGISTER_PARAM(TypeTag, std::string, MiluVariant, "Specify which variant of the modified-ILU preconditioner ought to be used. Possible variants are: ILU (default, plain ILU), MILU_1 (lump diagonal with dropped row entries), MILU_2 (lump diagonal with the sum of the absolute values of the dropped row  entries), MILU_3 (if diagonal is positive add sum of dropped row entrires. Otherwise substract them), MILU_4 (if diagonal is positive add sum of dropped row entrires. Otherwise do nothing");
             EWOMS_REGISTER_PARAM(TypeTag, bool, IluRedblack, "Use red-black partioning for the ILU preconditioner");
             EWOMS_REGISTER_PARAM(TypeTag, bool, IluReorderSpheres, "Whether to reorder the entries of the matrix in the red-black ILU preconditioner in spheres starting at an edge. If false the original ordering is preserved in each color. Otherwise why try to ensure D4 ordering (in a 2D structured grid, the diagonal elements are consecutive).");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, IluReorderRcm, "Reorder the rows of the ILU preconditioner with reverse Cuthill-McKee to reduce the bandwidth and improve the cache locality of the triangular solves. Ignored if IluRedblack is set");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, IluSinglePrecision, "Store and apply the ILU preconditioner in single precision. The linear solver itself still uses double precision");
             EWOMS_REGISTER_PARAM(TypeTag, bool, UseGmres, "Use GMRES as the linear solver");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, UseFusedBicgstab, "Use the BiCGSTAB variant with two fused global reductions per iteration as the linear solver. Reduces the communication latency in large parallel runs. Ignored if UseGmres is set");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, LinearSolverOverlapHaloExchange, "Exchange the ghost values of the input of the mat-vec product while the rows without ghost columns are multiplied, instead of at the end of the ILU preconditioner. Only used in parallel runs with the ILU preconditioner (no UseAmg or UseCpr)");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, LinearSolverCompressedMatrix, "Use a copy of the Jacobian with 32 bit indices and contiguous blocks for the mat-vec products of the linear solver. Costs the memory of a second copy of the matrix entries");
             EWOMS_REGISTER_PARAM(TypeTag, bool, LinearSolverRequireFullSparsityPattern, "Produce the full sparsity pattern for the linear solver");
             EWOMS_REGISTER_PARAM(TypeTag, bool, LinearSolverIgnoreConvergenceFailure, "Continue with the simulation like nothing happened after the linear solver did not converge");
             EWOMS_REGISTER_PARAM(TypeTag, bool, UseAmg, "Use AMG as the linear solver's preconditioner");
             EWOMS_REGISTER_PARAM(TypeTag, bool, UseCpr, "Use CPR as the linear solver's preconditioner");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, UseRas, "Use restricted additive Schwarz as the linear solver's preconditioner. Ignored if UseAmg or UseCpr is set");
+            EWOMS_REGISTER_PARAM(TypeTag, int, RasOverlap, "The number of layers of ghost cells in the subdomains of restricted additive Schwarz (0 or 1, limited by the ghost layer of the grid partition). 0 gives block-Jacobi");
+            EWOMS_REGISTER_PARAM(TypeTag, std::string, RasLocalSolver, "The solver for the subdomain problems of restricted additive Schwarz. Possible values are: ILU0 (default), ILUK (ILU with IluFillinLevel), Direct (UMFPack or SuperLU, only for small subdomains)");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, LinearSolverPartitioned, "Precondition only the flow equations with CPR (UseCpr) or ILU0 and update the polymer, solvent and energy unknowns with a block Gauss-Seidel sweep. Ignored for models without such equations. Takes precedence over UseAmg and UseRas");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, LinearSolverAutoTune, "Measure the solves with a few preconditioner configurations (ILU0, ILU1, red-black ILU0, CPR) at the start of the run and use the fastest one for the rest of it");
+            EWOMS_REGISTER_PARAM(TypeTag, int, LinearSolverAutoTuneSolves, "The number of linear solves measured for each configuration if LinearSolverAutoTune is set");
+            EWOMS_REGISTER_PARAM(TypeTag, int, LinearSolverDirectMaxCells, "Use a sparse direct factorization (UMFPack) as the preconditioner for sequential runs with at most this many cells. The symbolic factorization is kept while the sparsity pattern does not change. 0 (default) never uses it. A value of about 50000 is a reasonable choice");
+            EWOMS_REGISTER_PARAM(TypeTag, std::string, LinearSolverFallback, "The comma separated configurations tried in turn on the same system if the linear solver does not converge, before the time step is cut. Possible values are: ilu0 (ILU0 with BiCGSTAB), ilu1 (ILU1 with BiCGSTAB), cpr (CPR with GMRES and twice the restart length and iterations), direct (UMFPack, sequential runs only), e.g. ilu0,cpr,direct. Empty (default) cuts the time step at once");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, CprReuseSetup, "Reuse the aggregates and coarse level structure of the CPR preconditioner between Newton iterations and time steps. Only the matrix entries are recomputed, a full setup is done again at a new report step or if the number of linear iterations increases");
+            EWOMS_REGISTER_PARAM(TypeTag, double, CprReuseMaxStepGrowth, "The largest factor the time step size may grow by since the last full setup of a reused CPR preconditioner, as the accumulation terms which make the pressure system diagonally dominant shrink relative to the fluxes. Shorter steps, e.g. after a failure, keep the setup. 0 does not limit the growth");
+            EWOMS_REGISTER_PARAM(TypeTag, std::string, CprPressureSolver, "The name of the backend used to solve the pressure system of CPR. Empty uses the built-in AMG or ILU0");
+            EWOMS_REGISTER_PARAM(TypeTag, std::string, CprSmoother, "The smoother used on the levels of the AMG of CPR. Possible values are: ILU0 (default, sequential within a process), BlockJacobiILU0 (ILU0 on one block of rows per thread), Chebyshev (Chebyshev polynomial of the block diagonally scaled matrix, threaded)");
+            EWOMS_REGISTER_PARAM(TypeTag, int, CprChebyshevDegree, "The degree of the polynomial of the Chebyshev smoother (see CprSmoother)");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, CprUseTrueImpes, "Decouple the pressure equation of CPR with the true-IMPES weights computed from the derivatives of the accumulation terms instead of summing the mass balance equations (quasi-IMPES)");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, CprReuseWeights, "Compute the true-IMPES weights only in the first Newton iteration of a time step and keep them for the following iterations (see CprUseTrueImpes)");
+            EWOMS_REGISTER_PARAM(TypeTag, int, CprAmgCoarsenTarget, "The number of unknowns of the coarsest level of the AMG of CPR at which the coarsening stops");
+            EWOMS_REGISTER_PARAM(TypeTag, int, CprAmgMaxLevel, "The largest number of levels of the AMG of CPR");
+            EWOMS_REGISTER_PARAM(TypeTag, double, CprAmgAlpha, "The relative strength of a connection of the AMG of CPR, compared to the strongest connection of its row, above which the connection is strong");
+            EWOMS_REGISTER_PARAM(TypeTag, double, CprAmgBeta, "The absolute strength below which the connections of the AMG of CPR are ignored");
+            EWOMS_REGISTER_PARAM(TypeTag, std::string, CprAmgAggregation, "The shape of the aggregates of the AMG of CPR. Possible values are: isotropic (default), anisotropic (elongated along the strong connections, e.g. of thin layers)");
+            EWOMS_REGISTER_PARAM(TypeTag, int, CprAmgAggregationDimension, "The dimension of the problem the sizes of the aggregates of the AMG of CPR are chosen for (see CprAmgAggregation)");
+            EWOMS_REGISTER_PARAM(TypeTag, int, CprAmgSmoothSteps, "The number of pre and of post smoothing steps on each level of the AMG of CPR");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, LinearSolverTimingReport, "Measure the time spent in the stages of the linear solver (preconditioner setup and apply, SpMV, well apply, communication) and write it to the PRT file for each report step");
+            EWOMS_REGISTER_PARAM(TypeTag, std::string, LinearSolverTimingFile, "The name of a CSV file to write the timings of the linear solver stages to for each report step. Requires LinearSolverTimingReport");
         }
 
         FlowLinearSolverParameters() { reset(); }
@@ -198,17 +387,33 @@ namespace Opm
 
             // read parameters (using previsouly set default values)
             newton_use_gmres_        = param.getDefault("newton_use_gmres", newton_use_gmres_ );
+            newton_use_fused_bicgstab_ = param.getDefault("newton_use_fused_bicgstab", newton_use_fused_bicgstab_ );
+            linear_solver_overlap_halo_exchange_ = param.getDefault("linear_solver_overlap_halo_exchange", linear_solver_overlap_halo_exchange_ );
+            linear_solver_compressed_matrix_ = param.getDefault("linear_solver_compressed_matrix", linear_solver_compressed_matrix_ );
             linear_solver_reduction_ = param.getDefault("linear_solver_reduction", linear_solver_reduction_ );
+            linear_solver_adaptive_reduction_ = param.getDefault("linear_solver_adaptive_reduction", linear_solver_adaptive_reduction_ );
+            linear_solver_max_reduction_ = param.getDefault("linear_solver_max_reduction", linear_solver_max_reduction_ );
             linear_solver_maxiter_   = param.getDefault("linear_solver_maxiter", linear_solver_maxiter_);
             linear_solver_restart_   = param.getDefault("linear_solver_restart", linear_solver_restart_);
+            linear_solver_recycle_size_ = param.getDefault("linear_solver_recycle_size", linear_solver_recycle_size_);
             linear_solver_verbosity_ = param.getDefault("linear_solver_verbosity", linear_solver_verbosity_);
             require_full_sparsity_pattern_ = param.getDefault("require_full_sparsity_pattern", require_full_sparsity_pattern_);
             ignoreConvergenceFailure_ = param.getDefault("linear_solver_ignoreconvergencefailure", ignoreConvergenceFailure_);
             linear_solver_use_amg_    = param.getDefault("linear_solver_use_amg", linear_solver_use_amg_ );
+            use_ras_                  = param.getDefault("linear_solver_use_ras", use_ras_ );
+            ras_overlap_              = param.getDefault("ras_overlap", ras_overlap_ );
+            ras_local_solver_         = param.getDefault("ras_local_solver", ras_local_solver_ );
+            linear_solver_partitioned_ = param.getDefault("linear_solver_partitioned", linear_solver_partitioned_ );
+            linear_solver_auto_tune_ = param.getDefault("linear_solver_auto_tune", linear_solver_auto_tune_ );
+            linear_solver_auto_tune_solves_ = param.getDefault("linear_solver_auto_tune_solves", linear_solver_auto_tune_solves_ );
+            linear_solver_direct_max_cells_ = param.getDefault("linear_solver_direct_max_cells", linear_solver_direct_max_cells_ );
+            linear_solver_fallback_ = param.getDefault("linear_solver_fallback", linear_solver_fallback_ );
             ilu_relaxation_           = param.getDefault("ilu_relaxation", ilu_relaxation_ );
             ilu_fillin_level_         = param.getDefault("ilu_fillin_level",  ilu_fillin_level_ );
             ilu_redblack_             = param.getDefault("ilu_redblack", cpr_ilu_redblack_);
             ilu_reorder_sphere_       = param.getDefault("ilu_reorder_sphere", cpr_ilu_reorder_sphere_);
+            ilu_reorder_rcm_          = param.getDefault("ilu_reorder_rcm", ilu_reorder_rcm_);
+            ilu_single_precision_     = param.getDefault("ilu_single_precision", ilu_single_precision_);
             std::string milu("ILU");
             ilu_milu_ = convertString2Milu(param.getDefault("ilu_milu", milu));
 
@@ -222,18 +427,35 @@ namespace Opm
         {
             use_cpr_     = false;
             newton_use_gmres_        = false;
+            newton_use_fused_bicgstab_ = false;
+            linear_solver_overlap_halo_exchange_ = false;
+            linear_solver_compressed_matrix_ = false;
             linear_solver_reduction_ = 1e-2;
+            linear_solver_adaptive_reduction_ = false;
+            linear_solver_max_reduction_ = 0.1;
             linear_solver_maxiter_   = 150;
             linear_solver_restart_   = 40;
+            linear_solver_recycle_size_ = 0;
             linear_solver_verbosity_ = 0;
             require_full_sparsity_pattern_ = false;
             ignoreConvergenceFailure_ = false;
             linear_solver_use_amg_    = false;
+            use_ras_                  = false;
+            ras_overlap_              = 1;
+            ras_local_solver_         = "ILU0";
+            linear_solver_partitioned_ = false;
+            linear_solver_auto_tune_ = false;
+            linear_solver_auto_tune_solves_ = 3;
+            linear_solver_direct_max_cells_ = 0;
+            linear_solver_fallback_.clear();
             ilu_fillin_level_         = 0;
             ilu_relaxation_           = 0.9;
             ilu_milu_                 = MILU_VARIANT::ILU;
             ilu_redblack_             = false;
             ilu_reorder_sphere_       = true;
+            ilu_reorder_rcm_          = false;
+            ilu_single_precision_     = false;
+            linear_solver_timing_     = false;
         }
     };
 
@@ -25,7 +25,21 @@
 
 #include <sys/utsname.h>
 
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <pthread.h>
+#endif
+
 #include <opm/simulators/ParallelFileMerger.hpp>
+#include <opm/simulators/GatheringLog.hpp>
 
 #include <opm/autodiff/BlackoilModelEbos.hpp>
 #include <opm/autodiff/MissingFeatures.hpp>
@@ -58,6 +72,11 @@ NEW_PROP_TAG(OutputMode);
 NEW_PROP_TAG(EnableDryRun);
 NEW_PROP_TAG(OutputInterval);
 NEW_PROP_TAG(UseAmg);
+NEW_PROP_TAG(ThreadsFromAffinity);
+NEW_PROP_TAG(PinThreads);
+NEW_PROP_TAG(GatherParallelLogs);
+NEW_PROP_TAG(StartupTimingFile);
+NEW_PROP_TAG(RelpermDiagnosticsCacheFile);
 
 SET_STRING_PROP(EclFlowProblem, OutputMode, "all");
 
@@ -66,6 +85,12 @@ SET_STRING_PROP(EclFlowProblem, EnableDryRun, "auto");
 
 SET_INT_PROP(EclFlowProblem, OutputInterval, 1);
 
+SET_BOOL_PROP(EclFlowProblem, ThreadsFromAffinity, false);
+SET_BOOL_PROP(EclFlowProblem, PinThreads, false);
+SET_BOOL_PROP(EclFlowProblem, GatherParallelLogs, true);
+SET_STRING_PROP(EclFlowProblem, StartupTimingFile, "");
+SET_STRING_PROP(EclFlowProblem, RelpermDiagnosticsCacheFile, "");
+
 END_PROPERTIES
 
 namespace Opm
@@ -106,6 +131,16 @@ namespace Opm
                                  "Specify if the simulation ought to be actually run, or just pretended to be");
             EWOMS_REGISTER_PARAM(TypeTag, int, OutputInterval,
                                  "Specify the number of report steps between two consecutive writes of restart data");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, ThreadsFromAffinity,
+                                 "Use one thread per CPU the process is bound to, e.g. one process per NUMA domain, unless OMP_NUM_THREADS is set");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, PinThreads,
+                                 "Bind each thread to one of the CPUs the process is bound to");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, GatherParallelLogs,
+                                 "Send the log messages of all processes to the log files of the first one during the run instead of merging log files per process after it");
+            EWOMS_REGISTER_PARAM(TypeTag, std::string, StartupTimingFile,
+                                 "The name of a JSON file to write the time spent in each phase of the startup to");
+            EWOMS_REGISTER_PARAM(TypeTag, std::string, RelpermDiagnosticsCacheFile,
+                                 "The name of a file to keep a hash of the input of the saturation function diagnostics in. The diagnostics are skipped if the input did not change since the last run");
             Simulator::registerParameters();
 
             ISTLSolverType::registerParameters();
@@ -218,14 +253,15 @@ namespace Opm
                 if (status)
                     return status;
 
-                setupParallelism();
-                setupOutput();
+                timeStartupPhase_("parallelism", [this]() { setupParallelism(); });
+                timeStartupPhase_("output", [this]() { setupOutput(); });
                 setupEbosSimulator();
-                setupLogging();
+                timeStartupPhase_("logging", [this]() { setupLogging(); });
                 printPRTHeader();
-                runDiagnostics();
-                setupLinearSolver();
-                createSimulator();
+                timeStartupPhase_("diagnostics", [this]() { runDiagnostics(); });
+                timeStartupPhase_("linear solver", [this]() { setupLinearSolver(); });
+                timeStartupPhase_("simulator", [this]() { createSimulator(); });
+                reportStartupTimes_();
 
                 // do the actual work
                 runSimulator();
@@ -268,14 +304,116 @@ namespace Opm
             mpi_size_ = 1;
 #endif
 
+            // the CPUs the process may run on, e.g. those of its NUMA domain if the
+            // MPI launcher binds the processes to them.
+            const std::vector<int> cpus = affinityCpus_();
+
 #if _OPENMP
-            // if openMP is available, default to 2 threads per process.
-            if (!getenv("OMP_NUM_THREADS"))
-                omp_set_num_threads(std::min(2, omp_get_num_procs()));
+            // if openMP is available, default to 2 threads per process, or to one
+            // thread per CPU of the process if requested.
+            if (!getenv("OMP_NUM_THREADS")) {
+                if (EWOMS_GET_PARAM(TypeTag, bool, ThreadsFromAffinity) && !cpus.empty())
+                    omp_set_num_threads(static_cast<int>(cpus.size()));
+                else
+                    omp_set_num_threads(std::min(2, omp_get_num_procs()));
+            }
 #endif
 
             typedef typename GET_PROP_TYPE(TypeTag, ThreadManager) ThreadManager;
             ThreadManager::init();
+
+            const bool pinned = EWOMS_GET_PARAM(TypeTag, bool, PinThreads) && pinThreads_(cpus);
+            describeParallelism_(cpus, ThreadManager::maxThreads(), pinned);
+        }
+
+        // The CPUs in the affinity mask of the process, empty if unknown.
+        static std::vector<int> affinityCpus_()
+        {
+            std::vector<int> cpus;
+#if defined(__linux__)
+            cpu_set_t mask;
+            CPU_ZERO(&mask);
+            if (sched_getaffinity(0, sizeof(mask), &mask) == 0) {
+                for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+                    if (CPU_ISSET(cpu, &mask))
+                        cpus.push_back(cpu);
+                }
+            }
+#endif
+            return cpus;
+        }
+
+        // Bind the threads round-robin to the CPUs of the process, such that the
+        // pages they touch first stay in their NUMA domain. Returns whether all
+        // threads were bound.
+        static bool pinThreads_(const std::vector<int>& cpus)
+        {
+            if (cpus.empty())
+                return false;
+
+            bool pinned = true;
+#if defined(__linux__)
+            const auto pinThread = [&cpus](int threadIdx) {
+                cpu_set_t mask;
+                CPU_ZERO(&mask);
+                CPU_SET(cpus[threadIdx % cpus.size()], &mask);
+                return pthread_setaffinity_np(pthread_self(), sizeof(mask), &mask) == 0;
+            };
+#if _OPENMP
+#pragma omp parallel reduction(&&:pinned)
+            pinned = pinThread(omp_get_thread_num());
+#else
+            pinned = pinThread(0);
+#endif
+#else
+            pinned = false;
+#endif
+            return pinned;
+        }
+
+        // Record the placement of the processes and threads for the PRT header,
+        // one line per process gathered on the first one.
+        void describeParallelism_(const std::vector<int>& cpus, int numThreads, bool pinned)
+        {
+            std::ostringstream line;
+            struct utsname arch;
+            line << "Process " << mpi_rank_ << "    =  "
+                 << (uname(&arch) == 0 ? arch.nodename : "unknown host")
+                 << ", " << numThreads << " thread(s)"
+                 << (pinned ? " pinned" : "")
+                 << ", CPUs: ";
+            if (cpus.empty()) {
+                line << "unknown";
+            }
+            for (std::size_t i = 0; i < cpus.size(); ++i) {
+                // print ranges of consecutive CPUs as first-last
+                std::size_t last = i;
+                while (last + 1 < cpus.size() && cpus[last + 1] == cpus[last] + 1)
+                    ++last;
+                line << (i > 0 ? "," : "") << cpus[i];
+                if (last > i)
+                    line << "-" << cpus[last];
+                i = last;
+            }
+            line << "\n";
+            parallelism_description_ = line.str();
+
+#if HAVE_MPI
+            if (mpi_size_ > 1) {
+                const std::string local = parallelism_description_;
+                int length = local.size();
+                std::vector<int> lengths(mpi_size_);
+                MPI_Gather(&length, 1, MPI_INT, lengths.data(), 1, MPI_INT, 0, MPI_COMM_WORLD);
+                std::vector<int> offsets(mpi_size_ + 1, 0);
+                for (int rank = 0; rank < mpi_size_; ++rank)
+                    offsets[rank + 1] = offsets[rank] + lengths[rank];
+                std::vector<char> all(std::max(offsets.back(), 1));
+                MPI_Gatherv(const_cast<char*>(local.data()), length, MPI_CHAR,
+                            all.data(), lengths.data(), offsets.data(), MPI_CHAR, 0, MPI_COMM_WORLD);
+                if (mpi_rank_ == 0)
+                    parallelism_description_.assign(all.data(), offsets.back());
+            }
+#endif
         }
 
         // Extract the minimum priority and determines if log files ought to be created.
@@ -343,14 +481,20 @@ namespace Opm
 
             logFile_ = logFileStream.str();
 
-            if (output_ > OUTPUT_NONE) {
+            if (mpi_rank_ != 0 && output_ > OUTPUT_NONE && EWOMS_GET_PARAM(TypeTag, bool, GatherParallelLogs)) {
+                // the messages are sent to the first process at the end of each report
+                // step, only those which never get there end up in the file of the process.
+                std::shared_ptr<GatheringLog> gatheringLog = std::make_shared<GatheringLog>(Log::DefaultMessageTypes, logFile_);
+                OpmLog::addBackend(GatheringLog::backendName, gatheringLog);
+            }
+            else if (output_ > OUTPUT_NONE) {
                 std::shared_ptr<EclipsePRTLog> prtLog = std::make_shared<EclipsePRTLog>(logFile_ , Log::NoDebugMessageTypes, false, output_cout_);
                 OpmLog::addBackend( "ECLIPSEPRTLOG" , prtLog );
                 prtLog->setMessageLimiter(std::make_shared<MessageLimiter>());
                 prtLog->setMessageFormatter(std::make_shared<SimpleMessageFormatter>(false));
             }
 
-            if (output_ >= OUTPUT_LOG_ONLY) {
+            if (output_ >= OUTPUT_LOG_ONLY && !OpmLog::hasBackend(GatheringLog::backendName)) {
                 std::string debugFile = debugFileStream.str();
                 std::shared_ptr<StreamLog> debugLog = std::make_shared<EclipsePRTLog>(debugFile, Log::DefaultMessageTypes, false, output_cout_);
                 OpmLog::addBackend("DEBUGLOG",  debugLog);
@@ -404,6 +548,7 @@ namespace Opm
                  ss << "User          =  " << user << std::endl;
                  }
               ss << "Simulation started on " << tmstr << " hrs\n";
+              ss << parallelism_description_;
 
               ss << "Parameters used by Flow:\n";
               Ewoms::Parameters::printValues<TypeTag>(ss);
@@ -414,7 +559,9 @@ namespace Opm
 
         void mergeParallelLogFiles()
         {
-            // force closing of all log files.
+            // send the messages which are left to the first process and force
+            // closing of all log files.
+            gatherLogMessages();
             OpmLog::removeAllBackends();
 
             if (mpi_rank_ != 0 || mpi_size_ < 2 || !output_to_files_) {
@@ -432,13 +579,20 @@ namespace Opm
 
         void setupEbosSimulator()
         {
-            ebosSimulator_.reset(new EbosSimulator(/*verbose=*/false));
+            // the vanguard parses the deck, creates the EclipseState and the Schedule,
+            // processes and distributes the grid and the problem computes the
+            // transmissibilities when the ebos simulator is created.
+            timeStartupPhase_("deck, grid and problem", [this]() {
+                    ebosSimulator_.reset(new EbosSimulator(/*verbose=*/false));
+                });
             ebosSimulator_->executionTimer().start();
-            ebosSimulator_->model().applyInitialSolution();
+            timeStartupPhase_("initial solution",
+                              [this]() { ebosSimulator_->model().applyInitialSolution(); });
 
             try {
                 if (output_cout_) {
-                    MissingFeatures::checkKeywords(deck());
+                    timeStartupPhase_("keyword check",
+                                      [this]() { MissingFeatures::checkKeywords(deck()); });
                 }
 
                 // Possible to force initialization only behavior (NOSIM).
@@ -488,13 +642,55 @@ namespace Opm
         //   OpmLog singleton.
         void runDiagnostics()
         {
-            if (!output_cout_) {
+            // The first process decides whether to run the diagnostics: they are skipped
+            // without terminal output, or if the hash of their input is found in the
+            // cache file.
+            const std::string cacheFile = EWOMS_GET_PARAM(TypeTag, std::string, RelpermDiagnosticsCacheFile);
+            std::uint64_t hash = 0;
+            int skip = 0;
+            if (mpi_rank_ == 0) {
+                skip = !output_cout_;
+                if (!skip && !cacheFile.empty()) {
+                    hash = RelpermDiagnostics::inputHash(eclState(), deck());
+                    std::ifstream cache(cacheFile);
+                    std::uint64_t cachedHash = 0;
+                    if ((cache >> cachedHash) && cachedHash == hash) {
+                        OpmLog::info("Saturation function diagnostics skipped, their input did not change since the last run.");
+                        skip = 1;
+                    }
+                }
+            }
+            grid().comm().broadcast(&skip, 1, 0);
+            if (skip) {
                 return;
             }
 
-            // Run relperm diagnostics
+            // Run relperm diagnostics. The tables are checked by the first process
+            // and the scaled end points by each process for its interior cells.
             RelpermDiagnostics diagnostic;
-            diagnostic.diagnosis(eclState(), deck(), this->grid());
+            if (mpi_size_ == 1) {
+                diagnostic.diagnosis(eclState(), deck(), this->grid());
+            }
+            else {
+                if (output_cout_) {
+                    diagnostic.tableDiagnosis(eclState(), deck());
+                }
+                const auto& gridView = ebosSimulator_->vanguard().gridView();
+                std::vector<int> interiorCells;
+                interiorCells.reserve(gridView.size(/*codim=*/0));
+                const auto& elemEndIt = gridView.template end</*codim=*/0>();
+                for (auto elemIt = gridView.template begin</*codim=*/0>(); elemIt != elemEndIt; ++elemIt) {
+                    if (elemIt->partitionType() == Dune::InteriorEntity) {
+                        interiorCells.push_back(gridView.indexSet().index(*elemIt));
+                    }
+                }
+                diagnostic.cellDiagnosis(eclState(), deck(), this->grid(), interiorCells);
+            }
+
+            if (!cacheFile.empty() && mpi_rank_ == 0) {
+                std::ofstream cache(cacheFile);
+                cache << hash << "\n";
+            }
         }
 
         // Run the simulator.
@@ -583,6 +779,53 @@ namespace Opm
             simulator_.reset(new Simulator(*ebosSimulator_, *linearSolver_));
         }
 
+        // Measure the wall clock time of a phase of the startup.
+        template <class Phase>
+        void timeStartupPhase_(const std::string& name, Phase&& phase)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            phase();
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            startup_times_.emplace_back(name, elapsed.count());
+        }
+
+        // Write the times of the startup phases of the first process to the log and
+        // to the StartupTimingFile, if given.
+        void reportStartupTimes_()
+        {
+            if (!output_cout_) {
+                return;
+            }
+
+            double total = 0.0;
+            std::ostringstream ss;
+            ss << "Startup time:\n";
+            for (const auto& phase : startup_times_) {
+                ss << "  " << std::left << std::setw(24) << phase.first << std::right
+                   << std::fixed << std::setprecision(2) << std::setw(10) << phase.second << " s\n";
+                total += phase.second;
+            }
+            ss << "  " << std::left << std::setw(24) << "total" << std::right
+               << std::fixed << std::setprecision(2) << std::setw(10) << total << " s\n";
+            OpmLog::note(ss.str());
+
+            const std::string fileName = EWOMS_GET_PARAM(TypeTag, std::string, StartupTimingFile);
+            if (fileName.empty()) {
+                return;
+            }
+            std::ofstream file(fileName);
+            if (!file) {
+                OpmLog::warning("Could not open the startup timing file " + fileName);
+                return;
+            }
+            file << "{\n  \"processes\": " << mpi_size_ << ",\n  \"phases\": [";
+            for (std::size_t i = 0; i < startup_times_.size(); ++i) {
+                file << (i == 0 ? "\n" : ",\n") << "    { \"name\": \"" << startup_times_[i].first
+                     << "\", \"seconds\": " << std::setprecision(6) << startup_times_[i].second << " }";
+            }
+            file << "\n  ],\n  \"total\": " << total << "\n}\n";
+        }
+
         unsigned long long getTotalSystemMemory()
         {
             long pages = sysconf(_SC_PHYS_PAGES);
@@ -605,6 +848,8 @@ namespace Opm
         std::unique_ptr<ISTLSolverType> linearSolver_;
         std::unique_ptr<Simulator> simulator_;
         std::string logFile_;
+        std::string parallelism_description_;
+        std::vector<std::pair<std::string, double> > startup_times_;
     };
 } // namespace Opm
 
@@ -0,0 +1,348 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_FUSEDBICGSTABSOLVER_HEADER_INCLUDED
+#define OPM_FUSEDBICGSTABSOLVER_HEADER_INCLUDED
+
+#include <opm/common/utility/platform_dependent/disable_warnings.h>
+#include <dune/common/version.hh>
+#include <dune/common/timer.hh>
+#include <dune/istl/operators.hh>
+#include <dune/istl/preconditioner.hh>
+#include <dune/istl/solver.hh>
+#include <dune/istl/solvercategory.hh>
+#include <dune/istl/paamg/pinfo.hh>
+#if HAVE_MPI
+#include <dune/istl/owneroverlapcopy.hh>
+#endif
+#include <opm/common/utility/platform_dependent/reenable_warnings.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+namespace Opm
+{
+namespace Detail
+{
+    //! \brief Local dot product of two block vectors, skipping the blocks with mask zero.
+    template<class X>
+    double localDot(const X& x, const X& y, const std::vector<double>* mask)
+    {
+        double result = 0.0;
+        for ( std::size_t i = 0, end = x.size(); i < end; ++i )
+        {
+            double blockResult = 0.0;
+            for ( std::size_t k = 0; k < x[i].size(); ++k )
+            {
+                blockResult += x[i][k] * y[i][k];
+            }
+            result += mask ? (*mask)[i] * blockResult : blockResult;
+        }
+        return result;
+    }
+
+    /// \brief Computes several dot products with one global reduction.
+    ///
+    /// The primary template is for sequential runs.
+    template<class Communication>
+    class FusedDotProducts
+    {
+    public:
+        explicit FusedDotProducts(const Communication&)
+        {}
+
+        template<class X, std::size_t n>
+        std::array<double, n> compute(const std::array<std::pair<const X*, const X*>, n>& pairs) const
+        {
+            std::array<double, n> result;
+            for ( std::size_t i = 0; i < n; ++i )
+            {
+                result[i] = localDot(*pairs[i].first, *pairs[i].second, nullptr);
+            }
+            return result;
+        }
+
+        /// \brief Computes any number of dot products with one global reduction.
+        template<class X>
+        std::vector<double> compute(const std::vector<std::pair<const X*, const X*> >& pairs) const
+        {
+            std::vector<double> result(pairs.size());
+            for ( std::size_t i = 0; i < pairs.size(); ++i )
+            {
+                result[i] = localDot(*pairs[i].first, *pairs[i].second, nullptr);
+            }
+            return result;
+        }
+    };
+
+#if HAVE_MPI
+    /// \brief Computes several dot products with one global reduction.
+    ///
+    /// Only the entries owned by this process contribute, like in
+    /// the scalar product of OwnerOverlapCopyCommunication. The local
+    /// results are summed with a single allreduce instead of one per
+    /// dot product.
+    template<class GlobalIndex, class LocalIndex>
+    class FusedDotProducts<Dune::OwnerOverlapCopyCommunication<GlobalIndex, LocalIndex> >
+    {
+        typedef Dune::OwnerOverlapCopyCommunication<GlobalIndex, LocalIndex> Communication;
+    public:
+        explicit FusedDotProducts(const Communication& comm)
+            : comm_(comm)
+        {}
+
+        template<class X, std::size_t n>
+        std::array<double, n> compute(const std::array<std::pair<const X*, const X*>, n>& pairs) const
+        {
+            const auto& mask = ownerMask(pairs[0].first->size());
+            std::array<double, n> result;
+            for ( std::size_t i = 0; i < n; ++i )
+            {
+                result[i] = localDot(*pairs[i].first, *pairs[i].second, &mask);
+            }
+            comm_.communicator().sum(result.data(), n);
+            return result;
+        }
+
+        /// \brief Computes any number of dot products with one global reduction.
+        template<class X>
+        std::vector<double> compute(const std::vector<std::pair<const X*, const X*> >& pairs) const
+        {
+            std::vector<double> result(pairs.size());
+            if ( pairs.empty() )
+            {
+                return result;
+            }
+            const auto& mask = ownerMask(pairs[0].first->size());
+            for ( std::size_t i = 0; i < pairs.size(); ++i )
+            {
+                result[i] = localDot(*pairs[i].first, *pairs[i].second, &mask);
+            }
+            comm_.communicator().sum(result.data(), result.size());
+            return result;
+        }
+
+    private:
+        const std::vector<double>& ownerMask(std::size_t size) const
+        {
+            if ( mask_.size() != size )
+            {
+                mask_.assign(size, 1.0);
+                for ( const auto& index : comm_.indexSet() )
+                {
+                    if ( index.local().attribute() != Dune::OwnerOverlapCopyAttributeSet::owner )
+                    {
+                        mask_[index.local().local()] = 0.0;
+                    }
+                }
+            }
+            return mask_;
+        }
+
+        const Communication& comm_;
+        mutable std::vector<double> mask_;
+    };
+#endif
+} // end namespace Detail
+
+/// \brief BiCGSTAB with fewer global reductions per iteration.
+///
+/// The standard BiCGSTAB of dune-istl needs four to five dot products per
+/// iteration, each one being a blocking global reduction in parallel runs.
+/// This variant computes the dot products needed for omega, the next rho and
+/// the residual norm together, leaving two global reductions per iteration.
+/// The residual norm is obtained from the recurrence
+/// \f$\|s - \omega t\|^2 = (s,s) - 2\omega(t,s) + \omega^2(t,t)\f$ and only
+/// recomputed directly to confirm convergence.
+/// In exact arithmetic the iterates are the ones of the standard BiCGSTAB.
+/// \tparam X The vector type.
+/// \tparam Communication The type of the parallel information.
+template<class X, class Communication>
+class FusedBiCGSTABSolver
+    : public Dune::InverseOperator<X,X>
+{
+public:
+    typedef X domain_type;
+    typedef X range_type;
+    typedef typename X::field_type field_type;
+
+    /// \brief Constructor.
+    /// \param op The operator of the system.
+    /// \param prec The preconditioner.
+    /// \param comm The parallel information.
+    /// \param reduction The reduction of the residual norm to achieve.
+    /// \param maxit The maximum number of iterations.
+    /// \param verbose The verbosity level (0: none, 1: summary, 2: every iteration).
+    FusedBiCGSTABSolver(Dune::LinearOperator<X,X>& op, Dune::Preconditioner<X,X>& prec,
+                        const Communication& comm, double reduction, int maxit, int verbose)
+        : op_(op), prec_(prec), dots_(comm), reduction_(reduction), maxit_(maxit), verbose_(verbose)
+    {}
+
+#if DUNE_VERSION_NEWER(DUNE_ISTL, 2, 6)
+    Dune::SolverCategory::Category category() const override
+    {
+        return op_.category();
+    }
+#endif
+
+    virtual void apply(X& x, X& b, Dune::InverseOperatorResult& res)
+    {
+        apply(x, b, reduction_, res);
+    }
+
+    virtual void apply(X& x, X& b, double reduction, Dune::InverseOperatorResult& res)
+    {
+        typedef std::pair<const X*, const X*> Pair;
+        res.clear();
+        Dune::Timer watch;
+
+        X r(b);
+        op_.applyscaleadd(-1.0, x, r);
+        X r0(r);
+        X p(r);
+        X v(b.size()), phat(b.size()), s(b.size()), shat(b.size()), t(b.size());
+        v = 0.0;
+
+        prec_.pre(x, b);
+
+        auto initial = dots_.compute(std::array<Pair, 2>{{ Pair(&r0, &r), Pair(&r, &r) }});
+        double rho = initial[0];
+        const double def0 = std::sqrt(std::max(initial[1], 0.0));
+        double def = def0;
+
+        if ( verbose_ > 1 )
+        {
+            printDefect(0, def);
+        }
+
+        if ( def0 < 1e-30 )
+        {
+            res.converged = true;
+        }
+
+        const double tiny = std::numeric_limits<double>::min();
+        int it = 0;
+        for ( ; !res.converged && it < maxit_; )
+        {
+            ++it;
+            phat = 0.0;
+            prec_.apply(phat, p);
+            op_.apply(phat, v);
+
+            // first reduction
+            const double r0v = dots_.compute(std::array<Pair, 1>{{ Pair(&r0, &v) }})[0];
+            if ( std::abs(r0v) < tiny )
+            {
+                break;
+            }
+            const double alpha = rho / r0v;
+
+            s = r;
+            s.axpy(-alpha, v);
+            x.axpy(alpha, phat);
+
+            shat = 0.0;
+            prec_.apply(shat, s);
+            op_.apply(shat, t);
+
+            // second reduction: everything needed for omega, the next rho and the defect
+            auto d = dots_.compute(std::array<Pair, 5>{{ Pair(&t, &s), Pair(&t, &t), Pair(&r0, &s),
+                                                         Pair(&r0, &t), Pair(&s, &s) }});
+            const double ts = d[0], tt = d[1], r0s = d[2], r0t = d[3], ss = d[4];
+
+            if ( tt < tiny )
+            {
+                // s is (numerically) zero: x is the solution.
+                r = s;
+                def = std::sqrt(std::max(ss, 0.0));
+                res.converged = def <= reduction * def0;
+                break;
+            }
+
+            const double omega = ts / tt;
+            x.axpy(omega, shat);
+            r = s;
+            r.axpy(-omega, t);
+
+            const double rhoNew = r0s - omega * r0t;
+            def = std::sqrt(std::max(ss - 2.0 * omega * ts + omega * omega * tt, 0.0));
+
+            if ( def <= reduction * def0 )
+            {
+                // The recurrence may be inaccurate close to convergence. Confirm it.
+                def = std::sqrt(std::max(dots_.compute(std::array<Pair, 1>{{ Pair(&r, &r) }})[0], 0.0));
+                res.converged = def <= reduction * def0;
+            }
+
+            if ( verbose_ > 1 )
+            {
+                printDefect(it, def);
+            }
+
+            if ( res.converged || std::abs(omega) < tiny || std::abs(rho) < tiny )
+            {
+                break;
+            }
+
+            const double beta = (rhoNew / rho) * (alpha / omega);
+            rho = rhoNew;
+            p.axpy(-omega, v);
+            p *= beta;
+            p += r;
+        }
+
+        prec_.post(x);
+
+        res.iterations = it;
+        res.reduction = def0 > 0.0 ? def / def0 : 0.0;
+        res.conv_rate = it > 0 ? std::pow(res.reduction, 1.0 / it) : 0.0;
+        res.elapsed = watch.elapsed();
+
+        if ( verbose_ > 0 )
+        {
+            std::cout << "=== FusedBiCGSTABSolver " << (res.converged ? "converged" : "did not converge")
+                      << ": iterations " << res.iterations << ", reduction " << res.reduction
+                      << ", time " << res.elapsed << " s" << std::endl;
+        }
+    }
+
+private:
+    void printDefect(int it, double def) const
+    {
+        std::cout << std::setw(5) << it << "  " << std::scientific << std::setprecision(6)
+                  << def << std::defaultfloat << std::endl;
+    }
+
+    Dune::LinearOperator<X,X>& op_;
+    Dune::Preconditioner<X,X>& prec_;
+    Detail::FusedDotProducts<Communication> dots_;
+    double reduction_;
+    int maxit_;
+    int verbose_;
+};
+
+} // end namespace Opm
+
+#endif // OPM_FUSEDBICGSTABSOLVER_HEADER_INCLUDED
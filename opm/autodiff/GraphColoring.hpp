@@ -26,6 +26,7 @@
 #include <numeric>
 #include <queue>
 #include <cstddef>
+#include <cstdint>
 
 namespace Opm
 {
@@ -103,6 +104,16 @@ std::size_t breadthFirstSearch(const Graph& graph, typename Graph::VertexDescrip
     }
     return noVisited;
 }
+
+/// \brief A pseudo random but reproducible weight of a vertex.
+inline std::uint64_t vertexWeight(std::uint64_t vertex)
+{
+    // splitmix64 finalizer
+    std::uint64_t z = vertex + 0x9e3779b97f4a7c15ULL;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
 } // end namespace Detail
 
 
@@ -179,6 +190,116 @@ colorVerticesWelshPowell(const Graph& graph)
     return std::make_tuple(colors, color, verticesPerColor);
 }
 
+/// \brief Color the vertices of graph in parallel.
+///
+/// It uses the algorithm of Jones and Plassmann: In each round all
+/// uncolored vertices with a larger weight than all of their uncolored
+/// neighbours get the smallest color not used by their neighbours. These
+/// vertices are independent, hence the rounds are processed with OpenMP.
+/// The weights are pseudo random but fixed, so the coloring does not depend
+/// on the number of threads. It usually needs a few more colors than
+/// colorVerticesWelshPowell.
+/// \param graph The graph to color. Must adhere to the graph interface of dune-istl
+///              and use the vertex indices as descriptors.
+/// \return A tuple of a vector with the colors of the vertices, the number of colors
+///         assigned, and the number of vertices of each color.
+template<class Graph>
+std::tuple<std::vector<int>, int, std::vector<std::size_t> >
+colorVerticesJonesPlassmann(const Graph& graph)
+{
+    using Vertex = typename Graph::VertexDescriptor;
+    const std::size_t noVertices = graph.maxVertex() + 1;
+    std::vector<int> colors(noVertices, -1);
+    std::vector<std::uint64_t> weights(noVertices);
+    for ( std::size_t vertex = 0; vertex < noVertices; ++vertex )
+    {
+        weights[vertex] = Detail::vertexWeight(vertex);
+    }
+    auto heavier = [&weights](Vertex v1, Vertex v2)
+        {
+            return weights[v1] > weights[v2] || ( weights[v1] == weights[v2] && v1 > v2 );
+        };
+
+    std::vector<Vertex> uncolored;
+    uncolored.reserve(noVertices);
+    for( auto vertex: graph )
+    {
+        uncolored.push_back(vertex);
+    }
+    std::vector<char> selected(noVertices, false);
+
+    while ( !uncolored.empty() )
+    {
+        const std::ptrdiff_t noUncolored = uncolored.size();
+
+        // select the vertices heavier than all uncolored neighbours
+#if HAVE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif // HAVE_OPENMP
+        for ( std::ptrdiff_t i = 0; i < noUncolored; ++i )
+        {
+            const auto vertex = uncolored[i];
+            bool heaviest = true;
+            for ( auto edge = graph.beginEdges(vertex), endEdge = graph.endEdges(vertex);
+                  edge != endEdge && heaviest; ++edge )
+            {
+                const auto neighbour = edge.target();
+                heaviest = neighbour == vertex || colors[neighbour] >= 0 || heavier(vertex, neighbour);
+            }
+            selected[vertex] = heaviest;
+        }
+
+        // color them with the smallest color not used by a neighbour
+#if HAVE_OPENMP
+#pragma omp parallel
+#endif // HAVE_OPENMP
+        {
+            std::vector<char> used;
+#if HAVE_OPENMP
+#pragma omp for schedule(static)
+#endif // HAVE_OPENMP
+            for ( std::ptrdiff_t i = 0; i < noUncolored; ++i )
+            {
+                const auto vertex = uncolored[i];
+                if ( !selected[vertex] )
+                {
+                    continue;
+                }
+                used.assign(used.size(), false);
+                for ( auto edge = graph.beginEdges(vertex), endEdge = graph.endEdges(vertex);
+                      edge != endEdge; ++edge )
+                {
+                    const int color = colors[edge.target()];
+                    if ( color >= 0 )
+                    {
+                        if ( static_cast<std::size_t>(color) >= used.size() )
+                        {
+                            used.resize(color + 1, false);
+                        }
+                        used[color] = true;
+                    }
+                }
+                colors[vertex] = std::find(used.begin(), used.end(), false) - used.begin();
+            }
+        }
+
+        auto newEnd = std::remove_if(uncolored.begin(), uncolored.end(),
+                                     [&colors](const Vertex& vertex)
+                                     {
+                                         return colors[vertex] >= 0;
+                                     });
+        uncolored.erase(newEnd, uncolored.end());
+    }
+
+    const int noColors = noVertices > 0 ? *std::max_element(colors.begin(), colors.end()) + 1 : 0;
+    std::vector<std::size_t> verticesPerColor(noColors, 0);
+    for ( const auto color: colors )
+    {
+        ++verticesPerColor[color];
+    }
+    return std::make_tuple(colors, noColors, verticesPerColor);
+}
+
 /// \! Reorder colored graph preserving order of vertices with the same color.
 template<class Graph>
 std::vector<std::size_t>
@@ -241,5 +362,82 @@ reorderVerticesSpheres(const std::vector<int>& colors, int noColors,
     }
     return indices;
 }
+
+/// \brief Reorder the vertices with the reverse Cuthill-McKee algorithm.
+///
+/// Each connected component is numbered in breadth first order starting from
+/// a vertex of minimum degree, visiting the neighbours by increasing degree.
+/// Reversing this numbering reduces the bandwidth and profile of the matrix,
+/// which improves the cache locality of the triangular solves and of SpMV.
+/// \param graph The graph to reorder. Must adhere to the graph interface of dune-istl.
+/// \return A vector with the new index of each vertex.
+template<class Graph>
+std::vector<std::size_t>
+reorderVerticesReverseCuthillMcKee(const Graph& graph)
+{
+    using Vertex = typename Graph::VertexDescriptor;
+    const std::size_t noVertices = graph.maxVertex() + 1;
+    std::vector<std::size_t> degree(noVertices, 0);
+    std::vector<Vertex> byDegree;
+    byDegree.reserve(noVertices);
+
+    for( auto vertex: graph )
+    {
+        for( auto edge = graph.beginEdges(vertex), endEdge = graph.endEdges(vertex);
+             edge != endEdge; ++edge )
+        {
+            if ( edge.target() != vertex )
+            {
+                ++degree[vertex];
+            }
+        }
+        byDegree.push_back(vertex);
+    }
+
+    auto lessDegree = [&degree](const Vertex& v1, const Vertex& v2)
+        {
+            return degree[v1] < degree[v2];
+        };
+    std::stable_sort(byDegree.begin(), byDegree.end(), lessDegree);
+
+    std::vector<Vertex> order;
+    order.reserve(noVertices);
+    std::vector<char> visited(noVertices, false);
+    std::vector<Vertex> neighbours;
+
+    for( auto start: byDegree )
+    {
+        if ( visited[start] )
+        {
+            continue;
+        }
+        visited[start] = true;
+        order.push_back(start);
+
+        for( std::size_t head = order.size() - 1; head < order.size(); ++head )
+        {
+            const auto current = order[head];
+            neighbours.clear();
+            for( auto edge = graph.beginEdges(current), endEdge = graph.endEdges(current);
+                 edge != endEdge; ++edge )
+            {
+                if ( ! visited[edge.target()] )
+                {
+                    visited[edge.target()] = true;
+                    neighbours.push_back(edge.target());
+                }
+            }
+            std::stable_sort(neighbours.begin(), neighbours.end(), lessDegree);
+            order.insert(order.end(), neighbours.begin(), neighbours.end());
+        }
+    }
+
+    std::vector<std::size_t> indices(noVertices);
+    for( std::size_t i = 0; i < order.size(); ++i )
+    {
+        indices[order[i]] = order.size() - 1 - i;
+    }
+    return indices;
+}
 } // end namespace Opm
 #endif
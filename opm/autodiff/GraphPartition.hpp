@@ -0,0 +1,240 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_GRAPHPARTITION_HEADER_INCLUDED
+#define OPM_GRAPHPARTITION_HEADER_INCLUDED
+
+#include <opm/common/ErrorMacros.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace Opm
+{
+
+/// \brief Split the rows of a matrix into parts of nearly equal size along
+///        the graph of its sparsity pattern.
+///
+/// The rows are numbered by a breadth-first search, starting at the first
+/// row of each connected component, and consecutive ranges of this order
+/// form the parts. A part therefore consists of a few layers of neighbouring
+/// cells. The cuts are not as small as those of a graph partitioner like
+/// Zoltan or METIS, but the search is cheap and the parts do not depend on
+/// the number of processes or threads.
+/// \param A The matrix. Its sparsity pattern has to be symmetric.
+/// \param numParts The number of parts. Parts are empty if it exceeds A.N().
+/// \return The part of each row.
+template<class Matrix>
+std::vector<int> partitionMatrixGraph(const Matrix& A, const int numParts)
+{
+    if ( numParts < 1 )
+    {
+        OPM_THROW(std::logic_error, "The number of parts has to be positive");
+    }
+    const std::size_t n = A.N();
+    std::vector<std::size_t> order;
+    order.reserve(n);
+    std::vector<char> visited(n, 0);
+    for ( std::size_t seed = 0; seed < n; ++seed )
+    {
+        if ( visited[seed] )
+        {
+            continue;
+        }
+        visited[seed] = 1;
+        order.push_back(seed);
+        for ( std::size_t head = order.size() - 1; head < order.size(); ++head )
+        {
+            const auto& row = A[order[head]];
+            for ( auto col = row.begin(), colEnd = row.end(); col != colEnd; ++col )
+            {
+                if ( !visited[col.index()] )
+                {
+                    visited[col.index()] = 1;
+                    order.push_back(col.index());
+                }
+            }
+        }
+    }
+
+    std::vector<int> part(n);
+    for ( std::size_t i = 0; i < n; ++i )
+    {
+        part[order[i]] = static_cast<int>(i * numParts / n);
+    }
+    return part;
+}
+
+/// \brief The estimated cost of the cells of a model, used as the weights
+///        of a balanced partition.
+///
+/// A cell costs one unit, plus phaseCost for each phase present beyond the
+/// first, since the flash and the PVT evaluations of cells with several
+/// phases are more expensive, plus perforationCost for each perforation.
+/// If a profile of the measured cost of the cells is given, e.g. from a
+/// previous run, the estimate is scaled by it relative to its mean.
+struct CellCostModel
+{
+    double phaseCost = 0.5;
+    double perforationCost = 4.0;
+
+    /// \param phasesPresent The number of phases present in each cell.
+    /// \param perforations The number of perforations in each cell, or empty.
+    /// \param profile The measured cost of each cell, or empty.
+    /// \return The weight of each cell.
+    std::vector<double> weights(const std::vector<int>& phasesPresent,
+                                const std::vector<int>& perforations,
+                                const std::vector<double>& profile) const
+    {
+        const std::size_t n = phasesPresent.size();
+        if ( (!perforations.empty() && perforations.size() != n)
+             || (!profile.empty() && profile.size() != n) )
+        {
+            OPM_THROW(std::logic_error, "The cost data of the cells have different sizes");
+        }
+        const double profileMean = profile.empty() ? 1.0
+            : std::accumulate(profile.begin(), profile.end(), 0.0) / n;
+
+        std::vector<double> weight(n);
+        for ( std::size_t i = 0; i < n; ++i )
+        {
+            weight[i] = 1.0 + phaseCost * std::max(phasesPresent[i] - 1, 0);
+            if ( !perforations.empty() )
+            {
+                weight[i] += perforationCost * perforations[i];
+            }
+            if ( !profile.empty() && profileMean > 0.0 )
+            {
+                weight[i] *= profile[i] / profileMean;
+            }
+        }
+        return weight;
+    }
+};
+
+/// \brief Split the rows of a matrix into connected parts of nearly equal
+///        weight, cutting preferably through weak connections.
+///
+/// The parts are grown one after the other. A part starts at the strongest
+/// connection left by the previous part, or at the first row not in a part,
+/// and adds the row with the strongest connection to it until it has its
+/// share of the remaining weight. With the transmissibilities as the
+/// connection strengths, the strongly coupled cells of e.g. a high
+/// permeability layer stay in one part.
+/// \param A The matrix. Its sparsity pattern has to be symmetric.
+/// \param numParts The number of parts. Parts may be empty if it exceeds A.N().
+/// \param rowWeights The positive weight of each row.
+/// \param connection connection(i, j) returns the strength of the connection of rows i and j.
+/// \return The part of each row.
+template<class Matrix, class Connection>
+std::vector<int> partitionWeightedMatrixGraph(const Matrix& A, const int numParts,
+                                              const std::vector<double>& rowWeights,
+                                              const Connection& connection)
+{
+    if ( numParts < 1 )
+    {
+        OPM_THROW(std::logic_error, "The number of parts has to be positive");
+    }
+    const std::size_t n = A.N();
+    if ( rowWeights.size() != n )
+    {
+        OPM_THROW(std::logic_error, "Expected " << n << " row weights, got " << rowWeights.size());
+    }
+
+    typedef std::pair<double, std::size_t> Candidate;
+    std::vector<int> part(n, -1);
+    std::priority_queue<Candidate> frontier;
+    std::size_t nextSeed = 0;
+    double remaining = std::accumulate(rowWeights.begin(), rowWeights.end(), 0.0);
+
+    for ( int p = 0; p < numParts - 1; ++p )
+    {
+        const double target = remaining / (numParts - p);
+        double weight = 0.0;
+        // continue at the strongest connection out of the previous parts
+        std::priority_queue<Candidate> candidates;
+        while ( !frontier.empty() && part[frontier.top().second] >= 0 )
+        {
+            frontier.pop();
+        }
+        if ( !frontier.empty() )
+        {
+            candidates.push(Candidate(std::numeric_limits<double>::infinity(), frontier.top().second));
+        }
+        while ( weight < target )
+        {
+            while ( !candidates.empty() && part[candidates.top().second] >= 0 )
+            {
+                candidates.pop();
+            }
+            if ( candidates.empty() )
+            {
+                // the part continues in another connected component
+                while ( nextSeed < n && part[nextSeed] >= 0 )
+                {
+                    ++nextSeed;
+                }
+                if ( nextSeed == n )
+                {
+                    break;
+                }
+                candidates.push(Candidate(std::numeric_limits<double>::infinity(), nextSeed));
+            }
+            const std::size_t row = candidates.top().second;
+            // stop if the row takes the part further from its share than without it
+            if ( weight > 0.0 && weight + rowWeights[row] - target > target - weight )
+            {
+                break;
+            }
+            candidates.pop();
+            part[row] = p;
+            weight += rowWeights[row];
+            const auto& rowEntries = A[row];
+            for ( auto col = rowEntries.begin(), colEnd = rowEntries.end(); col != colEnd; ++col )
+            {
+                if ( part[col.index()] < 0 )
+                {
+                    candidates.push(Candidate(connection(row, col.index()), col.index()));
+                }
+            }
+        }
+        remaining -= weight;
+        frontier = std::move(candidates);
+    }
+
+    // the last part gets the rest
+    for ( auto& p : part )
+    {
+        if ( p < 0 )
+        {
+            p = numParts - 1;
+        }
+    }
+    return part;
+}
+
+} // end namespace Opm
+
+#endif // OPM_GRAPHPARTITION_HEADER_INCLUDED
@@ -23,17 +23,29 @@
 #include <opm/autodiff/MatrixBlock.hpp>
 #include <opm/autodiff/BlackoilAmg.hpp>
 #include <opm/autodiff/CPRPreconditioner.hpp>
+#include <opm/autodiff/EnsembleSolver.hpp>
+#include <opm/autodiff/FusedBiCGSTABSolver.hpp>
+#include <opm/autodiff/LinearSolverAutoTuner.hpp>
+#include <opm/autodiff/LinearSolverFallback.hpp>
+#include <opm/autodiff/RecyclingGCRSolver.hpp>
+#include <opm/autodiff/MixedPrecisionPreconditioner.hpp>
 #include <opm/autodiff/MPIUtilities.hpp>
 #include <opm/autodiff/ParallelRestrictedAdditiveSchwarz.hpp>
+#include <opm/autodiff/RestrictedAdditiveSchwarz.hpp>
+#include <opm/autodiff/SparseDirectSolver.hpp>
 #include <opm/autodiff/ParallelOverlappingILU0.hpp>
+#include <opm/autodiff/PartitionedPreconditioner.hpp>
+#include <opm/autodiff/TimingRegistry.hpp>
 
 #include <opm/common/Exceptions.hpp>
+#include <opm/common/OpmLog/OpmLog.hpp>
 #include <opm/core/linalg/ParallelIstlInformation.hpp>
 #include <opm/common/utility/platform_dependent/disable_warnings.h>
 
 #include <ewoms/common/parametersystem.hh>
 #include <ewoms/common/propertysystem.hh>
 
+#include <dune/common/timer.hh>
 #include <dune/istl/scalarproducts.hh>
 #include <dune/istl/operators.hh>
 #include <dune/istl/preconditioners.hh>
@@ -43,6 +55,8 @@
 
 #include <opm/common/utility/platform_dependent/reenable_warnings.h>
 
+#include <sstream>
+
 BEGIN_PROPERTIES
 
 NEW_TYPE_TAG(FlowIstlSolver, INHERITS_FROM(FlowIstlSolverParams));
@@ -76,6 +90,12 @@ namespace Opm
         typedef typename SparseMatrixAdapter::IstlMatrix Matrix;
 
         enum { pressureIndex = Indices::pressureSwitchIdx };
+        /// \brief The number of flow equations, the first ones of each cell.
+        enum { numFlowEq = Indices::numPhases };
+        /// \brief Whether there are equations besides the flow (polymer, solvent, energy).
+        typedef std::integral_constant<bool, (numFlowEq < Matrix::block_type::rows)> HasExtraEquations;
+        /// \brief The number of systems solved together by solveEnsemble().
+        enum { ensembleLanes = 4 };
 
     public:
         typedef Dune::AssembledLinearOperator< Matrix, Vector, Vector > AssembledLinearOperatorType;
@@ -90,10 +110,43 @@ namespace Opm
         ///                                with dune-istl the information about the parallelization.
         ISTLSolverEbos(const boost::any& parallelInformation_arg=boost::any())
             : iterations_( 0 )
+            , setupIterations_( 0 )
+            , preconditionerNonzeroes_( 0 )
+            , stepSize_( 0.0 )
+            , setupStepSize_( 0.0 )
+            , rebuildPreconditioner_( true )
+            , preconditionerReused_( false )
+            , keepPreconditioner_( false )
+            , reuseKeptPreconditioner_( false )
+            , keptNonzeroes_( 0 )
+            , impesWeights_( nullptr )
+            , tunedCandidate_( 0 )
             , parallelInformation_(parallelInformation_arg)
             , isIORank_(isIORank(parallelInformation_arg))
         {
             parameters_.template init<TypeTag>();
+            reduction_ = parameters_.linear_solver_reduction_;
+            TimingRegistry::instance().setEnabled(parameters_.linear_solver_timing_);
+#if FLOW_SUPPORT_AMG
+            const bool includeCpr = true;
+#else
+            const bool includeCpr = false;
+#endif
+            if ( parameters_.linear_solver_auto_tune_ )
+            {
+                autoTuner_.reset(new LinearSolverAutoTuner(parameters_, parameters_.linear_solver_auto_tune_solves_,
+                                                           includeCpr));
+                tunedCandidate_ = autoTuner_->current();
+            }
+            if ( ! parameters_.linear_solver_fallback_.empty() )
+            {
+                fallback_.reset(new LinearSolverFallback(parameters_, parameters_.linear_solver_fallback_,
+                                                         includeCpr));
+                if ( fallback_->empty() )
+                {
+                    fallback_.reset();
+                }
+            }
         }
 
         const FlowLinearSolverParameters& parameters() const
@@ -111,6 +164,138 @@ namespace Opm
         /// \copydoc NewtonIterationBlackoilInterface::parallelInformation
         const boost::any& parallelInformation() const { return parallelInformation_; }
 
+#if HAVE_MPI
+        /// \brief The communication of the parallel solves for vectors of the given size.
+        ///
+        /// The index sets and remote indices only depend on the cells of the
+        /// process, not on the sparsity pattern of the matrix. Hence they are set
+        /// up once and kept for the whole simulation; only a different number
+        /// of rows rebuilds them.
+        Dune::OwnerOverlapCopyCommunication<int,int>& parallelCommunication(const std::size_t size) const
+        {
+            if ( ! parallelComm_ || parallelCommSize_ != size )
+            {
+                const ParallelISTLInformation& info =
+                    boost::any_cast<const ParallelISTLInformation&>( parallelInformation_);
+                // The preconditioner kept between solves refers to the old communication.
+                reusablePreconditioner_.reset();
+                rebuildPreconditioner_ = true;
+                parallelComm_.reset(new Dune::OwnerOverlapCopyCommunication<int,int>(info.communicator()));
+                info.copyValuesTo(parallelComm_->indexSet(), parallelComm_->remoteIndices(),
+                                  size, 1);
+                parallelCommSize_ = size;
+            }
+            return *parallelComm_;
+        }
+#endif
+
+        typedef std::vector<std::pair<int, std::vector<int> > > OverlapRows;
+
+        /// \brief The rows of the overlap cells with their columns, kept for the
+        ///        whole simulation.
+        /// \param compute Functor filling the rows, only called the first time.
+        template <class Compute>
+        const OverlapRows& overlapRowsAndColumns(const Compute& compute) const
+        {
+            if ( ! overlapRowsComputed_ )
+            {
+                compute(overlapRows_);
+                overlapRowsComputed_ = true;
+            }
+            return overlapRows_;
+        }
+
+        /// \brief Force a full setup of the CPR preconditioner for the next solve.
+        ///
+        /// Only has an effect if the setup of the CPR preconditioner is reused
+        /// between solves (cpr_reuse_setup_).
+        void invalidatePreconditioner() const { rebuildPreconditioner_ = true; }
+
+        /// \brief Whether the last solve reused the setup of the preconditioner
+        ///        of a previous solve instead of doing a full setup.
+        bool preconditionerReused() const { return preconditionerReused_; }
+
+        /// \brief Keep the ILU preconditioner of the sequential solves for
+        ///        reuseKeptPreconditioner().
+        ///
+        /// Costs the memory of the factorization between the solves.
+        void keepPreconditioner(bool keep) const
+        {
+            keepPreconditioner_ = keep;
+            if ( ! keep )
+            {
+                keptPreconditioner_.reset();
+            }
+        }
+
+        /// \brief Use the preconditioner of the last solve without any setup in the next solve.
+        ///
+        /// Meant for a matrix which did not change since the last solve, e.g. in
+        /// the chord iterations of the Newton method. Only the kept ILU
+        /// preconditioner (keepPreconditioner()) and the reused CPR preconditioner
+        /// (cpr_reuse_setup_) skip their setup, the other ones are set up as usual.
+        void reuseKeptPreconditioner() const { reuseKeptPreconditioner_ = true; }
+
+        /// \brief Set the size of the time step of the next solves.
+        ///
+        /// The structure of the system does not depend on it, hence a reused CPR
+        /// preconditioner is kept over time steps of the same report step, as
+        /// long as the step size does not grow by more than cpr_reuse_max_step_growth_
+        /// since its last full setup.
+        void setTimeStepSize(double dt) const { stepSize_ = dt; }
+
+        /// \brief Set the reduction of the residual to achieve in the next solves.
+        ///
+        /// Used to adapt the tolerance to the convergence of the Newton method.
+        /// The initial value is linear_solver_reduction_.
+        void setReduction(double reduction) const { reduction_ = reduction; }
+
+        /// \brief Set the true-IMPES weights used to decouple the pressure equation of CPR.
+        ///
+        /// nullptr uses the quasi-IMPES weights. A reused CPR preconditioner
+        /// reads the current entries of the weights at each update, so they
+        /// have to outlive it.
+        void setImpesWeights(const Vector* weights) const { impesWeights_ = weights; }
+
+        /// \brief Whether the operator should exchange the ghost values of its input
+        ///        while multiplying the interior rows.
+        ///
+        /// Only done for the (parallel) ILU preconditioner, which then leaves
+        /// the ghost values of its result alone.
+        bool overlapHaloExchange() const
+        {
+            return parameters_.linear_solver_overlap_halo_exchange_
+                && !parameters_.linear_solver_use_amg_ && !parameters_.use_cpr_
+                && !parameters_.ilu_single_precision_ && !parameters_.use_ras_
+                && !partitionedSolve();
+        }
+
+        /// \brief Whether a sparse direct factorization is used as the preconditioner
+        ///        (see linear_solver_direct_max_cells_).
+        bool directSolve(std::size_t numCells) const
+        {
+#if HAVE_UMFPACK
+#if HAVE_MPI
+            if ( parallelInformation_.type() == typeid(ParallelISTLInformation) )
+            {
+                return false;
+            }
+#endif
+            return parameters_.linear_solver_direct_max_cells_ > 0
+                && numCells <= static_cast<std::size_t>(parameters_.linear_solver_direct_max_cells_);
+#else
+            static_cast<void>(numCells);
+            return false;
+#endif
+        }
+
+        /// \brief Whether the flow equations are preconditioned separately
+        ///        from the other equations (see PartitionedPreconditioner).
+        bool partitionedSolve() const
+        {
+            return parameters_.linear_solver_partitioned_ && HasExtraEquations::value;
+        }
+
     public:
         /// \brief construct the CPR preconditioner and the solver.
         /// \tparam P The type of the parallel information.
@@ -138,6 +323,32 @@ namespace Opm
             // Communicate if parallel.
             parallelInformation_arg.copyOwnerToAll(istlb, istlb);
 
+            // Only the reused CPR preconditioner and the kept ILU can skip the full setup.
+            preconditionerReused_ = false;
+            const bool reuseKept = reuseKeptPreconditioner_;
+            reuseKeptPreconditioner_ = false;
+
+#if HAVE_UMFPACK
+            if ( directSolve(linearOperator.getmat().N()) )
+            {
+                // Factorize, reusing the symbolic factorization of the last solve.
+                auto& precond = constructDirectPrecond(linearOperator, parallelInformation_arg);
+
+                // Solve.
+                solve(linearOperator, x, istlb, *sp, precond, parallelInformation_arg, result);
+            }
+            else
+#endif
+            if ( partitionedSolve() )
+            {
+                // Construct preconditioner.
+                auto precond = constructPartitionedPrecond(linearOperator, parallelInformation_arg,
+                                                           HasExtraEquations());
+
+                // Solve.
+                solve(linearOperator, x, istlb, *sp, *precond, parallelInformation_arg, result);
+            }
+            else
 #if FLOW_SUPPORT_AMG // activate AMG if either flow_ebos is used or UMFPack is not available
             if( parameters_.linear_solver_use_amg_ || parameters_.use_cpr_)
             {
@@ -163,13 +374,20 @@ namespace Opm
                     using AMG = typename ISTLUtility
                         ::BlackoilAmgSelector< Matrix, Vector, Vector,POrComm, Criterion, pressureIndex >::AMG;
 
-                    std::unique_ptr< AMG > amg;
-                    // Construct preconditioner.
-                    Criterion crit(15, 2000);
-                    constructAMGPrecond<Criterion>( linearOperator, parallelInformation_arg, amg, opA, relax, ilu_milu );
+                    if ( parameters_.cpr_reuse_setup_ )
+                    {
+                        solveReusingCpr<AMG, Criterion>( linearOperator, x, istlb, *sp, parallelInformation_arg,
+                                                         opA, relax, ilu_milu, reuseKept, result );
+                    }
+                    else
+                    {
+                        std::unique_ptr< AMG > amg;
+                        // Construct preconditioner.
+                        constructAMGPrecond<Criterion>( linearOperator, parallelInformation_arg, amg, opA, relax, ilu_milu );
 
-                    // Solve.
-                    solve(linearOperator, x, istlb, *sp, *amg, result);
+                        // Solve.
+                        solve(linearOperator, x, istlb, *sp, *amg, parallelInformation_arg, result);
+                    }
                 }
                 else
                 {
@@ -180,20 +398,78 @@ namespace Opm
                     constructAMGPrecond( linearOperator, parallelInformation_arg, amg, opA, relax, ilu_milu );
 
                     // Solve.
-                    solve(linearOperator, x, istlb, *sp, *amg, result);
+                    solve(linearOperator, x, istlb, *sp, *amg, parallelInformation_arg, result);
                 }
             }
             else
 #endif
+            if ( parameters_.use_ras_ )
             {
                 // Construct preconditioner.
-                auto precond = constructPrecond(linearOperator, parallelInformation_arg);
+                auto precond = constructRasPrecond(linearOperator, parallelInformation_arg);
 
                 // Solve.
-                solve(linearOperator, x, istlb, *sp, *precond, result);
+                solve(linearOperator, x, istlb, *sp, *precond, parallelInformation_arg, result);
+            }
+            else if ( parameters_.ilu_single_precision_ )
+            {
+                // Construct preconditioner.
+                auto precond = constructSinglePrecisionPrecond(linearOperator, parallelInformation_arg);
+
+                // Solve.
+                solve(linearOperator, x, istlb, *sp, *precond, parallelInformation_arg, result);
+            }
+            else
+            {
+                const bool keep = keepPreconditioner_
+                    && std::is_same<POrComm, Dune::Amg::SequentialInformation>::value;
+                const auto nonzeroes = linearOperator.getmat().nonzeroes();
+                if ( keep && reuseKept && keptPreconditioner_ && nonzeroes == keptNonzeroes_ )
+                {
+                    preconditionerReused_ = true;
+                    solve(linearOperator, x, istlb, *sp, *keptPreconditioner_, parallelInformation_arg, result);
+                }
+                else
+                {
+                    // Construct preconditioner.
+                    auto precond = constructPrecond(linearOperator, parallelInformation_arg);
+
+                    // Solve.
+                    solve(linearOperator, x, istlb, *sp, *precond, parallelInformation_arg, result);
+
+                    if ( keep )
+                    {
+                        keptPreconditioner_ = std::move(precond);
+                        keptNonzeroes_ = nonzeroes;
+                    }
+                }
+            }
+        }
+
+
+#if HAVE_UMFPACK
+        typedef SparseDirectSolver<Matrix, Vector> DirectSolver;
+
+        template <class Operator>
+        DirectSolver& constructDirectPrecond(Operator& opA, const Dune::Amg::SequentialInformation&) const
+        {
+            static auto& timing = TimingRegistry::instance().entry("linsolve.precond_setup");
+            ScopedTiming scopedTiming(timing);
+
+            if ( ! directSolver_ )
+            {
+                directSolver_.reset(new DirectSolver());
             }
+            directSolver_->update(opA.getmat());
+            return *directSolver_;
         }
 
+        template <class Operator, class POrComm>
+        DirectSolver& constructDirectPrecond(Operator&, const POrComm&) const
+        {
+            OPM_THROW(std::logic_error, "The direct solver is only available for sequential runs");
+        }
+#endif
 
 	// 3x3 matrix block inversion was unstable at least 2.3 until and including
 	// 2.5.0. There may still be some issue with the 4x4 matrix block inversion
@@ -207,15 +483,51 @@ namespace Opm
         template <class Operator>
         std::unique_ptr<SeqPreconditioner> constructPrecond(Operator& opA, const Dune::Amg::SequentialInformation&) const
         {
+            static auto& timing = TimingRegistry::instance().entry("linsolve.precond_setup");
+            ScopedTiming scopedTiming(timing);
+
             const double relax   = parameters_.ilu_relaxation_;
             const int ilu_fillin = parameters_.ilu_fillin_level_;
             const MILU_VARIANT ilu_milu  = parameters_.ilu_milu_;
             const bool ilu_redblack = parameters_.ilu_redblack_;
             const bool ilu_reorder_spheres = parameters_.ilu_reorder_sphere_;
-            std::unique_ptr<SeqPreconditioner> precond(new SeqPreconditioner(opA.getmat(), ilu_fillin, relax, ilu_milu, ilu_redblack, ilu_reorder_spheres));
+            const bool ilu_reorder_rcm = parameters_.ilu_reorder_rcm_;
+            std::unique_ptr<SeqPreconditioner> precond(new SeqPreconditioner(opA.getmat(), ilu_fillin, relax, ilu_milu, ilu_redblack, ilu_reorder_spheres,
+                                                                             ilu_reorder_rcm));
             return precond;
         }
 
+        // The matrix and vector types used for the ILU in single precision.
+        typedef Dune::BCRSMatrix<Dune::MatrixBlock<float,
+                                                   Matrix::block_type::rows,
+                                                   Matrix::block_type::cols> > SinglePrecisionMatrix;
+        typedef Dune::BlockVector<Dune::FieldVector<float, Vector::block_type::dimension> > SinglePrecisionVector;
+        typedef ParallelOverlappingILU0<SinglePrecisionMatrix,
+                                        SinglePrecisionVector, SinglePrecisionVector> SeqSinglePrecisionILU;
+        typedef MixedPrecisionPreconditioner<Vector, Vector, SinglePrecisionMatrix,
+                                             SeqSinglePrecisionILU> SeqSinglePrecisionPreconditioner;
+
+        template <class Operator>
+        std::unique_ptr<SeqSinglePrecisionPreconditioner>
+        constructSinglePrecisionPrecond(Operator& opA, const Dune::Amg::SequentialInformation&) const
+        {
+            static auto& timing = TimingRegistry::instance().entry("linsolve.precond_setup");
+            ScopedTiming scopedTiming(timing);
+
+            const double relax   = parameters_.ilu_relaxation_;
+            const int ilu_fillin = parameters_.ilu_fillin_level_;
+            const MILU_VARIANT ilu_milu  = parameters_.ilu_milu_;
+            const bool ilu_redblack = parameters_.ilu_redblack_;
+            const bool ilu_reorder_spheres = parameters_.ilu_reorder_sphere_;
+            const bool ilu_reorder_rcm = parameters_.ilu_reorder_rcm_;
+            auto createILU = [=](const SinglePrecisionMatrix& A)
+                {
+                    return std::unique_ptr<SeqSinglePrecisionILU>(new SeqSinglePrecisionILU(A, ilu_fillin, relax, ilu_milu,
+                                                                                           ilu_redblack, ilu_reorder_spheres, ilu_reorder_rcm));
+                };
+            return std::unique_ptr<SeqSinglePrecisionPreconditioner>(new SeqSinglePrecisionPreconditioner(opA.getmat(), createILU));
+        }
+
 #if HAVE_MPI
         typedef Dune::OwnerOverlapCopyCommunication<int, int> Comm;
 #if DUNE_VERSION_NEWER_REV(DUNE_ISTL, 2 , 5, 1)
@@ -232,19 +544,127 @@ namespace Opm
         std::unique_ptr<ParPreconditioner>
         constructPrecond(Operator& opA, const Comm& comm) const
         {
+            static auto& timing = TimingRegistry::instance().entry("linsolve.precond_setup");
+            ScopedTiming scopedTiming(timing);
+
             typedef std::unique_ptr<ParPreconditioner> Pointer;
             const double relax  = parameters_.ilu_relaxation_;
             const MILU_VARIANT ilu_milu  = parameters_.ilu_milu_;
             const bool ilu_redblack = parameters_.ilu_redblack_;
             const bool ilu_reorder_spheres = parameters_.ilu_reorder_sphere_;
-            return Pointer(new ParPreconditioner(opA.getmat(), comm, relax, ilu_milu, ilu_redblack, ilu_reorder_spheres));
+            const bool ilu_reorder_rcm = parameters_.ilu_reorder_rcm_;
+            Pointer precond(new ParPreconditioner(opA.getmat(), comm, relax, ilu_milu, ilu_redblack,
+                                                  ilu_reorder_spheres, ilu_reorder_rcm));
+            if ( exchangesInput(opA, 0) )
+            {
+                precond->setCopyResultToAll(false);
+            }
+            return precond;
+        }
+
+        typedef ParallelOverlappingILU0<SinglePrecisionMatrix, SinglePrecisionVector,
+                                        SinglePrecisionVector, Comm> ParSinglePrecisionILU;
+        typedef MixedPrecisionPreconditioner<Vector, Vector, SinglePrecisionMatrix,
+                                             ParSinglePrecisionILU> ParSinglePrecisionPreconditioner;
+
+        template <class Operator>
+        std::unique_ptr<ParSinglePrecisionPreconditioner>
+        constructSinglePrecisionPrecond(Operator& opA, const Comm& comm) const
+        {
+            static auto& timing = TimingRegistry::instance().entry("linsolve.precond_setup");
+            ScopedTiming scopedTiming(timing);
+
+            const double relax  = parameters_.ilu_relaxation_;
+            const MILU_VARIANT ilu_milu  = parameters_.ilu_milu_;
+            const bool ilu_redblack = parameters_.ilu_redblack_;
+            const bool ilu_reorder_spheres = parameters_.ilu_reorder_sphere_;
+            const bool ilu_reorder_rcm = parameters_.ilu_reorder_rcm_;
+            const Comm* commPtr = &comm;
+            auto createILU = [=](const SinglePrecisionMatrix& A)
+                {
+                    return std::unique_ptr<ParSinglePrecisionILU>(new ParSinglePrecisionILU(A, *commPtr, relax, ilu_milu,
+                                                                                           ilu_redblack, ilu_reorder_spheres, ilu_reorder_rcm));
+                };
+            return std::unique_ptr<ParSinglePrecisionPreconditioner>(new ParSinglePrecisionPreconditioner(opA.getmat(), createILU));
+        }
+#endif
+
+        template <class Operator, class POrComm>
+        std::unique_ptr< RestrictedAdditiveSchwarz<Matrix, Vector, POrComm> >
+        constructRasPrecond(Operator& opA, const POrComm& comm) const
+        {
+            static auto& timing = TimingRegistry::instance().entry("linsolve.precond_setup");
+            ScopedTiming scopedTiming(timing);
+
+            typedef RestrictedAdditiveSchwarz<Matrix, Vector, POrComm> Ras;
+            return std::unique_ptr<Ras>(new Ras(opA.getmat(), comm, parameters_.ras_overlap_,
+                                                convertString2RasLocalSolver(parameters_.ras_local_solver_),
+                                                parameters_.ilu_fillin_level_, parameters_.ilu_relaxation_,
+                                                parameters_.ilu_milu_));
         }
+
+        // The matrix type of the flow equations of the partitioned preconditioner.
+        typedef Dune::BCRSMatrix<Dune::MatrixBlock<typename Matrix::field_type,
+                                                   numFlowEq, numFlowEq> > FlowMatrix;
+
+        /// \brief Construct the preconditioner treating the flow equations with
+        ///        CPR (or ILU0) and the other equations with block Gauss-Seidel.
+        template <class LinearOperator, class POrComm>
+        std::unique_ptr< Dune::Preconditioner<Vector,Vector> >
+        constructPartitionedPrecond(LinearOperator& linearOperator, const POrComm& comm,
+                                    std::true_type) const
+        {
+            static auto& timing = TimingRegistry::instance().entry("linsolve.precond_setup");
+            ScopedTiming scopedTiming(timing);
+
+            typedef PartitionedPreconditioner<Matrix, Vector, FlowMatrix, POrComm> Partitioned;
+            typedef typename Partitioned::FlowOperator FlowOperator;
+            typedef typename Partitioned::FlowVector FlowVector;
+            typedef typename Partitioned::FlowPreconditioner FlowPreconditioner;
+
+            const CPRParameter& param = parameters_;
+            const double relax = parameters_.ilu_relaxation_;
+            const MILU_VARIANT milu = parameters_.ilu_milu_;
+            const bool useCpr = parameters_.use_cpr_;
+            const POrComm* commPtr = &comm;
+            auto createFlowPreconditioner = [=, &param](FlowOperator& op)
+                -> std::unique_ptr<FlowPreconditioner>
+                {
+#if FLOW_SUPPORT_AMG
+                    if ( useCpr )
+                    {
+                        using CouplingMetric = Dune::Amg::Diagonal<pressureIndex>;
+                        using CritBase       = Dune::Amg::SymmetricCriterion<FlowMatrix, CouplingMetric>;
+                        using Criterion      = Dune::Amg::CoarsenCriterion<CritBase>;
+                        using AMG = typename ISTLUtility
+                            ::BlackoilAmgSelector< FlowMatrix, FlowVector, FlowVector, POrComm, Criterion, pressureIndex >::AMG;
+                        std::unique_ptr< AMG > amg;
+                        ISTLUtility::template createAMGPreconditionerPointer<Criterion>( op, relax, *commPtr, amg, param );
+                        return std::move(amg);
+                    }
+#else
+                    DUNE_UNUSED_PARAMETER(useCpr);
 #endif
+                    typedef ParallelOverlappingILU0<FlowMatrix, FlowVector, FlowVector, POrComm> FlowILU;
+                    return std::unique_ptr<FlowPreconditioner>(new FlowILU(op.getmat(), *commPtr, relax, milu));
+                };
+            return std::unique_ptr< Dune::Preconditioner<Vector,Vector> >(
+                new Partitioned(linearOperator.getmat(), comm, createFlowPreconditioner));
+        }
+
+        template <class LinearOperator, class POrComm>
+        std::unique_ptr< Dune::Preconditioner<Vector,Vector> >
+        constructPartitionedPrecond(LinearOperator&, const POrComm&, std::false_type) const
+        {
+            OPM_THROW(std::logic_error, "The partitioned preconditioner needs equations besides the flow equations");
+        }
 
         template <class LinearOperator, class MatrixOperator, class POrComm, class AMG >
         void
         constructAMGPrecond(LinearOperator& /* linearOperator */, const POrComm& comm, std::unique_ptr< AMG >& amg, std::unique_ptr< MatrixOperator >& opA, const double relax, const MILU_VARIANT milu) const
         {
+            static auto& timing = TimingRegistry::instance().entry("linsolve.precond_setup");
+            ScopedTiming scopedTiming(timing);
             ISTLUtility::template createAMGPreconditionerPointer<pressureIndex>( *opA, relax, milu, comm, amg );
         }
 
@@ -254,32 +674,127 @@ namespace Opm
         constructAMGPrecond(LinearOperator& /* linearOperator */, const POrComm& comm, std::unique_ptr< AMG >& amg, std::unique_ptr< MatrixOperator >& opA, const double relax,
                             const MILU_VARIANT milu ) const
         {
+            static auto& timing = TimingRegistry::instance().entry("linsolve.precond_setup");
+            ScopedTiming scopedTiming(timing);
+            const Vector* weights = impesWeights_ && impesWeights_->size() == opA->getmat().N() ?
+                impesWeights_ : nullptr;
             ISTLUtility::template createAMGPreconditionerPointer<C>( *opA, relax,
-                                                                     comm, amg, parameters_ );
+                                                                     comm, amg, parameters_, weights );
+            if ( parameters_.linear_solver_verbosity_ > 0 )
+            {
+                auto statistics = amg->hierarchyStatistics();
+                statistics.reduce(comm.communicator());
+                if ( isIORank_ )
+                {
+                    std::ostringstream ss;
+                    statistics.report(ss);
+                    OpmLog::info(ss.str());
+                }
+            }
         }
 
 
+        /// \brief Solve the system with the CPR preconditioner of the previous solve.
+        ///
+        /// Only the matrix entries of the preconditioner are updated.
+        /// A full setup is done if there is no preconditioner yet, a rebuild was
+        /// requested, the sparsity pattern changed, the time step size grew too much
+        /// since the last full setup, or the previous solve with an
+        /// updated preconditioner did not converge or needed more iterations than
+        /// the one after the last full setup. With keepMatrix the matrix is the one
+        /// of the last solve, hence not even the entries are updated.
+        template <class AMG, class Criterion, class LinearOperator, class MatrixOperator,
+                  class ScalarProd, class POrComm>
+        void solveReusingCpr(LinearOperator& linearOperator, Vector& x, Vector& istlb,
+                             ScalarProd& sp, const POrComm& comm,
+                             std::unique_ptr< MatrixOperator >& opA, const double relax,
+                             const MILU_VARIANT milu, const bool keepMatrix,
+                             Dune::InverseOperatorResult& result) const
+        {
+            AMG* amg = dynamic_cast<AMG*>(reusablePreconditioner_.get());
+            const auto nonzeroes = linearOperator.getmat().nonzeroes();
+            const double maxGrowth = parameters_.cpr_reuse_max_step_growth_;
+            const bool stepGrew = maxGrowth > 0.0 && stepSize_ > maxGrowth * setupStepSize_;
+            const bool update = amg && !rebuildPreconditioner_ && !stepGrew
+                && nonzeroes == preconditionerNonzeroes_;
+
+            // make sure that an exception during the solve triggers a full setup next time.
+            rebuildPreconditioner_ = true;
+
+            if ( update )
+            {
+                if ( ! keepMatrix )
+                {
+                    amg->updatePreconditioner(*opA);
+                }
+                preconditionerReused_ = true;
+            }
+            else
+            {
+                std::unique_ptr< AMG > newAmg;
+                constructAMGPrecond<Criterion>( linearOperator, comm, newAmg, opA, relax, milu );
+                amg = newAmg.get();
+                reusablePreconditioner_ = std::move(newAmg);
+                preconditionerNonzeroes_ = nonzeroes;
+                setupStepSize_ = stepSize_;
+            }
+
+            solve(linearOperator, x, istlb, sp, *amg, comm, result);
+
+            if ( ! update )
+            {
+                setupIterations_ = result.iterations;
+            }
+            rebuildPreconditioner_ = !result.converged || result.iterations > setupIterations_;
+        }
+
         /// \brief Solve the system using the given preconditioner and scalar product.
-        template <class Operator, class ScalarProd, class Precond>
-        void solve(Operator& opA, Vector& x, Vector& istlb, ScalarProd& sp, Precond& precond, Dune::InverseOperatorResult& result) const
+        template <class Operator, class ScalarProd, class Precond, class POrComm>
+        void solve(Operator& opA, Vector& x, Vector& istlb, ScalarProd& sp, Precond& precond,
+                   const POrComm& comm, Dune::InverseOperatorResult& result) const
         {
             // TODO: Revise when linear solvers interface opm-core is done
             // Construct linear solver.
             // GMRes solver
             int verbosity = ( isIORank_ ) ? parameters_.linear_solver_verbosity_ : 0;
 
-            if ( parameters_.newton_use_gmres_ ) {
+            static auto& timing = TimingRegistry::instance().entry("linsolve.krylov");
+            ScopedTiming scopedTiming(timing);
+
+            if ( parameters_.linear_solver_recycle_size_ > 0 ) {
+                // The recycled directions are kept over all solves of this solver.
+                if ( ! recycledSubspace_ )
+                {
+                    recycledSubspace_.reset(new RecycledSubspace<Vector>(parameters_.linear_solver_recycle_size_));
+                }
+                RecyclingGCRSolver<Vector, POrComm> linsolve(opA, precond, comm, *recycledSubspace_,
+                          reduction_,
+                          parameters_.linear_solver_restart_,
+                          parameters_.linear_solver_maxiter_,
+                          verbosity);
+                // Solve system.
+                linsolve.apply(x, istlb, result);
+            }
+            else if ( parameters_.newton_use_gmres_ ) {
                 Dune::RestartedGMResSolver<Vector> linsolve(opA, sp, precond,
-                          parameters_.linear_solver_reduction_,
+                          reduction_,
                           parameters_.linear_solver_restart_,
                           parameters_.linear_solver_maxiter_,
                           verbosity);
                 // Solve system.
                 linsolve.apply(x, istlb, result);
             }
+            else if ( parameters_.newton_use_fused_bicgstab_ ) {
+                FusedBiCGSTABSolver<Vector, POrComm> linsolve(opA, precond, comm,
+                          reduction_,
+                          parameters_.linear_solver_maxiter_,
+                          verbosity);
+                // Solve system.
+                linsolve.apply(x, istlb, result);
+            }
             else { // BiCGstab solver
                 Dune::BiCGSTABSolver<Vector> linsolve(opA, sp, precond,
-                          parameters_.linear_solver_reduction_,
+                          reduction_,
                           parameters_.linear_solver_maxiter_,
                           verbosity);
                 // Solve system.
@@ -301,9 +816,7 @@ namespace Opm
             if (parallelInformation_.type() == typeid(ParallelISTLInformation))
             {
                 typedef Dune::OwnerOverlapCopyCommunication<int,int> Comm;
-                const ParallelISTLInformation& info =
-                    boost::any_cast<const ParallelISTLInformation&>( parallelInformation_);
-                Comm istlComm(info.communicator());
+                Comm& istlComm = parallelCommunication(A.N());
 
                 // Construct operator, scalar product and vectors needed.
                 typedef Dune::OverlappingSchwarzOperator<Matrix, Vector, Vector,Comm> Operator;
@@ -319,6 +832,80 @@ namespace Opm
             }
         }
 
+        /// \brief Solve several systems with the same sparsity pattern together.
+        ///
+        /// Either one matrix is given for all right hand sides, or one matrix
+        /// per right hand side (e.g. the realizations of an ensemble on the
+        /// same grid). The systems are processed in groups of ensembleLanes
+        /// with interleaved values (see EnsembleMatrix), using BiCGSTAB with
+        /// ILU(0) for each of them. Only sequential runs are supported.
+        /// \param[in] matrices   the matrices, one or b.size()
+        /// \param[inout] x       the solutions, initialized with the initial guess
+        /// \param[in] b          the right hand sides
+        void solveEnsemble(const std::vector<const Matrix*>& matrices,
+                           std::vector<Vector>& x, const std::vector<Vector>& b) const
+        {
+#if HAVE_MPI
+            if ( parallelInformation_.type() == typeid(ParallelISTLInformation) )
+            {
+                OPM_THROW(std::logic_error, "solveEnsemble supports sequential runs only");
+            }
+#endif
+            if ( matrices.size() != 1 && matrices.size() != b.size() )
+            {
+                OPM_THROW(std::logic_error, "solveEnsemble needs one matrix or one matrix per right hand side");
+            }
+            typedef typename Vector::field_type Field;
+            static const int n = Vector::block_type::dimension;
+            typedef EnsembleMatrix<Field, n, ensembleLanes> LaneMatrix;
+            typedef EnsembleVector<Field, n, ensembleLanes> LaneVector;
+
+            x.resize(b.size());
+            int maxIterations = 0;
+            LaneMatrix A, ilu;
+            LaneVector laneX, laneB;
+            for ( std::size_t first = 0; first < b.size(); first += ensembleLanes )
+            {
+                // Avoid setting up the shared matrix again for the next group.
+                if ( matrices.size() > 1 || first == 0 )
+                {
+                    std::vector<const Matrix*> group;
+                    for ( std::size_t m = first; m < std::min(first + ensembleLanes, matrices.size()); ++m )
+                    {
+                        group.push_back(matrices[m]);
+                    }
+                    A.setup(group);
+                    ilu.iluDecomposition(group);
+                }
+                for ( std::size_t r = first; r < std::min(first + ensembleLanes, b.size()); ++r )
+                {
+                    if ( x[r].size() != b[r].size() )
+                    {
+                        x[r].resize(b[r].size());
+                        x[r] = 0.0;
+                    }
+                }
+                interleave<Field, n, ensembleLanes>(x, first, laneX);
+                interleave<Field, n, ensembleLanes>(b, first, laneB);
+
+                EnsembleBiCGSTAB<Field, n, ensembleLanes> linsolve(A, ilu, reduction_, parameters_.linear_solver_maxiter_);
+                const auto laneResult = linsolve.apply(laneX, laneB);
+                deinterleave<Field, n, ensembleLanes>(laneX, first, x);
+
+                for ( std::size_t r = first; r < std::min(first + ensembleLanes, b.size()); ++r )
+                {
+                    Dune::InverseOperatorResult result;
+                    result.iterations = laneResult.iterations[r - first];
+                    result.reduction = laneResult.reduction[r - first];
+                    result.converged = laneResult.converged[r - first];
+                    checkConvergence(result);
+                    maxIterations = std::max(maxIterations, result.iterations);
+                }
+            }
+            // report the largest number of iterations
+            iterations_ = maxIterations;
+        }
+
         /// Solve the linear system Ax = b, with A being the
         /// combined derivative matrix of the residual and b
         /// being the residual itself.
@@ -329,20 +916,43 @@ namespace Opm
         void solve(Operator& opA, Vector& x, Vector& b, Comm& comm) const
         {
             Dune::InverseOperatorResult result;
+            selectTunedParameters();
             // Parallel version is deactivated until we figure out how to do it properly.
 #if HAVE_MPI
             if (parallelInformation_.type() == typeid(ParallelISTLInformation))
             {
                 const size_t size = opA.getmat().N();
-                const ParallelISTLInformation& info =
-                    boost::any_cast<const ParallelISTLInformation&>( parallelInformation_);
+                auto& persistentComm = parallelCommunication(size);
+                if ( &comm != &persistentComm )
+                {
+                    // A communication set up by the caller for this solve only.
+                    // As we use a dune-istl with block size np the number of components
+                    // per parallel is only one.
+                    const ParallelISTLInformation& info =
+                        boost::any_cast<const ParallelISTLInformation&>( parallelInformation_);
+                    info.copyValuesTo(comm.indexSet(), comm.remoteIndices(),
+                                      size, 1);
+                }
 
-                // As we use a dune-istl with block size np the number of components
-                // per parallel is only one.
-                info.copyValuesTo(comm.indexSet(), comm.remoteIndices(),
-                                  size, 1);
-                // Construct operator, scalar product and vectors needed.
-                constructPreconditionerAndSolve<Dune::SolverCategory::overlapping>(opA, x, b, comm, result);
+                auto solveOnce = [&]( Dune::InverseOperatorResult& res )
+                {
+                    // The reused preconditioner stores a reference to the communication.
+                    // Hence it needs the one that lives as long as this solver.
+                    auto& solveComm = ( parameters_.use_cpr_ && parameters_.cpr_reuse_setup_ ) ? persistentComm : comm;
+                    constructPreconditionerAndSolve<Dune::SolverCategory::overlapping>(opA, x, b, solveComm, res);
+                    if ( exchangesInput(opA, 0) )
+                    {
+                        // The preconditioner did not update the ghost values.
+                        solveComm.copyOwnerToAll(x, x);
+                    }
+                };
+                const Vector rhs = fallback_ ? b : Vector();
+                solveOnce( result );
+                reportTunedSolve( result );
+                if ( fallback_ && !result.converged )
+                {
+                    solveFallbacks( x, b, rhs, size, result, solveOnce );
+                }
             }
             else
 #endif
@@ -363,12 +973,118 @@ namespace Opm
         void solve(Operator& opA, Vector& x, Vector& b ) const
         {
             Dune::InverseOperatorResult result;
+            selectTunedParameters();
             // Construct operator, scalar product and vectors needed.
-            Dune::Amg::SequentialInformation info;
-            constructPreconditionerAndSolve(opA, x, b, info, result);
+            // A member is used as the reused preconditioner keeps a reference to it.
+            auto solveOnce = [&]( Dune::InverseOperatorResult& res )
+            {
+                constructPreconditionerAndSolve(opA, x, b, sequentialInformation_, res);
+            };
+            const Vector rhs = fallback_ ? b : Vector();
+            solveOnce( result );
+            reportTunedSolve( result );
+            if ( fallback_ && !result.converged )
+            {
+                solveFallbacks( x, b, rhs, opA.getmat().N(), result, solveOnce );
+            }
             checkConvergence( result );
         }
 
+        /// \brief Solve the system again with the stages of the fallback chain
+        ///        (linear_solver_fallback_) until one of them converges.
+        ///
+        /// \param rhs The right hand side of the failed solve, which overwrote b.
+        /// \param numRows The number of rows of the matrix, to skip the direct
+        ///                solver if it is not available.
+        /// \param solveOnce Solves with the current parameters_.
+        template <class SolveOnce>
+        void solveFallbacks(Vector& x, Vector& b, const Vector& rhs, const std::size_t numRows,
+                            Dune::InverseOperatorResult& result, const SolveOnce& solveOnce) const
+        {
+            static auto& timing = TimingRegistry::instance().entry("linsolve.fallback");
+            ScopedTiming scopedTiming(timing);
+
+            const FlowLinearSolverParameters configured = parameters_;
+            // The next solve sets up the preconditioner of the configuration again.
+            auto restore = [&]()
+            {
+                parameters_ = configured;
+                rebuildPreconditioner_ = true;
+                keptPreconditioner_.reset();
+            };
+            try
+            {
+                for ( const auto& stage : fallback_->stages() )
+                {
+                    parameters_ = stage.parameters;
+                    if ( parameters_.linear_solver_direct_max_cells_ > 0 && !directSolve(numRows) )
+                    {
+                        continue;
+                    }
+                    if ( isIORank_ )
+                    {
+                        OpmLog::info("Linear solver did not converge in " + std::to_string(result.iterations)
+                                     + " iterations, trying the fallback " + stage.name);
+                    }
+                    x = 0.0;
+                    b = rhs;
+                    solveOnce( result );
+                    if ( result.converged )
+                    {
+                        break;
+                    }
+                }
+            }
+            catch (...)
+            {
+                restore();
+                throw;
+            }
+            restore();
+        }
+
+        /// \brief Whether the operator exchanges the ghost values of its input itself.
+        template <class Operator>
+        static auto exchangesInput(const Operator& opA, int) -> decltype(opA.exchangesInput())
+        {
+            return opA.exchangesInput();
+        }
+
+        template <class Operator>
+        static bool exchangesInput(const Operator&, long)
+        {
+            return false;
+        }
+
+        /// \brief Use the parameters of the candidate to measure next (or the
+        ///        selected one) if the configuration is auto-tuned.
+        void selectTunedParameters() const
+        {
+            if ( ! autoTuner_ )
+            {
+                return;
+            }
+            if ( autoTuner_->current() != tunedCandidate_ )
+            {
+                // The state kept between solves belongs to the previous configuration.
+                tunedCandidate_ = autoTuner_->current();
+                rebuildPreconditioner_ = true;
+                recycledSubspace_.reset();
+                keptPreconditioner_.reset();
+            }
+            parameters_ = autoTuner_->parameters();
+            tuneTimer_.reset();
+        }
+
+        void reportTunedSolve( const Dune::InverseOperatorResult& result ) const
+        {
+            if ( autoTuner_ && autoTuner_->report(tuneTimer_.elapsed(), result.iterations, result.converged)
+                 && isIORank_ )
+            {
+                OpmLog::info(autoTuner_->summary());
+            }
+        }
+
         void checkConvergence( const Dune::InverseOperatorResult& result ) const
         {
             // store number of iterations
@@ -382,10 +1098,58 @@ namespace Opm
         }
     protected:
         mutable int iterations_;
+        /// \brief The number of iterations after the last full setup of the preconditioner.
+        mutable int setupIterations_;
+        /// \brief The number of nonzeroes of the matrix of the reused preconditioner.
+        mutable std::size_t preconditionerNonzeroes_;
+        /// \brief The time step size of the next solves (see setTimeStepSize()).
+        mutable double stepSize_;
+        /// \brief The time step size at the last full setup of the reused preconditioner.
+        mutable double setupStepSize_;
+        /// \brief Whether the reused preconditioner needs a full setup.
+        mutable bool rebuildPreconditioner_;
+        /// \brief Whether the last solve reused the preconditioner.
+        mutable bool preconditionerReused_;
+        /// \brief Whether the ILU preconditioner is kept (see keepPreconditioner()).
+        mutable bool keepPreconditioner_;
+        /// \brief Whether the next solve uses the kept preconditioner (see reuseKeptPreconditioner()).
+        mutable bool reuseKeptPreconditioner_;
+        /// \brief The number of nonzeroes of the matrix of the kept preconditioner.
+        mutable std::size_t keptNonzeroes_;
+        /// \brief The true-IMPES weights for CPR or nullptr (see setImpesWeights()).
+        mutable const Vector* impesWeights_;
+        /// \brief The CPR preconditioner reused between solves.
+        mutable std::unique_ptr< Dune::Preconditioner<Vector,Vector> > reusablePreconditioner_;
+        /// \brief The ILU preconditioner of the last sequential solve (see keepPreconditioner()).
+        mutable std::unique_ptr< Dune::Preconditioner<Vector,Vector> > keptPreconditioner_;
+        /// \brief The search directions recycled between solves (linear_solver_recycle_size_).
+        mutable std::unique_ptr< RecycledSubspace<Vector> > recycledSubspace_;
+        /// \brief The reduction of the residual the Krylov solver has to achieve.
+        mutable double reduction_;
+#if HAVE_UMFPACK
+        /// \brief The direct solver kept between solves to reuse its symbolic factorization.
+        mutable std::unique_ptr< DirectSolver > directSolver_;
+#endif
+        /// \brief Selects the configuration if linear_solver_auto_tune_ is set.
+        std::unique_ptr< LinearSolverAutoTuner > autoTuner_;
+        /// \brief The configurations tried if a solve does not converge (linear_solver_fallback_).
+        std::unique_ptr< LinearSolverFallback > fallback_;
+        /// \brief The candidate of the auto-tuner used for the last solve.
+        mutable std::size_t tunedCandidate_;
+        mutable Dune::Timer tuneTimer_;
+        Dune::Amg::SequentialInformation sequentialInformation_;
+#if HAVE_MPI
+        /// \brief The communication of the parallel solves (see parallelCommunication()).
+        mutable std::unique_ptr< Dune::OwnerOverlapCopyCommunication<int,int> > parallelComm_;
+        mutable std::size_t parallelCommSize_ = 0;
+#endif
+        mutable OverlapRows overlapRows_;
+        mutable bool overlapRowsComputed_ = false;
         boost::any parallelInformation_;
         bool isIORank_;
 
-        FlowLinearSolverParameters parameters_;
+        /// \brief The parameters of the solver. Switched by the auto-tuner.
+        mutable FlowLinearSolverParameters parameters_;
     }; // end ISTLSolver
 
 } // namespace Opm
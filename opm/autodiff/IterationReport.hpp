@@ -31,6 +31,8 @@ namespace Opm {
         bool converged;
         int linear_iterations;
         int well_iterations;
+        int preconditioner_setups;
+        int preconditioner_reuses;
     };
 } // namespace Opm
 
@@ -0,0 +1,229 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_LINEARSOLVERAUTOTUNER_HEADER_INCLUDED
+#define OPM_LINEARSOLVERAUTOTUNER_HEADER_INCLUDED
+
+#include <opm/autodiff/FlowLinearSolverParameters.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace Opm
+{
+
+    /// \brief Selects the fastest of a few linear solver configurations during a run.
+    ///
+    /// During the tuning phase the candidates are used in turn for the
+    /// linear solves of the simulation, so that all of them see systems
+    /// of the same stage of the run. Once each candidate has done the
+    /// requested number of solves, the one with the smallest mean time
+    /// per solve is used for the rest of the run. A candidate whose solve
+    /// did not converge is not selected.
+    class LinearSolverAutoTuner
+    {
+    public:
+        /// \brief A configuration to try.
+        struct Candidate
+        {
+            Candidate(const std::string& n, const FlowLinearSolverParameters& p)
+                : name(n), parameters(p), seconds(0.0), solves(0), iterations(0), failed(false)
+            {}
+            std::string name;
+            FlowLinearSolverParameters parameters;
+            double seconds;
+            int solves;
+            long iterations;
+            bool failed;
+        };
+
+        /// \brief Constructor.
+        /// \param configured The configuration given by the user. It is always a candidate.
+        /// \param solvesPerCandidate The number of solves to measure for each candidate.
+        /// \param includeCpr Whether the CPR preconditioner is available.
+        LinearSolverAutoTuner(const FlowLinearSolverParameters& configured,
+                              int solvesPerCandidate, bool includeCpr)
+            : solvesPerCandidate_(std::max(solvesPerCandidate, 1)), next_(0), selected_(-1)
+        {
+            candidates_.emplace_back("configured", configured);
+
+            FlowLinearSolverParameters ilu0 = configured;
+            ilu0.use_cpr_ = false;
+            ilu0.linear_solver_use_amg_ = false;
+            ilu0.use_ras_ = false;
+            ilu0.ilu_fillin_level_ = 0;
+            ilu0.ilu_milu_ = MILU_VARIANT::ILU;
+            ilu0.ilu_redblack_ = false;
+            addCandidate("ILU0", ilu0);
+
+            FlowLinearSolverParameters ilu1 = ilu0;
+            ilu1.ilu_fillin_level_ = 1;
+            addCandidate("ILU1", ilu1);
+
+            FlowLinearSolverParameters redBlack = ilu0;
+            redBlack.ilu_redblack_ = true;
+            addCandidate("ILU0 red-black", redBlack);
+
+            if ( includeCpr )
+            {
+                FlowLinearSolverParameters cpr = ilu0;
+                cpr.use_cpr_ = true;
+                cpr.cpr_reuse_setup_ = false;
+                addCandidate("CPR", cpr);
+
+                cpr.cpr_reuse_setup_ = true;
+                addCandidate("CPR with reused setup", cpr);
+            }
+        }
+
+        /// \brief Whether the candidates are still being measured.
+        bool tuning() const
+        {
+            return selected_ < 0;
+        }
+
+        /// \brief The index of the candidate to use for the next solve.
+        std::size_t current() const
+        {
+            return tuning() ? next_ : selected_;
+        }
+
+        /// \brief The parameters to use for the next solve.
+        const FlowLinearSolverParameters& parameters() const
+        {
+            return candidates_[current()].parameters;
+        }
+
+        const std::vector<Candidate>& candidates() const
+        {
+            return candidates_;
+        }
+
+        /// \brief Record the result of the solve with the current candidate.
+        /// \return Whether this ended the tuning phase.
+        bool report(double seconds, int iterations, bool converged)
+        {
+            if ( !tuning() )
+            {
+                return false;
+            }
+            auto& candidate = candidates_[next_];
+            candidate.seconds += seconds;
+            candidate.iterations += iterations;
+            ++candidate.solves;
+            candidate.failed = candidate.failed || !converged;
+
+            // next candidate that still needs measurements
+            for ( std::size_t i = 1; i <= candidates_.size(); ++i )
+            {
+                const std::size_t c = (next_ + i) % candidates_.size();
+                if ( !candidates_[c].failed && candidates_[c].solves < solvesPerCandidate_ )
+                {
+                    next_ = c;
+                    return false;
+                }
+            }
+            select();
+            return true;
+        }
+
+        /// \brief A table of the measured candidates and the selection.
+        std::string summary() const
+        {
+            std::ostringstream os;
+            os << "Linear solver auto-tuning:\n";
+            for ( std::size_t c = 0; c < candidates_.size(); ++c )
+            {
+                const auto& candidate = candidates_[c];
+                os << (static_cast<int>(c) == selected_ ? " * " : "   ")
+                   << std::left << std::setw(24) << candidate.name << std::right;
+                if ( candidate.failed )
+                {
+                    os << "  failed to converge";
+                }
+                else if ( candidate.solves > 0 )
+                {
+                    os << std::fixed << std::setprecision(4) << std::setw(10)
+                       << candidate.seconds / candidate.solves << " s/solve"
+                       << std::setw(8) << std::setprecision(1)
+                       << double(candidate.iterations) / candidate.solves << " its/solve";
+                }
+                os << "\n";
+            }
+            return os.str();
+        }
+
+    private:
+        static bool sameConfiguration(const FlowLinearSolverParameters& a,
+                                      const FlowLinearSolverParameters& b)
+        {
+            return a.use_cpr_ == b.use_cpr_ && a.linear_solver_use_amg_ == b.linear_solver_use_amg_
+                && a.use_ras_ == b.use_ras_ && a.ilu_fillin_level_ == b.ilu_fillin_level_
+                && a.ilu_milu_ == b.ilu_milu_ && a.ilu_redblack_ == b.ilu_redblack_
+                && a.cpr_reuse_setup_ == b.cpr_reuse_setup_
+                && a.ilu_single_precision_ == b.ilu_single_precision_
+                && a.linear_solver_partitioned_ == b.linear_solver_partitioned_;
+        }
+
+        void addCandidate(const std::string& name, const FlowLinearSolverParameters& parameters)
+        {
+            for ( const auto& candidate : candidates_ )
+            {
+                if ( sameConfiguration(candidate.parameters, parameters) )
+                {
+                    return;
+                }
+            }
+            candidates_.emplace_back(name, parameters);
+        }
+
+        void select()
+        {
+            double best = std::numeric_limits<double>::max();
+            selected_ = 0;
+            for ( std::size_t c = 0; c < candidates_.size(); ++c )
+            {
+                const auto& candidate = candidates_[c];
+                if ( candidate.failed || candidate.solves == 0 )
+                {
+                    continue;
+                }
+                const double mean = candidate.seconds / candidate.solves;
+                if ( mean < best )
+                {
+                    best = mean;
+                    selected_ = static_cast<int>(c);
+                }
+            }
+        }
+
+        std::vector<Candidate> candidates_;
+        int solvesPerCandidate_;
+        std::size_t next_;
+        int selected_;
+    };
+
+} // namespace Opm
+
+#endif // OPM_LINEARSOLVERAUTOTUNER_HEADER_INCLUDED
@@ -0,0 +1,144 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_LINEARSOLVERFALLBACK_HEADER_INCLUDED
+#define OPM_LINEARSOLVERFALLBACK_HEADER_INCLUDED
+
+#include <opm/autodiff/FlowLinearSolverParameters.hpp>
+#include <opm/common/ErrorMacros.hpp>
+
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace Opm
+{
+
+    /// \brief The configurations tried in turn on a system the configured
+    ///        linear solver did not converge for.
+    ///
+    /// The chain is a comma separated list of the stages
+    ///   - ilu0:   ILU0 preconditioned BiCGSTAB,
+    ///   - ilu1:   ILU1 preconditioned BiCGSTAB,
+    ///   - cpr:    CPR preconditioned GMRES with twice the restart length
+    ///             and iterations of the configuration,
+    ///   - direct: a sparse direct factorization (UMFPack, sequential runs).
+    /// The other parameters of a stage, e.g. the reduction, are those of the
+    /// configuration. The state kept between solves, like a reused CPR
+    /// setup or recycled search directions, is not used by the stages.
+    class LinearSolverFallback
+    {
+    public:
+        /// \brief A configuration of the chain.
+        struct Stage
+        {
+            Stage(const std::string& n, const FlowLinearSolverParameters& p)
+                : name(n), parameters(p)
+            {}
+            std::string name;
+            FlowLinearSolverParameters parameters;
+        };
+
+        /// \brief Constructor.
+        /// \param configured The configuration given by the user.
+        /// \param chain The comma separated names of the stages.
+        /// \param includeCpr Whether the CPR preconditioner is available,
+        ///                   otherwise the cpr stages are left out.
+        LinearSolverFallback(const FlowLinearSolverParameters& configured,
+                             const std::string& chain, bool includeCpr)
+        {
+            std::istringstream is(chain);
+            std::string name;
+            while ( std::getline(is, name, ',') )
+            {
+                name.erase(0, name.find_first_not_of(" \t"));
+                name.erase(name.find_last_not_of(" \t") + 1);
+                if ( name.empty() || ( name == "cpr" && !includeCpr ) )
+                {
+                    continue;
+                }
+                stages_.emplace_back(name, stageParameters(configured, name));
+            }
+        }
+
+        /// \brief Whether there is no stage to try.
+        bool empty() const
+        {
+            return stages_.empty();
+        }
+
+        const std::vector<Stage>& stages() const
+        {
+            return stages_;
+        }
+
+        /// \brief The parameters of the named stage, derived from the configured ones.
+        static FlowLinearSolverParameters stageParameters(const FlowLinearSolverParameters& configured,
+                                                          const std::string& name)
+        {
+            FlowLinearSolverParameters parameters = configured;
+            parameters.use_cpr_ = false;
+            parameters.cpr_reuse_setup_ = false;
+            parameters.linear_solver_use_amg_ = false;
+            parameters.use_ras_ = false;
+            parameters.linear_solver_partitioned_ = false;
+            parameters.linear_solver_direct_max_cells_ = 0;
+            parameters.linear_solver_recycle_size_ = 0;
+            parameters.ilu_single_precision_ = false;
+            parameters.ilu_fillin_level_ = 0;
+            parameters.ilu_milu_ = MILU_VARIANT::ILU;
+            parameters.ilu_redblack_ = false;
+            parameters.newton_use_gmres_ = false;
+            parameters.newton_use_fused_bicgstab_ = false;
+
+            if ( name == "ilu0" )
+            {
+            }
+            else if ( name == "ilu1" )
+            {
+                parameters.ilu_fillin_level_ = 1;
+            }
+            else if ( name == "cpr" )
+            {
+                parameters.use_cpr_ = true;
+                parameters.newton_use_gmres_ = true;
+                parameters.linear_solver_restart_ = 2 * configured.linear_solver_restart_;
+                parameters.linear_solver_maxiter_ = 2 * configured.linear_solver_maxiter_;
+            }
+            else if ( name == "direct" )
+            {
+                parameters.linear_solver_direct_max_cells_ = std::numeric_limits<int>::max();
+            }
+            else
+            {
+                OPM_THROW(std::invalid_argument, "Unknown stage of the linear solver fallback: " << name
+                          << ". Possible values are: ilu0, ilu1, cpr, direct");
+            }
+            return parameters;
+        }
+
+    private:
+        std::vector<Stage> stages_;
+    };
+
+} // namespace Opm
+
+#endif // OPM_LINEARSOLVERFALLBACK_HEADER_INCLUDED
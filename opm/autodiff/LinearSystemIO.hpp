@@ -0,0 +1,224 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_LINEARSYSTEMIO_HEADER_INCLUDED
+#define OPM_LINEARSYSTEMIO_HEADER_INCLUDED
+
+#include <opm/common/ErrorMacros.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <vector>
+
+namespace Opm
+{
+namespace LinearSystemIO
+{
+    /// \brief Functions to store linear systems in a compact binary format.
+    ///
+    /// The format is meant to replay the systems of a simulation run with
+    /// different solver settings on the same machine. Hence the raw memory
+    /// representation is written (no conversion of endianness). A system file
+    /// consists of a header, the matrix, the right hand side and the packed
+    /// well contributions (see PackedWellContributions::write).
+
+    //! \brief The version of the file format.
+    const std::uint32_t fileVersion = 1;
+
+    //! \brief Write the bytes of a trivially copyable value.
+    template<class T>
+    void writeValue(std::ostream& os, const T& value)
+    {
+        os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    //! \brief Read a value written with writeValue.
+    template<class T>
+    T readValue(std::istream& is)
+    {
+        T value;
+        is.read(reinterpret_cast<char*>(&value), sizeof(T));
+        if ( !is )
+        {
+            OPM_THROW(std::runtime_error, "Unexpected end of linear system file");
+        }
+        return value;
+    }
+
+    //! \brief Write the size and the bytes of a vector of trivially copyable values.
+    template<class T>
+    void writeArray(std::ostream& os, const std::vector<T>& values)
+    {
+        writeValue(os, static_cast<std::uint64_t>(values.size()));
+        if ( !values.empty() )
+        {
+            os.write(reinterpret_cast<const char*>(values.data()), sizeof(T) * values.size());
+        }
+    }
+
+    //! \brief Read a vector written with writeArray.
+    template<class T>
+    void readArray(std::istream& is, std::vector<T>& values)
+    {
+        values.resize(readValue<std::uint64_t>(is));
+        if ( !values.empty() )
+        {
+            is.read(reinterpret_cast<char*>(values.data()), sizeof(T) * values.size());
+            if ( !is )
+            {
+                OPM_THROW(std::runtime_error, "Unexpected end of linear system file");
+            }
+        }
+    }
+
+    /// \brief Write the header of a system file.
+    /// \param numEq The number of equations per cell of the system.
+    inline void writeHeader(std::ostream& os, int numEq)
+    {
+        os.write("OPMLSYS", 8);
+        writeValue(os, fileVersion);
+        writeValue(os, static_cast<std::int32_t>(numEq));
+    }
+
+    /// \brief Read the header of a system file.
+    /// \return The number of equations per cell of the system.
+    inline int readHeader(std::istream& is)
+    {
+        char magic[8];
+        is.read(magic, 8);
+        if ( !is || std::strncmp(magic, "OPMLSYS", 8) != 0 )
+        {
+            OPM_THROW(std::runtime_error, "Not a linear system file");
+        }
+        if ( readValue<std::uint32_t>(is) != fileVersion )
+        {
+            OPM_THROW(std::runtime_error, "Unsupported version of linear system file");
+        }
+        return readValue<std::int32_t>(is);
+    }
+
+    /// \brief Read the header of a system file and check it against the expected block size.
+    inline void readHeader(std::istream& is, int numEq)
+    {
+        const int fileNumEq = readHeader(is);
+        if ( fileNumEq != numEq )
+        {
+            OPM_THROW(std::runtime_error, "The linear system file has " << fileNumEq
+                      << " equations per cell but " << numEq << " were expected");
+        }
+    }
+
+    /// \brief Write a block matrix as row pointers, column indices and blocks.
+    template<class Matrix>
+    void writeMatrix(std::ostream& os, const Matrix& A)
+    {
+        typedef typename Matrix::block_type Block;
+        std::vector<std::uint64_t> rowStart;
+        std::vector<std::uint32_t> cols;
+        std::vector<Block> blocks;
+        rowStart.reserve(A.N() + 1);
+        cols.reserve(A.nonzeroes());
+        blocks.reserve(A.nonzeroes());
+        rowStart.push_back(0);
+
+        for ( auto row = A.begin(), rend = A.end(); row != rend; ++row )
+        {
+            for ( auto col = row->begin(), cend = row->end(); col != cend; ++col )
+            {
+                cols.push_back(col.index());
+                blocks.push_back(*col);
+            }
+            rowStart.push_back(cols.size());
+        }
+
+        writeValue(os, static_cast<std::uint64_t>(A.M()));
+        writeArray(os, rowStart);
+        writeArray(os, cols);
+        writeArray(os, blocks);
+    }
+
+    /// \brief Read a block matrix written with writeMatrix.
+    template<class Matrix>
+    void readMatrix(std::istream& is, Matrix& A)
+    {
+        typedef typename Matrix::block_type Block;
+        const std::uint64_t numCols = readValue<std::uint64_t>(is);
+        std::vector<std::uint64_t> rowStart;
+        std::vector<std::uint32_t> cols;
+        std::vector<Block> blocks;
+        readArray(is, rowStart);
+        readArray(is, cols);
+        readArray(is, blocks);
+
+        if ( rowStart.empty() || rowStart.back() != cols.size() || cols.size() != blocks.size() )
+        {
+            OPM_THROW(std::runtime_error, "Corrupt matrix in linear system file");
+        }
+
+        const std::size_t numRows = rowStart.size() - 1;
+        A.setSize(numRows, numCols, cols.size());
+        A.setBuildMode(Matrix::row_wise);
+        std::size_t row = 0;
+        for ( auto createRow = A.createbegin(), rend = A.createend(); createRow != rend; ++createRow, ++row )
+        {
+            for ( std::size_t k = rowStart[row]; k < rowStart[row+1]; ++k )
+            {
+                createRow.insert(cols[k]);
+            }
+        }
+
+        row = 0;
+        std::size_t k = 0;
+        for ( auto r = A.begin(), rend = A.end(); r != rend; ++r, ++row )
+        {
+            for ( auto col = r->begin(), cend = r->end(); col != cend; ++col, ++k )
+            {
+                *col = blocks[k];
+            }
+        }
+    }
+
+    /// \brief Write a block vector.
+    template<class Vector>
+    void writeVector(std::ostream& os, const Vector& v)
+    {
+        std::vector<typename Vector::block_type> blocks(v.begin(), v.end());
+        writeArray(os, blocks);
+    }
+
+    /// \brief Read a block vector written with writeVector.
+    template<class Vector>
+    void readVector(std::istream& is, Vector& v)
+    {
+        std::vector<typename Vector::block_type> blocks;
+        readArray(is, blocks);
+        v.resize(blocks.size());
+        for ( std::size_t i = 0; i < blocks.size(); ++i )
+        {
+            v[i] = blocks[i];
+        }
+    }
+
+} // namespace LinearSystemIO
+} // namespace Opm
+
+#endif // OPM_LINEARSYSTEMIO_HEADER_INCLUDED
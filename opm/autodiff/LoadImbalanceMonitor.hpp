@@ -0,0 +1,131 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_LOADIMBALANCEMONITOR_HEADER_INCLUDED
+#define OPM_LOADIMBALANCEMONITOR_HEADER_INCLUDED
+
+#include <opm/autodiff/ReductionBatch.hpp>
+#include <opm/core/simulator/SimulatorReport.hpp>
+
+#include <array>
+#include <deque>
+#include <string>
+
+namespace Opm
+{
+
+/// \brief The load imbalance of the processes over the last report steps.
+///
+/// Each process records the time it spent in the assembly, including the
+/// wells, in the linear solves and in the updates of each report step. At
+/// the end of a report step the times of the last report steps are reduced
+/// over all processes, and the imbalance of a stage is the ratio of the
+/// largest to the mean time of a process, minus one.
+class LoadImbalanceMonitor
+{
+public:
+    enum Stage { Assembly = 0, LinearSolve = 1, Update = 2, NumStages = 3 };
+
+    /// \param window The number of report steps to measure, 0 disables the monitor.
+    /// \param threshold The imbalance of the total time at which the processes
+    ///                  should be repartitioned.
+    LoadImbalanceMonitor(const int window, const double threshold)
+        : window_(window)
+        , threshold_(threshold)
+    {
+        imbalance_.fill(0.0);
+    }
+
+    /// \brief Record the times of a report step and compute the imbalance of
+    ///        the last report steps. Collective on the communication.
+    /// \return Whether the total imbalance exceeds the threshold, which
+    ///         needs a full window of report steps.
+    template<class Comm>
+    bool endReportStep(const Comm& comm, const SimulatorReport& stepReport)
+    {
+        if ( window_ <= 0 )
+        {
+            return false;
+        }
+        steps_.push_back({{ stepReport.assemble_time,
+                            stepReport.linear_solve_time,
+                            stepReport.update_time }});
+        if ( static_cast<int>(steps_.size()) > window_ )
+        {
+            steps_.pop_front();
+        }
+
+        std::array<double, NumStages + 1> local;
+        local.fill(0.0);
+        for ( const auto& step : steps_ )
+        {
+            for ( int stage = 0; stage < NumStages; ++stage )
+            {
+                local[stage] += step[stage];
+                local[NumStages] += step[stage];
+            }
+        }
+
+        batch_.clear();
+        for ( const double time : local )
+        {
+            batch_.addSum(time);
+            batch_.addMax(time);
+        }
+        batch_.begin(comm);
+        batch_.end();
+
+        for ( int i = 0; i <= NumStages; ++i )
+        {
+            const double mean = batch_.sum(i) / comm.size();
+            imbalance_[i] = mean > 0.0 ? batch_.max(i) / mean - 1.0 : 0.0;
+        }
+        return static_cast<int>(steps_.size()) == window_ && imbalance_[NumStages] > threshold_;
+    }
+
+    /// \brief The imbalance of a stage in the last call of endReportStep().
+    double imbalance(const Stage stage) const
+    {
+        return imbalance_[stage];
+    }
+
+    /// \brief The imbalance of the total time in the last call of endReportStep().
+    double totalImbalance() const
+    {
+        return imbalance_[NumStages];
+    }
+
+    /// \brief Forget the measured report steps, e.g. after a repartition.
+    void reset()
+    {
+        steps_.clear();
+        imbalance_.fill(0.0);
+    }
+
+private:
+    int window_;
+    double threshold_;
+    std::deque<std::array<double, NumStages> > steps_;
+    std::array<double, NumStages + 1> imbalance_;
+    ReductionBatch batch_;
+};
+
+} // namespace Opm
+
+#endif // OPM_LOADIMBALANCEMONITOR_HEADER_INCLUDED
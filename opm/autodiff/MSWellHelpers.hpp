@@ -26,7 +26,9 @@
 #include <dune/istl/solvers.hh>
 #if HAVE_UMFPACK
 #include <dune/istl/umfpack.hh>
+#include <opm/autodiff/SparseDirectSolver.hpp>
 #endif // HAVE_UMFPACK
+#include <cassert>
 #include <cmath>
 
 namespace Opm {
@@ -71,6 +73,43 @@ namespace mswellhelpers
 
 
 
+    // obtain y = D^-1 * x with a direct solver holding the factorization of D,
+    // y is resized to the size of x and does not need to be allocated
+    // again by repeated solves, e.g. in the products of a Krylov solver
+    template <typename SolverType, typename VectorType>
+    void
+    solveDirect(SolverType& solver, const VectorType& x, VectorType& y)
+    {
+        y.resize(x.size());
+
+        solver.apply(y, x);
+
+        // Checking if there is any inf or nan in y
+        for (size_t i_block = 0; i_block < y.size(); ++i_block) {
+            for (size_t i_elem = 0; i_elem < y[i_block].size(); ++i_elem) {
+                if (std::isinf(y[i_block][i_elem]) || std::isnan(y[i_block][i_elem]) ) {
+                    OPM_THROW(Opm::NumericalIssue, "nan or inf value found in solveDirect due to singular matrix");
+                }
+            }
+        }
+    }
+
+
+
+    // obtain y = D^-1 * x with a direct solver holding the factorization of D
+    template <typename SolverType, typename VectorType>
+    VectorType
+    solveDirect(SolverType& solver, const VectorType& x)
+    {
+        VectorType y(x.size());
+        solveDirect(solver, x, y);
+        return y;
+    }
+
+
+
+
+
     // obtain y = D^-1 * x with a BICSSTAB iterative solver
     template <typename MatrixType, typename VectorType>
     VectorType
@@ -194,6 +233,105 @@ namespace mswellhelpers
     }
 
 
+
+
+
+    // the factors of the pressure losses of a segment which only depend on its geometry
+    struct SegmentGeometry
+    {
+        SegmentGeometry() = default;
+
+        // l is the segment length
+        // d is the segment inner diameter
+        // a is the segment cross area
+        // k is the absolute roughness
+        SegmentGeometry(const double l, const double d, const double a, const double k)
+            : area(a)
+            , diameter(d)
+            , roughness(k)
+            , reynolds_factor(d / a)
+            , friction_factor(2. * l / (a * a * d))
+            , velocity_head_factor(0.5 / (a * a))
+            , roughness_term(std::pow(k / (3.7 * d), 10. / 9.))
+        {
+            const double value = -3.6 * std::log10(6.9 / re_turbulent + roughness_term);
+            turbulent_friction = 1. / (value * value);
+        }
+
+        static constexpr double re_laminar = 200.;
+        static constexpr double re_turbulent = 4000.;
+
+        double area = 0.;
+        double diameter = 0.;
+        double roughness = 0.;
+        // Re = reynolds_factor * w / mu
+        double reynolds_factor = 0.;
+        // the friction pressure loss is friction_factor * f * w * w / density
+        double friction_factor = 0.;
+        // the velocity head is velocity_head_factor * w * w / density
+        double velocity_head_factor = 0.;
+        // (roughness / (3.7 diameter))^(10/9) of the Haaland formula
+        double roughness_term = 0.;
+        // the Haaland friction factor at re_turbulent
+        double turbulent_friction = 0.;
+    };
+
+
+
+
+
+    // the friction factor of calculateFrictionFactor() with the precomputed geometry factors
+    inline double calculateFrictionFactor(const SegmentGeometry& geometry, const double w, const double mu)
+    {
+        const double re = std::abs(geometry.reynolds_factor * w / mu);
+
+        if ( re == 0.0 ) {
+            // make sure it is because the mass rate is zero
+            assert(w == 0.);
+            return 0.0;
+        }
+
+        const double re_value1 = SegmentGeometry::re_laminar;
+        const double re_value2 = SegmentGeometry::re_turbulent;
+
+        if (re < re_value1) {
+            return 16. / re;
+        } else if (re > re_value2) {
+            const double value = -3.6 * std::log10(6.9 / re + geometry.roughness_term);
+            assert(value >= 0.0);
+            return 1. / (value * value);
+        } else { // in between
+            const double f1 = 16. / re_value1;
+            const double f2 = geometry.turbulent_friction;
+            return (f2 - f1) / (re_value2 - re_value1) * (re - re_value1) + f1;
+        }
+    }
+
+
+
+
+
+    // the friction pressure loss of frictionPressureLoss() with the precomputed geometry factors
+    template <typename ValueType>
+    ValueType frictionPressureLoss(const SegmentGeometry& geometry,
+                                   const ValueType& density, const ValueType& w, const ValueType& mu)
+    {
+        const double f = calculateFrictionFactor(geometry, w.value(), mu.value());
+        return (f * geometry.friction_factor) * w * w / density;
+    }
+
+
+
+
+
+    // the velocity head of velocityHead() with the precomputed geometry factors
+    template <typename ValueType>
+    ValueType velocityHead(const SegmentGeometry& geometry, const ValueType& mass_rate, const ValueType& density)
+    {
+        return geometry.velocity_head_factor * mass_rate * mass_rate / density;
+    }
+
+
 } // namespace mswellhelpers
 
 }
@@ -217,6 +217,30 @@ static inline void invertMatrix(Dune::DynamicMatrix<K>& matrix)
     matrix.invert();
 }
 
+//! \brief Computes ret = A x for a block of compile time size.
+//!
+//! The loops have fixed trip counts and the result is accumulated in a
+//! local array which does not alias A or x. This allows the compiler to
+//! fully unroll and vectorize the kernel for the small blocks of the
+//! black oil equations. The generic loops of DenseMatrix do not allow this
+//! as the result might alias the argument.
+template <int n, int m, class Block, class X, class K>
+static inline void blockMultiply(const Block& A, const X& x, K (&ret)[n])
+{
+    K xLocal[ m ];
+    for( int j = 0; j < m; ++j )
+        xLocal[ j ] = x[ j ];
+
+    for( int i = 0; i < n; ++i )
+    {
+        const auto& row = A[ i ];
+        K sum = 0;
+        for( int j = 0; j < m; ++j )
+            sum += row[ j ] * xLocal[ j ];
+        ret[ i ] = sum;
+    }
+}
+
 } // end ISTLUtility
 
 template <class Scalar, int n, int m>
@@ -233,6 +257,47 @@ public:
     {
         ISTLUtility::invertMatrix( *this );
     }
+
+    //! y = A x
+    template<class X, class Y>
+    void mv( const X& x, Y& y ) const
+    {
+        Scalar tmp[ n ];
+        ISTLUtility::blockMultiply<n, m>( *this, x, tmp );
+        for( int i = 0; i < n; ++i )
+            y[ i ] = tmp[ i ];
+    }
+
+    //! y += A x
+    template<class X, class Y>
+    void umv( const X& x, Y& y ) const
+    {
+        Scalar tmp[ n ];
+        ISTLUtility::blockMultiply<n, m>( *this, x, tmp );
+        for( int i = 0; i < n; ++i )
+            y[ i ] += tmp[ i ];
+    }
+
+    //! y -= A x
+    template<class X, class Y>
+    void mmv( const X& x, Y& y ) const
+    {
+        Scalar tmp[ n ];
+        ISTLUtility::blockMultiply<n, m>( *this, x, tmp );
+        for( int i = 0; i < n; ++i )
+            y[ i ] -= tmp[ i ];
+    }
+
+    //! y += alpha A x
+    template<class F, class X, class Y>
+    void usmv( const F& alpha, const X& x, Y& y ) const
+    {
+        Scalar tmp[ n ];
+        ISTLUtility::blockMultiply<n, m>( *this, x, tmp );
+        for( int i = 0; i < n; ++i )
+            y[ i ] += alpha * tmp[ i ];
+    }
+
     const BaseType& asBase() const { return static_cast< const BaseType& > (*this); }
     BaseType& asBase() { return static_cast< BaseType& > (*this); }
 };
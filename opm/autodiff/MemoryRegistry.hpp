@@ -0,0 +1,164 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_MEMORYREGISTRY_HEADER_INCLUDED
+#define OPM_MEMORYREGISTRY_HEADER_INCLUDED
+
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Opm
+{
+
+    /// \brief The memory held by the large data structures of the subsystems.
+    ///
+    /// The data structures (Jacobian, ILU factors, well matrices, ...) report
+    /// their size in bytes through a MemoryAccount whenever they are set up,
+    /// and the registry keeps the current and the peak sum of each subsystem.
+    /// The sizes are those of the arrays, not of the allocator overhead, hence
+    /// their total is a lower bound of the resident set size.
+    class MemoryRegistry
+    {
+    public:
+        /// \brief The memory of one subsystem.
+        struct Entry
+        {
+            explicit Entry(const std::string& l)
+                : label(l), current(0), peak(0)
+            {}
+
+            void add(const long long bytes)
+            {
+                const long long now = current += bytes;
+                long long largest = peak.load();
+                while ( now > largest && !peak.compare_exchange_weak(largest, now) )
+                {}
+            }
+
+            std::string label;
+            std::atomic<long long> current;
+            std::atomic<long long> peak;
+        };
+
+        /// \brief The registry used by all subsystems.
+        static MemoryRegistry& instance()
+        {
+            static MemoryRegistry registry;
+            return registry;
+        }
+
+        /// \brief Get the entry for a label, creating it if needed.
+        ///
+        /// The reference stays valid for the life time of the registry.
+        Entry& entry(const std::string& label)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for ( auto& e : entries_ )
+            {
+                if ( e.label == label )
+                {
+                    return e;
+                }
+            }
+            entries_.emplace_back(label);
+            return entries_.back();
+        }
+
+    private:
+        MemoryRegistry() = default;
+
+        // deque to keep references to the entries valid.
+        std::deque<Entry> entries_;
+        std::mutex mutex_;
+    };
+
+    /// \brief The contribution of one object to an entry of the MemoryRegistry.
+    ///
+    /// The owner sets the size of its data whenever it changes, and the
+    /// contribution is removed when the account is destroyed. A copy of an
+    /// account contributes the same size again, like the copy of its owner.
+    ///
+    /// Usage:
+    /// \code
+    /// MemoryAccount account_{ MemoryRegistry::instance().entry("ilu.factors") };
+    /// ...
+    /// account_.set( memoryBytes( factors ) );
+    /// \endcode
+    class MemoryAccount
+    {
+    public:
+        explicit MemoryAccount(MemoryRegistry::Entry& entry)
+            : entry_(&entry), bytes_(0)
+        {}
+
+        MemoryAccount(const MemoryAccount& other)
+            : entry_(other.entry_), bytes_(0)
+        {
+            set(other.bytes_);
+        }
+
+        MemoryAccount& operator=(const MemoryAccount& other)
+        {
+            set(other.bytes_);
+            return *this;
+        }
+
+        ~MemoryAccount()
+        {
+            set(0);
+        }
+
+        void set(const std::size_t bytes)
+        {
+            entry_->add(static_cast<long long>(bytes) - static_cast<long long>(bytes_));
+            bytes_ = bytes;
+        }
+
+        std::size_t bytes() const
+        {
+            return bytes_;
+        }
+
+    private:
+        MemoryRegistry::Entry* entry_;
+        std::size_t bytes_;
+    };
+
+    /// \brief The bytes of the elements of a vector.
+    template <class T, class A>
+    std::size_t memoryBytes(const std::vector<T, A>& v)
+    {
+        return v.capacity() * sizeof(T);
+    }
+
+    /// \brief The bytes of the blocks, column indices and rows of a BCRSMatrix.
+    template <class Matrix>
+    std::size_t matrixMemoryBytes(const Matrix& A)
+    {
+        return A.nonzeroes() * (sizeof(typename Matrix::block_type) + sizeof(typename Matrix::size_type))
+            + A.N() * sizeof(typename Matrix::row_type);
+    }
+
+} // namespace Opm
+
+#endif // OPM_MEMORYREGISTRY_HEADER_INCLUDED
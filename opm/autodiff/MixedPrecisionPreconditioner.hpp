@@ -0,0 +1,190 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef OPM_MIXEDPRECISIONPRECONDITIONER_HEADER_INCLUDED
+#define OPM_MIXEDPRECISIONPRECONDITIONER_HEADER_INCLUDED
+
+#include <opm/common/utility/platform_dependent/disable_warnings.h>
+#include <dune/common/version.hh>
+#include <dune/common/unused.hh>
+#include <dune/istl/preconditioner.hh>
+#include <dune/istl/solvercategory.hh>
+#include <opm/common/utility/platform_dependent/reenable_warnings.h>
+
+#include <cassert>
+#include <memory>
+
+namespace Opm
+{
+namespace Detail
+{
+    //! \brief Create the sparsity pattern of to from the one of from.
+    template<class FromMatrix, class ToMatrix>
+    void copySparsityPattern(const FromMatrix& from, ToMatrix& to)
+    {
+        to.setSize(from.N(), from.M(), from.nonzeroes());
+        to.setBuildMode(ToMatrix::row_wise);
+
+        auto fromRow = from.begin();
+        for ( auto row = to.createbegin(), rend = to.createend(); row != rend; ++row, ++fromRow )
+        {
+            for ( auto col = fromRow->begin(), cend = fromRow->end(); col != cend; ++col )
+            {
+                row.insert(col.index());
+            }
+        }
+    }
+
+    //! \brief Copy the entries of a matrix to one with the same sparsity pattern
+    //!        but a possibly different field type.
+    template<class FromMatrix, class ToMatrix>
+    void convertMatrixEntries(const FromMatrix& from, ToMatrix& to)
+    {
+        using ToField = typename ToMatrix::field_type;
+        assert( from.N() == to.N() && from.nonzeroes() == to.nonzeroes() );
+        auto toRow = to.begin();
+
+        for ( const auto& row : from )
+        {
+            auto toCol = toRow->begin();
+            for ( auto col = row.begin(), cend = row.end(); col != cend; ++col, ++toCol )
+            {
+                for ( int i = 0; i < ToMatrix::block_type::rows; ++i )
+                {
+                    for ( int j = 0; j < ToMatrix::block_type::cols; ++j )
+                    {
+                        (*toCol)[i][j] = static_cast<ToField>((*col)[i][j]);
+                    }
+                }
+            }
+            ++toRow;
+        }
+    }
+
+    //! \brief Copy the entries of a block vector to one with a possibly different field type.
+    template<class FromVector, class ToVector>
+    void convertVectorEntries(const FromVector& from, ToVector& to)
+    {
+        using ToField = typename ToVector::field_type;
+        assert( from.size() == to.size() );
+
+        for ( std::size_t i = 0, end = from.size(); i < end; ++i )
+        {
+            for ( int j = 0; j < ToVector::block_type::dimension; ++j )
+            {
+                to[i][j] = static_cast<ToField>(from[i][j]);
+            }
+        }
+    }
+} // end namespace Detail
+
+/// \brief A preconditioner that is set up and applied in a lower precision.
+///
+/// The matrix is copied to a matrix with a lower precision field type
+/// (usually float) and the inner preconditioner is computed for it.
+/// During apply the defect is converted to the lower precision, the inner
+/// preconditioner is applied, and the update is converted back.
+/// As the preconditioner only needs to be an approximation this halves
+/// the memory traffic of its apply while the Krylov solver stays
+/// in double precision.
+/// \tparam X The type of the domain of the Krylov solver.
+/// \tparam Y The type of the range of the Krylov solver.
+/// \tparam LowMatrix The type of the matrix with the lower precision.
+/// \tparam LowPreconditioner The type of the inner preconditioner for LowMatrix.
+template<class X, class Y, class LowMatrix, class LowPreconditioner>
+class MixedPrecisionPreconditioner
+    : public Dune::Preconditioner<X,Y>
+{
+public:
+    //! \brief The domain type of the preconditioner.
+    typedef X domain_type;
+    //! \brief The range type of the preconditioner.
+    typedef Y range_type;
+    //! \brief The field type of the preconditioner.
+    typedef typename X::field_type field_type;
+    //! \brief The domain type of the inner preconditioner.
+    typedef typename LowPreconditioner::domain_type LowDomain;
+    //! \brief The range type of the inner preconditioner.
+    typedef typename LowPreconditioner::range_type LowRange;
+
+#if DUNE_VERSION_NEWER(DUNE_ISTL, 2, 6)
+    Dune::SolverCategory::Category category() const override
+    {
+        return precond_->category();
+    }
+#else
+    enum {
+        //! \brief The category the preconditioner is part of.
+        category = LowPreconditioner::category
+    };
+#endif
+
+    /// \brief Constructor.
+    /// \param A The matrix in the precision of the Krylov solver.
+    /// \param createPreconditioner Functor that creates the inner preconditioner
+    ///        for the lower precision matrix passed to it and returns a
+    ///        std::unique_ptr to it. The matrix will live as long as this object.
+    template<class Matrix, class Factory>
+    MixedPrecisionPreconditioner(const Matrix& A, const Factory& createPreconditioner)
+        : matrix_(new LowMatrix()), v_(A.M()), d_(A.N())
+    {
+        Detail::copySparsityPattern(A, *matrix_);
+        Detail::convertMatrixEntries(A, *matrix_);
+        precond_ = createPreconditioner(*matrix_);
+    }
+
+    virtual void pre (X& x, Y& b)
+    {
+        DUNE_UNUSED_PARAMETER(x);
+        DUNE_UNUSED_PARAMETER(b);
+    }
+
+    virtual void apply (X& v, const Y& d)
+    {
+        Detail::convertVectorEntries(d, d_);
+        v_ = 0;
+        precond_->apply(v_, d_);
+        Detail::convertVectorEntries(v_, v);
+    }
+
+    virtual void post (X& x)
+    {
+        DUNE_UNUSED_PARAMETER(x);
+    }
+
+    /// \brief Update the preconditioner for new entries of a matrix
+    ///        with unchanged sparsity pattern.
+    template<class Matrix>
+    void update(const Matrix& A)
+    {
+        Detail::convertMatrixEntries(A, *matrix_);
+        precond_->update();
+    }
+
+private:
+    //! \brief The matrix in lower precision.
+    std::unique_ptr<LowMatrix> matrix_;
+    //! \brief The inner preconditioner.
+    std::unique_ptr<LowPreconditioner> precond_;
+    //! \brief Lower precision copies of the update and the defect.
+    LowDomain v_;
+    LowRange d_;
+};
+
+} // end namespace Opm
+#endif
@@ -24,12 +24,14 @@
 
 
 #include <opm/autodiff/WellInterface.hpp>
+#include <opm/autodiff/MSWellHelpers.hpp>
+#include <opm/autodiff/SegmentTreeSolver.hpp>
 
 namespace Opm
 {
 
     template<typename TypeTag>
-    class MultisegmentWell: public WellInterface<TypeTag>
+    class MultisegmentWell final : public WellInterface<TypeTag>
     {
     public:
         typedef WellInterface<TypeTag> Base;
@@ -49,6 +51,7 @@ namespace Opm
 
         using Base::has_solvent;
         using Base::has_polymer;
+        using Base::phaseIsActive;
         using Base::Water;
         using Base::Oil;
         using Base::Gas;
@@ -109,6 +112,14 @@ namespace Opm
                           const double gravity_arg,
                           const int num_cells) override;
 
+        /// The segments are only taken over within a report step.
+        virtual bool rebind(const Well* well, const int time_step, const Wells* wells) override;
+
+        /// The segment pressures and rates are not extrapolated, hence neither is the well.
+        virtual void predictWellState(const WellState& /* older_state */, const double /* factor */,
+                                      WellState& /* well_state */) const override
+        {
+        }
 
         virtual void initPrimaryVariablesEvaluation() const override;
 
@@ -145,6 +156,20 @@ namespace Opm
         virtual void calculateExplicitQuantities(const Simulator& ebosSimulator,
                                                  const WellState& well_state) override; // should be const?
 
+        /// A -= C^T D^-1 B, with one solve by the factorization of D per unknown of a perforated cell
+        virtual void addWellContributions(Mat& mat) const override;
+
+        /// \brief Wether the Jacobian will also have well contributions in it.
+        virtual bool jacobianContainsWellContributions() const override
+        {
+            return param_.matrix_add_well_contributions_;
+        }
+
+        virtual std::size_t wellMatrixMemory() const override
+        {
+            return Opm::matrixMemoryBytes(duneB_) + Opm::matrixMemoryBytes(duneC_) + Opm::matrixMemoryBytes(duneD_);
+        }
+
         /// number of segments for this well
         /// int number_of_segments_;
         int numberOfSegments() const;
@@ -175,6 +200,7 @@ namespace Opm
         using Base::param_;
         using Base::well_index_;
         using Base::well_type_;
+        using Base::deferred_logger_;
         using Base::first_perf_;
         using Base::saturation_table_number_;
         using Base::well_efficiency_factor_;
@@ -216,6 +242,17 @@ namespace Opm
         mutable OffDiagMatWell duneC_;
         // diagonal matrix for the well
         mutable DiagMatWell duneD_;
+        // the products of duneB_ and duneD_^-1 in apply(), kept between the calls of the linear solver
+        mutable BVectorWell apply_Bx_;
+        mutable BVectorWell apply_invDBx_;
+        // the factorization of duneD_ by elimination over the segment tree,
+        // updated after each assembly
+        mutable SegmentTreeSolver<DiagMatWell, BVectorWell> duneDTreeSolver_;
+#if HAVE_UMFPACK
+        // the general factorization of duneD_, if it does not have the pattern
+        // of the segment tree. The symbolic factorization is reused.
+        mutable SparseDirectSolver<DiagMatWell, BVectorWell> duneDSolver_;
+#endif // HAVE_UMFPACK
 
         // residuals of the well equations
         mutable BVectorWell resWell_;
@@ -253,6 +290,10 @@ namespace Opm
 
         std::vector<double> segment_depth_diffs_;
 
+        // the factors of the frictional and acceleration pressure losses of the segments,
+        // computed once from the segment geometry
+        std::vector<mswellhelpers::SegmentGeometry> segment_geometry_;
+
         void initMatrixAndVectors(const int num_cells) const;
 
         // protected functions
@@ -319,6 +360,13 @@ namespace Opm
 
         void assemblePressureEq(const int seg) const;
 
+        // factorize duneD_ for the following calls of solveD()
+        void factorizeD() const;
+
+        // y = duneD_^-1 * x
+        BVectorWell solveD(const BVectorWell& x) const;
+        void solveD(const BVectorWell& x, BVectorWell& y) const;
+
         // hytrostatic pressure loss
         EvalWell getHydroPressureLoss(const int seg) const;
 
@@ -43,6 +43,7 @@ namespace Opm
     , segment_viscosities_(numberOfSegments(), 0.0)
     , segment_mass_rates_(numberOfSegments(), 0.0)
     , segment_depth_diffs_(numberOfSegments(), 0.0)
+    , segment_geometry_(numberOfSegments())
     {
         // not handling solvent or polymer for now with multisegment well
         if (has_solvent) {
@@ -97,6 +98,12 @@ namespace Opm
             const Segment& outlet_segment = segmentSet()[segmentNumberToIndex(outlet_segment_number)];
             const double outlet_depth = outlet_segment.depth();
             segment_depth_diffs_[seg] = segment_depth - outlet_depth;
+
+            const double length = segmentSet()[seg].totalLength() - outlet_segment.totalLength();
+            segment_geometry_[seg] = mswellhelpers::SegmentGeometry(length,
+                                                                    segmentSet()[seg].internalDiameter(),
+                                                                    segmentSet()[seg].crossArea(),
+                                                                    segmentSet()[seg].roughness());
         }
     }
 
@@ -137,6 +144,22 @@ namespace Opm
 
 
 
+    template <typename TypeTag>
+    bool
+    MultisegmentWell<TypeTag>::
+    rebind(const Well* well, const int time_step, const Wells* wells)
+    {
+        // the segments and their perforations are set up from the schedule of current_step_
+        if (time_step != current_step_) {
+            return false;
+        }
+        return Base::rebind(well, time_step, wells);
+    }
+
+
+
+
+
     template <typename TypeTag>
     void
     MultisegmentWell<TypeTag>::
@@ -275,13 +298,13 @@ namespace Opm
 
             /* const Opm::PhaseUsage& pu = phaseUsage();
             std::vector<double> rates(3, 0.0);
-            if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+            if (phaseIsActive(FluidSystem::waterPhaseIdx)) {
                 rates[ Water ] = well_state.wellRates()[index_of_well_ * number_of_phases_ + pu.phase_pos[ Water ] ];
             }
-            if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx)) {
+            if (phaseIsActive(FluidSystem::oilPhaseIdx)) {
                  rates[ Oil ] = well_state.wellRates()[index_of_well_ * number_of_phases_ + pu.phase_pos[ Oil ] ];
             }
-            if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+            if (phaseIsActive(FluidSystem::gasPhaseIdx)) {
                 rates[ Gas ] = well_state.wellRates()[index_of_well_ * number_of_phases_ + pu.phase_pos[ Gas ] ];
             } */
 
@@ -508,15 +531,75 @@ namespace Opm
     MultisegmentWell<TypeTag>::
     apply(const BVector& x, BVector& Ax) const
     {
-        BVectorWell Bx(duneB_.N());
+        if ( param_.matrix_add_well_contributions_ )
+        {
+            // Contributions are already in the matrix itself
+            return;
+        }
+
+        apply_Bx_.resize(duneB_.N());
 
-        duneB_.mv(x, Bx);
+        duneB_.mv(x, apply_Bx_);
 
         // invDBx = duneD^-1 * Bx_
-        const BVectorWell invDBx = mswellhelpers::invDXDirect(duneD_, Bx);
+        solveD(apply_Bx_, apply_invDBx_);
 
         // Ax = Ax - duneC_^T * invDBx
-        duneC_.mmtv(invDBx,Ax);
+        duneC_.mmtv(apply_invDBx_, Ax);
+    }
+
+
+
+
+
+    template <typename TypeTag>
+    void
+    MultisegmentWell<TypeTag>::
+    addWellContributions(Mat& mat) const
+    {
+        // We need to change matrix A as follows
+        // A -= C^T D^-1 B
+        // B and C have a row per segment and nonzero blocks in the columns of
+        // the perforated cells only. D is factorized already, hence each column
+        // of B, i.e. each unknown of a perforated cell, takes one solve.
+        const int nseg = duneB_.N();
+        std::vector<int> cells;
+        for (int seg = 0; seg < nseg; ++seg) {
+            for (auto colB = duneB_[seg].begin(), endB = duneB_[seg].end(); colB != endB; ++colB) {
+                cells.push_back(colB.index());
+            }
+        }
+        std::sort(cells.begin(), cells.end());
+        cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+
+        BVectorWell column(nseg);
+        for (const int cell : cells) {
+            for (int pvIdx = 0; pvIdx < numEq; ++pvIdx) {
+                column = 0.0;
+                for (int seg = 0; seg < nseg; ++seg) {
+                    const auto entry = duneB_[seg].find(cell);
+                    if (entry != duneB_[seg].end()) {
+                        for (int i = 0; i < numWellEq; ++i) {
+                            column[seg][i] = (*entry)[i][pvIdx];
+                        }
+                    }
+                }
+                const BVectorWell invDColumn = solveD(column);
+
+                for (int seg = 0; seg < nseg; ++seg) {
+                    for (auto colC = duneC_[seg].begin(), endC = duneC_[seg].end(); colC != endC; ++colC) {
+                        auto& block = mat[colC.index()][cell];
+                        for (int eqIdx = 0; eqIdx < numEq; ++eqIdx) {
+                            Scalar value = 0.0;
+                            for (int i = 0; i < numWellEq; ++i) {
+                                value += (*colC)[i][eqIdx] * invDColumn[seg][i];
+                            }
+                            block[eqIdx][pvIdx] -= value;
+                        }
+                    }
+                }
+            }
+        }
     }
 
 
@@ -529,7 +612,7 @@ namespace Opm
     apply(BVector& r) const
     {
         // invDrw_ = duneD^-1 * resWell_
-        const BVectorWell invDrw = mswellhelpers::invDXDirect(duneD_, resWell_);
+        const BVectorWell invDrw = solveD(resWell_);
         // r = r - duneC_^T * invDrw
         duneC_.mmtv(invDrw, r);
     }
@@ -565,7 +648,7 @@ namespace Opm
                 + "If you need well potential to set the guide rate for group controled wells \n"
                 + "you will have to change the " + name() + " well to a standard well \n";
 
-        OpmLog::warning("WELL_POTENTIAL_NOT_IMPLEMENTED_FOR_MULTISEG_WELLS", msg);
+        deferred_logger_.warning("WELL_POTENTIAL_NOT_IMPLEMENTED_FOR_MULTISEG_WELLS", msg);
 
         const int np = number_of_phases_;
         well_potentials.resize(np, 0.0);
@@ -602,11 +685,11 @@ namespace Opm
 
             primary_variables_[seg][GTotal] = total_seg_rate;
             if (std::abs(total_seg_rate) > 0.) {
-                if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+                if (phaseIsActive(FluidSystem::waterPhaseIdx)) {
                     const int water_pos = pu.phase_pos[Water];
                     primary_variables_[seg][WFrac] = scalingFactor(water_pos) * segment_rates[number_of_phases_ * seg_index + water_pos] / total_seg_rate;
                 }
-                if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+                if (phaseIsActive(FluidSystem::gasPhaseIdx)) {
                     const int gas_pos = pu.phase_pos[Gas];
                     primary_variables_[seg][GFrac] = scalingFactor(gas_pos) * segment_rates[number_of_phases_ * seg_index + gas_pos] / total_seg_rate;
                 }
@@ -614,7 +697,7 @@ namespace Opm
                 if (well_type_ == INJECTOR) {
                     // only single phase injection handled
                     const double* distr = well_controls_get_current_distr(well_controls_);
-                    if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+                    if (phaseIsActive(FluidSystem::waterPhaseIdx)) {
                         if (distr[pu.phase_pos[Water]] > 0.0) {
                             primary_variables_[seg][WFrac] = 1.0;
                         } else {
@@ -622,7 +705,7 @@ namespace Opm
                         }
                     }
 
-                    if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+                    if (phaseIsActive(FluidSystem::gasPhaseIdx)) {
                         if (distr[pu.phase_pos[Gas]] > 0.0) {
                             primary_variables_[seg][GFrac] = 1.0;
                         } else {
@@ -630,11 +713,11 @@ namespace Opm
                         }
                     }
                 } else if (well_type_ == PRODUCER) { // producers
-                    if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+                    if (phaseIsActive(FluidSystem::waterPhaseIdx)) {
                         primary_variables_[seg][WFrac] = 1.0 / number_of_phases_;
                     }
 
-                    if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+                    if (phaseIsActive(FluidSystem::gasPhaseIdx)) {
                         primary_variables_[seg][GFrac] = 1.0 / number_of_phases_;
                     }
                 }
@@ -655,7 +738,7 @@ namespace Opm
         // resWell = resWell - B * x
         duneB_.mmv(x, resWell);
         // xw = D^-1 * resWell
-        xw = mswellhelpers::invDXDirect(duneD_, resWell);
+        xw = solveD(resWell);
     }
 
 
@@ -669,7 +752,7 @@ namespace Opm
     {
         // We assemble the well equations, then we check the convergence,
         // which is why we do not put the assembleWellEq here.
-        const BVectorWell dx_well = mswellhelpers::invDXDirect(duneD_, resWell_);
+        const BVectorWell dx_well = solveD(resWell_);
 
         updateWellState(dx_well, false, well_state);
     }
@@ -767,13 +850,13 @@ namespace Opm
         const std::vector<std::array<double, numWellEq> > old_primary_variables = primary_variables_;
 
         for (int seg = 0; seg < numberOfSegments(); ++seg) {
-            if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+            if (phaseIsActive(FluidSystem::waterPhaseIdx)) {
                 const int sign = dwells[seg][WFrac] > 0. ? 1 : -1;
                 const double dx_limited = sign * std::min(std::abs(dwells[seg][WFrac]), relaxation_factor * dFLimit);
                 primary_variables_[seg][WFrac] = old_primary_variables[seg][WFrac] - dx_limited;
             }
 
-            if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+            if (phaseIsActive(FluidSystem::gasPhaseIdx)) {
                 const int sign = dwells[seg][GFrac] > 0. ? 1 : -1;
                 const double dx_limited = sign * std::min(std::abs(dwells[seg][GFrac]), relaxation_factor * dFLimit);
                 primary_variables_[seg][GFrac] = old_primary_variables[seg][GFrac] - dx_limited;
@@ -895,21 +978,21 @@ namespace Opm
     volumeFraction(const int seg, const unsigned compIdx) const
     {
 
-        if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx) && compIdx == Indices::canonicalToActiveComponentIndex(FluidSystem::waterCompIdx)) {
+        if (phaseIsActive(FluidSystem::waterPhaseIdx) && compIdx == Indices::canonicalToActiveComponentIndex(FluidSystem::waterCompIdx)) {
             return primary_variables_evaluation_[seg][WFrac];
         }
 
-        if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx) && compIdx == Indices::canonicalToActiveComponentIndex(FluidSystem::gasCompIdx)) {
+        if (phaseIsActive(FluidSystem::gasPhaseIdx) && compIdx == Indices::canonicalToActiveComponentIndex(FluidSystem::gasCompIdx)) {
             return primary_variables_evaluation_[seg][GFrac];
         }
 
         // Oil fraction
         EvalWell oil_fraction = 1.0;
-        if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+        if (phaseIsActive(FluidSystem::waterPhaseIdx)) {
             oil_fraction -= primary_variables_evaluation_[seg][WFrac];
         }
 
-        if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+        if (phaseIsActive(FluidSystem::gasPhaseIdx)) {
             oil_fraction -= primary_variables_evaluation_[seg][GFrac];
         }
         /* if (has_solvent) {
@@ -988,7 +1071,7 @@ namespace Opm
         std::vector<EvalWell> b_perfcells(num_components_, 0.0);
 
         for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx) {
-            if (!FluidSystem::phaseIsActive(phaseIdx)) {
+            if (!phaseIsActive(phaseIdx)) {
                 continue;
             }
 
@@ -1018,7 +1101,7 @@ namespace Opm
                 cq_s[comp_idx] = b_perfcells[comp_idx] * cq_p;
             }
 
-            if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx) && FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+            if (phaseIsActive(FluidSystem::oilPhaseIdx) && phaseIsActive(FluidSystem::gasPhaseIdx)) {
                 const unsigned oilCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::oilCompIdx);
                 const unsigned gasCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::gasCompIdx);
                 const EvalWell cq_s_oil = cq_s[oilCompIdx];
@@ -1043,12 +1126,12 @@ namespace Opm
 
             // compute volume ratio between connection and at standard conditions
             EvalWell volume_ratio = 0.0;
-            if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+            if (phaseIsActive(FluidSystem::waterPhaseIdx)) {
                 const unsigned waterCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::waterCompIdx);
                 volume_ratio += cmix_s[waterCompIdx] / b_perfcells[waterCompIdx];
             }
 
-            if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx) && FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+            if (phaseIsActive(FluidSystem::oilPhaseIdx) && phaseIsActive(FluidSystem::gasPhaseIdx)) {
                 const unsigned oilCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::oilCompIdx);
                 const unsigned gasCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::gasCompIdx);
 
@@ -1068,11 +1151,11 @@ namespace Opm
                 const EvalWell tmp_gas = (cmix_s[gasCompIdx] - rs * cmix_s[oilCompIdx]) / d;
                 volume_ratio += tmp_gas / b_perfcells[gasCompIdx];
             } else { // not having gas and oil at the same time
-                if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx)) {
+                if (phaseIsActive(FluidSystem::oilPhaseIdx)) {
                     const unsigned oilCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::oilCompIdx);
                     volume_ratio += cmix_s[oilCompIdx] / b_perfcells[oilCompIdx];
                 }
-                if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+                if (phaseIsActive(FluidSystem::gasPhaseIdx)) {
                     const unsigned gasCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::gasCompIdx);
                     volume_ratio += cmix_s[gasCompIdx] / b_perfcells[gasCompIdx];
                 }
@@ -1137,7 +1220,7 @@ namespace Opm
         std::vector<double> surf_dens(num_components_);
         // Surface density.
         for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx) {
-            if (!FluidSystem::phaseIsActive(phaseIdx)) {
+            if (!phaseIsActive(phaseIdx)) {
                 continue;
             }
 
@@ -1156,7 +1239,7 @@ namespace Opm
             std::vector<EvalWell> visc(num_components_, 0.0);
 
             const EvalWell seg_pressure = getSegmentPressure(seg);
-            if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+            if (phaseIsActive(FluidSystem::waterPhaseIdx)) {
                 const unsigned waterCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::waterCompIdx);
                 b[waterCompIdx] =
                     FluidSystem::waterPvt().inverseFormationVolumeFactor(pvt_region_index, temperature, seg_pressure);
@@ -1166,9 +1249,9 @@ namespace Opm
 
             EvalWell rv(0.0);
             // gas phase
-            if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+            if (phaseIsActive(FluidSystem::gasPhaseIdx)) {
                 const unsigned gasCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::gasCompIdx);
-                if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx)) {
+                if (phaseIsActive(FluidSystem::oilPhaseIdx)) {
                     const unsigned oilCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::oilCompIdx);
                     const EvalWell rvmax = FluidSystem::gasPvt().saturatedOilVaporizationFactor(pvt_region_index, temperature, seg_pressure);
                     if (mix_s[oilCompIdx] > 0.0) {
@@ -1200,9 +1283,9 @@ namespace Opm
 
             EvalWell rs(0.0);
             // oil phase
-            if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx)) {
+            if (phaseIsActive(FluidSystem::oilPhaseIdx)) {
                 const unsigned oilCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::oilCompIdx);
-                if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+                if (phaseIsActive(FluidSystem::gasPhaseIdx)) {
                     const unsigned gasCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::gasCompIdx);
                     const EvalWell rsmax = FluidSystem::oilPvt().saturatedGasDissolutionFactor(pvt_region_index, temperature, seg_pressure);
                     if (mix_s[gasCompIdx] > 0.0) {
@@ -1233,7 +1316,7 @@ namespace Opm
             }
 
             std::vector<EvalWell> mix(mix_s);
-            if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx) && FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+            if (phaseIsActive(FluidSystem::oilPhaseIdx) && phaseIsActive(FluidSystem::gasPhaseIdx)) {
                 const unsigned gasCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::gasCompIdx);
                 const unsigned oilCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::oilCompIdx);
 
@@ -1333,7 +1416,7 @@ namespace Opm
         if( satid == satid_elem ) { // the same saturation number is used. i.e. just use the mobilty from the cell
 
             for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx) {
-                if (!FluidSystem::phaseIsActive(phaseIdx)) {
+                if (!phaseIsActive(phaseIdx)) {
                     continue;
                 }
 
@@ -1354,7 +1437,7 @@ namespace Opm
 
             // compute the mobility
             for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx) {
-                if (!FluidSystem::phaseIsActive(phaseIdx)) {
+                if (!phaseIsActive(phaseIdx)) {
                     continue;
                 }
 
@@ -1514,16 +1597,12 @@ namespace Opm
         const EvalWell mass_rate = segment_mass_rates_[seg];
         const EvalWell density = segment_densities_[seg];
         const EvalWell visc = segment_viscosities_[seg];
-        const int outlet_segment_index = segmentNumberToIndex(segmentSet()[seg].outletSegment());
-        const double length = segmentSet()[seg].totalLength() - segmentSet()[outlet_segment_index].totalLength();
-        assert(length > 0.);
-        const double roughness = segmentSet()[seg].roughness();
-        const double area = segmentSet()[seg].crossArea();
-        const double diameter = segmentSet()[seg].internalDiameter();
+        const auto& geometry = segment_geometry_[seg];
+        assert(geometry.friction_factor > 0.);
 
         const double sign = mass_rate < 0. ? 1.0 : - 1.0;
 
-        return sign * mswellhelpers::frictionPressureLoss(length, diameter, area, roughness, density, mass_rate, visc);
+        return sign * mswellhelpers::frictionPressureLoss(geometry, density, mass_rate, visc);
     }
 
 
@@ -1537,10 +1616,11 @@ namespace Opm
     {
         // TODO: this pressure loss is not significant enough to be well tested yet.
         // handle the out velcocity head
-        const double area = segmentSet()[seg].crossArea();
+        const auto& geometry = segment_geometry_[seg];
+        const double area = geometry.area;
         const EvalWell mass_rate = segment_mass_rates_[seg];
         const EvalWell density = segment_densities_[seg];
-        const EvalWell out_velocity_head = mswellhelpers::velocityHead(area, mass_rate, density);
+        const EvalWell out_velocity_head = mswellhelpers::velocityHead(geometry, mass_rate, density);
 
         resWell_[seg][SPres] -= out_velocity_head.value();
         for (int pv_idx = 0; pv_idx < numWellEq; ++pv_idx) {
@@ -1550,7 +1630,7 @@ namespace Opm
         // calcuate the maximum cross-area among the segment and its inlet segments
         double max_area = area;
         for (const int inlet : segment_inlets_[seg]) {
-            const double inlet_area = segmentSet()[inlet].crossArea();
+            const double inlet_area = segment_geometry_[inlet].area;
             if (inlet_area > max_area) {
                 max_area = inlet_area;
             }
@@ -1560,7 +1640,7 @@ namespace Opm
         for (const int inlet : segment_inlets_[seg]) {
             const EvalWell density = segment_densities_[inlet];
             const EvalWell mass_rate = segment_mass_rates_[inlet];
-            const EvalWell inlet_velocity_head = mswellhelpers::velocityHead(area, mass_rate, density);
+            const EvalWell inlet_velocity_head = mswellhelpers::velocityHead(geometry, mass_rate, density);
             resWell_[seg][SPres] += inlet_velocity_head.value();
             for (int pv_idx = 0; pv_idx < numWellEq; ++pv_idx) {
                 duneD_[seg][inlet][SPres][pv_idx] += inlet_velocity_head.derivative(pv_idx + numEq);
@@ -1581,26 +1661,26 @@ namespace Opm
 
         std::vector<double> fractions(number_of_phases_, 0.0);
 
-        assert( FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx) );
+        assert( phaseIsActive(FluidSystem::oilPhaseIdx) );
         const int oil_pos = pu.phase_pos[Oil];
         fractions[oil_pos] = 1.0;
 
-        if ( FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx) ) {
+        if ( phaseIsActive(FluidSystem::waterPhaseIdx) ) {
             const int water_pos = pu.phase_pos[Water];
             fractions[water_pos] = primary_variables_[seg][WFrac];
             fractions[oil_pos] -= fractions[water_pos];
         }
 
-        if ( FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx) ) {
+        if ( phaseIsActive(FluidSystem::gasPhaseIdx) ) {
             const int gas_pos = pu.phase_pos[Gas];
             fractions[gas_pos] = primary_variables_[seg][GFrac];
             fractions[oil_pos] -= fractions[gas_pos];
         }
 
-        if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+        if (phaseIsActive(FluidSystem::waterPhaseIdx)) {
             const int water_pos = pu.phase_pos[Water];
             if (fractions[water_pos] < 0.0) {
-                if ( FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx) ) {
+                if ( phaseIsActive(FluidSystem::gasPhaseIdx) ) {
                     fractions[pu.phase_pos[Gas]] /= (1.0 - fractions[water_pos]);
                 }
                 fractions[oil_pos] /= (1.0 - fractions[water_pos]);
@@ -1608,10 +1688,10 @@ namespace Opm
             }
         }
 
-        if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+        if (phaseIsActive(FluidSystem::gasPhaseIdx)) {
             const int gas_pos = pu.phase_pos[Gas];
             if (fractions[gas_pos] < 0.0) {
-                if ( FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx) ) {
+                if ( phaseIsActive(FluidSystem::waterPhaseIdx) ) {
                     fractions[pu.phase_pos[Water]] /= (1.0 - fractions[gas_pos]);
                 }
                 fractions[oil_pos] /= (1.0 - fractions[gas_pos]);
@@ -1620,20 +1700,20 @@ namespace Opm
         }
 
         if (fractions[oil_pos] < 0.0) {
-            if ( FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx) ) {
+            if ( phaseIsActive(FluidSystem::waterPhaseIdx) ) {
                 fractions[pu.phase_pos[Water]] /= (1.0 - fractions[oil_pos]);
             }
-            if ( FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx) ) {
+            if ( phaseIsActive(FluidSystem::gasPhaseIdx) ) {
                 fractions[pu.phase_pos[Gas]] /= (1.0 - fractions[oil_pos]);
             }
             fractions[oil_pos] = 0.0;
         }
 
-        if ( FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx) ) {
+        if ( phaseIsActive(FluidSystem::waterPhaseIdx) ) {
             primary_variables_[seg][WFrac] = fractions[pu.phase_pos[Water]];
         }
 
-        if ( FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx) ) {
+        if ( phaseIsActive(FluidSystem::gasPhaseIdx) ) {
             primary_variables_[seg][GFrac] = fractions[pu.phase_pos[Gas]];
         }
     }
@@ -1650,7 +1730,7 @@ namespace Opm
     {
         const std::string msg = "Support of well operability checking for multisegment wells is not implemented "
                                 "yet, checkWellOperability() for " + name() + " will do nothing";
-        OpmLog::warning("NO_OPERATABILITY_CHECKING_MS_WELLS", msg);
+        deferred_logger_.warning("NO_OPERATABILITY_CHECKING_MS_WELLS", msg);
     }
 
 
@@ -1663,20 +1743,20 @@ namespace Opm
     updateWellStateFromPrimaryVariables(WellState& well_state) const
     {
         const PhaseUsage& pu = phaseUsage();
-        assert( FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx) );
+        assert( phaseIsActive(FluidSystem::oilPhaseIdx) );
         const int oil_pos = pu.phase_pos[Oil];
 
         for (int seg = 0; seg < numberOfSegments(); ++seg) {
             std::vector<double> fractions(number_of_phases_, 0.0);
             fractions[oil_pos] = 1.0;
 
-            if ( FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx) ) {
+            if ( phaseIsActive(FluidSystem::waterPhaseIdx) ) {
                 const int water_pos = pu.phase_pos[Water];
                 fractions[water_pos] = primary_variables_[seg][WFrac];
                 fractions[oil_pos] -= fractions[water_pos];
             }
 
-            if ( FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx) ) {
+            if ( phaseIsActive(FluidSystem::gasPhaseIdx) ) {
                 const int gas_pos = pu.phase_pos[Gas];
                 fractions[gas_pos] = primary_variables_[seg][GFrac];
                 fractions[oil_pos] -= fractions[gas_pos];
@@ -1759,7 +1839,7 @@ namespace Opm
 
             assembleWellEqWithoutIteration(ebosSimulator, dt, well_state);
 
-            const BVectorWell dx_well = mswellhelpers::invDXDirect(duneD_, resWell_);
+            const BVectorWell dx_well = solveD(resWell_);
 
             // TODO: use these small values for now, not intend to reach the convergence
             // in this stage, but, should we?
@@ -1886,6 +1966,67 @@ namespace Opm
                 assemblePressureEq(seg);
             }
         }
+
+        factorizeD();
+    }
+
+
+
+
+
+    template<typename TypeTag>
+    void
+    MultisegmentWell<TypeTag>::
+    factorizeD() const
+    {
+        if (duneDTreeSolver_.update(duneD_, segment_inlets_)) {
+            return;
+        }
+#if HAVE_UMFPACK
+        try
+        {
+            duneDSolver_.update(duneD_);
+        }
+        catch (const Opm::LinearSolverProblem&)
+        {
+            OPM_THROW(Opm::NumericalIssue, "Error when factorizing the equations of multi-segment well " + name());
+        }
+#endif // HAVE_UMFPACK
+    }
+
+
+
+
+
+    template<typename TypeTag>
+    typename MultisegmentWell<TypeTag>::BVectorWell
+    MultisegmentWell<TypeTag>::
+    solveD(const BVectorWell& x) const
+    {
+        BVectorWell y(x.size());
+        solveD(x, y);
+        return y;
+    }
+
+
+
+
+
+    template<typename TypeTag>
+    void
+    MultisegmentWell<TypeTag>::
+    solveD(const BVectorWell& x, BVectorWell& y) const
+    {
+        if (duneDTreeSolver_.factorized()) {
+            mswellhelpers::solveDirect(duneDTreeSolver_, x, y);
+            return;
+        }
+#if HAVE_UMFPACK
+        mswellhelpers::solveDirect(duneDSolver_, x, y);
+#else
+        // throws without UMFPACK
+        y = mswellhelpers::invDXDirect(duneD_, x);
+#endif // HAVE_UMFPACK
     }
 
 
@@ -1901,7 +2042,7 @@ namespace Opm
     {
         const std::string msg = "Support of well testing for physical limits for multisegment wells is not "
                                 "implemented yet, wellTestingPhysical() for " + name() + " will do nothing";
-        OpmLog::warning("NO_WELLTESTPHYSICAL_CHECKING_MS_WELLS", msg);
+        deferred_logger_.warning("NO_WELLTESTPHYSICAL_CHECKING_MS_WELLS", msg);
     }
 
 
@@ -0,0 +1,179 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_NEWTONTRACE_HEADER_INCLUDED
+#define OPM_NEWTONTRACE_HEADER_INCLUDED
+
+#include <opm/common/ErrorMacros.hpp>
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Opm
+{
+
+    /// \brief A CSV file with one line per Newton iteration.
+    ///
+    /// Each line holds the residuals (MB and CNV for each component), the
+    /// number of well convergence failures, the linear iterations, the
+    /// relaxation factor, the times of assembly, linear solve and update and
+    /// the number of cells whose update switched the primary variables or was
+    /// chopped in one iteration. The lines are formatted and written by a thread of
+    /// their own, hence the simulation only waits for the records to be
+    /// queued. The destructor writes all queued records.
+    class NewtonTrace
+    {
+    public:
+        /// \brief The data of one Newton iteration.
+        struct Record
+        {
+            int report_step = 0;
+            int sub_step = 0;
+            int iteration = 0;
+            double dt = 0.0;
+            bool converged = false;
+            std::vector<double> mass_balance;
+            std::vector<double> cnv;
+            int well_failures = 0;
+            int linear_iterations = 0;
+            double relaxation = 1.0;
+            double assemble_time = 0.0;
+            double linear_solve_time = 0.0;
+            double update_time = 0.0;
+            int switched_cells = 0;
+            int chopped_cells = 0;
+        };
+
+        /// \brief Open the file and start the writing thread.
+        /// \param fileName The name of the file, which is overwritten.
+        /// \param componentNames The names of the components, in the order of the residuals.
+        NewtonTrace(const std::string& fileName, const std::vector<std::string>& componentNames)
+            : file_(fileName), done_(false)
+        {
+            if ( !file_ )
+            {
+                OPM_THROW(std::runtime_error, "Could not open the Newton trace file " << fileName);
+            }
+            writeHeader(file_, componentNames);
+            writer_ = std::thread([this]() { writeQueued(); });
+        }
+
+        ~NewtonTrace()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                done_ = true;
+            }
+            wakeup_.notify_one();
+            writer_.join();
+        }
+
+        NewtonTrace(const NewtonTrace&) = delete;
+        NewtonTrace& operator=(const NewtonTrace&) = delete;
+
+        /// \brief Queue a record for writing.
+        void push(Record record)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                queue_.push_back(std::move(record));
+            }
+            wakeup_.notify_one();
+        }
+
+        /// \brief Write the column names.
+        static void writeHeader(std::ostream& os, const std::vector<std::string>& componentNames)
+        {
+            os << "report_step,sub_step,iteration,dt,converged";
+            for ( const auto& name : componentNames )
+            {
+                os << ",mb_" << name;
+            }
+            for ( const auto& name : componentNames )
+            {
+                os << ",cnv_" << name;
+            }
+            os << ",well_failures,linear_iterations,relaxation,assemble_time,linear_solve_time,update_time,switched_cells,chopped_cells\n";
+        }
+
+        /// \brief Write a record as one line.
+        static void writeCsv(std::ostream& os, const Record& record)
+        {
+            os << record.report_step << "," << record.sub_step << "," << record.iteration << ","
+               << std::setprecision(9) << record.dt << "," << record.converged;
+            for ( const double mb : record.mass_balance )
+            {
+                os << "," << mb;
+            }
+            for ( const double cnv : record.cnv )
+            {
+                os << "," << cnv;
+            }
+            os << "," << record.well_failures << "," << record.linear_iterations << ","
+               << record.relaxation << "," << record.assemble_time << ","
+               << record.linear_solve_time << "," << record.update_time << ","
+               << record.switched_cells << "," << record.chopped_cells << "\n";
+        }
+
+    private:
+        void writeQueued()
+        {
+            std::deque<Record> records;
+            std::unique_lock<std::mutex> lock(mutex_);
+            while ( true )
+            {
+                wakeup_.wait(lock, [this]() { return done_ || !queue_.empty(); });
+                records.swap(queue_);
+                const bool done = done_;
+                // the simulation can go on queueing while this batch is written
+                lock.unlock();
+                for ( const auto& record : records )
+                {
+                    writeCsv(file_, record);
+                }
+                records.clear();
+                file_.flush();
+                lock.lock();
+                if ( done && queue_.empty() )
+                {
+                    return;
+                }
+            }
+        }
+
+        std::ofstream file_;
+        std::deque<Record> queue_;
+        std::mutex mutex_;
+        std::condition_variable wakeup_;
+        bool done_;
+        std::thread writer_;
+    };
+
+} // namespace Opm
+
+#endif // OPM_NEWTONTRACE_HEADER_INCLUDED
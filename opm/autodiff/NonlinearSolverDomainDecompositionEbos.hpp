@@ -0,0 +1,133 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_NON_LINEAR_SOLVER_DOMAIN_DECOMPOSITION_EBOS_HPP
+#define OPM_NON_LINEAR_SOLVER_DOMAIN_DECOMPOSITION_EBOS_HPP
+
+#include <opm/autodiff/NonlinearSolverEbos.hpp>
+
+BEGIN_PROPERTIES
+
+NEW_PROP_TAG(NonlinearDomains);
+NEW_PROP_TAG(NonlinearDomainMaxIterations);
+
+SET_INT_PROP(FlowNonLinearSolver, NonlinearDomains, 0);
+SET_INT_PROP(FlowNonLinearSolver, NonlinearDomainMaxIterations, 3);
+
+END_PROPERTIES
+
+namespace Opm {
+
+
+    /// A nonlinear solver that first iterates on subdomains independently
+    /// (nonlinear domain decomposition) and then does the Newton iterations
+    /// of NonlinearSolverEbos for the whole model.
+    ///
+    /// The cells are split into NonlinearDomains parts. In each iteration of
+    /// the first phase, the model computes the Newton updates of all
+    /// subdomains that are not converged yet, with the unknowns of the other
+    /// subdomains fixed (see BlackoilModelEbos::nonlinearIterationDomains()).
+    /// The global Newton iterations then only have to resolve the coupling
+    /// between the subdomains, which reduces the number of time step cuts
+    /// caused by a few strongly nonlinear regions. With less than two
+    /// subdomains the solver does the same as NonlinearSolverEbos.
+    template <class TypeTag, class PhysicalModel>
+    class NonlinearSolverDomainDecompositionEbos
+        : public NonlinearSolverEbos<TypeTag, PhysicalModel>
+    {
+        typedef NonlinearSolverEbos<TypeTag, PhysicalModel> Base;
+
+    public:
+        // Solver parameters controlling nonlinear process.
+        struct SolverParameters : public Base::SolverParameters
+        {
+            int numDomains_; // number of subdomains (< 2: no domain decomposition)
+            int maxDomainIter_; // max iterations on the subdomains
+
+            SolverParameters()
+            {
+                numDomains_ = EWOMS_GET_PARAM(TypeTag, int, NonlinearDomains);
+                maxDomainIter_ = EWOMS_GET_PARAM(TypeTag, int, NonlinearDomainMaxIterations);
+            }
+
+            static void registerParameters()
+            {
+                Base::SolverParameters::registerParameters();
+                EWOMS_REGISTER_PARAM(TypeTag, int, NonlinearDomains, "The number of subdomains whose nonlinear problems are iterated on independently before the Newton iterations of the whole model. Less than 2 disables the domain decomposition");
+                EWOMS_REGISTER_PARAM(TypeTag, int, NonlinearDomainMaxIterations, "The maximum number of iterations on the subdomains per time step");
+            }
+        };
+
+        /// Construct solver for a given model.
+        ///
+        /// \param[in]      param   parameters controlling nonlinear process
+        /// \param[in, out] model   physical simulation model.
+        NonlinearSolverDomainDecompositionEbos(const SolverParameters& param,
+                                               std::unique_ptr<PhysicalModel> model)
+            : Base(param, std::move(model))
+            , domainParam_(param)
+        {
+        }
+
+        SimulatorReport step(const SimulatorTimerInterface& timer)
+        {
+            if (domainParam_.numDomains_ < 2) {
+                return Base::step(timer);
+            }
+
+            SimulatorReport report;
+            this->failureReport_ = SimulatorReport();
+
+            // Do model-specific once-per-step calculations.
+            this->model().prepareStep(timer);
+
+            for (int iteration = 0; iteration < domainParam_.maxDomainIter_; ++iteration) {
+                SimulatorReport iterReport;
+                try {
+                    iterReport = this->model().nonlinearIterationDomains(iteration, timer, domainParam_.numDomains_);
+                }
+                catch (...) {
+                    this->failureReport_ += report;
+                    this->failureReport_ += this->model().failureReport();
+                    throw;
+                }
+                report += iterReport;
+                // all subdomains are converged
+                if (iterReport.converged) {
+                    break;
+                }
+            }
+            report.converged = false;
+
+            return this->newtonIterations(timer, report);
+        }
+
+        /// Set parameters to override those given at construction time.
+        void setParameters(const SolverParameters& param)
+        {
+            Base::setParameters(param);
+            domainParam_ = param;
+        }
+
+    private:
+        SolverParameters domainParam_;
+    };
+} // namespace Opm
+
+#endif // OPM_NON_LINEAR_SOLVER_DOMAIN_DECOMPOSITION_EBOS_HPP
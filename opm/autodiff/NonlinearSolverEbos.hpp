@@ -21,6 +21,8 @@
 #ifndef OPM_NON_LINEAR_SOLVER_EBOS_HPP
 #define OPM_NON_LINEAR_SOLVER_EBOS_HPP
 
+#include <opm/autodiff/AndersonAcceleration.hpp>
+#include <opm/autodiff/TimingRegistry.hpp>
 #include <opm/core/simulator/SimulatorReport.hpp>
 #include <opm/common/utility/parameters/ParameterGroup.hpp>
 #include <opm/common/ErrorMacros.hpp>
@@ -32,6 +34,7 @@
 
 #include <dune/common/fmatrix.hh>
 #include <dune/istl/bcrsmatrix.hh>
+#include <algorithm>
 #include <memory>
 
 BEGIN_PROPERTIES
@@ -43,11 +46,17 @@ NEW_PROP_TAG(NewtonMaxRelax);
 NEW_PROP_TAG(FlowNewtonMaxIterations);
 NEW_PROP_TAG(FlowNewtonMinIterations);
 NEW_PROP_TAG(NewtonRelaxationType);
+NEW_PROP_TAG(NewtonAndersonDepth);
+NEW_PROP_TAG(NewtonDivergenceFactor);
+NEW_PROP_TAG(NewtonDivergenceIterations);
 
 SET_SCALAR_PROP(FlowNonLinearSolver, NewtonMaxRelax, 0.5);
 SET_INT_PROP(FlowNonLinearSolver, FlowNewtonMaxIterations, 20);
 SET_INT_PROP(FlowNonLinearSolver, FlowNewtonMinIterations, 1);
 SET_STRING_PROP(FlowNonLinearSolver, NewtonRelaxationType, "dampen");
+SET_INT_PROP(FlowNonLinearSolver, NewtonAndersonDepth, 3);
+SET_SCALAR_PROP(FlowNonLinearSolver, NewtonDivergenceFactor, 0.0);
+SET_INT_PROP(FlowNonLinearSolver, NewtonDivergenceIterations, 3);
 
 END_PROPERTIES
 
@@ -65,7 +74,8 @@ namespace Opm {
         // Available relaxation scheme types.
         enum RelaxType {
             Dampen,
-            SOR
+            SOR,
+            Anderson
         };
 
         // Solver parameters controlling nonlinear process.
@@ -77,6 +87,9 @@ namespace Opm {
             double relaxRelTol_;
             int maxIter_; // max nonlinear iterations
             int minIter_; // min nonlinear iterations
+            int andersonDepth_; // number of previous updates combined by Anderson acceleration
+            double divergenceFactor_; // growth of the residual which fails the time step early, 0 to disable
+            int divergenceIterations_; // number of iterations the residual has to grow in a row
 
             SolverParameters()
             {
@@ -87,12 +100,17 @@ namespace Opm {
                 relaxMax_ = EWOMS_GET_PARAM(TypeTag, Scalar, NewtonMaxRelax);
                 maxIter_ = EWOMS_GET_PARAM(TypeTag, int, FlowNewtonMaxIterations);
                 minIter_ = EWOMS_GET_PARAM(TypeTag, int, FlowNewtonMinIterations);
+                divergenceFactor_ = EWOMS_GET_PARAM(TypeTag, Scalar, NewtonDivergenceFactor);
+                divergenceIterations_ = EWOMS_GET_PARAM(TypeTag, int, NewtonDivergenceIterations);
+                andersonDepth_ = EWOMS_GET_PARAM(TypeTag, int, NewtonAndersonDepth);
 
                 const auto& relaxationTypeString = EWOMS_GET_PARAM(TypeTag, std::string, NewtonRelaxationType);
                 if (relaxationTypeString == "dampen") {
                     relaxType_ = Dampen;
                 } else if (relaxationTypeString == "sor") {
                     relaxType_ = SOR;
+                } else if (relaxationTypeString == "anderson") {
+                    relaxType_ = Anderson;
                 } else {
                     OPM_THROW(std::runtime_error, "Unknown Relaxtion Type " << relaxationTypeString);
                 }
@@ -103,7 +121,10 @@ namespace Opm {
                 EWOMS_REGISTER_PARAM(TypeTag, Scalar, NewtonMaxRelax, "The maximum relaxation factor of a Newton iteration used by flow");
                 EWOMS_REGISTER_PARAM(TypeTag, int, FlowNewtonMaxIterations, "The maximum number of Newton iterations per time step used by flow");
                 EWOMS_REGISTER_PARAM(TypeTag, int, FlowNewtonMinIterations, "The minimum number of Newton iterations per time step used by flow");
-                EWOMS_REGISTER_PARAM(TypeTag, std::string, NewtonRelaxationType, "The type of relaxation used by flow's Newton method");
+                EWOMS_REGISTER_PARAM(TypeTag, std::string, NewtonRelaxationType, "The type of relaxation used by flow's Newton method: 'dampen', 'sor' or 'anderson' (combine the last updates once oscillations are detected)");
+                EWOMS_REGISTER_PARAM(TypeTag, int, NewtonAndersonDepth, "The number of previous Newton updates combined with the current one by the 'anderson' relaxation");
+                EWOMS_REGISTER_PARAM(TypeTag, Scalar, NewtonDivergenceFactor, "Fail a time step as soon as the largest residual grew by this factor over the first Newton iteration, instead of when the iteration limit is reached (0 to disable)");
+                EWOMS_REGISTER_PARAM(TypeTag, int, NewtonDivergenceIterations, "The number of Newton iterations in a row the largest residual has to grow before the time step is failed by NewtonDivergenceFactor");
             }
 
             void reset()
@@ -115,6 +136,9 @@ namespace Opm {
                 relaxRelTol_ = 0.2;
                 maxIter_ = 10;
                 minIter_ = 1;
+                andersonDepth_ = 3;
+                divergenceFactor_ = 0.0;
+                divergenceIterations_ = 3;
             }
 
         };
@@ -142,6 +166,7 @@ namespace Opm {
             , nonlinearIterationsLast_(0)
             , linearIterationsLast_(0)
             , wellIterationsLast_(0)
+            , anderson_(param.andersonDepth_)
         {
             if (!model_) {
                 OPM_THROW(std::logic_error, "Must provide a non-null model argument for NonlinearSolver.");
@@ -151,56 +176,15 @@ namespace Opm {
 
         SimulatorReport step(const SimulatorTimerInterface& timer)
         {
-            SimulatorReport iterReport;
-            SimulatorReport report;
+            static auto& timing = TimingRegistry::instance().entry("timestep");
+            ScopedTiming scopedTiming(timing);
+
             failureReport_ = SimulatorReport();
 
             // Do model-specific once-per-step calculations.
             model_->prepareStep(timer);
 
-            int iteration = 0;
-
-            // Let the model do one nonlinear iteration.
-
-            // Set up for main solver loop.
-            bool converged = false;
-
-            // ----------  Main nonlinear solver loop  ----------
-            do {
-                try {
-                    // Do the nonlinear step. If we are in a converged state, the
-                    // model will usually do an early return without an expensive
-                    // solve, unless the minIter() count has not been reached yet.
-                    iterReport = model_->nonlinearIteration(iteration, timer, *this);
-
-                    report += iterReport;
-                    report.converged = iterReport.converged;
-
-                    converged = report.converged;
-                    iteration += 1;
-                }
-                catch (...) {
-                    // if an iteration fails during a time step, all previous iterations
-                    // count as a failure as well
-                    failureReport_ += report;
-                    failureReport_ += model_->failureReport();
-                    throw;
-                }
-            }
-            while ( (!converged && (iteration <= maxIter())) || (iteration <= minIter()));
-
-            if (!converged) {
-                failureReport_ += report;
-
-                std::string msg = "Solver convergence failure - Failed to complete a time step within " + std::to_string(maxIter()) + " iterations.";
-                OPM_THROW_NOLOG(Opm::TooManyIterations, msg);
-            }
-
-            // Do model-specific post-step actions.
-            model_->afterStep(timer);
-            report.converged = true;
-
-            return report;
+            return newtonIterations(timer, SimulatorReport());
         }
 
         /// return the statistics if the step() method failed
@@ -248,7 +232,9 @@ namespace Opm {
         { return *model_; }
 
         /// Detect oscillation or stagnation in a given residual history.
-        void detectOscillations(const std::vector<std::vector<double>>& residualHistory,
+        /// \tparam History A vector of the residual norms of each iteration.
+        template <class History>
+        void detectOscillations(const History& residualHistory,
                                 const int it, bool& oscillate, bool& stagnate) const
         {
             // The detection of oscillation in two primary variable results in the report of the detection
@@ -264,9 +250,9 @@ namespace Opm {
 
             stagnate = true;
             int oscillatePhase = 0;
-            const std::vector<double>& F0 = residualHistory[it];
-            const std::vector<double>& F1 = residualHistory[it - 1];
-            const std::vector<double>& F2 = residualHistory[it - 2];
+            const auto& F0 = residualHistory[it];
+            const auto& F1 = residualHistory[it - 1];
+            const auto& F2 = residualHistory[it - 2];
             for (int p= 0; p < model_->numPhases(); ++p){
                 const double d1 = std::abs((F0[p] - F2[p]) / F0[p]);
                 const double d2 = std::abs((F0[p] - F1[p]) / F0[p]);
@@ -282,8 +268,38 @@ namespace Opm {
         }
 
 
+        /// Detect a diverging Newton process in a given residual history: the
+        /// largest residual norm grew in each of the last divergence iterations
+        /// and exceeds the one of the first iteration by the divergence factor.
+        /// The time step is then cut without running up to maxIter() iterations.
+        /// \tparam History A vector of the residual norms of each iteration.
+        template <class History>
+        bool detectDivergence(const History& residualHistory, const int it) const
+        {
+            const int numGrowing = std::max(param_.divergenceIterations_, 1);
+            if ( param_.divergenceFactor_ <= 0.0 || it < numGrowing ) {
+                return false;
+            }
+
+            const auto maxNorm = [&residualHistory](const int i) {
+                const auto& norms = residualHistory[i];
+                return *std::max_element(norms.begin(), norms.end());
+            };
+            for (int i = it - numGrowing + 1; i <= it; ++i) {
+                if ( !(maxNorm(i) > maxNorm(i - 1)) ) {
+                    return false;
+                }
+            }
+            return maxNorm(it) > param_.divergenceFactor_ * maxNorm(0);
+        }
+
+
         /// Apply a stabilization to dx, depending on dxOld and relaxation parameters.
         /// Implemention for Dune block vectors.
+        ///
+        /// The Anderson relaxation records all updates of a time step. Once an
+        /// oscillation has lowered omega below 1, it replaces dx by the
+        /// combination of the last updates instead of dampening it.
         template <class BVector>
         void stabilizeNonlinearUpdate(BVector& dx, BVector& dxOld, const double omega) const
         {
@@ -294,6 +310,11 @@ namespace Opm {
             dxOld = dx;
 
             switch (relaxType()) {
+            case Anderson: {
+                anderson_.apply(dx, model_->interiorCells(),
+                                model_->ebosSimulator().gridView().comm(), omega < 1.);
+                return;
+            }
             case Dampen: {
                 if (omega == 1.) {
                     return;
@@ -317,7 +338,7 @@ namespace Opm {
                 return;
             }
             default:
-                OPM_THROW(std::runtime_error, "Can only handle Dampen and SOR relaxation type.");
+                OPM_THROW(std::runtime_error, "Can only handle Dampen, SOR and Anderson relaxation type.");
             }
 
             return;
@@ -349,11 +370,73 @@ namespace Opm {
 
         /// Set parameters to override those given at construction time.
         void setParameters(const SolverParameters& param)
-        { param_ = param; }
+        {
+            param_ = param;
+            anderson_ = AndersonAcceleration<typename PhysicalModel::BVector>(param.andersonDepth_);
+        }
+
+    protected:
+        /// The Newton iterations of a time step after model_->prepareStep().
+        /// \param[in] timer    simulation timer
+        /// \param[in] report   the statistics of the work already done for the step
+        SimulatorReport newtonIterations(const SimulatorTimerInterface& timer,
+                                         SimulatorReport report)
+        {
+            SimulatorReport iterReport;
+            int iteration = 0;
+            // the updates of the last time step are not related to the new ones
+            anderson_.reset();
+
+            // Let the model do one nonlinear iteration.
+
+            // Set up for main solver loop.
+            bool converged = false;
+
+            // ----------  Main nonlinear solver loop  ----------
+            do {
+                try {
+                    static auto& timing = TimingRegistry::instance().entry("newton.iteration");
+                    ScopedTiming scopedTiming(timing);
+
+                    // Do the nonlinear step. If we are in a converged state, the
+                    // model will usually do an early return without an expensive
+                    // solve, unless the minIter() count has not been reached yet.
+                    iterReport = model_->nonlinearIteration(iteration, timer, *this);
+
+                    report += iterReport;
+                    report.converged = iterReport.converged;
+
+                    converged = report.converged;
+                    iteration += 1;
+                }
+                catch (...) {
+                    // if an iteration fails during a time step, all previous iterations
+                    // count as a failure as well
+                    failureReport_ += report;
+                    failureReport_ += model_->failureReport();
+                    throw;
+                }
+            }
+            while ( (!converged && (iteration <= maxIter())) || (iteration <= minIter()));
+
+            if (!converged) {
+                failureReport_ += report;
+
+                std::string msg = "Solver convergence failure - Failed to complete a time step within " + std::to_string(maxIter()) + " iterations.";
+                OPM_THROW_NOLOG(Opm::TooManyIterations, msg);
+            }
+
+            // Do model-specific post-step actions.
+            model_->afterStep(timer);
+            report.converged = true;
+
+            return report;
+        }
+
+        SimulatorReport failureReport_;
 
     private:
         // ---------  Data members  ---------
-        SimulatorReport failureReport_;
         SolverParameters param_;
         std::unique_ptr<PhysicalModel> model_;
         int linearizations_;
@@ -363,6 +446,8 @@ namespace Opm {
         int nonlinearIterationsLast_;
         int linearIterationsLast_;
         int wellIterationsLast_;
+        // the history of the Newton updates of the time step (relaxType_ Anderson)
+        mutable AndersonAcceleration<typename PhysicalModel::BVector> anderson_;
     };
 } // namespace Opm
 
@@ -0,0 +1,171 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_PACKEDWELLCONTRIBUTIONS_HEADER_INCLUDED
+#define OPM_PACKEDWELLCONTRIBUTIONS_HEADER_INCLUDED
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+
+#include <opm/autodiff/LinearSystemIO.hpp>
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+namespace Opm
+{
+
+    /// \brief The Schur complement contributions C^T D^-1 B of many wells
+    ///        stored in contiguous arrays.
+    ///
+    /// The well matrices of all wells with the same number of well equations
+    /// are gathered once per linearization. Applying the correction of all
+    /// wells is then one sweep over these arrays without virtual calls or
+    /// per well sparse matrix overhead.
+    /// \tparam Scalar The type of the matrix entries.
+    /// \tparam numEq The number of reservoir equations per cell.
+    /// \tparam numWellEq The number of equations per well.
+    template<class Scalar, int numEq, int numWellEq>
+    class PackedWellContributions
+    {
+    public:
+        typedef Dune::FieldMatrix<Scalar, numWellEq, numEq> OffDiagBlock;
+        typedef Dune::FieldMatrix<Scalar, numWellEq, numWellEq> DiagBlock;
+        typedef Dune::FieldVector<Scalar, numWellEq> WellVector;
+
+        PackedWellContributions()
+            : wellStart_(1, 0)
+        {}
+
+        /// \brief Remove all wells but keep the memory.
+        void clear()
+        {
+            wellStart_.resize(1);
+            cells_.clear();
+            B_.clear();
+            C_.clear();
+            invD_.clear();
+        }
+
+        /// \brief Whether no well was added.
+        bool empty() const
+        {
+            return invD_.empty();
+        }
+
+        /// \brief Start adding a new well.
+        /// \param invD The inverse of the well equation matrix D.
+        void beginWell(const DiagBlock& invD)
+        {
+            invD_.push_back(invD);
+            wellStart_.push_back(cells_.size());
+        }
+
+        /// \brief Add a perforation of the well started last.
+        /// \param cell The index of the perforated cell.
+        /// \param B The derivatives of the well equations w.r.t. the cell unknowns.
+        /// \param C The derivatives of the cell equations w.r.t. the well unknowns (transposed).
+        void addPerforation(const int cell, const OffDiagBlock& B, const OffDiagBlock& C)
+        {
+            assert( !invD_.empty() );
+            cells_.push_back(cell);
+            B_.push_back(B);
+            C_.push_back(C);
+            ++wellStart_.back();
+        }
+
+        /// \brief Ax = Ax - C^T D^-1 B x for all wells.
+        template<class X, class Y>
+        void apply(const X& x, Y& Ax) const
+        {
+            const std::size_t numWells = invD_.size();
+            for ( std::size_t w = 0; w < numWells; ++w )
+            {
+                const std::size_t perfBegin = wellStart_[w];
+                const std::size_t perfEnd   = wellStart_[w+1];
+
+                WellVector Bx(0.0);
+                for ( std::size_t perf = perfBegin; perf < perfEnd; ++perf )
+                {
+                    B_[perf].umv(x[cells_[perf]], Bx);
+                }
+
+                WellVector invDBx;
+                invD_[w].mv(Bx, invDBx);
+
+                for ( std::size_t perf = perfBegin; perf < perfEnd; ++perf )
+                {
+                    C_[perf].mmtv(invDBx, Ax[cells_[perf]]);
+                }
+            }
+        }
+
+        /// \brief Write all wells in the format of LinearSystemIO.
+        void write(std::ostream& os) const
+        {
+            LinearSystemIO::writeValue(os, static_cast<std::int32_t>(numWellEq));
+            LinearSystemIO::writeArray(os, wellStart_);
+            LinearSystemIO::writeArray(os, cells_);
+            LinearSystemIO::writeArray(os, B_);
+            LinearSystemIO::writeArray(os, C_);
+            LinearSystemIO::writeArray(os, invD_);
+        }
+
+        /// \brief Replace all wells by the ones read from a stream written with write.
+        void read(std::istream& is)
+        {
+            if ( LinearSystemIO::readValue<std::int32_t>(is) != numWellEq )
+            {
+                OPM_THROW(std::runtime_error, "The wells in the linear system file have a different number of equations");
+            }
+            LinearSystemIO::readArray(is, wellStart_);
+            LinearSystemIO::readArray(is, cells_);
+            LinearSystemIO::readArray(is, B_);
+            LinearSystemIO::readArray(is, C_);
+            LinearSystemIO::readArray(is, invD_);
+            if ( wellStart_.size() != invD_.size() + 1 || wellStart_.back() != cells_.size()
+                 || B_.size() != cells_.size() || C_.size() != cells_.size() )
+            {
+                OPM_THROW(std::runtime_error, "Corrupt wells in linear system file");
+            }
+        }
+
+        /// \brief The bytes of the arrays, for the memory report.
+        std::size_t memory() const
+        {
+            return wellStart_.capacity() * sizeof(std::size_t) + cells_.capacity() * sizeof(int)
+                + (B_.capacity() + C_.capacity()) * sizeof(OffDiagBlock) + invD_.capacity() * sizeof(DiagBlock);
+        }
+
+    private:
+        //! \brief The first perforation of each well (and the number of perforations at the end).
+        std::vector<std::size_t> wellStart_;
+        //! \brief The perforated cell of each perforation.
+        std::vector<int> cells_;
+        //! \brief The blocks of B and C for each perforation.
+        std::vector<OffDiagBlock> B_;
+        std::vector<OffDiagBlock> C_;
+        //! \brief The inverse of D for each well.
+        std::vector<DiagBlock> invD_;
+    };
+
+} // namespace Opm
+
+#endif // OPM_PACKEDWELLCONTRIBUTIONS_HEADER_INCLUDED
@@ -0,0 +1,637 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_PADDEDEVALUATION_HEADER_INCLUDED
+#define OPM_PADDEDEVALUATION_HEADER_INCLUDED
+
+#include <opm/material/common/MathToolbox.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <ostream>
+#include <type_traits>
+
+#if defined(__AVX__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace Opm
+{
+namespace PaddedAd
+{
+    namespace detail
+    {
+        /// The number of values of a SIMD register.
+        template <class ValueT>
+        constexpr int simdWidth()
+        {
+#if defined(__AVX__)
+            return std::is_same<ValueT, double>::value ? 4 : 1;
+#elif defined(__SSE2__)
+            return std::is_same<ValueT, double>::value ? 2 : 1;
+#else
+            return 1;
+#endif
+        }
+
+        /// c = alpha * a + beta * b for arrays of n values, n a multiple of the SIMD width.
+        template <class ValueT, int n>
+        inline void axpby(ValueT* c, const ValueT alpha, const ValueT* a, const ValueT beta, const ValueT* b)
+        {
+            for (int i = 0; i < n; ++i) {
+                c[i] = alpha * a[i] + beta * b[i];
+            }
+        }
+
+        /// c = alpha * a for arrays of n values, n a multiple of the SIMD width.
+        template <class ValueT, int n>
+        inline void scale(ValueT* c, const ValueT alpha, const ValueT* a)
+        {
+            for (int i = 0; i < n; ++i) {
+                c[i] = alpha * a[i];
+            }
+        }
+
+        // The vector versions use unaligned loads and stores, as the containers
+        // of C++14 do not guarantee the alignment of their elements. For aligned
+        // data these are as fast as the aligned ones.
+#if defined(__AVX__)
+        template <int n>
+        inline void axpbyDouble(double* c, const double alpha, const double* a, const double beta, const double* b)
+        {
+            const __m256d va = _mm256_set1_pd(alpha);
+            const __m256d vb = _mm256_set1_pd(beta);
+            for (int i = 0; i < n; i += 4) {
+                const __m256d x = _mm256_mul_pd(va, _mm256_loadu_pd(a + i));
+                const __m256d y = _mm256_mul_pd(vb, _mm256_loadu_pd(b + i));
+                _mm256_storeu_pd(c + i, _mm256_add_pd(x, y));
+            }
+        }
+
+        template <int n>
+        inline void scaleDouble(double* c, const double alpha, const double* a)
+        {
+            const __m256d va = _mm256_set1_pd(alpha);
+            for (int i = 0; i < n; i += 4) {
+                _mm256_storeu_pd(c + i, _mm256_mul_pd(va, _mm256_loadu_pd(a + i)));
+            }
+        }
+#elif defined(__SSE2__)
+        template <int n>
+        inline void axpbyDouble(double* c, const double alpha, const double* a, const double beta, const double* b)
+        {
+            const __m128d va = _mm_set1_pd(alpha);
+            const __m128d vb = _mm_set1_pd(beta);
+            for (int i = 0; i < n; i += 2) {
+                const __m128d x = _mm_mul_pd(va, _mm_loadu_pd(a + i));
+                const __m128d y = _mm_mul_pd(vb, _mm_loadu_pd(b + i));
+                _mm_storeu_pd(c + i, _mm_add_pd(x, y));
+            }
+        }
+
+        template <int n>
+        inline void scaleDouble(double* c, const double alpha, const double* a)
+        {
+            const __m128d va = _mm_set1_pd(alpha);
+            for (int i = 0; i < n; i += 2) {
+                _mm_storeu_pd(c + i, _mm_mul_pd(va, _mm_loadu_pd(a + i)));
+            }
+        }
+#endif
+
+#if defined(__AVX__) || defined(__SSE2__)
+        template <>
+        inline void axpby<double, 4>(double* c, const double alpha, const double* a, const double beta, const double* b)
+        { axpbyDouble<4>(c, alpha, a, beta, b); }
+        template <>
+        inline void axpby<double, 8>(double* c, const double alpha, const double* a, const double beta, const double* b)
+        { axpbyDouble<8>(c, alpha, a, beta, b); }
+        template <>
+        inline void axpby<double, 12>(double* c, const double alpha, const double* a, const double beta, const double* b)
+        { axpbyDouble<12>(c, alpha, a, beta, b); }
+        template <>
+        inline void axpby<double, 16>(double* c, const double alpha, const double* a, const double beta, const double* b)
+        { axpbyDouble<16>(c, alpha, a, beta, b); }
+
+        template <>
+        inline void scale<double, 4>(double* c, const double alpha, const double* a)
+        { scaleDouble<4>(c, alpha, a); }
+        template <>
+        inline void scale<double, 8>(double* c, const double alpha, const double* a)
+        { scaleDouble<8>(c, alpha, a); }
+        template <>
+        inline void scale<double, 12>(double* c, const double alpha, const double* a)
+        { scaleDouble<12>(c, alpha, a); }
+        template <>
+        inline void scale<double, 16>(double* c, const double alpha, const double* a)
+        { scaleDouble<16>(c, alpha, a); }
+#endif
+    } // namespace detail
+
+
+
+    /// \brief A forward automatic differentiation value with a fixed number of
+    ///        derivatives, padded to whole SIMD registers.
+    ///
+    /// The interface is that of DenseAd::Evaluation. The value and the
+    /// derivatives are stored in one array whose length is a multiple of the
+    /// SIMD width (4 doubles with AVX, 2 with SSE2), with zeros in the padding.
+    /// All operations then act on the whole array, the chain rule of a
+    /// product being c = b0 * a + a0 * b with the value fixed afterwards,
+    /// hence each operator is a few vector instructions without a remainder
+    /// loop, e.g. two AVX registers instead of seven scalar operations for
+    /// the seven derivatives of a standard well with three equations.
+    template <class ValueT, int numDerivs>
+    class Evaluation
+    {
+        static constexpr int width_ = detail::simdWidth<ValueT>();
+
+    public:
+        typedef ValueT ValueType;
+
+        //! The number of derivatives.
+        static const int size = numDerivs;
+
+        //! The length of the array of the value and the derivatives.
+        static const int length = (numDerivs + 1 + width_ - 1) / width_ * width_;
+
+        Evaluation()
+        {
+            std::fill(data_, data_ + length, ValueT(0.0));
+        }
+
+        //! A constant, with zero derivatives.
+        Evaluation(const ValueT& c)
+        {
+            std::fill(data_, data_ + length, ValueT(0.0));
+            data_[0] = c;
+        }
+
+        //! The variable with the index varPos.
+        Evaluation(const ValueT& c, const int varPos)
+        {
+            assert(0 <= varPos && varPos < size);
+            std::fill(data_, data_ + length, ValueT(0.0));
+            data_[0] = c;
+            data_[1 + varPos] = 1.0;
+        }
+
+        static Evaluation createVariable(const ValueT& value, const int varPos)
+        {
+            return Evaluation(value, varPos);
+        }
+
+        static Evaluation createConstant(const ValueT& value)
+        {
+            return Evaluation(value);
+        }
+
+        static Evaluation createBlank(const Evaluation&)
+        {
+            return Evaluation();
+        }
+
+        const ValueT& value() const
+        {
+            return data_[0];
+        }
+
+        void setValue(const ValueT& value)
+        {
+            data_[0] = value;
+        }
+
+        const ValueT& derivative(const int varIdx) const
+        {
+            assert(0 <= varIdx && varIdx < size);
+            return data_[1 + varIdx];
+        }
+
+        void setDerivative(const int varIdx, const ValueT& derVal)
+        {
+            assert(0 <= varIdx && varIdx < size);
+            data_[1 + varIdx] = derVal;
+        }
+
+        void clearDerivatives()
+        {
+            std::fill(data_ + 1, data_ + length, ValueT(0.0));
+        }
+
+        Evaluation& operator+=(const Evaluation& other)
+        {
+            detail::axpby<ValueT, length>(data_, 1.0, data_, 1.0, other.data_);
+            return *this;
+        }
+
+        Evaluation& operator+=(const ValueT& other)
+        {
+            data_[0] += other;
+            return *this;
+        }
+
+        Evaluation& operator-=(const Evaluation& other)
+        {
+            detail::axpby<ValueT, length>(data_, 1.0, data_, -1.0, other.data_);
+            return *this;
+        }
+
+        Evaluation& operator-=(const ValueT& other)
+        {
+            data_[0] -= other;
+            return *this;
+        }
+
+        Evaluation& operator*=(const Evaluation& other)
+        {
+            // (u*v)' = v'u + u'v
+            const ValueT u = data_[0];
+            const ValueT v = other.data_[0];
+            detail::axpby<ValueT, length>(data_, v, data_, u, other.data_);
+            data_[0] = u * v;
+            return *this;
+        }
+
+        Evaluation& operator*=(const ValueT& other)
+        {
+            detail::scale<ValueT, length>(data_, other, data_);
+            return *this;
+        }
+
+        Evaluation& operator/=(const Evaluation& other)
+        {
+            // (u/v)' = (v'u - u'v)/v^2
+            const ValueT u = data_[0];
+            const ValueT v = other.data_[0];
+            const ValueT vInv = 1.0 / v;
+            detail::axpby<ValueT, length>(data_, vInv, data_, -u * vInv * vInv, other.data_);
+            data_[0] = u * vInv;
+            return *this;
+        }
+
+        Evaluation& operator/=(const ValueT& other)
+        {
+            detail::scale<ValueT, length>(data_, ValueT(1.0) / other, data_);
+            return *this;
+        }
+
+        Evaluation operator-() const
+        {
+            Evaluation result;
+            detail::scale<ValueT, length>(result.data_, -1.0, data_);
+            return result;
+        }
+
+        Evaluation& operator=(const ValueT& other)
+        {
+            std::fill(data_ + 1, data_ + length, ValueT(0.0));
+            data_[0] = other;
+            return *this;
+        }
+
+        bool operator==(const Evaluation& other) const
+        {
+            return std::equal(data_, data_ + length, other.data_);
+        }
+
+        bool operator!=(const Evaluation& other) const
+        {
+            return !operator==(other);
+        }
+
+        bool operator==(const ValueT& other) const { return data_[0] == other; }
+        bool operator!=(const ValueT& other) const { return data_[0] != other; }
+        bool operator>(const Evaluation& other) const { return data_[0] > other.data_[0]; }
+        bool operator>(const ValueT& other) const { return data_[0] > other; }
+        bool operator<(const Evaluation& other) const { return data_[0] < other.data_[0]; }
+        bool operator<(const ValueT& other) const { return data_[0] < other; }
+        bool operator>=(const Evaluation& other) const { return data_[0] >= other.data_[0]; }
+        bool operator>=(const ValueT& other) const { return data_[0] >= other; }
+        bool operator<=(const Evaluation& other) const { return data_[0] <= other.data_[0]; }
+        bool operator<=(const ValueT& other) const { return data_[0] <= other; }
+
+        /// \brief The result of a function of the value with the derivative df.
+        Evaluation chain(const ValueT& f, const ValueT& df) const
+        {
+            Evaluation result;
+            detail::scale<ValueT, length>(result.data_, df, data_);
+            result.data_[0] = f;
+            return result;
+        }
+
+    private:
+        alignas(width_ * sizeof(ValueT)) ValueT data_[length];
+    };
+
+    //! Enables the operators and functions with a scalar for the arithmetic types.
+    template <class RhsValueType, class Result>
+    using EnableIfScalar = typename std::enable_if<std::is_arithmetic<RhsValueType>::value, Result>::type;
+
+    template <class ValueT, int n>
+    Evaluation<ValueT, n> operator+(Evaluation<ValueT, n> a, const Evaluation<ValueT, n>& b) { return a += b; }
+    template <class ValueT, int n, class RhsValueType>
+    EnableIfScalar<RhsValueType, Evaluation<ValueT, n> > operator+(Evaluation<ValueT, n> a, const RhsValueType& b) { return a += b; }
+    template <class ValueT, int n, class RhsValueType>
+    EnableIfScalar<RhsValueType, Evaluation<ValueT, n> > operator+(const RhsValueType& a, Evaluation<ValueT, n> b) { return b += a; }
+
+    template <class ValueT, int n>
+    Evaluation<ValueT, n> operator-(Evaluation<ValueT, n> a, const Evaluation<ValueT, n>& b) { return a -= b; }
+    template <class ValueT, int n, class RhsValueType>
+    EnableIfScalar<RhsValueType, Evaluation<ValueT, n> > operator-(Evaluation<ValueT, n> a, const RhsValueType& b) { return a -= b; }
+    template <class ValueT, int n, class RhsValueType>
+    EnableIfScalar<RhsValueType, Evaluation<ValueT, n> > operator-(const RhsValueType& a, const Evaluation<ValueT, n>& b) { return -b + a; }
+
+    template <class ValueT, int n>
+    Evaluation<ValueT, n> operator*(Evaluation<ValueT, n> a, const Evaluation<ValueT, n>& b) { return a *= b; }
+    template <class ValueT, int n, class RhsValueType>
+    EnableIfScalar<RhsValueType, Evaluation<ValueT, n> > operator*(Evaluation<ValueT, n> a, const RhsValueType& b) { return a *= b; }
+    template <class ValueT, int n, class RhsValueType>
+    EnableIfScalar<RhsValueType, Evaluation<ValueT, n> > operator*(const RhsValueType& a, Evaluation<ValueT, n> b) { return b *= a; }
+
+    template <class ValueT, int n>
+    Evaluation<ValueT, n> operator/(Evaluation<ValueT, n> a, const Evaluation<ValueT, n>& b) { return a /= b; }
+    template <class ValueT, int n, class RhsValueType>
+    EnableIfScalar<RhsValueType, Evaluation<ValueT, n> > operator/(Evaluation<ValueT, n> a, const RhsValueType& b) { return a /= b; }
+    template <class ValueT, int n, class RhsValueType>
+    EnableIfScalar<RhsValueType, Evaluation<ValueT, n> > operator/(const RhsValueType& a, const Evaluation<ValueT, n>& b)
+    {
+        // (a/v)' = -a v'/v^2
+        const ValueT vInv = 1.0 / b.value();
+        return b.chain(a * vInv, -a * vInv * vInv);
+    }
+
+    template <class ValueT, int n, class RhsValueType>
+    EnableIfScalar<RhsValueType, bool> operator<(const RhsValueType& a, const Evaluation<ValueT, n>& b) { return b > a; }
+    template <class ValueT, int n, class RhsValueType>
+    EnableIfScalar<RhsValueType, bool> operator>(const RhsValueType& a, const Evaluation<ValueT, n>& b) { return b < a; }
+    template <class ValueT, int n, class RhsValueType>
+    EnableIfScalar<RhsValueType, bool> operator<=(const RhsValueType& a, const Evaluation<ValueT, n>& b) { return b >= a; }
+    template <class ValueT, int n, class RhsValueType>
+    EnableIfScalar<RhsValueType, bool> operator>=(const RhsValueType& a, const Evaluation<ValueT, n>& b) { return b <= a; }
+    template <class ValueT, int n, class RhsValueType>
+    EnableIfScalar<RhsValueType, bool> operator==(const RhsValueType& a, const Evaluation<ValueT, n>& b) { return b == a; }
+    template <class ValueT, int n, class RhsValueType>
+    EnableIfScalar<RhsValueType, bool> operator!=(const RhsValueType& a, const Evaluation<ValueT, n>& b) { return b != a; }
+
+    template <class ValueT, int n>
+    std::ostream& operator<<(std::ostream& os, const Evaluation<ValueT, n>& eval)
+    {
+        return os << eval.value();
+    }
+
+    // the functions of DenseAd used by the property and well code
+
+    template <class ValueT, int n>
+    Evaluation<ValueT, n> abs(const Evaluation<ValueT, n>& x)
+    { return x < 0.0 ? -x : x; }
+
+    template <class ValueT, int n>
+    Evaluation<ValueT, n> max(const Evaluation<ValueT, n>& a, const Evaluation<ValueT, n>& b)
+    { return a > b ? a : b; }
+    template <class ValueT, int n, class RhsValueType>
+    EnableIfScalar<RhsValueType, Evaluation<ValueT, n> > max(const Evaluation<ValueT, n>& a, const RhsValueType& b)
+    { return a > b ? a : Evaluation<ValueT, n>(b); }
+    template <class ValueT, int n, class RhsValueType>
+    EnableIfScalar<RhsValueType, Evaluation<ValueT, n> > max(const RhsValueType& a, const Evaluation<ValueT, n>& b)
+    { return max(b, a); }
+
+    template <class ValueT, int n>
+    Evaluation<ValueT, n> min(const Evaluation<ValueT, n>& a, const Evaluation<ValueT, n>& b)
+    { return a < b ? a : b; }
+    template <class ValueT, int n, class RhsValueType>
+    EnableIfScalar<RhsValueType, Evaluation<ValueT, n> > min(const Evaluation<ValueT, n>& a, const RhsValueType& b)
+    { return a < b ? a : Evaluation<ValueT, n>(b); }
+    template <class ValueT, int n, class RhsValueType>
+    EnableIfScalar<RhsValueType, Evaluation<ValueT, n> > min(const RhsValueType& a, const Evaluation<ValueT, n>& b)
+    { return min(b, a); }
+
+    template <class ValueT, int n>
+    Evaluation<ValueT, n> sqrt(const Evaluation<ValueT, n>& x)
+    {
+        const ValueT s = std::sqrt(x.value());
+        return x.chain(s, 0.5 / s);
+    }
+
+    template <class ValueT, int n>
+    Evaluation<ValueT, n> exp(const Evaluation<ValueT, n>& x)
+    {
+        const ValueT e = std::exp(x.value());
+        return x.chain(e, e);
+    }
+
+    template <class ValueT, int n>
+    Evaluation<ValueT, n> log(const Evaluation<ValueT, n>& x)
+    { return x.chain(std::log(x.value()), 1.0 / x.value()); }
+
+    template <class ValueT, int n>
+    Evaluation<ValueT, n> sin(const Evaluation<ValueT, n>& x)
+    { return x.chain(std::sin(x.value()), std::cos(x.value())); }
+
+    template <class ValueT, int n>
+    Evaluation<ValueT, n> cos(const Evaluation<ValueT, n>& x)
+    { return x.chain(std::cos(x.value()), -std::sin(x.value())); }
+
+    template <class ValueT, int n>
+    Evaluation<ValueT, n> tan(const Evaluation<ValueT, n>& x)
+    {
+        const ValueT t = std::tan(x.value());
+        return x.chain(t, 1.0 + t * t);
+    }
+
+    template <class ValueT, int n>
+    Evaluation<ValueT, n> asin(const Evaluation<ValueT, n>& x)
+    { return x.chain(std::asin(x.value()), 1.0 / std::sqrt(1.0 - x.value() * x.value())); }
+
+    template <class ValueT, int n>
+    Evaluation<ValueT, n> acos(const Evaluation<ValueT, n>& x)
+    { return x.chain(std::acos(x.value()), -1.0 / std::sqrt(1.0 - x.value() * x.value())); }
+
+    template <class ValueT, int n>
+    Evaluation<ValueT, n> atan(const Evaluation<ValueT, n>& x)
+    { return x.chain(std::atan(x.value()), 1.0 / (1.0 + x.value() * x.value())); }
+
+    template <class ValueT, int n>
+    Evaluation<ValueT, n> atan2(const Evaluation<ValueT, n>& y, const Evaluation<ValueT, n>& x)
+    {
+        // d atan2(y, x) = (x dy - y dx) / (x^2 + y^2)
+        const ValueT r2Inv = 1.0 / (x.value() * x.value() + y.value() * y.value());
+        Evaluation<ValueT, n> result = y.chain(0.0, x.value() * r2Inv);
+        result -= x.chain(0.0, y.value() * r2Inv);
+        result.setValue(std::atan2(y.value(), x.value()));
+        return result;
+    }
+
+    template <class ValueT, int n>
+    Evaluation<ValueT, n> pow(const Evaluation<ValueT, n>& base, const ValueT& exponent)
+    {
+        const ValueT p = std::pow(base.value(), exponent);
+        return base.chain(p, base.value() == 0.0 ? 0.0 : exponent * p / base.value());
+    }
+
+    template <class ValueT, int n>
+    Evaluation<ValueT, n> pow(const ValueT& base, const Evaluation<ValueT, n>& exponent)
+    {
+        const ValueT p = std::pow(base, exponent.value());
+        return exponent.chain(p, base == 0.0 ? 0.0 : std::log(base) * p);
+    }
+
+    template <class ValueT, int n>
+    Evaluation<ValueT, n> pow(const Evaluation<ValueT, n>& base, const Evaluation<ValueT, n>& exponent)
+    {
+        if (base.value() == 0.0) {
+            return Evaluation<ValueT, n>(0.0);
+        }
+        // d b^e = e b^(e-1) db + ln(b) b^e de
+        const ValueT p = std::pow(base.value(), exponent.value());
+        Evaluation<ValueT, n> result = base.chain(0.0, exponent.value() * p / base.value());
+        result += exponent.chain(0.0, std::log(base.value()) * p);
+        result.setValue(p);
+        return result;
+    }
+
+} // namespace PaddedAd
+
+
+
+    /// \brief The MathToolbox of the padded evaluations, as for DenseAd::Evaluation.
+    template <class ValueT, int numDerivs>
+    struct MathToolbox<PaddedAd::Evaluation<ValueT, numDerivs> >
+    {
+        typedef ValueT ValueType;
+        typedef MathToolbox<ValueType> InnerToolbox;
+        typedef typename InnerToolbox::Scalar Scalar;
+        typedef PaddedAd::Evaluation<ValueType, numDerivs> Evaluation;
+
+        static ValueType value(const Evaluation& eval)
+        { return eval.value(); }
+
+        static decltype(InnerToolbox::scalarValue(0.0)) scalarValue(const Evaluation& eval)
+        { return InnerToolbox::scalarValue(eval.value()); }
+
+        static Evaluation createBlank(const Evaluation& x)
+        { return Evaluation::createBlank(x); }
+
+        static Evaluation createConstant(ValueType value)
+        { return Evaluation::createConstant(value); }
+
+        static Evaluation createConstant(const Evaluation&, ValueType value)
+        { return Evaluation::createConstant(value); }
+
+        static Evaluation createVariable(ValueType value, int varIdx)
+        { return Evaluation::createVariable(value, varIdx); }
+
+        template <class LhsEval>
+        static typename std::enable_if<std::is_same<Evaluation, LhsEval>::value, LhsEval>::type
+        decay(const Evaluation& eval)
+        { return eval; }
+
+        template <class LhsEval>
+        static typename std::enable_if<std::is_floating_point<LhsEval>::value, LhsEval>::type
+        decay(const Evaluation& eval)
+        { return eval.value(); }
+
+        static bool isSame(const Evaluation& a, const Evaluation& b, Scalar tolerance)
+        {
+            if (!InnerToolbox::isSame(a.value(), b.value(), tolerance)) {
+                return false;
+            }
+            for (int varIdx = 0; varIdx < numDerivs; ++varIdx) {
+                if (!InnerToolbox::isSame(a.derivative(varIdx), b.derivative(varIdx), tolerance)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        template <class Arg1Eval, class Arg2Eval>
+        static Evaluation max(const Arg1Eval& arg1, const Arg2Eval& arg2)
+        { return PaddedAd::max(arg1, arg2); }
+
+        template <class Arg1Eval, class Arg2Eval>
+        static Evaluation min(const Arg1Eval& arg1, const Arg2Eval& arg2)
+        { return PaddedAd::min(arg1, arg2); }
+
+        static Evaluation abs(const Evaluation& arg)
+        { return PaddedAd::abs(arg); }
+
+        static Evaluation tan(const Evaluation& arg)
+        { return PaddedAd::tan(arg); }
+
+        static Evaluation atan(const Evaluation& arg)
+        { return PaddedAd::atan(arg); }
+
+        static Evaluation atan2(const Evaluation& arg1, const Evaluation& arg2)
+        { return PaddedAd::atan2(arg1, arg2); }
+
+        static Evaluation sin(const Evaluation& arg)
+        { return PaddedAd::sin(arg); }
+
+        static Evaluation asin(const Evaluation& arg)
+        { return PaddedAd::asin(arg); }
+
+        static Evaluation cos(const Evaluation& arg)
+        { return PaddedAd::cos(arg); }
+
+        static Evaluation acos(const Evaluation& arg)
+        { return PaddedAd::acos(arg); }
+
+        static Evaluation sqrt(const Evaluation& arg)
+        { return PaddedAd::sqrt(arg); }
+
+        static Evaluation exp(const Evaluation& arg)
+        { return PaddedAd::exp(arg); }
+
+        static Evaluation log(const Evaluation& arg)
+        { return PaddedAd::log(arg); }
+
+        template <class RhsValueType>
+        static Evaluation pow(const Evaluation& arg1, const RhsValueType& arg2)
+        { return PaddedAd::pow(arg1, arg2); }
+
+        static bool isfinite(const Evaluation& arg)
+        {
+            if (!InnerToolbox::isfinite(arg.value())) {
+                return false;
+            }
+            for (int i = 0; i < numDerivs; ++i) {
+                if (!InnerToolbox::isfinite(arg.derivative(i))) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        static bool isnan(const Evaluation& arg)
+        {
+            if (InnerToolbox::isnan(arg.value())) {
+                return true;
+            }
+            for (int i = 0; i < numDerivs; ++i) {
+                if (InnerToolbox::isnan(arg.derivative(i))) {
+                    return true;
+                }
+            }
+            return false;
+        }
+    };
+
+} // namespace Opm
+
+#endif // OPM_PADDEDEVALUATION_HEADER_INCLUDED
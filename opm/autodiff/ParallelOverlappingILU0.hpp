@@ -21,6 +21,8 @@
 #define OPM_PARALLELOVERLAPPINGILU0_HEADER_INCLUDED
 
 #include <opm/autodiff/GraphColoring.hpp>
+#include <opm/autodiff/MemoryRegistry.hpp>
+#include <opm/autodiff/TimingRegistry.hpp>
 #include <opm/common/Exceptions.hpp>
 #include <opm/common/ErrorMacros.hpp>
 #include <dune/common/version.hh>
@@ -30,9 +32,12 @@
 #include <dune/istl/paamg/pinfo.hh>
 
 #include <type_traits>
+#include <memory>
 #include <numeric>
 #include <limits>
 #include <cstddef>
+#include <cstdint>
+#include <deque>
 #include <string>
 
 namespace Opm
@@ -328,9 +333,42 @@ namespace Opm
                             diagonal);
     }
 
+    //! compute the (modified) ILU0 decomposition of A in place.
     template<class M>
-    void milun_decomposition(const M& A, int n, MILU_VARIANT milu, M& ILU,
-                             Reorderer& ordering, Reorderer& inverseOrdering)
+    void ilu0_decomposition(M& A, MILU_VARIANT milu)
+    {
+        switch ( milu )
+        {
+        case MILU_VARIANT::MILU_1:
+            detail::milu0_decomposition ( A);
+            break;
+        case MILU_VARIANT::MILU_2:
+            detail::milu0_decomposition ( A, detail::IdentityFunctor(),
+                                          detail::SignFunctor() );
+            break;
+        case MILU_VARIANT::MILU_3:
+            detail::milu0_decomposition ( A, detail::AbsFunctor(),
+                                          detail::SignFunctor() );
+            break;
+        case MILU_VARIANT::MILU_4:
+            detail::milu0_decomposition ( A, detail::IdentityFunctor(),
+                                          detail::IsPositiveFunctor() );
+            break;
+        default:
+            bilu0_decomposition( A );
+            break;
+        }
+    }
+
+    /// \brief Create the sparsity pattern of the ILU-n decomposition of A.
+    ///
+    /// The level of fill only depends on the sparsity pattern of A, hence
+    /// the result can be reused for all matrices with the same pattern
+    /// (see milun_numeric). ILU has to be a matrix in row_wise build mode
+    /// without rows.
+    template<class M>
+    void milun_symbolic(const M& A, int n, M& ILU,
+                        Reorderer& ordering, Reorderer& inverseOrdering)
     {
         using Map = std::map<std::size_t, int>;
 
@@ -385,7 +423,13 @@ namespace Opm
                 (*col)[0][0] = generationPair->second;
             }
         }
+    }
 
+    /// \brief Compute the ILU-n decomposition of A in the pattern created by
+    ///        milun_symbolic.
+    template<class M>
+    void milun_numeric(const M& A, MILU_VARIANT milu, M& ILU, Reorderer& ordering)
+    {
         // copy Entries from A
         for(auto iter=A.begin(), iend = A.end(); iter != iend; ++iter)
         {
@@ -401,28 +445,16 @@ namespace Opm
                 newRow[ordering[col.index()]] = *col;
             }
         }
-        // call decomposition on pattern        
-        switch ( milu )
-        {
-        case MILU_VARIANT::MILU_1:
-            detail::milu0_decomposition ( ILU);
-            break;
-        case MILU_VARIANT::MILU_2:
-            detail::milu0_decomposition ( ILU, detail::IdentityFunctor(),
-                                          detail::SignFunctor() );
-            break;
-        case MILU_VARIANT::MILU_3:
-            detail::milu0_decomposition ( ILU, detail::AbsFunctor(),
-                                          detail::SignFunctor() );
-            break;
-        case MILU_VARIANT::MILU_4:
-            detail::milu0_decomposition ( ILU, detail::IdentityFunctor(),
-                                          detail::IsPositiveFunctor() );
-            break;
-        default:
-            bilu0_decomposition( ILU );
-            break;
-        }
+        // call decomposition on pattern
+        ilu0_decomposition( ILU, milu );
+    }
+
+    template<class M>
+    void milun_decomposition(const M& A, int n, MILU_VARIANT milu, M& ILU,
+                             Reorderer& ordering, Reorderer& inverseOrdering)
+    {
+        milun_symbolic( A, n, ILU, ordering, inverseOrdering );
+        milun_numeric( A, milu, ILU, ordering );
     }
 
       //! compute ILU decomposition of A. A is overwritten by its decomposition
@@ -442,6 +474,10 @@ namespace Opm
         upper.resize( A.N() );
         inv.resize( A.N() );
 
+        // Remove the entries of a previous decomposition, but keep the memory
+        lower.clear();
+        upper.clear();
+
         // Count the lower and upper matrix entries.
         size_type numLower = 0;
         size_type numUpper = 0;
@@ -511,6 +547,96 @@ namespace Opm
         }
         assert(colcount == numUpper);
       }
+
+    /// \brief The red-black ordering of a matrix and the sizes of its colors.
+    struct ColoredOrdering
+    {
+        std::vector<std::size_t> ordering;
+        std::vector<std::size_t> verticesPerColor;
+    };
+
+    /// \brief Compute the red-black ordering of the matrix graph.
+    ///
+    /// The sparsity pattern of the Jacobian rarely changes during a run,
+    /// but the ILU is set up for each linear solve. Hence the last few
+    /// orderings are cached, keyed by a hash of the sparsity pattern. Large
+    /// graphs are colored in parallel (Jones-Plassmann), which needs a few
+    /// more colors than the sequential greedy coloring.
+    /// \warning The cache is not thread-safe.
+    template<class Matrix>
+    const ColoredOrdering& redBlackOrdering(const Matrix& A, bool reorderSpheres)
+    {
+        struct Entry
+        {
+            std::uint64_t hash;
+            std::size_t rows;
+            std::size_t nonzeros;
+            bool spheres;
+            ColoredOrdering result;
+        };
+        static std::deque<Entry> cache;
+        static const std::size_t maxCacheSize = 4;
+        static const std::size_t minParallelColoringSize = 100000;
+
+        // FNV-1a of the column indices and row lengths
+        std::uint64_t hash = 14695981039346656037ULL;
+        auto combine = [&hash](std::uint64_t value)
+            {
+                hash = (hash ^ value) * 1099511628211ULL;
+            };
+        for ( auto row = A.begin(), rowEnd = A.end(); row != rowEnd; ++row )
+        {
+            combine(row->size());
+            for ( auto col = row->begin(), colEnd = row->end(); col != colEnd; ++col )
+            {
+                combine(col.index());
+            }
+        }
+
+        for ( auto entry = cache.begin(); entry != cache.end(); ++entry )
+        {
+            if ( entry->hash == hash && entry->rows == A.N() && entry->nonzeros == A.nonzeroes()
+                 && entry->spheres == reorderSpheres )
+            {
+                // move to the front (most recently used)
+                if ( entry != cache.begin() )
+                {
+                    Entry hit = std::move(*entry);
+                    cache.erase(entry);
+                    cache.push_front(std::move(hit));
+                }
+                return cache.front().result;
+            }
+        }
+
+        static auto& timing = TimingRegistry::instance().entry("ilu.coloring");
+        ScopedTiming scopedTiming(timing);
+        using Graph = Dune::Amg::MatrixGraph<const Matrix>;
+        Graph graph(A);
+        auto colorsTuple = A.N() >= minParallelColoringSize ?
+            colorVerticesJonesPlassmann(graph) : colorVerticesWelshPowell(graph);
+        const auto& colors = std::get<0>(colorsTuple);
+        auto noColors = std::get<1>(colorsTuple);
+        ColoredOrdering result;
+        result.verticesPerColor = std::get<2>(colorsTuple);
+        if ( reorderSpheres )
+        {
+            result.ordering = reorderVerticesSpheres(colors, noColors, result.verticesPerColor,
+                                                     graph, 0);
+        }
+        else
+        {
+            result.ordering = reorderVerticesPreserving(colors, noColors, result.verticesPerColor,
+                                                        graph);
+        }
+
+        cache.push_front(Entry{hash, A.N(), A.nonzeroes(), reorderSpheres, std::move(result)});
+        if ( cache.size() > maxCacheSize )
+        {
+            cache.pop_back();
+        }
+        return cache.front().result;
+    }
     } // end namespace detail
 
 
@@ -550,15 +676,19 @@ public:
     typedef typename matrix_type::size_type   size_type;
 
 protected:
+    /// \brief Storage of the factors with 32 bit indices, which halves the
+    ///        memory traffic for the indices in the triangular solves.
     struct CRS
     {
+      typedef std::uint32_t index_type;
+
       CRS() : nRows_( 0 ) {}
 
       size_type rows() const { return nRows_; }
 
       size_type nonZeros() const
       {
-        assert( rows_[ rows() ] != size_type(-1) );
+        assert( rows_[ rows() ] != index_type(-1) );
         return rows_[ rows() ];
       }
 
@@ -567,13 +697,17 @@ protected:
           if( nRows_ != nRows )
           {
             nRows_ = nRows ;
-            rows_.resize( nRows_+1, size_type(-1) );
+            rows_.resize( nRows_+1, index_type(-1) );
           }
       }
 
       void reserveAdditional( const size_type nonZeros )
       {
           const size_type needed = values_.size() + nonZeros ;
+          if( needed >= size_type( std::numeric_limits<index_type>::max() ) )
+          {
+              OPM_THROW(std::logic_error, "ILU: too many nonzeroes for the index type of the factors");
+          }
           if( values_.capacity() < needed )
           {
               const size_type estimate = needed * 1.1;
@@ -588,9 +722,15 @@ protected:
           cols_.push_back( index );
       }
 
-      std::vector< size_type  > rows_;
+      void clear()
+      {
+          values_.clear();
+          cols_.clear();
+      }
+
+      std::vector< index_type > rows_;
       std::vector< block_type > values_;
-      std::vector< size_type  > cols_;
+      std::vector< index_type > cols_;
       size_type nRows_;
     };
 
@@ -623,12 +763,14 @@ public:
                             The vertices on each layer aound it (same distance) are
                             ordered consecutivly. If false, we preserver the order of
                             the vertices with the same color.
+      \param reorder_rcm If true and no red-black ordering is used, the rows are
+                         reordered with reverse Cuthill-McKee to reduce the bandwidth.
     */
     template<class BlockType, class Alloc>
     ParallelOverlappingILU0 (const Dune::BCRSMatrix<BlockType,Alloc>& A,
                              const int n, const field_type w,
                              MILU_VARIANT milu, bool redblack=false,
-                             bool reorder_sphere=true)
+                             bool reorder_sphere=true, bool reorder_rcm=false)
         : lower_(),
           upper_(),
           inv_(),
@@ -638,7 +780,7 @@ public:
         // BlockMatrix is a Subclass of FieldMatrix that just adds
         // methods. Therefore this cast should be safe.
         init( reinterpret_cast<const Matrix&>(A), n, milu, redblack,
-              reorder_sphere  );
+              reorder_sphere, reorder_rcm );
     }
 
     /*! \brief Constructor gets all parameters to operate the prec.
@@ -652,12 +794,14 @@ public:
                             The vertices on each layer aound it (same distance) are
                             ordered consecutivly. If false, we preserver the order of
                             the vertices with the same color.
+      \param reorder_rcm If true and no red-black ordering is used, the rows are
+                         reordered with reverse Cuthill-McKee to reduce the bandwidth.
     */
     template<class BlockType, class Alloc>
     ParallelOverlappingILU0 (const Dune::BCRSMatrix<BlockType,Alloc>& A,
                              const ParallelInfo& comm, const int n, const field_type w,
                              MILU_VARIANT milu, bool redblack=false,
-                             bool reorder_sphere=true)
+                             bool reorder_sphere=true, bool reorder_rcm=false)
         : lower_(),
           upper_(),
           inv_(),
@@ -667,7 +811,7 @@ public:
         // BlockMatrix is a Subclass of FieldMatrix that just adds
         // methods. Therefore this cast should be safe.
         init( reinterpret_cast<const Matrix&>(A), n, milu, redblack,
-              reorder_sphere );
+              reorder_sphere, reorder_rcm );
     }
 
     /*! \brief Constructor.
@@ -681,12 +825,14 @@ public:
                   The vertices on each layer aound it (same distance) are
                   ordered consecutivly. If false, we preserver the order of
                   the vertices with the same color.
+      \param reorder_rcm If true and no red-black ordering is used, the rows are
+                         reordered with reverse Cuthill-McKee to reduce the bandwidth.
     */
     template<class BlockType, class Alloc>
     ParallelOverlappingILU0 (const Dune::BCRSMatrix<BlockType,Alloc>& A,
                              const field_type w, MILU_VARIANT milu, bool redblack=false,
-                             bool reorder_sphere=true)
-        : ParallelOverlappingILU0( A, 0, w, milu, redblack, reorder_sphere )
+                             bool reorder_sphere=true, bool reorder_rcm=false)
+        : ParallelOverlappingILU0( A, 0, w, milu, redblack, reorder_sphere, reorder_rcm )
     {
     }
 
@@ -702,12 +848,14 @@ public:
                             The vertices on each layer aound it (same distance) are
                             ordered consecutivly. If false, we preserver the order of
                             the vertices with the same color.
+      \param reorder_rcm If true and no red-black ordering is used, the rows are
+                         reordered with reverse Cuthill-McKee to reduce the bandwidth.
     */
     template<class BlockType, class Alloc>
     ParallelOverlappingILU0 (const Dune::BCRSMatrix<BlockType,Alloc>& A,
                              const ParallelInfo& comm, const field_type w,
                              MILU_VARIANT milu, bool redblack=false,
-                             bool reorder_sphere=true)
+                             bool reorder_sphere=true, bool reorder_rcm=false)
         : lower_(),
           upper_(),
           inv_(),
@@ -717,7 +865,7 @@ public:
         // BlockMatrix is a Subclass of FieldMatrix that just adds
         // methods. Therefore this cast should be safe.
         init( reinterpret_cast<const Matrix&>(A), 0, milu, redblack,
-              reorder_sphere );
+              reorder_sphere, reorder_rcm );
     }
 
     /*!
@@ -738,55 +886,73 @@ public:
     */
     virtual void apply (Domain& v, const Range& d)
     {
+        static auto& timing = TimingRegistry::instance().entry("ilu.apply");
+        ScopedTiming scopedTiming(timing);
+
         Range& md = reorderD(d);
         Domain& mv = reorderV(v);
         copyOwnerToAll( md );
 
-        // iterator types
-        typedef typename Range ::block_type  dblock;
-        typedef typename Domain::block_type  vblock;
-
         const size_type iEnd = lower_.rows();
-        const size_type lastRow = iEnd - 1;
         if( iEnd != upper_.rows() )
         {
             OPM_THROW(std::logic_error,"ILU: number of lower and upper rows must be the same");
         }
 
         // lower triangular solve
-        for( size_type i=0; i<iEnd; ++ i )
+        if ( colorStarts_.empty() )
         {
-          dblock rhs( md[ i ] );
-          const size_type rowI     = lower_.rows_[ i ];
-          const size_type rowINext = lower_.rows_[ i+1 ];
-
-          for( size_type col = rowI; col < rowINext; ++ col )
-          {
-            lower_.values_[ col ].mmv( mv[ lower_.cols_[ col ] ], rhs );
-          }
-
-          mv[ i ] = rhs;  // Lii = I
+            for( size_type i=0; i<iEnd; ++ i )
+            {
+                lowerSolveRow( i, md, mv );
+            }
+        }
+        else
+        {
+            // The rows of one color are not coupled and only depend
+            // on rows of previous colors. Hence they can be processed
+            // concurrently.
+            for( std::size_t color = 0; color + 1 < colorStarts_.size(); ++color )
+            {
+                const size_type colorEnd = colorStarts_[ color+1 ];
+#if HAVE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif // HAVE_OPENMP
+                for( size_type i=colorStarts_[ color ]; i<colorEnd; ++ i )
+                {
+                    lowerSolveRow( i, md, mv );
+                }
+            }
         }
 
         copyOwnerToAll( mv );
 
-        for( size_type i=0; i<iEnd; ++ i )
+        // upper triangular solve (upper_ stores the rows in reverse order)
+        if ( colorStarts_.empty() )
         {
-            vblock& vBlock = mv[ lastRow - i ];
-            vblock rhs ( vBlock );
-            const size_type rowI     = upper_.rows_[ i ];
-            const size_type rowINext = upper_.rows_[ i+1 ];
-
-            for( size_type col = rowI; col < rowINext; ++ col )
+            for( size_type i=0; i<iEnd; ++ i )
             {
-                upper_.values_[ col ].mmv( mv[ upper_.cols_[ col ] ], rhs );
+                upperSolveRow( i, mv );
+            }
+        }
+        else
+        {
+            for( std::size_t color = colorStarts_.size() - 1; color > 0; --color )
+            {
+                const size_type colorEnd = iEnd - colorStarts_[ color-1 ];
+#if HAVE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif // HAVE_OPENMP
+                for( size_type i=iEnd - colorStarts_[ color ]; i<colorEnd; ++ i )
+                {
+                    upperSolveRow( i, mv );
+                }
             }
-
-            // apply inverse and store result
-            inv_[ i ].mv( rhs, vBlock);
         }
 
-        copyOwnerToAll( mv );
+        if( copyResultToAll_ ) {
+            copyOwnerToAll( mv );
+        }
 
         if( relaxation_ ) {
             mv *= w_;
@@ -794,10 +960,45 @@ public:
         reorderBack(mv, v);
     }
 
+    /*!
+      \brief Recompute the decomposition for changed matrix entries.
+
+      The matrix passed to the constructor has to be still valid.
+      For an unchanged sparsity pattern the ordering and the storage
+      of the factors, including the fill-in pattern of ILU-n, is reused
+      and no memory is allocated. Otherwise a new setup is done.
+    */
+    void update()
+    {
+        if ( ILU_ && ILU_->N() == A_->N() && patternNonzeroes_ == A_->nonzeroes() )
+        {
+            decompose();
+        }
+        else
+        {
+            init( *A_, iluIteration_, milu_, redBlack_, reorderSpheres_, reorderRcm_ );
+        }
+    }
+
+    /*!
+      \brief Whether apply() copies the result of the owners to the other entries.
+
+      Can be switched off if the operator the result is passed to exchanges
+      the ghost values of its input itself (see WellModelMatrixAdapter).
+      Then the vectors built from the results of apply() have to be made
+      consistent again where it matters, e.g. the solution after the solve.
+    */
+    void setCopyResultToAll( bool copy )
+    {
+        copyResultToAll_ = copy;
+    }
+
     template <class V>
     void copyOwnerToAll( V& v ) const
     {
         if( comm_ ) {
+            static auto& timing = TimingRegistry::instance().entry("mpi.halo_exchange");
+            ScopedTiming scopedTiming(timing);
             comm_->copyOwnerToAll(v, v);
         }
     }
@@ -813,8 +1014,49 @@ public:
     }
 
 protected:
-    void init( const Matrix& A, const int iluIteration, MILU_VARIANT milu, bool redBlack, bool reorderSpheres )
+    /// \brief Solve row i of Ly = d (L has unit diagonal).
+    void lowerSolveRow( const size_type i, const Range& md, Domain& mv ) const
     {
+        typename Range::block_type rhs( md[ i ] );
+        const size_type rowI     = lower_.rows_[ i ];
+        const size_type rowINext = lower_.rows_[ i+1 ];
+
+        for( size_type col = rowI; col < rowINext; ++ col )
+        {
+            lower_.values_[ col ].mmv( mv[ lower_.cols_[ col ] ], rhs );
+        }
+
+        mv[ i ] = rhs;  // Lii = I
+    }
+
+    /// \brief Solve row i of the reversed rows of Ux = y.
+    void upperSolveRow( const size_type i, Domain& mv ) const
+    {
+        typename Domain::block_type& vBlock = mv[ lower_.rows() - 1 - i ];
+        typename Domain::block_type rhs ( vBlock );
+        const size_type rowI     = upper_.rows_[ i ];
+        const size_type rowINext = upper_.rows_[ i+1 ];
+
+        for( size_type col = rowI; col < rowINext; ++ col )
+        {
+            upper_.values_[ col ].mmv( mv[ upper_.cols_[ col ] ], rhs );
+        }
+
+        // apply inverse and store result
+        inv_[ i ].mv( rhs, vBlock);
+    }
+
+    void init( const Matrix& A, const int iluIteration, MILU_VARIANT milu, bool redBlack, bool reorderSpheres,
+               bool reorderRcm )
+    {
+        // remember the setup to be able to update the decomposition later on
+        A_ = &A;
+        iluIteration_ = iluIteration;
+        milu_ = milu;
+        redBlack_ = redBlack;
+        reorderSpheres_ = reorderSpheres;
+        reorderRcm_ = reorderRcm;
+
         // (For older DUNE versions the communicator might be
         // invalid if redistribution in AMG happened on the coarset level.
         // Therefore we check for nonzero size
@@ -831,61 +1073,110 @@ protected:
             }
         }
 
-        int ilu_setup_successful = 1;
-        std::string message;
-        const int rank = ( comm_ ) ? comm_->communicator().rank() : 0;
-
-        std::unique_ptr< Matrix > ILU;
-
         if ( redBlack )
         {
+            const auto& coloredOrdering = detail::redBlackOrdering(A, reorderSpheres);
+            ordering_ = coloredOrdering.ordering;
+            const auto& verticesPerColor = coloredOrdering.verticesPerColor;
+
+            // ILU-n introduces fill-in between vertices of the same color.
+            // Only for ILU-0 the colors can be processed concurrently.
+            colorStarts_.clear();
+            if ( iluIteration == 0 )
+            {
+                colorStarts_.resize(verticesPerColor.size() + 1, 0);
+                std::partial_sum(verticesPerColor.begin(), verticesPerColor.end(),
+                                 colorStarts_.begin() + 1);
+            }
+        }
+        else if ( reorderRcm )
+        {
+            // Bandwidth reduction for the sequential triangular solves.
             using Graph = Dune::Amg::MatrixGraph<const Matrix>;
             Graph graph(A);
-            auto colorsTuple = colorVerticesWelshPowell(graph);
-            const auto& colors = std::get<0>(colorsTuple);
-            const auto& verticesPerColor = std::get<2>(colorsTuple);
-            auto noColors = std::get<1>(colorsTuple);
-            if ( reorderSpheres )
+            ordering_ = reorderVerticesReverseCuthillMcKee(graph);
+            colorStarts_.clear();
+        }
+        else
+        {
+            colorStarts_.clear();
+        }
+
+        inverseOrdering_.resize(ordering_.size());
+        std::size_t index = 0;
+        for( auto newIndex: ordering_)
+        {
+            inverseOrdering_[newIndex] = index++;
+        }
+
+        if( iluIteration == 0 ) {
+            // create the sparsity pattern of the ILU-0 decomposition once.
+            // The values are copied during decompose.
+            if ( ordering_.empty() )
             {
-                ordering_ = reorderVerticesSpheres(colors, noColors, verticesPerColor,
-                                                   graph, 0);
+                ILU_.reset( new Matrix( A ) );
             }
             else
             {
-                ordering_ = reorderVerticesPreserving(colors, noColors, verticesPerColor,
-                                                      graph);
+                ILU_.reset( new Matrix(A.N(), A.M(), A.nonzeroes(), Matrix::row_wise));
+                auto& newA = *ILU_;
+                // Create sparsity pattern
+                for(auto iter=newA.createbegin(), iend = newA.createend(); iter != iend; ++iter)
+                {
+                    const auto& row = A[inverseOrdering_[iter.index()]];
+                    for(auto col = row.begin(), cend = row.end(); col != cend; ++col)
+                    {
+                        iter.insert(ordering_[col.index()]);
+                    }
+                }
             }
         }
-
-        std::vector<std::size_t> inverseOrdering(ordering_.size());
-        std::size_t index = 0;
-        for( auto newIndex: ordering_)
-        {
-            inverseOrdering[newIndex] = index++;
+        else {
+            // The fill-in pattern of ILU-n only depends on the sparsity pattern
+            // of A. Create it once here, decompose() only redoes the numbers.
+            static auto& timing = TimingRegistry::instance().entry("ilu.symbolic");
+            ScopedTiming scopedTiming(timing);
+
+            ILU_.reset( new Matrix( A.N(), A.M(), Matrix::row_wise) );
+            const auto reorderer = makeReorderer(ordering_);
+            const auto inverseReorderer = makeReorderer(inverseOrdering_);
+            detail::milun_symbolic( A, iluIteration, *ILU_, *reorderer, *inverseReorderer );
         }
+        patternNonzeroes_ = A.nonzeroes();
+
+        decompose();
+    }
+
+    /// \brief Compute the decomposition of A_ in the storage set up by init.
+    void decompose()
+    {
+        static auto& timing = TimingRegistry::instance().entry("ilu.factorize");
+        ScopedTiming scopedTiming(timing);
+
+        const Matrix& A = *A_;
+        int ilu_setup_successful = 1;
+        std::string message;
+        const int rank = ( comm_ ) ? comm_->communicator().rank() : 0;
 
         try
         {
-            if( iluIteration == 0 ) {
-                // create ILU-0 decomposition
+            if( iluIteration_ == 0 ) {
+                // copy the values into the existing ILU-0 storage
+                auto& newA = *ILU_;
                 if ( ordering_.empty() )
                 {
-                    ILU.reset( new Matrix( A ) );
-                }
-                else
-                {
-                    ILU.reset( new Matrix(A.N(), A.M(), A.nonzeroes(), Matrix::row_wise));
-                    auto& newA = *ILU;
-                    // Create sparsity pattern
-                    for(auto iter=newA.createbegin(), iend = newA.createend(); iter != iend; ++iter)
+                    auto newRow = newA.begin();
+                    for(auto iter = A.begin(), iend = A.end(); iter != iend; ++iter, ++newRow)
                     {
-                        const auto& row = A[inverseOrdering[iter.index()]];
-                        for(auto col = row.begin(), cend = row.end(); col != cend; ++col)
+                        auto newCol = newRow->begin();
+                        for(auto col = iter->begin(), cend = iter->end(); col != cend; ++col, ++newCol)
                         {
-                            iter.insert(ordering_[col.index()]);
+                            *newCol = *col;
                         }
                     }
-                    // Copy values
+                }
+                else
+                {
                     for(auto iter = A.begin(), iend = A.end(); iter != iend; ++iter)
                     {
                         auto& newRow = newA[ordering_[iter.index()]];
@@ -896,44 +1187,12 @@ protected:
                     }
                 }
 
-                switch ( milu )
-                {
-                case MILU_VARIANT::MILU_1:
-                    detail::milu0_decomposition ( *ILU);
-                    break;
-                case MILU_VARIANT::MILU_2:
-                    detail::milu0_decomposition ( *ILU, detail::IdentityFunctor(),
-                                                  detail::SignFunctor() );
-                    break;
-                case MILU_VARIANT::MILU_3:
-                    detail::milu0_decomposition ( *ILU, detail::AbsFunctor(),
-                                                  detail::SignFunctor() );
-                    break;
-                case MILU_VARIANT::MILU_4:
-                    detail::milu0_decomposition ( *ILU, detail::IdentityFunctor(),
-                                                  detail::IsPositiveFunctor() );
-                    break;
-                default:
-                    bilu0_decomposition( *ILU );
-                    break;
-                }
+                detail::ilu0_decomposition( newA, milu_ );
             }
             else {
-                // create ILU-n decomposition
-                ILU.reset( new Matrix( A.N(), A.M(), Matrix::row_wise) );
-                std::unique_ptr<detail::Reorderer> reorderer, inverseReorderer;
-                if ( ordering_.empty() )
-                {
-                    reorderer.reset(new detail::NoReorderer());
-                    inverseReorderer.reset(new detail::NoReorderer());
-                }
-                else
-                {
-                    reorderer.reset(new detail::RealReorderer(ordering_));
-                    inverseReorderer.reset(new detail::RealReorderer(inverseOrdering));
-                }
-
-                milun_decomposition( A, iluIteration, milu, *ILU, *reorderer, *inverseReorderer );
+                // compute the ILU-n decomposition in the pattern created by init.
+                const auto reorderer = makeReorderer(ordering_);
+                detail::milun_numeric( A, milu_, *ILU_, *reorderer );
             }
         }
         catch ( const Dune::MatrixBlockError& error )
@@ -950,11 +1209,25 @@ protected:
         const bool local_failure = ilu_setup_successful == 0;
         if ( local_failure || parallel_failure )
         {
+            // force a new setup on the next update as the values are garbage now.
+            ILU_.reset();
             throw Dune::MatrixBlockError();
         }
 
-        // store ILU in simple CRS format
-        detail::convertToCRS( *ILU, lower_, upper_, inv_ );
+        // store ILU in simple CRS format. The buffers are reused.
+        detail::convertToCRS( *ILU_, lower_, upper_, inv_ );
+        memory_.set( matrixMemoryBytes( *ILU_ ) + memoryBytes( inv_ )
+                     + memoryBytes( lower_.rows_ ) + memoryBytes( lower_.values_ ) + memoryBytes( lower_.cols_ )
+                     + memoryBytes( upper_.rows_ ) + memoryBytes( upper_.values_ ) + memoryBytes( upper_.cols_ ) );
+    }
+
+    static std::unique_ptr<detail::Reorderer> makeReorderer(const std::vector<std::size_t>& ordering)
+    {
+        if ( ordering.empty() )
+        {
+            return std::unique_ptr<detail::Reorderer>(new detail::NoReorderer());
+        }
+        return std::unique_ptr<detail::Reorderer>(new detail::RealReorderer(ordering));
     }
 
     /// \brief Reorder D if needed and return a reference to it.
@@ -1017,16 +1290,38 @@ protected:
     std::vector< block_type > inv_;
     //! \brief the reordering of the unknowns
     std::vector< std::size_t > ordering_;
+    //! \brief the inverse of the reordering of the unknowns
+    std::vector< std::size_t > inverseOrdering_;
+    //! \brief The first (reordered) row of each color and the number of rows.
+    //!
+    //! Empty if the rows cannot be processed color by color.
+    std::vector< size_type > colorStarts_;
+    //! \brief The storage for the (reordered) decomposition before conversion to CRS.
+    std::unique_ptr< Matrix > ILU_;
     //! \brief The reordered right hand side
     Range reorderedD_;
     //! \brief The reordered left hand side.
     Domain reorderedV_;
 
     const ParallelInfo* comm_;
+    //! \brief Whether apply() makes its result consistent.
+    bool copyResultToAll_ = true;
     //! \brief The relaxation factor to use.
     const field_type w_;
     const bool relaxation_;
 
+    //! \brief The matrix the decomposition was computed for.
+    const Matrix* A_;
+    //! \brief The number of nonzeroes of the matrix the storage of ILU_ was set up for.
+    std::size_t patternNonzeroes_ = 0;
+    //! \brief The parameters of the decomposition.
+    int iluIteration_;
+    MILU_VARIANT milu_;
+    bool redBlack_;
+    bool reorderSpheres_;
+    bool reorderRcm_;
+    //! \brief The memory of the decomposition, for the memory report.
+    MemoryAccount memory_{ MemoryRegistry::instance().entry("ilu.factors") };
 };
 
 } // end namespace Opm
@@ -21,6 +21,7 @@
 #define OPM_PARALLELRESTRICTEDADDITIVESCHWARZ_HEADER_INCLUDED
 
 #include <opm/common/utility/platform_dependent/disable_warnings.h>
+#include <dune/common/version.hh>
 #include <dune/istl/preconditioner.hh>
 #include <dune/istl/paamg/smoother.hh>
 #include <opm/common/utility/platform_dependent/reenable_warnings.h>
@@ -138,11 +139,18 @@ public:
     //! \brief The type of the communication object.
     typedef ParallelInfo communication_type;
 
+#if DUNE_VERSION_NEWER(DUNE_ISTL, 2, 6)
+    Dune::SolverCategory::Category category() const override
+    {
+        return Dune::SolverCategory::overlapping;
+    }
+#else
     // define the category
     enum {
         //! \brief The category the precondtioner is part of.
         category=Dune::SolverCategory::overlapping
     };
+#endif
 
     /*! \brief Constructor.
 
@@ -173,7 +181,13 @@ public:
     */
     virtual void apply (Domain& v, const Range& d)
     {
-        apply<true>(v, d);
+        // hack us a mutable d to prevent copying.
+        Range& md = const_cast<Range&>(d);
+        communication_.copyOwnerToAll(md,md);
+        preconditioner_.apply(v,d);
+        communication_.copyOwnerToAll(v,v);
+        // Make sure that d is the same as at the beginning of apply.
+        communication_.project(md);
     }
 
     template<bool forward>
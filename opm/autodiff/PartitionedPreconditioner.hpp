@@ -0,0 +1,264 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_PARTITIONEDPRECONDITIONER_HEADER_INCLUDED
+#define OPM_PARTITIONEDPRECONDITIONER_HEADER_INCLUDED
+
+#include <opm/autodiff/CPRPreconditioner.hpp>
+#include <opm/autodiff/TimingRegistry.hpp>
+#include <opm/common/ErrorMacros.hpp>
+#include <opm/common/Exceptions.hpp>
+
+#include <opm/common/utility/platform_dependent/disable_warnings.h>
+#include <dune/common/fmatrix.hh>
+#include <dune/common/unused.hh>
+#include <dune/common/version.hh>
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/preconditioner.hh>
+#include <dune/istl/solvercategory.hh>
+#include <opm/common/utility/platform_dependent/reenable_warnings.h>
+
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace Opm
+{
+
+/// \brief A preconditioner that treats the flow equations and the additional
+///        equations of a cell (e.g. polymer, solvent, energy) separately.
+///
+/// The flow block (the first FlowVector::block_type::dimension equations and
+/// unknowns of each cell) is copied to a matrix with the smaller block size,
+/// and the inner preconditioner (usually CPR) is only computed and applied
+/// for it. Then the additional unknowns are updated with one forward block
+/// Gauss-Seidel sweep over the cells, using the flow update just computed:
+/// \f[ A^{ee}_{ii} v^e_i = d^e_i - \sum_j A^{ef}_{ij} v^f_j - \sum_{j<i} A^{ee}_{ij} v^e_j. \f]
+/// The equations of the additional quantities are nearly decoupled from the
+/// flow, hence this is much cheaper than running the inner preconditioner
+/// on the full blocks, while the Krylov solver still sees the full coupling.
+/// The additional unknowns must not be coupled back into the flow equations
+/// too strongly.
+/// \tparam Matrix The matrix type of the full system.
+/// \tparam X The type of the domain and the range of the full system.
+/// \tparam FlowMatrix The matrix type of the flow system.
+/// \tparam Communication The type of the parallel information.
+template<class Matrix, class X, class FlowMatrix, class Communication>
+class PartitionedPreconditioner
+    : public Dune::Preconditioner<X,X>
+{
+public:
+    //! \brief The domain type of the preconditioner.
+    typedef X domain_type;
+    //! \brief The range type of the preconditioner.
+    typedef X range_type;
+    //! \brief The field type of the preconditioner.
+    typedef typename X::field_type field_type;
+    //! \brief The vector type of the flow system.
+    typedef Dune::BlockVector<Dune::FieldVector<field_type, FlowMatrix::block_type::rows> > FlowVector;
+    //! \brief The operator type of the flow system.
+    typedef typename ISTLUtility::CPRSelector<FlowMatrix, FlowVector, FlowVector, Communication>::Operator FlowOperator;
+    //! \brief The type of the inner preconditioner.
+    typedef Dune::Preconditioner<FlowVector, FlowVector> FlowPreconditioner;
+
+    static const int numEq = X::block_type::dimension;
+    static const int numFlow = FlowMatrix::block_type::rows;
+    static const int numExtra = numEq - numFlow;
+    static_assert(numExtra > 0, "The partitioned preconditioner needs equations besides the flow");
+
+    typedef Dune::FieldMatrix<field_type, numExtra, numExtra> ExtraBlock;
+
+#if DUNE_VERSION_NEWER(DUNE_ISTL, 2, 6)
+    Dune::SolverCategory::Category category() const override
+    {
+        return std::is_same<Communication, Dune::Amg::SequentialInformation>::value ?
+            Dune::SolverCategory::sequential : Dune::SolverCategory::overlapping;
+    }
+#else
+    enum {
+        //! \brief The category the preconditioner is part of.
+        category = std::is_same<Communication, Dune::Amg::SequentialInformation>::value ?
+            Dune::SolverCategory::sequential : Dune::SolverCategory::overlapping
+    };
+#endif
+
+    /// \brief Constructor.
+    /// \param A The matrix of the full system. Has to outlive the preconditioner.
+    /// \param comm The parallel information.
+    /// \param createPreconditioner Functor that creates the inner preconditioner
+    ///        for the flow operator passed to it and returns a std::unique_ptr
+    ///        to it. The operator will live as long as this object.
+    template<class Factory>
+    PartitionedPreconditioner(const Matrix& A, const Communication& comm,
+                              const Factory& createPreconditioner)
+        : comm_(comm), matrix_(&A), flowMatrix_(new FlowMatrix()), vFlow_(A.N()), dFlow_(A.N())
+    {
+        flowMatrix_->setSize(A.N(), A.M(), A.nonzeroes());
+        flowMatrix_->setBuildMode(FlowMatrix::row_wise);
+        auto fromRow = A.begin();
+        for ( auto row = flowMatrix_->createbegin(), rend = flowMatrix_->createend(); row != rend; ++row, ++fromRow )
+        {
+            for ( auto col = fromRow->begin(), cend = fromRow->end(); col != cend; ++col )
+            {
+                row.insert(col.index());
+            }
+        }
+        extractBlocks(A);
+        flowOperator_.reset(ISTLUtility::CPRSelector<FlowMatrix, FlowVector, FlowVector, Communication>
+                            ::makeOperator(*flowMatrix_, comm));
+        flowPrecond_ = createPreconditioner(*flowOperator_);
+    }
+
+    virtual void pre (X& x, X& b)
+    {
+        DUNE_UNUSED_PARAMETER(x);
+        DUNE_UNUSED_PARAMETER(b);
+    }
+
+    virtual void apply (X& v, const X& d)
+    {
+        static auto& timing = TimingRegistry::instance().entry("partitioned.apply");
+        ScopedTiming scopedTiming(timing);
+
+        for ( std::size_t i = 0; i < d.size(); ++i )
+        {
+            for ( int k = 0; k < numFlow; ++k )
+            {
+                dFlow_[i][k] = d[i][k];
+            }
+        }
+        vFlow_ = 0.0;
+        flowPrecond_->apply(vFlow_, dFlow_);
+
+        v = 0.0;
+        for ( std::size_t i = 0; i < v.size(); ++i )
+        {
+            for ( int k = 0; k < numFlow; ++k )
+            {
+                v[i][k] = vFlow_[i][k];
+            }
+        }
+        // The flow update has to be consistent for the coupling to the other equations.
+        comm_.copyOwnerToAll(v, v);
+
+        // forward block Gauss-Seidel sweep for the other equations
+        const auto& A = *matrix_;
+        for ( auto row = A.begin(), rend = A.end(); row != rend; ++row )
+        {
+            const auto i = row.index();
+            Dune::FieldVector<field_type, numExtra> rhs;
+            for ( int e = 0; e < numExtra; ++e )
+            {
+                rhs[e] = d[i][numFlow + e];
+            }
+            for ( auto col = row->begin(), cend = row->end(); col != cend; ++col )
+            {
+                const auto& block = *col;
+                const auto& vj = v[col.index()];
+                // v of the additional unknowns is still zero for j >= i
+                const int end = col.index() < i ? numEq : numFlow;
+                for ( int e = 0; e < numExtra; ++e )
+                {
+                    for ( int k = 0; k < end; ++k )
+                    {
+                        rhs[e] -= block[numFlow + e][k] * vj[k];
+                    }
+                }
+            }
+            Dune::FieldVector<field_type, numExtra> ve;
+            extraDiagonalInverse_[i].mv(rhs, ve);
+            for ( int e = 0; e < numExtra; ++e )
+            {
+                v[i][numFlow + e] = ve[e];
+            }
+        }
+        comm_.copyOwnerToAll(v, v);
+    }
+
+    virtual void post (X& x)
+    {
+        DUNE_UNUSED_PARAMETER(x);
+    }
+
+    /// \brief Update the preconditioner for new entries of a matrix
+    ///        with unchanged sparsity pattern.
+    void update(const Matrix& A)
+    {
+        extractBlocks(A);
+        flowPrecond_->update();
+    }
+
+private:
+    void extractBlocks(const Matrix& A)
+    {
+        matrix_ = &A;
+        extraDiagonalInverse_.resize(A.N());
+        auto toRow = flowMatrix_->begin();
+        for ( auto row = A.begin(), rend = A.end(); row != rend; ++row, ++toRow )
+        {
+            auto toCol = toRow->begin();
+            for ( auto col = row->begin(), cend = row->end(); col != cend; ++col, ++toCol )
+            {
+                for ( int k = 0; k < numFlow; ++k )
+                {
+                    for ( int l = 0; l < numFlow; ++l )
+                    {
+                        (*toCol)[k][l] = (*col)[k][l];
+                    }
+                }
+                if ( col.index() == row.index() )
+                {
+                    auto& inverse = extraDiagonalInverse_[row.index()];
+                    for ( int e = 0; e < numExtra; ++e )
+                    {
+                        for ( int f = 0; f < numExtra; ++f )
+                        {
+                            inverse[e][f] = (*col)[numFlow + e][numFlow + f];
+                        }
+                    }
+                    try
+                    {
+                        inverse.invert();
+                    }
+                    catch ( const Dune::FMatrixError& )
+                    {
+                        OPM_THROW(LinearSolverProblem, "Partitioned preconditioner: singular diagonal block of the additional equations in row " << row.index());
+                    }
+                }
+            }
+        }
+    }
+
+    const Communication& comm_;
+    //! \brief The matrix of the full system.
+    const Matrix* matrix_;
+    //! \brief The flow block of the matrix.
+    std::unique_ptr<FlowMatrix> flowMatrix_;
+    std::unique_ptr<FlowOperator> flowOperator_;
+    std::unique_ptr<FlowPreconditioner> flowPrecond_;
+    //! \brief The inverses of the diagonal blocks of the additional equations.
+    std::vector<ExtraBlock> extraDiagonalInverse_;
+    FlowVector vFlow_;
+    FlowVector dFlow_;
+};
+
+} // end namespace Opm
+
+#endif // OPM_PARTITIONEDPRECONDITIONER_HEADER_INCLUDED
@@ -0,0 +1,127 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_PRESSURESOLVERBACKEND_HEADER_INCLUDED
+#define OPM_PRESSURESOLVERBACKEND_HEADER_INCLUDED
+
+#include <opm/autodiff/FlowLinearSolverParameters.hpp>
+#include <opm/common/ErrorMacros.hpp>
+
+#include <dune/istl/solver.hh>
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace Opm
+{
+
+    /// \brief Interface of a solver for the pressure system of CPR.
+    ///
+    /// The pressure system (already decoupled with the true- or quasi-IMPES
+    /// weights computed by OPM) is handed to the backend as a Dune operator.
+    /// Backends for other libraries (e.g. an AMG of an external package)
+    /// copy its matrix to their own data structures.
+    /// \tparam X The type of the vectors of the pressure system.
+    template<class X>
+    class PressureSolverBackend
+    {
+    public:
+        virtual ~PressureSolverBackend()
+        {}
+
+        /// \brief Update the solver after the entries of the pressure matrix changed.
+        ///
+        /// The sparsity pattern is unchanged.
+        virtual void update() = 0;
+
+        /// \brief Approximately solve the pressure system.
+        /// \param x The solution (initially zero).
+        /// \param b The right hand side. It may be overwritten.
+        /// \param res Information about the solve. Backends have to set at least
+        ///            converged and iterations.
+        virtual void apply(X& x, X& b, Dune::InverseOperatorResult& res) = 0;
+    };
+
+    /// \brief Registry of the available pressure solver backends.
+    ///
+    /// The backend is selected by its name with the parameter CprPressureSolver
+    /// (cpr_pressure_solver_). An empty name uses the built-in Dune AMG or ILU0
+    /// (see cpr_use_amg_). Backends register themselves, e.g. in a translation
+    /// unit that is only compiled if the library they use is available:
+    /// \code
+    /// static const bool registered = (PressureSolverRegistry<Op,X,Comm>::add("mybackend",
+    ///     [](const Op& op, const Comm& comm, const CPRParameter& param)
+    ///     { return std::unique_ptr<PressureSolverBackend<X>>(new MyBackend(op, comm, param)); }), true);
+    /// \endcode
+    /// \tparam Operator The type of the operator of the pressure system.
+    /// \tparam X The type of the vectors of the pressure system.
+    /// \tparam Communication The type of the parallel information.
+    template<class Operator, class X, class Communication>
+    class PressureSolverRegistry
+    {
+    public:
+        typedef PressureSolverBackend<X> Backend;
+        typedef std::function<std::unique_ptr<Backend>(const Operator&, const Communication&,
+                                                       const CPRParameter&)> Creator;
+
+        /// \brief Add a backend. An existing backend with the same name is replaced.
+        static void add(const std::string& name, const Creator& creator)
+        {
+            creators()[name] = creator;
+        }
+
+        /// \brief Whether a backend with this name is registered.
+        static bool contains(const std::string& name)
+        {
+            return creators().count(name) > 0;
+        }
+
+        /// \brief Create the backend with the given name for a pressure system.
+        static std::unique_ptr<Backend> create(const std::string& name, const Operator& op,
+                                               const Communication& comm, const CPRParameter& param)
+        {
+            const auto creator = creators().find(name);
+            if ( creator == creators().end() )
+            {
+                std::ostringstream available;
+                for ( const auto& entry : creators() )
+                {
+                    available << " " << entry.first;
+                }
+                OPM_THROW(std::invalid_argument, "Unknown CPR pressure solver '" << name
+                          << "'. Available are:" << (creators().empty() ? std::string(" none") : available.str()));
+            }
+            return creator->second(op, comm, param);
+        }
+
+    private:
+        static std::map<std::string, Creator>& creators()
+        {
+            static std::map<std::string, Creator> creatorMap;
+            return creatorMap;
+        }
+    };
+
+} // namespace Opm
+
+#endif // OPM_PRESSURESOLVERBACKEND_HEADER_INCLUDED
@@ -0,0 +1,139 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_PROCESSTIMINGSTATISTICS_HEADER_INCLUDED
+#define OPM_PROCESSTIMINGSTATISTICS_HEADER_INCLUDED
+
+#include <opm/autodiff/ReductionBatch.hpp>
+#include <opm/autodiff/TimingRegistry.hpp>
+#include <opm/core/simulator/SimulatorReport.hpp>
+
+#include <array>
+#include <iomanip>
+#include <ostream>
+
+namespace Opm
+{
+
+/// \brief The minimum, mean and maximum over the processes of the times of a report step.
+///
+/// Unlike LoadImbalanceMonitor, which watches the sum of the last report
+/// steps to recommend a repartition, this reports the spread of the times
+/// of each stage in a single report step, such that a slow parallel run can
+/// be attributed to the partition, the wells or the communication. The well
+/// and communication times come from the TimingRegistry, and are zero
+/// unless it is enabled.
+class ProcessTimingStatistics
+{
+public:
+    enum Stage { Assembly = 0, Wells = 1, LinearSolve = 2, CommunicationWait = 3, NumStages = 4 };
+
+    ProcessTimingStatistics()
+    {
+        min_.fill(0.0);
+        mean_.fill(0.0);
+        max_.fill(0.0);
+    }
+
+    /// \brief The times of this process in a report step.
+    static std::array<double, NumStages> localTimes(const SimulatorReport& stepReport)
+    {
+        auto& timings = TimingRegistry::instance();
+        static auto& wells = timings.entry("wells.assemble");
+        static auto& wellApply = timings.entry("well.apply");
+        static auto& reductionWait = timings.entry("mpi.reduction_wait");
+        static auto& haloExchange = timings.entry("mpi.halo_exchange");
+        return {{ stepReport.assemble_time,
+                  wells.seconds + wellApply.seconds,
+                  stepReport.linear_solve_time,
+                  reductionWait.seconds + haloExchange.seconds }};
+    }
+
+    /// \brief Reduce the times of a report step over all processes.
+    ///        Collective on the communication.
+    template<class Comm>
+    void compute(const Comm& comm, const std::array<double, NumStages>& times)
+    {
+        batch_.clear();
+        for ( const double time : times )
+        {
+            batch_.addSum(time);
+            batch_.addMax(time);
+            // the minimum is the negated maximum of the negated times
+            batch_.addMax(-time);
+        }
+        batch_.begin(comm);
+        batch_.end();
+
+        for ( int stage = 0; stage < NumStages; ++stage )
+        {
+            mean_[stage] = batch_.sum(stage) / comm.size();
+            max_[stage] = batch_.max(2 * stage);
+            min_[stage] = -batch_.max(2 * stage + 1);
+        }
+    }
+
+    double min(const Stage stage) const
+    {
+        return min_[stage];
+    }
+
+    double mean(const Stage stage) const
+    {
+        return mean_[stage];
+    }
+
+    double max(const Stage stage) const
+    {
+        return max_[stage];
+    }
+
+    /// \brief The largest relative to the mean time of a stage, minus one.
+    double imbalance(const Stage stage) const
+    {
+        return mean_[stage] > 0.0 ? max_[stage] / mean_[stage] - 1.0 : 0.0;
+    }
+
+    /// \brief Print a table of the statistics of all stages.
+    void report(std::ostream& os) const
+    {
+        static const char* const names[NumStages] = { "Assembly", "Wells", "Linear solve", "Communication wait" };
+        os << std::left << std::setw(20) << "Stage" << std::right
+           << std::setw(12) << "Min (s)" << std::setw(12) << "Mean (s)"
+           << std::setw(12) << "Max (s)" << std::setw(12) << "Imbalance" << "\n";
+        for ( int stage = 0; stage < NumStages; ++stage )
+        {
+            os << std::left << std::setw(20) << names[stage] << std::right
+               << std::fixed << std::setprecision(3)
+               << std::setw(12) << min_[stage] << std::setw(12) << mean_[stage]
+               << std::setw(12) << max_[stage]
+               << std::setw(11) << std::setprecision(1) << 100.0 * imbalance(static_cast<Stage>(stage)) << "%\n";
+        }
+    }
+
+private:
+    std::array<double, NumStages> min_;
+    std::array<double, NumStages> mean_;
+    std::array<double, NumStages> max_;
+    ReductionBatch batch_;
+};
+
+} // namespace Opm
+
+#endif // OPM_PROCESSTIMINGSTATISTICS_HEADER_INCLUDED
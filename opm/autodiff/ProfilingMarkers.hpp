@@ -0,0 +1,111 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_PROFILINGMARKERS_HEADER_INCLUDED
+#define OPM_PROFILINGMARKERS_HEADER_INCLUDED
+
+// The markers of one external profiler are compiled in by defining one of
+//   OPM_MARKERS_LIKWID  LIKWID marker API (also define LIKWID_PERFMON, link -llikwid)
+//   OPM_MARKERS_NVTX    NVIDIA Tools Extension ranges (link -lnvToolsExt)
+//   OPM_MARKERS_ITT     Intel ITT tasks for VTune (link -littnotify)
+//   OPM_MARKERS_SCOREP  Score-P user regions (build with the scorep --user wrapper)
+// Without any of them the markers are empty and vanish from the code.
+#if defined(OPM_MARKERS_LIKWID)
+#include <likwid.h>
+#elif defined(OPM_MARKERS_NVTX)
+#include <nvToolsExt.h>
+#elif defined(OPM_MARKERS_ITT)
+#include <ittnotify.h>
+#elif defined(OPM_MARKERS_SCOREP)
+#include <scorep/SCOREP_User.h>
+#endif
+
+#include <string>
+
+namespace Opm
+{
+
+    /// \brief A named region of the code for an external profiler.
+    ///
+    /// The hardware counters and times an external profiler measures
+    /// between begin() and end() are attributed to the name of the region.
+    /// Each section of the TimingRegistry is such a region, hence every
+    /// ScopedTiming marks its scope.
+    class ProfilingRegion
+    {
+    public:
+        explicit ProfilingRegion(const std::string& name)
+            : name_(name)
+        {
+#if defined(OPM_MARKERS_LIKWID)
+            static struct Marker
+            {
+                Marker() { LIKWID_MARKER_INIT; }
+                ~Marker() { LIKWID_MARKER_CLOSE; }
+            } marker;
+            LIKWID_MARKER_REGISTER(name_.c_str());
+#elif defined(OPM_MARKERS_ITT)
+            static __itt_domain* domain = __itt_domain_create("opm");
+            domain_ = domain;
+            handle_ = __itt_string_handle_create(name_.c_str());
+#endif
+        }
+
+        void begin() const
+        {
+#if defined(OPM_MARKERS_LIKWID)
+            LIKWID_MARKER_START(name_.c_str());
+#elif defined(OPM_MARKERS_NVTX)
+            nvtxRangePushA(name_.c_str());
+#elif defined(OPM_MARKERS_ITT)
+            __itt_task_begin(domain_, __itt_null, __itt_null, handle_);
+#elif defined(OPM_MARKERS_SCOREP)
+            SCOREP_USER_REGION_BY_NAME_BEGIN(name_.c_str(), SCOREP_USER_REGION_TYPE_COMMON);
+#endif
+        }
+
+        void end() const
+        {
+#if defined(OPM_MARKERS_LIKWID)
+            LIKWID_MARKER_STOP(name_.c_str());
+#elif defined(OPM_MARKERS_NVTX)
+            nvtxRangePop();
+#elif defined(OPM_MARKERS_ITT)
+            __itt_task_end(domain_);
+#elif defined(OPM_MARKERS_SCOREP)
+            SCOREP_USER_REGION_BY_NAME_END(name_.c_str());
+#endif
+        }
+
+        const std::string& name() const
+        {
+            return name_;
+        }
+
+    private:
+        std::string name_;
+#if defined(OPM_MARKERS_ITT)
+        __itt_domain* domain_;
+        __itt_string_handle* handle_;
+#endif
+    };
+
+} // namespace Opm
+
+#endif // OPM_PROFILINGMARKERS_HEADER_INCLUDED
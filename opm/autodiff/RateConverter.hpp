@@ -28,6 +28,8 @@
 
 #include <dune/grid/common/gridenums.hh>
 #include <algorithm>
+#include <array>
+#include <cassert>
 #include <cmath>
 #include <memory>
 #include <stdexcept>
@@ -411,12 +413,19 @@ namespace Opm {
              * \param[in] region Forward region mapping.  Often
              * corresponds to the "FIPNUM" mapping of an ECLIPSE input
              * deck.
+             *
+             * \param[in] tolerance Relative change of the average
+             * pressure, temperature, rs and rv of a region below which
+             * the conversion coefficients of the region are reused.
+             * With 0, they are only reused for an unchanged state.
              */
             SurfaceToReservoirVoidage(const PhaseUsage& phaseUsage,
-                                      const Region&   region)
+                                      const Region&   region,
+                                      const double    tolerance = 0.0)
                 : phaseUsage_(phaseUsage)
                 , rmap_ (region)
                 , attr_ (rmap_, Attributes())
+                , tolerance_(tolerance)
             {
             }
 
@@ -428,20 +437,27 @@ namespace Opm {
              * state for purpose of conversion from surface rate to
              * reservoir voidage rate.
              *
+             * The intensive quantities cached by the last linearization
+             * are used where they are up to date, hence they are only
+             * computed again for the cells updated since.
              */
             template <typename ElementContext, class EbosSimulator>
             void defineState(const EbosSimulator& simulator)
             {
 
-                // create map from cell to region
+                // create map from cell to region once,
                 // and set all attributes to zero
                 const auto& grid = simulator.vanguard().grid();
                 const unsigned numCells = grid.size(/*codim=*/0);
-                std::vector<int> cell2region(numCells, -1);
-                for (const auto& reg : rmap_.activeRegions()) {
-                    for (const auto& cell : rmap_.cells(reg)) {
-                        cell2region[cell] = reg;
+                if (cell2region_.size() != numCells) {
+                    cell2region_.assign(numCells, -1);
+                    for (const auto& reg : rmap_.activeRegions()) {
+                        for (const auto& cell : rmap_.cells(reg)) {
+                            cell2region_[cell] = reg;
+                        }
                     }
+                }
+                for (const auto& reg : rmap_.activeRegions()) {
                     auto& ra = attr_.attributes(reg);
                     ra.pressure = 0.0;
                     ra.temperature = 0.0;
@@ -454,21 +470,24 @@ namespace Opm {
                 ElementContext elemCtx( simulator );
                 const auto& gridView = simulator.gridView();
                 const auto& comm = gridView.comm();
+                const auto& elemMapper = simulator.model().elementMapper();
 
-                const auto& elemEndIt = gridView.template end</*codim=*/0>();
-                for (auto elemIt = gridView.template begin</*codim=*/0>();
+                const auto& elemEndIt = gridView.template end</*codim=*/0, Dune::Interior_Partition>();
+                for (auto elemIt = gridView.template begin</*codim=*/0, Dune::Interior_Partition>();
                      elemIt != elemEndIt;
                      ++elemIt)
                 {
 
                     const auto& elem = *elemIt;
-                    if (elem.partitionType() != Dune::InteriorEntity)
-                        continue;
-
-                    elemCtx.updatePrimaryStencil(elem);
-                    elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
-                    const unsigned cellIdx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
-                    const auto& intQuants = elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
+                    const unsigned cellIdx = elemMapper.index(elem);
+                    const auto* cachedIntQuants = simulator.model().cachedIntensiveQuantities(cellIdx, /*timeIdx=*/0);
+                    if (!cachedIntQuants) {
+                        elemCtx.updatePrimaryStencil(elem);
+                        elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
+                    }
+                    const auto& intQuants = cachedIntQuants
+                        ? *cachedIntQuants
+                        : elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
                     const auto& fs = intQuants.fluidState();
                     // use pore volume weighted averages.
                     const double pv_cell =
@@ -482,7 +501,7 @@ namespace Opm {
                         hydrocarbon -= fs.saturation(FluidSystem::waterPhaseIdx).value();
                     }
 
-                    int reg = cell2region[cellIdx];
+                    int reg = cell2region_[cellIdx];
                     assert(reg >= 0);
                     auto& ra = attr_.attributes(reg);
                     auto& p  = ra.pressure;
@@ -500,6 +519,15 @@ namespace Opm {
                     T += fs.temperature(FluidSystem::oilPhaseIdx).value()*hydrocarbonPV;
                 }
 
+                // communicate the sums of all regions at once
+                std::vector<double> sums;
+                for (const auto& reg : rmap_.activeRegions()) {
+                      const auto& ra = attr_.attributes(reg);
+                      sums.insert(sums.end(), { ra.pressure, ra.temperature, ra.rs, ra.rv, ra.pv });
+                }
+                comm.sum(sums.data(), sums.size());
+
+                auto sum = sums.begin();
                 for (const auto& reg : rmap_.activeRegions()) {
                       auto& ra = attr_.attributes(reg);
                       auto& p  = ra.pressure;
@@ -507,17 +535,22 @@ namespace Opm {
                       auto& rs  = ra.rs;
                       auto& rv  = ra.rv;
                       auto& pv  = ra.pv;
-                      // communicate sums
-                      p = comm.sum(p);
-                      T = comm.sum(T);
-                      rs = comm.sum(rs);
-                      rv = comm.sum(rv);
-                      pv = comm.sum(pv);
+                      p = *sum++;
+                      T = *sum++;
+                      rs = *sum++;
+                      rv = *sum++;
+                      pv = *sum++;
                       // compute average
                       p /= pv;
                       T /= pv;
                       rs /= pv;
                       rv /= pv;
+
+                      // drop the coefficients computed at a different state
+                      if (!ra.withinTolerance(tolerance_)) {
+                          ra.coeff.clear();
+                          ra.coeff_state = { p, T, rs, rv };
+                      }
                 }
             }
 
@@ -554,65 +587,51 @@ namespace Opm {
              * these coefficients (i.e. q_{rp} is not equal to coeff[p] q_{sp})
              * since they can depend on more than one surface volume rate when
              * we have dissolved gas or vaporized oil.
+             *
+             * The coefficients are cached per region and PVT region until
+             * defineState() finds a different state of the region.
              */
             template <class Coeff>
             void
             calcCoeff(const RegionId r, const int pvtRegionIdx, Coeff& coeff) const
             {
-                const auto& pu = phaseUsage_;
                 const auto& ra = attr_.attributes(r);
-                const double p = ra.pressure;
-                const double T = ra.temperature;
-
-                const int   iw = Details::PhasePos::water(pu);
-                const int   io = Details::PhasePos::oil  (pu);
-                const int   ig = Details::PhasePos::gas  (pu);
-
-                std::fill(& coeff[0], & coeff[0] + phaseUsage_.num_phases, 0.0);
-
-                if (Details::PhaseUsed::water(pu)) {
-                    // q[w]_r = q[w]_s / bw
-
-                    const double bw = FluidSystem::waterPvt().inverseFormationVolumeFactor(pvtRegionIdx, T, p);
-
-                    coeff[iw] = 1.0 / bw;
+                auto cached = ra.coeff.find(pvtRegionIdx);
+                if (cached == ra.coeff.end()) {
+                    std::vector<double> c(phaseUsage_.num_phases);
+                    computeCoeff(ra, pvtRegionIdx, c);
+                    cached = ra.coeff.emplace(pvtRegionIdx, std::move(c)).first;
                 }
+                std::copy(cached->second.begin(), cached->second.end(), & coeff[0]);
+            }
 
-                // Actual Rs and Rv:
-                double Rs = ra.rs;
-                double Rv = ra.rv;
-
-                // Determinant of 'R' matrix
-                const double detR = 1.0 - (Rs * Rv);
-
-                if (Details::PhaseUsed::oil(pu)) {
-                    // q[o]_r = 1/(bo * (1 - rs*rv)) * (q[o]_s - rv*q[g]_s)
-
-                    const double bo = FluidSystem::oilPvt().inverseFormationVolumeFactor(pvtRegionIdx, T, p, Rs);
-                    const double den = bo * detR;
-
-                    coeff[io] += 1.0 / den;
-
-                    if (Details::PhaseUsed::gas(pu)) {
-                        coeff[ig] -= ra.rv / den;
-                    }
-                }
-
-                if (Details::PhaseUsed::gas(pu)) {
-                    // q[g]_r = 1/(bg * (1 - rs*rv)) * (q[g]_s - rs*q[o]_s)
-
-                    const double bg  = FluidSystem::gasPvt().inverseFormationVolumeFactor(pvtRegionIdx, T, p, Rv);
-                    const double den = bg * detR;
-
-                    coeff[ig] += 1.0 / den;
 
-                    if (Details::PhaseUsed::oil(pu)) {
-                        coeff[io] -= ra.rs / den;
-                    }
+            /**
+             * Compute coefficients for surface-to-reservoir voidage
+             * conversion of several wells at once.
+             *
+             * \param[in] regions Fluid-in-place region of each well
+             * \param[in] pvtRegionIdx PVT region of each well
+             *
+             * \param[out] coeffs The coefficients of calcCoeff(), for
+             * each well in turn (num_phases entries per well).
+             */
+            void
+            calcCoeffs(const std::vector<RegionId>& regions,
+                       const std::vector<int>& pvtRegionIdx,
+                       std::vector<double>& coeffs) const
+            {
+                assert(regions.size() == pvtRegionIdx.size());
+                const std::size_t np = phaseUsage_.num_phases;
+                coeffs.resize(np * regions.size());
+                for (std::size_t w = 0; w < regions.size(); ++w) {
+                    double* coeff = & coeffs[np * w];
+                    calcCoeff(regions[w], pvtRegionIdx[w], coeff);
                 }
             }
 
 
+
             /**
              * Converting surface volume rates to reservoir voidage rates
              *
@@ -733,6 +752,66 @@ namespace Opm {
             }
 
         private:
+            /**
+             * Compute the conversion coefficients of calcCoeff() at the
+             * average state of a region.
+             */
+            template <class Attr>
+            void
+            computeCoeff(const Attr& ra, const int pvtRegionIdx, std::vector<double>& coeff) const
+            {
+                const auto& pu = phaseUsage_;
+                const double p = ra.pressure;
+                const double T = ra.temperature;
+
+                const int   iw = Details::PhasePos::water(pu);
+                const int   io = Details::PhasePos::oil  (pu);
+                const int   ig = Details::PhasePos::gas  (pu);
+
+                std::fill(& coeff[0], & coeff[0] + phaseUsage_.num_phases, 0.0);
+
+                if (Details::PhaseUsed::water(pu)) {
+                    // q[w]_r = q[w]_s / bw
+
+                    const double bw = FluidSystem::waterPvt().inverseFormationVolumeFactor(pvtRegionIdx, T, p);
+
+                    coeff[iw] = 1.0 / bw;
+                }
+
+                // Actual Rs and Rv:
+                double Rs = ra.rs;
+                double Rv = ra.rv;
+
+                // Determinant of 'R' matrix
+                const double detR = 1.0 - (Rs * Rv);
+
+                if (Details::PhaseUsed::oil(pu)) {
+                    // q[o]_r = 1/(bo * (1 - rs*rv)) * (q[o]_s - rv*q[g]_s)
+
+                    const double bo = FluidSystem::oilPvt().inverseFormationVolumeFactor(pvtRegionIdx, T, p, Rs);
+                    const double den = bo * detR;
+
+                    coeff[io] += 1.0 / den;
+
+                    if (Details::PhaseUsed::gas(pu)) {
+                        coeff[ig] -= ra.rv / den;
+                    }
+                }
+
+                if (Details::PhaseUsed::gas(pu)) {
+                    // q[g]_r = 1/(bg * (1 - rs*rv)) * (q[g]_s - rs*q[o]_s)
+
+                    const double bg  = FluidSystem::gasPvt().inverseFormationVolumeFactor(pvtRegionIdx, T, p, Rv);
+                    const double den = bg * detR;
+
+                    coeff[ig] += 1.0 / den;
+
+                    if (Details::PhaseUsed::oil(pu)) {
+                        coeff[io] -= ra.rs / den;
+                    }
+                }
+            }
+
             /**
              * Fluid property object.
              */
@@ -760,10 +839,43 @@ namespace Opm {
                 double rs;
                 double rv;
                 double pv;
+
+                /**
+                 * Whether the average state differs from that of the
+                 * cached coefficients by at most a relative tolerance.
+                 */
+                bool withinTolerance(const double tolerance) const
+                {
+                    const std::array<double, 4> state = {{ pressure, temperature, rs, rv }};
+                    for (std::size_t i = 0; i < state.size(); ++i) {
+                        const double scale = std::max(std::abs(state[i]), std::abs(coeff_state[i]));
+                        if (!(std::abs(state[i] - coeff_state[i]) <= tolerance * scale)) {
+                            return false;
+                        }
+                    }
+                    return true;
+                }
+
+                // the state of the cached coefficients
+                std::array<double, 4> coeff_state = {{ 0.0, 0.0, 0.0, 0.0 }};
+
+                // the conversion coefficients for each PVT region, see calcCoeff()
+                mutable std::unordered_map<int, std::vector<double>> coeff;
             };
 
             Details::RegionAttributes<RegionId, Attributes> attr_;
 
+            /**
+             * The region of each cell.
+             */
+            std::vector<int> cell2region_;
+
+            /**
+             * Relative change of the state of a region below which its
+             * conversion coefficients are reused.
+             */
+            double tolerance_;
+
         };
     } // namespace RateConverter
 } // namespace Opm
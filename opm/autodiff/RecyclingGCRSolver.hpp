@@ -0,0 +1,359 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_RECYCLINGGCRSOLVER_HEADER_INCLUDED
+#define OPM_RECYCLINGGCRSOLVER_HEADER_INCLUDED
+
+#include <opm/autodiff/FusedBiCGSTABSolver.hpp>
+
+#include <opm/common/utility/platform_dependent/disable_warnings.h>
+#include <dune/common/version.hh>
+#include <dune/common/timer.hh>
+#include <dune/istl/operators.hh>
+#include <dune/istl/preconditioner.hh>
+#include <dune/istl/solver.hh>
+#include <dune/istl/solvercategory.hh>
+#include <opm/common/utility/platform_dependent/reenable_warnings.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace Opm
+{
+
+/// \brief The search directions a RecyclingGCRSolver keeps between solves.
+///
+/// Only the preconditioned directions are stored. Their images under the
+/// operator are recomputed at the start of each solve, as the matrix
+/// changes between the solves.
+/// \tparam X The vector type.
+template<class X>
+class RecycledSubspace
+{
+public:
+    /// \brief Constructor.
+    /// \param maxSize The maximum number of directions to keep.
+    explicit RecycledSubspace(std::size_t maxSize)
+        : maxSize_(maxSize)
+    {}
+
+    /// \brief The maximum number of directions to keep.
+    std::size_t maxSize() const
+    {
+        return maxSize_;
+    }
+
+    /// \brief The number of directions currently kept.
+    std::size_t size() const
+    {
+        return directions_.size();
+    }
+
+    /// \brief Forget all directions, e.g. if the system changed completely.
+    void clear()
+    {
+        directions_.clear();
+    }
+
+    std::vector<X>& directions()
+    {
+        return directions_;
+    }
+
+    const std::vector<X>& directions() const
+    {
+        return directions_;
+    }
+
+private:
+    std::size_t maxSize_;
+    std::vector<X> directions_;
+};
+
+/// \brief Restarted GCR that recycles search directions between solves (GCRO).
+///
+/// At the start of each solve the directions kept from the previous
+/// solve are mapped by the current operator and orthonormalized. The
+/// residual is first projected onto their span, and the new search
+/// directions are kept orthogonal to them, also after restarts.
+/// Consecutive systems of a Newton method (and of the first Newton
+/// iteration of the next time step) are very similar; the slow modes
+/// resolved in one solve then do not have to be found again in the next.
+/// At the end of a solve the most recent search directions are kept, as
+/// the components of the error the preconditioner resolves badly show up
+/// late in the iteration.
+///
+/// As GCR allows for a preconditioner changing between iterations the
+/// (inexact) CPR preconditioner can be used. The reductions of each
+/// iteration are fused to two global reductions.
+/// \tparam X The vector type.
+/// \tparam Communication The type of the parallel information.
+template<class X, class Communication>
+class RecyclingGCRSolver
+    : public Dune::InverseOperator<X,X>
+{
+public:
+    typedef X domain_type;
+    typedef X range_type;
+    typedef typename X::field_type field_type;
+
+    /// \brief Constructor.
+    /// \param op The operator of the system.
+    /// \param prec The preconditioner.
+    /// \param comm The parallel information.
+    /// \param subspace The directions recycled from the previous solve. Updated by each solve.
+    /// \param reduction The reduction of the residual norm to achieve.
+    /// \param restart The number of new search directions after which GCR is restarted.
+    /// \param maxit The maximum number of iterations.
+    /// \param verbose The verbosity level (0: none, 1: summary, 2: every iteration).
+    RecyclingGCRSolver(Dune::LinearOperator<X,X>& op, Dune::Preconditioner<X,X>& prec,
+                       const Communication& comm, RecycledSubspace<X>& subspace,
+                       double reduction, int restart, int maxit, int verbose)
+        : op_(op), prec_(prec), dots_(comm), subspace_(subspace), reduction_(reduction),
+          restart_(std::max(restart, 1)), maxit_(maxit), verbose_(verbose)
+    {}
+
+#if DUNE_VERSION_NEWER(DUNE_ISTL, 2, 6)
+    Dune::SolverCategory::Category category() const override
+    {
+        return op_.category();
+    }
+#endif
+
+    virtual void apply(X& x, X& b, Dune::InverseOperatorResult& res)
+    {
+        apply(x, b, reduction_, res);
+    }
+
+    virtual void apply(X& x, X& b, double reduction, Dune::InverseOperatorResult& res)
+    {
+        res.clear();
+        Dune::Timer watch;
+
+        X r(b);
+        op_.applyscaleadd(-1.0, x, r);
+
+        prec_.pre(x, b);
+
+        const double def0 = norm(r);
+        double def = def0;
+
+        if ( verbose_ > 1 )
+        {
+            printDefect(0, def);
+        }
+
+        // The preconditioned directions and their (orthonormal) images.
+        // The first ones are the recycled directions, which are kept over restarts.
+        std::vector<X> zs, ws;
+        std::size_t recycled = 0;
+
+        if ( def0 < 1e-30 )
+        {
+            res.converged = true;
+        }
+        else
+        {
+            recycled = deflate(x, r, zs, ws);
+            if ( recycled > 0 )
+            {
+                def = norm(r);
+                res.converged = def <= reduction * def0;
+                if ( verbose_ > 1 )
+                {
+                    printDefect(0, def);
+                }
+            }
+        }
+
+        int it = 0;
+        for ( ; !res.converged && it < maxit_; )
+        {
+            ++it;
+            X z(b.size()), w(b.size());
+            z = 0.0;
+            prec_.apply(z, r);
+            op_.apply(z, w);
+
+            orthogonalize(z, w, zs, ws);
+
+            typedef std::pair<const X*, const X*> Pair;
+            auto d = dots_.compute(std::array<Pair, 2>{{ Pair(&w, &w), Pair(&w, &r) }});
+            if ( d[0] < std::numeric_limits<double>::min() )
+            {
+                // no progress possible in this direction
+                break;
+            }
+            const double wnorm = std::sqrt(d[0]);
+            z *= 1.0 / wnorm;
+            w *= 1.0 / wnorm;
+            const double alpha = d[1] / wnorm;
+            x.axpy(alpha, z);
+            r.axpy(-alpha, w);
+
+            def = std::sqrt(std::max(def * def - alpha * alpha, 0.0));
+            if ( def <= reduction * def0 )
+            {
+                // The recurrence may be inaccurate close to convergence. Confirm it.
+                def = norm(r);
+                res.converged = def <= reduction * def0;
+            }
+
+            if ( verbose_ > 1 )
+            {
+                printDefect(it, def);
+            }
+
+            zs.push_back(std::move(z));
+            ws.push_back(std::move(w));
+
+            if ( !res.converged && zs.size() - recycled >= static_cast<std::size_t>(restart_) )
+            {
+                // restart, but stay orthogonal to the recycled directions
+                zs.erase(zs.begin() + recycled, zs.end());
+                ws.erase(ws.begin() + recycled, ws.end());
+            }
+        }
+
+        prec_.post(x);
+
+        keepDirections(zs);
+
+        res.iterations = it;
+        res.reduction = def0 > 0.0 ? def / def0 : 0.0;
+        res.conv_rate = it > 0 ? std::pow(res.reduction, 1.0 / it) : 0.0;
+        res.elapsed = watch.elapsed();
+
+        if ( verbose_ > 0 )
+        {
+            std::cout << "=== RecyclingGCRSolver " << (res.converged ? "converged" : "did not converge")
+                      << ": iterations " << res.iterations << ", recycled directions " << recycled
+                      << ", reduction " << res.reduction << ", time " << res.elapsed << " s" << std::endl;
+        }
+    }
+
+private:
+    double norm(const X& x) const
+    {
+        typedef std::pair<const X*, const X*> Pair;
+        return std::sqrt(std::max(dots_.compute(std::array<Pair, 1>{{ Pair(&x, &x) }})[0], 0.0));
+    }
+
+    /// \brief Make w orthogonal to all ws, applying the same combination to z.
+    void orthogonalize(X& z, X& w, const std::vector<X>& zs, const std::vector<X>& ws) const
+    {
+        std::vector<std::pair<const X*, const X*> > pairs;
+        pairs.reserve(ws.size());
+        for ( const auto& wj : ws )
+        {
+            pairs.emplace_back(&wj, &w);
+        }
+        const auto h = dots_.compute(pairs);
+        for ( std::size_t j = 0; j < ws.size(); ++j )
+        {
+            w.axpy(-h[j], ws[j]);
+            z.axpy(-h[j], zs[j]);
+        }
+    }
+
+    /// \brief Orthonormalize the images of the recycled directions, and
+    ///        remove their span from the residual.
+    /// \return The number of recycled directions used.
+    std::size_t deflate(X& x, X& r, std::vector<X>& zs, std::vector<X>& ws) const
+    {
+        auto& directions = subspace_.directions();
+        if ( directions.empty() || directions.front().size() != x.size() )
+        {
+            // nothing to recycle or the system size changed
+            subspace_.clear();
+            return 0;
+        }
+
+        typedef std::pair<const X*, const X*> Pair;
+        for ( const auto& u : directions )
+        {
+            X z(u), w(x.size());
+            op_.apply(z, w);
+            const double before = norm(w);
+            orthogonalize(z, w, zs, ws);
+            const double after = norm(w);
+            if ( after <= 1e-10 * before )
+            {
+                // (numerically) dependent on the previous directions
+                continue;
+            }
+            z *= 1.0 / after;
+            w *= 1.0 / after;
+            zs.push_back(std::move(z));
+            ws.push_back(std::move(w));
+        }
+
+        std::vector<Pair> pairs;
+        pairs.reserve(ws.size());
+        for ( const auto& w : ws )
+        {
+            pairs.emplace_back(&w, &r);
+        }
+        const auto c = dots_.compute(pairs);
+        for ( std::size_t j = 0; j < ws.size(); ++j )
+        {
+            x.axpy(c[j], zs[j]);
+            r.axpy(-c[j], ws[j]);
+        }
+        return zs.size();
+    }
+
+    /// \brief Keep the most recent directions for the next solve.
+    void keepDirections(std::vector<X>& zs) const
+    {
+        const std::size_t keep = std::min(subspace_.maxSize(), zs.size());
+        auto& directions = subspace_.directions();
+        directions.clear();
+        for ( std::size_t j = zs.size() - keep; j < zs.size(); ++j )
+        {
+            directions.push_back(std::move(zs[j]));
+        }
+    }
+
+    void printDefect(int it, double def) const
+    {
+        std::cout << std::setw(5) << it << "  " << std::scientific << std::setprecision(6)
+                  << def << std::defaultfloat << std::endl;
+    }
+
+    Dune::LinearOperator<X,X>& op_;
+    Dune::Preconditioner<X,X>& prec_;
+    Detail::FusedDotProducts<Communication> dots_;
+    RecycledSubspace<X>& subspace_;
+    double reduction_;
+    int restart_;
+    int maxit_;
+    int verbose_;
+};
+
+} // end namespace Opm
+
+#endif // OPM_RECYCLINGGCRSOLVER_HEADER_INCLUDED
@@ -0,0 +1,208 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_REDUCTIONBATCH_HEADER_INCLUDED
+#define OPM_REDUCTIONBATCH_HEADER_INCLUDED
+
+#include <opm/autodiff/TimingRegistry.hpp>
+
+#include <opm/common/utility/platform_dependent/disable_warnings.h>
+#include <dune/common/parallel/collectivecommunication.hh>
+#if HAVE_MPI
+#include <dune/common/parallel/mpicollectivecommunication.hh>
+#endif
+#include <opm/common/utility/platform_dependent/reenable_warnings.h>
+
+#if HAVE_MPI
+#include <mpi.h>
+#endif
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+namespace Opm
+{
+
+/// \brief Global sums and maxima of several values computed by one collective.
+///
+/// The values are queued by addSum() and addMax(), begin() starts the
+/// reduction and end() waits for it. With MPI the reduction is a single
+/// non-blocking MPI_Iallreduce with an operation that adds the sums and
+/// takes the maxima of the rest, hence the caller can do work that does
+/// not need the results between begin() and end().
+class ReductionBatch
+{
+public:
+    ReductionBatch()
+        : pending_(false)
+    {
+#if HAVE_MPI
+        request_ = MPI_REQUEST_NULL;
+#endif
+    }
+
+    ~ReductionBatch()
+    {
+        if ( pending_ )
+        {
+            end();
+        }
+    }
+
+    ReductionBatch(const ReductionBatch&) = delete;
+    ReductionBatch& operator=(const ReductionBatch&) = delete;
+
+    /// \brief Remove all the queued values.
+    void clear()
+    {
+        assert( !pending_ );
+        sums_.clear();
+        maxima_.clear();
+    }
+
+    /// \brief Queue a value to sum, returns its index for sum().
+    std::size_t addSum(double value)
+    {
+        assert( !pending_ );
+        sums_.push_back(value);
+        return sums_.size() - 1;
+    }
+
+    /// \brief Queue a value to maximize, returns its index for max().
+    std::size_t addMax(double value)
+    {
+        assert( !pending_ );
+        maxima_.push_back(value);
+        return maxima_.size() - 1;
+    }
+
+    /// \brief Start the reduction over all processes of a communication.
+    template<class Comm>
+    void begin(const Comm& comm)
+    {
+        assert( !pending_ );
+        pending_ = true;
+        start_(comm);
+    }
+
+    /// \brief Wait for the reduction started by begin().
+    void end()
+    {
+        assert( pending_ );
+#if HAVE_MPI
+        if ( request_ != MPI_REQUEST_NULL )
+        {
+            static auto& timing = TimingRegistry::instance().entry("mpi.reduction_wait");
+            ScopedTiming scopedTiming(timing);
+            MPI_Wait(&request_, MPI_STATUS_IGNORE);
+            std::copy(buffer_.begin() + 1, buffer_.begin() + 1 + sums_.size(), sums_.begin());
+            std::copy(buffer_.begin() + 1 + sums_.size(), buffer_.end(), maxima_.begin());
+        }
+#endif
+        pending_ = false;
+    }
+
+    /// \brief The global sum of the value with the given index, after end().
+    double sum(std::size_t index) const
+    {
+        assert( !pending_ );
+        return sums_[index];
+    }
+
+    /// \brief The global maximum of the value with the given index, after end().
+    double max(std::size_t index) const
+    {
+        assert( !pending_ );
+        return maxima_[index];
+    }
+
+private:
+    // Any other communication, e.g. the sequential one, reduces the values with blocking calls.
+    template<class Comm>
+    void start_(const Comm& comm)
+    {
+        if ( comm.size() > 1 )
+        {
+            if ( !sums_.empty() )
+            {
+                comm.sum(sums_.data(), sums_.size());
+            }
+            if ( !maxima_.empty() )
+            {
+                comm.max(maxima_.data(), maxima_.size());
+            }
+        }
+    }
+
+#if HAVE_MPI
+    void start_(const Dune::CollectiveCommunication<MPI_Comm>& comm)
+    {
+        if ( comm.size() == 1 )
+        {
+            return;
+        }
+
+        // The number of sums leads the buffer, which is the same on all processes.
+        buffer_.resize(1 + sums_.size() + maxima_.size());
+        buffer_[0] = sums_.size();
+        std::copy(sums_.begin(), sums_.end(), buffer_.begin() + 1);
+        std::copy(maxima_.begin(), maxima_.end(), buffer_.begin() + 1 + sums_.size());
+        MPI_Iallreduce(MPI_IN_PLACE, buffer_.data(), buffer_.size(), MPI_DOUBLE,
+                       sumAndMaxOperation_(), static_cast<MPI_Comm>(comm), &request_);
+    }
+
+    static void sumAndMax_(void* in, void* inout, int* len, MPI_Datatype*)
+    {
+        const double* a = static_cast<const double*>(in);
+        double* b = static_cast<double*>(inout);
+        const int numSums = static_cast<int>(b[0]);
+        for ( int i = 1; i <= numSums; ++i )
+        {
+            b[i] += a[i];
+        }
+        for ( int i = numSums + 1; i < *len; ++i )
+        {
+            b[i] = std::max(a[i], b[i]);
+        }
+    }
+
+    static MPI_Op sumAndMaxOperation_()
+    {
+        static MPI_Op operation = []() {
+            MPI_Op op;
+            MPI_Op_create(&sumAndMax_, /*commute=*/1, &op);
+            return op;
+        }();
+        return operation;
+    }
+
+    MPI_Request request_;
+    std::vector<double> buffer_;
+#endif
+
+    std::vector<double> sums_;
+    std::vector<double> maxima_;
+    bool pending_;
+};
+
+} // namespace Opm
+
+#endif // OPM_REDUCTIONBATCH_HEADER_INCLUDED
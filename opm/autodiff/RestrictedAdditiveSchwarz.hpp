@@ -0,0 +1,362 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_RESTRICTEDADDITIVESCHWARZ_HEADER_INCLUDED
+#define OPM_RESTRICTEDADDITIVESCHWARZ_HEADER_INCLUDED
+
+#include <opm/autodiff/ParallelRestrictedAdditiveSchwarz.hpp>
+#include <opm/autodiff/ParallelOverlappingILU0.hpp>
+#include <opm/autodiff/MatrixBlock.hpp>
+#include <opm/autodiff/TimingRegistry.hpp>
+#include <opm/common/ErrorMacros.hpp>
+
+#include <opm/common/utility/platform_dependent/disable_warnings.h>
+#include <dune/common/version.hh>
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/preconditioner.hh>
+#include <dune/istl/solver.hh>
+#include <dune/istl/solvercategory.hh>
+#include <dune/istl/paamg/pinfo.hh>
+#if HAVE_MPI
+#include <dune/common/enumset.hh>
+#include <dune/common/parallel/interface.hh>
+#include <dune/istl/owneroverlapcopy.hh>
+#include <mpi.h>
+#endif
+#include <opm/common/utility/platform_dependent/reenable_warnings.h>
+
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace Opm
+{
+
+//! \brief The solvers for the subdomain problems of RestrictedAdditiveSchwarz.
+enum class RAS_LOCAL_SOLVER {
+    //! \brief ILU0 of the subdomain matrix (default).
+    ILU0,
+    //! \brief ILU(k) of the subdomain matrix.
+    ILUK,
+    //! \brief Sparse direct solver (UMFPack or SuperLU). Only for small subdomains.
+    DIRECT
+};
+
+inline RAS_LOCAL_SOLVER convertString2RasLocalSolver(const std::string& solver)
+{
+    if ( solver.empty() || solver == "ILU0" )
+    {
+        return RAS_LOCAL_SOLVER::ILU0;
+    }
+    if ( solver == "ILUK" )
+    {
+        return RAS_LOCAL_SOLVER::ILUK;
+    }
+    if ( solver == "Direct" )
+    {
+        return RAS_LOCAL_SOLVER::DIRECT;
+    }
+    OPM_THROW(std::invalid_argument, "Unknown local solver '" << solver
+              << "' for restricted additive Schwarz. Possible values are ILU0, ILUK and Direct");
+}
+
+namespace Detail
+{
+    /// \brief Uses a (direct) inverse operator as preconditioner.
+    template<class Solver, class X>
+    class InverseOperatorPreconditioner
+        : public Dune::Preconditioner<X,X>
+    {
+    public:
+        explicit InverseOperatorPreconditioner(std::unique_ptr<Solver>&& solver)
+            : solver_(std::move(solver))
+        {}
+
+#if DUNE_VERSION_NEWER(DUNE_ISTL, 2, 6)
+        Dune::SolverCategory::Category category() const override
+        {
+            return Dune::SolverCategory::sequential;
+        }
+#endif
+
+        virtual void pre(X&, X&)
+        {}
+
+        virtual void apply(X& v, const X& d)
+        {
+            X rhs(d);
+            Dune::InverseOperatorResult res;
+            solver_->apply(v, rhs, res);
+        }
+
+        virtual void post(X&)
+        {}
+
+    private:
+        std::unique_ptr<Solver> solver_;
+    };
+
+    /// \brief Sequential runs have no ghost rows.
+    template<class M>
+    void copyOwnerRowsToGhostRows(M&, const Dune::Amg::SequentialInformation&)
+    {}
+
+#if HAVE_MPI
+    /// \brief Overwrite the rows of the ghost entries with the rows of their owners.
+    ///
+    /// The rows of the ghost cells in the assembled Jacobian miss the
+    /// contributions of the neighbours outside of this process. Their owners
+    /// send the complete rows. Entries for columns that are not present on this
+    /// process are dropped, which gives the matrix of the local subdomain
+    /// problem with Dirichlet conditions on its boundary. The sparsity
+    /// pattern is unchanged.
+    template<class M, class GlobalIndex, class LocalIndex>
+    void copyOwnerRowsToGhostRows(M& A, const Dune::OwnerOverlapCopyCommunication<GlobalIndex, LocalIndex>& comm)
+    {
+        static auto& timing = TimingRegistry::instance().entry("mpi.ghost_rows");
+        ScopedTiming scopedTiming(timing);
+
+        const int tag = 4713;
+        const std::size_t rows = M::block_type::rows;
+        const std::size_t cols = M::block_type::cols;
+        const auto& indexSet = comm.indexSet();
+        MPI_Comm mpiComm = comm.communicator();
+
+        std::vector<double> globalIndex(A.N(), -1.0);
+        for ( const auto& index : indexSet )
+        {
+            globalIndex[index.local().local()] = index.global();
+        }
+
+        typedef Dune::OwnerOverlapCopyAttributeSet::AttributeSet Attribute;
+        Dune::EnumItem<Attribute, Dune::OwnerOverlapCopyAttributeSet::owner> ownerFlags;
+        Dune::AllSet<Attribute> allFlags;
+        Dune::Interface interface;
+        interface.build(comm.remoteIndices(), ownerFlags, allFlags);
+
+        // Send the owned rows: number of entries, then global column and block for each entry.
+        std::vector<std::vector<double> > sendBuffers;
+        std::vector<MPI_Request> requests;
+        sendBuffers.reserve(interface.interfaces().size());
+        requests.reserve(interface.interfaces().size());
+        for ( const auto& entry : interface.interfaces() )
+        {
+            const auto& sendInfo = entry.second.first;
+            if ( sendInfo.size() == 0 )
+            {
+                continue;
+            }
+            sendBuffers.emplace_back();
+            auto& buffer = sendBuffers.back();
+            for ( std::size_t i = 0; i < sendInfo.size(); ++i )
+            {
+                const auto& row = A[sendInfo[i]];
+                const std::size_t countPos = buffer.size();
+                buffer.push_back(0.0);
+                for ( auto col = row.begin(); col != row.end(); ++col )
+                {
+                    if ( globalIndex[col.index()] < 0.0 )
+                    {
+                        continue;
+                    }
+                    buffer[countPos] += 1.0;
+                    buffer.push_back(globalIndex[col.index()]);
+                    for ( std::size_t r = 0; r < rows; ++r )
+                    {
+                        for ( std::size_t c = 0; c < cols; ++c )
+                        {
+                            buffer.push_back((*col)[r][c]);
+                        }
+                    }
+                }
+            }
+            requests.emplace_back();
+            MPI_Isend(buffer.data(), buffer.size(), MPI_DOUBLE, entry.first, tag, mpiComm, &requests.back());
+        }
+
+        for ( const auto& entry : interface.interfaces() )
+        {
+            const auto& receiveInfo = entry.second.second;
+            if ( receiveInfo.size() == 0 )
+            {
+                continue;
+            }
+            MPI_Status status;
+            MPI_Probe(entry.first, tag, mpiComm, &status);
+            int count = 0;
+            MPI_Get_count(&status, MPI_DOUBLE, &count);
+            std::vector<double> buffer(count);
+            MPI_Recv(buffer.data(), count, MPI_DOUBLE, entry.first, tag, mpiComm, MPI_STATUS_IGNORE);
+
+            std::size_t pos = 0;
+            for ( std::size_t i = 0; i < receiveInfo.size(); ++i )
+            {
+                auto& row = A[receiveInfo[i]];
+                row = 0.0;
+                const std::size_t entries = buffer[pos++];
+                for ( std::size_t k = 0; k < entries; ++k )
+                {
+                    const GlobalIndex global = buffer[pos++];
+                    if ( indexSet.exists(global) )
+                    {
+                        const auto col = row.find(indexSet[global].local());
+                        if ( col != row.end() )
+                        {
+                            for ( std::size_t r = 0; r < rows; ++r )
+                            {
+                                for ( std::size_t c = 0; c < cols; ++c )
+                                {
+                                    (*col)[r][c] = buffer[pos + r * cols + c];
+                                }
+                            }
+                        }
+                    }
+                    pos += rows * cols;
+                }
+            }
+        }
+
+        MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+    }
+#endif
+} // end namespace Detail
+
+/// \brief Restricted additive Schwarz (RAS) with its own subdomain matrix and solver.
+///
+/// Each process solves the problem of its subdomain, which consists of
+/// the cells it owns and, for an overlap of one, the ghost cells around
+/// them. Afterwards only the owned values are kept and copied to the other
+/// processes (see ParallelRestrictedOverlappingSchwarz). Compared to the
+/// ParallelOverlappingILU0, which ignores the rows of the ghost cells, the
+/// information exchanged by the overlap improves the convergence for many
+/// processes. The overlap is limited by the ghost layer of the grid
+/// partition, i.e. to one cell.
+/// \tparam M The type of the matrix.
+/// \tparam X The type of the vectors.
+/// \tparam C The type of the parallel information.
+template<class M, class X, class C>
+class RestrictedAdditiveSchwarz
+    : public Dune::Preconditioner<X,X>
+{
+public:
+    typedef M matrix_type;
+    typedef X domain_type;
+    typedef X range_type;
+    typedef typename X::field_type field_type;
+    typedef C communication_type;
+
+    /// \brief Constructor.
+    /// \param A The matrix of the system. Its ghost rows may be invalid.
+    /// \param comm The parallel information.
+    /// \param overlap The number of layers of ghost cells in the subdomains (0 or 1).
+    /// \param localSolver The solver for the subdomain problems.
+    /// \param iluFillin The fill-in level for RAS_LOCAL_SOLVER::ILUK.
+    /// \param w The relaxation factor of the ILU.
+    /// \param milu The modified ILU variant to use.
+    RestrictedAdditiveSchwarz(const M& A, const C& comm, int overlap,
+                              RAS_LOCAL_SOLVER localSolver, int iluFillin,
+                              field_type w, MILU_VARIANT milu)
+        : localMatrix_(A)
+    {
+        if ( overlap > 0 )
+        {
+            Detail::copyOwnerRowsToGhostRows(localMatrix_, comm);
+        }
+
+        switch ( localSolver )
+        {
+        case RAS_LOCAL_SOLVER::DIRECT:
+            localSolver_ = createDirectSolver();
+            break;
+        case RAS_LOCAL_SOLVER::ILUK:
+            localSolver_.reset(new LocalILU(localMatrix_, iluFillin, w, milu));
+            break;
+        default:
+            localSolver_.reset(new LocalILU(localMatrix_, 0, w, milu));
+        }
+
+        schwarz_.reset(new Schwarz(*localSolver_, comm));
+    }
+
+#if DUNE_VERSION_NEWER(DUNE_ISTL, 2, 6)
+    Dune::SolverCategory::Category category() const override
+    {
+        return std::is_same<C, Dune::Amg::SequentialInformation>::value ?
+            Dune::SolverCategory::sequential : Dune::SolverCategory::overlapping;
+    }
+#endif
+
+    virtual void pre(X& x, X& b)
+    {
+        schwarz_->pre(x, b);
+    }
+
+    virtual void apply(X& v, const X& d)
+    {
+        static auto& timing = TimingRegistry::instance().entry("ras.apply");
+        ScopedTiming scopedTiming(timing);
+        schwarz_->apply(v, d);
+    }
+
+    virtual void post(X& x)
+    {
+        schwarz_->post(x);
+    }
+
+private:
+    // Like the ILU preconditioner of ISTLSolverEbos the blocks use the OPM block inversion.
+    typedef Dune::BCRSMatrix<Dune::MatrixBlock<typename M::field_type,
+                                               M::block_type::rows,
+                                               M::block_type::cols> > LocalMatrix;
+    typedef ParallelOverlappingILU0<LocalMatrix, X, X> LocalILU;
+    typedef Dune::Preconditioner<X,X> LocalSolver;
+    typedef ParallelRestrictedOverlappingSchwarz<X, X, C, LocalSolver> Schwarz;
+
+    std::unique_ptr<LocalSolver> createDirectSolver() const
+    {
+        // MatrixBlock only adds methods to FieldMatrix. Therefore this cast is safe.
+        const LocalMatrix& matrix = reinterpret_cast<const LocalMatrix&>(localMatrix_);
+#if HAVE_UMFPACK
+        typedef Dune::UMFPack<LocalMatrix> Direct;
+        std::unique_ptr<Direct> direct(new Direct(matrix, 0, false));
+#elif HAVE_SUPERLU
+        typedef Dune::SuperLU<LocalMatrix> Direct;
+        std::unique_ptr<Direct> direct(new Direct(matrix, 0, true));
+#else
+        DUNE_UNUSED_PARAMETER(matrix);
+        OPM_THROW(std::invalid_argument, "The direct local solver of restricted additive Schwarz "
+                  "needs UMFPack or SuperLU");
+#endif
+#if HAVE_UMFPACK || HAVE_SUPERLU
+        return std::unique_ptr<LocalSolver>(new Detail::InverseOperatorPreconditioner<Direct, X>(std::move(direct)));
+#endif
+    }
+
+    //! \brief The matrix of the subdomain problem.
+    M localMatrix_;
+    std::unique_ptr<LocalSolver> localSolver_;
+    std::unique_ptr<Schwarz> schwarz_;
+};
+
+} // end namespace Opm
+
+#endif // OPM_RESTRICTEDADDITIVESCHWARZ_HEADER_INCLUDED
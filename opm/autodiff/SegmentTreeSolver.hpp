@@ -0,0 +1,236 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_SEGMENTTREESOLVER_HEADER_INCLUDED
+#define OPM_SEGMENTTREESOLVER_HEADER_INCLUDED
+
+#include <opm/common/ErrorMacros.hpp>
+#include <opm/common/Exceptions.hpp>
+
+#include <opm/common/utility/platform_dependent/disable_warnings.h>
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <opm/common/utility/platform_dependent/reenable_warnings.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+namespace Opm
+{
+
+/// \brief Direct solver for the segment equations of a multi-segment well.
+///
+/// A segment is only coupled to its outlet and to its inlets, hence the
+/// graph of the matrix is a tree (a forest if there are several top
+/// segments). Eliminating the segments from the leaves towards the top
+/// creates no fill-in: eliminating segment s only changes the diagonal
+/// block of its outlet o by D_os D~_ss^-1 D_so, where D~_ss is the already
+/// updated diagonal block of s. The factorization and each solve thus cost
+/// O(segments) operations on fixed-size blocks. After the first
+/// factorization of a well, no memory is allocated.
+/// \tparam Matrix The type of the segment matrix (a BCRSMatrix of FieldMatrix blocks).
+/// \tparam Vector The type of the segment vectors.
+template<class Matrix, class Vector>
+class SegmentTreeSolver
+{
+public:
+    typedef typename Matrix::block_type Block;
+    typedef typename Vector::block_type VectorBlock;
+
+    /// \brief Factorize a segment matrix.
+    /// \param D The segment matrix.
+    /// \param inlets The inlet segments of each segment.
+    /// \return Whether the matrix has the pattern of the segment tree. If
+    ///         not, nothing is factorized and apply() must not be used.
+    bool update(const Matrix& D, const std::vector<std::vector<int>>& inlets)
+    {
+        const std::size_t n = D.N();
+        if ( inlets.size() != n || !setupOrder(inlets) || !treePattern(D) )
+        {
+            factorized_ = false;
+            return false;
+        }
+
+        invDiagonal_.resize(n);
+        lower_.resize(n);
+        upper_.resize(n);
+        for ( std::size_t s = 0; s < n; ++s )
+        {
+            invDiagonal_[s] = D[s][s];
+        }
+        for ( const int s : order_ )
+        {
+            // all inlets of s are eliminated, invDiagonal_[s] holds D~_ss
+            try
+            {
+                invDiagonal_[s].invert();
+            }
+            catch ( const Dune::FMatrixError& )
+            {
+                factorized_ = false;
+                OPM_THROW(NumericalIssue, "Singular diagonal block of segment " << s << " in the segment tree solver");
+            }
+            const int o = outlet_[s];
+            if ( o < 0 )
+            {
+                continue;
+            }
+            // L_s = D_os D~_ss^-1, D~_oo -= L_s D_so
+            lower_[s] = block(D, o, s);
+            lower_[s].rightmultiply(invDiagonal_[s]);
+            upper_[s] = block(D, s, o);
+            Block update = lower_[s];
+            update.rightmultiply(upper_[s]);
+            invDiagonal_[o] -= update;
+        }
+        work_.resize(n);
+        factorized_ = true;
+        return true;
+    }
+
+    /// \brief Whether the last update() succeeded.
+    bool factorized() const
+    {
+        return factorized_;
+    }
+
+    /// \brief Solve D v = d with the factorization of the last update().
+    void apply(Vector& v, const Vector& d)
+    {
+        assert(factorized_);
+        work_ = d;
+        // forward elimination from the leaves to the top
+        for ( const int s : order_ )
+        {
+            const int o = outlet_[s];
+            if ( o >= 0 )
+            {
+                lower_[s].mmv(work_[s], work_[o]);
+            }
+        }
+        // back substitution from the top to the leaves
+        for ( auto it = order_.rbegin(), end = order_.rend(); it != end; ++it )
+        {
+            const int s = *it;
+            const int o = outlet_[s];
+            if ( o >= 0 )
+            {
+                upper_[s].mmv(v[o], work_[s]);
+            }
+            invDiagonal_[s].mv(work_[s], v[s]);
+        }
+    }
+
+private:
+    /// \brief The outlet of each segment and the order of the segments with
+    ///        all inlets of a segment before it.
+    /// \return Whether the inlets form a tree.
+    bool setupOrder(const std::vector<std::vector<int>>& inlets)
+    {
+        const int n = inlets.size();
+        outlet_.assign(n, -1);
+        for ( int s = 0; s < n; ++s )
+        {
+            for ( const int inlet : inlets[s] )
+            {
+                if ( inlet < 0 || inlet >= n || outlet_[inlet] >= 0 || inlet == s )
+                {
+                    return false;
+                }
+                outlet_[inlet] = s;
+            }
+        }
+
+        // breadth first from the top segments, reversed
+        order_.clear();
+        order_.reserve(n);
+        for ( int s = 0; s < n; ++s )
+        {
+            if ( outlet_[s] < 0 )
+            {
+                order_.push_back(s);
+            }
+        }
+        for ( std::size_t pos = 0; pos < order_.size(); ++pos )
+        {
+            for ( const int inlet : inlets[order_[pos]] )
+            {
+                order_.push_back(inlet);
+            }
+        }
+        if ( static_cast<int>(order_.size()) != n )
+        {
+            // a cycle without a top segment
+            return false;
+        }
+        std::reverse(order_.begin(), order_.end());
+        return true;
+    }
+
+    /// \brief Whether each segment is only coupled to its outlet and inlets.
+    bool treePattern(const Matrix& D) const
+    {
+        for ( auto row = D.begin(), rowEnd = D.end(); row != rowEnd; ++row )
+        {
+            const int s = row.index();
+            bool hasDiagonal = false;
+            for ( auto col = row->begin(), colEnd = row->end(); col != colEnd; ++col )
+            {
+                const int c = col.index();
+                if ( c == s )
+                {
+                    hasDiagonal = true;
+                }
+                else if ( c != outlet_[s] && outlet_[c] != s )
+                {
+                    return false;
+                }
+            }
+            if ( !hasDiagonal )
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// \brief The block (i, j) of D, zero if it is not in the pattern.
+    static Block block(const Matrix& D, const int i, const int j)
+    {
+        const auto& row = D[i];
+        const auto col = row.find(j);
+        return col != row.end() ? Block(*col) : Block(0.0);
+    }
+
+    bool factorized_ = false;
+    std::vector<int> outlet_;
+    std::vector<int> order_;
+    // the inverses of the eliminated diagonal blocks D~_ss
+    std::vector<Block> invDiagonal_;
+    // D_os D~_ss^-1 and D_so of each segment s with outlet o
+    std::vector<Block> lower_;
+    std::vector<Block> upper_;
+    Vector work_;
+};
+
+} // end namespace Opm
+
+#endif // OPM_SEGMENTTREESOLVER_HEADER_INCLUDED
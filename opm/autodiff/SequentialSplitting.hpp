@@ -0,0 +1,261 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_SEQUENTIALSPLITTING_HEADER_INCLUDED
+#define OPM_SEQUENTIALSPLITTING_HEADER_INCLUDED
+
+#include <opm/autodiff/CPRPreconditioner.hpp>
+#include <opm/autodiff/TimingRegistry.hpp>
+#include <opm/common/ErrorMacros.hpp>
+#include <opm/common/Exceptions.hpp>
+
+#include <opm/common/utility/platform_dependent/disable_warnings.h>
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/paamg/pinfo.hh>
+#include <dune/istl/solvers.hh>
+#include <opm/common/utility/platform_dependent/reenable_warnings.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+namespace Opm
+{
+
+/// \brief Sequential (pressure, then transport) solution of the Newton
+///        system of the fully implicit model.
+///
+/// First the pressure system, the combination of the equations of each cell
+/// with its (true- or quasi-IMPES) weights restricted to the pressure
+/// unknowns, is solved with AMG. Then the other unknowns are computed with
+/// the pressure update fixed, by block Gauss-Seidel sweeps over the cells in
+/// the order of decreasing pressure. With a fixed total velocity the
+/// upwinded transport equations of a cell only depend on the cells upstream
+/// of it, hence this order makes one sweep nearly exact. In the transport
+/// step, the reference equation of each cell is left out, since its
+/// information is contained in the pressure equation.
+/// \tparam Matrix The type of the (sequential) Jacobian.
+/// \tparam Vector The type of the vectors of the Jacobian.
+template<class Matrix, class Vector>
+class SequentialSplitting
+{
+public:
+    typedef typename Vector::field_type field_type;
+    static const int numEq = Vector::block_type::dimension;
+    static_assert(numEq > 1, "The transport step needs more than one equation per cell");
+
+    typedef Dune::BCRSMatrix<Dune::FieldMatrix<field_type, 1, 1> > PressureMatrix;
+    typedef Dune::BlockVector<Dune::FieldVector<field_type, 1> > PressureVector;
+
+    /// \brief Set up the pressure system.
+    /// \param J The Jacobian.
+    /// \param r The residual.
+    /// \param weights The weights of the equations of each cell.
+    /// \param pressureIndex The index of the pressure unknown.
+    void assemblePressure(const Matrix& J, const Vector& r, const Vector& weights,
+                          const int pressureIndex)
+    {
+        if ( pressureMatrix_.N() != J.N() || pressureMatrix_.nonzeroes() != J.nonzeroes() )
+        {
+            pressureMatrix_ = PressureMatrix(J.N(), J.M(), J.nonzeroes(), PressureMatrix::row_wise);
+            auto fromRow = J.begin();
+            for ( auto row = pressureMatrix_.createbegin(), rowEnd = pressureMatrix_.createend(); row != rowEnd; ++row, ++fromRow )
+            {
+                for ( auto col = fromRow->begin(), colEnd = fromRow->end(); col != colEnd; ++col )
+                {
+                    row.insert(col.index());
+                }
+            }
+            // the pattern changed, the hierarchy has to be rebuilt
+            amg_.reset();
+        }
+
+        auto toRow = pressureMatrix_.begin();
+        for ( auto row = J.begin(), rowEnd = J.end(); row != rowEnd; ++row, ++toRow )
+        {
+            const auto& weight = weights[row.index()];
+            auto toCol = toRow->begin();
+            for ( auto col = row->begin(), colEnd = row->end(); col != colEnd; ++col, ++toCol )
+            {
+                field_type entry = 0.0;
+                for ( int eq = 0; eq < numEq; ++eq )
+                {
+                    entry += weight[eq] * (*col)[eq][pressureIndex];
+                }
+                *toCol = entry;
+            }
+        }
+
+        pressureRhs_.resize(r.size());
+        for ( std::size_t i = 0; i < r.size(); ++i )
+        {
+            pressureRhs_[i] = weights[i] * r[i];
+        }
+    }
+
+    /// \brief Solve the pressure system with AMG preconditioned BiCGSTAB.
+    /// \param dp The pressure update.
+    /// \param reduction The reduction of the residual.
+    /// \param maxIter The maximum number of iterations.
+    /// \param relax The relaxation factor of the ILU smoother.
+    /// \param milu The variant of the ILU smoother.
+    Dune::InverseOperatorResult solvePressure(PressureVector& dp, const double reduction,
+                                              const int maxIter, const double relax,
+                                              const MILU_VARIANT milu)
+    {
+        static auto& timing = TimingRegistry::instance().entry("sequential.pressure");
+        ScopedTiming scopedTiming(timing);
+
+        typedef Dune::Amg::SequentialInformation Communication;
+        typedef ISTLUtility::CPRSelector<PressureMatrix, PressureVector, PressureVector, Communication> Selector;
+
+        Communication comm;
+        if ( !operator_ )
+        {
+            operator_.reset(Selector::makeOperator(pressureMatrix_, comm));
+        }
+        // The hierarchy is only rebuilt for a new pattern, otherwise its values are updated.
+        if ( amg_ )
+        {
+            amg_->recalculateHierarchy();
+        }
+        else
+        {
+            ISTLUtility::createAMGPreconditionerPointer<0>(*operator_, relax, milu, comm, amg_);
+        }
+
+        dp.resize(pressureRhs_.size());
+        dp = 0.0;
+        PressureVector rhs(pressureRhs_);
+        Dune::BiCGSTABSolver<PressureVector> linsolve(*operator_, *amg_, reduction, maxIter, /*verbose=*/0);
+        Dune::InverseOperatorResult result;
+        linsolve.apply(dp, rhs, result);
+        return result;
+    }
+
+    /// \brief The cells ordered by decreasing pressure, i.e. upstream first
+    ///        if the flow is driven by the pressure.
+    static std::vector<std::size_t> upstreamOrder(const std::vector<double>& pressure)
+    {
+        std::vector<std::size_t> order(pressure.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(),
+                         [&pressure](std::size_t a, std::size_t b) { return pressure[a] > pressure[b]; });
+        return order;
+    }
+
+    /// \brief Compute the other unknowns for a fixed pressure update.
+    /// \param J The Jacobian.
+    /// \param r The residual.
+    /// \param order The order of the cells in the sweeps.
+    /// \param pressureIndex The index of the pressure unknown.
+    /// \param referenceEq The index of the equation left out in each cell.
+    /// \param sweeps The number of block Gauss-Seidel sweeps.
+    /// \param dx The update. The pressure entries are given, the others are
+    ///           computed (their initial values are used in the first sweep).
+    static void transportSweeps(const Matrix& J, const Vector& r, const std::vector<std::size_t>& order,
+                                const int pressureIndex, const int referenceEq, const int sweeps,
+                                Vector& dx)
+    {
+        static auto& timing = TimingRegistry::instance().entry("sequential.transport");
+        ScopedTiming scopedTiming(timing);
+
+        typedef Dune::FieldMatrix<field_type, numEq - 1, numEq - 1> TransportBlock;
+        typedef Dune::FieldVector<field_type, numEq - 1> TransportVector;
+
+        for ( int sweep = 0; sweep < sweeps; ++sweep )
+        {
+            for ( const auto i : order )
+            {
+                // residual of the cell without the contribution of its transport unknowns
+                auto rhs = r[i];
+                const auto& row = J[i];
+                TransportBlock diagonal(0.0);
+                for ( auto col = row.begin(), colEnd = row.end(); col != colEnd; ++col )
+                {
+                    if ( col.index() != i )
+                    {
+                        col->mmv(dx[col.index()], rhs);
+                        continue;
+                    }
+                    const auto& block = *col;
+                    for ( int eq = 0, e = 0; eq < numEq; ++eq )
+                    {
+                        rhs[eq] -= block[eq][pressureIndex] * dx[i][pressureIndex];
+                        if ( eq == referenceEq )
+                        {
+                            continue;
+                        }
+                        for ( int k = 0, l = 0; k < numEq; ++k )
+                        {
+                            if ( k != pressureIndex )
+                            {
+                                diagonal[e][l++] = block[eq][k];
+                            }
+                        }
+                        ++e;
+                    }
+                }
+
+                TransportVector reducedRhs;
+                for ( int eq = 0, e = 0; eq < numEq; ++eq )
+                {
+                    if ( eq != referenceEq )
+                    {
+                        reducedRhs[e++] = rhs[eq];
+                    }
+                }
+                TransportVector update;
+                try
+                {
+                    diagonal.solve(update, reducedRhs);
+                }
+                catch ( const Dune::FMatrixError& )
+                {
+                    OPM_THROW(NumericalIssue, "Singular transport block in cell " << i);
+                }
+                for ( int k = 0, l = 0; k < numEq; ++k )
+                {
+                    if ( k != pressureIndex )
+                    {
+                        dx[i][k] = update[l++];
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    typedef typename ISTLUtility::CPRSelector<PressureMatrix, PressureVector, PressureVector,
+                                              Dune::Amg::SequentialInformation> PressureSelector;
+
+    PressureMatrix pressureMatrix_;
+    PressureVector pressureRhs_;
+    std::unique_ptr<typename PressureSelector::Operator> operator_;
+    std::unique_ptr<typename PressureSelector::AMG> amg_;
+};
+
+} // end namespace Opm
+
+#endif // OPM_SEQUENTIALSPLITTING_HEADER_INCLUDED
@@ -23,27 +23,57 @@
 #define OPM_SIMULATORFULLYIMPLICITBLACKOILEBOS_HEADER_INCLUDED
 
 #include <opm/autodiff/IterationReport.hpp>
-#include <opm/autodiff/NonlinearSolverEbos.hpp>
+#include <opm/autodiff/NonlinearSolverDomainDecompositionEbos.hpp>
 #include <opm/autodiff/BlackoilModelEbos.hpp>
 #include <opm/autodiff/BlackoilModelParametersEbos.hpp>
 #include <opm/autodiff/WellStateFullyImplicitBlackoil.hpp>
 #include <opm/autodiff/BlackoilAquiferModel.hpp>
 #include <opm/autodiff/moduleVersion.hpp>
+#include <opm/autodiff/MemoryRegistry.hpp>
+#include <opm/autodiff/TimingRegistry.hpp>
+#include <opm/autodiff/NewtonTrace.hpp>
+#include <opm/autodiff/ConvergenceHotSpots.hpp>
+#include <opm/autodiff/LoadImbalanceMonitor.hpp>
+#include <opm/autodiff/ProcessTimingStatistics.hpp>
+#include <opm/simulators/GatheringLog.hpp>
+#include <opm/core/simulator/PerformanceReport.hpp>
 #include <opm/simulators/timestepping/AdaptiveTimeSteppingEbos.hpp>
 #include <opm/grid/utility/StopWatch.hpp>
 
 #include <opm/common/Exceptions.hpp>
 #include <opm/common/ErrorMacros.hpp>
 
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <numeric>
+#include <sstream>
+
 BEGIN_PROPERTIES
 
 NEW_PROP_TAG(EnableTerminalOutput);
 NEW_PROP_TAG(EnableAdaptiveTimeStepping);
 NEW_PROP_TAG(EnableTuning);
+NEW_PROP_TAG(LoadImbalanceWindow);
+NEW_PROP_TAG(LoadImbalanceThreshold);
+NEW_PROP_TAG(EnableProcessTimingStatistics);
+NEW_PROP_TAG(PerformanceReportFile);
+NEW_PROP_TAG(PerformanceReportCsvFile);
+NEW_PROP_TAG(EnableMemoryReport);
+NEW_PROP_TAG(TraceFile);
 
 SET_BOOL_PROP(EclFlowProblem, EnableTerminalOutput, true);
 SET_BOOL_PROP(EclFlowProblem, EnableAdaptiveTimeStepping, true);
 SET_BOOL_PROP(EclFlowProblem, EnableTuning, false);
+SET_INT_PROP(EclFlowProblem, LoadImbalanceWindow, 0);
+SET_SCALAR_PROP(EclFlowProblem, LoadImbalanceThreshold, 0.2);
+SET_BOOL_PROP(EclFlowProblem, EnableProcessTimingStatistics, false);
+SET_STRING_PROP(EclFlowProblem, PerformanceReportFile, "");
+SET_STRING_PROP(EclFlowProblem, PerformanceReportCsvFile, "");
+SET_BOOL_PROP(EclFlowProblem, EnableMemoryReport, false);
+SET_STRING_PROP(EclFlowProblem, TraceFile, "");
 
 END_PROPERTIES
 
@@ -70,7 +100,7 @@ public:
 
     typedef WellStateFullyImplicitBlackoil WellState;
     typedef BlackoilModelEbos<TypeTag> Model;
-    typedef NonlinearSolverEbos<TypeTag, Model> Solver;
+    typedef NonlinearSolverDomainDecompositionEbos<TypeTag, Model> Solver;
     typedef typename Model::ModelParameters ModelParameters;
     typedef typename Solver::SolverParameters SolverParameters;
     typedef BlackoilWellModel<TypeTag> WellModel;
@@ -124,6 +154,20 @@ public:
                              "Use adaptive time stepping between report steps");
         EWOMS_REGISTER_PARAM(TypeTag, bool, EnableTuning,
                              "Honor some aspects of the TUNING keyword.");
+        EWOMS_REGISTER_PARAM(TypeTag, int, LoadImbalanceWindow,
+                             "The number of report steps over which the load imbalance of the processes is measured, 0 disables the measurement");
+        EWOMS_REGISTER_PARAM(TypeTag, double, LoadImbalanceThreshold,
+                             "The imbalance of the time of the processes, i.e. the largest relative to the mean time minus one, at which a repartition is reported");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, EnableProcessTimingStatistics,
+                             "Report the minimum, mean and maximum over the processes of the assembly, well, linear solve and communication wait times of each report step");
+        EWOMS_REGISTER_PARAM(TypeTag, std::string, PerformanceReportFile,
+                             "The JSON file to write the timings and iteration counts of each report step and the peak memory of each process to at the end of the run");
+        EWOMS_REGISTER_PARAM(TypeTag, std::string, PerformanceReportCsvFile,
+                             "The CSV file to write the timings and iteration counts of each report step to as soon as the step is done");
+        EWOMS_REGISTER_PARAM(TypeTag, bool, EnableMemoryReport,
+                             "Report the peak memory of the Jacobian, the ILU factors, the wells and the aquifers of the processes at the end of the run");
+        EWOMS_REGISTER_PARAM(TypeTag, std::string, TraceFile,
+                             "The Chrome trace event file (for chrome://tracing or the Perfetto UI) to write a timeline of the report steps, the Newton iterations and the timed sections of all processes to at the end of the run");
     }
 
     /// Run the simulation.
@@ -195,8 +239,43 @@ public:
         // beginning of a restart
         bool firstRestartStep = isRestart();
 
+        // the file for the timings of the linear solver stages
+        std::ofstream timingFile;
+        const auto& timingFileName = linearSolver_.parameters().linear_solver_timing_file_;
+        if (terminalOutput_ && TimingRegistry::instance().enabled() && !timingFileName.empty()) {
+            timingFile.open(timingFileName);
+            timingFile << "report_step,section,calls,seconds\n";
+        }
+
+        // the machine readable timings of the report steps, written by the first process
+        const std::string performanceFileName = EWOMS_GET_PARAM(TypeTag, std::string, PerformanceReportFile);
+        PerformanceReport performanceReport(grid().comm().rank() == 0
+                                            ? EWOMS_GET_PARAM(TypeTag, std::string, PerformanceReportCsvFile)
+                                            : std::string());
+        SimulatorReport stepFailureReport;
+
+        // the balance of the processes over the last report steps
+        LoadImbalanceMonitor imbalanceMonitor(EWOMS_GET_PARAM(TypeTag, int, LoadImbalanceWindow),
+                                              EWOMS_GET_PARAM(TypeTag, double, LoadImbalanceThreshold));
+        const bool enableProcessStatistics = EWOMS_GET_PARAM(TypeTag, bool, EnableProcessTimingStatistics)
+            && grid().comm().size() > 1;
+        ProcessTimingStatistics processStatistics;
+        // the total times of the stages of this process for the performance report
+        std::array<double, ProcessTimingStatistics::NumStages> stageTimes;
+        stageTimes.fill(0.0);
+
+        // the timeline of the timed sections
+        const std::string traceFileName = EWOMS_GET_PARAM(TypeTag, std::string, TraceFile);
+        if (!traceFileName.empty()) {
+            TraceRecorder::instance().setEnabled(true);
+        }
+
         // Main simulation loop.
         while (!timer.done()) {
+            // the report step is only an event of the timeline, as its timings
+            // are reported within it
+            const auto reportStepStart = TraceRecorder::Clock::now();
+
             // Report timestep.
             if (terminalOutput_) {
                 std::ostringstream ss;
@@ -210,7 +289,7 @@ public:
                 perfTimer.start();
 
                 wellModel_().beginReportStep(timer.currentStepNum());
-                ebosSimulator_.problem().writeOutput(false);
+                writeOutput_();
 
                 report.output_write_time += perfTimer.stop();
             }
@@ -219,6 +298,26 @@ public:
             solverTimer.start();
 
             auto solver = createSolver(wellModel_());
+            // the residuals are global, hence only one process writes the trace
+            if (terminalOutput_ && !modelParam_.newton_trace_file_.empty()) {
+                if (!newtonTrace_) {
+                    newtonTrace_.reset(new NewtonTrace(modelParam_.newton_trace_file_,
+                                                       solver->model().componentNames()));
+                }
+                solver->model().setNewtonTrace(newtonTrace_.get());
+            }
+            // the hot spots are merged over the processes, hence all of them record
+            if (modelParam_.convergence_hot_spots_ > 0) {
+                if (!hotSpots_) {
+                    const int* cartDims = Opm::UgGridHelpers::cartDims(grid());
+                    hotSpots_.reset(new ConvergenceHotSpots(modelParam_.convergence_hot_spots_,
+                                                            solver->model().componentNames(),
+                                                            {{ cartDims[0], cartDims[1], cartDims[2] }}));
+                }
+                solver->model().setConvergenceHotSpots(hotSpots_.get());
+            }
+            // the wells and hence the matrix might change completely
+            linearSolver_.invalidatePreconditioner();
 
             solver->model().beginReportStep(firstRestartStep);
             firstRestartStep = false;
@@ -253,13 +352,15 @@ public:
                         events.hasEvent(ScheduleEvents::WELL_STATUS_CHANGE, timer.currentStepNum());
                 stepReport = adaptiveTimeStepping->step(timer, *solver, event, nullptr);
                 report += stepReport;
-                failureReport_ += adaptiveTimeStepping->failureReport();
+                stepFailureReport = adaptiveTimeStepping->failureReport();
+                failureReport_ += stepFailureReport;
             }
             else {
                 // solve for complete report step
                 stepReport = solver->step(timer);
                 report += stepReport;
-                failureReport_ += solver->failureReport();
+                stepFailureReport = solver->failureReport();
+                failureReport_ += stepFailureReport;
 
                 if (terminalOutput_) {
                     std::ostringstream ss;
@@ -270,13 +371,64 @@ public:
 
             solver->model().endReportStep();
 
+            if (grid().comm().size() > 1 && imbalanceMonitor.endReportStep(grid().comm(), stepReport)) {
+                if (terminalOutput_) {
+                    std::ostringstream ss;
+                    ss << std::fixed << std::setprecision(0)
+                       << "The load of the processes is imbalanced by "
+                       << 100.0 * imbalanceMonitor.totalImbalance() << "% over the last "
+                       << EWOMS_GET_PARAM(TypeTag, int, LoadImbalanceWindow) << " report steps (assembly "
+                       << 100.0 * imbalanceMonitor.imbalance(LoadImbalanceMonitor::Assembly) << "%, linear solve "
+                       << 100.0 * imbalanceMonitor.imbalance(LoadImbalanceMonitor::LinearSolve) << "%, update "
+                       << 100.0 * imbalanceMonitor.imbalance(LoadImbalanceMonitor::Update) << "%), "
+                       << "a repartition of the grid is recommended.";
+                    OpmLog::warning(ss.str());
+                }
+                imbalanceMonitor.reset();
+            }
+
+            const auto localStageTimes = ProcessTimingStatistics::localTimes(stepReport);
+            std::transform(stageTimes.begin(), stageTimes.end(), localStageTimes.begin(),
+                           stageTimes.begin(), std::plus<double>());
+
+            if (enableProcessStatistics) {
+                processStatistics.compute(grid().comm(), localStageTimes);
+                if (terminalOutput_) {
+                    std::ostringstream ss;
+                    ss << "Process timings for report step " << timer.currentStepNum()
+                       << " over " << grid().comm().size() << " processes:\n";
+                    processStatistics.report(ss);
+                    OpmLog::note(ss.str());
+                }
+            }
+
             // take time that was used to solve system for this reportStep
             solverTimer.stop();
 
             // update timing.
             report.solver_time += solverTimer.secsSinceStart();
 
+            // report the time spent in the stages of the linear solver
+            auto& timings = TimingRegistry::instance();
+            if (timings.enabled()) {
+                if (terminalOutput_) {
+                    std::ostringstream ss;
+                    ss << "Linear solver timings for report step " << timer.currentStepNum() << ":\n";
+                    timings.report(ss);
+                    OpmLog::note(ss.str());
+                    if (timingFile.is_open()) {
+                        timings.writeCsv(timingFile, timer.currentStepNum());
+                        timingFile.flush();
+                    }
+                }
+                timings.reset();
+            }
+
+            // move the log messages of the other processes to the log files
+            gatherLogMessages();
+
             // Increment timer, remember well state.
+            const int reportStep = timer.currentStepNum();
             ++timer;
 
 
@@ -292,8 +444,12 @@ public:
             perfTimer.start();
             const double nextstep = adaptiveTimeStepping ? adaptiveTimeStepping->suggestedNextStep() : -1.0;
             ebosSimulator_.problem().setNextTimeStepSize(nextstep);
-            ebosSimulator_.problem().writeOutput(false);
-            report.output_write_time += perfTimer.stop();
+            writeOutput_();
+            stepReport.output_write_time = perfTimer.stop();
+            report.output_write_time += stepReport.output_write_time;
+
+            stepReport.solver_time = solverTimer.secsSinceStart();
+            performanceReport.addReportStep(reportStep, stepReport, stepFailureReport);
 
             if (terminalOutput_) {
                 std::string msg =
@@ -302,6 +458,10 @@ public:
                 OpmLog::debug(msg);
             }
 
+            if (TraceRecorder::instance().enabled()) {
+                static const std::string reportStepName = "report_step";
+                TraceRecorder::instance().record(reportStepName, reportStepStart, TraceRecorder::Clock::now());
+            }
         }
 
         // Stop timer and create timing report
@@ -309,6 +469,60 @@ public:
         report.total_time = totalTimer.secsSinceStart();
         report.converged = true;
 
+        const bool memoryReport = EWOMS_GET_PARAM(TypeTag, bool, EnableMemoryReport);
+        if (!performanceFileName.empty() || memoryReport) {
+            const auto& comm = grid().comm();
+            const auto gatherPerProcess = [&comm](double value) {
+                std::vector<double> perProcess(comm.size(), value);
+                comm.gather(&value, perProcess.data(), 1, 0);
+                return perProcess;
+            };
+            const std::vector<double> peakMemoryPerProcess = gatherPerProcess(PerformanceReport::peakResidentSetSize());
+            std::vector<PerformanceReport::SubsystemMemory> subsystemMemory;
+            if (memoryReport) {
+                for (const std::string label : { "jacobian", "jacobian.preconditioner_copy", "jacobian.compressed_copy",
+                                                 "ilu.factors", "wells.matrices", "wells.state", "aquifers" }) {
+                    const double peak = MemoryRegistry::instance().entry(label).peak.load();
+                    subsystemMemory.emplace_back(label, gatherPerProcess(peak));
+                }
+            }
+            comm.max(stageTimes.data(), stageTimes.size());
+            if (comm.rank() == 0) {
+                performanceReport.setStageTimes({ { "assembly", stageTimes[ProcessTimingStatistics::Assembly] },
+                                                  { "wells", stageTimes[ProcessTimingStatistics::Wells] },
+                                                  { "linear_solve", stageTimes[ProcessTimingStatistics::LinearSolve] },
+                                                  { "communication", stageTimes[ProcessTimingStatistics::CommunicationWait] } });
+                if (memoryReport && terminalOutput_) {
+                    std::ostringstream ss;
+                    ss << "Peak memory of the subsystems over " << comm.size() << " processes:\n"
+                       << std::left << std::setw(30) << "Subsystem" << std::right
+                       << std::setw(14) << "Max (MB)" << std::setw(14) << "Total (MB)" << "\n";
+                    subsystemMemory.emplace_back("process.resident_set", peakMemoryPerProcess);
+                    for (const auto& subsystem : subsystemMemory) {
+                        const auto& perProcess = subsystem.second;
+                        ss << std::left << std::setw(30) << subsystem.first << std::right << std::fixed << std::setprecision(1)
+                           << std::setw(14) << *std::max_element(perProcess.begin(), perProcess.end()) / 1048576.0
+                           << std::setw(14) << std::accumulate(perProcess.begin(), perProcess.end(), 0.0) / 1048576.0 << "\n";
+                    }
+                    subsystemMemory.pop_back();
+                    OpmLog::note(ss.str());
+                }
+                if (!performanceFileName.empty()) {
+                    performanceReport.setCalibrationTime(PerformanceReport::calibrationTime());
+                    std::ofstream performanceFile(performanceFileName);
+                    performanceReport.writeJson(performanceFile, peakMemoryPerProcess, subsystemMemory);
+                }
+            }
+        }
+
+        if (!traceFileName.empty()) {
+            writeTrace_(traceFileName);
+        }
+
+        if (hotSpots_ && terminalOutput_) {
+            OpmLog::note(hotSpots_->summary());
+        }
+
         return report;
     }
 
@@ -333,6 +547,42 @@ protected:
         return std::unique_ptr<Solver>(new Solver(solverParam_, std::move(model)));
     }
 
+    // gather the timelines of all processes and write them to one file
+    void writeTrace_(const std::string& fileName) const
+    {
+        auto& recorder = TraceRecorder::instance();
+        recorder.setEnabled(false);
+        const auto& comm = grid().comm();
+        std::string local = recorder.events(comm.rank());
+        int localSize = local.size();
+        std::vector<int> sizes(comm.size(), localSize);
+        comm.gather(&localSize, sizes.data(), 1, 0);
+        std::vector<int> displ(comm.size() + 1, 0);
+        std::partial_sum(sizes.begin(), sizes.end(), displ.begin() + 1);
+        std::vector<char> all(displ.back());
+        comm.gatherv(&local[0], localSize, all.data(), sizes.data(), displ.data(), 0);
+        if (comm.rank() == 0) {
+            std::vector<std::string> processEvents;
+            for (int p = 0; p < comm.size(); ++p) {
+                processEvents.emplace_back(all.begin() + displ[p], all.begin() + displ[p + 1]);
+            }
+            std::ofstream traceFile(fileName);
+            TraceRecorder::writeTrace(traceFile, processEvents);
+        }
+        const auto dropped = comm.sum(recorder.dropped());
+        if (dropped > 0 && terminalOutput_) {
+            OpmLog::warning(std::to_string(dropped) + " events of the timeline were dropped since their buffers were full");
+        }
+    }
+
+    // write the output of ebos at the end of a report step
+    void writeOutput_()
+    {
+        static auto& timing = TimingRegistry::instance().entry("output.write");
+        ScopedTiming scopedTiming(timing);
+        ebosSimulator_.problem().writeOutput(false);
+    }
+
     void outputTimestampFIP(const SimulatorTimer& timer, const std::string version)
     {
         std::ostringstream ss;
@@ -379,6 +629,10 @@ protected:
     PhaseUsage phaseUsage_;
     // Misc. data
     bool terminalOutput_;
+    // the trace of the Newton iterations of all report steps (NewtonTraceFile)
+    std::unique_ptr<NewtonTrace> newtonTrace_;
+    // the cells and wells of the Newton iterations which did not converge (ConvergenceHotSpots)
+    std::unique_ptr<ConvergenceHotSpots> hotSpots_;
 };
 
 } // namespace Opm
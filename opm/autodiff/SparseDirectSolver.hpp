@@ -0,0 +1,271 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_SPARSEDIRECTSOLVER_HEADER_INCLUDED
+#define OPM_SPARSEDIRECTSOLVER_HEADER_INCLUDED
+
+#if HAVE_UMFPACK
+
+#include <opm/autodiff/TimingRegistry.hpp>
+#include <opm/common/ErrorMacros.hpp>
+#include <opm/common/Exceptions.hpp>
+
+#include <opm/common/utility/platform_dependent/disable_warnings.h>
+#include <dune/common/unused.hh>
+#include <dune/common/version.hh>
+#include <dune/istl/preconditioner.hh>
+#include <dune/istl/solvercategory.hh>
+#include <dune/istl/umfpack.hh>
+#include <opm/common/utility/platform_dependent/reenable_warnings.h>
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace Opm
+{
+
+/// \brief Sparse LU factorization with UMFPack that keeps the symbolic
+///        factorization between matrices with the same sparsity pattern.
+///
+/// Dune::UMFPack does the symbolic analysis (ordering) for every matrix.
+/// For the Newton iterations of small models the pattern of the Jacobian
+/// does not change, hence this class only redoes the numeric factorization
+/// in update(). It can be used as the preconditioner of a Krylov solver,
+/// which then converges in one iteration if the operator is the matrix.
+///
+/// The rows of the BCRSMatrix are passed as the columns of the transposed
+/// matrix, which avoids a transposition, and the systems are solved with
+/// the transposed factorization.
+/// \tparam Matrix The type of the (sequential) matrix.
+/// \tparam X The type of the domain and the range.
+template<class Matrix, class X>
+class SparseDirectSolver
+    : public Dune::Preconditioner<X,X>
+{
+public:
+    typedef X domain_type;
+    typedef X range_type;
+    typedef typename X::field_type field_type;
+    static const int blockSize = Matrix::block_type::rows;
+
+#if DUNE_VERSION_NEWER(DUNE_ISTL, 2, 6)
+    Dune::SolverCategory::Category category() const override
+    {
+        return Dune::SolverCategory::sequential;
+    }
+#else
+    enum {
+        //! \brief The category the preconditioner is part of.
+        category = Dune::SolverCategory::sequential
+    };
+#endif
+
+    SparseDirectSolver()
+        : symbolic_(nullptr), numeric_(nullptr), symbolicSetups_(0)
+    {
+        umfpack_di_defaults(control_);
+    }
+
+    ~SparseDirectSolver()
+    {
+        freeFactorization();
+    }
+
+    SparseDirectSolver(const SparseDirectSolver&) = delete;
+    SparseDirectSolver& operator=(const SparseDirectSolver&) = delete;
+
+    /// \brief Factorize a matrix.
+    ///
+    /// The symbolic factorization of the previous matrix is reused if the
+    /// sparsity pattern is the same.
+    void update(const Matrix& A)
+    {
+        const bool samePattern = symbolic_ && copyPattern(A);
+        if ( !samePattern )
+        {
+            static auto& timing = TimingRegistry::instance().entry("direct.symbolic");
+            ScopedTiming scopedTiming(timing);
+
+            freeFactorization();
+            copyPattern(A);
+            copyValues(A);
+            check(umfpack_di_symbolic(size_, size_, start_.data(), index_.data(), values_.data(),
+                                      &symbolic_, control_, info_), "symbolic");
+            ++symbolicSetups_;
+        }
+        else
+        {
+            copyValues(A);
+        }
+
+        static auto& timing = TimingRegistry::instance().entry("direct.numeric");
+        ScopedTiming scopedTiming(timing);
+        if ( numeric_ )
+        {
+            umfpack_di_free_numeric(&numeric_);
+        }
+        check(umfpack_di_numeric(start_.data(), index_.data(), values_.data(), symbolic_,
+                                 &numeric_, control_, info_), "numeric");
+    }
+
+    virtual void pre (X& x, X& b)
+    {
+        DUNE_UNUSED_PARAMETER(x);
+        DUNE_UNUSED_PARAMETER(b);
+    }
+
+    /// \brief Solve A v = d.
+    virtual void apply (X& v, const X& d)
+    {
+        static auto& timing = TimingRegistry::instance().entry("direct.solve");
+        ScopedTiming scopedTiming(timing);
+
+        rhs_.resize(size_);
+        solution_.resize(size_);
+        for ( std::size_t i = 0; i < d.size(); ++i )
+        {
+            for ( int k = 0; k < blockSize; ++k )
+            {
+                rhs_[i * blockSize + k] = d[i][k];
+            }
+        }
+        // The CSC matrix passed to UMFPack is the transpose of A.
+        check(umfpack_di_solve(UMFPACK_At, start_.data(), index_.data(), values_.data(),
+                               solution_.data(), rhs_.data(), numeric_, control_, info_), "solve");
+        for ( std::size_t i = 0; i < v.size(); ++i )
+        {
+            for ( int k = 0; k < blockSize; ++k )
+            {
+                v[i][k] = solution_[i * blockSize + k];
+            }
+        }
+    }
+
+    virtual void post (X& x)
+    {
+        DUNE_UNUSED_PARAMETER(x);
+    }
+
+    /// \brief The number of symbolic factorizations done so far.
+    int symbolicSetups() const
+    {
+        return symbolicSetups_;
+    }
+
+private:
+    /// \brief Store the scalar pattern of A.
+    /// \return Whether it is the same as the stored one.
+    bool copyPattern(const Matrix& A)
+    {
+        if ( A.nonzeroes() * blockSize * blockSize > static_cast<std::size_t>(std::numeric_limits<int>::max()) )
+        {
+            OPM_THROW(std::logic_error, "The matrix is too large for the direct solver");
+        }
+        const int size = A.N() * blockSize;
+        bool same = size == size_ && index_.size() == A.nonzeroes() * blockSize * blockSize;
+        if ( !same )
+        {
+            size_ = size;
+            start_.assign(size + 1, 0);
+            index_.resize(A.nonzeroes() * blockSize * blockSize);
+        }
+        int pos = 0;
+        for ( auto row = A.begin(), rowEnd = A.end(); row != rowEnd; ++row )
+        {
+            for ( int k = 0; k < blockSize; ++k )
+            {
+                start_[row.index() * blockSize + k] = pos;
+                for ( auto col = row->begin(), colEnd = row->end(); col != colEnd; ++col )
+                {
+                    for ( int l = 0; l < blockSize; ++l, ++pos )
+                    {
+                        const int index = col.index() * blockSize + l;
+                        same = same && index_[pos] == index;
+                        index_[pos] = index;
+                    }
+                }
+            }
+        }
+        start_[size] = pos;
+        return same;
+    }
+
+    void copyValues(const Matrix& A)
+    {
+        values_.resize(index_.size());
+        std::size_t pos = 0;
+        for ( auto row = A.begin(), rowEnd = A.end(); row != rowEnd; ++row )
+        {
+            for ( int k = 0; k < blockSize; ++k )
+            {
+                for ( auto col = row->begin(), colEnd = row->end(); col != colEnd; ++col )
+                {
+                    for ( int l = 0; l < blockSize; ++l )
+                    {
+                        values_[pos++] = (*col)[k][l];
+                    }
+                }
+            }
+        }
+    }
+
+    void check(int status, const char* phase)
+    {
+        if ( status != UMFPACK_OK )
+        {
+            // force a new setup on the next update
+            freeFactorization();
+            OPM_THROW(LinearSolverProblem, "UMFPack " << phase << " factorization failed with status " << status);
+        }
+    }
+
+    void freeFactorization()
+    {
+        if ( numeric_ )
+        {
+            umfpack_di_free_numeric(&numeric_);
+        }
+        if ( symbolic_ )
+        {
+            umfpack_di_free_symbolic(&symbolic_);
+        }
+        numeric_ = nullptr;
+        symbolic_ = nullptr;
+    }
+
+    void* symbolic_;
+    void* numeric_;
+    int symbolicSetups_;
+    int size_ = 0;
+    //! \brief The scalar matrix in compressed column format (of the transpose).
+    std::vector<int> start_;
+    std::vector<int> index_;
+    std::vector<double> values_;
+    std::vector<double> rhs_;
+    std::vector<double> solution_;
+    double control_[UMFPACK_CONTROL];
+    double info_[UMFPACK_INFO];
+};
+
+} // end namespace Opm
+
+#endif // HAVE_UMFPACK
+
+#endif // OPM_SPARSEDIRECTSOLVER_HEADER_INCLUDED
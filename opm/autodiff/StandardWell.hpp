@@ -27,12 +27,15 @@
 #include <opm/autodiff/WellInterface.hpp>
 #include <opm/autodiff/ISTLSolverEbos.hpp>
 #include <opm/autodiff/RateConverter.hpp>
+#include <opm/autodiff/PaddedEvaluation.hpp>
+
+#include <array>
 
 namespace Opm
 {
 
     template<typename TypeTag>
-    class StandardWell: public WellInterface<TypeTag>
+    class StandardWell final : public WellInterface<TypeTag>
     {
 
     public:
@@ -56,6 +59,7 @@ namespace Opm
         using Base::has_solvent;
         using Base::has_polymer;
         using Base::has_energy;
+        using Base::phaseIsActive;
 
         // polymer concentration and temperature are already known by the well, so
         // polymer and energy conservation do not need to be considered explicitly
@@ -121,7 +125,12 @@ namespace Opm
         typedef Dune::FieldMatrix<Scalar, numWellEq, numEq>  OffDiagMatrixBlockWellType;
         typedef Dune::BCRSMatrix<OffDiagMatrixBlockWellType> OffDiagMatWell;
 
+#if USE_PADDED_WELL_EVALUATION
+        // the derivatives padded to whole SIMD registers
+        typedef PaddedAd::Evaluation<double, /*size=*/numEq + numWellEq> EvalWell;
+#else
         typedef DenseAd::Evaluation<double, /*size=*/numEq + numWellEq> EvalWell;
+#endif
 
         using Base::contiSolventEqIdx;
         using Base::contiPolymerEqIdx;
@@ -156,6 +165,12 @@ namespace Opm
         /// r = r - C D^-1 Rw
         virtual void apply(BVector& r) const override;
 
+        /// add B, C and D^-1 of this well to the packed contributions of all
+        /// standard wells. Afterwards apply(x, Ax) of the packed contributions
+        /// replaces the one of this well.
+        template <class PackedWells>
+        void addToPackedWells(PackedWells& packed_wells) const;
+
         /// using the solution x to recover the solution xw for wells and applying
         /// xw to update Well State
         virtual void recoverWellSolutionAndUpdateWellState(const BVector& x,
@@ -181,6 +196,11 @@ namespace Opm
             return param_.matrix_add_well_contributions_;
         }
 
+        virtual std::size_t wellMatrixMemory() const override
+        {
+            return Opm::matrixMemoryBytes(duneB_) + Opm::matrixMemoryBytes(duneC_) + Opm::matrixMemoryBytes(invDuneD_);
+        }
+
     protected:
 
         // protected functions from the Base class
@@ -214,6 +234,7 @@ namespace Opm
         using Base::index_of_well_;
         using Base::well_controls_;
         using Base::well_type_;
+        using Base::deferred_logger_;
         using Base::num_components_;
         using Base::connectionRates_;
 
@@ -225,6 +246,8 @@ namespace Opm
         std::vector<double> perf_densities_;
         // pressure drop between different perforations
         std::vector<double> perf_pressure_diffs_;
+        // the inputs of the last computation of perf_densities_ and perf_pressure_diffs_
+        std::vector<double> connection_pressure_inputs_;
 
         // residuals of the well equations
         BVectorWell resWell_;
@@ -256,6 +279,13 @@ namespace Opm
         mutable std::vector<double> ipr_a_;
         mutable std::vector<double> ipr_b_;
 
+        // scratch space for the surface volume fractions, and the mobilities and
+        // rates of a perforation, sized once such that the loops over the
+        // perforations do not allocate
+        mutable std::vector<EvalWell> scratch_cmix_s_;
+        mutable std::vector<EvalWell> scratch_mob_;
+        mutable std::vector<EvalWell> scratch_cq_s_;
+
         const EvalWell& getBhp() const;
 
         EvalWell getQs(const int comp_idx) const;
@@ -268,8 +298,32 @@ namespace Opm
 
         EvalWell wellSurfaceVolumeFraction(const int phase) const;
 
+        // the surface volume fractions of all the components, computed with one sum,
+        // fractions needs to have num_components_ entries
+        void wellSurfaceVolumeFractions(std::vector<EvalWell>& fractions) const;
+
         EvalWell extendEval(const Eval& in) const;
 
+        // the energy flux of a perforation from its surface rates cq_s, either
+        // with the derivatives (EvalWell) or as an explicit source term (Scalar)
+        template <class RateVector>
+        typename RateVector::value_type
+        computeConnectionEnergyRate(const Simulator& ebosSimulator,
+                                    const IntensiveQuantities& intQuants,
+                                    const RateVector& cq_s,
+                                    const int cell_idx) const;
+
+        // the reservoir quantities in the type of the energy flux
+        EvalWell energyValue(const Eval& in, const EvalWell& /* type */) const
+        {
+            return extendEval(in);
+        }
+
+        static Scalar energyValue(const Eval& in, const Scalar& /* type */)
+        {
+            return in.value();
+        }
+
         // xw = inv(D)*(rw - C*x)
         void recoverSolutionWell(const BVector& x, BVectorWell& xw) const;
 
@@ -308,9 +362,16 @@ namespace Opm
         void computeWellConnectionPressures(const Simulator& ebosSimulator,
                                                     const WellState& well_state);
 
+        // the quantities computeWellConnectionPressures() depends on
+        std::vector<double> connectionPressureInputs(const Simulator& ebosSimulator,
+                                                     const WellState& well_state) const;
+
+        // cmix_s are the surface volume fractions of the well, which are the
+        // same for all the perforations (see wellSurfaceVolumeFractions())
         void computePerfRate(const IntensiveQuantities& intQuants,
                              const std::vector<EvalWell>& mob,
                              const EvalWell& bhp,
+                             const std::vector<EvalWell>& cmix_s,
                              const int perf,
                              const bool allow_cf,
                              std::vector<EvalWell>& cq_s,
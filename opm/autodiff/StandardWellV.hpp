@@ -25,6 +25,7 @@
 
 
 #include <opm/autodiff/WellInterface.hpp>
+#include <opm/autodiff/CondensedWellSystem.hpp>
 #include <opm/autodiff/ISTLSolverEbos.hpp>
 #include <opm/autodiff/RateConverter.hpp>
 
@@ -32,12 +33,13 @@
 
 #include <dune/common/dynvector.hh>
 #include <dune/common/dynmatrix.hh>
+#include <dune/common/fvector.hh>
 
 namespace Opm
 {
 
     template<typename TypeTag>
-    class StandardWellV: public WellInterface<TypeTag>
+    class StandardWellV final : public WellInterface<TypeTag>
     {
 
     public:
@@ -61,6 +63,7 @@ namespace Opm
         using Base::has_solvent;
         using Base::has_polymer;
         using Base::has_energy;
+        using Base::phaseIsActive;
 
         // polymer concentration and temperature are already known by the well, so
         // polymer and energy conservation do not need to be considered explicitly
@@ -182,6 +185,11 @@ namespace Opm
             return param_.matrix_add_well_contributions_;
         }
 
+        virtual std::size_t wellMatrixMemory() const override
+        {
+            return Opm::matrixMemoryBytes(duneB_) + Opm::matrixMemoryBytes(duneC_) + Opm::matrixMemoryBytes(invDuneD_);
+        }
+
     protected:
 
         // protected functions from the Base class
@@ -215,6 +223,7 @@ namespace Opm
         using Base::index_of_well_;
         using Base::well_controls_;
         using Base::well_type_;
+        using Base::deferred_logger_;
         using Base::num_components_;
         using Base::connectionRates_;
 
@@ -244,6 +253,15 @@ namespace Opm
         mutable BVectorWell Bx_;
         mutable BVectorWell invDrw_;
 
+        // The rows of D^-1 B and C of each perforated cell in contiguous arrays,
+        // used by apply(x, Ax). Only the number of well equations is dynamic,
+        // the rows have the compile time size numEq of the reservoir blocks.
+        typedef Dune::FieldVector<Scalar, numEq> ReservoirRow;
+        std::vector<int> packed_cells_;
+        std::vector<ReservoirRow> packed_invDB_;
+        std::vector<ReservoirRow> packed_C_;
+        mutable std::vector<Scalar> packed_invDBx_;
+
         // the values for the primary varibles
         // based on different solutioin strategies, the wells can have different primary variables
         mutable std::vector<double> primary_variables_;
@@ -275,6 +293,26 @@ namespace Opm
 
         EvalWell extendEval(const Eval& in) const;
 
+        // the energy flux of a perforation from its surface rates cq_s, either
+        // with the derivatives (EvalWell) or as an explicit source term (Scalar)
+        template <class RateVector>
+        typename RateVector::value_type
+        computeConnectionEnergyRate(const Simulator& ebosSimulator,
+                                    const IntensiveQuantities& intQuants,
+                                    const RateVector& cq_s,
+                                    const int cell_idx) const;
+
+        // the reservoir quantities in the type of the energy flux
+        EvalWell energyValue(const Eval& in, const EvalWell& /* type */) const
+        {
+            return extendEval(in);
+        }
+
+        static Scalar energyValue(const Eval& in, const Scalar& /* type */)
+        {
+            return in.value();
+        }
+
         // xw = inv(D)*(rw - C*x)
         void recoverSolutionWell(const BVector& x, BVectorWell& xw) const;
 
@@ -355,6 +393,9 @@ namespace Opm
 
         void assembleControlEq();
 
+        // gather D^-1 B and C into the packed arrays used by apply(x, Ax)
+        void packApplyOperator();
+
         // handle the non reasonable fractions due to numerical overshoot
         void processFractions() const;
 
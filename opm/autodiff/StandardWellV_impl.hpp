@@ -236,11 +236,11 @@ namespace Opm
     StandardWellV<TypeTag>::
     wellVolumeFraction(const unsigned compIdx) const
     {
-        if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx) && compIdx == Indices::canonicalToActiveComponentIndex(FluidSystem::waterCompIdx)) {
+        if (phaseIsActive(FluidSystem::waterPhaseIdx) && compIdx == Indices::canonicalToActiveComponentIndex(FluidSystem::waterCompIdx)) {
             return primary_variables_evaluation_[WFrac];
         }
 
-        if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx) && compIdx == Indices::canonicalToActiveComponentIndex(FluidSystem::gasCompIdx)) {
+        if (phaseIsActive(FluidSystem::gasPhaseIdx) && compIdx == Indices::canonicalToActiveComponentIndex(FluidSystem::gasCompIdx)) {
             return primary_variables_evaluation_[GFrac];
         }
 
@@ -250,11 +250,11 @@ namespace Opm
 
         // Oil fraction
         EvalWell well_fraction(numWellEq_ + numEq, 1.0);
-        if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+        if (phaseIsActive(FluidSystem::waterPhaseIdx)) {
             well_fraction -= primary_variables_evaluation_[WFrac];
         }
 
-        if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+        if (phaseIsActive(FluidSystem::gasPhaseIdx)) {
             well_fraction -= primary_variables_evaluation_[GFrac];
         }
         if (has_solvent) {
@@ -287,6 +287,79 @@ namespace Opm
 
 
 
+    template<typename TypeTag>
+    template<class RateVector>
+    typename RateVector::value_type
+    StandardWellV<TypeTag>::
+    computeConnectionEnergyRate(const Simulator& ebosSimulator,
+                                const IntensiveQuantities& intQuants,
+                                const RateVector& cq_s,
+                                const int cell_idx) const
+    {
+        typedef typename RateVector::value_type Value;
+
+        auto fs = intQuants.fluidState();
+        const int reportStepIdx = ebosSimulator.episodeIndex();
+        Value energy_rate = cq_s[0] * 0.0;
+
+        for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx) {
+            if (!phaseIsActive(phaseIdx)) {
+                continue;
+            }
+
+            const unsigned activeCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::solventComponentIndex(phaseIdx));
+            // convert to reservoar conditions
+            Value cq_r_thermal = cq_s[activeCompIdx] * 0.0;
+            if (phaseIsActive(FluidSystem::oilPhaseIdx) && phaseIsActive(FluidSystem::gasPhaseIdx)) {
+
+                if(FluidSystem::waterPhaseIdx == phaseIdx)
+                     cq_r_thermal = cq_s[activeCompIdx] / energyValue(fs.invB(phaseIdx), cq_s[0]);
+
+                // remove dissolved gas and vapporized oil
+                const unsigned oilCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::oilCompIdx);
+                const unsigned gasCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::gasCompIdx);
+                // q_os = q_or * b_o + rv * q_gr * b_g
+                // q_gs = q_gr * g_g + rs * q_or * b_o
+                // d = 1.0 - rs * rv
+                const Value d = energyValue(1.0 - fs.Rv() * fs.Rs(), cq_s[0]);
+                // q_gr = 1 / (b_g * d) * (q_gs - rs * q_os)
+                if(FluidSystem::gasPhaseIdx == phaseIdx)
+                    cq_r_thermal = (cq_s[gasCompIdx] - energyValue(fs.Rs(), cq_s[0]) * cq_s[oilCompIdx]) / (d * energyValue(fs.invB(phaseIdx), cq_s[0]) );
+                // q_or = 1 / (b_o * d) * (q_os - rv * q_gs)
+                if(FluidSystem::oilPhaseIdx == phaseIdx)
+                    cq_r_thermal = (cq_s[oilCompIdx] - energyValue(fs.Rv(), cq_s[0]) * cq_s[gasCompIdx]) / (d * energyValue(fs.invB(phaseIdx), cq_s[0]) );
+
+            } else {
+                cq_r_thermal = cq_s[activeCompIdx] / energyValue(fs.invB(phaseIdx), cq_s[0]);
+            }
+
+            // change temperature for injecting fluids
+            if (well_type_ == INJECTOR && cq_s[activeCompIdx] > 0.0){
+                const auto& injProps = this->well_ecl_->getInjectionProperties(reportStepIdx);
+                fs.setTemperature(injProps.temperature);
+                typedef typename std::decay<decltype(fs)>::type::Scalar FsScalar;
+                typename FluidSystem::template ParameterCache<FsScalar> paramCache;
+                const unsigned pvtRegionIdx = intQuants.pvtRegionIndex();
+                paramCache.setRegionIndex(pvtRegionIdx);
+                paramCache.setMaxOilSat(ebosSimulator.problem().maxOilSaturation(cell_idx));
+                paramCache.updatePhase(fs, phaseIdx);
+
+                const auto& rho = FluidSystem::density(fs, paramCache, phaseIdx);
+                fs.setDensity(phaseIdx, rho);
+                const auto& h = FluidSystem::enthalpy(fs, paramCache, phaseIdx);
+                fs.setEnthalpy(phaseIdx, h);
+            }
+            // compute the thermal flux
+            cq_r_thermal *= energyValue(fs.enthalpy(phaseIdx), cq_s[0]) * energyValue(fs.density(phaseIdx), cq_s[0]);
+            energy_rate += cq_r_thermal;
+        }
+        return energy_rate;
+    }
+
+
+
+
+
     template<typename TypeTag>
     typename StandardWellV<TypeTag>::EvalWell
     StandardWellV<TypeTag>::
@@ -322,7 +395,7 @@ namespace Opm
         const EvalWell rv = extendEval(fs.Rv());
         std::vector<EvalWell> b_perfcells_dense(num_components_, EvalWell{numWellEq_ + numEq, 0.0});
         for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx) {
-            if (!FluidSystem::phaseIsActive(phaseIdx)) {
+            if (!phaseIsActive(phaseIdx)) {
                 continue;
             }
 
@@ -357,7 +430,7 @@ namespace Opm
                 cq_s[componentIdx] = b_perfcells_dense[componentIdx] * cq_p;
             }
 
-            if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx) && FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+            if (phaseIsActive(FluidSystem::oilPhaseIdx) && phaseIsActive(FluidSystem::gasPhaseIdx)) {
                 const unsigned oilCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::oilCompIdx);
                 const unsigned gasCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::gasCompIdx);
                 const EvalWell cq_sOil = cq_s[oilCompIdx];
@@ -399,7 +472,7 @@ namespace Opm
 
             // compute volume ratio between connection at standard conditions
             EvalWell volumeRatio(numWellEq_ + numEq, 0.);
-            if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+            if (phaseIsActive(FluidSystem::waterPhaseIdx)) {
                 const unsigned waterCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::waterCompIdx);
                 volumeRatio += cmix_s[waterCompIdx] / b_perfcells_dense[waterCompIdx];
             }
@@ -408,7 +481,7 @@ namespace Opm
                 volumeRatio += cmix_s[contiSolventEqIdx] / b_perfcells_dense[contiSolventEqIdx];
             }
 
-            if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx) && FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+            if (phaseIsActive(FluidSystem::oilPhaseIdx) && phaseIsActive(FluidSystem::gasPhaseIdx)) {
                 const unsigned oilCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::oilCompIdx);
                 const unsigned gasCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::gasCompIdx);
                 // Incorporate RS/RV factors if both oil and gas active
@@ -428,11 +501,11 @@ namespace Opm
                 volumeRatio += tmp_gas / b_perfcells_dense[gasCompIdx];
             }
             else {
-                if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx)) {
+                if (phaseIsActive(FluidSystem::oilPhaseIdx)) {
                     const unsigned oilCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::oilCompIdx);
                     volumeRatio += cmix_s[oilCompIdx] / b_perfcells_dense[oilCompIdx];
                 }
-                if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+                if (phaseIsActive(FluidSystem::gasPhaseIdx)) {
                     const unsigned gasCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::gasCompIdx);
                     volumeRatio += cmix_s[gasCompIdx] / b_perfcells_dense[gasCompIdx];
                 }
@@ -447,7 +520,7 @@ namespace Opm
 
             // calculating the perforation solution gas rate and solution oil rates
             if (well_type_ == PRODUCER) {
-                if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx) && FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+                if (phaseIsActive(FluidSystem::oilPhaseIdx) && phaseIsActive(FluidSystem::gasPhaseIdx)) {
                     const unsigned oilCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::oilCompIdx);
                     const unsigned gasCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::gasCompIdx);
                     // TODO: the formulations here remain to be tested with cases with strong crossflow through production wells
@@ -533,10 +606,6 @@ namespace Opm
                 well_state.wellVaporizedOilRates()[index_of_well_] += perf_vap_oil_rate;
             }
 
-            if (has_energy) {
-                connectionRates_[perf][contiEnergyEqIdx] = 0.0;
-            }
-
             for (int componentIdx = 0; componentIdx < num_components_; ++componentIdx) {
                 // the cq_s entering mass balance equations need to consider the efficiency factors.
                 const EvalWell cq_s_effective = cq_s[componentIdx] * well_efficiency_factor_;
@@ -565,60 +634,15 @@ namespace Opm
                 }
             }
             if (has_energy) {
-
-                auto fs = intQuants.fluidState();
-                const int reportStepIdx = ebosSimulator.episodeIndex();
-
-                for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx) {
-                    if (!FluidSystem::phaseIsActive(phaseIdx)) {
-                        continue;
+                if (param_.explicit_well_energy_flux_) {
+                    // only the values of the rates are used, the flux has no derivatives
+                    std::array<Scalar, numEq> cq_s_value{};
+                    for (int componentIdx = 0; componentIdx < num_components_; ++componentIdx) {
+                        cq_s_value[componentIdx] = cq_s[componentIdx].value();
                     }
-
-                    const unsigned activeCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::solventComponentIndex(phaseIdx));
-                    // convert to reservoar conditions
-                    EvalWell cq_r_thermal(numWellEq_ + numEq, 0.);
-                    if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx) && FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
-
-                        if(FluidSystem::waterPhaseIdx == phaseIdx)
-                             cq_r_thermal = cq_s[activeCompIdx] / extendEval(fs.invB(phaseIdx));
-
-                        // remove dissolved gas and vapporized oil
-                        const unsigned oilCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::oilCompIdx);
-                        const unsigned gasCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::gasCompIdx);
-                        // q_os = q_or * b_o + rv * q_gr * b_g
-                        // q_gs = q_gr * g_g + rs * q_or * b_o
-                        // d = 1.0 - rs * rv
-                        const EvalWell d = extendEval(1.0 - fs.Rv() * fs.Rs());
-                        // q_gr = 1 / (b_g * d) * (q_gs - rs * q_os)
-                        if(FluidSystem::gasPhaseIdx == phaseIdx)
-                            cq_r_thermal = (cq_s[gasCompIdx] - extendEval(fs.Rs()) * cq_s[oilCompIdx]) / (d * extendEval(fs.invB(phaseIdx)) );
-                        // q_or = 1 / (b_o * d) * (q_os - rv * q_gs)
-                        if(FluidSystem::oilPhaseIdx == phaseIdx)
-                            cq_r_thermal = (cq_s[oilCompIdx] - extendEval(fs.Rv()) * cq_s[gasCompIdx]) / (d * extendEval(fs.invB(phaseIdx)) );
-
-                    } else {
-                        cq_r_thermal = cq_s[activeCompIdx] / extendEval(fs.invB(phaseIdx));
-                    }
-
-                    // change temperature for injecting fluids
-                    if (well_type_ == INJECTOR && cq_s[activeCompIdx] > 0.0){
-                        const auto& injProps = this->well_ecl_->getInjectionProperties(reportStepIdx);
-                        fs.setTemperature(injProps.temperature);
-                        typedef typename std::decay<decltype(fs)>::type::Scalar FsScalar;
-                        typename FluidSystem::template ParameterCache<FsScalar> paramCache;
-                        const unsigned pvtRegionIdx = intQuants.pvtRegionIndex();
-                        paramCache.setRegionIndex(pvtRegionIdx);
-                        paramCache.setMaxOilSat(ebosSimulator.problem().maxOilSaturation(cell_idx));
-                        paramCache.updatePhase(fs, phaseIdx);
-
-                        const auto& rho = FluidSystem::density(fs, paramCache, phaseIdx);
-                        fs.setDensity(phaseIdx, rho);
-                        const auto& h = FluidSystem::enthalpy(fs, paramCache, phaseIdx);
-                        fs.setEnthalpy(phaseIdx, h);
-                    }
-                    // compute the thermal flux
-                    cq_r_thermal *= extendEval(fs.enthalpy(phaseIdx)) * extendEval(fs.density(phaseIdx));
-                    connectionRates_[perf][contiEnergyEqIdx] += Base::restrictEval(cq_r_thermal);
+                    connectionRates_[perf][contiEnergyEqIdx] = computeConnectionEnergyRate(ebosSimulator, intQuants, cq_s_value, cell_idx);
+                } else {
+                    connectionRates_[perf][contiEnergyEqIdx] = Base::restrictEval(computeConnectionEnergyRate(ebosSimulator, intQuants, cq_s, cell_idx));
                 }
             }
 
@@ -695,16 +719,22 @@ namespace Opm
 
         assembleControlEq();
 
-        // do the local inversion of D.
+        // do the local inversion of D. With the per perforation variables of the polymer
+        // injectivity, these are eliminated perforation by perforation first.
         try
         {
-            Dune::ISTLUtility::invertMatrix(invDuneD_[0][0]);
+            const bool condensed = this->has_polymermw && well_type_ == INJECTOR
+                && wellhelpers::invertCondensed(invDuneD_[0][0], numStaticWellEq, number_of_perforations_, 2);
+            if (!condensed) {
+                Dune::ISTLUtility::invertMatrix(invDuneD_[0][0]);
+            }
         }
         catch( ... )
         {
             OPM_THROW(Opm::NumericalIssue,"Error when inverting local well equations for well " + name());
         }
 
+        packApplyOperator();
 
     }
 
@@ -722,13 +752,13 @@ namespace Opm
             case THP:
             {
                 std::vector<EvalWell> rates(3, {numWellEq_ + numEq, 0.});
-                if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+                if (phaseIsActive(FluidSystem::waterPhaseIdx)) {
                     rates[ Water ] = getQs(flowPhaseToEbosCompIdx(Water));
                 }
-                if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx)) {
+                if (phaseIsActive(FluidSystem::oilPhaseIdx)) {
                     rates[ Oil ] = getQs(flowPhaseToEbosCompIdx(Oil));
                 }
-                if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+                if (phaseIsActive(FluidSystem::gasPhaseIdx)) {
                     rates[ Gas ] = getQs(flowPhaseToEbosCompIdx(Gas));
                 }
                 const int current = well_controls_get_current(well_controls_);
@@ -770,7 +800,7 @@ namespace Opm
                             const std::string msg = " Setting all rates to be zero for well " + name()
                                                   + " due to un-solvable situation. There is non-zero target for the phase "
                                                   + " that does not exist in the wellbore for the situation";
-                            OpmLog::warning("NON_SOLVABLE_WELL_SOLUTION", msg);
+                            deferred_logger_.warning("NON_SOLVABLE_WELL_SOLUTION", msg);
 
                             control_eq = getWQTotal() - target_rate;
                         }
@@ -844,7 +874,7 @@ namespace Opm
         if( satid == satid_elem ) { // the same saturation number is used. i.e. just use the mobilty from the cell
 
             for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx) {
-                if (!FluidSystem::phaseIsActive(phaseIdx)) {
+                if (!phaseIsActive(phaseIdx)) {
                     continue;
                 }
 
@@ -865,7 +895,7 @@ namespace Opm
 
             // compute the mobility
             for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx) {
-                if (!FluidSystem::phaseIsActive(phaseIdx)) {
+                if (!phaseIsActive(phaseIdx)) {
                     continue;
                 }
 
@@ -881,7 +911,7 @@ namespace Opm
 
         // modify the water mobility if polymer is present
         if (has_polymer) {
-            if (!FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+            if (!phaseIsActive(FluidSystem::waterPhaseIdx)) {
                 OPM_THROW(std::runtime_error, "Water is required when polymer is active");
             }
 
@@ -927,14 +957,14 @@ namespace Opm
                                        : 1.0;
 
         // update the second and third well variable (The flux fractions)
-        if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+        if (phaseIsActive(FluidSystem::waterPhaseIdx)) {
             const int sign2 = dwells[0][WFrac] > 0 ? 1: -1;
             const double dx2_limited = sign2 * std::min(std::abs(dwells[0][WFrac] * relaxation_factor_fractions), dFLimit);
             // primary_variables_[WFrac] = old_primary_variables[WFrac] - dx2_limited;
             primary_variables_[WFrac] = old_primary_variables[WFrac] - dx2_limited;
         }
 
-        if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+        if (phaseIsActive(FluidSystem::gasPhaseIdx)) {
             const int sign3 = dwells[0][GFrac] > 0 ? 1: -1;
             const double dx3_limited = sign3 * std::min(std::abs(dwells[0][GFrac] * relaxation_factor_fractions), dFLimit);
             primary_variables_[GFrac] = old_primary_variables[GFrac] - dx3_limited;
@@ -986,17 +1016,17 @@ namespace Opm
     StandardWellV<TypeTag>::
     processFractions() const
     {
-        assert(FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx));
+        assert(phaseIsActive(FluidSystem::oilPhaseIdx));
         const auto pu = phaseUsage();
         std::vector<double> F(number_of_phases_, 0.0);
         F[pu.phase_pos[Oil]] = 1.0;
 
-        if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+        if (phaseIsActive(FluidSystem::waterPhaseIdx)) {
             F[pu.phase_pos[Water]] = primary_variables_[WFrac];
             F[pu.phase_pos[Oil]] -= F[pu.phase_pos[Water]];
         }
 
-        if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+        if (phaseIsActive(FluidSystem::gasPhaseIdx)) {
             F[pu.phase_pos[Gas]] = primary_variables_[GFrac];
             F[pu.phase_pos[Oil]] -= F[pu.phase_pos[Gas]];
         }
@@ -1007,9 +1037,9 @@ namespace Opm
             F[pu.phase_pos[Oil]] -= F_solvent;
         }
 
-        if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+        if (phaseIsActive(FluidSystem::waterPhaseIdx)) {
             if (F[Water] < 0.0) {
-                if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+                if (phaseIsActive(FluidSystem::gasPhaseIdx)) {
                         F[pu.phase_pos[Gas]] /= (1.0 - F[pu.phase_pos[Water]]);
                 }
                 if (has_solvent) {
@@ -1020,9 +1050,9 @@ namespace Opm
             }
         }
 
-        if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+        if (phaseIsActive(FluidSystem::gasPhaseIdx)) {
             if (F[pu.phase_pos[Gas]] < 0.0) {
-                if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+                if (phaseIsActive(FluidSystem::waterPhaseIdx)) {
                     F[pu.phase_pos[Water]] /= (1.0 - F[pu.phase_pos[Gas]]);
                 }
                 if (has_solvent) {
@@ -1034,10 +1064,10 @@ namespace Opm
         }
 
         if (F[pu.phase_pos[Oil]] < 0.0) {
-            if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+            if (phaseIsActive(FluidSystem::waterPhaseIdx)) {
                 F[pu.phase_pos[Water]] /= (1.0 - F[pu.phase_pos[Oil]]);
             }
-            if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+            if (phaseIsActive(FluidSystem::gasPhaseIdx)) {
                 F[pu.phase_pos[Gas]] /= (1.0 - F[pu.phase_pos[Oil]]);
             }
             if (has_solvent) {
@@ -1046,10 +1076,10 @@ namespace Opm
             F[pu.phase_pos[Oil]] = 0.0;
         }
 
-        if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+        if (phaseIsActive(FluidSystem::waterPhaseIdx)) {
             primary_variables_[WFrac] = F[pu.phase_pos[Water]];
         }
-        if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+        if (phaseIsActive(FluidSystem::gasPhaseIdx)) {
             primary_variables_[GFrac] = F[pu.phase_pos[Gas]];
         }
         if(has_solvent) {
@@ -1067,19 +1097,19 @@ namespace Opm
     updateWellStateFromPrimaryVariables(WellState& well_state) const
     {
         const PhaseUsage& pu = phaseUsage();
-        assert( FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx) );
+        assert( phaseIsActive(FluidSystem::oilPhaseIdx) );
         const int oil_pos = pu.phase_pos[Oil];
 
         std::vector<double> F(number_of_phases_, 0.0);
         F[oil_pos] = 1.0;
 
-        if ( FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx) ) {
+        if ( phaseIsActive(FluidSystem::waterPhaseIdx) ) {
             const int water_pos = pu.phase_pos[Water];
             F[water_pos] = primary_variables_[WFrac];
             F[oil_pos] -= F[water_pos];
         }
 
-        if ( FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx) ) {
+        if ( phaseIsActive(FluidSystem::gasPhaseIdx) ) {
             const int gas_pos = pu.phase_pos[Gas];
             F[gas_pos] = primary_variables_[GFrac];
             F[oil_pos] -= F[gas_pos];
@@ -1164,13 +1194,13 @@ namespace Opm
             std::vector<double> rates(3, 0.0);
 
             const Opm::PhaseUsage& pu = phaseUsage();
-            if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+            if (phaseIsActive(FluidSystem::waterPhaseIdx)) {
                 rates[ Water ] = well_state.wellRates()[index_of_well_ * number_of_phases_ + pu.phase_pos[ Water ] ];
             }
-            if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx)) {
+            if (phaseIsActive(FluidSystem::oilPhaseIdx)) {
                 rates[ Oil ] = well_state.wellRates()[index_of_well_ * number_of_phases_ + pu.phase_pos[ Oil ] ];
             }
-            if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+            if (phaseIsActive(FluidSystem::gasPhaseIdx)) {
                 rates[ Gas ] = well_state.wellRates()[index_of_well_ * number_of_phases_ + pu.phase_pos[ Gas ] ];
             }
 
@@ -1217,7 +1247,7 @@ namespace Opm
             } else { // go to BHP limit
                 assert(this->operability_status_.isOperableUnderBHPLimit() );
 
-                OpmLog::info("well " + name() + " can not work with THP target, switching to BHP control");
+                deferred_logger_.info("well " + name() + " can not work with THP target, switching to BHP control");
 
                 well_state.bhp()[well_index] = mostStrictBhpFromBhpLimits();
             }
@@ -1322,7 +1352,7 @@ namespace Opm
             // calculating the b for the connection
             std::vector<double> b_perf(num_components_);
             for (size_t phase = 0; phase < FluidSystem::numPhases; ++phase) {
-                if (!FluidSystem::phaseIsActive(phase)) {
+                if (!phaseIsActive(phase)) {
                     continue;
                 }
                 const unsigned comp_idx = Indices::canonicalToActiveComponentIndex(FluidSystem::solventComponentIndex(phase));
@@ -1337,7 +1367,7 @@ namespace Opm
             // it should not be negative anyway. If it is negative, we might need to re-formulate
             // to taking into consideration the crossflow here.
             if (pressure_diff <= 0.) {
-                OpmLog::warning("NON_POSITIVE_DRAWDOWN_IPR",
+                deferred_logger_.warning("NON_POSITIVE_DRAWDOWN_IPR",
                                 "non-positive drawdown found when updateIPR for well " + name());
             }
 
@@ -1356,7 +1386,7 @@ namespace Opm
             }
 
             // we need to handle the rs and rv when both oil and gas are present
-            if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx) && FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+            if (phaseIsActive(FluidSystem::oilPhaseIdx) && phaseIsActive(FluidSystem::gasPhaseIdx)) {
                 const unsigned oil_comp_idx = Indices::canonicalToActiveComponentIndex(FluidSystem::oilCompIdx);
                 const unsigned gas_comp_idx = Indices::canonicalToActiveComponentIndex(FluidSystem::gasCompIdx);
                 const double rs = (fs.Rs()).value();
@@ -1409,9 +1439,9 @@ namespace Opm
         const bool well_operable = this->operability_status_.isOperable();
 
         if (!well_operable && old_well_operable) {
-            OpmLog::info(" well " + name() + " gets SHUT during iteration ");
+            deferred_logger_.info(" well " + name() + " gets SHUT during iteration ");
         } else if (well_operable && !old_well_operable) {
-            OpmLog::info(" well " + name() + " gets REVIVED during iteration ");
+            deferred_logger_.info(" well " + name() + " gets REVIVED during iteration ");
         }
     }
 
@@ -1514,12 +1544,12 @@ namespace Opm
                                         + " bars is SMALLER than thp limit "
                                         + std::to_string(unit::convert::to(thp_limit, unit::barsa))
                                         + " bars as a producer for well " + name();
-                OpmLog::debug(msg);
+                deferred_logger_.debug(msg);
             }
         } else {
             this->operability_status_.can_obtain_bhp_with_thp_limit = false;
             const double thp_limit = this->getTHPConstraint();
-            OpmLog::debug(" COULD NOT find bhp value under thp_limit "
+            deferred_logger_.debug(" COULD NOT find bhp value under thp_limit "
                           + std::to_string(unit::convert::to(thp_limit, unit::barsa))
                           + " bars for well " + name() + ", the well might need to be closed ");
             this->operability_status_.obey_bhp_limit_with_thp_limit = false;
@@ -1590,7 +1620,7 @@ namespace Opm
         }
 
         if (!can_produce_inject) {
-            OpmLog::debug(" well " + name() + " CANNOT produce or inejct ");
+            deferred_logger_.debug(" well " + name() + " CANNOT produce or inejct ");
         }
 
         return can_produce_inject;
@@ -1722,9 +1752,9 @@ namespace Opm
         surf_dens_perf.resize(nperf * num_components_);
         const int w = index_of_well_;
 
-        const bool waterPresent = FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx);
-        const bool oilPresent = FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx);
-        const bool gasPresent = FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx);
+        const bool waterPresent = phaseIsActive(FluidSystem::waterPhaseIdx);
+        const bool oilPresent = phaseIsActive(FluidSystem::oilPhaseIdx);
+        const bool gasPresent = phaseIsActive(FluidSystem::gasPhaseIdx);
 
         //rs and rv are only used if both oil and gas is present
         if (oilPresent && gasPresent) {
@@ -1804,7 +1834,7 @@ namespace Opm
 
             // Surface density.
             for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx) {
-                if (!FluidSystem::phaseIsActive(phaseIdx)) {
+                if (!phaseIsActive(phaseIdx)) {
                     continue;
                 }
 
@@ -1889,7 +1919,7 @@ namespace Opm
             x = mix;
 
             // Subtract dissolved gas from oil phase and vapporized oil from gas phase
-            if (FluidSystem::phaseIsActive(FluidSystem::gasCompIdx) && FluidSystem::phaseIsActive(FluidSystem::oilCompIdx)) {
+            if (phaseIsActive(FluidSystem::gasCompIdx) && phaseIsActive(FluidSystem::oilCompIdx)) {
                 const unsigned gaspos = Indices::canonicalToActiveComponentIndex(FluidSystem::gasCompIdx);
                 const unsigned oilpos = Indices::canonicalToActiveComponentIndex(FluidSystem::oilCompIdx);
                 double rs = 0.0;
@@ -1997,7 +2027,7 @@ namespace Opm
         CR::WellFailure::Type type = CR::WellFailure::Type::MassBalance;
         // checking if any NaN or too large residuals found
         for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx) {
-            if (!FluidSystem::phaseIsActive(phaseIdx)) {
+            if (!phaseIsActive(phaseIdx)) {
                 continue;
             }
 
@@ -2184,6 +2214,44 @@ namespace Opm
 
 
 
+    template<typename TypeTag>
+    void
+    StandardWellV<TypeTag>::
+    packApplyOperator()
+    {
+        packed_cells_.clear();
+        packed_invDB_.clear();
+        packed_C_.clear();
+        packed_invDBx_.resize(numWellEq_);
+
+        const auto& invD = invDuneD_[0][0];
+        // the columns of B and C are the same perforated cells
+        for (auto colB = duneB_[0].begin(), endB = duneB_[0].end(); colB != endB; ++colB) {
+            const auto& B = *colB;
+            const auto& C = duneC_[0][colB.index()];
+            packed_cells_.push_back(colB.index());
+            for (int row = 0; row < numWellEq_; ++row) {
+                ReservoirRow invDB(0.0);
+                for (int k = 0; k < numWellEq_; ++k) {
+                    for (int col = 0; col < numEq; ++col) {
+                        invDB[col] += invD[row][k] * B[k][col];
+                    }
+                }
+                packed_invDB_.push_back(invDB);
+
+                ReservoirRow rowC;
+                for (int col = 0; col < numEq; ++col) {
+                    rowC[col] = C[row][col];
+                }
+                packed_C_.push_back(rowC);
+            }
+        }
+    }
+
+
+
+
+
     template<typename TypeTag>
     void
     StandardWellV<TypeTag>::
@@ -2196,19 +2264,28 @@ namespace Opm
             // Contributions are already in the matrix itself
             return;
         }
-        assert( Bx_.size() == duneB_.N() );
-        assert( invDrw_.size() == invDuneD_.N() );
+        assert( packed_invDB_.size() == packed_cells_.size() * numWellEq_ );
+        assert( packed_invDBx_.size() == static_cast<std::size_t>(numWellEq_) );
 
-        // Bx_ = duneB_ * x
-        duneB_.mv(x, Bx_);
-        // invDBx = invDuneD_ * Bx_
-        // TODO: with this, we modified the content of the invDrw_.
-        // Is it necessary to do this to save some memory?
-        BVectorWell& invDBx = invDrw_;
-        invDuneD_.mv(Bx_, invDBx);
+        // invDBx = D^-1 B x, with D^-1 B gathered in packApplyOperator()
+        std::fill(packed_invDBx_.begin(), packed_invDBx_.end(), 0.0);
+        const std::size_t numCells = packed_cells_.size();
+        for (std::size_t c = 0; c < numCells; ++c) {
+            const auto& xCell = x[packed_cells_[c]];
+            const ReservoirRow* invDB = &packed_invDB_[c * numWellEq_];
+            for (int row = 0; row < numWellEq_; ++row) {
+                packed_invDBx_[row] += invDB[row] * xCell;
+            }
+        }
 
-        // Ax = Ax - duneC_^T * invDBx
-        duneC_.mmtv(invDBx,Ax);
+        // Ax = Ax - C^T * invDBx
+        for (std::size_t c = 0; c < numCells; ++c) {
+            auto& AxCell = Ax[packed_cells_[c]];
+            const ReservoirRow* C = &packed_C_[c * numWellEq_];
+            for (int row = 0; row < numWellEq_; ++row) {
+                AxCell.axpy(-packed_invDBx_[row], C[row]);
+            }
+        }
     }
 
 
@@ -2345,13 +2422,13 @@ namespace Opm
                     const Opm::PhaseUsage& pu = phaseUsage();
 
                     std::vector<double> rates(3, 0.0);
-                    if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+                    if (phaseIsActive(FluidSystem::waterPhaseIdx)) {
                         rates[ Water ] = potentials[pu.phase_pos[ Water ] ];
                     }
-                    if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx)) {
+                    if (phaseIsActive(FluidSystem::oilPhaseIdx)) {
                         rates[ Oil ] = potentials[pu.phase_pos[ Oil ] ];
                     }
-                    if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+                    if (phaseIsActive(FluidSystem::gasPhaseIdx)) {
                         rates[ Gas ] = potentials[pu.phase_pos[ Gas ] ];
                     }
 
@@ -2498,10 +2575,10 @@ namespace Opm
         const auto pu = phaseUsage();
 
         if(std::abs(total_well_rate) > 0.) {
-            if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+            if (phaseIsActive(FluidSystem::waterPhaseIdx)) {
                 primary_variables_[WFrac] = scalingFactor(pu.phase_pos[Water]) * well_state.wellRates()[np*well_index + pu.phase_pos[Water]] / total_well_rate;
             }
-            if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+            if (phaseIsActive(FluidSystem::gasPhaseIdx)) {
                 primary_variables_[GFrac] = scalingFactor(pu.phase_pos[Gas]) * (well_state.wellRates()[np*well_index + pu.phase_pos[Gas]] - well_state.solventWellRate(well_index)) / total_well_rate ;
             }
             if (has_solvent) {
@@ -2510,7 +2587,7 @@ namespace Opm
         } else { // total_well_rate == 0
             if (well_type_ == INJECTOR) {
                 // only single phase injection handled
-                if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+                if (phaseIsActive(FluidSystem::waterPhaseIdx)) {
                     if (distr[Water] > 0.0) {
                         primary_variables_[WFrac] = 1.0;
                     } else {
@@ -2518,7 +2595,7 @@ namespace Opm
                     }
                 }
 
-                if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+                if (phaseIsActive(FluidSystem::gasPhaseIdx)) {
                     if (distr[pu.phase_pos[Gas]] > 0.0) {
                         primary_variables_[GFrac] = 1.0 - wsolvent();
                         if (has_solvent) {
@@ -2534,10 +2611,10 @@ namespace Opm
                 // this will happen.
             } else if (well_type_ == PRODUCER) { // producers
                 // TODO: the following are not addressed for the solvent case yet
-                if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+                if (phaseIsActive(FluidSystem::waterPhaseIdx)) {
                     primary_variables_[WFrac] = 1.0 / np;
                 }
-                if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+                if (phaseIsActive(FluidSystem::gasPhaseIdx)) {
                     primary_variables_[GFrac] = 1.0 / np;
                 }
             } else {
@@ -2594,14 +2671,14 @@ namespace Opm
 
             const double dp = wellhelpers::computeHydrostaticCorrection(ref_depth_, vfp_ref_depth, rho, gravity_);
 
-            return vfp_properties_->getInj()->bhp(vfp, aqua, liquid, vapour, thp) - dp;
+            return vfp_properties_->getInj()->bhp(vfp, aqua, liquid, vapour, thp, &vfp_interp_hint_) - dp;
          }
          else if (well_type_ == PRODUCER) {
              const double vfp_ref_depth = vfp_properties_->getProd()->getTable(vfp)->getDatumDepth();
 
              const double dp = wellhelpers::computeHydrostaticCorrection(ref_depth_, vfp_ref_depth, rho, gravity_);
 
-             return vfp_properties_->getProd()->bhp(vfp, aqua, liquid, vapour, thp, alq) - dp;
+             return vfp_properties_->getProd()->bhp(vfp, aqua, liquid, vapour, thp, alq, &vfp_interp_hint_) - dp;
          }
          else {
              OPM_THROW(std::logic_error, "Expected INJECTOR or PRODUCER well");
@@ -2800,17 +2877,17 @@ namespace Opm
         // 0.95 is a experimental value, which remains to be optimized
         double relaxation_factor = 1.0;
 
-        if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+        if (phaseIsActive(FluidSystem::waterPhaseIdx)) {
             const double relaxation_factor_w = relaxationFactorFraction(primary_variables[WFrac], dwells[0][WFrac]);
             relaxation_factor = std::min(relaxation_factor, relaxation_factor_w);
         }
 
-        if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+        if (phaseIsActive(FluidSystem::gasPhaseIdx)) {
             const double relaxation_factor_g = relaxationFactorFraction(primary_variables[GFrac], dwells[0][GFrac]);
             relaxation_factor = std::min(relaxation_factor, relaxation_factor_g);
         }
 
-        if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx) && FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+        if (phaseIsActive(FluidSystem::waterPhaseIdx) && phaseIsActive(FluidSystem::gasPhaseIdx)) {
             // We need to make sure the even with the relaxation_factor, the sum of F_w and F_g is below one, so there will
             // not be negative oil fraction later
             const double original_sum = primary_variables[WFrac] + primary_variables[GFrac];
@@ -2870,7 +2947,7 @@ namespace Opm
                         const double simulation_time, const int report_step, const bool terminal_output,
                         WellState& well_state, WellTestState& welltest_state, wellhelpers::WellSwitchingLogger& logger)
     {
-        OpmLog::debug(" well " + name() + " is being tested for physical limits");
+        deferred_logger_.debug(" well " + name() + " is being tested for physical limits");
 
         // some most difficult things are the explicit quantities, since there is no information
         // in the WellState to do a decent initialization
@@ -2893,7 +2970,7 @@ namespace Opm
 
         if ( !this->isOperable() ) {
             const std::string msg = " well " + name() + " is not operable during well testing for physical reason";
-            OpmLog::debug(msg);
+            deferred_logger_.debug(msg);
             return;
         }
 
@@ -2907,18 +2984,18 @@ namespace Opm
 
         if (!converged) {
             const std::string msg = " well " + name() + " did not get converged during well testing for physical reason";
-            OpmLog::debug(msg);
+            deferred_logger_.debug(msg);
             return;
         }
 
         if (this->isOperable() ) {
             welltest_state.openWell(name() );
             const std::string msg = " well " + name() + " is re-opened through well testing for physical reason";
-            OpmLog::info(msg);
+            deferred_logger_.info(msg);
             well_state = well_state_copy;
         } else {
             const std::string msg = " well " + name() + " is not operable during well testing for physical reason";
-            OpmLog::debug(msg);
+            deferred_logger_.debug(msg);
         }
     }
 
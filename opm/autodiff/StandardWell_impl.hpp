@@ -38,6 +38,9 @@ namespace Opm
     , F0_(numWellConservationEq)
     , ipr_a_(number_of_phases_)
     , ipr_b_(number_of_phases_)
+    , scratch_cmix_s_(num_components_)
+    , scratch_mob_(num_components_)
+    , scratch_cq_s_(num_components_)
     {
         assert(num_components_ == numWellConservationEq);
 
@@ -207,11 +210,11 @@ namespace Opm
     StandardWell<TypeTag>::
     wellVolumeFraction(const unsigned compIdx) const
     {
-        if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx) && compIdx == Indices::canonicalToActiveComponentIndex(FluidSystem::waterCompIdx)) {
+        if (phaseIsActive(FluidSystem::waterPhaseIdx) && compIdx == Indices::canonicalToActiveComponentIndex(FluidSystem::waterCompIdx)) {
             return primary_variables_evaluation_[WFrac];
         }
 
-        if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx) && compIdx == Indices::canonicalToActiveComponentIndex(FluidSystem::gasCompIdx)) {
+        if (phaseIsActive(FluidSystem::gasPhaseIdx) && compIdx == Indices::canonicalToActiveComponentIndex(FluidSystem::gasCompIdx)) {
             return primary_variables_evaluation_[GFrac];
         }
 
@@ -221,11 +224,11 @@ namespace Opm
 
         // Oil fraction
         EvalWell well_fraction = 1.0;
-        if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+        if (phaseIsActive(FluidSystem::waterPhaseIdx)) {
             well_fraction -= primary_variables_evaluation_[WFrac];
         }
 
-        if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+        if (phaseIsActive(FluidSystem::gasPhaseIdx)) {
             well_fraction -= primary_variables_evaluation_[GFrac];
         }
         if (has_solvent) {
@@ -258,6 +261,103 @@ namespace Opm
 
 
 
+    template<typename TypeTag>
+    void
+    StandardWell<TypeTag>::
+    wellSurfaceVolumeFractions(std::vector<EvalWell>& fractions) const
+    {
+        assert(static_cast<int>(fractions.size()) == num_components_);
+        EvalWell sum_volume_fraction_scaled = 0.;
+        for (int idx = 0; idx < num_components_; ++idx) {
+            fractions[idx] = wellVolumeFractionScaled(idx);
+            sum_volume_fraction_scaled += fractions[idx];
+        }
+
+        // also computed for wells without injecting perforations, which do not use them
+        if (sum_volume_fraction_scaled.value() != 0.) {
+            for (auto& fraction : fractions) {
+                fraction /= sum_volume_fraction_scaled;
+            }
+        }
+    }
+
+
+
+
+
+    template<typename TypeTag>
+    template<class RateVector>
+    typename RateVector::value_type
+    StandardWell<TypeTag>::
+    computeConnectionEnergyRate(const Simulator& ebosSimulator,
+                                const IntensiveQuantities& intQuants,
+                                const RateVector& cq_s,
+                                const int cell_idx) const
+    {
+        typedef typename RateVector::value_type Value;
+
+        auto fs = intQuants.fluidState();
+        const int reportStepIdx = ebosSimulator.episodeIndex();
+        Value energy_rate = cq_s[0] * 0.0;
+
+        for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx) {
+            if (!phaseIsActive(phaseIdx)) {
+                continue;
+            }
+
+            const unsigned activeCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::solventComponentIndex(phaseIdx));
+            // convert to reservoar conditions
+            Value cq_r_thermal = cq_s[activeCompIdx] * 0.0;
+            if (phaseIsActive(FluidSystem::oilPhaseIdx) && phaseIsActive(FluidSystem::gasPhaseIdx)) {
+
+                if(FluidSystem::waterPhaseIdx == phaseIdx)
+                     cq_r_thermal = cq_s[activeCompIdx] / energyValue(fs.invB(phaseIdx), cq_s[0]);
+
+                // remove dissolved gas and vapporized oil
+                const unsigned oilCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::oilCompIdx);
+                const unsigned gasCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::gasCompIdx);
+                // q_os = q_or * b_o + rv * q_gr * b_g
+                // q_gs = q_gr * g_g + rs * q_or * b_o
+                // d = 1.0 - rs * rv
+                const Value d = energyValue(1.0 - fs.Rv() * fs.Rs(), cq_s[0]);
+                // q_gr = 1 / (b_g * d) * (q_gs - rs * q_os)
+                if(FluidSystem::gasPhaseIdx == phaseIdx)
+                    cq_r_thermal = (cq_s[gasCompIdx] - energyValue(fs.Rs(), cq_s[0]) * cq_s[oilCompIdx]) / (d * energyValue(fs.invB(phaseIdx), cq_s[0]) );
+                // q_or = 1 / (b_o * d) * (q_os - rv * q_gs)
+                if(FluidSystem::oilPhaseIdx == phaseIdx)
+                    cq_r_thermal = (cq_s[oilCompIdx] - energyValue(fs.Rv(), cq_s[0]) * cq_s[gasCompIdx]) / (d * energyValue(fs.invB(phaseIdx), cq_s[0]) );
+
+            } else {
+                cq_r_thermal = cq_s[activeCompIdx] / energyValue(fs.invB(phaseIdx), cq_s[0]);
+            }
+
+            // change temperature for injecting fluids
+            if (well_type_ == INJECTOR && cq_s[activeCompIdx] > 0.0){
+                const auto& injProps = this->well_ecl_->getInjectionProperties(reportStepIdx);
+                fs.setTemperature(injProps.temperature);
+                typedef typename std::decay<decltype(fs)>::type::Scalar FsScalar;
+                typename FluidSystem::template ParameterCache<FsScalar> paramCache;
+                const unsigned pvtRegionIdx = intQuants.pvtRegionIndex();
+                paramCache.setRegionIndex(pvtRegionIdx);
+                paramCache.setMaxOilSat(ebosSimulator.problem().maxOilSaturation(cell_idx));
+                paramCache.updatePhase(fs, phaseIdx);
+
+                const auto& rho = FluidSystem::density(fs, paramCache, phaseIdx);
+                fs.setDensity(phaseIdx, rho);
+                const auto& h = FluidSystem::enthalpy(fs, paramCache, phaseIdx);
+                fs.setEnthalpy(phaseIdx, h);
+            }
+            // compute the thermal flux
+            cq_r_thermal *= energyValue(fs.enthalpy(phaseIdx), cq_s[0]) * energyValue(fs.density(phaseIdx), cq_s[0]);
+            energy_rate += cq_r_thermal;
+        }
+        return energy_rate;
+    }
+
+
+
+
+
     template<typename TypeTag>
     typename StandardWell<TypeTag>::EvalWell
     StandardWell<TypeTag>::
@@ -281,6 +381,7 @@ namespace Opm
     computePerfRate(const IntensiveQuantities& intQuants,
                     const std::vector<EvalWell>& mob,
                     const EvalWell& bhp,
+                    const std::vector<EvalWell>& cmix_s,
                     const int perf,
                     const bool allow_cf,
                     std::vector<EvalWell>& cq_s,
@@ -291,9 +392,11 @@ namespace Opm
         const EvalWell pressure = extendEval(fs.pressure(FluidSystem::oilPhaseIdx));
         const EvalWell rs = extendEval(fs.Rs());
         const EvalWell rv = extendEval(fs.Rv());
-        std::vector<EvalWell> b_perfcells_dense(num_components_, 0.0);
+        // the components are at most the conservation equations, no allocation per perforation
+        std::array<EvalWell, numEq> b_perfcells_dense;
+        std::fill(b_perfcells_dense.begin(), b_perfcells_dense.end(), 0.0);
         for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx) {
-            if (!FluidSystem::phaseIsActive(phaseIdx)) {
+            if (!phaseIsActive(phaseIdx)) {
                 continue;
             }
 
@@ -322,7 +425,7 @@ namespace Opm
                 cq_s[componentIdx] = b_perfcells_dense[componentIdx] * cq_p;
             }
 
-            if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx) && FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+            if (phaseIsActive(FluidSystem::oilPhaseIdx) && phaseIsActive(FluidSystem::gasPhaseIdx)) {
                 const unsigned oilCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::oilCompIdx);
                 const unsigned gasCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::gasCompIdx);
                 const EvalWell cq_sOil = cq_s[oilCompIdx];
@@ -356,15 +459,9 @@ namespace Opm
             const double Tw = well_index_[perf];
             const EvalWell cqt_i = - Tw * (total_mob_dense * drawdown);
 
-            // surface volume fraction of fluids within wellbore
-            std::vector<EvalWell> cmix_s(num_components_, 0.);
-            for (int componentIdx = 0; componentIdx < num_components_; ++componentIdx) {
-                cmix_s[componentIdx] = wellSurfaceVolumeFraction(componentIdx);
-            }
-
             // compute volume ratio between connection at standard conditions
             EvalWell volumeRatio = 0.0;
-            if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+            if (phaseIsActive(FluidSystem::waterPhaseIdx)) {
                 const unsigned waterCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::waterCompIdx);
                 volumeRatio += cmix_s[waterCompIdx] / b_perfcells_dense[waterCompIdx];
             }
@@ -373,7 +470,7 @@ namespace Opm
                 volumeRatio += cmix_s[contiSolventEqIdx] / b_perfcells_dense[contiSolventEqIdx];
             }
 
-            if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx) && FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+            if (phaseIsActive(FluidSystem::oilPhaseIdx) && phaseIsActive(FluidSystem::gasPhaseIdx)) {
                 const unsigned oilCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::oilCompIdx);
                 const unsigned gasCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::gasCompIdx);
                 // Incorporate RS/RV factors if both oil and gas active
@@ -393,11 +490,11 @@ namespace Opm
                 volumeRatio += tmp_gas / b_perfcells_dense[gasCompIdx];
             }
             else {
-                if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx)) {
+                if (phaseIsActive(FluidSystem::oilPhaseIdx)) {
                     const unsigned oilCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::oilCompIdx);
                     volumeRatio += cmix_s[oilCompIdx] / b_perfcells_dense[oilCompIdx];
                 }
-                if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+                if (phaseIsActive(FluidSystem::gasPhaseIdx)) {
                     const unsigned gasCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::gasCompIdx);
                     volumeRatio += cmix_s[gasCompIdx] / b_perfcells_dense[gasCompIdx];
                 }
@@ -412,7 +509,7 @@ namespace Opm
 
             // calculating the perforation solution gas rate and solution oil rates
             if (well_type_ == PRODUCER) {
-                if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx) && FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+                if (phaseIsActive(FluidSystem::oilPhaseIdx) && phaseIsActive(FluidSystem::gasPhaseIdx)) {
                     const unsigned oilCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::oilCompIdx);
                     const unsigned gasCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::gasCompIdx);
                     // TODO: the formulations here remain to be tested with cases with strong crossflow through production wells
@@ -446,7 +543,6 @@ namespace Opm
                    const double dt,
                    WellState& well_state)
     {
-
         checkWellOperability(ebosSimulator, well_state);
 
         if (!this->isOperable()) return;
@@ -473,17 +569,33 @@ namespace Opm
             well_state.productivityIndex()[np*index_of_well_ + p] = 0.;
         }
 
+        // surface volume fraction of fluids within wellbore
+        std::vector<EvalWell>& cmix_s = scratch_cmix_s_;
+        wellSurfaceVolumeFractions(cmix_s);
+        std::vector<EvalWell>& mob = scratch_mob_;
+        std::vector<EvalWell>& cq_s = scratch_cq_s_;
+
+        // whether the productivity index of a phase is asked for, looked up once per well
+        const auto& pu = phaseUsage();
+        const Opm::SummaryConfig& summaryConfig = ebosSimulator.vanguard().summaryConfig();
+        std::array<bool, 3> compute_pi;
+        for (int p = 0; p < np; ++p) {
+            compute_pi[p] = (pu.phase_pos[Water] == p && (summaryConfig.hasSummaryKey("WPIW:" + name()) || summaryConfig.hasSummaryKey("WPIL:" + name())))
+                || (pu.phase_pos[Oil] == p && (summaryConfig.hasSummaryKey("WPIO:" + name()) || summaryConfig.hasSummaryKey("WPIL:" + name())))
+                || (pu.phase_pos[Gas] == p && summaryConfig.hasSummaryKey("WPIG:" + name()));
+        }
+
         for (int perf = 0; perf < number_of_perforations_; ++perf) {
 
             const int cell_idx = well_cells_[perf];
             const auto& intQuants = *(ebosSimulator.model().cachedIntensiveQuantities(cell_idx, /*timeIdx=*/ 0));
-            std::vector<EvalWell> mob(num_components_, 0.0);
+            std::fill(mob.begin(), mob.end(), 0.0);
             getMobility(ebosSimulator, perf, mob);
 
-            std::vector<EvalWell> cq_s(num_components_, 0.0);
+            std::fill(cq_s.begin(), cq_s.end(), 0.0);
             double perf_dis_gas_rate = 0.;
             double perf_vap_oil_rate = 0.;
-            computePerfRate(intQuants, mob, bhp, perf, allow_cf,
+            computePerfRate(intQuants, mob, bhp, cmix_s, perf, allow_cf,
                             cq_s, perf_dis_gas_rate, perf_vap_oil_rate);
 
             // updating the solution gas rate and solution oil rate
@@ -492,10 +604,6 @@ namespace Opm
                 well_state.wellVaporizedOilRates()[index_of_well_] += perf_vap_oil_rate;
             }
 
-            if (has_energy) {
-                connectionRates_[perf][contiEnergyEqIdx] = 0.0;
-            }
-
             for (int componentIdx = 0; componentIdx < num_components_; ++componentIdx) {
                 // the cq_s entering mass balance equations need to consider the efficiency factors.
                 const EvalWell cq_s_effective = cq_s[componentIdx] * well_efficiency_factor_;
@@ -524,60 +632,15 @@ namespace Opm
                 }
             }
             if (has_energy) {
-
-                auto fs = intQuants.fluidState();
-                const int reportStepIdx = ebosSimulator.episodeIndex();
-
-                for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx) {
-                    if (!FluidSystem::phaseIsActive(phaseIdx)) {
-                        continue;
-                    }
-
-                    const unsigned activeCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::solventComponentIndex(phaseIdx));
-                    // convert to reservoar conditions
-                    EvalWell cq_r_thermal = 0.0;
-                    if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx) && FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
-
-                        if(FluidSystem::waterPhaseIdx == phaseIdx)
-                             cq_r_thermal = cq_s[activeCompIdx] / extendEval(fs.invB(phaseIdx));
-
-                        // remove dissolved gas and vapporized oil
-                        const unsigned oilCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::oilCompIdx);
-                        const unsigned gasCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::gasCompIdx);
-                        // q_os = q_or * b_o + rv * q_gr * b_g
-                        // q_gs = q_gr * g_g + rs * q_or * b_o
-                        // d = 1.0 - rs * rv
-                        const EvalWell d = extendEval(1.0 - fs.Rv() * fs.Rs());
-                        // q_gr = 1 / (b_g * d) * (q_gs - rs * q_os)
-                        if(FluidSystem::gasPhaseIdx == phaseIdx)
-                            cq_r_thermal = (cq_s[gasCompIdx] - extendEval(fs.Rs()) * cq_s[oilCompIdx]) / (d * extendEval(fs.invB(phaseIdx)) );
-                        // q_or = 1 / (b_o * d) * (q_os - rv * q_gs)
-                        if(FluidSystem::oilPhaseIdx == phaseIdx)
-                            cq_r_thermal = (cq_s[oilCompIdx] - extendEval(fs.Rv()) * cq_s[gasCompIdx]) / (d * extendEval(fs.invB(phaseIdx)) );
-
-                    } else {
-                        cq_r_thermal = cq_s[activeCompIdx] / extendEval(fs.invB(phaseIdx));
-                    }
-
-                    // change temperature for injecting fluids
-                    if (well_type_ == INJECTOR && cq_s[activeCompIdx] > 0.0){
-                        const auto& injProps = this->well_ecl_->getInjectionProperties(reportStepIdx);
-                        fs.setTemperature(injProps.temperature);
-                        typedef typename std::decay<decltype(fs)>::type::Scalar FsScalar;
-                        typename FluidSystem::template ParameterCache<FsScalar> paramCache;
-                        const unsigned pvtRegionIdx = intQuants.pvtRegionIndex();
-                        paramCache.setRegionIndex(pvtRegionIdx);
-                        paramCache.setMaxOilSat(ebosSimulator.problem().maxOilSaturation(cell_idx));
-                        paramCache.updatePhase(fs, phaseIdx);
-
-                        const auto& rho = FluidSystem::density(fs, paramCache, phaseIdx);
-                        fs.setDensity(phaseIdx, rho);
-                        const auto& h = FluidSystem::enthalpy(fs, paramCache, phaseIdx);
-                        fs.setEnthalpy(phaseIdx, h);
+                if (param_.explicit_well_energy_flux_) {
+                    // only the values of the rates are used, the flux has no derivatives
+                    std::array<Scalar, numEq> cq_s_value{};
+                    for (int componentIdx = 0; componentIdx < num_components_; ++componentIdx) {
+                        cq_s_value[componentIdx] = cq_s[componentIdx].value();
                     }
-                    // compute the thermal flux
-                    cq_r_thermal *= extendEval(fs.enthalpy(phaseIdx)) * extendEval(fs.density(phaseIdx));
-                    connectionRates_[perf][contiEnergyEqIdx] += Base::restrictEval(cq_r_thermal);
+                    connectionRates_[perf][contiEnergyEqIdx] = computeConnectionEnergyRate(ebosSimulator, intQuants, cq_s_value, cell_idx);
+                } else {
+                    connectionRates_[perf][contiEnergyEqIdx] = Base::restrictEval(computeConnectionEnergyRate(ebosSimulator, intQuants, cq_s, cell_idx));
                 }
             }
 
@@ -611,12 +674,8 @@ namespace Opm
             well_state.perfPress()[first_perf_ + perf] = well_state.bhp()[index_of_well_] + perf_pressure_diffs_[perf];
 
             // Compute Productivity index if asked for
-            const auto& pu = phaseUsage();
-            const Opm::SummaryConfig& summaryConfig = ebosSimulator.vanguard().summaryConfig();
             for (int p = 0; p < np; ++p) {
-                if ( (pu.phase_pos[Water] == p && (summaryConfig.hasSummaryKey("WPIW:" + name()) || summaryConfig.hasSummaryKey("WPIL:" + name())))
-                        || (pu.phase_pos[Oil] == p && (summaryConfig.hasSummaryKey("WPIO:" + name()) || summaryConfig.hasSummaryKey("WPIL:" + name())))
-                        || (pu.phase_pos[Gas] == p && summaryConfig.hasSummaryKey("WPIG:" + name()))) {
+                if (compute_pi[p]) {
 
                     const unsigned int compIdx = flowPhaseToEbosCompIdx(p);
                     const double drawdown = well_state.perfPress()[first_perf_ + perf] - intQuants.fluidState().pressure(FluidSystem::oilPhaseIdx).value();
@@ -668,13 +727,13 @@ namespace Opm
             case THP:
             {
                 std::vector<EvalWell> rates(3, 0.);
-                if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+                if (phaseIsActive(FluidSystem::waterPhaseIdx)) {
                     rates[ Water ] = getQs(flowPhaseToEbosCompIdx(Water));
                 }
-                if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx)) {
+                if (phaseIsActive(FluidSystem::oilPhaseIdx)) {
                     rates[ Oil ] = getQs(flowPhaseToEbosCompIdx(Oil));
                 }
-                if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+                if (phaseIsActive(FluidSystem::gasPhaseIdx)) {
                     rates[ Gas ] = getQs(flowPhaseToEbosCompIdx(Gas));
                 }
                 const int current = well_controls_get_current(well_controls_);
@@ -716,7 +775,7 @@ namespace Opm
                             const std::string msg = " Setting all rates to be zero for well " + name()
                                                   + " due to un-solvable situation. There is non-zero target for the phase "
                                                   + " that does not exist in the wellbore for the situation";
-                            OpmLog::warning("NON_SOLVABLE_WELL_SOLUTION", msg);
+                            deferred_logger_.warning("NON_SOLVABLE_WELL_SOLUTION", msg);
 
                             control_eq = getWQTotal() - target_rate;
                         }
@@ -790,7 +849,7 @@ namespace Opm
         if( satid == satid_elem ) { // the same saturation number is used. i.e. just use the mobilty from the cell
 
             for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx) {
-                if (!FluidSystem::phaseIsActive(phaseIdx)) {
+                if (!phaseIsActive(phaseIdx)) {
                     continue;
                 }
 
@@ -811,7 +870,7 @@ namespace Opm
 
             // compute the mobility
             for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx) {
-                if (!FluidSystem::phaseIsActive(phaseIdx)) {
+                if (!phaseIsActive(phaseIdx)) {
                     continue;
                 }
 
@@ -827,7 +886,7 @@ namespace Opm
 
         // modify the water mobility if polymer is present
         if (has_polymer) {
-            if (!FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+            if (!phaseIsActive(FluidSystem::waterPhaseIdx)) {
                 OPM_THROW(std::runtime_error, "Water is required when polymer is active");
             }
 
@@ -873,14 +932,14 @@ namespace Opm
                                        : 1.0;
 
         // update the second and third well variable (The flux fractions)
-        if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+        if (phaseIsActive(FluidSystem::waterPhaseIdx)) {
             const int sign2 = dwells[0][WFrac] > 0 ? 1: -1;
             const double dx2_limited = sign2 * std::min(std::abs(dwells[0][WFrac] * relaxation_factor_fractions), dFLimit);
             // primary_variables_[WFrac] = old_primary_variables[WFrac] - dx2_limited;
             primary_variables_[WFrac] = old_primary_variables[WFrac] - dx2_limited;
         }
 
-        if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+        if (phaseIsActive(FluidSystem::gasPhaseIdx)) {
             const int sign3 = dwells[0][GFrac] > 0 ? 1: -1;
             const double dx3_limited = sign3 * std::min(std::abs(dwells[0][GFrac] * relaxation_factor_fractions), dFLimit);
             primary_variables_[GFrac] = old_primary_variables[GFrac] - dx3_limited;
@@ -917,17 +976,17 @@ namespace Opm
     StandardWell<TypeTag>::
     processFractions() const
     {
-        assert(FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx));
+        assert(phaseIsActive(FluidSystem::oilPhaseIdx));
         const auto pu = phaseUsage();
         std::vector<double> F(number_of_phases_, 0.0);
         F[pu.phase_pos[Oil]] = 1.0;
 
-        if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+        if (phaseIsActive(FluidSystem::waterPhaseIdx)) {
             F[pu.phase_pos[Water]] = primary_variables_[WFrac];
             F[pu.phase_pos[Oil]] -= F[pu.phase_pos[Water]];
         }
 
-        if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+        if (phaseIsActive(FluidSystem::gasPhaseIdx)) {
             F[pu.phase_pos[Gas]] = primary_variables_[GFrac];
             F[pu.phase_pos[Oil]] -= F[pu.phase_pos[Gas]];
         }
@@ -938,9 +997,9 @@ namespace Opm
             F[pu.phase_pos[Oil]] -= F_solvent;
         }
 
-        if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+        if (phaseIsActive(FluidSystem::waterPhaseIdx)) {
             if (F[Water] < 0.0) {
-                if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+                if (phaseIsActive(FluidSystem::gasPhaseIdx)) {
                         F[pu.phase_pos[Gas]] /= (1.0 - F[pu.phase_pos[Water]]);
                 }
                 if (has_solvent) {
@@ -951,9 +1010,9 @@ namespace Opm
             }
         }
 
-        if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+        if (phaseIsActive(FluidSystem::gasPhaseIdx)) {
             if (F[pu.phase_pos[Gas]] < 0.0) {
-                if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+                if (phaseIsActive(FluidSystem::waterPhaseIdx)) {
                     F[pu.phase_pos[Water]] /= (1.0 - F[pu.phase_pos[Gas]]);
                 }
                 if (has_solvent) {
@@ -965,10 +1024,10 @@ namespace Opm
         }
 
         if (F[pu.phase_pos[Oil]] < 0.0) {
-            if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+            if (phaseIsActive(FluidSystem::waterPhaseIdx)) {
                 F[pu.phase_pos[Water]] /= (1.0 - F[pu.phase_pos[Oil]]);
             }
-            if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+            if (phaseIsActive(FluidSystem::gasPhaseIdx)) {
                 F[pu.phase_pos[Gas]] /= (1.0 - F[pu.phase_pos[Oil]]);
             }
             if (has_solvent) {
@@ -977,10 +1036,10 @@ namespace Opm
             F[pu.phase_pos[Oil]] = 0.0;
         }
 
-        if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+        if (phaseIsActive(FluidSystem::waterPhaseIdx)) {
             primary_variables_[WFrac] = F[pu.phase_pos[Water]];
         }
-        if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+        if (phaseIsActive(FluidSystem::gasPhaseIdx)) {
             primary_variables_[GFrac] = F[pu.phase_pos[Gas]];
         }
         if(has_solvent) {
@@ -998,19 +1057,19 @@ namespace Opm
     updateWellStateFromPrimaryVariables(WellState& well_state) const
     {
         const PhaseUsage& pu = phaseUsage();
-        assert( FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx) );
+        assert( phaseIsActive(FluidSystem::oilPhaseIdx) );
         const int oil_pos = pu.phase_pos[Oil];
 
         std::vector<double> F(number_of_phases_, 0.0);
         F[oil_pos] = 1.0;
 
-        if ( FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx) ) {
+        if ( phaseIsActive(FluidSystem::waterPhaseIdx) ) {
             const int water_pos = pu.phase_pos[Water];
             F[water_pos] = primary_variables_[WFrac];
             F[oil_pos] -= F[water_pos];
         }
 
-        if ( FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx) ) {
+        if ( phaseIsActive(FluidSystem::gasPhaseIdx) ) {
             const int gas_pos = pu.phase_pos[Gas];
             F[gas_pos] = primary_variables_[GFrac];
             F[oil_pos] -= F[gas_pos];
@@ -1087,13 +1146,13 @@ namespace Opm
             std::vector<double> rates(3, 0.0);
 
             const Opm::PhaseUsage& pu = phaseUsage();
-            if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+            if (phaseIsActive(FluidSystem::waterPhaseIdx)) {
                 rates[ Water ] = well_state.wellRates()[index_of_well_ * number_of_phases_ + pu.phase_pos[ Water ] ];
             }
-            if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx)) {
+            if (phaseIsActive(FluidSystem::oilPhaseIdx)) {
                 rates[ Oil ] = well_state.wellRates()[index_of_well_ * number_of_phases_ + pu.phase_pos[ Oil ] ];
             }
-            if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+            if (phaseIsActive(FluidSystem::gasPhaseIdx)) {
                 rates[ Gas ] = well_state.wellRates()[index_of_well_ * number_of_phases_ + pu.phase_pos[ Gas ] ];
             }
 
@@ -1140,7 +1199,7 @@ namespace Opm
             } else { // go to BHP limit
                 assert(this->operability_status_.isOperableUnderBHPLimit() );
 
-                OpmLog::info("well " + name() + " can not work with THP target, switching to BHP control");
+                deferred_logger_.info("well " + name() + " can not work with THP target, switching to BHP control");
 
                 well_state.bhp()[well_index] = mostStrictBhpFromBhpLimits();
             }
@@ -1245,7 +1304,7 @@ namespace Opm
             // calculating the b for the connection
             std::vector<double> b_perf(num_components_);
             for (size_t phase = 0; phase < FluidSystem::numPhases; ++phase) {
-                if (!FluidSystem::phaseIsActive(phase)) {
+                if (!phaseIsActive(phase)) {
                     continue;
                 }
                 const unsigned comp_idx = Indices::canonicalToActiveComponentIndex(FluidSystem::solventComponentIndex(phase));
@@ -1260,7 +1319,7 @@ namespace Opm
             // it should not be negative anyway. If it is negative, we might need to re-formulate
             // to taking into consideration the crossflow here.
             if (pressure_diff <= 0.) {
-                OpmLog::warning("NON_POSITIVE_DRAWDOWN_IPR",
+                deferred_logger_.warning("NON_POSITIVE_DRAWDOWN_IPR",
                                 "non-positive drawdown found when updateIPR for well " + name());
             }
 
@@ -1279,7 +1338,7 @@ namespace Opm
             }
 
             // we need to handle the rs and rv when both oil and gas are present
-            if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx) && FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+            if (phaseIsActive(FluidSystem::oilPhaseIdx) && phaseIsActive(FluidSystem::gasPhaseIdx)) {
                 const unsigned oil_comp_idx = Indices::canonicalToActiveComponentIndex(FluidSystem::oilCompIdx);
                 const unsigned gas_comp_idx = Indices::canonicalToActiveComponentIndex(FluidSystem::gasCompIdx);
                 const double rs = (fs.Rs()).value();
@@ -1332,9 +1391,9 @@ namespace Opm
         const bool well_operable = this->operability_status_.isOperable();
 
         if (!well_operable && old_well_operable) {
-            OpmLog::info(" well " + name() + " gets SHUT during iteration ");
+            deferred_logger_.info(" well " + name() + " gets SHUT during iteration ");
         } else if (well_operable && !old_well_operable) {
-            OpmLog::info(" well " + name() + " gets REVIVED during iteration ");
+            deferred_logger_.info(" well " + name() + " gets REVIVED during iteration ");
         }
     }
 
@@ -1437,12 +1496,12 @@ namespace Opm
                                         + " bars is SMALLER than thp limit "
                                         + std::to_string(unit::convert::to(thp_limit, unit::barsa))
                                         + " bars as a producer for well " + name();
-                OpmLog::debug(msg);
+                deferred_logger_.debug(msg);
             }
         } else {
             this->operability_status_.can_obtain_bhp_with_thp_limit = false;
             const double thp_limit = this->getTHPConstraint();
-            OpmLog::debug(" COULD NOT find bhp value under thp_limit "
+            deferred_logger_.debug(" COULD NOT find bhp value under thp_limit "
                           + std::to_string(unit::convert::to(thp_limit, unit::barsa))
                           + " bars for well " + name() + ", the well might need to be closed ");
             this->operability_status_.obey_bhp_limit_with_thp_limit = false;
@@ -1513,7 +1572,7 @@ namespace Opm
         }
 
         if (!can_produce_inject) {
-            OpmLog::debug(" well " + name() + " CANNOT produce or inejct ");
+            deferred_logger_.debug(" well " + name() + " CANNOT produce or inejct ");
         }
 
         return can_produce_inject;
@@ -1645,9 +1704,9 @@ namespace Opm
         surf_dens_perf.resize(nperf * num_components_);
         const int w = index_of_well_;
 
-        const bool waterPresent = FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx);
-        const bool oilPresent = FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx);
-        const bool gasPresent = FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx);
+        const bool waterPresent = phaseIsActive(FluidSystem::waterPhaseIdx);
+        const bool oilPresent = phaseIsActive(FluidSystem::oilPhaseIdx);
+        const bool gasPresent = phaseIsActive(FluidSystem::gasPhaseIdx);
 
         //rs and rv are only used if both oil and gas is present
         if (oilPresent && gasPresent) {
@@ -1727,7 +1786,7 @@ namespace Opm
 
             // Surface density.
             for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx) {
-                if (!FluidSystem::phaseIsActive(phaseIdx)) {
+                if (!phaseIsActive(phaseIdx)) {
                     continue;
                 }
 
@@ -1812,7 +1871,7 @@ namespace Opm
             x = mix;
 
             // Subtract dissolved gas from oil phase and vapporized oil from gas phase
-            if (FluidSystem::phaseIsActive(FluidSystem::gasCompIdx) && FluidSystem::phaseIsActive(FluidSystem::oilCompIdx)) {
+            if (phaseIsActive(FluidSystem::gasCompIdx) && phaseIsActive(FluidSystem::oilCompIdx)) {
                 const unsigned gaspos = Indices::canonicalToActiveComponentIndex(FluidSystem::gasCompIdx);
                 const unsigned oilpos = Indices::canonicalToActiveComponentIndex(FluidSystem::oilCompIdx);
                 double rs = 0.0;
@@ -1920,7 +1979,7 @@ namespace Opm
         CR::WellFailure::Type type = CR::WellFailure::Type::MassBalance;
         // checking if any NaN or too large residuals found
         for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx) {
-            if (!FluidSystem::phaseIsActive(phaseIdx)) {
+            if (!phaseIsActive(phaseIdx)) {
                 continue;
             }
 
@@ -2014,6 +2073,15 @@ namespace Opm
     computeWellConnectionPressures(const Simulator& ebosSimulator,
                                    const WellState& well_state)
     {
+         // The PVT evaluations are skipped if the inputs are (nearly) the same
+         // as in the last computation.
+         std::vector<double> inputs = connectionPressureInputs(ebosSimulator, well_state);
+         if (wellhelpers::withinRelativeTolerance(inputs, connection_pressure_inputs_,
+                                                  param_.connection_pressure_tolerance_)) {
+             return;
+         }
+         connection_pressure_inputs_ = std::move(inputs);
+
          // 1. Compute properties required by computeConnectionPressureDelta().
          //    Note that some of the complexity of this part is due to the function
          //    taking std::vector<double> arguments, and not Eigen objects.
@@ -2029,6 +2097,47 @@ namespace Opm
 
 
 
+    template<typename TypeTag>
+    std::vector<double>
+    StandardWell<TypeTag>::
+    connectionPressureInputs(const Simulator& ebosSimulator,
+                             const WellState& well_state) const
+    {
+        const int nperf = number_of_perforations_;
+        const int np = number_of_phases_;
+        const int w = index_of_well_;
+
+        std::vector<double> inputs;
+        inputs.reserve(1 + np + 1 + nperf * (np + 4));
+        inputs.push_back(well_state.bhp()[w]);
+        for (int p = 0; p < np; ++p) {
+            inputs.push_back(well_state.wellRates()[w * np + p]);
+        }
+        inputs.push_back(has_solvent ? well_state.solventWellRate(w) : 0.0);
+
+        for (int perf = 0; perf < nperf; ++perf) {
+            const int cell_idx = well_cells_[perf];
+            const auto& intQuants = *(ebosSimulator.model().cachedIntensiveQuantities(cell_idx, /*timeIdx=*/0));
+            inputs.push_back(well_state.perfPress()[first_perf_ + perf]);
+            inputs.push_back(intQuants.fluidState().temperature(FluidSystem::oilPhaseIdx).value());
+            for (int p = 0; p < np; ++p) {
+                inputs.push_back(well_state.perfPhaseRates()[(first_perf_ + perf) * np + p]);
+            }
+            if (has_solvent) {
+                inputs.push_back(well_state.perfRateSolvent()[first_perf_ + perf]);
+                inputs.push_back(intQuants.solventInverseFormationVolumeFactor().value());
+            } else {
+                inputs.push_back(0.0);
+                inputs.push_back(0.0);
+            }
+        }
+        return inputs;
+    }
+
+
+
+
+
     template<typename TypeTag>
     void
     StandardWell<TypeTag>::
@@ -2106,6 +2215,34 @@ namespace Opm
 
 
 
+    template<typename TypeTag>
+    template <class PackedWells>
+    void
+    StandardWell<TypeTag>::
+    addToPackedWells(PackedWells& packed_wells) const
+    {
+        if (!this->isOperable()) return;
+
+        if ( param_.matrix_add_well_contributions_ )
+        {
+            // Contributions are already in the matrix itself
+            return;
+        }
+
+        packed_wells.beginWell(invDuneD_[0][0]);
+
+        // duneB_ and duneC_ share the sparsity pattern
+        auto colC = duneC_[0].begin();
+        for (auto colB = duneB_[0].begin(), endB = duneB_[0].end(); colB != endB; ++colB, ++colC) {
+            assert(colB.index() == colC.index());
+            packed_wells.addPerforation(colB.index(), *colB, *colC);
+        }
+    }
+
+
+
+
+
     template<typename TypeTag>
     void
     StandardWell<TypeTag>::
@@ -2172,17 +2309,22 @@ namespace Opm
 
         const bool allow_cf = getAllowCrossFlow();
 
+        std::vector<EvalWell>& cmix_s = scratch_cmix_s_;
+        wellSurfaceVolumeFractions(cmix_s);
+        std::vector<EvalWell>& mob = scratch_mob_;
+        std::vector<EvalWell>& cq_s = scratch_cq_s_;
+
         for (int perf = 0; perf < number_of_perforations_; ++perf) {
             const int cell_idx = well_cells_[perf];
             const auto& intQuants = *(ebosSimulator.model().cachedIntensiveQuantities(cell_idx, /*timeIdx=*/ 0));
             // flux for each perforation
-            std::vector<EvalWell> mob(num_components_, 0.0);
+            std::fill(mob.begin(), mob.end(), 0.0);
             getMobility(ebosSimulator, perf, mob);
 
-            std::vector<EvalWell> cq_s(num_components_, 0.0);
+            std::fill(cq_s.begin(), cq_s.end(), 0.0);
             double perf_dis_gas_rate = 0.;
             double perf_vap_oil_rate = 0.;
-            computePerfRate(intQuants, mob, bhp, perf, allow_cf,
+            computePerfRate(intQuants, mob, bhp, cmix_s, perf, allow_cf,
                             cq_s, perf_dis_gas_rate, perf_vap_oil_rate);
 
             for(int p = 0; p < np; ++p) {
@@ -2235,13 +2377,13 @@ namespace Opm
                     const Opm::PhaseUsage& pu = phaseUsage();
 
                     std::vector<double> rates(3, 0.0);
-                    if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+                    if (phaseIsActive(FluidSystem::waterPhaseIdx)) {
                         rates[ Water ] = potentials[pu.phase_pos[ Water ] ];
                     }
-                    if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx)) {
+                    if (phaseIsActive(FluidSystem::oilPhaseIdx)) {
                         rates[ Oil ] = potentials[pu.phase_pos[ Oil ] ];
                     }
-                    if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+                    if (phaseIsActive(FluidSystem::gasPhaseIdx)) {
                         rates[ Gas ] = potentials[pu.phase_pos[ Gas ] ];
                     }
 
@@ -2388,10 +2530,10 @@ namespace Opm
         const auto pu = phaseUsage();
 
         if(std::abs(total_well_rate) > 0.) {
-            if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+            if (phaseIsActive(FluidSystem::waterPhaseIdx)) {
                 primary_variables_[WFrac] = scalingFactor(pu.phase_pos[Water]) * well_state.wellRates()[np*well_index + pu.phase_pos[Water]] / total_well_rate;
             }
-            if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+            if (phaseIsActive(FluidSystem::gasPhaseIdx)) {
                 primary_variables_[GFrac] = scalingFactor(pu.phase_pos[Gas]) * (well_state.wellRates()[np*well_index + pu.phase_pos[Gas]] - well_state.solventWellRate(well_index)) / total_well_rate ;
             }
             if (has_solvent) {
@@ -2400,7 +2542,7 @@ namespace Opm
         } else { // total_well_rate == 0
             if (well_type_ == INJECTOR) {
                 // only single phase injection handled
-                if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+                if (phaseIsActive(FluidSystem::waterPhaseIdx)) {
                     if (distr[Water] > 0.0) {
                         primary_variables_[WFrac] = 1.0;
                     } else {
@@ -2408,7 +2550,7 @@ namespace Opm
                     }
                 }
 
-                if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+                if (phaseIsActive(FluidSystem::gasPhaseIdx)) {
                     if (distr[pu.phase_pos[Gas]] > 0.0) {
                         primary_variables_[GFrac] = 1.0 - wsolvent();
                         if (has_solvent) {
@@ -2424,10 +2566,10 @@ namespace Opm
                 // this will happen.
             } else if (well_type_ == PRODUCER) { // producers
                 // TODO: the following are not addressed for the solvent case yet
-                if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+                if (phaseIsActive(FluidSystem::waterPhaseIdx)) {
                     primary_variables_[WFrac] = 1.0 / np;
                 }
-                if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+                if (phaseIsActive(FluidSystem::gasPhaseIdx)) {
                     primary_variables_[GFrac] = 1.0 / np;
                 }
             } else {
@@ -2477,14 +2619,14 @@ namespace Opm
 
             const double dp = wellhelpers::computeHydrostaticCorrection(ref_depth_, vfp_ref_depth, rho, gravity_);
 
-            bhp = vfp_properties_->getInj()->bhp(vfp, aqua, liquid, vapour, thp) - dp;
+            bhp = vfp_properties_->getInj()->bhp(vfp, aqua, liquid, vapour, thp, &vfp_interp_hint_) - dp;
          }
          else if (well_type_ == PRODUCER) {
              const double vfp_ref_depth = vfp_properties_->getProd()->getTable(vfp)->getDatumDepth();
 
              const double dp = wellhelpers::computeHydrostaticCorrection(ref_depth_, vfp_ref_depth, rho, gravity_);
 
-             bhp = vfp_properties_->getProd()->bhp(vfp, aqua, liquid, vapour, thp, alq) - dp;
+             bhp = vfp_properties_->getProd()->bhp(vfp, aqua, liquid, vapour, thp, alq, &vfp_interp_hint_) - dp;
          }
          else {
              OPM_THROW(std::logic_error, "Expected INJECTOR or PRODUCER well");
@@ -2573,9 +2715,11 @@ namespace Opm
             const EvalWell& bhp = getBhp();
 
             std::vector<EvalWell> cq_s(num_components_,0.0);
+            std::vector<EvalWell> cmix_s(num_components_);
+            wellSurfaceVolumeFractions(cmix_s);
             double perf_dis_gas_rate = 0.;
             double perf_vap_oil_rate = 0.;
-            computePerfRate(int_quant, mob, bhp, perf, allow_cf,
+            computePerfRate(int_quant, mob, bhp, cmix_s, perf, allow_cf,
                             cq_s, perf_dis_gas_rate, perf_vap_oil_rate);
             // TODO: make area a member
             const double area = 2 * M_PI * perf_rep_radius_[perf] * perf_length_[perf];
@@ -2680,17 +2824,17 @@ namespace Opm
         // 0.95 is a experimental value, which remains to be optimized
         double relaxation_factor = 1.0;
 
-        if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx)) {
+        if (phaseIsActive(FluidSystem::waterPhaseIdx)) {
             const double relaxation_factor_w = relaxationFactorFraction(primary_variables[WFrac], dwells[0][WFrac]);
             relaxation_factor = std::min(relaxation_factor, relaxation_factor_w);
         }
 
-        if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+        if (phaseIsActive(FluidSystem::gasPhaseIdx)) {
             const double relaxation_factor_g = relaxationFactorFraction(primary_variables[GFrac], dwells[0][GFrac]);
             relaxation_factor = std::min(relaxation_factor, relaxation_factor_g);
         }
 
-        if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx) && FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx)) {
+        if (phaseIsActive(FluidSystem::waterPhaseIdx) && phaseIsActive(FluidSystem::gasPhaseIdx)) {
             // We need to make sure the even with the relaxation_factor, the sum of F_w and F_g is below one, so there will
             // not be negative oil fraction later
             const double original_sum = primary_variables[WFrac] + primary_variables[GFrac];
@@ -2750,7 +2894,7 @@ namespace Opm
                         const double simulation_time, const int report_step, const bool terminal_output,
                         WellState& well_state, WellTestState& welltest_state, wellhelpers::WellSwitchingLogger& logger)
     {
-        OpmLog::debug(" well " + name() + " is being tested for physical limits");
+        deferred_logger_.debug(" well " + name() + " is being tested for physical limits");
 
         // some most difficult things are the explicit quantities, since there is no information
         // in the WellState to do a decent initialization
@@ -2773,7 +2917,7 @@ namespace Opm
 
         if ( !this->isOperable() ) {
             const std::string msg = " well " + name() + " is not operable during well testing for physical reason";
-            OpmLog::debug(msg);
+            deferred_logger_.debug(msg);
             return;
         }
 
@@ -2787,18 +2931,18 @@ namespace Opm
 
         if (!converged) {
             const std::string msg = " well " + name() + " did not get converged during well testing for physical reason";
-            OpmLog::debug(msg);
+            deferred_logger_.debug(msg);
             return;
         }
 
         if (this->isOperable() ) {
             welltest_state.openWell(name() );
             const std::string msg = " well " + name() + " is re-opened through well testing for physical reason";
-            OpmLog::info(msg);
+            deferred_logger_.info(msg);
             well_state = well_state_copy;
         } else {
             const std::string msg = " well " + name() + " is not operable during well testing for physical reason";
-            OpmLog::debug(msg);
+            deferred_logger_.debug(msg);
         }
     }
 
@@ -0,0 +1,200 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_TIMINGREGISTRY_HEADER_INCLUDED
+#define OPM_TIMINGREGISTRY_HEADER_INCLUDED
+
+#include <opm/autodiff/ProfilingMarkers.hpp>
+#include <opm/autodiff/TraceRecorder.hpp>
+
+#include <chrono>
+#include <deque>
+#include <iomanip>
+#include <mutex>
+#include <ostream>
+#include <string>
+
+namespace Opm
+{
+
+    /// \brief Accumulated wall clock times of labelled code sections.
+    ///
+    /// The sections of the linear solver stack (preconditioner setup, ILU
+    /// apply, SpMV, ...) register an entry once and add the time spent in
+    /// them using ScopedTiming. Measuring is off unless enabled, in which
+    /// case a ScopedTiming does not even read the clock. Each section is
+    /// also a region for an external profiler (see ProfilingMarkers.hpp)
+    /// and an event of the timeline of the TraceRecorder.
+    class TimingRegistry
+    {
+    public:
+        /// \brief The accumulated timing of one section.
+        struct Entry
+        {
+            explicit Entry(const std::string& l)
+                : label(l), seconds(0.0), calls(0), region(l)
+            {}
+            std::string label;
+            double seconds;
+            long calls;
+            ProfilingRegion region;
+        };
+
+        /// \brief The registry used by all sections.
+        static TimingRegistry& instance()
+        {
+            static TimingRegistry registry;
+            return registry;
+        }
+
+        /// \brief Get the entry for a label, creating it if needed.
+        ///
+        /// The reference stays valid for the life time of the registry.
+        /// Sections should look it up once (e.g. in a function local static)
+        /// as this involves a linear search.
+        Entry& entry(const std::string& label)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for ( auto& e : entries_ )
+            {
+                if ( e.label == label )
+                {
+                    return e;
+                }
+            }
+            entries_.emplace_back(label);
+            return entries_.back();
+        }
+
+        bool enabled() const
+        {
+            return enabled_;
+        }
+
+        void setEnabled(bool enabled)
+        {
+            enabled_ = enabled;
+        }
+
+        /// \brief Reset the accumulated times and calls of all entries.
+        void reset()
+        {
+            for ( auto& e : entries_ )
+            {
+                e.seconds = 0.0;
+                e.calls = 0;
+            }
+        }
+
+        /// \brief Print a table of all entries with calls.
+        void report(std::ostream& os) const
+        {
+            os << std::left << std::setw(30) << "Section" << std::right
+               << std::setw(12) << "Calls" << std::setw(14) << "Time (s)" << "\n";
+            for ( const auto& e : entries_ )
+            {
+                if ( e.calls > 0 )
+                {
+                    os << std::left << std::setw(30) << e.label << std::right
+                       << std::setw(12) << e.calls
+                       << std::setw(14) << std::fixed << std::setprecision(4) << e.seconds << "\n";
+                }
+            }
+        }
+
+        /// \brief Write a line "step,label,calls,seconds" for all entries with calls.
+        void writeCsv(std::ostream& os, int step) const
+        {
+            for ( const auto& e : entries_ )
+            {
+                if ( e.calls > 0 )
+                {
+                    os << step << "," << e.label << "," << e.calls << ","
+                       << std::setprecision(9) << e.seconds << "\n";
+                }
+            }
+        }
+
+    private:
+        TimingRegistry()
+            : enabled_(false)
+        {}
+
+        // deque to keep references to the entries valid.
+        std::deque<Entry> entries_;
+        std::mutex mutex_;
+        bool enabled_;
+    };
+
+    /// \brief Adds the wall clock time of its scope to an entry of the TimingRegistry,
+    ///        marks the scope as the region of the entry for an external profiler
+    ///        and records it as an event of the TraceRecorder.
+    ///
+    /// Usage:
+    /// \code
+    /// static auto& timing = TimingRegistry::instance().entry("ilu.apply");
+    /// ScopedTiming scopedTiming(timing);
+    /// \endcode
+    class ScopedTiming
+    {
+    public:
+        explicit ScopedTiming(TimingRegistry::Entry& entry)
+            : entry_(TimingRegistry::instance().enabled() ? &entry : nullptr)
+            , trace_(TraceRecorder::instance().enabled() ? &entry.label : nullptr)
+            , region_(entry.region)
+        {
+            region_.begin();
+            if ( entry_ || trace_ )
+            {
+                start_ = std::chrono::steady_clock::now();
+            }
+        }
+
+        ~ScopedTiming()
+        {
+            if ( entry_ || trace_ )
+            {
+                const auto end = std::chrono::steady_clock::now();
+                if ( entry_ )
+                {
+                    const std::chrono::duration<double> elapsed = end - start_;
+                    entry_->seconds += elapsed.count();
+                    ++entry_->calls;
+                }
+                if ( trace_ )
+                {
+                    TraceRecorder::instance().record(*trace_, start_, end);
+                }
+            }
+            region_.end();
+        }
+
+        ScopedTiming(const ScopedTiming&) = delete;
+        ScopedTiming& operator=(const ScopedTiming&) = delete;
+
+    private:
+        TimingRegistry::Entry* entry_;
+        const std::string* trace_;
+        const ProfilingRegion& region_;
+        std::chrono::steady_clock::time_point start_;
+    };
+
+} // namespace Opm
+
+#endif // OPM_TIMINGREGISTRY_HEADER_INCLUDED
@@ -0,0 +1,178 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_TRACERECORDER_HEADER_INCLUDED
+#define OPM_TRACERECORDER_HEADER_INCLUDED
+
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <iomanip>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace Opm
+{
+
+    /// \brief A timeline of the sections of the TimingRegistry.
+    ///
+    /// While enabled, every ScopedTiming appends its start and end time to a
+    /// buffer of its thread, which involves neither a lock nor any formatting.
+    /// The buffers are formatted as Chrome trace events at the end of the run,
+    /// which chrome://tracing and the Perfetto UI show as one row per process
+    /// and thread. The names of the events are the labels of the entries of
+    /// the TimingRegistry, which live as long as the registry.
+    class TraceRecorder
+    {
+    public:
+        typedef std::chrono::steady_clock Clock;
+
+        /// \brief The recorder used by all sections.
+        static TraceRecorder& instance()
+        {
+            static TraceRecorder recorder;
+            return recorder;
+        }
+
+        bool enabled() const
+        {
+            return enabled_;
+        }
+
+        /// \brief Start or stop recording. The times of the events are taken
+        ///        relative to the first start.
+        /// \param maxEventsPerThread Further events of a thread are dropped.
+        void setEnabled(const bool enabled, const std::size_t maxEventsPerThread = 10000000)
+        {
+            if ( enabled && !started_ )
+            {
+                epoch_ = Clock::now();
+                started_ = true;
+            }
+            maxEvents_ = maxEventsPerThread;
+            enabled_ = enabled;
+        }
+
+        /// \brief Record an event of the calling thread.
+        void record(const std::string& name, const Clock::time_point start, const Clock::time_point end)
+        {
+            Buffer& buffer = threadBuffer_();
+            if ( buffer.events.size() < maxEvents_ )
+            {
+                buffer.events.push_back(Event{ &name, start, end });
+            }
+            else
+            {
+                ++buffer.dropped;
+            }
+        }
+
+        /// \brief The number of events dropped because a buffer was full.
+        std::size_t dropped() const
+        {
+            std::size_t result = 0;
+            for ( const auto& buffer : buffers_ )
+            {
+                result += buffer.dropped;
+            }
+            return result;
+        }
+
+        /// \brief The recorded events of all threads as comma separated Chrome
+        ///        trace events of a process, with the times in microseconds.
+        std::string events(const int pid) const
+        {
+            std::ostringstream os;
+            os << std::fixed << std::setprecision(3)
+               << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << pid
+               << ",\"args\":{\"name\":\"rank " << pid << "\"}}";
+            for ( const auto& buffer : buffers_ )
+            {
+                for ( const auto& event : buffer.events )
+                {
+                    const std::chrono::duration<double, std::micro> start = event.start - epoch_;
+                    const std::chrono::duration<double, std::micro> duration = event.end - event.start;
+                    os << ",\n{\"name\":\"" << *event.name << "\",\"ph\":\"X\",\"ts\":" << start.count()
+                       << ",\"dur\":" << duration.count() << ",\"pid\":" << pid << ",\"tid\":" << buffer.thread << "}";
+                }
+            }
+            return os.str();
+        }
+
+        /// \brief Write a trace file of the events of several processes.
+        static void writeTrace(std::ostream& os, const std::vector<std::string>& processEvents)
+        {
+            os << "{\"traceEvents\":[\n";
+            bool first = true;
+            for ( const auto& events : processEvents )
+            {
+                if ( !events.empty() )
+                {
+                    os << (first ? "" : ",\n") << events;
+                    first = false;
+                }
+            }
+            os << "\n],\"displayTimeUnit\":\"ms\"}\n";
+        }
+
+    private:
+        struct Event
+        {
+            const std::string* name;
+            Clock::time_point start;
+            Clock::time_point end;
+        };
+
+        struct Buffer
+        {
+            int thread = 0;
+            std::vector<Event> events;
+            std::size_t dropped = 0;
+        };
+
+        TraceRecorder() = default;
+
+        Buffer& threadBuffer_()
+        {
+            thread_local Buffer* buffer = nullptr;
+            if ( !buffer )
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                buffers_.emplace_back();
+                buffers_.back().thread = buffers_.size() - 1;
+                buffer = &buffers_.back();
+            }
+            return *buffer;
+        }
+
+        // deque to keep the buffers of the threads in place.
+        std::deque<Buffer> buffers_;
+        std::mutex mutex_;
+        bool enabled_ = false;
+        bool started_ = false;
+        std::size_t maxEvents_ = 0;
+        Clock::time_point epoch_;
+    };
+
+} // namespace Opm
+
+#endif // OPM_TRACERECORDER_HEADER_INCLUDED
@@ -23,7 +23,13 @@
 
 #include <opm/common/OpmLog/OpmLog.hpp>
 
+#include <algorithm>
+#include <array>
+#include <cassert>
 #include <cmath>
+#include <cstddef>
+#include <map>
+#include <vector>
 #include <opm/common/ErrorMacros.hpp>
 #include <opm/parser/eclipse/EclipseState/Schedule/VFPProdTable.hpp>
 #include <opm/parser/eclipse/EclipseState/Schedule/VFPInjTable.hpp>
@@ -197,6 +203,44 @@ struct InterpData {
 
 
 
+/**
+ * The lower indices of the intervals of the last interpolation on the axes
+ * of a table (FLO, THP, WFR, GFR, ALQ), as a first guess for the next one
+ */
+struct InterpHint {
+    int ind_[5] = {0, 0, 0, 0, 0};
+};
+
+
+
+
+
+
+/**
+ * Helper function to set the interpolation ratio of the interval of retval
+ */
+inline void setInterpFactor(const double& value, const std::vector<double>& values, InterpData& retval) {
+    const double start = values[retval.ind_[0]];
+    const double end   = values[retval.ind_[1]];
+
+    //Find interpolation ratio
+    if (end > start) {
+        //FIXME: Possible source for floating point error here if value and floor are large,
+        //but very close to each other
+        retval.inv_dist_ = 1.0 / (end-start);
+        retval.factor_ = (value-start) * retval.inv_dist_;
+    }
+    else {
+        retval.inv_dist_ = 0.0;
+        retval.factor_ = 0.0;
+    }
+}
+
+
+
+
+
+
 /**
  * Helper function to find indices etc. for linear interpolation and extrapolation
  *  @param value Value to find in values
@@ -228,32 +272,36 @@ inline InterpData findInterpData(const double& value, const std::vector<double>&
             retval.ind_[1] = nvalues-1;
         }
         else {
-            //Search internal intervals
-            for (int i=1; i<nvalues; ++i) {
-                if (values[i] >= value) {
-                    retval.ind_[0] = i-1;
-                    retval.ind_[1] = i;
-                    break;
-                }
-            }
+            //Search internal intervals for the first value greater than or equal to value
+            const int i = std::lower_bound(values.begin() + 1, values.end(), value) - values.begin();
+            retval.ind_[0] = i-1;
+            retval.ind_[1] = i;
         }
 
-        const double start = values[retval.ind_[0]];
-        const double end   = values[retval.ind_[1]];
+        setInterpFactor(value, values, retval);
+    }
 
-        //Find interpolation ratio
-        if (end > start) {
-            //FIXME: Possible source for floating point error here if value and floor are large,
-            //but very close to each other
-            retval.inv_dist_ = 1.0 / (end-start);
-            retval.factor_ = (value-start) * retval.inv_dist_;
-        }
-        else {
-            retval.inv_dist_ = 0.0;
-            retval.factor_ = 0.0;
-        }
+    return retval;
+}
+
+/**
+ * As findInterpData(value, values), but first tries the interval starting at
+ * hint, e.g. the one of the last call, and sets hint to the interval found.
+ */
+inline InterpData findInterpData(const double& value, const std::vector<double>& values, int& hint) {
+    const int nvalues = values.size();
+    if (nvalues > 1 && hint >= 0 && hint < nvalues-1
+        && value >= values.front() && value < values.back()
+        && values[hint+1] >= value && (hint == 0 || values[hint] < value)) {
+        InterpData retval;
+        retval.ind_[0] = hint;
+        retval.ind_[1] = hint+1;
+        setInterpFactor(value, values, retval);
+        return retval;
     }
 
+    const InterpData retval = findInterpData(value, values);
+    hint = retval.ind_[0];
     return retval;
 }
 
@@ -319,114 +367,110 @@ inline VFPEvaluation operator*(
 
 /**
  * Helper function which interpolates data using the indices etc. given in the inputs.
+ * The array is typically a VFPProdTable::array_type, but may hold the table in
+ * another precision, e.g. in float. The interpolation is always done in double.
  */
+template <class Array>
 inline VFPEvaluation interpolate(
-        const VFPProdTable::array_type& array,
+        const Array& array,
         const InterpData& flo_i,
         const InterpData& thp_i,
         const InterpData& wfr_i,
         const InterpData& gfr_i,
         const InterpData& alq_i) {
 
-    //Values and derivatives in a 5D hypercube
-    VFPEvaluation nn[2][2][2][2][2];
-
-
-    //Pick out nearest neighbors (nn) to our evaluation point
-    //This is not really required, but performance-wise it may pay off, since the 32-elements
-    //we copy to (nn) will fit better in cache than the full original table for the
-    //interpolation below.
-    //The following ladder of for loops will presumably be unrolled by a reasonable compiler.
-    for (int t=0; t<=1; ++t) {
-        for (int w=0; w<=1; ++w) {
-            for (int g=0; g<=1; ++g) {
-                for (int a=0; a<=1; ++a) {
-                    for (int f=0; f<=1; ++f) {
-                        //Shorthands for indexing
-                        const int ti = thp_i.ind_[t];
-                        const int wi = wfr_i.ind_[w];
-                        const int gi = gfr_i.ind_[g];
-                        const int ai = alq_i.ind_[a];
-                        const int fi = flo_i.ind_[f];
-
-                        //Copy element
-                        nn[t][w][g][a][f].value = array[ti][wi][gi][ai][fi];
-                    }
-                }
-            }
-        }
-    }
-
-    //Calculate derivatives
-    //Note that the derivative of the two end points of a line aligned with the
-    //"axis of the derivative" are equal
-    for (int i=0; i<=1; ++i) {
-        for (int j=0; j<=1; ++j) {
-            for (int k=0; k<=1; ++k) {
-                for (int l=0; l<=1; ++l) {
-                    nn[0][i][j][k][l].dthp = (nn[1][i][j][k][l].value - nn[0][i][j][k][l].value) * thp_i.inv_dist_;
-                    nn[i][0][j][k][l].dwfr = (nn[i][1][j][k][l].value - nn[i][0][j][k][l].value) * wfr_i.inv_dist_;
-                    nn[i][j][0][k][l].dgfr = (nn[i][j][1][k][l].value - nn[i][j][0][k][l].value) * gfr_i.inv_dist_;
-                    nn[i][j][k][0][l].dalq = (nn[i][j][k][1][l].value - nn[i][j][k][0][l].value) * alq_i.inv_dist_;
-                    nn[i][j][k][l][0].dflo = (nn[i][j][k][l][1].value - nn[i][j][k][l][0].value) * flo_i.inv_dist_;
-
-                    nn[1][i][j][k][l].dthp = nn[0][i][j][k][l].dthp;
-                    nn[i][1][j][k][l].dwfr = nn[i][0][j][k][l].dwfr;
-                    nn[i][j][1][k][l].dgfr = nn[i][j][0][k][l].dgfr;
-                    nn[i][j][k][1][l].dalq = nn[i][j][k][0][l].dalq;
-                    nn[i][j][k][l][1].dflo = nn[i][j][k][l][0].dflo;
-                }
-            }
-        }
-    }
-
+    //Remove the dimensions of the 5D hypercube one by one, from the FLO axis to
+    //the THP axis. The derivative along an axis is the difference of the two
+    //faces of the hypercube across that axis, interpolated along the
+    //remaining axes, hence it is only formed when its axis is removed, and
+    //only the derivatives of the removed axes are carried along. The 32
+    //values of the hypercube are read directly from the table.
     double t1, t2; //interpolation variables, so that t1 = (1-t) and t2 = t.
 
-    // Remove dimensions one by one
-    // Example: going from 3D to 2D to 1D, we start by interpolating along
-    // the z axis first, leaving a 2D problem. Then interpolating along the y
-    // axis, leaving a 1D, problem, etc.
+    //Values and FLO derivatives after removing the FLO axis
+    double v4[2][2][2][2];
+    double dflo4[2][2][2][2];
     t2 = flo_i.factor_;
     t1 = (1.0-t2);
     for (int t=0; t<=1; ++t) {
         for (int w=0; w<=1; ++w) {
             for (int g=0; g<=1; ++g) {
                 for (int a=0; a<=1; ++a) {
-                    nn[t][w][g][a][0] = t1*nn[t][w][g][a][0] + t2*nn[t][w][g][a][1];
+                    //Shorthands for indexing
+                    const int ti = thp_i.ind_[t];
+                    const int wi = wfr_i.ind_[w];
+                    const int gi = gfr_i.ind_[g];
+                    const int ai = alq_i.ind_[a];
+
+                    const double lo = static_cast<double>(array[ti][wi][gi][ai][flo_i.ind_[0]]);
+                    const double hi = static_cast<double>(array[ti][wi][gi][ai][flo_i.ind_[1]]);
+                    v4[t][w][g][a] = t1*lo + t2*hi;
+                    dflo4[t][w][g][a] = (hi - lo) * flo_i.inv_dist_;
                 }
             }
         }
     }
 
+    //Remove the ALQ axis
+    double v3[2][2][2];
+    double dflo3[2][2][2];
+    double dalq3[2][2][2];
     t2 = alq_i.factor_;
     t1 = (1.0-t2);
     for (int t=0; t<=1; ++t) {
         for (int w=0; w<=1; ++w) {
             for (int g=0; g<=1; ++g) {
-                nn[t][w][g][0][0] = t1*nn[t][w][g][0][0] + t2*nn[t][w][g][1][0];
+                v3[t][w][g] = t1*v4[t][w][g][0] + t2*v4[t][w][g][1];
+                dflo3[t][w][g] = t1*dflo4[t][w][g][0] + t2*dflo4[t][w][g][1];
+                dalq3[t][w][g] = (v4[t][w][g][1] - v4[t][w][g][0]) * alq_i.inv_dist_;
             }
         }
     }
 
+    //Remove the GFR axis
+    double v2[2][2];
+    double dflo2[2][2];
+    double dalq2[2][2];
+    double dgfr2[2][2];
     t2 = gfr_i.factor_;
     t1 = (1.0-t2);
     for (int t=0; t<=1; ++t) {
         for (int w=0; w<=1; ++w) {
-            nn[t][w][0][0][0] = t1*nn[t][w][0][0][0] + t2*nn[t][w][1][0][0];
+            v2[t][w] = t1*v3[t][w][0] + t2*v3[t][w][1];
+            dflo2[t][w] = t1*dflo3[t][w][0] + t2*dflo3[t][w][1];
+            dalq2[t][w] = t1*dalq3[t][w][0] + t2*dalq3[t][w][1];
+            dgfr2[t][w] = (v3[t][w][1] - v3[t][w][0]) * gfr_i.inv_dist_;
         }
     }
 
+    //Remove the WFR axis
+    double v1[2];
+    double dflo1[2];
+    double dalq1[2];
+    double dgfr1[2];
+    double dwfr1[2];
     t2 = wfr_i.factor_;
     t1 = (1.0-t2);
     for (int t=0; t<=1; ++t) {
-        nn[t][0][0][0][0] = t1*nn[t][0][0][0][0] + t2*nn[t][1][0][0][0];
+        v1[t] = t1*v2[t][0] + t2*v2[t][1];
+        dflo1[t] = t1*dflo2[t][0] + t2*dflo2[t][1];
+        dalq1[t] = t1*dalq2[t][0] + t2*dalq2[t][1];
+        dgfr1[t] = t1*dgfr2[t][0] + t2*dgfr2[t][1];
+        dwfr1[t] = (v2[t][1] - v2[t][0]) * wfr_i.inv_dist_;
     }
 
+    //Remove the THP axis
+    VFPEvaluation retval;
     t2 = thp_i.factor_;
     t1 = (1.0-t2);
-    nn[0][0][0][0][0] = t1*nn[0][0][0][0][0] + t2*nn[1][0][0][0][0];
+    retval.value = t1*v1[0] + t2*v1[1];
+    retval.dflo = t1*dflo1[0] + t2*dflo1[1];
+    retval.dalq = t1*dalq1[0] + t2*dalq1[1];
+    retval.dgfr = t1*dgfr1[0] + t2*dgfr1[1];
+    retval.dwfr = t1*dwfr1[0] + t2*dwfr1[1];
+    retval.dthp = (v1[1] - v1[0]) * thp_i.inv_dist_;
 
-    return nn[0][0][0][0][0];
+    return retval;
 }
 
 
@@ -437,8 +481,9 @@ inline VFPEvaluation interpolate(
  * This basically models interpolate(VFPProdTable::array_type, ...)
  * which performs 5D interpolation, but here for the 2D case only
  */
+template <class Array>
 inline VFPEvaluation interpolate(
-        const VFPInjTable::array_type& array,
+        const Array& array,
         const InterpData& flo_i,
         const InterpData& thp_i) {
 
@@ -455,7 +500,7 @@ inline VFPEvaluation interpolate(
             const int fi = flo_i.ind_[f];
 
             //Copy element
-            nn[t][f].value = array[ti][fi];
+            nn[t][f].value = static_cast<double>(array[ti][fi]);
         }
     }
 
@@ -497,7 +542,8 @@ inline VFPEvaluation bhp(const VFPProdTable* table,
         const double& liquid,
         const double& vapour,
         const double& thp,
-        const double& alq) {
+        const double& alq,
+        InterpHint* hint = nullptr) {
     //Find interpolation variables
     double flo = detail::getFlo(aqua, liquid, vapour, table->getFloType());
     double wfr = detail::getWFR(aqua, liquid, vapour, table->getWFRType());
@@ -505,11 +551,13 @@ inline VFPEvaluation bhp(const VFPProdTable* table,
 
     //First, find the values to interpolate between
     //Recall that flo is negative in Opm, so switch sign.
-    auto flo_i = detail::findInterpData(-flo, table->getFloAxis());
-    auto thp_i = detail::findInterpData( thp, table->getTHPAxis());
-    auto wfr_i = detail::findInterpData( wfr, table->getWFRAxis());
-    auto gfr_i = detail::findInterpData( gfr, table->getGFRAxis());
-    auto alq_i = detail::findInterpData( alq, table->getALQAxis());
+    InterpHint local_hint;
+    auto& h = hint ? *hint : local_hint;
+    auto flo_i = detail::findInterpData(-flo, table->getFloAxis(), h.ind_[0]);
+    auto thp_i = detail::findInterpData( thp, table->getTHPAxis(), h.ind_[1]);
+    auto wfr_i = detail::findInterpData( wfr, table->getWFRAxis(), h.ind_[2]);
+    auto gfr_i = detail::findInterpData( gfr, table->getGFRAxis(), h.ind_[3]);
+    auto alq_i = detail::findInterpData( alq, table->getALQAxis(), h.ind_[4]);
 
     detail::VFPEvaluation retval = detail::interpolate(table->getTable(), flo_i, thp_i, wfr_i, gfr_i, alq_i);
 
@@ -524,13 +572,16 @@ inline VFPEvaluation bhp(const VFPInjTable* table,
         const double& aqua,
         const double& liquid,
         const double& vapour,
-        const double& thp) {
+        const double& thp,
+        InterpHint* hint = nullptr) {
     //Find interpolation variables
     double flo = detail::getFlo(aqua, liquid, vapour, table->getFloType());
 
     //First, find the values to interpolate between
-    auto flo_i = detail::findInterpData(flo, table->getFloAxis());
-    auto thp_i = detail::findInterpData(thp, table->getTHPAxis());
+    InterpHint local_hint;
+    auto& h = hint ? *hint : local_hint;
+    auto flo_i = detail::findInterpData(flo, table->getFloAxis(), h.ind_[0]);
+    auto thp_i = detail::findInterpData(thp, table->getTHPAxis(), h.ind_[1]);
 
     //Then perform the interpolation itself
     detail::VFPEvaluation retval = detail::interpolate(table->getTable(), flo_i, thp_i);
@@ -549,7 +600,7 @@ inline VFPEvaluation bhp(const VFPInjTable* table,
  * Returns the table from the map if found, or throws an exception
  */
 template <typename T>
-const T* getTable(const std::map<int, T*> tables, int table_id) {
+const T* getTable(const std::map<int, T*>& tables, int table_id) {
     auto entry = tables.find(table_id);
     if (entry == tables.end()) {
         OPM_THROW(std::invalid_argument, "Nonexistent VFP table " << table_id << " referenced.");
@@ -563,11 +614,49 @@ const T* getTable(const std::map<int, T*> tables, int table_id) {
  * Check whether we have a table with the table number
  */
 template <typename T>
-bool hasTable(const std::map<int, T*> tables, int table_id) {
+bool hasTable(const std::map<int, T*>& tables, int table_id) {
     const auto entry = tables.find(table_id);
     return (entry != tables.end() );
 }
 
+/**
+ * The tables of a map in a vector indexed by the table numbers, with null
+ * pointers for the missing numbers, for lookups without a map traversal
+ */
+template <typename T>
+std::vector<const T*> tableIndex(const std::map<int, const T*>& tables) {
+    std::vector<const T*> index;
+    for (const auto& table : tables) {
+        if (table.first < 0) {
+            OPM_THROW(std::invalid_argument, "Negative VFP table number " << table.first);
+        }
+        if (static_cast<std::size_t>(table.first) >= index.size()) {
+            index.resize(table.first + 1, nullptr);
+        }
+        index[table.first] = table.second;
+    }
+    return index;
+}
+
+/**
+ * Returns the table from the index of tableIndex() if found, or throws an exception
+ */
+template <typename T>
+const T* getTable(const std::vector<const T*>& index, int table_id) {
+    if (table_id < 0 || static_cast<std::size_t>(table_id) >= index.size() || index[table_id] == nullptr) {
+        OPM_THROW(std::invalid_argument, "Nonexistent VFP table " << table_id << " referenced.");
+    }
+    return index[table_id];
+}
+
+/**
+ * Check whether the index of tableIndex() has a table with the table number
+ */
+template <typename T>
+bool hasTable(const std::vector<const T*>& index, int table_id) {
+    return table_id >= 0 && static_cast<std::size_t>(table_id) < index.size() && index[table_id] != nullptr;
+}
+
 
 /**
  * Returns the type variable for FLO/GFR/WFR for production tables
@@ -803,8 +892,13 @@ inline bool findIntersection(const std::array<RateBhpPair, 2>& line_segment, con
     }
 }
 
-// calculating the BHP from thp through the intersection of VFP curves and inflow performance relationship
-inline bool findIntersectionForBhp(const std::vector<RateBhpPair>& ratebhp_samples,
+// calculating the BHP from thp through the intersection of VFP curves and inflow performance relationship,
+// with the VFP curve given by its bhp at sample rates. The bhp of a sample is only computed when needed:
+// as the intersection with the biggest rate is wanted, the samples are visited from the last one
+// and the search stops at the first intersecting segment
+template <class SampleBhp>
+inline bool findIntersectionForBhp(const std::vector<double>& rate_samples,
+                                   SampleBhp&& sample_bhp,
                                    const std::array<RateBhpPair, 2>& ratebhp_twopoints_ipr,
                                    double& obtained_bhp)
 {
@@ -826,32 +920,45 @@ inline bool findIntersectionForBhp(const std::vector<RateBhpPair>& ratebhp_sampl
         return bhp - bhp1 - line_slope * (flo_rate - rate1);
     };
 
-    int number_intersection_found = 0;
-    int index_segment = 0; // the intersection segment that intersection happens
-    const size_t num_samples = ratebhp_samples.size();
-    for (size_t i = 0; i < num_samples - 1; ++i) {
-        const double temp1 = flambda(ratebhp_samples[i].rate, ratebhp_samples[i].bhp);
-        const double temp2 = flambda(ratebhp_samples[i+1].rate, ratebhp_samples[i+1].bhp);
+    const std::size_t num_samples = rate_samples.size();
+    if (num_samples < 2) {
+        return false;
+    }
+
+    RateBhpPair upper{rate_samples[num_samples - 1], sample_bhp(num_samples - 1)};
+    double temp2 = flambda(upper.rate, upper.bhp);
+    for (std::size_t i = num_samples - 1; i-- > 0; ) {
+        const RateBhpPair lower{rate_samples[i], sample_bhp(i)};
+        const double temp1 = flambda(lower.rate, lower.bhp);
         if (temp1 * temp2 <= 0.) { // intersection happens
             // in theory there should be maximum two intersection points
             // while considering the situation == 0. here, we might find more
             // we always use the last one, which is the one corresponds to the biggest rate,
             // which we assume is the more stable one
-            ++number_intersection_found;
-            index_segment = i;
+            // then we pick the segment from the VFP curve to do the line intersection calculation
+            const std::array<RateBhpPair, 2> line_segment{ lower, upper };
+            return findIntersection(line_segment, ratebhp_twopoints_ipr, obtained_bhp);
         }
+        upper = lower;
+        temp2 = temp1;
     }
 
-    if (number_intersection_found == 0) { // there is not intersection point
-        return false;
-    }
-
-    // then we pick the segment from the VFP curve to do the line intersection calculation
-    const std::array<RateBhpPair, 2> line_segment{ ratebhp_samples[index_segment], ratebhp_samples[index_segment + 1] };
-
-    const bool intersection_found = findIntersection(line_segment, ratebhp_twopoints_ipr, obtained_bhp);
+    // there is not intersection point
+    return false;
+}
 
-    return intersection_found;
+// calculating the BHP from thp through the intersection of VFP curves and inflow performance relationship
+inline bool findIntersectionForBhp(const std::vector<RateBhpPair>& ratebhp_samples,
+                                   const std::array<RateBhpPair, 2>& ratebhp_twopoints_ipr,
+                                   double& obtained_bhp)
+{
+    std::vector<double> rate_samples(ratebhp_samples.size());
+    for (std::size_t i = 0; i < ratebhp_samples.size(); ++i) {
+        rate_samples[i] = ratebhp_samples[i].rate;
+    }
+    return findIntersectionForBhp(rate_samples,
+                                  [&ratebhp_samples](const std::size_t i) { return ratebhp_samples[i].bhp; },
+                                  ratebhp_twopoints_ipr, obtained_bhp);
 }
 
 
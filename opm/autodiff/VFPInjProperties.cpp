@@ -39,6 +39,7 @@ VFPInjProperties::VFPInjProperties() {
 
 VFPInjProperties::VFPInjProperties(const VFPInjTable* table){
     m_tables[table->getTableNum()] = table;
+    m_table_index = detail::tableIndex(m_tables);
 }
 
 
@@ -46,6 +47,7 @@ VFPInjProperties::VFPInjProperties(const VFPInjProperties::InjTable& tables) {
     for (const auto& table : tables) {
         m_tables[table.first] = table.second.get();
     }
+    m_table_index = detail::tableIndex(m_tables);
 }
 
 
@@ -53,10 +55,11 @@ double VFPInjProperties::bhp(int table_id,
                                  const double& aqua,
                                  const double& liquid,
                                  const double& vapour,
-                                 const double& thp_arg) const {
-    const VFPInjTable* table = detail::getTable(m_tables, table_id);
+                                 const double& thp_arg,
+                                 detail::InterpHint* hint) const {
+    const VFPInjTable* table = detail::getTable(m_table_index, table_id);
 
-    detail::VFPEvaluation retval = detail::bhp(table, aqua, liquid, vapour, thp_arg);
+    detail::VFPEvaluation retval = detail::bhp(table, aqua, liquid, vapour, thp_arg, hint);
     return retval.value;
 }
 
@@ -66,7 +69,7 @@ double VFPInjProperties::thp(int table_id,
                              const double& liquid,
                              const double& vapour,
                              const double& bhp_arg) const {
-    const VFPInjTable* table = detail::getTable(m_tables, table_id);
+    const VFPInjTable* table = detail::getTable(m_table_index, table_id);
     const VFPInjTable::array_type& data = table->getTable();
 
     //Find interpolation variables
@@ -92,11 +95,11 @@ double VFPInjProperties::thp(int table_id,
 }
 
 const VFPInjTable* VFPInjProperties::getTable(const int table_id) const {
-    return detail::getTable(m_tables, table_id);
+    return detail::getTable(m_table_index, table_id);
 }
 
 bool VFPInjProperties::hasTable(const int table_id) const {
-    return detail::hasTable(m_tables, table_id);
+    return detail::hasTable(m_table_index, table_id);
 }
 
 } //Namespace Opm
@@ -66,6 +66,8 @@ public:
      * @param liquid Oil phase
      * @param vapour Gas phase
      * @param thp Tubing head pressure
+     * @param hint If given, the intervals of the last call for the well, which
+     *             are tried first and updated.
      *
      * @return The bottom hole pressure, interpolated/extrapolated linearly using
      * the above parameters from the values in the input table, for each entry in the
@@ -76,10 +78,11 @@ public:
                  const EvalWell& aqua,
                  const EvalWell& liquid,
                  const EvalWell& vapour,
-                 const double& thp) const {
+                 const double& thp,
+                 detail::InterpHint* hint = nullptr) const {
 
         //Get the table
-        const VFPInjTable* table = detail::getTable(m_tables, table_id);
+        const VFPInjTable* table = detail::getTable(m_table_index, table_id);
         EvalWell bhp = 0.0 * aqua;
 
         //Find interpolation variables
@@ -89,8 +92,10 @@ public:
         if (table != nullptr) {
             //First, find the values to interpolate between
             //Value of FLO is negative in OPM for producers, but positive in VFP table
-            auto flo_i = detail::findInterpData(flo.value(), table->getFloAxis());
-            auto thp_i = detail::findInterpData( thp, table->getTHPAxis()); // assume constant
+            detail::InterpHint local_hint;
+            auto& h = hint ? *hint : local_hint;
+            auto flo_i = detail::findInterpData(flo.value(), table->getFloAxis(), h.ind_[0]);
+            auto thp_i = detail::findInterpData( thp, table->getTHPAxis(), h.ind_[1]); // assume constant
 
             detail::VFPEvaluation bhp_val = detail::interpolate(table->getTable(), flo_i, thp_i);
 
@@ -128,6 +133,8 @@ public:
      * @param liquid Oil phase
      * @param vapour Gas phase
      * @param thp Tubing head pressure
+     * @param hint If given, the intervals of the last call for the well, which
+     *             are tried first and updated.
      *
      * @return The bottom hole pressure, interpolated/extrapolated linearly using
      * the above parameters from the values in the input table.
@@ -136,7 +143,8 @@ public:
                const double& aqua,
                const double& liquid,
                const double& vapour,
-               const double& thp) const;
+               const double& thp,
+               detail::InterpHint* hint = nullptr) const;
 
     /**
      * Linear interpolation of thp as a function of the input parameters
@@ -158,6 +166,9 @@ public:
 protected:
     // Map which connects the table number with the table itself
     std::map<int, const VFPInjTable*> m_tables;
+
+    // The tables indexed by the table number, see detail::tableIndex()
+    std::vector<const VFPInjTable*> m_table_index;
 };
 
 
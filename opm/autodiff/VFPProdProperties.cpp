@@ -26,6 +26,9 @@
 #include <opm/material/densead/Evaluation.hpp>
 #include <opm/autodiff/VFPHelpers.hpp>
 
+#include <algorithm>
+#include <numeric>
+
 
 
 namespace Opm {
@@ -40,6 +43,7 @@ VFPProdProperties::VFPProdProperties() {
 
 VFPProdProperties::VFPProdProperties(const VFPProdTable* table){
     m_tables[table->getTableNum()] = table;
+    m_table_index = detail::tableIndex(m_tables);
 }
 
 
@@ -47,6 +51,7 @@ VFPProdProperties::VFPProdProperties(const VFPProdProperties::ProdTable& tables)
     for (const auto& table : tables) {
         m_tables[table.first] = table.second.get();
     }
+    m_table_index = detail::tableIndex(m_tables);
 }
 
 
@@ -56,7 +61,7 @@ double VFPProdProperties::thp(int table_id,
                               const double& vapour,
                               const double& bhp_arg,
                               const double& alq) const {
-    const VFPProdTable* table = detail::getTable(m_tables, table_id);
+    const VFPProdTable* table = detail::getTable(m_table_index, table_id);
     const VFPProdTable::array_type& data = table->getTable();
 
     //Find interpolation variables
@@ -93,55 +98,63 @@ double VFPProdProperties::bhp(int table_id,
                               const double& liquid,
                               const double& vapour,
                               const double& thp_arg,
-                              const double& alq) const {
-    const VFPProdTable* table = detail::getTable(m_tables, table_id);
+                              const double& alq,
+                              detail::InterpHint* hint) const {
+    const VFPProdTable* table = detail::getTable(m_table_index, table_id);
 
-    detail::VFPEvaluation retval = detail::bhp(table, aqua, liquid, vapour, thp_arg, alq);
+    detail::VFPEvaluation retval = detail::bhp(table, aqua, liquid, vapour, thp_arg, alq, hint);
     return retval.value;
 }
 
 
-const VFPProdTable* VFPProdProperties::getTable(const int table_id) const {
-    return detail::getTable(m_tables, table_id);
-}
-
-bool VFPProdProperties::hasTable(const int table_id) const {
-    return detail::hasTable(m_tables, table_id);
-}
-
-
-std::vector<double>
-VFPProdProperties::
-bhpwithflo(const std::vector<double>& flos,
-           const int table_id,
-           const double wfr,
-           const double gfr,
-           const double thp,
-           const double alq,
-           const double dp) const
-{
-    // Get the table
-    const VFPProdTable* table = detail::getTable(m_tables, table_id);
-    const auto thp_i = detail::findInterpData( thp, table->getTHPAxis()); // assume constant
-    const auto wfr_i = detail::findInterpData( wfr, table->getWFRAxis());
-    const auto gfr_i = detail::findInterpData( gfr, table->getGFRAxis());
-    const auto alq_i = detail::findInterpData( alq, table->getALQAxis()); //assume constant
-
-    std::vector<double> bhps(flos.size(), 0.);
-    for (size_t i = 0; i < flos.size(); ++i) {
-        // Value of FLO is negative in OPM for producers, but positive in VFP table
-        const auto flo_i = detail::findInterpData(-flos[i], table->getFloAxis());
-        const detail::VFPEvaluation bhp_val = detail::interpolate(table->getTable(), flo_i, thp_i, wfr_i, gfr_i, alq_i);
-
-        // TODO: this kind of breaks the conventions for the functions here by putting dp within the function
-        bhps[i] = bhp_val.value - dp;
+void VFPProdProperties::bhp(const std::vector<int>& table_id,
+                            const std::vector<double>& aqua,
+                            const std::vector<double>& liquid,
+                            const std::vector<double>& vapour,
+                            const std::vector<double>& thp_arg,
+                            const std::vector<double>& alq,
+                            std::vector<detail::VFPEvaluation>& bhp_arg,
+                            std::vector<detail::InterpHint>* hints) const {
+    const std::size_t num_wells = table_id.size();
+    if (aqua.size() != num_wells || liquid.size() != num_wells || vapour.size() != num_wells
+        || thp_arg.size() != num_wells || alq.size() != num_wells
+        || (hints != nullptr && hints->size() != num_wells)) {
+        OPM_THROW(std::invalid_argument, "The inputs of the batched VFP evaluation differ in size.");
     }
 
-    return bhps;
+    // The wells sorted by table, keeping the order of the wells of a table
+    std::vector<std::size_t> order(num_wells);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [&table_id](const std::size_t a, const std::size_t b) {
+                         return table_id[a] < table_id[b];
+                     });
+
+    bhp_arg.assign(num_wells, detail::VFPEvaluation());
+    const VFPProdTable* table = nullptr;
+    int last_id = -1;
+    for (const std::size_t w : order) {
+        if (table_id[w] < 0) {
+            bhp_arg[w].value = -1e100; //Signal that this value has not been calculated properly, due to "missing" table
+            continue;
+        }
+        if (table == nullptr || table_id[w] != last_id) {
+            table = detail::getTable(m_table_index, table_id[w]);
+            last_id = table_id[w];
+        }
+        detail::InterpHint* hint = hints ? &(*hints)[w] : nullptr;
+        bhp_arg[w] = detail::bhp(table, aqua[w], liquid[w], vapour[w], thp_arg[w], alq[w], hint);
+    }
 }
 
 
+const VFPProdTable* VFPProdProperties::getTable(const int table_id) const {
+    return detail::getTable(m_table_index, table_id);
+}
 
+bool VFPProdProperties::hasTable(const int table_id) const {
+    return detail::hasTable(m_table_index, table_id);
+}
 
 
 double
@@ -184,7 +197,7 @@ calculateBhpWithTHPTarget(const std::vector<double>& ipr_a,
     const int Oil = BlackoilPhases::Liquid;
     const int Gas = BlackoilPhases::Vapour;
 
-    const VFPProdTable* table = detail::getTable(m_tables, thp_table_id);
+    const VFPProdTable* table = detail::getTable(m_table_index, thp_table_id);
     const double aqua_bhp_limit = rates_bhp_limit[Water];
     const double liquid_bhp_limit = rates_bhp_limit[Oil];
     const double vapour_bhp_limit = rates_bhp_limit[Gas];
@@ -217,19 +230,29 @@ calculateBhpWithTHPTarget(const std::vector<double>& ipr_a,
         value = -value;
     }
 
-    // get the bhp sampling values based on the flo sample values
-    const std::vector<double> bhp_flo_samples = bhpwithflo(flo_samples, thp_table_id, wfr, gfr, thp_limit, alq, dp);
+    // the bhp sampling values based on the flo sample values, only computed for the samples
+    // visited by the search of the intersection
+    const auto thp_i = detail::findInterpData( thp_limit, table->getTHPAxis()); // assume constant
+    const auto wfr_i = detail::findInterpData( wfr, table->getWFRAxis());
+    const auto gfr_i = detail::findInterpData( gfr, table->getGFRAxis());
+    const auto alq_i = detail::findInterpData( alq, table->getALQAxis()); //assume constant
+    // the samples are visited in order, hence the interval of the last one is a good start
+    int flo_hint = table->getFloAxis().size();
+    auto bhp_flo_sample = [&](const std::size_t i) {
+        // Value of FLO is negative in OPM for producers, but positive in VFP table
+        const auto flo_i = detail::findInterpData(-flo_samples[i], table->getFloAxis(), flo_hint);
+        const detail::VFPEvaluation bhp_val = detail::interpolate(table->getTable(), flo_i, thp_i, wfr_i, gfr_i, alq_i);
 
-    std::vector<detail::RateBhpPair> ratebhp_samples;
-    for (size_t i = 0; i < flo_samples.size(); ++i) {
-        ratebhp_samples.push_back( detail::RateBhpPair{flo_samples[i], bhp_flo_samples[i]} );
-    }
+        // TODO: this kind of breaks the conventions for the functions here by putting dp within the function
+        return bhp_val.value - dp;
+    };
 
     const std::array<detail::RateBhpPair, 2> ratebhp_twopoints_ipr {detail::RateBhpPair{flo_bhp_middle, bhp_middle},
                                                                     detail::RateBhpPair{flo_bhp_limit, bhp_limit} };
 
     double obtain_bhp = 0.;
-    const bool can_obtain_bhp_with_thp_limit = detail::findIntersectionForBhp(ratebhp_samples, ratebhp_twopoints_ipr, obtain_bhp);
+    const bool can_obtain_bhp_with_thp_limit = detail::findIntersectionForBhp(flo_samples, bhp_flo_sample,
+                                                                                      ratebhp_twopoints_ipr, obtain_bhp);
 
     // \Note: assuming that negative BHP does not make sense
     if (can_obtain_bhp_with_thp_limit && obtain_bhp > 0.) {
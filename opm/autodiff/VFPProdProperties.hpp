@@ -71,6 +71,8 @@ public:
      * @param vapour Gas phase
      * @param thp Tubing head pressure
      * @param alq Artificial lift or other parameter
+     * @param hint If given, the intervals of the last call for the well, which
+     *             are tried first and updated.
      *
      * @return The bottom hole pressure, interpolated/extrapolated linearly using
      * the above parameters from the values in the input table, for each entry in the
@@ -82,10 +84,11 @@ public:
                  const EvalWell& liquid,
                  const EvalWell& vapour,
                  const double& thp,
-                 const double& alq) const {
+                 const double& alq,
+                 detail::InterpHint* hint = nullptr) const {
 
         //Get the table
-        const VFPProdTable* table = detail::getTable(m_tables, table_id);
+        const VFPProdTable* table = detail::getTable(m_table_index, table_id);
         EvalWell bhp = 0.0 * aqua;
 
         //Find interpolation variables
@@ -97,11 +100,13 @@ public:
         if (table != nullptr) {
             //First, find the values to interpolate between
             //Value of FLO is negative in OPM for producers, but positive in VFP table
-            auto flo_i = detail::findInterpData(-flo.value(), table->getFloAxis());
-            auto thp_i = detail::findInterpData( thp, table->getTHPAxis()); // assume constant
-            auto wfr_i = detail::findInterpData( wfr.value(), table->getWFRAxis());
-            auto gfr_i = detail::findInterpData( gfr.value(), table->getGFRAxis());
-            auto alq_i = detail::findInterpData( alq, table->getALQAxis()); //assume constant
+            detail::InterpHint local_hint;
+            auto& h = hint ? *hint : local_hint;
+            auto flo_i = detail::findInterpData(-flo.value(), table->getFloAxis(), h.ind_[0]);
+            auto thp_i = detail::findInterpData( thp, table->getTHPAxis(), h.ind_[1]); // assume constant
+            auto wfr_i = detail::findInterpData( wfr.value(), table->getWFRAxis(), h.ind_[2]);
+            auto gfr_i = detail::findInterpData( gfr.value(), table->getGFRAxis(), h.ind_[3]);
+            auto alq_i = detail::findInterpData( alq, table->getALQAxis(), h.ind_[4]); //assume constant
 
             detail::VFPEvaluation bhp_val = detail::interpolate(table->getTable(), flo_i, thp_i, wfr_i, gfr_i, alq_i);
 
@@ -122,6 +127,8 @@ public:
      * @param vapour Gas phase
      * @param thp Tubing head pressure
      * @param alq Artificial lift or other parameter
+     * @param hint If given, the intervals of the last call for the well, which
+     *             are tried first and updated.
      *
      * @return The bottom hole pressure, interpolated/extrapolated linearly using
      * the above parameters from the values in the input table.
@@ -131,7 +138,35 @@ public:
             const double& liquid,
             const double& vapour,
             const double& thp,
-            const double& alq) const;
+            const double& alq,
+            detail::InterpHint* hint = nullptr) const;
+
+    /**
+     * Linear interpolation of bhp for many wells in one call
+     * Each entry of the input vectors corresponds to one well. The wells are
+     * evaluated grouped by their table, such that the data of a table is
+     * reused while it is in the cache.
+     * @param table_id Table number of each well. A negative entry (e.g., -1)
+     *                 will indicate that no table is used, and the corresponding
+     *                 BHP will be -1e100 with zero derivatives.
+     * @param aqua Water phase
+     * @param liquid Oil phase
+     * @param vapour Gas phase
+     * @param thp Tubing head pressure
+     * @param alq Artificial lift or other parameter
+     * @param bhp The bottom hole pressure of each well, with its derivatives with
+     *            respect to the flo, thp, wfr, gfr and alq of the table of the well.
+     *            Note that the flo of the table is positive for producers.
+     * @param hints If given, one hint per well as for bhp() above.
+     */
+    void bhp(const std::vector<int>& table_id,
+             const std::vector<double>& aqua,
+             const std::vector<double>& liquid,
+             const std::vector<double>& vapour,
+             const std::vector<double>& thp,
+             const std::vector<double>& alq,
+             std::vector<detail::VFPEvaluation>& bhp,
+             std::vector<detail::InterpHint>* hints = nullptr) const;
 
     /**
      * Linear interpolation of thp as a function of the input parameters
@@ -185,17 +220,11 @@ public:
                                const double dp) const;
 
 protected:
-    // calculate a group bhp values with a group of flo rate values
-    std::vector<double> bhpwithflo(const std::vector<double>& flos,
-                                   const int table_id,
-                                   const double wfr,
-                                   const double gfr,
-                                   const double thp,
-                                   const double alq,
-                                   const double dp) const;
-
     // Map which connects the table number with the table itself
     std::map<int, const VFPProdTable*> m_tables;
+
+    // The tables indexed by the table number, see detail::tableIndex()
+    std::vector<const VFPProdTable*> m_table_index;
 };
 
 
@@ -27,8 +27,13 @@
 
 #include <opm/core/wells.h>
 
+#include <opm/autodiff/CartesianCellIndexMap.hpp>
+
 #include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
 
+#include <algorithm>
+#include <vector>
+
 namespace Opm
 {
 template<class TypeTag>
@@ -52,13 +57,7 @@ public:
 
         auto size = cartesianSize[0]*cartesianSize[1]*cartesianSize[2];
 
-        std::vector<int> cartesianToCompressed(size, -1);
-        auto begin = globalCell.begin();
-
-        for ( auto cell = begin, end= globalCell.end(); cell != end; ++cell )
-        {
-            cartesianToCompressed[ *cell ] = cell - begin;
-        }
+        const CartesianCellIndexMap cartesianToCompressed(size, globalCell.size(), globalCell.data());
 
         int last_time_step = schedule.getTimeMap().size() - 1;
         const auto& schedule_wells = schedule.getWells();
@@ -68,7 +67,8 @@ public:
         for ( const auto well : schedule_wells )
         {
             std::vector<int> compressed_well_perforations;
-            // All possible completions of the well
+            // All possible completions of the well, hence the pattern covers
+            // every state of the well the schedule opens or shuts later on.
             const auto& completionSet = well->getConnections(last_time_step);
             compressed_well_perforations.reserve(completionSet.size());
 
@@ -91,6 +91,9 @@ public:
             {
                 std::sort(compressed_well_perforations.begin(),
                           compressed_well_perforations.end());
+                compressed_well_perforations.erase(std::unique(compressed_well_perforations.begin(),
+                                                               compressed_well_perforations.end()),
+                                                   compressed_well_perforations.end());
 
                 wells_.push_back(compressed_well_perforations);
             }
@@ -105,7 +108,7 @@ public:
 
     void addNeighbors(std::vector<NeighborSet>& neighbors) const
     {
-        for(const auto well_perforations : wells_)
+        for(const auto& well_perforations : wells_)
         {
             for(const auto& perforation : well_perforations)
                 neighbors[perforation].insert(well_perforations.begin(),
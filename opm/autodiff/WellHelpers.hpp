@@ -25,6 +25,9 @@
 #include <opm/core/wells.h>
 // #include <opm/autodiff/AutoDiffHelpers.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
 #include <vector>
 
 namespace Opm {
@@ -35,6 +38,25 @@ namespace Opm {
     namespace wellhelpers
     {
 
+        /// Whether the values have the size of the reference values and each differs
+        /// from its reference value by at most the relative tolerance. Used to skip
+        /// recomputations whose inputs did not change.
+        inline
+        bool withinRelativeTolerance(const std::vector<double>& values,
+                                     const std::vector<double>& reference,
+                                     const double tolerance)
+        {
+            if (values.size() != reference.size()) {
+                return false;
+            }
+            for (std::size_t i = 0; i < values.size(); ++i) {
+                const double scale = std::max(std::abs(values[i]), std::abs(reference[i]));
+                if (!(std::abs(values[i] - reference[i]) <= tolerance * scale)) {
+                    return false;
+                }
+            }
+            return true;
+        }
 
         inline
         double rateToCompare(const std::vector<double>& well_phase_flow_rate,
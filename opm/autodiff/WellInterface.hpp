@@ -43,9 +43,13 @@
 #include <opm/autodiff/WellStateFullyImplicitBlackoil.hpp>
 #include <opm/autodiff/BlackoilModelParametersEbos.hpp>
 #include <opm/autodiff/RateConverter.hpp>
+#include <opm/autodiff/CartesianCellIndexMap.hpp>
+#include <opm/autodiff/ActivePhases.hpp>
+#include <opm/autodiff/MemoryRegistry.hpp>
 
 #include <opm/simulators/timestepping/ConvergenceReport.hpp>
 #include <opm/simulators/WellSwitchingLogger.hpp>
+#include <opm/simulators/DeferredLogger.hpp>
 
 #include<dune/common/fmatrix.hh>
 #include<dune/istl/bcrsmatrix.hh>
@@ -54,6 +58,8 @@
 #include <opm/material/densead/Math.hpp>
 #include <opm/material/densead/Evaluation.hpp>
 
+#include <algorithm>
+#include <cmath>
 #include <string>
 #include <memory>
 #include <vector>
@@ -106,6 +112,12 @@ namespace Opm
         // index for the polymer molecular weight continuity equation
         static const int contiPolymerMWEqIdx = Indices::contiPolymerMWEqIdx;
 
+        // whether a phase is active, false at compile time for the phase a two-phase model does not have
+        static bool phaseIsActive(const unsigned phaseIdx)
+        {
+            return ActivePhases<FluidSystem, Indices>::isActive(phaseIdx);
+        }
+
         // For the conversion between the surface volume rate and resrevoir voidage rate
         using RateConverterType = RateConverter::
         SurfaceToReservoirVoidage<FluidSystem, std::vector<int> >;
@@ -117,8 +129,20 @@ namespace Opm
                       const int pvtRegionIdx,
                       const int num_components);
 
-        /// Virutal destructor
-        virtual ~WellInterface() {}
+        /// Virutal destructor, writes the messages not logged yet.
+        virtual ~WellInterface()
+        {
+            logMessages();
+        }
+
+        /// Write the messages of the well to OpmLog and forget them.
+        /// The wells do not log directly, such that several wells can be
+        /// handled by concurrent threads (see BlackoilWellModel).
+        void logMessages() const
+        {
+            deferred_logger_.logMessages();
+            deferred_logger_.clearMessages();
+        }
 
         /// Well name.
         const std::string& name() const;
@@ -142,6 +166,12 @@ namespace Opm
                           const double gravity_arg,
                           const int num_cells);
 
+        /// Take over the well for the wells struct of a new time step, keeping
+        /// the data computed from its perforations (matrix patterns, depths, ...).
+        /// \return false if the well or its perforations changed, then the well
+        ///         has to be created anew and nothing is changed.
+        virtual bool rebind(const Well* well, const int time_step, const Wells* wells);
+
         virtual void initPrimaryVariablesEvaluation() const = 0;
 
         virtual ConvergenceReport getWellConvergence(const std::vector<double>& B_avg) const = 0;
@@ -160,7 +190,7 @@ namespace Opm
 
         void setWellEfficiencyFactor(const double efficiency_factor);
 
-        void computeRepRadiusPerfLength(const Grid& grid, const std::vector<int>& cartesian_to_compressed);
+        void computeRepRadiusPerfLength(const Grid& grid, const CartesianCellIndexMap& cartesian_to_compressed);
 
         /// using the solution x to recover the solution xw for wells and applying
         /// xw to update Well State
@@ -178,6 +208,13 @@ namespace Opm
                                            const WellState& well_state,
                                            std::vector<double>& well_potentials) = 0;
 
+        /// Compute the well potentials with computeWellPotentials(), or keep those of the
+        /// last computation if its inputs (see potentialInputs()) changed less than the
+        /// relative tolerance param_.well_potential_tolerance_.
+        void computeWellPotentialsIfChanged(const Simulator& ebosSimulator,
+                                            const WellState& well_state,
+                                            std::vector<double>& well_potentials);
+
         virtual void updateWellStateWithTarget(const Simulator& ebos_simulator,
                                                WellState& well_state) const = 0;
 
@@ -203,6 +240,12 @@ namespace Opm
         virtual void addWellContributions(Mat&) const
         {}
 
+        /// \brief The bytes of the matrices of the well equations, for the memory report.
+        virtual std::size_t wellMatrixMemory() const
+        {
+            return 0;
+        }
+
         void addCellRates(RateVector& rates, int cellIdx) const;
 
         Scalar volumetricSurfaceRateForConnection(int cellIdx, int phaseIdx) const;
@@ -221,6 +264,16 @@ namespace Opm
 
         void closeCompletions(WellTestState& wellTestState);
 
+        /// Extrapolate the BHP and the rates of the well linearly from two converged states,
+        /// as the initial guess of the next time step. The well is left unchanged if its
+        /// control differs between the states or if a rate would change its sign, and
+        /// the BHP is kept within the BHP limits.
+        /// \param older_state The converged state before the last time step.
+        /// \param factor The length of the next time step relative to the last one.
+        /// \param well_state The converged state of the last time step, changed in place.
+        virtual void predictWellState(const WellState& older_state, const double factor,
+                                      WellState& well_state) const;
+
         const Well* wellEcl() const;
 
         // TODO: theoretically, it should be a const function
@@ -254,7 +307,7 @@ namespace Opm
 
         const Well* well_ecl_;
 
-        const int current_step_;
+        int current_step_;
 
         // the index of well in Wells struct
         int index_of_well_;
@@ -315,6 +368,9 @@ namespace Opm
 
         const VFPProperties<VFPInjProperties,VFPProdProperties>* vfp_properties_;
 
+        // the table intervals of the last BHP evaluation from the THP, tried first by the next one
+        mutable detail::InterpHint vfp_interp_hint_;
+
         double gravity_;
 
         // For the conversion between the surface volume rate and resrevoir voidage rate
@@ -328,6 +384,17 @@ namespace Opm
 
         std::vector<RateVector> connectionRates_;
 
+        // the messages of the well, written by logMessages()
+        mutable DeferredLogger deferred_logger_;
+
+        // the inputs and the result of the last computation of the well potentials
+        std::vector<double> potential_inputs_;
+        std::vector<double> potentials_;
+
+        // the controls, the well state and the perforated cell quantities the well potentials depend on
+        std::vector<double> potentialInputs(const Simulator& ebosSimulator,
+                                            const WellState& well_state) const;
+
         const PhaseUsage& phaseUsage() const;
 
         int flowPhaseToEbosCompIdx( const int phaseIdx ) const;
@@ -140,6 +140,158 @@ namespace Opm
 
 
 
+    template<typename TypeTag>
+    bool
+    WellInterface<TypeTag>::
+    rebind(const Well* well, const int time_step, const Wells* wells)
+    {
+        if (well != well_ecl_ || !wells || wells->number_of_phases != number_of_phases_) {
+            return false;
+        }
+
+        int index_well;
+        for (index_well = 0; index_well < wells->number_of_wells; ++index_well) {
+            if (name() == std::string(wells->name[index_well])) {
+                break;
+            }
+        }
+        if (index_well == wells->number_of_wells || wells->type[index_well] != well_type_) {
+            return false;
+        }
+
+        const int perf_index_begin = wells->well_connpos[index_well];
+        const int perf_index_end = wells->well_connpos[index_well + 1];
+        if (perf_index_end - perf_index_begin != number_of_perforations_ ||
+            !std::equal(well_cells_.begin(), well_cells_.end(), wells->well_cells + perf_index_begin) ||
+            !std::equal(saturation_table_number_.begin(), saturation_table_number_.end(),
+                        wells->sat_table_id + perf_index_begin)) {
+            return false;
+        }
+
+        current_step_ = time_step;
+        index_of_well_ = index_well;
+        first_perf_ = perf_index_begin;
+        well_controls_ = wells->ctrls[index_well];
+        ref_depth_ = wells->depth_ref[index_well];
+        std::copy(wells->comp_frac + index_well * number_of_phases_,
+                  wells->comp_frac + (index_well + 1) * number_of_phases_, comp_frac_.begin() );
+        // the connection factors can change, and closeCompletions() zeroes them
+        std::copy(wells->WI + perf_index_begin, wells->WI + perf_index_end, well_index_.begin() );
+        well_efficiency_factor_ = 1.0;
+        return true;
+    }
+
+
+
+
+
+    template<typename TypeTag>
+    void
+    WellInterface<TypeTag>::
+    computeWellPotentialsIfChanged(const Simulator& ebosSimulator,
+                                   const WellState& well_state,
+                                   std::vector<double>& well_potentials)
+    {
+        std::vector<double> inputs = potentialInputs(ebosSimulator, well_state);
+        if (wellhelpers::withinRelativeTolerance(inputs, potential_inputs_, param_.well_potential_tolerance_)) {
+            well_potentials = potentials_;
+            return;
+        }
+
+        computeWellPotentials(ebosSimulator, well_state, well_potentials);
+        // only kept after a successful computation
+        potential_inputs_ = std::move(inputs);
+        potentials_ = well_potentials;
+    }
+
+
+
+
+
+    template<typename TypeTag>
+    void
+    WellInterface<TypeTag>::
+    predictWellState(const WellState& older_state, const double factor,
+                     WellState& well_state) const
+    {
+        const int w = index_of_well_;
+        const int np = number_of_phases_;
+        if (older_state.currentControls()[w] != well_state.currentControls()[w]) {
+            return;
+        }
+
+        std::vector<double> rates(np);
+        for (int p = 0; p < np; ++p) {
+            const double rate = well_state.wellRates()[w * np + p];
+            rates[p] = rate + factor * (rate - older_state.wellRates()[w * np + p]);
+            if (rates[p] * rate < 0.) {
+                return;
+            }
+        }
+
+        const double bhp = well_state.bhp()[w];
+        const double bhp_limit = mostStrictBhpFromBhpLimits();
+        const double predicted_bhp = bhp + factor * (bhp - older_state.bhp()[w]);
+        well_state.bhp()[w] = (well_type_ == PRODUCER) ? std::max(predicted_bhp, bhp_limit)
+                                                       : std::min(predicted_bhp, bhp_limit);
+        std::copy(rates.begin(), rates.end(), well_state.wellRates().begin() + w * np);
+    }
+
+
+
+
+
+    template<typename TypeTag>
+    std::vector<double>
+    WellInterface<TypeTag>::
+    potentialInputs(const Simulator& ebosSimulator,
+                    const WellState& well_state) const
+    {
+        std::vector<double> inputs;
+        const int nwc = well_controls_get_num(well_controls_);
+        inputs.reserve(3 * nwc + 4 + number_of_phases_ + number_of_perforations_ * (5 + 2 * FluidSystem::numPhases));
+
+        // the report step selects the VFP tables
+        inputs.push_back(current_step_);
+        // the targets of all the controls, which include the BHP and THP limits
+        inputs.push_back(well_controls_get_current(well_controls_));
+        inputs.push_back(well_controls_well_is_stopped(well_controls_));
+        for (int ctrl_index = 0; ctrl_index < nwc; ++ctrl_index) {
+            inputs.push_back(well_controls_iget_type(well_controls_, ctrl_index));
+            inputs.push_back(well_controls_iget_target(well_controls_, ctrl_index));
+            inputs.push_back(well_controls_iget_alq(well_controls_, ctrl_index));
+        }
+
+        inputs.push_back(well_state.bhp()[index_of_well_]);
+        const int np = number_of_phases_;
+        for (int p = 0; p < np; ++p) {
+            inputs.push_back(well_state.wellRates()[index_of_well_ * np + p]);
+        }
+
+        for (int perf = 0; perf < number_of_perforations_; ++perf) {
+            inputs.push_back(well_index_[perf]);
+            inputs.push_back(well_state.perfPress()[first_perf_ + perf]);
+
+            const int cell_idx = well_cells_[perf];
+            const auto& intQuants = *(ebosSimulator.model().cachedIntensiveQuantities(cell_idx, /*timeIdx=*/ 0));
+            const auto& fs = intQuants.fluidState();
+            inputs.push_back(fs.pressure(FluidSystem::oilPhaseIdx).value());
+            inputs.push_back(fs.Rs().value());
+            inputs.push_back(fs.Rv().value());
+            for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx) {
+                if (phaseIsActive(phaseIdx)) {
+                    inputs.push_back(intQuants.mobility(phaseIdx).value());
+                    inputs.push_back(fs.invB(phaseIdx).value());
+                }
+            }
+        }
+        return inputs;
+    }
+
+
+
+
+
     template<typename TypeTag>
     void
     WellInterface<TypeTag>::
@@ -248,11 +400,11 @@ namespace Opm
     flowPhaseToEbosCompIdx( const int phaseIdx ) const
     {
         const auto& pu = phaseUsage();
-        if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx) && pu.phase_pos[Water] == phaseIdx)
+        if (phaseIsActive(FluidSystem::waterPhaseIdx) && pu.phase_pos[Water] == phaseIdx)
             return Indices::canonicalToActiveComponentIndex(FluidSystem::waterCompIdx);
-        if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx) && pu.phase_pos[Oil] == phaseIdx)
+        if (phaseIsActive(FluidSystem::oilPhaseIdx) && pu.phase_pos[Oil] == phaseIdx)
             return Indices::canonicalToActiveComponentIndex(FluidSystem::oilCompIdx);
-        if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx) && pu.phase_pos[Gas] == phaseIdx)
+        if (phaseIsActive(FluidSystem::gasPhaseIdx) && pu.phase_pos[Gas] == phaseIdx)
             return Indices::canonicalToActiveComponentIndex(FluidSystem::gasCompIdx);
 
         // for other phases return the index
@@ -265,11 +417,11 @@ namespace Opm
     ebosCompIdxToFlowCompIdx( const unsigned compIdx ) const
     {
         const auto& pu = phaseUsage();
-        if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx) && Indices::canonicalToActiveComponentIndex(FluidSystem::waterCompIdx) == compIdx)
+        if (phaseIsActive(FluidSystem::waterPhaseIdx) && Indices::canonicalToActiveComponentIndex(FluidSystem::waterCompIdx) == compIdx)
             return pu.phase_pos[Water];
-        if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx) && Indices::canonicalToActiveComponentIndex(FluidSystem::oilCompIdx) == compIdx)
+        if (phaseIsActive(FluidSystem::oilPhaseIdx) && Indices::canonicalToActiveComponentIndex(FluidSystem::oilCompIdx) == compIdx)
             return pu.phase_pos[Oil];
-        if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx) && Indices::canonicalToActiveComponentIndex(FluidSystem::gasCompIdx) == compIdx)
+        if (phaseIsActive(FluidSystem::gasPhaseIdx) && Indices::canonicalToActiveComponentIndex(FluidSystem::gasCompIdx) == compIdx)
             return pu.phase_pos[Gas];
 
         // for other phases return the index
@@ -471,11 +623,11 @@ namespace Opm
                 } else {
                     // before we figure out to handle it, we give some debug information here
                     if ( well_controls_iget_type(wc, ctrl_index) == BHP && !operability_status_.isOperableUnderBHPLimit() ) {
-                        OpmLog::debug("well " + name() + " breaks the BHP limit, while it is not operable under BHP limit");
+                        deferred_logger_.debug("well " + name() + " breaks the BHP limit, while it is not operable under BHP limit");
                     }
 
                     if ( well_controls_iget_type(wc, ctrl_index) == THP && !operability_status_.isOperableUnderTHPLimit() ) {
-                        OpmLog::debug("well " + name() + " breaks the THP limit, while it is not operable under THP limit");
+                        deferred_logger_.debug("well " + name() + " breaks the THP limit, while it is not operable under THP limit");
                     }
                 }
             }
@@ -543,7 +695,7 @@ namespace Opm
         const int np = number_of_phases_;
 
         if (econ_production_limits.onMinOilRate()) {
-            assert(FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx));
+            assert(phaseIsActive(FluidSystem::oilPhaseIdx));
             const double oil_rate = well_state.wellRates()[index_of_well_ * np + pu.phase_pos[ Oil ] ];
             const double min_oil_rate = econ_production_limits.minOilRate();
             if (std::abs(oil_rate) < min_oil_rate) {
@@ -552,7 +704,7 @@ namespace Opm
         }
 
         if (econ_production_limits.onMinGasRate() ) {
-            assert(FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx));
+            assert(phaseIsActive(FluidSystem::gasPhaseIdx));
             const double gas_rate = well_state.wellRates()[index_of_well_ * np + pu.phase_pos[ Gas ] ];
             const double min_gas_rate = econ_production_limits.minGasRate();
             if (std::abs(gas_rate) < min_gas_rate) {
@@ -561,8 +713,8 @@ namespace Opm
         }
 
         if (econ_production_limits.onMinLiquidRate() ) {
-            assert(FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx));
-            assert(FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx));
+            assert(phaseIsActive(FluidSystem::oilPhaseIdx));
+            assert(phaseIsActive(FluidSystem::waterPhaseIdx));
             const double oil_rate = well_state.wellRates()[index_of_well_ * np + pu.phase_pos[ Oil ] ];
             const double water_rate = well_state.wellRates()[index_of_well_ * np + pu.phase_pos[ Water ] ];
             const double liquid_rate = oil_rate + water_rate;
@@ -573,7 +725,7 @@ namespace Opm
         }
 
         if (econ_production_limits.onMinReservoirFluidRate()) {
-            OpmLog::warning("NOT_SUPPORTING_MIN_RESERVOIR_FLUID_RATE", "Minimum reservoir fluid production rate limit is not supported yet");
+            deferred_logger_.warning("NOT_SUPPORTING_MIN_RESERVOIR_FLUID_RATE", "Minimum reservoir fluid production rate limit is not supported yet");
         }
 
         return false;
@@ -598,8 +750,8 @@ namespace Opm
         const Opm::PhaseUsage& pu = phaseUsage();
         const int well_number = index_of_well_;
 
-        assert(FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx));
-        assert(FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx));
+        assert(phaseIsActive(FluidSystem::oilPhaseIdx));
+        assert(phaseIsActive(FluidSystem::waterPhaseIdx));
 
         const double oil_rate = well_state.wellRates()[well_number * np + pu.phase_pos[ Oil ] ];
         const double water_rate = well_state.wellRates()[well_number * np + pu.phase_pos[ Water ] ];
@@ -702,15 +854,15 @@ namespace Opm
         }
 
         if (econ_production_limits.onMaxGasOilRatio()) {
-            OpmLog::warning("NOT_SUPPORTING_MAX_GOR", "the support for max Gas-Oil ratio is not implemented yet!");
+            deferred_logger_.warning("NOT_SUPPORTING_MAX_GOR", "the support for max Gas-Oil ratio is not implemented yet!");
         }
 
         if (econ_production_limits.onMaxWaterGasRatio()) {
-            OpmLog::warning("NOT_SUPPORTING_MAX_WGR", "the support for max Water-Gas ratio is not implemented yet!");
+            deferred_logger_.warning("NOT_SUPPORTING_MAX_WGR", "the support for max Water-Gas ratio is not implemented yet!");
         }
 
         if (econ_production_limits.onMaxGasLiquidRatio()) {
-            OpmLog::warning("NOT_SUPPORTING_MAX_GLR", "the support for max Gas-Liquid ratio is not implemented yet!");
+            deferred_logger_.warning("NOT_SUPPORTING_MAX_GLR", "the support for max Gas-Liquid ratio is not implemented yet!");
         }
 
         if (any_limit_violated) {
@@ -771,7 +923,7 @@ namespace Opm
                 // TODO: considering auto shut in?
                 const std::string msg = "well " + name()
                              + std::string(" will be shut as it can not operate under current reservoir condition");
-                OpmLog::info(msg);
+                deferred_logger_.info(msg);
             }
         }
 
@@ -805,7 +957,7 @@ namespace Opm
         if (quantity_limit == WellEcon::POTN) {
             const std::string msg = std::string("POTN limit for well ") + name() + std::string(" is not supported for the moment. \n")
                                   + std::string("All the limits will be evaluated based on RATE. ");
-            OpmLog::warning("NOT_SUPPORTING_POTN", msg);
+            deferred_logger_.warning("NOT_SUPPORTING_POTN", msg);
         }
 
         if (econ_production_limits.onAnyRateLimit()) {
@@ -818,21 +970,21 @@ namespace Opm
                                                   + std::string("is not supported yet \n")
                                                   + std::string("the program will keep running after ") + name()
                                                   + std::string(" is closed");
-                OpmLog::warning("NOT_SUPPORTING_ENDRUN", warning_message);
+                deferred_logger_.warning("NOT_SUPPORTING_ENDRUN", warning_message);
             }
 
             if (econ_production_limits.validFollowonWell()) {
-                OpmLog::warning("NOT_SUPPORTING_FOLLOWONWELL", "opening following on well after well closed is not supported yet");
+                deferred_logger_.warning("NOT_SUPPORTING_FOLLOWONWELL", "opening following on well after well closed is not supported yet");
             }
 
             well_test_state.addClosedWell(name(), WellTestConfig::Reason::ECONOMIC, simulation_time);
             if (write_message_to_opmlog) {
                 if (well_ecl_->getAutomaticShutIn()) {
                     const std::string msg = std::string("well ") + name() + std::string(" will be shut due to rate economic limit");
-                    OpmLog::info(msg);
+                    deferred_logger_.info(msg);
                 } else {
                     const std::string msg = std::string("well ") + name() + std::string(" will be stopped due to rate economic limit");
-                    OpmLog::info(msg);
+                    deferred_logger_.info(msg);
                 }
             }
             // the well is closed, not need to check other limits
@@ -860,11 +1012,11 @@ namespace Opm
                         if (worst_offending_completion < 0) {
                             const std::string msg = std::string("Connection ") + std::to_string(- worst_offending_completion)
                                     + std::string(" for well ") + name() + std::string(" will be closed due to economic limit");
-                            OpmLog::info(msg);
+                            deferred_logger_.info(msg);
                         } else {
                             const std::string msg = std::string("Completion ") + std::to_string(worst_offending_completion)
                                     + std::string(" for well ") + name() + std::string(" will be closed due to economic limit");
-                            OpmLog::info(msg);
+                            deferred_logger_.info(msg);
                         }
                     }
 
@@ -881,10 +1033,10 @@ namespace Opm
                         if (write_message_to_opmlog) {
                             if (well_ecl_->getAutomaticShutIn()) {
                                 const std::string msg = name() + std::string(" will be shut due to last completion closed");
-                            	OpmLog::info(msg);
+                            	deferred_logger_.info(msg);
                             } else {
                                 const std::string msg = name() + std::string(" will be stopped due to last completion closed");
-                                OpmLog::info(msg);
+                                deferred_logger_.info(msg);
                             }
                         }
                     }
@@ -897,10 +1049,10 @@ namespace Opm
                     if (well_ecl_->getAutomaticShutIn()) {
                         // tell the controll that the well is closed
                         const std::string msg = name() + std::string(" will be shut due to ratio economic limit");
-                        OpmLog::info(msg);
+                        deferred_logger_.info(msg);
                     } else {
                         const std::string msg = name() + std::string(" will be stopped due to ratio economic limit");
-                        OpmLog::info(msg);
+                        deferred_logger_.info(msg);
                     }
                 }
                     break;
@@ -909,7 +1061,7 @@ namespace Opm
                     break;
                 default:
                 {
-                    OpmLog::warning("NOT_SUPPORTED_WORKOVER_TYPE",
+                    deferred_logger_.warning("NOT_SUPPORTED_WORKOVER_TYPE",
                                     "not supporting workover type " + WellEcon::WorkoverEnumToString(workover) );
                 }
             }
@@ -952,10 +1104,20 @@ namespace Opm
                         const double simulation_time, const int report_step, const bool terminal_output,
                         const WellState& well_state, WellTestState& welltest_state, wellhelpers::WellSwitchingLogger& logger)
     {
-        OpmLog::debug(" well " + name() + " is being tested for economic limits");
+        deferred_logger_.debug(" well " + name() + " is being tested for economic limits");
 
         WellState well_state_copy = well_state;
 
+        // The IPR based operability check is cheap compared to the well solves
+        // below. A well that can not flow within its BHP and THP limits can not
+        // pass the test, hence it is not solved for.
+        calculateExplicitQuantities(simulator, well_state_copy);
+        checkWellOperability(simulator, well_state_copy);
+        if ( !this->isOperable() ) {
+            deferred_logger_.debug(" well " + name() + " is not operable during well testing for economic reason");
+            return;
+        }
+
         updatePrimaryVariables(well_state_copy);
         initPrimaryVariablesEvaluation();
 
@@ -986,7 +1148,7 @@ namespace Opm
         if (!welltest_state_temp.hasWell(name(), WellTestConfig::Reason::ECONOMIC)) {
             welltest_state.openWell(name());
             const std::string msg = std::string("well ") + name() + std::string(" is re-opened");
-            OpmLog::info(msg);
+            deferred_logger_.info(msg);
 
             // also reopen completions
             for (auto& completion : well_ecl_->getCompletions(report_step)) {
@@ -1005,7 +1167,7 @@ namespace Opm
     void
     WellInterface<TypeTag>::
     computeRepRadiusPerfLength(const Grid& grid,
-                               const std::vector<int>& cartesian_to_compressed)
+                               const CartesianCellIndexMap& cartesian_to_compressed)
     {
         const int* cart_dims = Opm::UgGridHelpers::cartDims(grid);
         auto cell_to_faces = Opm::UgGridHelpers::cell2Faces(grid);
@@ -1091,11 +1253,11 @@ namespace Opm
             return distr[phaseIdx];
         }
         const auto& pu = phaseUsage();
-        if (FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx) && pu.phase_pos[Water] == phaseIdx)
+        if (phaseIsActive(FluidSystem::waterPhaseIdx) && pu.phase_pos[Water] == phaseIdx)
             return 1.0;
-        if (FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx) && pu.phase_pos[Oil] == phaseIdx)
+        if (phaseIsActive(FluidSystem::oilPhaseIdx) && pu.phase_pos[Oil] == phaseIdx)
             return 1.0;
-        if (FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx) && pu.phase_pos[Gas] == phaseIdx)
+        if (phaseIsActive(FluidSystem::gasPhaseIdx) && pu.phase_pos[Gas] == phaseIdx)
             return 0.01;
         if (has_solvent && phaseIdx == contiSolventEqIdx )
             return 0.01;
@@ -1233,12 +1395,12 @@ namespace Opm
         const bool converged = solveWellEqUntilConverged(ebosSimulator, B_avg, well_state, logger);
         if (converged) {
             if ( terminal_output ) {
-                OpmLog::debug("WellTest: Well equation for well " + name() +  " solution gets converged");
+                deferred_logger_.debug("WellTest: Well equation for well " + name() +  " solution gets converged");
             }
         } else {
             if ( terminal_output ) {
                 const int max_iter = param_.max_welleq_iter_;
-                OpmLog::debug("WellTest: Well equation for well" +name() + " solution failed in getting converged with "
+                deferred_logger_.debug("WellTest: Well equation for well" +name() + " solution failed in getting converged with "
                               + std::to_string(max_iter) + " iterations");
             }
             well_state = well_state0;
@@ -1256,7 +1418,7 @@ namespace Opm
 
         if (well_ecl_->getDrainageRadius(current_step_) < 0) {
             if (new_well && perfIdx == 0) {
-                OpmLog::warning("PRODUCTIVITY_INDEX_WARNING", "Negative drainage radius not supported. The productivity index is set to zero");
+                deferred_logger_.warning("PRODUCTIVITY_INDEX_WARNING", "Negative drainage radius not supported. The productivity index is set to zero");
             }
             productivity_index = 0.0;
             return;
@@ -1264,7 +1426,7 @@ namespace Opm
 
         if (connection.r0() > well_ecl_->getDrainageRadius(current_step_)) {
             if (new_well && well_productivity_index_logger_counter_ < 1) {
-                OpmLog::info("PRODUCTIVITY_INDEX_INFO", "The effective radius is larger than the well drainage radius for well " + name() +
+                deferred_logger_.info("PRODUCTIVITY_INDEX_INFO", "The effective radius is larger than the well drainage radius for well " + name() +
                              " They are set to equal in the well productivity index calculations");
                 well_productivity_index_logger_counter_++;
             }
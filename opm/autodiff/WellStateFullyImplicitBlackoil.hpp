@@ -64,233 +64,9 @@ namespace Opm
         /// and perfPhaseRates() fields, depending on controls
         void init(const Wells* wells, const std::vector<double>& cellPressures,
                   const std::vector<const Well*>& wells_ecl, const int report_step,
-                  const WellStateFullyImplicitBlackoil* prevState, const PhaseUsage& pu)
-        {
-            // call init on base class
-            BaseType :: init(wells, cellPressures);
-
-            // if there are no well, do nothing in init
-            if (wells == 0) {
-                return;
-            }
-
-            const int nw = wells->number_of_wells;
-
-            if( nw == 0 ) return ;
-
-            // Initialize perfphaserates_, which must be done here.
-            const int np = wells->number_of_phases;
-            const int nperf = wells->well_connpos[nw];
-
-            well_reservoir_rates_.resize(nw * np, 0.0);
-            well_dissolved_gas_rates_.resize(nw, 0.0);
-            well_vaporized_oil_rates_.resize(nw, 0.0);
-
-            // checking whether some effective well control happens
-            effective_events_occurred_.resize(nw, true);
-
-            // a hack to make the resize() function used in RESTART related work
-            if (!wells_ecl.empty() ) {
-                // At the moment, the following events are considered to be effective events
-                // more events might join as effective events
-                // PRODUCTION_UPDATE, INJECTION_UPDATE, WELL_STATUS_CHANGE
-                // 16 + 32 + 128
-                const uint64_t effective_events_mask = ScheduleEvents::WELL_STATUS_CHANGE
-                                                     + ScheduleEvents::PRODUCTION_UPDATE
-                                                     + ScheduleEvents::INJECTION_UPDATE;
-
-                for (int w = 0; w <nw; ++w) {
-                    const int nw_wells_ecl = wells_ecl.size();
-                    int index_well_ecl = 0;
-                    const std::string well_name(wells->name[w]);
-                    for (; index_well_ecl < nw_wells_ecl; ++index_well_ecl) {
-                        if (well_name == wells_ecl[index_well_ecl]->name()) {
-                            break;
-                        }
-                    }
-
-                    // It should be able to find in wells_ecl.
-                    if (index_well_ecl == nw_wells_ecl) {
-                        OPM_THROW(std::logic_error, "Could not find well " << well_name << " in wells_ecl ");
-                    }
-
-                    const Well* well_ecl = wells_ecl[index_well_ecl];
-                    effective_events_occurred_[w] = (well_ecl->hasEvent(effective_events_mask, report_step) );
-                }
-            } // end of if (!well_ecl.empty() )
-
-            // Ensure that we start out with zero rates by default.
-            perfphaserates_.clear();
-            perfphaserates_.resize(nperf * np, 0.0);
-
-            // these are only used to monitor the injectivity
-            perf_water_throughput_.clear();
-            perf_water_throughput_.resize(nperf, 0.0);
-            perf_water_velocity_.clear();
-            perf_water_velocity_.resize(nperf, 0.0);
-            perf_skin_pressure_.clear();
-            perf_skin_pressure_.resize(nperf, 0.0);
-
-            for (int w = 0; w < nw; ++w) {
-                assert((wells->type[w] == INJECTOR) || (wells->type[w] == PRODUCER));
-                const WellControls* ctrl = wells->ctrls[w];
-
-                if (well_controls_well_is_stopped(ctrl)) {
-                    // Shut well: perfphaserates_ are all zero.
-                } else {
-                    const int num_perf_this_well = wells->well_connpos[w + 1] - wells->well_connpos[w];
-                    // Open well: Initialize perfphaserates_ to well
-                    // rates divided by the number of perforations.
-                    for (int perf = wells->well_connpos[w]; perf < wells->well_connpos[w + 1]; ++perf) {
-                        for (int p = 0; p < np; ++p) {
-                            perfphaserates_[np*perf + p] = wellRates()[np*w + p] / double(num_perf_this_well);
-                        }
-                        perfPress()[perf] = cellPressures[wells->well_cells[perf]];
-                    }
-                }
-            }
-
-            current_controls_.resize(nw);
-            // The controls set in the Wells (specified in the DECK) are treated as default initial value
-            for (int w = 0; w < nw; ++w) {
-                current_controls_[w] = well_controls_get_current(wells->ctrls[w]);
-            }
-            perfRateSolvent_.clear();
-            perfRateSolvent_.resize(nperf, 0.0);
-            productivity_index_.resize(nw * np, 0.0);
-            well_potentials_.resize(nw * np, 0.0);
-
-            // intialize wells that have been there before
-            // order may change so the mapping is based on the well name
-            if(prevState && !prevState->wellMap().empty()) {
-                typedef typename WellMapType :: const_iterator const_iterator;
-                const_iterator end = prevState->wellMap().end();
-                for (int w = 0; w < nw; ++w) {
-                    const std::string name( wells->name[ w ] );
-                    const_iterator it = prevState->wellMap().find( name );
-                    if( it != end )
-                    {
-                        const int oldIndex = (*it).second[ 0 ];
-                        const int newIndex = w;
-
-                        // bhp
-                        bhp()[ newIndex ] = prevState->bhp()[ oldIndex ];
-
-                        // thp
-                        thp()[ newIndex ] = prevState->thp()[ oldIndex ];
-
-                        // if there is no effective control event happens to the well, we use the current_controls_ from prevState
-                        // otherwise, we use the control specified in the deck
-                        if (!effective_events_occurred_[w]) {
-                            current_controls_[ newIndex ] = prevState->currentControls()[ oldIndex ];
-                            // also change the one in the WellControls
-                            well_controls_set_current(wells->ctrls[w], current_controls_[ newIndex ]);
-                        }
-
-                        // wellrates
-                        for( int i=0, idx=newIndex*np, oldidx=oldIndex*np; i<np; ++i, ++idx, ++oldidx )
-                        {
-                            wellRates()[ idx ] = prevState->wellRates()[ oldidx ];
-                        }
-
-                        // perfPhaseRates
-                        const int oldPerf_idx_beg = (*it).second[ 1 ];
-                        const int num_perf_old_well = (*it).second[ 2 ];
-                        const int num_perf_this_well = wells->well_connpos[newIndex + 1] - wells->well_connpos[newIndex];
-                        // copy perforation rates when the number of perforations is equal,
-                        // otherwise initialize perfphaserates to well rates divided by the number of perforations.
-                        if( num_perf_old_well == num_perf_this_well )
-                        {
-                            int old_perf_phase_idx = oldPerf_idx_beg *np;
-                            for (int perf_phase_idx = wells->well_connpos[ newIndex ]*np;
-                                 perf_phase_idx < wells->well_connpos[ newIndex + 1]*np; ++perf_phase_idx, ++old_perf_phase_idx )
-                            {
-                                perfPhaseRates()[ perf_phase_idx ] = prevState->perfPhaseRates()[ old_perf_phase_idx ];
-                            }
-                        } else {
-                            for (int perf = wells->well_connpos[newIndex]; perf < wells->well_connpos[newIndex + 1]; ++perf) {
-                                for (int p = 0; p < np; ++p) {
-                                    perfPhaseRates()[np*perf + p] = wellRates()[np*newIndex + p] / double(num_perf_this_well);
-                                }
-                            }
-                        }
-                        // perfPressures
-                        if( num_perf_old_well == num_perf_this_well )
-                        {
-                            int oldPerf_idx = oldPerf_idx_beg;
-                            for (int perf = wells->well_connpos[ newIndex ];
-                                 perf < wells->well_connpos[ newIndex + 1]; ++perf, ++oldPerf_idx )
-                            {
-                                perfPress()[ perf ] = prevState->perfPress()[ oldPerf_idx ];
-                            }
-                        }
-                        // perfSolventRates
-                        if (pu.has_solvent) {
-                            if( num_perf_old_well == num_perf_this_well )
-                            {
-                                int oldPerf_idx = oldPerf_idx_beg;
-                                for (int perf = wells->well_connpos[ newIndex ];
-                                     perf < wells->well_connpos[ newIndex + 1]; ++perf, ++oldPerf_idx )
-                                {
-                                    perfRateSolvent()[ perf ] = prevState->perfRateSolvent()[ oldPerf_idx ];
-                                }
-                            }
-                        }
-
-                        // polymer injectivity related
-                        // here we did not consider the case that we close some perforation during the running
-                        // and also, wells can be shut and re-opened
-                        if (pu.has_polymermw) {
-                            if( num_perf_old_well == num_perf_this_well )
-                            {
-                                int oldPerf_idx = oldPerf_idx_beg;
-                                for (int perf = wells->well_connpos[ newIndex ];
-                                     perf < wells->well_connpos[ newIndex + 1]; ++perf, ++oldPerf_idx )
-                                {
-                                    perf_water_throughput_[ perf ] = prevState->perfThroughput()[ oldPerf_idx ];
-                                    perf_skin_pressure_[ perf ] = prevState->perfSkinPressure()[ oldPerf_idx ];
-                                    perf_water_velocity_[ perf ] = prevState->perfWaterVelocity()[ oldPerf_idx ];
-                                }
-                            }
-                        }
-                    }
+                  const WellStateFullyImplicitBlackoil* prevState, const PhaseUsage& pu);
 
-
-                    // If in the new step, there is no THP related target/limit anymore, its thp value should be
-                    // set to zero.
-                    const WellControls* ctrl = wells->ctrls[w];
-                    const int nwc = well_controls_get_num(ctrl);
-                    int ctrl_index = 0;
-                    for (; ctrl_index < nwc; ++ctrl_index) {
-                        if (well_controls_iget_type(ctrl, ctrl_index) == THP) {
-                            break;
-                        }
-                    }
-                    // not finding any thp related control/limits
-                    if (ctrl_index == nwc) {
-                        thp()[w] = 0.;
-                    }
-                }
-            }
-
-            {
-                // we need to create a trival segment related values to avoid there will be some
-                // multi-segment wells added later.
-                top_segment_index_.reserve(nw);
-                for (int w = 0; w < nw; ++w) {
-                    top_segment_index_.push_back(w);
-                }
-                segpress_ = bhp();
-                segrates_ = wellRates();
-            }
-        }
-
-        void resize(const Wells* wells, size_t numCells, const PhaseUsage& pu)
-        {
-            const std::vector<double> tmp(numCells, 0.0); // <- UGLY HACK to pass the size
-            const std::vector<const Well*> wells_ecl;
-            init(wells, tmp, wells_ecl, 0, nullptr, pu);
-        }
+        void resize(const Wells* wells, size_t numCells, const PhaseUsage& pu);
 
         /// Allocate and initialize if wells is non-null.  Also tries
         /// to give useful initial values to the bhp(), wellRates()
@@ -480,105 +256,26 @@ namespace Opm
         std::vector<int>& currentControls() { return current_controls_; }
         const std::vector<int>& currentControls() const { return current_controls_; }
 
-        data::Wells report(const PhaseUsage &pu, const int* globalCellIdxMap) const override
-        {
-            data::Wells res = WellState::report(pu, globalCellIdxMap);
-
-            const int nw = this->numWells();
-            if( nw == 0 ) return res;
-            const int np = pu.num_phases;
-
-
-            using rt = data::Rates::opt;
-            std::vector< rt > phs( np );
-            if( pu.phase_used[Water] ) {
-                phs.at( pu.phase_pos[Water] ) = rt::wat;
-            }
-
-            if( pu.phase_used[Oil] ) {
-                phs.at( pu.phase_pos[Oil] ) = rt::oil;
-            }
-
-            if( pu.phase_used[Gas] ) {
-                phs.at( pu.phase_pos[Gas] ) = rt::gas;
-            }
-
-            if (pu.has_solvent) {
-                // add solvent component
-                for( int w = 0; w < nw; ++w ) {
-                    res.at( wells_->name[ w ]).rates.set( rt::solvent, solventWellRate(w) );
-                }
-            }
-
-            /* this is a reference or example on **how** to convert from
-             * WellState to something understood by opm-output. it is intended
-             * to be properly implemented and maintained as a part of
-             * simulators, as it relies on simulator internals, details and
-             * representations.
-             */
-
-            for( const auto& wt : this->wellMap() ) {
-                const auto w = wt.second[ 0 ];
-                auto& well = res.at( wt.first );
-                well.control = this->currentControls()[ w ];
-
-                const int well_rate_index = w * pu.num_phases;
-
-                if ( pu.phase_used[Water] ) {
-                    well.rates.set( rt::reservoir_water, this->well_reservoir_rates_[well_rate_index + pu.phase_pos[Water]] );
-                }
-
-                if ( pu.phase_used[Oil] ) {
-                    well.rates.set( rt::reservoir_oil, this->well_reservoir_rates_[well_rate_index + pu.phase_pos[Oil]] );
-                }
-
-                if ( pu.phase_used[Gas] ) {
-                    well.rates.set( rt::reservoir_gas, this->well_reservoir_rates_[well_rate_index + pu.phase_pos[Gas]] );
-                }
-
-                if ( pu.phase_used[Water] ) {
-                    well.rates.set( rt::productivity_index_water, this->productivity_index_[well_rate_index + pu.phase_pos[Water]] );
-                }
-
-                if ( pu.phase_used[Oil] ) {
-                    well.rates.set( rt::productivity_index_oil, this->productivity_index_[well_rate_index + pu.phase_pos[Oil]] );
-                }
-
-                if ( pu.phase_used[Gas] ) {
-                    well.rates.set( rt::productivity_index_gas, this->productivity_index_[well_rate_index + pu.phase_pos[Gas]] );
-                }
-
-                if ( pu.phase_used[Water] ) {
-                    well.rates.set( rt::well_potential_water, this->well_potentials_[well_rate_index + pu.phase_pos[Water]] );
-                }
-
-                if ( pu.phase_used[Oil] ) {
-                    well.rates.set( rt::well_potential_oil, this->well_potentials_[well_rate_index + pu.phase_pos[Oil]] );
-                }
-
-                if ( pu.phase_used[Gas] ) {
-                    well.rates.set( rt::well_potential_gas, this->well_potentials_[well_rate_index + pu.phase_pos[Gas]] );
-                }
-
-                well.rates.set( rt::dissolved_gas, this->well_dissolved_gas_rates_[w] );
-                well.rates.set( rt::vaporized_oil, this->well_vaporized_oil_rates_[w] );
+        data::Wells report(const PhaseUsage &pu, const int* globalCellIdxMap) const override;
 
-                int local_comp_index = 0;
-                for( auto& comp : well.connections) {
-                    const auto rates = this->perfPhaseRates().begin()
-                                     + (np * wt.second[ 1 ])
-                                     + (np * local_comp_index);
-                    ++local_comp_index;
+        /// The bytes of the arrays, for the memory report.
+        std::size_t memoryBytes() const override
+        {
+            const std::size_t doubles = perfphaserates_.capacity() + perfRateSolvent_.capacity()
+                + perf_water_throughput_.capacity() + perf_skin_pressure_.capacity() + perf_water_velocity_.capacity()
+                + well_reservoir_rates_.capacity() + well_dissolved_gas_rates_.capacity()
+                + well_vaporized_oil_rates_.capacity() + segrates_.capacity() + segpress_.capacity()
+                + productivity_index_.capacity() + well_potentials_.capacity();
+            const std::size_t ints = current_controls_.capacity() + top_segment_index_.capacity();
+            return BaseType::memoryBytes() + doubles * sizeof(double) + ints * sizeof(int)
+                + effective_events_occurred_.capacity() / 8;
+        }
 
-                    for( int i = 0; i < np; ++i ) {
-                        comp.rates.set( phs[ i ], *(rates + i) );
-                    }
-                }
-                assert(local_comp_index == this->wells_->well_connpos[ w + 1 ] - this->wells_->well_connpos[ w ]);
-            }
+        /// Write the state in binary for a checkpoint, see WellState::serialize().
+        void serialize(std::ostream& os) const override;
 
-            return res;
-        }
+        /// Read a state written by serialize().
+        void deserialize(std::istream& is) override;
 
 
         /// init the MS well related.
@@ -747,28 +444,7 @@ namespace Opm
 
 
         static void calculateSegmentRates(const std::vector<std::vector<int>>& segment_inlets, const std::vector<std::vector<int>>&segment_perforations,
-                                          const std::vector<double>& perforation_rates, const int np, const int segment, std::vector<double>& segment_rates)
-        {
-            // the rate of the segment equals to the sum of the contribution from the perforations and inlet segment rates.
-            // the first segment is always the top segment, its rates should be equal to the well rates.
-            assert(segment_inlets.size() == segment_perforations.size());
-            const int well_nseg = segment_inlets.size();
-            if (segment == 0) { // beginning the calculation
-                segment_rates.resize(np * well_nseg, 0.0);
-            }
-            // contributions from the perforations belong to this segment
-            for (const int& perf : segment_perforations[segment]) {
-                for (int p = 0; p < np; ++p) {
-                    segment_rates[np * segment + p] += perforation_rates[np * perf + p];
-                }
-            }
-            for (const int& inlet_seg : segment_inlets[segment]) {
-                calculateSegmentRates(segment_inlets, segment_perforations, perforation_rates, np, inlet_seg, segment_rates);
-                for (int p = 0; p < np; ++p) {
-                    segment_rates[np * segment + p] += segment_rates[np * inlet_seg + p];
-                }
-            }
-        }
+                                          const std::vector<double>& perforation_rates, const int np, const int segment, std::vector<double>& segment_rates);
 
 
         bool effectiveEventsOccurred(const int w) const {
@@ -0,0 +1,150 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_WELLWORKCOST_HEADER_INCLUDED
+#define OPM_WELLWORKCOST_HEADER_INCLUDED
+
+#include <opm/parser/eclipse/EclipseState/Schedule/Schedule.hpp>
+#include <opm/autodiff/CartesianCellIndexMap.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace Opm
+{
+
+    /// \brief A model of the work of the wells, as cell weights for the
+    ///        partitioning of the grid.
+    ///
+    /// A well is assembled and solved by the process owning its perforated
+    /// cells. Its cost grows with the number of perforations and, for
+    /// multi-segment wells, with the number of segments, and it is repeated
+    /// in each iteration of the well equations. The cost of a well is spread
+    /// over its perforated cells and added to the unit weight of each cell,
+    /// such that a partitioner balancing the cell weights spreads clusters of
+    /// wells over the processes.
+    class WellWorkCost
+    {
+    public:
+        /// \brief The data of a well entering its cost.
+        struct Well
+        {
+            /// The (compressed) indices of the perforated cells.
+            std::vector<int> cells;
+            /// The number of segments, 0 for a standard well.
+            int segments = 0;
+            /// The average number of iterations of the well equations per
+            /// Newton iteration, e.g. of a previous run.
+            double iterations = 1.0;
+        };
+
+        /// \param perforationCost The cost of a perforation, relative to that of a cell.
+        /// \param segmentCost The cost of a segment, relative to that of a cell.
+        WellWorkCost(const double perforationCost, const double segmentCost)
+            : perforationCost_(perforationCost), segmentCost_(segmentCost)
+        {}
+
+        /// \brief The cost of a well, relative to that of a cell.
+        double cost(const Well& well) const
+        {
+            return (perforationCost_ * well.cells.size() + segmentCost_ * well.segments)
+                * std::max(well.iterations, 1.0);
+        }
+
+        /// \brief The weight of each cell: 1 plus its share of the costs of
+        ///        the wells perforating it.
+        std::vector<double> cellWeights(const std::size_t numCells, const std::vector<Well>& wells) const
+        {
+            std::vector<double> weights(numCells, 1.0);
+            for ( const auto& well : wells )
+            {
+                if ( well.cells.empty() )
+                {
+                    continue;
+                }
+                const double share = cost(well) / well.cells.size();
+                for ( const int cell : well.cells )
+                {
+                    weights[cell] += share;
+                }
+            }
+            return weights;
+        }
+
+        /// \brief The weights rounded to positive integers, as required by
+        ///        graph partitioners, with a cell without wells scaled to resolution.
+        static std::vector<int> integerWeights(const std::vector<double>& weights, const int resolution)
+        {
+            std::vector<int> result(weights.size());
+            const double maxWeight = std::numeric_limits<int>::max() / 2;
+            for ( std::size_t i = 0; i < weights.size(); ++i )
+            {
+                const double weight = std::min(std::round(weights[i] * resolution), maxWeight);
+                result[i] = std::max(static_cast<int>(weight), 1);
+            }
+            return result;
+        }
+
+        /// \brief The wells of the schedule, with all their connections up to a report step.
+        /// \param schedule The schedule.
+        /// \param reportStep The report step of the connections and segments.
+        /// \param cartesianToCompressed The compressed index of each cartesian cell, negative if inactive.
+        /// \param cartesianSize The dimensions of the cartesian grid.
+        static std::vector<Well> scheduleWells(const Schedule& schedule, const int reportStep,
+                                               const CartesianCellIndexMap& cartesianToCompressed,
+                                               const int* cartesianSize)
+        {
+            std::vector<Well> wells;
+            for ( const auto well : schedule.getWells() )
+            {
+                Well workWell;
+                const auto& connectionSet = well->getConnections(reportStep);
+                workWell.cells.reserve(connectionSet.size());
+                for ( std::size_t c = 0; c < connectionSet.size(); ++c )
+                {
+                    const auto& connection = connectionSet.get(c);
+                    const int cartesianIndex = connection.getI()
+                        + cartesianSize[0] * (connection.getJ() + cartesianSize[1] * connection.getK());
+                    const int compressedIndex = cartesianToCompressed.compressed(cartesianIndex);
+                    if ( compressedIndex >= 0 )
+                    {
+                        workWell.cells.push_back(compressedIndex);
+                    }
+                }
+                if ( well->isMultiSegment(reportStep) )
+                {
+                    workWell.segments = well->getWellSegments(reportStep).size();
+                }
+                wells.push_back(std::move(workWell));
+            }
+            return wells;
+        }
+
+    private:
+        double perforationCost_;
+        double segmentCost_;
+    };
+
+} // namespace Opm
+
+#endif // OPM_WELLWORKCOST_HEADER_INCLUDED
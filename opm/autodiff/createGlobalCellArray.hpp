@@ -21,6 +21,9 @@
 
 #include <opm/grid/GridHelpers.hpp>
 
+#include <numeric>
+#include <vector>
+
 namespace Opm
 {
 /*!
@@ -30,19 +33,19 @@ namespace Opm
 template <class Grid>
 void createGlobalCellArray(const Grid &grid, std::vector<int>& dest)
 {
-    int numCells = Opm::UgGridHelpers::numCells(grid);
+    const int numCells = Opm::UgGridHelpers::numCells(grid);
     dest.resize(numCells);
     const auto& globalCell = Opm::UgGridHelpers::globalCell(grid);
-    std::vector<int> compressedToCartesianIdx(numCells);
+    if (!globalCell) {
+        std::iota(dest.begin(), dest.end(), 0);
+        return;
+    }
+#if HAVE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif // HAVE_OPENMP
     for (int cellIdx = 0; cellIdx < numCells; ++cellIdx) {
-        if (globalCell) {
-            dest[cellIdx] = globalCell[cellIdx];
-        }
-        else {
-            dest[cellIdx] = cellIdx;
-        }
+        dest[cellIdx] = globalCell[cellIdx];
     }
-
 }
 }
 
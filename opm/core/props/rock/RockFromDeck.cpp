@@ -25,8 +25,6 @@
 
 #include <opm/parser/eclipse/EclipseState/EclipseState.hpp>
 
-#include <opm/grid/utility/CompressedPropertyAccess.hpp>
-
 #include <array>
 #include <string>
 #include <vector>
@@ -39,25 +37,19 @@ namespace Opm
     {
         enum PermeabilityKind { ScalarPerm, DiagonalPerm, TensorPerm, None, Invalid };
 
-        void setScalarPermIfNeeded(std::array<int,9>& kmap,
-                                   int i, int j, int k);
-
-        typedef GridPropertyAccess::ArrayPolicy::ExtractFromDeck<double> PermArray;
+        // The global values of a property given in the deck, nullptr otherwise.
+        typedef const std::vector<double>* PermComponent;
 
-        struct PermTag {};
-
-        typedef GridPropertyAccess::Compressed<PermArray, PermTag> PermComponent;
+        void setScalarPermIfNeeded(std::array<PermComponent,9>& kmap,
+                                   int i, int j, int k);
 
         PermComponent
         extractPermComponent(const EclipseState& ecl,
-                             const std::string&   kw,
-                             const int*           global_cell);
+                             const std::string&  kw);
 
         PermeabilityKind
-        fillTensor(const EclipseState&         eclState,
-                   const int*                  global_cell,
-                   std::vector<PermComponent>& tensor,
-                   std::array<int,9>&          kmap);
+        fillTensor(const EclipseState&          eclState,
+                   std::array<PermComponent,9>& kmap);
 
     } // anonymous namespace
 
@@ -95,15 +87,18 @@ namespace Opm
     void RockFromDeck::assignPorosity(const Opm::EclipseState& eclState,
                                       int number_of_cells, const int* global_cell)
     {
-        typedef GridPropertyAccess::ArrayPolicy
-            ::ExtractFromDeck<double> Array;
-
-        Array poro_glob(eclState, "PORO", 1.0);
-        GridPropertyAccess::Compressed<Array> poro(poro_glob, global_cell);
+        // Only the cells of the grid are copied from the global values, and
+        // a missing PORO is not created as a global array of default values.
+        const auto& props = eclState.get3DProperties();
+        if (!props.hasDeckDoubleGridProperty("PORO")) {
+            porosity_.assign(number_of_cells, 1.0);
+            return;
+        }
+        const std::vector<double>& poro = props.getDoubleGridProperty("PORO").getData();
 
-        porosity_.clear(); porosity_.reserve(number_of_cells);
+        porosity_.resize(number_of_cells);
         for (int c = 0; c < number_of_cells; ++c) {
-            porosity_.push_back(poro[c]);
+            porosity_[c] = poro[global_cell ? global_cell[c] : c];
         }
     }
 
@@ -122,34 +117,33 @@ namespace Opm
 
         permeability.assign(dim * dim * nc, 0.0);
 
-        std::vector<PermComponent> tensor;
-        tensor.reserve(6);
-
-        std::array<int,9> kmap;
-        PermeabilityKind pkind = fillTensor(eclState, global_cell,
-                                            tensor, kmap);
+        // The components are read straight from the global values of the
+        // deck for the cells of the grid. Components which are not in the
+        // deck are zero and not created as global arrays in eclState.
+        std::array<PermComponent,9> kmap;
+        PermeabilityKind pkind = fillTensor(eclState, kmap);
         if (pkind == Invalid) {
             OPM_THROW(std::runtime_error, "Invalid permeability field.");
         }
 
-        assert (! tensor.empty());
         {
             int off = 0;
             for (int c = 0; c < nc; ++c, off += dim*dim) {
-                // SharedPermTensor K(dim, dim, &permeability_[off]);
+                const int glob = global_cell ? global_cell[c] : c;
                 int kix = 0;
 
                 for (int i = 0; i < dim; ++i) {
                     for (int j = 0; j < dim; ++j, ++kix) {
                         // Clients expect column-major (Fortran) order
                         // in "permeability_" so honour that
-                        // requirement despite "tensor" being created
+                        // requirement despite "kmap" being created
                         // row-major.  Note: The actual numerical
                         // values in the resulting array are the same
                         // in either order when viewed contiguously
                         // because fillTensor() enforces symmetry.
-                        permeability[off + (i + dim*j)] =
-                            tensor[kmap[kix]][c];
+                        if (kmap[kix] != nullptr) {
+                            permeability[off + (i + dim*j)] = (*kmap[kix])[glob];
+                        }
                     }
 
                     // K(i,i) = std::max(K(i,i), perm_threshold);
@@ -240,20 +234,18 @@ namespace Opm
         ///
         /// @param kmap
         ///    Permeability indirection map.  In particular @code
-        ///    kmap[i] @endcode is the index (an integral number in
-        ///    the set [1..9]) into the permeability tensor
-        ///    representation of function @code fillTensor @endcode
-        ///    which represents permeability component @code i
-        ///    @endcode.
+        ///    kmap[i] @endcode points to the global values in the
+        ///    deck which represent permeability component @code i
+        ///    @endcode, or is null if the component is zero.
         ///
         /// @param [in] i
         /// @param [in] j
         /// @param [in] k
-        void setScalarPermIfNeeded(std::array<int,9>& kmap,
+        void setScalarPermIfNeeded(std::array<PermComponent,9>& kmap,
                                    int i, int j, int k)
         {
-            if (kmap[j] < 0) { kmap[j] = kmap[i]; }
-            if (kmap[k] < 0) { kmap[k] = kmap[i]; }
+            if (kmap[j] == nullptr) { kmap[j] = kmap[i]; }
+            if (kmap[k] == nullptr) { kmap[k] = kmap[i]; }
         }
 
         /// @brief
@@ -286,22 +278,17 @@ namespace Opm
         ///    a given input deck as well as retrieving the numerical
         ///    value of each permeability component in each grid cell.
         ///
-        /// @param [out] tensor
         /// @param [out] kmap
         PermeabilityKind
-        fillTensor(const EclipseState&         eclState,
-                   const int*                  global_cell,
-                   std::vector<PermComponent>& tensor,
-                   std::array<int,9>&          kmap)
+        fillTensor(const EclipseState&          eclState,
+                   std::array<PermComponent,9>& kmap)
         {
             PermeabilityKind kind = classifyPermeability(eclState);
             if (kind == Invalid) {
                 OPM_THROW(std::runtime_error, "Invalid set of permeability fields given.");
             }
 
-            assert (tensor.empty());
-
-            for (int i = 0; i < 9; ++i) { kmap[i] = -1; }
+            kmap.fill(nullptr);
 
             enum { xx, xy, xz,    // 0, 1, 2
                    yx, yy, yz,    // 3, 4, 5
@@ -309,40 +296,25 @@ namespace Opm
 
             // -----------------------------------------------------------
             // 1st row: [ kxx, kxy ], kxz handled in kzx
-            if (eclState.get3DProperties().hasDeckDoubleGridProperty("PERMX" )) {
-                kmap[xx] = tensor.size();
-                tensor.push_back(extractPermComponent(eclState, "PERMX", global_cell));
-
+            if (PermComponent kxx = extractPermComponent(eclState, "PERMX")) {
+                kmap[xx] = kxx;
                 setScalarPermIfNeeded(kmap, xx, yy, zz);
             }
-            {
-                kmap[xy] = kmap[yx] = tensor.size();  // Enforce symmetry.
-                tensor.push_back(extractPermComponent(eclState, "PERMXY", global_cell));
-            }
+            kmap[xy] = kmap[yx] = extractPermComponent(eclState, "PERMXY");  // Enforce symmetry.
 
             // -----------------------------------------------------------
             // 2nd row: [ kyy, kyz ], kyx handled in kxy
-            if (eclState.get3DProperties().hasDeckDoubleGridProperty("PERMY" )) {
-                kmap[yy] = tensor.size();
-                tensor.push_back(extractPermComponent(eclState, "PERMY", global_cell));
-
+            if (PermComponent kyy = extractPermComponent(eclState, "PERMY")) {
+                kmap[yy] = kyy;
                 setScalarPermIfNeeded(kmap, yy, zz, xx);
             }
-            {
-                kmap[yz] = kmap[zy] = tensor.size();  // Enforce symmetry.
-                tensor.push_back(extractPermComponent(eclState, "PERMYZ", global_cell));
-            }
+            kmap[yz] = kmap[zy] = extractPermComponent(eclState, "PERMYZ");  // Enforce symmetry.
 
             // -----------------------------------------------------------
             // 3rd row: [ kzx, kzz ], kzy handled in kyz
-            {
-                kmap[zx] = kmap[xz] = tensor.size();  // Enforce symmetry.
-                tensor.push_back(extractPermComponent(eclState, "PERMZX", global_cell));
-            }
-            if (eclState.get3DProperties().hasDeckDoubleGridProperty("PERMZ" )) {
-                kmap[zz] = tensor.size();
-                tensor.push_back(extractPermComponent(eclState, "PERMZ", global_cell));
-
+            kmap[zx] = kmap[xz] = extractPermComponent(eclState, "PERMZX");  // Enforce symmetry.
+            if (PermComponent kzz = extractPermComponent(eclState, "PERMZ")) {
+                kmap[zz] = kzz;
                 setScalarPermIfNeeded(kmap, zz, xx, yy);
             }
 
@@ -350,13 +322,14 @@ namespace Opm
         }
 
         PermComponent
-        extractPermComponent(const EclipseState&  ecl,
-                             const std::string&   kw,
-                             const int*           global_cell)
+        extractPermComponent(const EclipseState& ecl,
+                             const std::string&  kw)
         {
-            PermArray k(ecl, kw, 0.0); // return 0.0 if not present.
-
-            return PermComponent(k, global_cell);
+            const auto& props = ecl.get3DProperties();
+            if (!props.hasDeckDoubleGridProperty(kw)) {
+                return nullptr;
+            }
+            return &props.getDoubleGridProperty(kw).getData();
         }
     } // anonymous namespace
 
@@ -23,8 +23,97 @@
 #include <opm/parser/eclipse/EclipseState/Tables/Sof2Table.hpp>
 #include <opm/parser/eclipse/EclipseState/Tables/SgwfnTable.hpp>
 
+#include <cstddef>
+#include <sstream>
+#include <string>
+
+namespace {
+
+    // 64 bit FNV-1a hash of a sequence of bytes
+    void hashBytes(std::uint64_t& hash, const void* data, const std::size_t size)
+    {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (std::size_t i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ULL;
+        }
+    }
+
+    void hashString(std::uint64_t& hash, const std::string& text)
+    {
+        hashBytes(hash, text.data(), text.size());
+        hashBytes(hash, "\0", 1);
+    }
+
+} // anonymous namespace
+
 namespace Opm{
 
+    void RelpermDiagnostics::tableDiagnosis(const EclipseState& eclState,
+                                            const Deck& deck)
+    {
+        OpmLog::info("\n===============Saturation Functions Diagnostics===============\n");
+        phaseCheck_(eclState);
+        satFamilyCheck_(eclState);
+        tableCheck_(eclState);
+        unscaledEndPointsCheck_(deck, eclState);
+    }
+
+
+
+
+
+    std::uint64_t RelpermDiagnostics::inputHash(const EclipseState& eclState,
+                                                const Deck& deck)
+    {
+        std::uint64_t hash = 14695981039346656037ULL;
+
+        // the keywords of the phases, the saturation tables and the end point scaling
+        static const char* const keywords[] = {
+            "OIL", "WATER", "GAS", "SOLVENT", "TABDIMS", "ENDSCALE", "SCALECRS",
+            "SWOF", "SGOF", "SLGOF", "SWFN", "SGFN", "SOF3", "SOF2", "SGWFN",
+            "SGCWMIS", "SORWMIS", "SSFN", "MISC", "MSFN"
+        };
+        for (const char* keyword : keywords) {
+            hashString(hash, keyword);
+            if (deck.hasKeyword(keyword)) {
+                std::ostringstream os;
+                os << deck.getKeyword(keyword);
+                hashString(hash, os.str());
+            }
+        }
+
+        // the processed grid properties, i.e. after BOX, EQUALS, MULTIPLY etc.
+        const auto& props = eclState.get3DProperties();
+        {
+            const auto& satnum = props.getIntGridProperty("SATNUM").getData();
+            hashBytes(hash, satnum.data(), satnum.size() * sizeof(int));
+        }
+        static const char* const endPoints[] = {
+            "SWL", "SWCR", "SWU", "SGL", "SGCR", "SGU", "SOWCR", "SOGCR"
+        };
+        for (const char* endPoint : endPoints) {
+            hashString(hash, endPoint);
+            if (props.hasDeckDoubleGridProperty(endPoint)) {
+                const auto& values = props.getDoubleGridProperty(endPoint).getData();
+                hashBytes(hash, values.data(), values.size() * sizeof(double));
+            }
+        }
+
+        // the active cells
+        const auto& grid = eclState.getInputGrid();
+        const std::size_t numActive = grid.getNumActive();
+        hashBytes(hash, &numActive, sizeof(numActive));
+        for (std::size_t activeIdx = 0; activeIdx < numActive; ++activeIdx) {
+            const std::size_t globalIdx = grid.getGlobalIndex(activeIdx);
+            hashBytes(hash, &globalIdx, sizeof(globalIdx));
+        }
+
+        return hash;
+    }
+
+
+
     void RelpermDiagnostics::phaseCheck_(const EclipseState& es)
     {
         const auto& phases = es.runspec().phases();
@@ -20,6 +20,7 @@
 #ifndef OPM_RELPERMDIAGNOSTICS_HEADER_INCLUDED
 #define OPM_RELPERMDIAGNOSTICS_HEADER_INCLUDED
 
+#include <cstdint>
 #include <vector>
 #include <utility>
 
@@ -62,6 +63,36 @@ namespace Opm {
                        const Deck& deck,
                        const GridT& grid);
 
+        ///This function checks the saturation tables and their
+        ///endpoints only, i.e. everything but the scaled endpoints
+        ///of the cells.
+        ///\param[in] eclState  eclipse state.
+        ///\param[in] deck      ecliplise data file.
+        void tableDiagnosis(const EclipseState& eclState,
+                            const Deck& deck);
+
+        ///This function checks the scaled endpoints of some cells
+        ///of the grid, e.g. the interior cells of a process. The
+        ///cells are checked by all threads, and the warnings are
+        ///output in the order of the cells.
+        ///\param[in] eclState  eclipse state.
+        ///\param[in] deck      ecliplise data file.
+        ///\param[in] grid      unstructured grid.
+        ///\param[in] cells     the compressed indices of the cells.
+        template <class GridT>
+        void cellDiagnosis(const EclipseState& eclState,
+                           const Deck& deck,
+                           const GridT& grid,
+                           const std::vector<int>& cells);
+
+        ///A hash of the input checked by the diagnostics, i.e. the
+        ///saturation tables, the endpoint scaling and the active cells,
+        ///which allows to skip the diagnostics of an unchanged deck.
+        ///\param[in] eclState  eclipse state.
+        ///\param[in] deck      ecliplise data file.
+        static std::uint64_t inputHash(const EclipseState& eclState,
+                                       const Deck& deck);
+
     private:
         enum FluidSystem {
             OilWater,
@@ -82,7 +113,6 @@ namespace Opm {
         SaturationFunctionFamily satFamily_;
 
         std::vector<Opm::EclEpsScalingPointsInfo<double> > unscaledEpsInfo_;
-        std::vector<Opm::EclEpsScalingPointsInfo<double> > scaledEpsInfo_;
 
 
         ///Check the phase that used.
@@ -101,7 +131,8 @@ namespace Opm {
         template <class GridT>
         void scaledEndPointsCheck_(const Deck& deck,
                                    const EclipseState& eclState,
-                                   const GridT& grid);
+                                   const GridT& grid,
+                                   const std::vector<int>& cells);
 
         ///For every table, need to deal with case by case.
         void swofTableCheck_(const Opm::SwofTable& swofTables,
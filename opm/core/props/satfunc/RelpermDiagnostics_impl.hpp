@@ -20,9 +20,15 @@
 #ifndef OPM_RELPERMDIAGNOSTICS_IMPL_HEADER_INCLUDED
 #define OPM_RELPERMDIAGNOSTICS_IMPL_HEADER_INCLUDED
 
+#include <numeric>
+#include <string>
 #include <vector>
 #include <utility>
 
+#if HAVE_OPENMP
+#include <omp.h>
+#endif // HAVE_OPENMP
+
 #include <opm/core/props/satfunc/RelpermDiagnostics.hpp>
 #include <opm/grid/utility/compressedToCartesian.hpp>
 
@@ -33,18 +39,26 @@ namespace Opm {
                                        const Opm::Deck& deck,
                                        const GridT& grid)
     {
-        OpmLog::info("\n===============Saturation Functions Diagnostics===============\n");
-        phaseCheck_(eclState);
-        satFamilyCheck_(eclState);
-        tableCheck_(eclState);
-        unscaledEndPointsCheck_(deck, eclState);
-        scaledEndPointsCheck_(deck, eclState, grid);
+        tableDiagnosis(eclState, deck);
+        std::vector<int> cells(Opm::UgGridHelpers::numCells(grid));
+        std::iota(cells.begin(), cells.end(), 0);
+        cellDiagnosis(eclState, deck, grid, cells);
+    }
+
+    template <class GridT>
+    void RelpermDiagnostics::cellDiagnosis(const Opm::EclipseState& eclState,
+                                           const Opm::Deck& deck,
+                                           const GridT& grid,
+                                           const std::vector<int>& cells)
+    {
+        scaledEndPointsCheck_(deck, eclState, grid, cells);
     }
 
     template <class GridT>
     void RelpermDiagnostics::scaledEndPointsCheck_(const Deck& deck,
                                                    const EclipseState& eclState,
-                                                   const GridT& grid)
+                                                   const GridT& grid,
+                                                   const std::vector<int>& cells)
     {
         // All end points are subject to round-off errors, checks should account for it
         const float tolerance = 1e-6;
@@ -52,49 +66,72 @@ namespace Opm {
         const auto& global_cell = Opm::UgGridHelpers::globalCell(grid);
         const auto dims = Opm::UgGridHelpers::cartDims(grid);
         const auto& compressedToCartesianIdx = Opm::compressedToCartesian(nc, global_cell);
-        scaledEpsInfo_.resize(nc);
         EclEpsGridProperties epsGridProperties;
         epsGridProperties.initFromDeck(deck, eclState, /*imbibition=*/false);       
         const auto& satnum = eclState.get3DProperties().getIntGridProperty("SATNUM");
-        
-        const std::string tag = "Scaled endpoints";
-        for (int c = 0; c < nc; ++c) {
-            const int cartIdx = compressedToCartesianIdx[c];
-            const std::string satnumIdx = std::to_string(satnum.iget(cartIdx));
-            std::array<int, 3> ijk;
-            ijk[0] = cartIdx % dims[0];
-            ijk[1] = (cartIdx / dims[0]) % dims[1];
-            ijk[2] = cartIdx / dims[0] / dims[1];
-            const std::string cellIdx = "(" + std::to_string(ijk[0]) + ", " + 
-                                   std::to_string(ijk[1]) + ", " +
-                                   std::to_string(ijk[2]) + ")";
-            scaledEpsInfo_[c].extractScaled(eclState, epsGridProperties, cartIdx);
+        const auto& phases = eclState.runspec().phases();
+        const bool checkMobility = deck.hasKeyword("SCALECRS")
+            && phases.active(Phase::OIL) && phases.active(Phase::WATER)
+            && phases.active(Phase::GAS) && !phases.active(Phase::SOLVENT);
+
+        // The messages of the cells checked by a thread, in the order of the cells
+        // since the cells are distributed statically.
+        const int numCells = cells.size();
+        int numThreads = 1;
+#if HAVE_OPENMP
+        numThreads = omp_get_max_threads();
+#endif // HAVE_OPENMP
+        std::vector<std::vector<std::string> > messages(numThreads);
+
+#if HAVE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif // HAVE_OPENMP
+        for (int i = 0; i < numCells; ++i) {
+            int thread = 0;
+#if HAVE_OPENMP
+            thread = omp_get_thread_num();
+#endif // HAVE_OPENMP
+            const int cartIdx = compressedToCartesianIdx[cells[i]];
+            Opm::EclEpsScalingPointsInfo<double> epsInfo;
+            epsInfo.extractScaled(eclState, epsGridProperties, cartIdx);
+
+            // The description of the cell is only needed for a warning.
+            const auto cellMessage = [&](const std::string& what) {
+                const std::string cellIdx = "(" + std::to_string(cartIdx % dims[0]) + ", " +
+                                       std::to_string((cartIdx / dims[0]) % dims[1]) + ", " +
+                                       std::to_string(cartIdx / dims[0] / dims[1]) + ")";
+                return "For scaled endpoints input, cell" + cellIdx + " SATNUM = "
+                    + std::to_string(satnum.iget(cartIdx)) + ", " + what;
+            };
 
             // SGU <= 1.0 - SWL
-            if (scaledEpsInfo_[c].Sgu > (1.0 - scaledEpsInfo_[c].Swl + tolerance)) {
-                const std::string msg = "For scaled endpoints input, cell" + cellIdx + " SATNUM = " + satnumIdx + ", SGU exceed 1.0 - SWL";
-                OpmLog::warning(tag, msg);
+            if (epsInfo.Sgu > (1.0 - epsInfo.Swl + tolerance)) {
+                messages[thread].push_back(cellMessage("SGU exceed 1.0 - SWL"));
             }
             
             // SGL <= 1.0 - SWU
-            if (scaledEpsInfo_[c].Sgl > (1.0 - scaledEpsInfo_[c].Swu + tolerance)) {
-                const std::string msg = "For scaled endpoints input, cell" + cellIdx + " SATNUM = " + satnumIdx + ", SGL exceed 1.0 - SWU";
-                OpmLog::warning(tag, msg);
+            if (epsInfo.Sgl > (1.0 - epsInfo.Swu + tolerance)) {
+                messages[thread].push_back(cellMessage("SGL exceed 1.0 - SWU"));
             }
 
-            if (deck.hasKeyword("SCALECRS") && fluidSystem_ == FluidSystem::BlackOil) {
+            if (checkMobility) {
                 // Mobilility check.
-		    if ((scaledEpsInfo_[c].Sowcr + scaledEpsInfo_[c].Swcr) >= (1.0 + tolerance)) {
-                    const std::string msg = "For scaled endpoints input, cell" + cellIdx + " SATNUM = " + satnumIdx + ", SOWCR + SWCR exceed 1.0";
-                    OpmLog::warning(tag, msg);
+                if ((epsInfo.Sowcr + epsInfo.Swcr) >= (1.0 + tolerance)) {
+                    messages[thread].push_back(cellMessage("SOWCR + SWCR exceed 1.0"));
                 }
 
-            if ((scaledEpsInfo_[c].Sogcr + scaledEpsInfo_[c].Sgcr + scaledEpsInfo_[c].Swl) >= (1.0 + tolerance)) {
-                    const std::string msg = "For scaled endpoints input, cell" + cellIdx + " SATNUM = " + satnumIdx + ", SOGCR + SGCR + SWL exceed 1.0";
-                    OpmLog::warning(tag, msg);
+                if ((epsInfo.Sogcr + epsInfo.Sgcr + epsInfo.Swl) >= (1.0 + tolerance)) {
+                    messages[thread].push_back(cellMessage("SOGCR + SGCR + SWL exceed 1.0"));
                 }
             }
         } 
+
+        const std::string tag = "Scaled endpoints";
+        for (const auto& threadMessages : messages) {
+            for (const auto& msg : threadMessages) {
+                OpmLog::warning(tag, msg);
+            }
+        }
     }
 
 } //namespace Opm
@@ -0,0 +1,122 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_BINARYSERIALIZATION_HEADER_INCLUDED
+#define OPM_BINARYSERIALIZATION_HEADER_INCLUDED
+
+#include <opm/common/ErrorMacros.hpp>
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace Opm
+{
+
+    /// \brief Binary serialization of the simulator state for checkpoints.
+    ///
+    /// The values are written as their bytes in memory, and the vectors and
+    /// strings as their size followed by the bytes of their elements, hence
+    /// a state is restored bit by bit on a machine of the same architecture.
+    /// A failure of the stream throws.
+    namespace BinarySerialization
+    {
+
+        template <class T>
+        void write(std::ostream& os, const T& value)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable values are written as bytes");
+            os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+            if (!os) {
+                OPM_THROW(std::runtime_error, "Writing " << sizeof(T) << " bytes of a checkpoint failed");
+            }
+        }
+
+        template <class T>
+        void read(std::istream& is, T& value)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable values are read as bytes");
+            is.read(reinterpret_cast<char*>(&value), sizeof(T));
+            if (!is) {
+                OPM_THROW(std::runtime_error, "Reading " << sizeof(T) << " bytes of a checkpoint failed");
+            }
+        }
+
+        template <class T>
+        void write(std::ostream& os, const std::vector<T>& values)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "Only vectors of trivially copyable values are written as bytes");
+            write(os, std::uint64_t(values.size()));
+            if (!values.empty()) {
+                os.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+            }
+            if (!os) {
+                OPM_THROW(std::runtime_error, "Writing " << values.size() << " values of a checkpoint failed");
+            }
+        }
+
+        template <class T>
+        void read(std::istream& is, std::vector<T>& values)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "Only vectors of trivially copyable values are read as bytes");
+            std::uint64_t size = 0;
+            read(is, size);
+            values.resize(size);
+            if (size > 0) {
+                is.read(reinterpret_cast<char*>(values.data()), size * sizeof(T));
+            }
+            if (!is) {
+                OPM_THROW(std::runtime_error, "Reading " << size << " values of a checkpoint failed");
+            }
+        }
+
+        // std::vector<bool> has no contiguous storage, its values are written as bytes
+        inline void write(std::ostream& os, const std::vector<bool>& values)
+        {
+            write(os, std::vector<unsigned char>(values.begin(), values.end()));
+        }
+
+        inline void read(std::istream& is, std::vector<bool>& values)
+        {
+            std::vector<unsigned char> bytes;
+            read(is, bytes);
+            values.assign(bytes.begin(), bytes.end());
+        }
+
+        inline void write(std::ostream& os, const std::string& text)
+        {
+            write(os, std::vector<char>(text.begin(), text.end()));
+        }
+
+        inline void read(std::istream& is, std::string& text)
+        {
+            std::vector<char> chars;
+            read(is, chars);
+            text.assign(chars.begin(), chars.end());
+        }
+
+    } // namespace BinarySerialization
+
+} // namespace Opm
+
+#endif // OPM_BINARYSERIALIZATION_HEADER_INCLUDED
@@ -0,0 +1,105 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+
+#include <opm/core/simulator/PerformanceComparison.hpp>
+#include <opm/common/ErrorMacros.hpp>
+
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+#include <stdexcept>
+
+namespace Opm
+{
+
+    namespace
+    {
+        boost::property_tree::ptree readReport(std::istream& is)
+        {
+            boost::property_tree::ptree report;
+            try {
+                boost::property_tree::read_json(is, report);
+            }
+            catch (const boost::property_tree::json_parser_error& e) {
+                OPM_THROW(std::runtime_error, "Reading a performance report failed: " << e.what());
+            }
+            return report;
+        }
+    } // anonymous namespace
+
+
+
+    PerformanceComparison::PerformanceComparison(std::istream& reference,
+                                                 std::istream& test,
+                                                 const double iterationBudget,
+                                                 const double timeBudget)
+    {
+        const auto referenceReport = readReport(reference);
+        const auto testReport = readReport(test);
+
+        for (const char* name : { "newton_iterations", "linear_iterations" }) {
+            const std::string path = std::string("total.") + name;
+            metrics_.push_back({ name, referenceReport.get<double>(path, 0.0),
+                                 testReport.get<double>(path, 0.0), iterationBudget });
+        }
+
+        const double referenceCalibration = referenceReport.get<double>("calibration_time", 0.0);
+        const double testCalibration = testReport.get<double>("calibration_time", 0.0);
+        timesCompared_ = referenceCalibration > 0.0 && testCalibration > 0.0;
+        if (timesCompared_) {
+            for (const char* name : { "assemble_time", "linear_solve_time", "solver_time" }) {
+                const std::string path = std::string("total.") + name;
+                metrics_.push_back({ std::string("relative_") + name,
+                                     referenceReport.get<double>(path, 0.0) / referenceCalibration,
+                                     testReport.get<double>(path, 0.0) / testCalibration, timeBudget });
+            }
+        }
+    }
+
+    bool PerformanceComparison::regressed() const
+    {
+        return std::any_of(metrics_.begin(), metrics_.end(),
+                           [](const Metric& metric) { return metric.regressed(); });
+    }
+
+    void PerformanceComparison::report(std::ostream& os) const
+    {
+        os << std::left << std::setw(28) << "Metric" << std::right
+           << std::setw(14) << "Reference" << std::setw(14) << "Test"
+           << std::setw(10) << "Change" << std::setw(10) << "Budget" << "\n";
+        for (const auto& metric : metrics_) {
+            const double change = metric.reference > 0.0 ? metric.value / metric.reference - 1.0 : 0.0;
+            os << std::left << std::setw(28) << metric.name << std::right
+               << std::setprecision(6) << std::setw(14) << metric.reference << std::setw(14) << metric.value
+               << std::fixed << std::setprecision(1)
+               << std::setw(9) << 100.0 * change << "%" << std::setw(9) << 100.0 * metric.budget << "%"
+               << (metric.regressed() ? "  REGRESSED" : "") << "\n";
+            os.unsetf(std::ios::floatfield);
+        }
+        if (!timesCompared_) {
+            os << "The times are not compared since a report has no calibration time.\n";
+        }
+    }
+
+} // namespace Opm
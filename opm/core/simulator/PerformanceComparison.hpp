@@ -0,0 +1,76 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_PERFORMANCECOMPARISON_HEADER_INCLUDED
+#define OPM_PERFORMANCECOMPARISON_HEADER_INCLUDED
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace Opm
+{
+
+    /// The comparison of the key metrics of two JSON documents written by
+    /// PerformanceReport::writeJson(), a reference and a test run of the
+    /// same case, for the performance regression tests.
+    ///
+    /// The Newton and linear iterations of the totals may exceed those of
+    /// the reference by a relative iteration budget. The assembly, linear
+    /// solve and solver times are compared relative to the calibration
+    /// times of the runs, which makes reports of different machines
+    /// comparable, and may exceed the reference by a relative time budget.
+    /// The times are not compared if a report has no calibration time.
+    class PerformanceComparison
+    {
+    public:
+        struct Metric
+        {
+            std::string name;
+            double reference;
+            double value;
+            double budget;
+
+            bool regressed() const
+            { return value > reference * (1.0 + budget); }
+        };
+
+        /// Throws std::runtime_error if a report cannot be read.
+        PerformanceComparison(std::istream& reference,
+                              std::istream& test,
+                              const double iterationBudget,
+                              const double timeBudget);
+
+        const std::vector<Metric>& metrics() const
+        { return metrics_; }
+
+        /// Whether any metric exceeds its budget.
+        bool regressed() const;
+
+        /// Print a table of the metrics and whether they regressed.
+        void report(std::ostream& os) const;
+
+    private:
+        std::vector<Metric> metrics_;
+        bool timesCompared_;
+    };
+
+} // namespace Opm
+
+#endif // OPM_PERFORMANCECOMPARISON_HEADER_INCLUDED
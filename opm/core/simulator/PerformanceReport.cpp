@@ -0,0 +1,199 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+
+#include <opm/core/simulator/PerformanceReport.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <limits>
+#include <ostream>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+namespace Opm
+{
+
+    namespace
+    {
+        // The names of the columns and JSON fields, in the order of writeFields().
+        const char* const fieldNames[] = {
+            "solver_time", "assemble_time", "linear_solve_time", "update_time", "output_write_time",
+            "well_iterations", "linearizations", "newton_iterations", "linear_iterations",
+            "failed_steps", "failed_solver_time", "failed_assemble_time",
+            "failed_linear_solve_time", "failed_update_time", "failed_newton_iterations",
+            "failed_linear_iterations"
+        };
+
+        template <class Write>
+        void writeFields(const SimulatorReport& step, const SimulatorReport& failed, Write&& write)
+        {
+            write(step.solver_time);
+            write(step.assemble_time);
+            write(step.linear_solve_time);
+            write(step.update_time);
+            write(step.output_write_time);
+            write(step.total_well_iterations);
+            write(step.total_linearizations);
+            write(step.total_newton_iterations);
+            write(step.total_linear_iterations);
+            write(failed.total_failed_steps);
+            write(failed.solver_time);
+            write(failed.assemble_time);
+            write(failed.linear_solve_time);
+            write(failed.update_time);
+            write(failed.total_newton_iterations);
+            write(failed.total_linear_iterations);
+        }
+
+        void writeJsonFields(std::ostream& os, const SimulatorReport& step,
+                             const SimulatorReport& failed, const std::string& indent)
+        {
+            int field = 0;
+            writeFields(step, failed, [&](const double value) {
+                    os << (field == 0 ? "" : ",\n") << indent
+                       << '"' << fieldNames[field] << "\": " << value;
+                    ++field;
+                });
+        }
+    } // anonymous namespace
+
+
+
+    PerformanceReport::PerformanceReport(const std::string& csvFileName)
+    {
+        if (!csvFileName.empty()) {
+            csv_.open(csvFileName);
+            csv_ << "report_step";
+            for (const char* name : fieldNames) {
+                csv_ << ',' << name;
+            }
+            csv_ << '\n';
+            csv_.flush();
+        }
+    }
+
+    void PerformanceReport::addReportStep(const int reportStep,
+                                          const SimulatorReport& step,
+                                          const SimulatorReport& failed)
+    {
+        steps_.push_back({ reportStep, step, failed });
+        if (csv_.is_open()) {
+            csv_ << reportStep << std::setprecision(8);
+            writeFields(step, failed, [this](const double value) { csv_ << ',' << value; });
+            csv_ << '\n';
+            csv_.flush();
+        }
+    }
+
+    void PerformanceReport::writeJson(std::ostream& os,
+                                      const std::vector<double>& peakMemoryPerProcess,
+                                      const std::vector<SubsystemMemory>& subsystemMemory) const
+    {
+        SimulatorReport total;
+        SimulatorReport totalFailed;
+        for (const auto& step : steps_) {
+            total += step.step;
+            totalFailed += step.failed;
+        }
+
+        os << std::setprecision(8) << "{\n  \"report_steps\": [";
+        for (std::size_t i = 0; i < steps_.size(); ++i) {
+            os << (i == 0 ? "\n" : ",\n")
+               << "    {\n      \"report_step\": " << steps_[i].report_step << ",\n";
+            writeJsonFields(os, steps_[i].step, steps_[i].failed, "      ");
+            os << "\n    }";
+        }
+        os << "\n  ],\n  \"total\": {\n";
+        writeJsonFields(os, total, totalFailed, "    ");
+        os << "\n  },\n  \"peak_memory_bytes\": [";
+        for (std::size_t p = 0; p < peakMemoryPerProcess.size(); ++p) {
+            os << (p == 0 ? "" : ", ") << peakMemoryPerProcess[p];
+        }
+        os << "]";
+        if (calibration_time_ > 0.0) {
+            os << ",\n  \"calibration_time\": " << calibration_time_;
+        }
+        if (!stage_times_.empty()) {
+            os << ",\n  \"max_stage_times\": {";
+            for (std::size_t i = 0; i < stage_times_.size(); ++i) {
+                os << (i == 0 ? "\n" : ",\n") << "    \"" << stage_times_[i].first << "\": " << stage_times_[i].second;
+            }
+            os << "\n  }";
+        }
+        if (!subsystemMemory.empty()) {
+            os << ",\n  \"peak_memory_bytes_by_subsystem\": {";
+            for (std::size_t i = 0; i < subsystemMemory.size(); ++i) {
+                os << (i == 0 ? "\n" : ",\n") << "    \"" << subsystemMemory[i].first << "\": [";
+                const auto& perProcess = subsystemMemory[i].second;
+                for (std::size_t p = 0; p < perProcess.size(); ++p) {
+                    os << (p == 0 ? "" : ", ") << perProcess[p];
+                }
+                os << "]";
+            }
+            os << "\n  }";
+        }
+        os << "\n}\n";
+    }
+
+    double PerformanceReport::peakResidentSetSize()
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#if defined(__APPLE__)
+            return usage.ru_maxrss;
+#else
+            // kilobytes on Linux
+            return 1024.0 * usage.ru_maxrss;
+#endif
+        }
+#endif
+        return 0.0;
+    }
+
+    double PerformanceReport::calibrationTime()
+    {
+        // three vectors of 32 MB each, beyond the caches
+        const std::size_t n = 1 << 22;
+        std::vector<double> x(n, 1.0);
+        std::vector<double> y(n, 2.0);
+        std::vector<double> z(n, 0.0);
+        double best = std::numeric_limits<double>::max();
+        for (int repetition = 0; repetition < 5; ++repetition) {
+            const auto start = std::chrono::steady_clock::now();
+            for (std::size_t i = 0; i < n; ++i) {
+                z[i] = x[i] + 0.5 * y[i];
+            }
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            best = std::min(best, elapsed.count());
+            std::swap(x, z);
+        }
+        // keep the compiler from dropping the loop
+        volatile double sink = x[n / 2];
+        static_cast<void>(sink);
+        return best;
+    }
+
+} // namespace Opm
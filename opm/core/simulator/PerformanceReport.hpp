@@ -0,0 +1,101 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_PERFORMANCEREPORT_HEADER_INCLUDED
+#define OPM_PERFORMANCEREPORT_HEADER_INCLUDED
+
+#include <opm/core/simulator/SimulatorReport.hpp>
+
+#include <fstream>
+#include <iosfwd>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Opm
+{
+
+    /// The timings and iteration counts of each report step in a machine
+    /// readable form, for tools that would otherwise parse the log files.
+    ///
+    /// The report steps are written as a JSON document by writeJson(), and
+    /// optionally as lines of a CSV file as soon as they are recorded.
+    class PerformanceReport
+    {
+    public:
+        /// \param csvFileName  If not empty, the file to which a line is
+        ///                     written for each recorded report step.
+        explicit PerformanceReport(const std::string& csvFileName = "");
+
+        /// Record a report step.
+        /// \param reportStep  The index of the report step.
+        /// \param step        The report of the converged substeps.
+        /// \param failed      The report of the failed substeps.
+        void addReportStep(const int reportStep,
+                           const SimulatorReport& step,
+                           const SimulatorReport& failed);
+
+        /// The peak bytes of each process for one subsystem.
+        typedef std::pair<std::string, std::vector<double>> SubsystemMemory;
+
+        /// Write the recorded report steps, their totals and the peak
+        /// resident set size of each process (in bytes) as JSON, and the
+        /// peak memory of the subsystems of each process if given.
+        void writeJson(std::ostream& os,
+                       const std::vector<double>& peakMemoryPerProcess,
+                       const std::vector<SubsystemMemory>& subsystemMemory = {}) const;
+
+        /// The largest resident set size of this process so far in bytes,
+        /// zero if the platform does not tell.
+        static double peakResidentSetSize();
+
+        /// The time of a memory bound calibration kernel in seconds, which
+        /// is written with the report if set. The times of reports from
+        /// different machines are comparable relative to it.
+        void setCalibrationTime(const double seconds)
+        { calibration_time_ = seconds; }
+
+        /// The largest total time over the processes of a stage of the run.
+        typedef std::pair<std::string, double> StageTime;
+
+        /// The stage times, which are written with the report if set.
+        void setStageTimes(const std::vector<StageTime>& stageTimes)
+        { stage_times_ = stageTimes; }
+
+        /// Measure the best time of a vector update of the size of a large
+        /// sparse matrix vector product on this machine.
+        static double calibrationTime();
+
+    private:
+        struct Step
+        {
+            int report_step;
+            SimulatorReport step;
+            SimulatorReport failed;
+        };
+
+        std::vector<Step> steps_;
+        std::ofstream csv_;
+        double calibration_time_ = 0.0;
+        std::vector<StageTime> stage_times_;
+    };
+
+} // namespace Opm
+
+#endif // OPM_PERFORMANCEREPORT_HEADER_INCLUDED
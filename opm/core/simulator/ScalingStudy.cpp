@@ -0,0 +1,120 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+
+#include <opm/core/simulator/ScalingStudy.hpp>
+#include <opm/common/ErrorMacros.hpp>
+
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+#include <stdexcept>
+
+namespace Opm
+{
+
+    ScalingStudy::ScalingStudy(const Scaling scaling)
+        : scaling_(scaling)
+    {
+    }
+
+    const std::vector<std::string>& ScalingStudy::stages()
+    {
+        static const std::vector<std::string> names = { "solver", "assembly", "wells", "linear_solve", "communication" };
+        return names;
+    }
+
+    void ScalingStudy::addRun(const int processes, const int threads, std::istream& report)
+    {
+        boost::property_tree::ptree tree;
+        try {
+            boost::property_tree::read_json(report, tree);
+        }
+        catch (const boost::property_tree::json_parser_error& e) {
+            OPM_THROW(std::runtime_error, "Reading the performance report of " << processes
+                      << " processes failed: " << e.what());
+        }
+
+        Run run{ processes, threads, {} };
+        run.times.push_back(tree.get<double>("total.solver_time", 0.0));
+        for (std::size_t stage = 1; stage < stages().size(); ++stage) {
+            run.times.push_back(tree.get<double>("max_stage_times." + stages()[stage], 0.0));
+        }
+        runs_.push_back(run);
+    }
+
+    double ScalingStudy::time(const std::size_t run, const std::size_t stage) const
+    {
+        return runs_[run].times[stage];
+    }
+
+    double ScalingStudy::efficiency(const std::size_t run, const std::size_t stage) const
+    {
+        const Run& baseline = baseline_();
+        const double time = runs_[run].times[stage];
+        if (baseline.times[stage] <= 0.0 || time <= 0.0) {
+            return 0.0;
+        }
+        const double efficiency = baseline.times[stage] / time;
+        if (scaling_ == Weak) {
+            return efficiency;
+        }
+        return efficiency * baseline.processes * baseline.threads
+            / (runs_[run].processes * runs_[run].threads);
+    }
+
+    void ScalingStudy::report(std::ostream& os) const
+    {
+        os << (scaling_ == Strong ? "Strong" : "Weak") << " scaling, time (s) and efficiency of the stages\n"
+           << std::right << std::setw(10) << "Processes" << std::setw(9) << "Threads";
+        for (const auto& stage : stages()) {
+            os << std::setw(22) << stage;
+        }
+        os << "\n";
+        for (std::size_t run = 0; run < runs_.size(); ++run) {
+            os << std::setw(10) << runs_[run].processes << std::setw(9) << runs_[run].threads;
+            for (std::size_t stage = 0; stage < stages().size(); ++stage) {
+                const double efficiency = this->efficiency(run, stage);
+                os << std::fixed << std::setprecision(3) << std::setw(14) << runs_[run].times[stage];
+                if (efficiency > 0.0) {
+                    os << std::setprecision(1) << std::setw(7) << 100.0 * efficiency << "%";
+                }
+                else {
+                    os << std::setw(8) << "-";
+                }
+            }
+            os << "\n";
+        }
+    }
+
+    const ScalingStudy::Run& ScalingStudy::baseline_() const
+    {
+        if (runs_.empty()) {
+            OPM_THROW(std::logic_error, "A scaling study without runs has no baseline");
+        }
+        return *std::min_element(runs_.begin(), runs_.end(), [](const Run& a, const Run& b) {
+                return a.processes * a.threads < b.processes * b.threads;
+            });
+    }
+
+} // namespace Opm
@@ -0,0 +1,81 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_SCALINGSTUDY_HEADER_INCLUDED
+#define OPM_SCALINGSTUDY_HEADER_INCLUDED
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace Opm
+{
+
+    /// The scaling efficiency of the stages of runs at several process
+    /// and thread counts, from the JSON documents written by
+    /// PerformanceReport::writeJson().
+    ///
+    /// The baseline is the run with the fewest cores, i.e. processes times
+    /// threads. For strong scaling (the same case on more cores) the
+    /// efficiency of a stage is its baseline time times the baseline cores
+    /// relative to its time times the cores, for weak scaling (a case of a
+    /// size proportional to the cores) it is its baseline time relative to
+    /// its time. The stages are the total solver time and the largest stage
+    /// times over the processes, where the well and communication times
+    /// require the timing report of the linear solver.
+    class ScalingStudy
+    {
+    public:
+        enum Scaling { Strong, Weak };
+
+        explicit ScalingStudy(const Scaling scaling);
+
+        /// Add the report of a run. Throws std::runtime_error if it cannot be read.
+        void addRun(const int processes, const int threads, std::istream& report);
+
+        /// The names of the stages, in the order of the columns of report().
+        static const std::vector<std::string>& stages();
+
+        /// The time of a stage of a run, in the order of addRun().
+        double time(const std::size_t run, const std::size_t stage) const;
+
+        /// The efficiency of a stage of a run, zero if the stage of the
+        /// baseline took no time.
+        double efficiency(const std::size_t run, const std::size_t stage) const;
+
+        /// Print a table of the times and efficiencies of all runs.
+        void report(std::ostream& os) const;
+
+    private:
+        struct Run
+        {
+            int processes;
+            int threads;
+            std::vector<double> times;
+        };
+
+        const Run& baseline_() const;
+
+        Scaling scaling_;
+        std::vector<Run> runs_;
+    };
+
+} // namespace Opm
+
+#endif // OPM_SCALINGSTUDY_HEADER_INCLUDED
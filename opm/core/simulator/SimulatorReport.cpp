@@ -40,6 +40,10 @@ namespace Opm
           total_linearizations( 0 ),
           total_newton_iterations( 0 ),
           total_linear_iterations( 0 ),
+          total_preconditioner_setups( 0 ),
+          total_preconditioner_reuses( 0 ),
+          total_tail_steps_avoided( 0 ),
+          total_failed_steps( 0 ),
           converged(false),
           verbose_(verbose)
     {
@@ -59,6 +63,10 @@ namespace Opm
         total_linearizations += sr.total_linearizations;
         total_newton_iterations += sr.total_newton_iterations;
         total_linear_iterations += sr.total_linear_iterations;
+        total_preconditioner_setups += sr.total_preconditioner_setups;
+        total_preconditioner_reuses += sr.total_preconditioner_reuses;
+        total_tail_steps_avoided += sr.total_tail_steps_avoided;
+        total_failed_steps += sr.total_failed_steps;
     }
 
     void SimulatorReport::report(std::ostream& os)
@@ -87,6 +95,10 @@ namespace Opm
                << " ("  << std::fixed << std::setprecision(3) << std::setw(6) << assemble_time << " sec), "
                << "linear its = " << std::setw(3) << total_linear_iterations
                << " ("  << std::fixed << std::setprecision(3) << std::setw(6) << linear_solve_time << " sec)";
+            if (total_preconditioner_reuses != 0) {
+                ss << ", prec. setups = " << std::setw(2) << total_preconditioner_setups
+                   << ", reuses = " << std::setw(2) << total_preconditioner_reuses;
+            }
         }
     }
 
@@ -164,6 +176,45 @@ namespace Opm
                    << 100.0*failureReport->total_linear_iterations/n << "%)";
             }
             os << std::endl;
+
+            n = total_preconditioner_setups + (failureReport ? failureReport->total_preconditioner_setups : 0);
+            os << "Overall Prec. Setups:         " << n;
+            if (failureReport) {
+                os << " (Failed: " << failureReport->total_preconditioner_setups << "; "
+                   << 100.0*failureReport->total_preconditioner_setups/n << "%)";
+            }
+            os << std::endl;
+
+            n = total_preconditioner_reuses + (failureReport ? failureReport->total_preconditioner_reuses : 0);
+            os << "Overall Prec. Reuses:         " << n;
+            if (failureReport) {
+                os << " (Failed: " << failureReport->total_preconditioner_reuses << "; "
+                   << 100.0*failureReport->total_preconditioner_reuses/n << "%)";
+            }
+            os << std::endl;
+
+            if (total_tail_steps_avoided != 0) {
+                os << "Tail Substeps Avoided:        " << total_tail_steps_avoided;
+                os << std::endl;
+            }
+
+            if (failureReport && failureReport->total_failed_steps != 0) {
+                os << "Failed Substeps:              " << failureReport->total_failed_steps;
+                os << std::endl;
+            }
+
+            // Cost ratios of the linear solver, including the failed steps.
+            const int newtonIts = total_newton_iterations + (failureReport ? failureReport->total_newton_iterations : 0);
+            const int linearIts = total_linear_iterations + (failureReport ? failureReport->total_linear_iterations : 0);
+            if (newtonIts > 0) {
+                os << "Linear Its. per Newton It.:   " << static_cast<double>(linearIts)/newtonIts;
+                os << std::endl;
+            }
+            if (linearIts > 0) {
+                t = linear_solve_time + (failureReport ? failureReport->linear_solve_time : 0.0);
+                os << "Seconds per Linear It.:       " << t/linearIts;
+                os << std::endl;
+            }
         }
     }
 
@@ -41,6 +41,10 @@ namespace Opm
         unsigned int total_linearizations;
         unsigned int total_newton_iterations;
         unsigned int total_linear_iterations;
+        unsigned int total_preconditioner_setups;
+        unsigned int total_preconditioner_reuses;
+        unsigned int total_tail_steps_avoided;
+        unsigned int total_failed_steps;
 
         bool converged;
 
@@ -21,6 +21,7 @@
 #define OPM_WELLSTATE_HEADER_INCLUDED
 
 #include <opm/core/props/BlackoilPhases.hpp>
+#include <opm/core/simulator/BinarySerialization.hpp>
 #include <opm/core/wells.h>
 #include <opm/core/well_controls.h>
 #include <opm/output/data/Wells.hpp>
@@ -32,6 +33,10 @@
 #include <vector>
 #include <cassert>
 #include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
 
 namespace Opm
 {
@@ -56,8 +61,9 @@ namespace Opm
         void init(const Wells* wells, const std::vector<double>& cellPressures)
         {
             // clear old name mapping
-            wellMap_.clear();
-            wells_.reset( clone_wells( wells ) );
+            // a new map, the old one may be shared with copies of this state
+            wellMap_ = std::make_shared<WellMapType>();
+            wells_.reset( clone_wells( wells ), wdel() );
 
             if (wells) {
                 const int nw = wells->number_of_wells;
@@ -76,7 +82,7 @@ namespace Opm
                         assert( wells->name[ w ] );
                         std::string name( wells->name[ w ] );
                         assert( name.size() > 0 );
-                        mapentry_t& wellMapEntry = wellMap_[name];
+                        mapentry_t& wellMapEntry = (*wellMap_)[name];
                         wellMapEntry[ 0 ] = w;
                         wellMapEntry[ 1 ] = wells->well_connpos[w];
                         // also store the number of perforations in this well
@@ -209,8 +215,15 @@ namespace Opm
             return getRestartTemperatureOffset() + temperature_.size();
         }
 
-        const WellMapType& wellMap() const { return wellMap_; }
-        WellMapType& wellMap() { return wellMap_; }
+        const WellMapType& wellMap() const { return *wellMap_; }
+        WellMapType& wellMap()
+        {
+            // copy on write, the map is shared with the copies of this state
+            if ( wellMap_.use_count() > 1 ) {
+                wellMap_ = std::make_shared<WellMapType>( *wellMap_ );
+            }
+            return *wellMap_;
+        }
 
         /// The number of wells present.
         int numWells() const
@@ -229,10 +242,12 @@ namespace Opm
             using rt = data::Rates::opt;
 
             data::Wells dw;
-            for( const auto& itr : this->wellMap_ ) {
+            // the well map is sorted by name as well, hence each well is appended
+            // at the end of the output without searching for its position
+            for( const auto& itr : this->wellMap() ) {
                 const auto well_index = itr.second[ 0 ];
 
-                auto& well = dw[ itr.first ];
+                auto& well = dw.emplace_hint( dw.end(), itr.first, data::Well() )->second;
                 well.bhp = this->bhp().at( well_index );
                 well.thp = this->thp().at( well_index );
                 well.temperature = this->temperature().at( well_index );
@@ -271,32 +286,71 @@ namespace Opm
 
         }
 
+        /// The bytes of the arrays, for the memory report.
+        virtual std::size_t memoryBytes() const
+        {
+            return (bhp_.capacity() + thp_.capacity() + temperature_.capacity() + wellrates_.capacity()
+                    + perfrates_.capacity() + perfpress_.capacity()) * sizeof(double);
+        }
+
+        /// Write the arrays and the well map in binary for a checkpoint.
+        /// The wells themselves are not written, they are set up from the
+        /// schedule again when the simulation is resumed.
+        virtual void serialize(std::ostream& os) const
+        {
+            using namespace BinarySerialization;
+            write(os, bhp_);
+            write(os, thp_);
+            write(os, temperature_);
+            write(os, wellrates_);
+            write(os, perfrates_);
+            write(os, perfpress_);
+            write(os, std::uint64_t(wellMap().size()));
+            for (const auto& entry : wellMap()) {
+                write(os, entry.first);
+                write(os, entry.second);
+            }
+        }
+
+        /// Read a state written by serialize(). The wells of an initialized
+        /// state are kept, and have to be those of the written state.
+        virtual void deserialize(std::istream& is)
+        {
+            using namespace BinarySerialization;
+            read(is, bhp_);
+            read(is, thp_);
+            read(is, temperature_);
+            read(is, wellrates_);
+            read(is, perfrates_);
+            read(is, perfpress_);
+            std::uint64_t numEntries = 0;
+            read(is, numEntries);
+            wellMap_ = std::make_shared<WellMapType>();
+            for (std::uint64_t i = 0; i < numEntries; ++i) {
+                std::string name;
+                mapentry_t entry;
+                read(is, name);
+                read(is, entry);
+                (*wellMap_)[name] = entry;
+            }
+
+            if (wells_) {
+                const int nw = wells_->number_of_wells;
+                if (int(bhp_.size()) != nw || int(perfpress_.size()) != wells_->well_connpos[nw]) {
+                    OPM_THROW(std::runtime_error, "The checkpoint of " << bhp_.size() << " wells with "
+                              << perfpress_.size() << " perforations does not match the "
+                              << nw << " wells with " << wells_->well_connpos[nw] << " perforations");
+                }
+            }
+        }
+
         virtual ~WellState() {}
 
+        // The copies share the wells and the well map, which only change in
+        // init(), hence saving and restoring a state only copies the arrays.
         WellState() = default;
-        WellState( const WellState& rhs ) :
-            bhp_( rhs.bhp_ ),
-            thp_( rhs.thp_ ),
-            temperature_( rhs.temperature_ ),
-            wellrates_( rhs.wellrates_ ),
-            perfrates_( rhs.perfrates_ ),
-            perfpress_( rhs.perfpress_ ),
-            wellMap_( rhs.wellMap_ ),
-            wells_( clone_wells( rhs.wells_.get() ) )
-        {}
-
-        WellState& operator=( const WellState& rhs ) {
-            this->bhp_ = rhs.bhp_;
-            this->thp_ = rhs.thp_;
-            this->temperature_ = rhs.temperature_;
-            this->wellrates_ = rhs.wellrates_;
-            this->perfrates_ = rhs.perfrates_;
-            this->perfpress_ = rhs.perfpress_;
-            this->wellMap_ = rhs.wellMap_;
-            this->wells_.reset( clone_wells( rhs.wells_.get() ) );
-
-            return *this;
-        }
+        WellState( const WellState& rhs ) = default;
+        WellState& operator=( const WellState& rhs ) = default;
 
     private:
         std::vector<double> bhp_;
@@ -306,13 +360,13 @@ namespace Opm
         std::vector<double> perfrates_;
         std::vector<double> perfpress_;
 
-        WellMapType wellMap_;
+        std::shared_ptr<WellMapType> wellMap_ = std::make_shared<WellMapType>();
 
     protected:
         struct wdel {
             void operator()( Wells* w ) { destroy_wells( w ); }
         };
-        std::unique_ptr< Wells, wdel > wells_;
+        std::shared_ptr< const Wells > wells_;
     };
 
 } // namespace Opm
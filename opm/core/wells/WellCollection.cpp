@@ -25,6 +25,8 @@
 
 #include <boost/lexical_cast.hpp>
 
+#include <cassert>
+#include <cmath>
 #include <memory>
 
 namespace Opm
@@ -36,6 +38,7 @@ namespace Opm
         }
 
         roots_.push_back(createGroupWellsGroup(fieldGroup, timeStep, phaseUsage));
+        addNodeName(roots_.back().get());
     }
 
     void WellCollection::addGroup(const Group& groupChild, std::string parent_name,
@@ -66,6 +69,7 @@ namespace Opm
         }
         parent_as_group->addChild(child);
         child->setParent(parent);
+        addNodeName(child.get());
     }
 
     void WellCollection::addWell(const Well* wellChild, size_t timeStep, const PhaseUsage& phaseUsage) {
@@ -87,7 +91,8 @@ namespace Opm
         }
         parent_as_group->addChild(child);
 
-        leaf_nodes_.push_back(static_cast<WellNode*>(child.get()));
+        addLeafNode(static_cast<WellNode*>(child.get()));
+        addNodeName(child.get());
 
         child->setParent(parent);
     }
@@ -98,42 +103,59 @@ namespace Opm
 
     WellsGroupInterface* WellCollection::findNode(const std::string& name)
     {
-
-        for (size_t i = 0; i < roots_.size(); i++) {
-            WellsGroupInterface* result = roots_[i]->findGroup(name);
-            if (result) {
-                return result;
-            }
-        }
-        return NULL;
+        const auto node = nodes_.find(name);
+        return node == nodes_.end() ? NULL : node->second;
     }
 
     const WellsGroupInterface* WellCollection::findNode(const std::string& name) const
     {
-
-        for (size_t i = 0; i < roots_.size(); i++) {
-            WellsGroupInterface* result = roots_[i]->findGroup(name);
-            if (result) {
-                return result;
-            }
-        }
-        return NULL;
+        const auto node = nodes_.find(name);
+        return node == nodes_.end() ? NULL : node->second;
     }
 
 
     WellNode& WellCollection::findWellNode(const std::string& name) const
     {
-        auto well_node = std::find_if(leaf_nodes_.begin(), leaf_nodes_.end(),
-                    [&] ( WellNode* w) {
-                    return w->name() == name;
-                    });
+        const auto well_node = well_nodes_.find(name);
 
         // Does not find the well
-        if (well_node == leaf_nodes_.end()) {
+        if (well_node == well_nodes_.end()) {
             OPM_THROW(std::runtime_error, "Could not find well " << name << " in the well collection!\n");
         }
 
-        return *(*well_node);
+        return *leaf_nodes_[well_node->second];
+    }
+
+    int WellCollection::findWellIndex(const std::string& name) const
+    {
+        const auto well_node = well_nodes_.find(name);
+        return well_node == well_nodes_.end() ? -1 : well_node->second;
+    }
+
+    WellNode& WellCollection::wellNode(const int index) const
+    {
+        assert(index >= 0 && index < static_cast<int>(leaf_nodes_.size()));
+        return *leaf_nodes_[index];
+    }
+
+    void WellCollection::addLeafNode(WellNode* well_node)
+    {
+        leaf_nodes_.push_back(well_node);
+        // the first well of a name is found, as with a search of leaf_nodes_
+        well_nodes_.emplace(well_node->name(), static_cast<int>(leaf_nodes_.size()) - 1);
+    }
+
+    void WellCollection::addNodeName(WellsGroupInterface* node)
+    {
+        // the first node of a name is kept, a later one is hidden by it as in a
+        // search of the trees
+        nodes_.emplace(node->name(), node);
+        post_order_nodes_.clear();
+        if (!node->isLeafNode()) {
+            for (const auto& child : static_cast<WellsGroup*>(node)->children()) {
+                addNodeName(child.get());
+            }
+        }
     }
 
     /// Adds the child to the collection
@@ -151,9 +173,9 @@ namespace Opm
         assert(!parent->isLeafNode());
         static_cast<WellsGroup*>(parent)->addChild(child_node);
         if (child_node->isLeafNode()) {
-            leaf_nodes_.push_back(static_cast<WellNode*>(child_node.get()));
+            addLeafNode(static_cast<WellNode*>(child_node.get()));
         }
-
+        addNodeName(child_node.get());
     }
 
     /// Adds the node to the collection (as a root node)
@@ -162,8 +184,9 @@ namespace Opm
     {
         roots_.push_back(child_node);
         if (child_node->isLeafNode()) {
-            leaf_nodes_.push_back(static_cast<WellNode*> (child_node.get()));
+            addLeafNode(static_cast<WellNode*>(child_node.get()));
         }
+        addNodeName(child_node.get());
     }
 
     bool WellCollection::conditionsMet(const std::vector<double>& well_bhp,
@@ -341,14 +364,99 @@ namespace Opm
     {
         // TODO: eventually, there should be only one root node
         // TODO: we also need to check the injection target, while we have not done that.
-        for (const std::shared_ptr<WellsGroupInterface>& root_node : roots_) {
-            if ( !root_node->groupProdTargetConverged(well_rates) ) {
-                return false;
+
+        // The groups are checked in the order of WellsGroup::groupProdTargetConverged(),
+        // with the rates of the children summed up once instead of for every group
+        // above them.
+        if (post_order_nodes_.empty()) {
+            setupPostOrder();
+        }
+        const BlackoilPhases::PhaseIndex phases[3] = { BlackoilPhases::Liquid,
+                                                       BlackoilPhases::Aqua,
+                                                       BlackoilPhases::Vapour };
+        post_order_rates_.assign(post_order_nodes_.size(), {{ 0.0, 0.0, 0.0 }});
+        for (std::size_t i = 0; i < post_order_nodes_.size(); ++i) {
+            const WellsGroupInterface* node = post_order_nodes_[i];
+            auto& rates = post_order_rates_[i];
+            if (node->isLeafNode()) {
+                for (int p = 0; p < 3; ++p) {
+                    if (node->phaseUsage().phase_used[phases[p]]) {
+                        rates[p] = node->getTotalProductionFlow(well_rates, phases[p]);
+                    }
+                }
+            }
+            else {
+                const WellsGroup* group = static_cast<const WellsGroup*>(node);
+                double production_rate = 0.0;
+                if (group->usesProductionRate()) {
+                    switch (group->prodSpec().control_mode_) {
+                    case ProductionSpecification::LRAT:
+                        production_rate = rates[0] + rates[1];
+                        break;
+                    case ProductionSpecification::ORAT:
+                        production_rate = rates[0];
+                        break;
+                    case ProductionSpecification::WRAT:
+                        production_rate = rates[1];
+                        break;
+                    default:
+                        production_rate = rates[2];
+                        break;
+                    }
+                }
+                if (!group->ownProdTargetConverged(std::abs(production_rate))) {
+                    return false;
+                }
+            }
+
+            const int parent = post_order_parents_[i];
+            if (parent >= 0) {
+                for (int p = 0; p < 3; ++p) {
+                    post_order_rates_[parent][p] += rates[p] * node->efficiencyFactor();
+                }
             }
         }
         return true;
     }
 
+    void WellCollection::setupPostOrder() const
+    {
+        post_order_nodes_.clear();
+        post_order_parents_.clear();
+
+        // an explicit stack of the nodes and the next child to visit
+        std::vector<std::pair<const WellsGroupInterface*, std::size_t> > stack;
+        std::vector<int> pending_parents;
+        for (const auto& root : roots_) {
+            stack.emplace_back(root.get(), 0);
+            while (!stack.empty()) {
+                const WellsGroupInterface* node = stack.back().first;
+                const std::size_t next_child = stack.back().second;
+                const auto* group = node->isLeafNode() ? nullptr : static_cast<const WellsGroup*>(node);
+                if (group && next_child < group->children().size()) {
+                    ++stack.back().second;
+                    stack.emplace_back(group->children()[next_child].get(), 0);
+                    continue;
+                }
+                stack.pop_back();
+
+                // the parent gets its position after all its children
+                const int position = post_order_nodes_.size();
+                post_order_nodes_.push_back(node);
+                post_order_parents_.push_back(-1);
+                if (group) {
+                    const int num_children = group->children().size();
+                    for (int c = 0; c < num_children; ++c) {
+                        post_order_parents_[pending_parents.back()] = position;
+                        pending_parents.pop_back();
+                    }
+                }
+                pending_parents.push_back(position);
+            }
+            pending_parents.clear();
+        }
+    }
+
 
 
     void WellCollection::
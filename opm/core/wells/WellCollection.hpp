@@ -19,8 +19,11 @@
 #ifndef OPM_WELLCOLLECTION_HPP
 #define	OPM_WELLCOLLECTION_HPP
 
+#include <array>
 #include <vector>
 #include <memory>
+#include <string>
+#include <unordered_map>
 
 #include <opm/core/wells/WellsGroup.hpp>
 #include <opm/grid/UnstructuredGrid.h>
@@ -98,6 +101,15 @@ namespace Opm
 
         WellNode& findWellNode(const std::string& name) const;
 
+        /// Finds the index of the well with the given name among the leaf nodes,
+        /// which does not change when nodes are added and may be kept by the caller.
+        /// \param[in] the name of the well
+        /// \return the index of the well if found, -1 otherwise
+        int findWellIndex(const std::string& name) const;
+
+        /// The well with an index returned by findWellIndex().
+        WellNode& wellNode(const int index) const;
+
 
         /// Applies all group controls (injection and production)
         void applyGroupControls();
@@ -165,6 +177,28 @@ namespace Opm
         // This will be used to traverse the bottom nodes.
         std::vector<WellNode*> leaf_nodes_;
 
+        // The indices of the bottom nodes in leaf_nodes_ by name, for findWellNode().
+        std::unordered_map<std::string, int> well_nodes_;
+
+        // All nodes by name, for findNode().
+        std::unordered_map<std::string, WellsGroupInterface*> nodes_;
+
+        void addLeafNode(WellNode* well_node);
+
+        // Adds a node and the nodes below it to nodes_.
+        void addNodeName(WellsGroupInterface* node);
+
+        // The nodes of all trees in post order, i.e. the children of a group in
+        // their order before the group, and the position of the parent of each
+        // node in it, -1 for a root. Built by groupTargetConverged() when empty.
+        mutable std::vector<const WellsGroupInterface*> post_order_nodes_;
+        mutable std::vector<int> post_order_parents_;
+
+        // The oil, water and gas production rates of the nodes in post order.
+        mutable std::vector<std::array<double, 3> > post_order_rates_;
+
+        void setupPostOrder() const;
+
         bool having_vrep_groups_ = false;
 
         bool group_control_active_ = false;
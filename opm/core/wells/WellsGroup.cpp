@@ -453,6 +453,11 @@ namespace Opm
         children_.push_back(child);
     }
 
+    const std::vector<std::shared_ptr<WellsGroupInterface> >& WellsGroup::children() const
+    {
+        return children_;
+    }
+
 
     int WellsGroup::numberOfLeafNodes() {
         // This could probably use some caching, but seeing as how the number of
@@ -846,6 +851,28 @@ namespace Opm
             }
         }
 
+        const double production_rate = usesProductionRate()
+            ? std::abs(getProductionRate(well_rates, prodSpec().control_mode_)) : 0.0;
+        return ownProdTargetConverged(production_rate);
+    }
+
+
+    bool WellsGroup::usesProductionRate() const
+    {
+        switch(prodSpec().control_mode_) {
+            case ProductionSpecification::LRAT :
+            case ProductionSpecification::ORAT :
+            case ProductionSpecification::WRAT :
+            case ProductionSpecification::GRAT :
+                return true;
+            default:
+                return false;
+        }
+    }
+
+
+    bool WellsGroup::ownProdTargetConverged(const double production_rate) const
+    {
         // We need to check whether the current group target is satisfied
         // we need to decide the modes we want to support here.
         const ProductionSpecification::ControlMode prod_mode = prodSpec().control_mode_;
@@ -855,7 +882,6 @@ namespace Opm
             case ProductionSpecification::WRAT :
             case ProductionSpecification::GRAT :
             {
-                const double production_rate = std::abs(getProductionRate(well_rates, prod_mode));
                 const double production_target = std::abs(getTarget(prod_mode));
 
                 // 0.01 is a hard-coded relative tolerance
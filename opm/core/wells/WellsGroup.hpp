@@ -295,6 +295,9 @@ namespace Opm
 
         void addChild(std::shared_ptr<WellsGroupInterface> child);
 
+        /// The children of the group, in the order they were added.
+        const std::vector<std::shared_ptr<WellsGroupInterface> >& children() const;
+
         virtual bool conditionsMet(const std::vector<double>& well_bhp,
                                    const std::vector<double>& well_reservoirrates_phase,
                                    const std::vector<double>& well_surfacerates_phase,
@@ -387,6 +390,15 @@ namespace Opm
 
         virtual bool groupProdTargetConverged(const std::vector<double>& well_rates) const;
 
+        /// Whether the production target of this group is met, given the production
+        /// rate of the group in its control mode, without checking the children.
+        /// The rate is only used for the rate control modes, see usesProductionRate().
+        bool ownProdTargetConverged(const double production_rate) const;
+
+        /// Whether the production control mode of this group is a rate of a phase
+        /// or the liquid rate, i.e. ownProdTargetConverged() needs the rate.
+        bool usesProductionRate() const;
+
     private:
         std::vector<std::shared_ptr<WellsGroupInterface> > children_;
     };
@@ -3,10 +3,6 @@
 
 #include <opm/common/ErrorMacros.hpp>
 #include <opm/common/OpmLog/OpmLog.hpp>
-#include <opm/grid/utility/compressedToCartesian.hpp>
-#include <opm/core/props/rock/RockFromDeck.hpp>
-#include <opm/parser/eclipse/EclipseState/Grid/EclipseGrid.hpp>
-#include <opm/parser/eclipse/EclipseState/Schedule/WellConnections.hpp>
 #include <opm/parser/eclipse/EclipseState/Schedule/Schedule.hpp>
 
 #include <algorithm>
@@ -101,168 +97,6 @@ getCubeDim(const C2F& c2f,
 
 namespace Opm
 {
-template<class C2F, class FC, class NTG>
-void WellsManager::createWellsFromSpecs(std::vector<const Well*>& wells, size_t timeStep,
-                                        const C2F& c2f,
-                                        const int* cart_dims,
-                                        FC begin_face_centroids,
-                                        int dimensions,
-                                        std::vector<double>& dz,
-                                        std::vector<std::string>& well_names,
-                                        std::vector<WellData>& well_data,
-                                        std::map<std::string, int>& well_names_to_index,
-                                        const PhaseUsage& phaseUsage,
-                                        const std::map<int,int>& cartesian_to_compressed,
-                                        const double* permeability,
-                                        const NTG& ntg,
-                                        std::vector<int>& wells_on_proc,
-                                        const std::unordered_set<std::string>& ignored_wells)
-{
-    if (dimensions != 3) {
-        OPM_THROW(std::domain_error,
-                  "WellsManager::createWellsFromSpecs() only "
-                  "supported in three space dimensions");
-    }
-
-    std::vector<std::vector<PerfData> > wellperf_data;
-    wellperf_data.resize(wells.size());
-    wells_on_proc.resize(wells.size(), 1);
-
-    // The well index on the current process.
-    // Note that some wells are deactivated as they live on the interior
-    // domain of another proccess. Therefore this might different from
-    // the index of the well according to the eclipse state
-    int active_well_index = 0;
-    for (auto wellIter= wells.begin(); wellIter != wells.end(); ++wellIter) {
-        const auto* well = (*wellIter);
-
-        if (well->getStatus(timeStep) == WellCommon::SHUT) {
-            continue;
-        }
-
-        if ( ignored_wells.find(well->name()) != ignored_wells.end() ) {
-            wells_on_proc[ wellIter - wells.begin() ] = 0;
-            continue;
-        }
-
-        {   // COMPDAT handling
-            // shut completions and open ones stored in this process will have 1 others 0.
-
-            for(const auto& completion : well->getConnections(timeStep)) {
-                if (completion.state() == WellCompletion::OPEN) {
-                    const int i = completion.getI();
-                    const int j = completion.getJ();
-                    const int k = completion.getK();
-
-                    const int* cpgdim = cart_dims;
-                    const int cart_grid_indx = i + cpgdim[0]*(j + cpgdim[1]*k);
-                    const std::map<int, int>::const_iterator cgit = cartesian_to_compressed.find(cart_grid_indx);
-                    if (cgit == cartesian_to_compressed.end()) {
-                        const std::string msg = ("Cell with i,j,k indices " + std::to_string(i) + " " + std::to_string(j)
-                                    + " " + std::to_string(k)  +  " not found in grid (well = " +  well->name() + ").");
-                        OPM_THROW(std::runtime_error, msg);
-                    }
-                    else
-                    {
-                        PerfData pd;
-                        pd.cell = cgit->second;
-                        pd.well_index = completion.CF() * completion.wellPi();
-                        pd.satnumid = completion.satTableId();
-
-                        wellperf_data[active_well_index].push_back(pd);
-                    }
-                } else {
-                    if (completion.state() != WellCompletion::SHUT) {
-                        OPM_THROW(std::runtime_error, "Completion state: " << WellCompletion::StateEnum2String( completion.state() ) << " not handled");
-                    }
-                }
-            }
-        }
-
-        if (wellperf_data[active_well_index].empty()) {
-            const std::string msg = " there is no perforations associated with the well "
-                                  + well->name() + ", the well is ignored for the report step "
-                                  + std::to_string(timeStep);
-            OpmLog::warning(msg);
-            wells_on_proc[wellIter - wells.begin()] = 0;
-            continue;
-        }
-        {   // WELSPECS handling
-            well_names_to_index[well->name()] = active_well_index;
-            well_names.push_back(well->name());
-            {
-                WellData wd;
-                wd.reference_bhp_depth = well->getRefDepth( timeStep );
-                wd.welspecsline = -1;
-                if (well->isInjector( timeStep ))
-                    wd.type = INJECTOR;
-                else
-                    wd.type = PRODUCER;
-
-                wd.allowCrossFlow = well->getAllowCrossFlow();
-                well_data.push_back(wd);
-            }
-        }
-
-        active_well_index++;
-    }
-    // Set up reference depths that were defaulted. Count perfs.
-
-    const int num_wells = well_data.size();
-
-    int num_perfs = 0;
-    assert (dimensions == 3);
-    for (int w = 0; w < num_wells; ++w) {
-        num_perfs += wellperf_data[w].size();
-    }
-    // Create the well data structures.
-    struct Wells* w = create_wells(phaseUsage.num_phases, num_wells, num_perfs);
-
-    if (!w) {
-        OPM_THROW(std::runtime_error, "Failed creating Wells struct.");
-    }
-
-    std::swap( w, w_ );
-    destroy_wells( w );
-
-    // Add wells.
-    for (int w = 0; w < num_wells; ++w) {
-        const int           w_num_perf = wellperf_data[w].size();
-        std::vector<int>    perf_cells  (w_num_perf);
-        std::vector<double> perf_prodind(w_num_perf);
-        std::vector<int> perf_satnumid(w_num_perf);
-
-        for (int perf = 0; perf < w_num_perf; ++perf) {
-            perf_cells  [perf] = wellperf_data[w][perf].cell;
-            perf_prodind[perf] = wellperf_data[w][perf].well_index;
-            perf_satnumid[perf] = wellperf_data[w][perf].satnumid;
-        }
-
-        const double* comp_frac = NULL;
-
-        // We initialize all wells with a null component fraction,
-        // and must (for injection wells) overwrite it later.
-        const int ok =
-            add_well(well_data[w].type,
-                     well_data[w].reference_bhp_depth,
-                     w_num_perf,
-                     comp_frac,
-                     perf_cells.data(),
-                     perf_prodind.data(),
-                     perf_satnumid.data(),
-                     well_names[w].c_str(),
-                     well_data[w].allowCrossFlow,
-                     w_);
-
-        if (!ok) {
-            OPM_THROW(std::runtime_error,
-                      "Failed adding well "
-                      << well_names[w]
-                      << " to Wells data structure.");
-        }
-    }
-}
-
 template <class C2F, class FC>
 WellsManager::
 WellsManager(const Opm::EclipseState& eclipseState,
@@ -293,8 +127,8 @@ WellsManager::init(const Opm::EclipseState& eclipseState,
                    const int*                      global_cell,
                    const int*                      cart_dims,
                    int                             dimensions,
-                   const C2F&                      cell_to_faces,
-                   FC                              begin_face_centroids,
+                   const C2F&                      /* cell_to_faces */,
+                   FC                              /* begin_face_centroids */,
                    const std::unordered_set<std::string>&    deactivated_wells)
 {
     if (dimensions != 3) {
@@ -309,10 +143,6 @@ WellsManager::init(const Opm::EclipseState& eclipseState,
         return;
     }
 
-    std::map<int,int> cartesian_to_compressed;
-    setupCompressedToCartesian(global_cell, number_of_cells,
-                               cartesian_to_compressed);
-
     // Obtain phase usage data.
     PhaseUsage pu = phaseUsageFromDeck(eclipseState);
 
@@ -331,40 +161,17 @@ WellsManager::init(const Opm::EclipseState& eclipseState,
     well_names.reserve(wells.size());
     well_data.reserve(wells.size());
 
-    typedef GridPropertyAccess::ArrayPolicy::ExtractFromDeck<double> DoubleArray;
-    typedef GridPropertyAccess::Compressed<DoubleArray, GridPropertyAccess::Tag::NTG> NTGArray;
-
-    DoubleArray ntg_glob(eclipseState, "NTG", 1.0);
-    NTGArray    ntg(ntg_glob, global_cell);
-
-    const auto& eclGrid = eclipseState.getInputGrid();
-
-    // use cell thickness (dz) from eclGrid
-    // dz overwrites values calculated by WellDetails::getCubeDim
-    std::vector<double> dz(number_of_cells);
-    {
-        std::vector<int> gc = compressedToCartesian(number_of_cells, global_cell);
-        for (int cell = 0; cell < number_of_cells; ++cell) {
-            dz[cell] = eclGrid.getCellThicknes(gc[cell]);
-        }
-    }
-
-
-    std::vector<double> interleavedPerm;
-    RockFromDeck::extractInterleavedPermeability(eclipseState,
-                                                 number_of_cells,
-                                                 global_cell,
-                                                 cart_dims,
-                                                 0.0,
-                                                 interleavedPerm);
+    // The connection factors are taken from the schedule, hence only the
+    // compressed indices of the connected cells are needed.
+    std::map<int,int> cartesian_to_compressed;
+    setupCompressedToCartesian(wells, timeStep, cart_dims, global_cell, number_of_cells,
+                               cartesian_to_compressed);
 
-    createWellsFromSpecs(wells, timeStep, cell_to_faces,
+    createWellsFromSpecs(wells, timeStep,
                          cart_dims,
-                         begin_face_centroids,
                          dimensions,
-                         dz,
                          well_names, well_data, well_names_to_index,
-                         pu, cartesian_to_compressed, interleavedPerm.data(), ntg,
+                         pu, cartesian_to_compressed,
                          wells_on_proc, deactivated_wells);
 
     setupWellControls(wells, timeStep, well_names, pu, wells_on_proc);
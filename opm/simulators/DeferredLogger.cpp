@@ -25,67 +25,87 @@ namespace Opm
 
     void DeferredLogger::info(const std::string& tag, const std::string& message)
     {
-        messages_.push_back({Log::MessageType::Info, tag, message});
+        push(Log::MessageType::Info, tag, message);
     }
     void DeferredLogger::warning(const std::string& tag, const std::string& message)
     {
-        messages_.push_back({Log::MessageType::Warning, tag, message});
+        push(Log::MessageType::Warning, tag, message);
     }
     void DeferredLogger::error(const std::string& tag, const std::string& message)
     {
-        messages_.push_back({Log::MessageType::Error, tag, message});
+        push(Log::MessageType::Error, tag, message);
     }
     void DeferredLogger::problem(const std::string& tag, const std::string& message)
     {
-        messages_.push_back({Log::MessageType::Problem, tag, message});
+        push(Log::MessageType::Problem, tag, message);
     }
     void DeferredLogger::bug(const std::string& tag, const std::string& message)
     {
-        messages_.push_back({Log::MessageType::Bug, tag, message});
+        push(Log::MessageType::Bug, tag, message);
     }
     void DeferredLogger::debug(const std::string& tag, const std::string& message)
     {
-        messages_.push_back({Log::MessageType::Debug, tag, message});
+        push(Log::MessageType::Debug, tag, message);
     }
     void DeferredLogger::note(const std::string& tag, const std::string& message)
     {
-        messages_.push_back({Log::MessageType::Note, tag, message});
+        push(Log::MessageType::Note, tag, message);
     }
 
     void DeferredLogger::info(const std::string& message)
     {
-        messages_.push_back({Log::MessageType::Info, "", message});
+        push(Log::MessageType::Info, std::string(), message);
     }
     void DeferredLogger::warning(const std::string& message)
     {
-        messages_.push_back({Log::MessageType::Warning, "", message});
+        push(Log::MessageType::Warning, std::string(), message);
     }
     void DeferredLogger::error(const std::string& message)
     {
-        messages_.push_back({Log::MessageType::Error, "", message});
+        push(Log::MessageType::Error, std::string(), message);
     }
     void DeferredLogger::problem(const std::string& message)
     {
-        messages_.push_back({Log::MessageType::Problem, "", message});
+        push(Log::MessageType::Problem, std::string(), message);
     }
     void DeferredLogger::bug(const std::string& message)
     {
-        messages_.push_back({Log::MessageType::Bug, "", message});
+        push(Log::MessageType::Bug, std::string(), message);
     }
     void DeferredLogger::debug(const std::string& message)
     {
-        messages_.push_back({Log::MessageType::Debug, "", message});
+        push(Log::MessageType::Debug, std::string(), message);
     }
     void DeferredLogger::note(const std::string& message)
     {
-        messages_.push_back({Log::MessageType::Note, "", message});
+        push(Log::MessageType::Note, std::string(), message);
     }
 
     void DeferredLogger::logMessages()
     {
-        for (const auto& m : messages_) {
+        for (std::size_t i = 0; i < size_; ++i) {
+            const auto& m = messages_[i];
             OpmLog::addTaggedMessage(m.flag, m.tag, m.text);
         }
     }
 
+    void DeferredLogger::clearMessages()
+    {
+        size_ = 0;
+    }
+
+    void DeferredLogger::push(const int64_t flag, const std::string& tag, const std::string& text)
+    {
+        if (size_ == messages_.size()) {
+            messages_.push_back({flag, tag, text});
+        } else {
+            // assigning reuses the storage of the strings of a cleared message
+            auto& m = messages_[size_];
+            m.flag = flag;
+            m.tag = tag;
+            m.text = text;
+        }
+        ++size_;
+    }
+
 } // namespace Opm
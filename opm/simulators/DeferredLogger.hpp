@@ -23,6 +23,8 @@
 
 #include <opm/common/OpmLog/OpmLog.hpp>
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -31,6 +33,8 @@ namespace Opm
     /** This class implements a deferred logger:
      * 1) messages can be pushed back to a vector
      * 2) a call to logMessages adds the messages to OpmLog backends
+     * 3) a call to clearMessages forgets them, while their storage is
+     *    kept for the next messages
      * */
 
     class DeferredLogger
@@ -54,6 +58,9 @@ namespace Opm
 
         void logMessages();
 
+        /// Forget all messages, e.g. after they were logged.
+        void clearMessages();
+
     private:
         struct Message
         {
@@ -61,7 +68,11 @@ namespace Opm
             std::string tag;
             std::string text;
         };
+        void push(const int64_t flag, const std::string& tag, const std::string& text);
+
+        // the first size_ entries are the messages, the others are cleared messages
         std::vector<Message> messages_;
+        std::size_t size_ = 0;
     };
 
 } // namespace Opm
@@ -0,0 +1,130 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "config.h"
+
+#include <opm/simulators/GatheringLog.hpp>
+#include <opm/common/OpmLog/OpmLog.hpp>
+
+#include <algorithm>
+#include <fstream>
+
+#if HAVE_MPI
+#include <mpi.h>
+#endif
+
+namespace Opm
+{
+
+    const char* const GatheringLog::backendName = "GATHERINGLOG";
+
+    GatheringLog::GatheringLog(const int64_t mask, const std::string& fallbackFile)
+        : LogBackend(mask)
+        , fallbackFile_(fallbackFile)
+    {
+    }
+
+    GatheringLog::~GatheringLog()
+    {
+        if (buffer_.empty()) {
+            return;
+        }
+        std::ofstream out(fallbackFile_, std::ofstream::app);
+        forEachMessage(buffer_.data(), buffer_.data() + buffer_.size(),
+                       [&out](int64_t, const std::string& text) { out << text << '\n'; });
+    }
+
+    std::vector<char> GatheringLog::takeMessages()
+    {
+        std::vector<char> messages;
+        messages.swap(buffer_);
+        return messages;
+    }
+
+    void GatheringLog::addMessageUnconditionally(int64_t messageType, const std::string& message)
+    {
+        const std::string text = formatMessage(messageType, message);
+        const std::uint32_t length = text.size();
+        const char* flag = reinterpret_cast<const char*>(&messageType);
+        buffer_.insert(buffer_.end(), flag, flag + sizeof(messageType));
+        const char* len = reinterpret_cast<const char*>(&length);
+        buffer_.insert(buffer_.end(), len, len + sizeof(length));
+        buffer_.insert(buffer_.end(), text.begin(), text.end());
+    }
+
+#if HAVE_MPI
+
+    void gatherLogMessages()
+    {
+        int rank = 0;
+        int size = 1;
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+        MPI_Comm_size(MPI_COMM_WORLD, &size);
+        if (size < 2) {
+            return;
+        }
+
+        std::vector<char> local;
+        if (rank != 0 && OpmLog::hasBackend(GatheringLog::backendName)) {
+            local = OpmLog::getBackend<GatheringLog>(GatheringLog::backendName)->takeMessages();
+        }
+
+        int localSize = local.size();
+        std::vector<int> sizes(rank == 0 ? size : 0);
+        MPI_Gather(&localSize, 1, MPI_INT, sizes.data(), 1, MPI_INT, 0, MPI_COMM_WORLD);
+
+        std::vector<int> displ(sizes.size() + 1, 0);
+        for (std::size_t r = 0; r < sizes.size(); ++r) {
+            displ[r + 1] = displ[r] + sizes[r];
+        }
+        std::vector<char> all(rank == 0 ? std::max(displ.back(), 1) : 0);
+        MPI_Gatherv(local.data(), localSize, MPI_CHAR,
+                    all.data(), sizes.data(), displ.data(), MPI_CHAR, 0, MPI_COMM_WORLD);
+
+        if (rank != 0 || displ.back() == 0) {
+            return;
+        }
+
+        // add the messages to the PRT and debug logs only, not to the terminal
+        std::vector<std::shared_ptr<LogBackend>> logs;
+        for (const char* name : { "ECLIPSEPRTLOG", "DEBUGLOG" }) {
+            if (OpmLog::hasBackend(name)) {
+                logs.push_back(OpmLog::getBackend<LogBackend>(name));
+            }
+        }
+        for (int r = 1; r < size; ++r) {
+            const std::string prefix = "Rank " + std::to_string(r) + ": ";
+            GatheringLog::forEachMessage(all.data() + displ[r], all.data() + displ[r + 1],
+                                         [&logs, &prefix](int64_t flag, const std::string& text) {
+                                             for (auto& log : logs) {
+                                                 log->addMessage(flag, prefix + text);
+                                             }
+                                         });
+        }
+    }
+
+#else // HAVE_MPI
+
+    void gatherLogMessages()
+    {
+    }
+
+#endif // HAVE_MPI
+
+} // namespace Opm
@@ -0,0 +1,88 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef OPM_GATHERINGLOG_HEADER_INCLUDED
+#define OPM_GATHERINGLOG_HEADER_INCLUDED
+
+#include <opm/common/OpmLog/LogBackend.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Opm
+{
+    /** A log backend of the processes other than the first one of a parallel
+     * run. It keeps the messages until gatherLogMessages() sends them to the
+     * first process, which adds them to its PRT and debug logs, such that no
+     * log files per process need to be merged after the run. The messages
+     * which have not been gathered, e.g. if the run was aborted, are written
+     * to a file by the destructor.
+     * */
+
+    class GatheringLog : public LogBackend
+    {
+    public:
+        /// The name of the backend in OpmLog.
+        static const char* const backendName;
+
+        GatheringLog(const int64_t mask, const std::string& fallbackFile);
+        ~GatheringLog();
+
+        /// The messages since the last call, serialized as the flag, the
+        /// length and the characters of each message.
+        std::vector<char> takeMessages();
+
+        /// Call function(flag, text) for each message of a serialized buffer.
+        template <class Function>
+        static void forEachMessage(const char* begin, const char* end, const Function& function);
+
+    protected:
+        void addMessageUnconditionally(int64_t messageType, const std::string& message) override;
+
+    private:
+        std::vector<char> buffer_;
+        std::string fallbackFile_;
+    };
+
+    /// Send the messages of the GatheringLog backends of all processes to the
+    /// PRT and debug logs of the first process, prefixed by the rank that
+    /// logged them. Collective on MPI_COMM_WORLD, a no-op without MPI.
+    void gatherLogMessages();
+
+
+    template <class Function>
+    void GatheringLog::forEachMessage(const char* begin, const char* end, const Function& function)
+    {
+        while (begin < end) {
+            int64_t flag;
+            std::uint32_t length;
+            std::copy(begin, begin + sizeof(flag), reinterpret_cast<char*>(&flag));
+            begin += sizeof(flag);
+            std::copy(begin, begin + sizeof(length), reinterpret_cast<char*>(&length));
+            begin += sizeof(length);
+            function(flag, std::string(begin, begin + length));
+            begin += length;
+        }
+    }
+
+} // namespace Opm
+
+#endif // OPM_GATHERINGLOG_HEADER_INCLUDED
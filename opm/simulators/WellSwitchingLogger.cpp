@@ -154,6 +154,14 @@ void WellSwitchingLogger::gatherDataAndLog()
         return;
     }
 
+    // Usually no well switched, then a single integer tells all the
+    // processes to skip the gathering of the messages.
+    const int any_switches = cc_.max(static_cast<int>(!switchMap_.empty()));
+    if ( !any_switches )
+    {
+        return;
+    }
+
     std::vector<int> message_sizes;
     std::vector<int> well_name_lengths;
     int message_size = calculateMessageSize(well_name_lengths);
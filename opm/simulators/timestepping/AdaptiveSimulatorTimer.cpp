@@ -29,10 +29,19 @@
 
 namespace Opm
 {
+    namespace
+    {
+        // a last substep shorter than this fraction of its estimate is a tail step
+        const double tailFraction = 0.25;
+        // the substeps are only planned this many steps before the end
+        const int maxPlannedSteps = 100;
+    }
+
     AdaptiveSimulatorTimer::
     AdaptiveSimulatorTimer( const SimulatorTimerInterface& timer,
                             const double lastStepTaken,
-                            const double maxTimeStep )
+                            const double maxTimeStep,
+                            const bool planSubsteps )
         : start_date_time_( timer.startDateTime() )
         , start_time_( timer.simulationTimeElapsed() )
         , total_time_( start_time_ + timer.currentStepLength() )
@@ -43,6 +52,9 @@ namespace Opm
         , current_step_( 0 )
         , steps_()
         , lastStepFailed_( false )
+        , planSubsteps_( planSubsteps )
+        , planningGrowth_( 1.0 )
+        , tailStepAvoided_( false )
     {
         // reserve memory for sub steps
         steps_.reserve( 10 );
@@ -73,25 +85,68 @@ AdaptiveSimulatorTimer& AdaptiveSimulatorTimer::operator++ ()
         dt_ = std::min( dt_estimate, max_time_step_ );
 
         if( remaining > 0 ) {
-
-            // set new time step (depending on remaining time)
-            if( 1.05 * dt_ > remaining ) {
-                dt_ = remaining;
-                // check max time step again and use half remaining if too large
-                if( dt_ > max_time_step_ ) {
-                    dt_ = 0.5 * remaining;
+            if( planSubsteps_ ) {
+                if( ! tailStepAvoided_ && endsWithTailStep_( remaining, dt_ ) ) {
+                    tailStepAvoided_ = true;
                 }
-                return;
+                dt_ = plannedStep_( remaining, dt_ );
+            }
+            else {
+                dt_ = unplannedStep_( remaining, dt_, max_time_step_ );
             }
+        }
+    }
+
+    double AdaptiveSimulatorTimer::
+    unplannedStep_( const double remaining, const double dt, const double maxTimeStep )
+    {
+        // set new time step (depending on remaining time)
+        if( 1.05 * dt > remaining ) {
+            // check max time step again and use half remaining if too large
+            return ( remaining > maxTimeStep ) ? 0.5 * remaining : remaining;
+        }
 
-            // check for half interval step to avoid very small step at the end
-            // remaining *= 0.5;
+        // check for half interval step to avoid very small step at the end
+        if( 1.5 * dt > remaining ) {
+            return 0.5 * remaining;
+        }
+        return dt;
+    }
+
+    double AdaptiveSimulatorTimer::
+    plannedStep_( const double remaining, const double dt ) const
+    {
+        if( remaining > maxPlannedSteps * dt ) {
+            return dt;
+        }
 
-            if( 1.5 * dt_ > remaining ) {
-                dt_ = 0.5 * remaining;
-                return;
+        // the number of substeps if the following estimates grow as expected,
+        // where a substep may be stretched by 5% to finish the remaining time
+        double covered = 0.0;
+        double step = dt;
+        int substeps = 1;
+        while( 1.05 * ( covered + step ) < remaining ) {
+            covered += step;
+            step = std::min( step * planningGrowth_, max_time_step_ );
+            ++substeps;
+        }
+
+        // equal substeps do not need any growth, hence they respect all growth limits
+        return std::min( { remaining / substeps, 1.05 * dt, max_time_step_ } );
+    }
+
+    bool AdaptiveSimulatorTimer::
+    endsWithTailStep_( double remaining, double dt ) const
+    {
+        for( int step = 0; step < maxPlannedSteps; ++step ) {
+            const double taken = unplannedStep_( remaining, dt, max_time_step_ );
+            remaining -= taken;
+            if( remaining <= 0.0 ) {
+                return taken < tailFraction * dt;
             }
+            dt = std::min( dt * planningGrowth_, max_time_step_ );
         }
+        return false;
     }
 
     int AdaptiveSimulatorTimer::
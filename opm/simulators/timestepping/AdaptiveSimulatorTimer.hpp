@@ -43,9 +43,12 @@ namespace Opm
         ///  \param timer          in case of sub stepping this is the outer timer
         ///  \param lastStepTaken  last suggested time step
         ///  \param maxTimeStep    maximum time step allowed
+        ///  \param planSubsteps   if true spread the remaining time evenly over the predicted
+        ///                        number of substeps instead of leaving a short last substep
         AdaptiveSimulatorTimer( const SimulatorTimerInterface& timer,
                                 const double lastStepTaken,
-                                const double maxTimeStep = std::numeric_limits<double>::max() );
+                                const double maxTimeStep = std::numeric_limits<double>::max(),
+                                const bool planSubsteps = false );
 
         /// \brief advance time by currentStepLength
         AdaptiveSimulatorTimer& operator++ ();
@@ -56,6 +59,14 @@ namespace Opm
         /// \brief provide and estimate for new time step size
         void provideTimeStepEstimate( const double dt_estimate );
 
+        /// \brief set the factor the estimates of the following substeps are expected to
+        ///        grow by, which the planning of the substeps uses (default 1)
+        void setPlanningGrowth( const double growth ) { planningGrowth_ = std::max( growth, 1.0 ); }
+
+        /// \brief Whether the planning of the substeps avoided a short last substep,
+        ///        which the estimates of the step sizes alone would have led to
+        bool tailStepAvoided() const { return tailStepAvoided_; }
+
         /// \brief Whether this is the first step
         bool initialStep () const;
 
@@ -119,6 +130,17 @@ namespace Opm
         std::vector< double > steps_;
         bool lastStepFailed_;
 
+        const bool planSubsteps_;
+        double planningGrowth_;
+        bool tailStepAvoided_;
+
+        // the step size the estimate leads to without planning
+        static double unplannedStep_( const double remaining, const double dt, const double maxTimeStep );
+        // the step size spreading the remaining time over the predicted substeps
+        double plannedStep_( const double remaining, const double dt ) const;
+        // whether the substeps without planning end with a short one
+        bool endsWithTailStep_( double remaining, double dt ) const;
+
     };
 
 } // namespace Opm
@@ -3,9 +3,13 @@
 #ifndef OPM_ADAPTIVE_TIME_STEPPING_EBOS_HPP
 #define OPM_ADAPTIVE_TIME_STEPPING_EBOS_HPP
 
+#include <algorithm>
 #include <iostream>
+#include <istream>
+#include <ostream>
 #include <utility>
 
+#include <opm/core/simulator/BinarySerialization.hpp>
 #include <opm/core/simulator/SimulatorReport.hpp>
 #include <opm/grid/utility/StopWatch.hpp>
 #include <opm/common/OpmLog/OpmLog.hpp>
@@ -15,6 +19,8 @@
 #include <opm/simulators/timestepping/AdaptiveSimulatorTimer.hpp>
 #include <opm/simulators/timestepping/TimeStepControlInterface.hpp>
 #include <opm/simulators/timestepping/TimeStepControl.hpp>
+#include <opm/simulators/timestepping/ConvergenceReport.hpp>
+#include <opm/simulators/timestepping/ConvergenceRiskPredictor.hpp>
 #include <opm/core/props/phaseUsageFromDeck.hpp>
 
 BEGIN_PROPERTIES
@@ -40,6 +46,8 @@ NEW_PROP_TAG(TimeStepControlTargetNewtonIterations);
 NEW_PROP_TAG(TimeStepControlDecayRate);
 NEW_PROP_TAG(TimeStepControlGrowthRate);
 NEW_PROP_TAG(TimeStepControlFileName);
+NEW_PROP_TAG(TimeStepMaxFailureRisk);
+NEW_PROP_TAG(TimeStepPlanSubsteps);
 
 SET_SCALAR_PROP(FlowTimeSteppingParameters, SolverRestartFactor, 0.33);
 SET_SCALAR_PROP(FlowTimeSteppingParameters, SolverGrowthFactor, 2.0);
@@ -58,6 +66,8 @@ SET_INT_PROP(FlowTimeSteppingParameters, TimeStepControlTargetNewtonIterations,
 SET_SCALAR_PROP(FlowTimeSteppingParameters, TimeStepControlDecayRate, 0.75);
 SET_SCALAR_PROP(FlowTimeSteppingParameters, TimeStepControlGrowthRate, 1.25);
 SET_STRING_PROP(FlowTimeSteppingParameters, TimeStepControlFileName, "timesteps");
+SET_SCALAR_PROP(FlowTimeSteppingParameters, TimeStepMaxFailureRisk, 1.0);
+SET_BOOL_PROP(FlowTimeSteppingParameters, TimeStepPlanSubsteps, false);
 
 END_PROPERTIES
 
@@ -108,6 +118,8 @@ namespace Opm {
             , fullTimestepInitially_(EWOMS_GET_PARAM(TypeTag, bool, FullTimeStepInitially)) // false
             , timestepAfterEvent_(EWOMS_GET_PARAM(TypeTag, double, TimeStepAfterEventInDays)*24*60*60) // 1e30
             , useNewtonIteration_(false)
+            , maxFailureRisk_(EWOMS_GET_PARAM(TypeTag, double, TimeStepMaxFailureRisk)) // 1.0
+            , planSubsteps_(EWOMS_GET_PARAM(TypeTag, bool, TimeStepPlanSubsteps)) // false
         {
             init_();
         }
@@ -132,6 +144,8 @@ namespace Opm {
             , fullTimestepInitially_(EWOMS_GET_PARAM(TypeTag, bool, FullTimeStepInitially)) // false
             , timestepAfterEvent_(EWOMS_GET_PARAM(TypeTag, double, TimeStepAfterEventInDays)*24*60*60) // 1e30
             , useNewtonIteration_(false)
+            , maxFailureRisk_(EWOMS_GET_PARAM(TypeTag, double, TimeStepMaxFailureRisk)) // 1.0
+            , planSubsteps_(EWOMS_GET_PARAM(TypeTag, bool, TimeStepPlanSubsteps)) // false
         {
             init_();
         }
@@ -160,7 +174,7 @@ namespace Opm {
             EWOMS_REGISTER_PARAM(TypeTag, double, TimeStepAfterEventInDays,
                                  "Time step size of the first time step after an event occurs during the simulation in days");
             EWOMS_REGISTER_PARAM(TypeTag, std::string, TimeStepControl,
-                                 "The algorithm used to determine time-step sizes. valid options are: 'pid' (default), 'pid+iteration', 'pid+newtoniteration', 'iterationcount' and 'hardcoded'");
+                                 "The algorithm used to determine time-step sizes. valid options are: 'pid' (default), 'pid+iteration', 'pid+newtoniteration', 'iterationcount', 'throughput' and 'hardcoded'");
             EWOMS_REGISTER_PARAM(TypeTag, double, TimeStepControlTolerance,
                                  "The tolerance used by the time step size control algorithm");
             EWOMS_REGISTER_PARAM(TypeTag, int, TimeStepControlTargetIterations,
@@ -173,6 +187,10 @@ namespace Opm {
                                  "The growth rate of the time step size of the number of target iterations is undercut");
             EWOMS_REGISTER_PARAM(TypeTag, std::string, TimeStepControlFileName,
                                  "The name of the file which contains the hardcoded time steps sizes");
+            EWOMS_REGISTER_PARAM(TypeTag, double, TimeStepMaxFailureRisk,
+                                 "The largest predicted probability of a convergence failure a substep is tried with, larger risks shorten the substep beforehand. 1 disables the prediction");
+            EWOMS_REGISTER_PARAM(TypeTag, bool, TimeStepPlanSubsteps,
+                                 "Spread the rest of a report step evenly over the substeps predicted from the growth of the step size, instead of ending it with a short substep");
         }
 
         /** \brief  step method that acts like the solver::step method
@@ -205,7 +223,7 @@ namespace Opm {
             auto& ebosProblem = ebosSimulator.problem();
 
             // create adaptive step timer with previously used sub step size
-            AdaptiveSimulatorTimer substepTimer(simulatorTimer, suggestedNextTimestep_, maxTimeStep_);
+            AdaptiveSimulatorTimer substepTimer(simulatorTimer, suggestedNextTimestep_, maxTimeStep_, planSubsteps_);
 
             // reset the statistics for the failed substeps
             failureReport_ = SimulatorReport();
@@ -213,8 +231,20 @@ namespace Opm {
             // counter for solver restarts
             int restarts = 0;
 
+            // the first substep after an event is riskier
+            bool afterEvent = isEvent;
+
             // sub step time loop
             while (!substepTimer.done()) {
+                // shorten the substep if it is likely to fail
+                ConvergenceRiskPredictor::Features riskFeatures;
+                if (maxFailureRisk_ < 1.0) {
+                    riskFeatures = riskFeatures_;
+                    riskFeatures.restarted = restarts > 0;
+                    riskFeatures.event = afterEvent;
+                    limitFailureRisk_(substepTimer, riskFeatures);
+                }
+
                 // get current delta t
                 const double dt = substepTimer.currentStepLength() ;
                 if (timestepVerbose_) {
@@ -226,6 +256,8 @@ namespace Opm {
 
                 SimulatorReport substepReport;
                 std::string causeOfFailure = "";
+                Opm::time::StopWatch substepWatch;
+                substepWatch.start();
                 try {
                     substepReport = solver.step(substepTimer);
                     report += substepReport;
@@ -275,6 +307,16 @@ namespace Opm {
                     // this can be thrown by ISTL's ILU0 in block mode, yet is not an ISTLError
                 }
 
+                timeStepControl_->recordStepCost(dt, substepReport.converged,
+                                                 substepReport.total_newton_iterations,
+                                                 substepReport.total_linear_iterations,
+                                                 substepWatch.secsSinceStart());
+
+                if (maxFailureRisk_ < 1.0) {
+                    riskPredictor_.update(riskFeatures, substepReport.converged);
+                    riskFeatures_.lastWellFailureFraction = wellFailureFraction_(solver.model().stepReports());
+                }
+
                 if (substepReport.converged) {
                     // advance by current dt
                     ++substepTimer;
@@ -282,6 +324,13 @@ namespace Opm {
                     // create object to compute the time error, simply forwards the call to the model
                     SolutionTimeErrorSolverWrapperEbos<Solver> relativeChange(solver);
 
+                    if (maxFailureRisk_ < 1.0) {
+                        lastConvergedStep_ = dt;
+                        riskFeatures_.lastNewtonIterations = substepReport.total_newton_iterations;
+                        riskFeatures_.lastRelativeChange = relativeChange.relativeChange();
+                        afterEvent = false;
+                    }
+
                     // compute new time step estimate
                     const int iterations = useNewtonIteration_ ? substepReport.total_newton_iterations
                         : substepReport.total_linear_iterations;
@@ -327,7 +376,8 @@ namespace Opm {
                         report.output_write_time += perfTimer.secsSinceStart();
                     }
 
-                    // set new time step length
+                    // set new time step length, the following ones are expected to grow alike
+                    substepTimer.setPlanningGrowth(std::min(dtEstimate / dt, double(maxGrowth_)));
                     substepTimer.provideTimeStepEstimate(dtEstimate);
 
                     report.converged = substepTimer.done();
@@ -338,6 +388,7 @@ namespace Opm {
                     substepTimer.setLastStepFailed(true);
 
                     failureReport_ += substepReport;
+                    ++failureReport_.total_failed_steps;
 
                     // If we have restarted (i.e. cut the timestep) too
                     // many times, we have failed and throw an exception.
@@ -407,6 +458,10 @@ namespace Opm {
                 ebosProblem.setNextTimeStepSize(substepTimer.currentStepLength());
             }
 
+            if (substepTimer.tailStepAvoided()) {
+                ++report.total_tail_steps_avoided;
+            }
+
             // store estimated time step for next reportStep
             suggestedNextTimestep_ = substepTimer.currentStepLength();
             if (timestepVerbose_) {
@@ -434,6 +489,31 @@ namespace Opm {
         void setSuggestedNextStep(const double x)
         { suggestedNextTimestep_ = x; }
 
+        /** \brief Write the state of the time stepping, i.e. the suggested size of the
+         *         next step and the history of the controllers, in binary for a
+         *         checkpoint.
+         */
+        void serialize(std::ostream& os) const
+        {
+            BinarySerialization::write(os, suggestedNextTimestep_);
+            BinarySerialization::write(os, lastConvergedStep_);
+            BinarySerialization::write(os, riskFeatures_);
+            riskPredictor_.serialize(os);
+            timeStepControl_->serialize(os);
+        }
+
+        /** \brief Read the state written by serialize() into a time stepping of the
+         *         same parameters.
+         */
+        void deserialize(std::istream& is)
+        {
+            BinarySerialization::read(is, suggestedNextTimestep_);
+            BinarySerialization::read(is, lastConvergedStep_);
+            BinarySerialization::read(is, riskFeatures_);
+            riskPredictor_.deserialize(is);
+            timeStepControl_->deserialize(is);
+        }
+
         void updateTUNING(const Tuning& tuning, size_t timeStep)
         {
             restartFactor_ = tuning.getTSFCNV(timeStep);
@@ -446,6 +526,46 @@ namespace Opm {
 
 
     protected:
+        // shorten the current substep to the largest one below the largest failure risk,
+        // which is at most cut by the restart factor
+        void limitFailureRisk_(AdaptiveSimulatorTimer& substepTimer,
+                               ConvergenceRiskPredictor::Features& features)
+        {
+            const double dt = substepTimer.currentStepLength();
+            if (lastConvergedStep_ <= 0.0 || dt <= 0.0) {
+                return;
+            }
+
+            features.growth = dt / lastConvergedStep_;
+            const double maxStep = riskPredictor_.maxGrowth(features, maxFailureRisk_) * lastConvergedStep_;
+            if (maxStep >= dt) {
+                return;
+            }
+
+            const double newTimeStep = std::max(maxStep, restartFactor_ * dt);
+            if (timestepVerbose_) {
+                std::ostringstream ss;
+                ss << "Predicted convergence failure risk " << riskPredictor_.risk(features)
+                   << ", stepsize reduced to " << unit::convert::to(newTimeStep, unit::day) << " days.";
+                OpmLog::info(ss.str());
+            }
+            substepTimer.provideTimeStepEstimate(newTimeStep);
+            features.growth = substepTimer.currentStepLength() / lastConvergedStep_;
+        }
+
+        // the fraction of the Newton iterations of the last step with well failures
+        template <class StepReportVector>
+        static double wellFailureFraction_(const StepReportVector& sr)
+        {
+            if (sr.empty() || sr.back().report.empty()) {
+                return 0.0;
+            }
+            const auto& iterations = sr.back().report;
+            const auto failed = std::count_if(iterations.begin(), iterations.end(),
+                                              [](const ConvergenceReport& r) { return r.wellFailed(); });
+            return static_cast<double>(failed) / iterations.size();
+        }
+
         void init_()
         {
             // valid are "pid" and "pid+iteration"
@@ -470,6 +590,11 @@ namespace Opm {
                 const double growthrate = EWOMS_GET_PARAM(TypeTag, double, TimeStepControlGrowthRate); // 1.25
                 timeStepControl_ = TimeStepControlType(new SimpleIterationCountTimeStepControl(iterations, decayrate, growthrate));
             }
+            else if (control == "throughput") {
+                const double decayrate = EWOMS_GET_PARAM(TypeTag, double, TimeStepControlDecayRate); // 0.75
+                const double growthrate = EWOMS_GET_PARAM(TypeTag, double, TimeStepControlGrowthRate); // 1.25
+                timeStepControl_ = TimeStepControlType(new ThroughputTimeStepControl(tol, decayrate, growthrate));
+            }
             else if (control == "hardcoded") {
                 const std::string filename = EWOMS_GET_PARAM(TypeTag, std::string, TimeStepControlFileName); // "timesteps"
                 timeStepControl_ = TimeStepControlType(new HardcodedTimeStepControl(filename));
@@ -545,6 +670,11 @@ namespace Opm {
         bool fullTimestepInitially_;        //!< beginning with the size of the time step from data file
         double timestepAfterEvent_;         //!< suggested size of timestep after an event
         bool useNewtonIteration_;           //!< use newton iteration count for adaptive time step control
+        double maxFailureRisk_;             //!< largest predicted failure risk of a substep
+        ConvergenceRiskPredictor riskPredictor_;         //!< predictor of the failure risk of a substep
+        ConvergenceRiskPredictor::Features riskFeatures_; //!< features of the last substeps
+        double lastConvergedStep_ = 0.0;    //!< size of the last converged substep
+        bool planSubsteps_;                 //!< spread the rest of a report step evenly over the substeps
     };
 }
 
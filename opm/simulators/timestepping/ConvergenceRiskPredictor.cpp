@@ -0,0 +1,119 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include <config.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <opm/core/simulator/BinarySerialization.hpp>
+#include <opm/simulators/timestepping/ConvergenceRiskPredictor.hpp>
+
+namespace Opm
+{
+    namespace
+    {
+        // the smallest weight of the step growth, which keeps the risk increasing with it
+        const double minGrowthWeight = 0.1;
+    }
+
+    ConvergenceRiskPredictor::
+    ConvergenceRiskPredictor( const double learningRate )
+        : learningRate_( learningRate )
+        // a prior of a failure rate of about 3% for an unchanged step after five Newton
+        // iterations, which rises with the growth of the step and the signs of trouble
+        , weights_{{ -4.5, 2.0, 0.5, 1.0, 1.0, 1.0, 1.0 }}
+    {
+    }
+
+    ConvergenceRiskPredictor::FeatureVector
+    ConvergenceRiskPredictor::
+    featureVector_( const Features& features )
+    {
+        return {{ 1.0,
+                  std::log( std::max( features.growth, 1e-3 ) ),
+                  std::log( 1.0 + std::max( features.lastNewtonIterations, 0 ) ),
+                  std::min( std::abs( features.lastRelativeChange ), 1.0 ),
+                  std::min( std::max( features.lastWellFailureFraction, 0.0 ), 1.0 ),
+                  features.restarted ? 1.0 : 0.0,
+                  features.event ? 1.0 : 0.0 }};
+    }
+
+    double
+    ConvergenceRiskPredictor::
+    risk( const Features& features ) const
+    {
+        const FeatureVector x = featureVector_( features );
+        double z = 0.0;
+        for( int i = 0; i < numFeatures; ++i ) {
+            z += weights_[ i ] * x[ i ];
+        }
+        return 1.0 / ( 1.0 + std::exp( -z ) );
+    }
+
+    double
+    ConvergenceRiskPredictor::
+    maxGrowth( const Features& features, const double maxRisk ) const
+    {
+        if( maxRisk >= 1.0 ) {
+            return std::numeric_limits<double>::infinity();
+        }
+        if( maxRisk <= 0.0 ) {
+            return 0.0;
+        }
+
+        // solve weights * x = logit(maxRisk) for the log of the growth
+        const FeatureVector x = featureVector_( features );
+        double z = 0.0;
+        for( int i = 0; i < numFeatures; ++i ) {
+            if( i != growthIdx ) {
+                z += weights_[ i ] * x[ i ];
+            }
+        }
+        const double logit = std::log( maxRisk / ( 1.0 - maxRisk ) );
+        return std::exp( ( logit - z ) / weights_[ growthIdx ] );
+    }
+
+    void
+    ConvergenceRiskPredictor::
+    update( const Features& features, const bool converged )
+    {
+        // gradient of the log likelihood of the outcome
+        const double residual = ( converged ? 0.0 : 1.0 ) - risk( features );
+        const FeatureVector x = featureVector_( features );
+        for( int i = 0; i < numFeatures; ++i ) {
+            weights_[ i ] += learningRate_ * residual * x[ i ];
+        }
+        weights_[ growthIdx ] = std::max( weights_[ growthIdx ], minGrowthWeight );
+    }
+
+    void
+    ConvergenceRiskPredictor::
+    serialize( std::ostream& os ) const
+    {
+        BinarySerialization::write( os, weights_ );
+    }
+
+    void
+    ConvergenceRiskPredictor::
+    deserialize( std::istream& is )
+    {
+        BinarySerialization::read( is, weights_ );
+    }
+
+} // end namespace Opm
@@ -0,0 +1,92 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef OPM_CONVERGENCERISKPREDICTOR_HEADER_INCLUDED
+#define OPM_CONVERGENCERISKPREDICTOR_HEADER_INCLUDED
+
+#include <array>
+#include <istream>
+#include <ostream>
+
+namespace Opm
+{
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///  Predictor of the probability that the nonlinear solver fails to converge in a time step.
+    ///
+    ///  The probability is a logistic function of a few cheap features of the step and of the
+    ///  previous steps, whose weights are learned online by a stochastic gradient step on the
+    ///  outcome of each attempted step. The weight of the step growth is kept positive, such that
+    ///  the predicted risk of a step decreases with its size and there is a largest step size
+    ///  below a given risk.
+    //
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    class ConvergenceRiskPredictor
+    {
+    public:
+        /// the features of a time step
+        struct Features
+        {
+            /// the step size relative to the last converged step size
+            double growth = 1.0;
+            /// the Newton iterations of the last converged step
+            int lastNewtonIterations = 0;
+            /// the relative change of the solution in the last converged step
+            double lastRelativeChange = 0.0;
+            /// the fraction of the Newton iterations of the last attempt with well failures
+            double lastWellFailureFraction = 0.0;
+            /// whether the step follows a failed attempt
+            bool restarted = false;
+            /// whether the step is the first one after an event, e.g. a change of the wells
+            bool event = false;
+        };
+
+        /// \brief constructor
+        /// \param learningRate  the length of the gradient steps of the weights
+        explicit ConvergenceRiskPredictor( const double learningRate = 0.1 );
+
+        /// \brief the predicted probability that a step with the given features fails
+        double risk( const Features& features ) const;
+
+        /// \brief the largest step growth at which the predicted risk does not exceed maxRisk,
+        ///        the other features being given
+        double maxGrowth( const Features& features, const double maxRisk ) const;
+
+        /// \brief learn from the outcome of a step with the given features
+        void update( const Features& features, const bool converged );
+
+        /// \brief write the learned weights in binary for a checkpoint
+        void serialize( std::ostream& os ) const;
+
+        /// \brief read the weights written by serialize
+        void deserialize( std::istream& is );
+
+    protected:
+        static const int numFeatures = 7;
+        typedef std::array<double, numFeatures> FeatureVector;
+
+        // the intercept followed by the transformed features, the growth is at index growthIdx
+        static FeatureVector featureVector_( const Features& features );
+        static const int growthIdx = 1;
+
+        const double   learningRate_;
+        FeatureVector  weights_;
+    };
+
+} // end namespace Opm
+#endif
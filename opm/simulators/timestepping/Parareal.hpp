@@ -0,0 +1,132 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef OPM_PARAREAL_HEADER_INCLUDED
+#define OPM_PARAREAL_HEADER_INCLUDED
+
+#include <opm/common/ErrorMacros.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+namespace Opm
+{
+    /// \brief The outcome of the parareal iterations.
+    struct PararealReport
+    {
+        /// the number of iterations, i.e. of batches of fine propagations
+        int iterations = 0;
+        /// the largest change of a state in the last iteration
+        double correction = 0.0;
+        /// whether the correction met the tolerance
+        bool converged = false;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///  Parareal iterations over a sequence of time intervals, e.g. report steps, following
+    ///     Lions, Maday and Turinici. A "parareal" in time discretization of PDE's.
+    ///     C. R. Acad. Sci. Paris, Serie I 332. 2001.
+    ///
+    ///  A cheap coarse propagator G, e.g. large time steps with loose tolerances, runs sequentially
+    ///  over the intervals, and an accurate fine propagator F runs on all the intervals at once,
+    ///  starting from the states of the previous iteration. The states are corrected by
+    ///
+    ///     U_{n+1}^{k+1} = G(U_n^{k+1}) + F(U_n^k) - G(U_n^k).
+    ///
+    ///  After k iterations the first k intervals equal the sequential fine solution, hence the
+    ///  iterations stop at the latest after as many iterations as intervals.
+    ///
+    ///  \param[in,out] states      the initial state in states[0], the states at the ends of the
+    ///                             intervals on return, states.size() - 1 is the number of intervals
+    ///  \param coarse              coarse(n, u) returns G(u) over interval n
+    ///  \param fineBatch           fineBatch(first, starts) returns the F(starts[i]) over the intervals
+    ///                             first + i. The propagations are independent, hence the caller may
+    ///                             run them concurrently, e.g. on separate groups of ranks
+    ///  \param distance            distance(u, v) returns the size of the difference of two states
+    ///  \param maxIterations       the largest number of iterations
+    ///  \param tolerance           the iterations stop if no state changes by more than tolerance
+    ///
+    ///  The states need to be copyable and support += and -=.
+    //
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    template <class State, class Coarse, class FineBatch, class Distance>
+    PararealReport parareal(std::vector<State>& states,
+                            Coarse&& coarse,
+                            FineBatch&& fineBatch,
+                            Distance&& distance,
+                            const int maxIterations,
+                            const double tolerance)
+    {
+        if (states.empty()) {
+            OPM_THROW(std::invalid_argument, "Parareal needs an initial state");
+        }
+        const int numIntervals = states.size() - 1;
+
+        // the initial guess of the coarse propagator, whose results are kept for the corrections
+        std::vector<State> coarseStates;
+        coarseStates.reserve(numIntervals);
+        for (int n = 0; n < numIntervals; ++n) {
+            coarseStates.push_back(coarse(n, states[n]));
+            states[n + 1] = coarseStates.back();
+        }
+
+        PararealReport report;
+        for (int k = 0; k < maxIterations; ++k) {
+            // the intervals before the k-th start from the fine solution already
+            const int first = k;
+            if (first >= numIntervals) {
+                report.converged = true;
+                break;
+            }
+
+            const std::vector<State> starts(states.begin() + first, states.end() - 1);
+            const std::vector<State> fineStates = fineBatch(first, starts);
+            if (static_cast<int>(fineStates.size()) != numIntervals - first) {
+                OPM_THROW(std::logic_error, "The fine propagation returned " << fineStates.size()
+                          << " states for " << numIntervals - first << " intervals");
+            }
+            ++report.iterations;
+
+            // the start of the first interval did not change, hence its coarse terms cancel
+            report.correction = distance(fineStates[0], states[first + 1]);
+            states[first + 1] = fineStates[0];
+
+            for (int n = first + 1; n < numIntervals; ++n) {
+                State corrected = coarse(n, states[n]);
+                const State newCoarse = corrected;
+                corrected += fineStates[n - first];
+                corrected -= coarseStates[n];
+
+                report.correction = std::max(report.correction, distance(corrected, states[n + 1]));
+                states[n + 1] = corrected;
+                coarseStates[n] = newCoarse;
+            }
+
+            if (report.correction <= tolerance) {
+                report.converged = true;
+                break;
+            }
+        }
+        return report;
+    }
+
+} // namespace Opm
+
+#endif // OPM_PARAREAL_HEADER_INCLUDED
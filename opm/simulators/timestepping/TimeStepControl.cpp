@@ -19,8 +19,10 @@
   along with OPM.  If not, see <http://www.gnu.org/licenses/>.
 */
 #include <config.h>
+#include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <limits>
 #include <iostream>
 #include <stdexcept>
 #include <string>
@@ -28,6 +30,7 @@
 #include <iostream>
 
 #include <opm/common/ErrorMacros.hpp>
+#include <opm/core/simulator/BinarySerialization.hpp>
 #include <opm/parser/eclipse/Units/Units.hpp>
 #include <opm/simulators/timestepping/TimeStepControl.hpp>
 
@@ -160,6 +163,23 @@ namespace Opm
 
 
 
+    void PIDTimeStepControl::
+    serialize( std::ostream& os ) const
+    {
+        BinarySerialization::write( os, errors_ );
+    }
+
+    void PIDTimeStepControl::
+    deserialize( std::istream& is )
+    {
+        BinarySerialization::read( is, errors_ );
+        if( errors_.size() != 3 ) {
+            OPM_THROW(std::runtime_error,"PIDTimeStepControl: the checkpoint has " << errors_.size() << " errors instead of 3" );
+        }
+    }
+
+
+
     ////////////////////////////////////////////////////////////
     //
     //  PIDAndIterationCountTimeStepControl  Implementation
@@ -193,4 +213,193 @@ namespace Opm
         return std::min(dtEstimatePID, dtEstimateIter);
     }
 
+
+
+    ////////////////////////////////////////////////////////////
+    //
+    //  ThroughputTimeStepControl  Implementation
+    //
+    ////////////////////////////////////////////////////////////
+
+    void ThroughputTimeStepControl::QuadraticFit::
+    add( const double x, const double y, const double forgetting )
+    {
+        if( sx[0] == 0.0 ) {
+            origin = x;
+        }
+        const double u = x - origin;
+        double power = 1.0;
+        for( int k = 0; k < 5; ++k ) {
+            sx[k] = forgetting * sx[k] + power;
+            if( k < 3 ) {
+                sy[k] = forgetting * sy[k] + power * y;
+            }
+            power *= u;
+        }
+    }
+
+    double ThroughputTimeStepControl::QuadraticFit::
+    operator()( const double x ) const
+    {
+        const double u = x - origin;
+
+        // the normal equations of the parabola, solved by Cramer's rule
+        const double det = sx[0] * (sx[2] * sx[4] - sx[3] * sx[3])
+                         - sx[1] * (sx[1] * sx[4] - sx[3] * sx[2])
+                         + sx[2] * (sx[1] * sx[3] - sx[2] * sx[2]);
+        if( det > 1e-10 * sx[0] * sx[2] * sx[4] ) {
+            const double c = ( sx[0] * (sx[2] * sy[2] - sy[1] * sx[3])
+                             - sx[1] * (sx[1] * sy[2] - sy[1] * sx[2])
+                             + sy[0] * (sx[1] * sx[3] - sx[2] * sx[2]) ) / det;
+            if( c >= 0.0 ) {
+                const double b = ( sx[0] * (sy[1] * sx[4] - sx[3] * sy[2])
+                                 - sy[0] * (sx[1] * sx[4] - sx[3] * sx[2])
+                                 + sx[2] * (sx[1] * sy[2] - sy[1] * sx[2]) ) / det;
+                const double a = (sy[0] - b * sx[1] - c * sx[2]) / sx[0];
+                return a + (b + c * u) * u;
+            }
+        }
+
+        // without a spread of the step sizes, the iterations do not depend on dt,
+        // and iterations never decrease with larger steps
+        const double mean_u = sx[1] / sx[0];
+        const double mean_y = sy[0] / sx[0];
+        const double var_u = sx[2] / sx[0] - mean_u * mean_u;
+        const double slope = var_u > 1e-12 ? std::max((sy[1] / sx[0] - mean_u * mean_y) / var_u, 0.0) : 0.0;
+        return mean_y + slope * (u - mean_u);
+    }
+
+    ThroughputTimeStepControl::
+    ThroughputTimeStepControl( const double tol,
+                               const double decayrate,
+                               const double growthrate,
+                               const double forgetting,
+                               const bool verbose )
+        : BaseType( tol, verbose )
+        , decayrate_( decayrate )
+        , growthrate_( growthrate )
+        , forgetting_( forgetting )
+        , failedDt_( std::numeric_limits<double>::max() )
+    {
+        if( decayrate_ > 1.0 ) {
+            OPM_THROW(std::runtime_error,"ThroughputTimeStepControl: decay should be <= 1 " << decayrate_ );
+        }
+        if( growthrate_ < 1.0 ) {
+            OPM_THROW(std::runtime_error,"ThroughputTimeStepControl: growth should be >= 1 " << growthrate_ );
+        }
+        if( forgetting_ <= 0.0 || forgetting_ > 1.0 ) {
+            OPM_THROW(std::runtime_error,"ThroughputTimeStepControl: forgetting factor should be in (0, 1] " << forgetting_ );
+        }
+    }
+
+    void ThroughputTimeStepControl::
+    recordStepCost( const double dt, const bool converged, const int newtonIterations,
+                    const int linearIterations, const double wallTime )
+    {
+        if( !converged ) {
+            failedDt_ = std::min(failedDt_, dt);
+            stepsSinceFailure_ = 0;
+            return;
+        }
+
+        // forget a failure after some converged steps, such that larger steps are tried again
+        const int failureMemory = 5;
+        if( ++stepsSinceFailure_ > failureMemory ) {
+            failedDt_ = std::numeric_limits<double>::max();
+        }
+
+        const double newton = std::max(newtonIterations, 1);
+        const double linear = std::max(linearIterations, 1);
+        newtonFit_.add(std::log(dt), std::log(newton), forgetting_);
+        linearFit_.add(std::log(dt), std::log(linear), forgetting_);
+
+        snn_ = forgetting_ * snn_ + newton * newton;
+        snl_ = forgetting_ * snl_ + newton * linear;
+        sll_ = forgetting_ * sll_ + linear * linear;
+        snt_ = forgetting_ * snt_ + newton * wallTime;
+        slt_ = forgetting_ * slt_ + linear * wallTime;
+    }
+
+    double ThroughputTimeStepControl::
+    predictedStepTime( const double dt ) const
+    {
+        if( snn_ <= 0.0 ) {
+            return -1.0;
+        }
+
+        // time per Newton iteration and per linear iteration
+        double timeNewton = snt_ / snn_;
+        double timeLinear = 0.0;
+        const double det = snn_ * sll_ - snl_ * snl_;
+        if( det > 1e-8 * snn_ * sll_ ) {
+            const double tn = (snt_ * sll_ - slt_ * snl_) / det;
+            const double tl = (slt_ * snn_ - snt_ * snl_) / det;
+            if( tn >= 0.0 && tl >= 0.0 ) {
+                timeNewton = tn;
+                timeLinear = tl;
+            }
+        }
+
+        const double x = std::log(dt);
+        return timeNewton * std::exp(newtonFit_(x)) + timeLinear * std::exp(linearFit_(x));
+    }
+
+    void ThroughputTimeStepControl::
+    serialize( std::ostream& os ) const
+    {
+        BaseType :: serialize( os );
+        BinarySerialization::write( os, newtonFit_ );
+        BinarySerialization::write( os, linearFit_ );
+        for( const double sum : { snn_, snl_, sll_, snt_, slt_, failedDt_ } ) {
+            BinarySerialization::write( os, sum );
+        }
+        BinarySerialization::write( os, stepsSinceFailure_ );
+    }
+
+    void ThroughputTimeStepControl::
+    deserialize( std::istream& is )
+    {
+        BaseType :: deserialize( is );
+        BinarySerialization::read( is, newtonFit_ );
+        BinarySerialization::read( is, linearFit_ );
+        for( double* sum : { &snn_, &snl_, &sll_, &snt_, &slt_, &failedDt_ } ) {
+            BinarySerialization::read( is, *sum );
+        }
+        BinarySerialization::read( is, stepsSinceFailure_ );
+    }
+
+    double ThroughputTimeStepControl::
+    computeTimeStepSize( const double dt, const int iterations, const RelativeChangeInterface& relChange, const double simulationTimeElapsed ) const
+    {
+        const double dtEstimatePID = BaseType :: computeTimeStepSize( dt, iterations, relChange, simulationTimeElapsed);
+
+        // the candidate with the least predicted wall-clock time per simulated time
+        const int numCandidates = 9;
+        double dtEstimateThroughput = dt * growthrate_;
+        double bestCost = std::numeric_limits<double>::max();
+        if( predictedStepTime(dt) >= 0.0 ) {
+            for( int c = 0; c < numCandidates; ++c ) {
+                const double factor = decayrate_ * std::pow( growthrate_ / decayrate_, double(c) / (numCandidates - 1) );
+                const double candidate = dt * factor;
+                if( candidate >= failedDt_ && c > 0 ) {
+                    break;
+                }
+                const double cost = predictedStepTime(candidate) / candidate;
+                if( cost < bestCost ) {
+                    bestCost = cost;
+                    dtEstimateThroughput = candidate;
+                }
+            }
+        }
+        else {
+            // no model yet, grow up to below a failed step size
+            dtEstimateThroughput = std::max(dt * decayrate_, std::min(dtEstimateThroughput, failedDt_ * decayrate_));
+        }
+
+        if( verbose_ )
+            std::cout << "Computed step size (throughput): " << unit::convert::to( dtEstimateThroughput, unit::day ) << " (days)" << std::endl;
+
+        return std::min(dtEstimatePID, dtEstimateThroughput);
+    }
+
 } // end namespace Opm
@@ -84,6 +84,12 @@ namespace Opm
         /// \brief \copydoc TimeStepControlInterface::computeTimeStepSize
         double computeTimeStepSize( const double dt, const int /* iterations */, const RelativeChangeInterface& relativeChange, const double /*simulationTimeElapsed */ ) const;
 
+        /// \brief \copydoc TimeStepControlInterface::serialize
+        void serialize( std::ostream& os ) const;
+
+        /// \brief \copydoc TimeStepControlInterface::deserialize
+        void deserialize( std::istream& is );
+
     protected:
         const double tol_;
         mutable std::vector< double > errors_;
@@ -117,6 +123,84 @@ namespace Opm
         const int     target_iterations_;
     };
 
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    ///
+    ///  Throughput based adaptive time step control: the step size maximizes the simulated time per
+    ///  wall-clock second, as predicted by a running model of the cost of the recent steps, and is
+    ///  limited by the PID controller above.
+    ///
+    ///  The model fits the logarithms of the Newton and linear iterations of a step as quadratic
+    ///  functions of the logarithm of the step size, and the wall-clock time of a step as a linear
+    ///  combination of its Newton and linear iterations. The fits are least squares with
+    ///  exponentially decaying weights of the older steps. The next step size is the candidate
+    ///  between dt * decayrate and dt * growthrate with the least predicted wall-clock time per
+    ///  simulated time, and stays below the size of a recently failed step.
+    //
+    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    class ThroughputTimeStepControl : public PIDTimeStepControl
+    {
+        typedef PIDTimeStepControl BaseType;
+    public:
+        /// \brief constructor
+        /// \param tol         tolerance for the relative changes of the numerical solution to be accepted
+        ///                    in one time step
+        /// \param decayrate   smallest factor of the change of the time step size (should be <= 1)
+        /// \param growthrate  largest factor of the change of the time step size (should be >= 1)
+        /// \param forgetting  factor of the weights of the older steps in the fits (in (0, 1])
+        /// \param verbose     if true get some output (default = false)
+        ThroughputTimeStepControl( const double tol,
+                                   const double decayrate,
+                                   const double growthrate,
+                                   const double forgetting = 0.8,
+                                   const bool verbose = false );
+
+        /// \brief \copydoc TimeStepControlInterface::computeTimeStepSize
+        double computeTimeStepSize( const double dt, const int iterations, const RelativeChangeInterface& relativeChange, const double simulationTimeElapsed ) const;
+
+        /// \brief \copydoc TimeStepControlInterface::recordStepCost
+        void recordStepCost( const double dt, const bool converged, const int newtonIterations,
+                             const int linearIterations, const double wallTime );
+
+        /// \brief the predicted wall-clock time of a step of size dt, negative if there is no model yet
+        double predictedStepTime( const double dt ) const;
+
+        /// \brief \copydoc TimeStepControlInterface::serialize
+        void serialize( std::ostream& os ) const;
+
+        /// \brief \copydoc TimeStepControlInterface::deserialize
+        void deserialize( std::istream& is );
+
+    protected:
+        /// weighted least squares fit of y = a + b x + c x^2 with decaying weights,
+        /// reduced to a line if there are too few step sizes or the parabola is concave
+        struct QuadraticFit
+        {
+            void add( const double x, const double y, const double forgetting );
+            double operator()( const double x ) const;
+
+            // the moments are taken about the first x, which keeps them well scaled
+            double origin = 0.0;
+            double sx[5] = {0.0, 0.0, 0.0, 0.0, 0.0};
+            double sy[3] = {0.0, 0.0, 0.0};
+        };
+
+        const double  decayrate_;
+        const double  growthrate_;
+        const double  forgetting_;
+        // log of the Newton and linear iterations as functions of the log of dt
+        QuadraticFit  newtonFit_;
+        QuadraticFit  linearFit_;
+        // sums of the least squares fit of the wall-clock time by the iterations
+        double        snn_ = 0.0;
+        double        snl_ = 0.0;
+        double        sll_ = 0.0;
+        double        snt_ = 0.0;
+        double        slt_ = 0.0;
+        // the smallest recently failed step size and the converged steps since
+        double        failedDt_;
+        int           stepsSinceFailure_ = 0;
+    };
+
     ///////////////////////////////////////////////////////////////////////////////////////////////////////////////
     ///
     ///  HardcodedTimeStepControl
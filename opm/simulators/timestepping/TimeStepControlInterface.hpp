@@ -19,6 +19,8 @@
 #ifndef OPM_TIMESTEPCONTROLINTERFACE_HEADER_INCLUDED
 #define OPM_TIMESTEPCONTROLINTERFACE_HEADER_INCLUDED
 
+#include <istream>
+#include <ostream>
 
 namespace Opm
 {
@@ -58,6 +60,23 @@ namespace Opm
         /// \return suggested time step size for the next step
         virtual double computeTimeStepSize( const double dt, const int iterations, const RelativeChangeInterface& relativeChange , const double simulationTimeElapsed) const = 0;
 
+        /// record the cost of an attempted time step, called for each converged
+        /// or failed step before the next computeTimeStepSize (default: ignored)
+        /// \param dt                time step size attempted
+        /// \param converged         whether the time step converged
+        /// \param newtonIterations  number of Newton iterations used
+        /// \param linearIterations  number of linear iterations used
+        /// \param wallTime          wall-clock time used in seconds
+        virtual void recordStepCost( const double /* dt */, const bool /* converged */,
+                                     const int /* newtonIterations */, const int /* linearIterations */,
+                                     const double /* wallTime */ ) {}
+
+        /// write the history of the controller in binary for a checkpoint (default: none)
+        virtual void serialize( std::ostream& /* os */ ) const {}
+
+        /// read the history written by serialize (default: none)
+        virtual void deserialize( std::istream& /* is */ ) {}
+
         /// virtual destructor (empty)
         virtual ~TimeStepControlInterface () {}
     };
@@ -169,6 +169,16 @@ namespace Opm
     /// (per-process) reports.
     ConvergenceReport gatherConvergenceReport(const ConvergenceReport& local_report)
     {
+        // Usually no process has failures to report, which a single reduction
+        // of the failure counts and the worst severity finds out.
+        int summary[3] = { static_cast<int>(local_report.reservoirFailures().size()),
+                           static_cast<int>(local_report.wellFailures().size()),
+                           static_cast<int>(local_report.severityOfWorstFailure()) };
+        MPI_Allreduce(MPI_IN_PLACE, summary, 3, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+        if (summary[0] == 0 && summary[1] == 0) {
+            return ConvergenceReport();
+        }
+
         // Pack local report.
         int message_size = messageSize(local_report);
         std::vector<char> buffer(message_size);
@@ -0,0 +1,61 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media Project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef OPM_SPARSITYPATTERNTESTHELPERS_HEADER
+#define OPM_SPARSITYPATTERNTESTHELPERS_HEADER
+
+#include <dune/istl/bcrsmatrix.hh>
+
+/// Set up the pattern of a 1D three point stencil with N cells.
+/// The entries are left for the caller to set.
+template<class B, class Alloc>
+void setupTridiagonalPattern(Dune::BCRSMatrix<B,Alloc>& A, int N)
+{
+    typedef Dune::BCRSMatrix<B,Alloc> Matrix;
+    A.setSize(N, N, 3 * N - 2);
+    A.setBuildMode(Matrix::row_wise);
+    for ( auto row = A.createbegin(); row != A.createend(); ++row )
+    {
+        const int i = row.index();
+        if ( i > 0 ) row.insert(i - 1);
+        row.insert(i);
+        if ( i < N - 1 ) row.insert(i + 1);
+    }
+}
+
+/// Set up the pattern of a 2D five point stencil on an N x N grid.
+/// The entries are left for the caller to set.
+template<class B, class Alloc>
+void setupFivePointPattern(Dune::BCRSMatrix<B,Alloc>& A, int N)
+{
+    typedef Dune::BCRSMatrix<B,Alloc> Matrix;
+    const int n = N * N;
+    A.setSize(n, n, 5 * n);
+    A.setBuildMode(Matrix::row_wise);
+    for ( auto row = A.createbegin(); row != A.createend(); ++row )
+    {
+        const int i = row.index() % N, j = row.index() / N;
+        if ( j > 0 ) row.insert(row.index() - N);
+        if ( i > 0 ) row.insert(row.index() - 1);
+        row.insert(row.index());
+        if ( i < N - 1 ) row.insert(row.index() + 1);
+        if ( j < N - 1 ) row.insert(row.index() + N);
+    }
+}
+
+#endif // OPM_SPARSITYPATTERNTESTHELPERS_HEADER
@@ -0,0 +1,193 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// Compares the variants of ParallelOverlappingILU0 on dumped systems, e.g.
+///
+///     benchmark_ilu 2 1e-2 dumps/linsys_step3_ts7_it1.bin
+///
+/// The first argument is the largest fill in level, the second the relative
+/// reduction of the residual required from BiCGStab, and the remaining ones
+/// are system files written with --linear-system-dump-dir.
+///
+/// For each MILU variant, fill in level and ordering (natural, red-black,
+/// red-black with sphere reordering and reverse Cuthill-McKee) the table
+/// shows the time of the setup (including the ordering), of the numerical
+/// factorization, the mean time of one application and the iterations and
+/// time of BiCGStab. Only the reservoir matrix is used, the well
+/// contributions of the files are ignored.
+
+#include <config.h>
+
+#include <opm/autodiff/LinearSystemIO.hpp>
+#include <opm/autodiff/ParallelOverlappingILU0.hpp>
+#include <opm/autodiff/TimingRegistry.hpp>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/common/timer.hh>
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/operators.hh>
+#include <dune/istl/solvers.hh>
+
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    /// An ordering of the rows used by the factorization.
+    struct Ordering
+    {
+        const char* name;
+        bool redblack;
+        bool reorder_sphere;
+        bool reorder_rcm;
+    };
+
+    const Ordering orderings[] = {
+        { "natural", false, false, false },
+        { "redblack", true, false, false },
+        { "redblack sphere", true, true, false },
+        { "rcm", false, false, true }
+    };
+
+    const Opm::MILU_VARIANT variants[] = {
+        Opm::MILU_VARIANT::ILU, Opm::MILU_VARIANT::MILU_1, Opm::MILU_VARIANT::MILU_2,
+        Opm::MILU_VARIANT::MILU_3, Opm::MILU_VARIANT::MILU_4
+    };
+
+    const char* variantName(const Opm::MILU_VARIANT milu)
+    {
+        switch (milu) {
+        case Opm::MILU_VARIANT::MILU_1: return "MILU_1";
+        case Opm::MILU_VARIANT::MILU_2: return "MILU_2";
+        case Opm::MILU_VARIANT::MILU_3: return "MILU_3";
+        case Opm::MILU_VARIANT::MILU_4: return "MILU_4";
+        default: return "ILU";
+        }
+    }
+
+    double seconds(const std::string& label)
+    {
+        return Opm::TimingRegistry::instance().entry(label).seconds;
+    }
+
+    template <int N>
+    void benchmark(const std::string& name, std::istream& is, const int max_fill, const double reduction)
+    {
+        typedef Dune::FieldMatrix<double, N, N> Block;
+        typedef Dune::BCRSMatrix<Block> Matrix;
+        typedef Dune::BlockVector<Dune::FieldVector<double, N>> Vector;
+        typedef Opm::ParallelOverlappingILU0<Matrix, Vector, Vector> ILU;
+
+        Matrix A;
+        Vector b;
+        Opm::LinearSystemIO::readMatrix(is, A);
+        Opm::LinearSystemIO::readVector(is, b);
+        if (!is) {
+            OPM_THROW(std::runtime_error, "Could not read the system of " << name);
+        }
+
+        auto& registry = Opm::TimingRegistry::instance();
+        auto& apply = registry.entry("ilu.apply");
+        Dune::MatrixAdapter<Matrix, Vector, Vector> op(A);
+
+        for (const auto milu : variants) {
+            for (int n = 0; n <= max_fill; ++n) {
+                for (const auto& ordering : orderings) {
+                    // the red-black ordering is only used without fill in
+                    if (ordering.redblack && n > 0) {
+                        continue;
+                    }
+                    registry.reset();
+                    Dune::Timer timer;
+                    timer.reset();
+                    ILU ilu(A, n, 1.0, milu, ordering.redblack, ordering.reorder_sphere, ordering.reorder_rcm);
+                    const double setup = timer.elapsed();
+                    const double factorize = seconds("ilu.factorize") + seconds("ilu.symbolic");
+
+                    Vector x(b.size());
+                    x = 0.0;
+                    Vector rhs(b);
+                    Dune::BiCGSTABSolver<Vector> solver(op, ilu, reduction, 1000, 0);
+                    Dune::InverseOperatorResult result;
+                    timer.reset();
+                    solver.apply(x, rhs, result);
+                    const double solve = timer.elapsed();
+
+                    std::cout << std::left << std::setw(32) << name
+                              << std::setw(8) << variantName(milu)
+                              << std::right << std::setw(5) << n << "  "
+                              << std::left << std::setw(16) << ordering.name << std::right
+                              << std::setw(12) << setup
+                              << std::setw(12) << factorize
+                              << std::setw(12) << (apply.calls > 0 ? apply.seconds / apply.calls : 0.0)
+                              << std::setw(8) << result.iterations
+                              << std::setw(12) << solve
+                              << (result.converged ? "" : "  (not converged)") << std::endl;
+                }
+            }
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 4) {
+        std::cerr << "Usage: " << argv[0] << " max_fill_level reduction system_file [system_file ...]" << std::endl;
+        return EXIT_FAILURE;
+    }
+    const int max_fill = std::atoi(argv[1]);
+    const double reduction = std::atof(argv[2]);
+
+    Opm::TimingRegistry::instance().setEnabled(true);
+
+    std::cout << "times in seconds" << std::endl
+              << std::left << std::setw(32) << "system"
+              << std::setw(8) << "variant"
+              << std::right << std::setw(5) << "fill" << "  "
+              << std::left << std::setw(16) << "ordering" << std::right
+              << std::setw(12) << "setup"
+              << std::setw(12) << "factorize"
+              << std::setw(12) << "apply"
+              << std::setw(8) << "iter"
+              << std::setw(12) << "bicgstab" << std::endl;
+
+    for (int arg = 3; arg < argc; ++arg) {
+        std::ifstream is(argv[arg], std::ios::binary);
+        if (!is) {
+            std::cerr << "Could not open " << argv[arg] << std::endl;
+            return EXIT_FAILURE;
+        }
+        const int num_eq = Opm::LinearSystemIO::readHeader(is);
+        switch (num_eq) {
+        case 2: benchmark<2>(argv[arg], is, max_fill, reduction); break;
+        case 3: benchmark<3>(argv[arg], is, max_fill, reduction); break;
+        default:
+            std::cerr << "Systems with " << num_eq << " equations per cell are not supported" << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
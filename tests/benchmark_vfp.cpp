@@ -0,0 +1,311 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// Measures the evaluations per second of VFP production tables, e.g.
+///
+///     benchmark_vfp 100000 20 tests/VFPPROD1 tests/VFPPROD2
+///
+/// The first argument is the number of evaluations of each kernel, the
+/// second the number of points of each axis of a synthetic table (0 for no
+/// synthetic table, which holds n^5 values), and the remaining ones are
+/// files with VFPPROD keywords in metric units.
+///
+/// Each table is evaluated at random points spread over its axes, including
+/// some extrapolation, and along Newton-like paths of small steps from
+/// random starting points. The kernels timed are bhp() without and with
+/// interpolation hints, the batched bhp(), thp() and
+/// calculateBhpWithTHPTarget().
+
+#include <config.h>
+
+#include <opm/autodiff/VFPHelpers.hpp>
+#include <opm/autodiff/VFPProdProperties.hpp>
+#include <opm/parser/eclipse/Parser/Parser.hpp>
+#include <opm/parser/eclipse/Deck/Deck.hpp>
+#include <opm/parser/eclipse/EclipseState/Schedule/VFPProdTable.hpp>
+#include <opm/parser/eclipse/Units/UnitSystem.hpp>
+
+#include <dune/common/timer.hh>
+
+#include <algorithm>
+#include <cstdlib>
+#include <initializer_list>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    /// A point of evaluation of a production table.
+    struct Point
+    {
+        double aqua;
+        double liquid;
+        double vapour;
+        double thp;
+        double alq;
+    };
+
+    /// The phase rates (negative for producers) of given flo, wfr and gfr of a table.
+    Point ratesFromTable(const Opm::VFPProdTable& table, const double flo, double wfr, const double gfr)
+    {
+        // water and gas per unit of oil
+        double water = 0.0;
+        double gas = 0.0;
+        if (table.getWFRType() == Opm::VFPProdTable::WFR_WGR) {
+            switch (table.getGFRType()) {
+            case Opm::VFPProdTable::GFR_GOR: gas = gfr; break;
+            case Opm::VFPProdTable::GFR_GLR: gas = gfr / std::max(1.0 - gfr * wfr, 1.0e-3); break;
+            default: gas = 1.0 / std::max(gfr, 1.0e-3); break;
+            }
+            water = wfr * gas;
+        }
+        else {
+            if (table.getWFRType() == Opm::VFPProdTable::WFR_WCT) {
+                wfr = std::min(wfr, 0.99);
+                water = wfr / (1.0 - wfr);
+            }
+            else {
+                water = wfr;
+            }
+            switch (table.getGFRType()) {
+            case Opm::VFPProdTable::GFR_GOR: gas = gfr; break;
+            case Opm::VFPProdTable::GFR_GLR: gas = gfr * (1.0 + water); break;
+            default: gas = 1.0 / std::max(gfr, 1.0e-3); break;
+            }
+        }
+
+        // scale the rates to the flo, the fractions do not change
+        const double unit_flo = Opm::detail::getFlo(water, 1.0, gas, table.getFloType());
+        const double scale = unit_flo > 0.0 ? -flo / unit_flo : 0.0;
+        return Point{water * scale, scale, gas * scale, 0.0, 0.0};
+    }
+
+    /// A value of an axis, spread over its range and 10% beyond.
+    double axisValue(const std::vector<double>& axis, const double t)
+    {
+        const double range = axis.back() - axis.front();
+        return axis.front() - 0.1 * range + t * 1.2 * range;
+    }
+
+    /// Points at random or along Newton-like paths of small steps.
+    std::vector<Point> points(const Opm::VFPProdTable& table, const int count,
+                              const bool newton, std::mt19937& generator)
+    {
+        std::uniform_real_distribution<double> uniform(0.0, 1.0);
+        std::uniform_real_distribution<double> step(-0.01, 0.01);
+        const int path_length = 10;
+        double t[5] = {0.0, 0.0, 0.0, 0.0, 0.0};
+        std::vector<Point> result;
+        result.reserve(count);
+        for (int i = 0; i < count; ++i) {
+            for (double& ti : t) {
+                if (!newton || i % path_length == 0) {
+                    ti = uniform(generator);
+                }
+                else {
+                    ti = std::min(std::max(ti + step(generator), 0.0), 1.0);
+                }
+            }
+            Point point = ratesFromTable(table,
+                                         std::max(axisValue(table.getFloAxis(), t[0]), 0.0),
+                                         std::max(axisValue(table.getWFRAxis(), t[1]), 0.0),
+                                         std::max(axisValue(table.getGFRAxis(), t[2]), 0.0));
+            point.thp = axisValue(table.getTHPAxis(), t[3]);
+            point.alq = axisValue(table.getALQAxis(), t[4]);
+            result.push_back(point);
+        }
+        return result;
+    }
+
+    /// A table of liquid rate, water cut and gas-oil ratio with n points on each axis.
+    std::unique_ptr<Opm::VFPProdTable> syntheticTable(const int table_num, const int n)
+    {
+        auto axis = [n](const double first, const double last) {
+            std::vector<double> values(n);
+            for (int i = 0; i < n; ++i) {
+                values[i] = first + (last - first) * i / std::max(n - 1, 1);
+            }
+            return values;
+        };
+        const std::vector<double> flo_axis = axis(1.0e-3, 1.0);
+        const std::vector<double> thp_axis = axis(1.0e5, 1.0e7);
+        const std::vector<double> wfr_axis = axis(0.0, 1.0);
+        const std::vector<double> gfr_axis = axis(10.0, 1000.0);
+        const std::vector<double> alq_axis = axis(0.0, 1.0);
+
+        Opm::VFPProdTable::extents size{{ n, n, n, n, n }};
+        Opm::VFPProdTable::array_type data(size);
+        for (int t = 0; t < n; ++t) {
+            for (int w = 0; w < n; ++w) {
+                for (int g = 0; g < n; ++g) {
+                    for (int a = 0; a < n; ++a) {
+                        for (int f = 0; f < n; ++f) {
+                            // friction growing with the rate, with a minimum of the
+                            // hydrostatic head at moderate rates
+                            const double flo = flo_axis[f];
+                            const double head = 1.0e7 * (0.5 + 0.5 * wfr_axis[w]) / (1.0 + 1.0e-3 * gfr_axis[g]);
+                            data[t][w][g][a][f] = thp_axis[t] + head * (1.0 - 0.5 * alq_axis[a])
+                                * (0.3 + 2.0 * (flo - 0.2) * (flo - 0.2));
+                        }
+                    }
+                }
+            }
+        }
+        return std::unique_ptr<Opm::VFPProdTable>(
+            new Opm::VFPProdTable(table_num, 0.0,
+                                  Opm::VFPProdTable::FLO_LIQ,
+                                  Opm::VFPProdTable::WFR_WCT,
+                                  Opm::VFPProdTable::GFR_GOR,
+                                  Opm::VFPProdTable::ALQ_UNDEF,
+                                  flo_axis, thp_axis, wfr_axis, gfr_axis, alq_axis, data));
+    }
+
+    template <class Kernel>
+    double evaluationsPerSecond(const std::vector<Point>& samples, Kernel&& kernel)
+    {
+        Dune::Timer timer;
+        timer.reset();
+        for (const auto& point : samples) {
+            kernel(point);
+        }
+        const double elapsed = timer.elapsed();
+        return elapsed > 0.0 ? samples.size() / elapsed : 0.0;
+    }
+
+    void benchmark(const std::string& name, const Opm::VFPProdTable& table, const int count)
+    {
+        const Opm::VFPProdProperties properties(&table);
+        const int table_id = table.getTableNum();
+        const auto& data = table.getTable();
+        const double max_bhp = *std::max_element(data.data(), data.data() + data.num_elements());
+        const double min_bhp = *std::min_element(data.data(), data.data() + data.num_elements());
+
+        std::mt19937 generator(42);
+        for (const bool newton : {false, true}) {
+            const std::vector<Point> samples = points(table, count, newton, generator);
+            // the results are summed such that the evaluations are not optimized away
+            double sum = 0.0;
+
+            const double bhp = evaluationsPerSecond(samples, [&](const Point& p) {
+                sum += properties.bhp(table_id, p.aqua, p.liquid, p.vapour, p.thp, p.alq);
+            });
+
+            Opm::detail::InterpHint hint;
+            const double bhp_hint = evaluationsPerSecond(samples, [&](const Point& p) {
+                sum += properties.bhp(table_id, p.aqua, p.liquid, p.vapour, p.thp, p.alq, &hint);
+            });
+
+            // batches of wells evaluated in one call
+            const std::size_t batch_size = 100;
+            std::vector<int> ids;
+            std::vector<double> aqua, liquid, vapour, thp, alq;
+            std::vector<Opm::detail::VFPEvaluation> bhps;
+            std::vector<Opm::detail::InterpHint> hints(batch_size);
+            Dune::Timer timer;
+            timer.reset();
+            for (std::size_t start = 0; start < samples.size(); start += batch_size) {
+                const std::size_t end = std::min(start + batch_size, samples.size());
+                ids.assign(end - start, table_id);
+                aqua.clear(); liquid.clear(); vapour.clear(); thp.clear(); alq.clear();
+                for (std::size_t i = start; i < end; ++i) {
+                    aqua.push_back(samples[i].aqua);
+                    liquid.push_back(samples[i].liquid);
+                    vapour.push_back(samples[i].vapour);
+                    thp.push_back(samples[i].thp);
+                    alq.push_back(samples[i].alq);
+                }
+                hints.resize(end - start);
+                properties.bhp(ids, aqua, liquid, vapour, thp, alq, bhps, &hints);
+                for (const auto& value : bhps) {
+                    sum += value.value;
+                }
+            }
+            const double batch_elapsed = timer.elapsed();
+            const double bhp_batch = batch_elapsed > 0.0 ? samples.size() / batch_elapsed : 0.0;
+
+            const double thp_rate = evaluationsPerSecond(samples, [&](const Point& p) {
+                const double bhp_value = 0.5 * (min_bhp + max_bhp);
+                sum += properties.thp(table_id, p.aqua, p.liquid, p.vapour, bhp_value, p.alq);
+            });
+
+            // an inflow performance relationship through the rates of the point
+            // at its bhp, for a reservoir pressure above all bhps of the table
+            const double reservoir_pressure = 1.2 * max_bhp;
+            const double thp_target = evaluationsPerSecond(samples, [&](const Point& p) {
+                const double bhp_value = properties.bhp(table_id, p.aqua, p.liquid, p.vapour, p.thp, p.alq);
+                const double drawdown = std::max(reservoir_pressure - bhp_value, 1.0);
+                const std::vector<double> ipr_b = {-p.aqua / drawdown, -p.liquid / drawdown, -p.vapour / drawdown};
+                const std::vector<double> ipr_a = {ipr_b[0] * reservoir_pressure,
+                                                   ipr_b[1] * reservoir_pressure,
+                                                   ipr_b[2] * reservoir_pressure};
+                sum += properties.calculateBhpWithTHPTarget(ipr_a, ipr_b, 0.5 * min_bhp, table_id,
+                                                            p.thp, p.alq, 0.0);
+            });
+
+            std::cout << std::left << std::setw(24) << name
+                      << std::setw(8) << (newton ? "newton" : "random") << std::right
+                      << std::setw(14) << bhp
+                      << std::setw(14) << bhp_hint
+                      << std::setw(14) << bhp_batch
+                      << std::setw(14) << thp_rate
+                      << std::setw(14) << thp_target
+                      << "   (" << sum << ")" << std::endl;
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " evaluations synthetic_axis_size [vfpprod_file ...]" << std::endl;
+        return EXIT_FAILURE;
+    }
+    const int count = std::atoi(argv[1]);
+    const int synthetic_size = std::atoi(argv[2]);
+
+    std::cout << "evaluations per second" << std::endl
+              << std::left << std::setw(24) << "table"
+              << std::setw(8) << "access" << std::right
+              << std::setw(14) << "bhp"
+              << std::setw(14) << "bhp hint"
+              << std::setw(14) << "bhp batch"
+              << std::setw(14) << "thp"
+              << std::setw(14) << "bhp thp target" << std::endl;
+
+    if (synthetic_size > 1) {
+        const auto table = syntheticTable(1, synthetic_size);
+        benchmark("synthetic " + std::to_string(synthetic_size) + "^5", *table, count);
+    }
+
+    const auto units = Opm::UnitSystem::newMETRIC();
+    for (int arg = 3; arg < argc; ++arg) {
+        Opm::Parser parser;
+        const auto deck = parser.parseFile(argv[arg]);
+        for (std::size_t i = 0; i < deck.count("VFPPROD"); ++i) {
+            const Opm::VFPProdTable table(deck.getKeyword("VFPPROD", i), units);
+            benchmark(std::string(argv[arg]) + " " + std::to_string(table.getTableNum()), table, count);
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,218 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// Times the kernels of the well models on the wells of a deck, e.g.
+///
+///     benchmark_well_model --ecl-deck-file-name=msw.data --benchmark-repetitions=1000
+///
+/// The wells of the first report step are set up for the initial solution
+/// by one linearization. Then assembleWellEq, apply,
+/// recoverWellSolutionAndUpdateWellState and computeWellPotentials are
+/// called repeatedly for each well, each on its own copy of the well state.
+/// The times are summed per well model (StandardWell, StandardWellV,
+/// MultisegmentWell). With --benchmark-well-copies=n, each well is timed n
+/// times in turn, as if the deck had n copies of it. The copies share the
+/// well object, hence its data stays in the cache. All parameters of flow can
+/// be used, e.g. --use-multisegment-well=false to time the wells of msw.data
+/// as standard wells.
+///
+/// Only decks of the three phase black-oil model are supported.
+
+#include <config.h>
+
+#include <opm/autodiff/FlowMainEbos.hpp>
+#include <opm/autodiff/BlackoilWellModel.hpp>
+
+#if HAVE_DUNE_FEM
+#include <dune/fem/misc/mpimanager.hh>
+#else
+#include <dune/common/parallel/mpihelper.hh>
+#endif
+#include <dune/common/timer.hh>
+
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+BEGIN_PROPERTIES
+NEW_PROP_TAG(BenchmarkRepetitions);
+NEW_PROP_TAG(BenchmarkWellCopies);
+NEW_PROP_TAG(BenchmarkTimeStepSize);
+SET_INT_PROP(EclFlowProblem, BenchmarkRepetitions, 100);
+SET_INT_PROP(EclFlowProblem, BenchmarkWellCopies, 1);
+SET_SCALAR_PROP(EclFlowProblem, BenchmarkTimeStepSize, 86400.0);
+END_PROPERTIES
+
+namespace
+{
+    typedef TTAG(EclFlowProblem) TypeTag;
+    typedef GET_PROP_TYPE(TypeTag, Simulator) Simulator;
+    typedef GET_PROP_TYPE(TypeTag, Scalar) Scalar;
+    typedef Opm::BlackoilWellModel<TypeTag> WellModel;
+    typedef WellModel::WellState WellState;
+    typedef WellModel::BVector BVector;
+    typedef Opm::WellInterface<TypeTag> Well;
+
+    /// The summed times of the kernels of the wells of one model.
+    struct KernelTimes
+    {
+        int wells = 0;
+        double assemble = 0.0;
+        double apply = 0.0;
+        double recover = 0.0;
+        double potentials = 0.0;
+    };
+
+    std::string modelName(const Well& well)
+    {
+        if ( dynamic_cast<const Opm::StandardWell<TypeTag>*>(&well) ) {
+            return "StandardWell";
+        }
+        if ( dynamic_cast<const Opm::StandardWellV<TypeTag>*>(&well) ) {
+            return "StandardWellV";
+        }
+        if ( dynamic_cast<const Opm::MultisegmentWell<TypeTag>*>(&well) ) {
+            return "MultisegmentWell";
+        }
+        return "unknown";
+    }
+
+    void timeWell(Simulator& simulator, Well& well, const WellState& wellState,
+                  const double dt, const int repetitions, KernelTimes& times)
+    {
+        const auto numCells = simulator.model().numGridDof();
+        BVector x(numCells);
+        x = 1.0;
+        BVector Ax(numCells);
+        Ax = 0.0;
+        // a zero update keeps the well state of the repetitions the same
+        BVector dx(numCells);
+        dx = 0.0;
+
+        WellState state(wellState);
+        std::vector<double> potentials;
+        Dune::Timer timer;
+
+        timer.reset();
+        for ( int rep = 0; rep < repetitions; ++rep ) {
+            well.assembleWellEq(simulator, dt, state);
+        }
+        times.assemble += timer.elapsed();
+
+        timer.reset();
+        for ( int rep = 0; rep < repetitions; ++rep ) {
+            well.apply(x, Ax);
+        }
+        times.apply += timer.elapsed();
+
+        timer.reset();
+        for ( int rep = 0; rep < repetitions; ++rep ) {
+            well.recoverWellSolutionAndUpdateWellState(dx, state);
+        }
+        times.recover += timer.elapsed();
+
+        timer.reset();
+        for ( int rep = 0; rep < repetitions; ++rep ) {
+            well.computeWellPotentials(simulator, state, potentials);
+        }
+        times.potentials += timer.elapsed();
+
+        ++times.wells;
+    }
+}
+
+int main(int argc, char** argv)
+{
+#if HAVE_DUNE_FEM
+    Dune::Fem::MPIManager::initialize(argc, argv);
+#else
+    Dune::MPIHelper::instance(argc, argv);
+#endif
+
+    EWOMS_REGISTER_PARAM(TypeTag, int, BenchmarkRepetitions,
+                         "The number of times each kernel is called for each well");
+    EWOMS_REGISTER_PARAM(TypeTag, int, BenchmarkWellCopies,
+                         "The number of times each well is timed in turn, as copies of the well");
+    EWOMS_REGISTER_PARAM(TypeTag, Scalar, BenchmarkTimeStepSize,
+                         "The time step size of the assembly of the well equations [s]");
+    const int status = Opm::FlowMainEbos<TypeTag>::setupParameters_(argc, argv);
+    if ( status != 0 ) {
+        return status == -1 ? EXIT_SUCCESS : status;
+    }
+
+    const int repetitions = EWOMS_GET_PARAM(TypeTag, int, BenchmarkRepetitions);
+    const int copies = EWOMS_GET_PARAM(TypeTag, int, BenchmarkWellCopies);
+    const double dt = EWOMS_GET_PARAM(TypeTag, Scalar, BenchmarkTimeStepSize);
+
+    Simulator simulator(/*verbose=*/false);
+    simulator.model().applyInitialSolution();
+
+    // the first time step of the first report step, as set up by flow
+    simulator.startNextEpisode(/*episodeStartTime=*/0.0, /*episodeLength=*/1e30);
+    simulator.setEpisodeIndex(0);
+    simulator.setTime(0.0);
+    simulator.setTimeStepSize(dt);
+    simulator.problem().beginEpisode(/*isRestart=*/false);
+    simulator.problem().beginTimeStep();
+
+    // one linearization sets up the well equations and the intensive quantities
+    simulator.model().newtonMethod().setIterationIndex(0);
+    simulator.problem().beginIteration();
+    simulator.model().linearizer().linearize();
+    simulator.problem().endIteration();
+
+    auto& wellModel = simulator.problem().wellModel();
+    const WellState wellState = wellModel.wellState();
+
+    std::map<std::string, KernelTimes> times;
+    for ( const auto* wellEcl : simulator.vanguard().schedule().getWells(0) ) {
+        std::shared_ptr<Well> well;
+        try {
+            well = wellModel.well(wellEcl->name());
+        }
+        catch (const std::invalid_argument&) {
+            // not open or not on this process
+            continue;
+        }
+        auto& modelTimes = times[modelName(*well)];
+        for ( int copy = 0; copy < copies; ++copy ) {
+            timeWell(simulator, *well, wellState, dt, repetitions, modelTimes);
+        }
+    }
+
+    std::cout << std::left << std::setw(18) << "model" << std::right
+              << std::setw(8) << "wells"
+              << std::setw(14) << "assemble [s]"
+              << std::setw(14) << "apply [s]"
+              << std::setw(14) << "recover [s]"
+              << std::setw(16) << "potentials [s]" << std::endl;
+    for ( const auto& entry : times ) {
+        const auto& t = entry.second;
+        std::cout << std::left << std::setw(18) << entry.first << std::right
+                  << std::setw(8) << t.wells
+                  << std::setw(14) << t.assemble
+                  << std::setw(14) << t.apply
+                  << std::setw(14) << t.recover
+                  << std::setw(16) << t.potentials << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
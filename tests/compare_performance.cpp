@@ -0,0 +1,58 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// Compares the performance report of a run with a reference, e.g.
+///
+///     compare_performance reference.json test.json 0.1 0.25
+///
+/// The arguments after the reports are the relative budgets of the
+/// iterations and of the calibrated times. Prints the metrics and returns
+/// a failure if any of them exceeds its budget.
+
+#include <config.h>
+
+#include <opm/core/simulator/PerformanceComparison.hpp>
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+int main(int argc, char** argv)
+{
+    if (argc != 5) {
+        std::cerr << "Usage: " << argv[0] << " reference.json test.json iteration_budget time_budget" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::ifstream reference(argv[1]);
+    std::ifstream test(argv[2]);
+    if (!reference || !test) {
+        std::cerr << "Cannot open " << (reference ? argv[2] : argv[1]) << std::endl;
+        return EXIT_FAILURE;
+    }
+    try {
+        const Opm::PerformanceComparison comparison(reference, test, std::atof(argv[3]), std::atof(argv[4]));
+        comparison.report(std::cout);
+        return comparison.regressed() ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}
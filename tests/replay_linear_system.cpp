@@ -0,0 +1,154 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// Replays a linear system written by flow with --linear-system-dump-dir
+/// through ISTLSolverEbos. All linear solver parameters of flow can be
+/// used to try different configurations on the same system, e.g.
+///
+///     replay_linear_system --linear-system-file=linsys_step3_ts12_it1.bin --use-cpr=true
+///
+/// Only systems of the three phase black-oil model are supported.
+
+#include <config.h>
+
+#include <opm/autodiff/FlowMainEbos.hpp>
+#include <opm/autodiff/BlackoilModelEbos.hpp>
+#include <opm/autodiff/ISTLSolverEbos.hpp>
+#include <opm/autodiff/LinearSystemIO.hpp>
+#include <opm/autodiff/TimingRegistry.hpp>
+
+#if HAVE_DUNE_FEM
+#include <dune/fem/misc/mpimanager.hh>
+#else
+#include <dune/common/parallel/mpihelper.hh>
+#endif
+#include <dune/common/timer.hh>
+
+#include <fstream>
+#include <iostream>
+
+BEGIN_PROPERTIES
+NEW_PROP_TAG(LinearSystemFile);
+NEW_PROP_TAG(ReplayRepetitions);
+SET_STRING_PROP(EclFlowProblem, LinearSystemFile, "");
+SET_INT_PROP(EclFlowProblem, ReplayRepetitions, 1);
+END_PROPERTIES
+
+namespace
+{
+    typedef TTAG(EclFlowProblem) TypeTag;
+    typedef Opm::BlackoilModelEbos<TypeTag> Model;
+    typedef Model::Mat Matrix;
+    typedef Model::BVector Vector;
+    typedef Opm::BlackoilWellModel<TypeTag>::PackedWells PackedWells;
+
+    /// The part of the well model interface used by WellModelMatrixAdapter.
+    struct ReplayWellModel
+    {
+        void apply(const Vector& x, Vector& Ax) const
+        {
+            wells.apply(x, Ax);
+        }
+
+        void applyScaleAdd(const double alpha, const Vector& x, Vector& Ax) const
+        {
+            if ( wells.empty() ) {
+                return;
+            }
+            scaleAddRes.resize(Ax.size());
+            scaleAddRes = 0.0;
+            wells.apply(x, scaleAddRes);
+            Ax.axpy(alpha, scaleAddRes);
+        }
+
+        PackedWells wells;
+        mutable Vector scaleAddRes;
+    };
+}
+
+int main(int argc, char** argv)
+{
+#if HAVE_DUNE_FEM
+    Dune::Fem::MPIManager::initialize(argc, argv);
+#else
+    Dune::MPIHelper::instance(argc, argv);
+#endif
+
+    EWOMS_REGISTER_PARAM(TypeTag, std::string, LinearSystemFile,
+                         "The file with the linear system to replay");
+    EWOMS_REGISTER_PARAM(TypeTag, int, ReplayRepetitions,
+                         "The number of times the linear system is solved");
+    const int status = Opm::FlowMainEbos<TypeTag>::setupParameters_(argc, argv);
+    if ( status != 0 ) {
+        return status == -1 ? EXIT_SUCCESS : status;
+    }
+
+    const std::string fileName = EWOMS_GET_PARAM(TypeTag, std::string, LinearSystemFile);
+    std::ifstream is(fileName, std::ios::binary);
+    if ( !is ) {
+        std::cerr << "Could not open linear system file '" << fileName << "'" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    Matrix A;
+    Vector b;
+    ReplayWellModel wellModel;
+    try {
+        Opm::LinearSystemIO::readHeader(is, Model::numEq);
+        Opm::LinearSystemIO::readMatrix(is, A);
+        Opm::LinearSystemIO::readVector(is, b);
+        wellModel.wells.read(is);
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Failed to read " << fileName << ": " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "Read " << A.N() << " cells with " << A.nonzeroes() << " nonzero blocks from "
+              << fileName << std::endl;
+
+    typedef Model::WellModelMatrixAdapter<Matrix, Vector, Vector, ReplayWellModel, false> Operator;
+    Operator opA(A, A, wellModel);
+    Opm::ISTLSolverEbos<TypeTag> solver;
+
+    const int repetitions = EWOMS_GET_PARAM(TypeTag, int, ReplayRepetitions);
+    for ( int rep = 0; rep < repetitions; ++rep ) {
+        // the solver may modify the right hand side
+        Vector rhs(b);
+        Vector x(b.size());
+        x = 0.0;
+        Dune::Timer timer;
+        timer.start();
+        try {
+            solver.solve(opA, x, rhs);
+        }
+        catch (const std::exception& e) {
+            std::cout << "Solve " << rep << " failed after " << timer.stop() << " s: " << e.what() << std::endl;
+            continue;
+        }
+        std::cout << "Solve " << rep << ": " << solver.iterations() << " iterations in "
+                  << timer.stop() << " s" << std::endl;
+    }
+
+    if ( Opm::TimingRegistry::instance().enabled() ) {
+        Opm::TimingRegistry::instance().report(std::cout);
+    }
+
+    return EXIT_SUCCESS;
+}
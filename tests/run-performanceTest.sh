@@ -0,0 +1,35 @@
+#!/bin/bash
+
+# This runs a simulator with a performance report, then compares the
+# iterations and the calibrated times of the report against a reference.
+# A missing reference skips the test, as the times are per case and the
+# reference reports are added as the cases are calibrated.
+
+INPUT_DATA_PATH="$1"
+RESULT_PATH="$2"
+BINPATH="$3"
+FILENAME="$4"
+ITERATION_BUDGET="$5"
+TIME_BUDGET="$6"
+COMPARE_PERFORMANCE_COMMAND="$7"
+EXE_NAME="${8}"
+shift 8
+TEST_ARGS="$@"
+
+REFERENCE=${INPUT_DATA_PATH}/opm-performance-reference/${EXE_NAME}/${FILENAME}.json
+
+rm -Rf  ${RESULT_PATH}
+mkdir -p ${RESULT_PATH}
+cd ${RESULT_PATH}
+${BINPATH}/${EXE_NAME} ${TEST_ARGS} --output-dir=${RESULT_PATH} --performance-report-file=${RESULT_PATH}/${FILENAME}.json
+test $? -eq 0 || exit 1
+cd ..
+
+if [ ! -f ${REFERENCE} ]
+then
+  echo "No performance reference ${REFERENCE}"
+  exit 77
+fi
+
+echo "=== Executing comparison for performance report ==="
+${COMPARE_PERFORMANCE_COMMAND} ${REFERENCE} ${RESULT_PATH}/${FILENAME}.json ${ITERATION_BUDGET} ${TIME_BUDGET}
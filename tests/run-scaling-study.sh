@@ -0,0 +1,57 @@
+#!/bin/bash
+
+# This runs a deck at 1, 2, 4, ... processes and several threads per
+# process, and prints the scaling efficiency of the assembly, the wells,
+# the linear solve and the communication from the performance reports.
+#
+# Usage: run-scaling-study.sh BINPATH RESULT_PATH MAX_PROCESSES "THREADS" DECK [DECK ...]
+#
+# With one deck the study is of strong scaling. With several decks it is
+# of weak scaling, and the i-th deck is run at 2^i processes, hence the
+# decks should grow in size by a factor of two.
+# Extra arguments of the simulator are passed in FLOW_ARGS.
+
+BINPATH="$1"
+RESULT_PATH="$2"
+MAX_PROCESSES="$3"
+THREADS="$4"
+shift 4
+DECKS=("$@")
+
+if [ ${#DECKS[@]} -eq 0 ]
+then
+  echo "Usage: $0 BINPATH RESULT_PATH MAX_PROCESSES \"THREADS\" DECK [DECK ...]"
+  exit 1
+fi
+
+SCALING=strong
+test ${#DECKS[@]} -gt 1 && SCALING=weak
+
+mkdir -p ${RESULT_PATH}
+RUNS=""
+run=0
+for ((np = 1; np <= MAX_PROCESSES; np *= 2))
+do
+  if [ ${SCALING} = weak ]
+  then
+    test ${run} -lt ${#DECKS[@]} || break
+    DECK=${DECKS[$run]}
+  else
+    DECK=${DECKS[0]}
+  fi
+  for nt in ${THREADS}
+  do
+    OUTPUT_DIR=${RESULT_PATH}/np${np}_nt${nt}
+    mkdir -p ${OUTPUT_DIR}
+    echo "=== Running ${DECK} at ${np} processes and ${nt} threads ==="
+    OMP_NUM_THREADS=${nt} mpirun -np ${np} ${BINPATH}/flow ${DECK} ${FLOW_ARGS} \
+        --threads-per-process=${nt} --linear-solver-timing-report=true \
+        --performance-report-file=${OUTPUT_DIR}/performance.json --output-dir=${OUTPUT_DIR} \
+        > ${OUTPUT_DIR}/flow.log 2>&1
+    test $? -eq 0 || { echo "The run failed, see ${OUTPUT_DIR}/flow.log"; exit 1; }
+    RUNS="${RUNS} ${np} ${nt} ${OUTPUT_DIR}/performance.json"
+  done
+  run=$((run + 1))
+done
+
+${BINPATH}/scaling_report ${SCALING} ${RUNS} | tee ${RESULT_PATH}/scaling.txt
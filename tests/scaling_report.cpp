@@ -0,0 +1,62 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/// Prints the scaling efficiency of the stages of several runs, e.g.
+///
+///     scaling_report strong 1 1 run1.json 2 1 run2.json 4 1 run4.json
+///
+/// The first argument is strong or weak, followed by the processes, the
+/// threads per process and the performance report of each run. The runs
+/// are written by tests/run-scaling-study.sh.
+
+#include <config.h>
+
+#include <opm/core/simulator/ScalingStudy.hpp>
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+int main(int argc, char** argv)
+{
+    const std::string scaling = argc > 1 ? argv[1] : "";
+    if (argc < 5 || (argc - 2) % 3 != 0 || (scaling != "strong" && scaling != "weak")) {
+        std::cerr << "Usage: " << argv[0] << " strong|weak processes threads report.json [processes threads report.json ...]" << std::endl;
+        return EXIT_FAILURE;
+    }
+    try {
+        Opm::ScalingStudy study(scaling == "strong" ? Opm::ScalingStudy::Strong : Opm::ScalingStudy::Weak);
+        for (int arg = 2; arg < argc; arg += 3) {
+            std::ifstream report(argv[arg + 2]);
+            if (!report) {
+                std::cerr << "Cannot open " << argv[arg + 2] << std::endl;
+                return EXIT_FAILURE;
+            }
+            study.addRun(std::atoi(argv[arg]), std::atoi(argv[arg + 1]), report);
+        }
+        study.report(std::cout);
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,187 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media Project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE ActiveSubdomainTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/autodiff/ActiveSubdomain.hpp>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+
+#include "SparsityPatternTestHelpers.hpp"
+
+#include <vector>
+
+typedef Dune::FieldMatrix<double, 2, 2> Block;
+typedef Dune::BCRSMatrix<Block> Matrix;
+typedef Dune::BlockVector<Dune::FieldVector<double, 2> > Vector;
+
+// 1D tridiagonal matrix with entry values depending on the row and column.
+void setupMatrix(Matrix& A, int N)
+{
+    setupTridiagonalPattern(A, N);
+    for ( auto row = A.begin(); row != A.end(); ++row )
+    {
+        for ( auto col = row->begin(); col != row->end(); ++col )
+        {
+            *col = 10.0 * row.index() + col.index();
+        }
+    }
+}
+
+// Adds x[0] of all entries to the first entry of Ax, like a well perforating every cell.
+struct SumModel
+{
+    void apply(const Vector& x, Vector& Ax) const
+    {
+        double sum = 0.0;
+        for ( std::size_t i = 0; i < x.size(); ++i )
+        {
+            sum += x[i][0];
+        }
+        for ( std::size_t i = 0; i < Ax.size(); ++i )
+        {
+            Ax[i][0] += sum;
+        }
+    }
+};
+
+BOOST_AUTO_TEST_CASE(HaloAndSubmatrix)
+{
+    const int N = 10;
+    Matrix A;
+    setupMatrix(A, N);
+
+    std::vector<char> seeds(N, 0);
+    seeds[2] = 1;
+    seeds[7] = 1;
+
+    Opm::ActiveSubdomain<Matrix> subdomain;
+    subdomain.setup(A, seeds, 0);
+    BOOST_CHECK_EQUAL(subdomain.size(), 2);
+    BOOST_CHECK_EQUAL(subdomain.matrix().nonzeroes(), 2);
+
+    subdomain.setup(A, seeds, 1);
+    const std::vector<std::size_t> expected = { 1, 2, 3, 6, 7, 8 };
+    BOOST_CHECK_EQUAL_COLLECTIONS(subdomain.cells().begin(), subdomain.cells().end(),
+                                  expected.begin(), expected.end());
+    BOOST_CHECK(subdomain.active(3));
+    BOOST_CHECK(!subdomain.active(4));
+
+    // rows 3 and 6 are not coupled, the submatrix consists of two tridiagonal blocks
+    const Matrix& S = subdomain.matrix();
+    BOOST_CHECK_EQUAL(S.N(), 6);
+    BOOST_CHECK_EQUAL(S.nonzeroes(), 14);
+    BOOST_CHECK(!S.exists(2, 3));
+    for ( auto row = S.begin(); row != S.end(); ++row )
+    {
+        for ( auto col = row->begin(); col != row->end(); ++col )
+        {
+            const auto i = expected[row.index()];
+            const auto j = expected[col.index()];
+            BOOST_CHECK_EQUAL((*col)[0][0], A[i][j][0][0]);
+        }
+    }
+
+    // two layers around the cells 2 and 7 cover all cells
+    subdomain.setup(A, seeds, 2);
+    BOOST_CHECK_EQUAL(subdomain.size(), 10);
+}
+
+BOOST_AUTO_TEST_CASE(RestrictAndProlongate)
+{
+    const int N = 6;
+    Matrix A;
+    setupMatrix(A, N);
+    std::vector<char> seeds(N, 0);
+    seeds[4] = 1;
+
+    Opm::ActiveSubdomain<Matrix> subdomain;
+    subdomain.setup(A, seeds, 1);
+
+    Vector full(N);
+    for ( int i = 0; i < N; ++i )
+    {
+        full[i] = i + 1.0;
+    }
+    Vector sub;
+    subdomain.restrict(full, sub);
+    BOOST_CHECK_EQUAL(sub.size(), 3);
+    BOOST_CHECK_EQUAL(sub[0][1], 4.0);
+
+    Vector back;
+    subdomain.prolongate(sub, back);
+    BOOST_CHECK_EQUAL(back.size(), N);
+    for ( int i = 0; i < N; ++i )
+    {
+        BOOST_CHECK_EQUAL(back[i][0], (i >= 3 && i <= 5) ? i + 1.0 : 0.0);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(OperatorMatchesRestrictedProduct)
+{
+    const int N = 8;
+    Matrix A;
+    setupMatrix(A, N);
+    std::vector<char> seeds(N, 0);
+    seeds[1] = 1;
+    seeds[5] = 1;
+
+    Opm::ActiveSubdomain<Matrix> subdomain;
+    subdomain.setup(A, seeds, 1);
+    SumModel wells;
+    Opm::ActiveSubdomainOperator<Matrix, Vector, SumModel> op(subdomain, &wells);
+
+    Vector x(subdomain.size());
+    for ( std::size_t i = 0; i < x.size(); ++i )
+    {
+        x[i][0] = 1.0 + i;
+        x[i][1] = -0.5 * i;
+    }
+
+    // reference: full product of the prolongated vector, restricted to the active cells
+    Vector xFull, yFull(N), yRef;
+    subdomain.prolongate(x, xFull);
+    A.mv(xFull, yFull);
+    wells.apply(xFull, yFull);
+    subdomain.restrict(yFull, yRef);
+
+    Vector y(x.size());
+    op.apply(x, y);
+    for ( std::size_t i = 0; i < y.size(); ++i )
+    {
+        BOOST_CHECK_CLOSE(y[i][0], yRef[i][0], 1e-12);
+        BOOST_CHECK_CLOSE(y[i][1], yRef[i][1], 1e-12);
+    }
+
+    // applyscaleadd, called twice to check that the work vectors are reset
+    Vector z(x.size());
+    z = 1.0;
+    op.applyscaleadd(2.0, x, z);
+    op.applyscaleadd(2.0, x, z);
+    for ( std::size_t i = 0; i < z.size(); ++i )
+    {
+        BOOST_CHECK_CLOSE(z[i][0], 1.0 + 4.0 * yRef[i][0], 1e-12);
+    }
+}
@@ -0,0 +1,171 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media Project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE AdaptiveImplicitTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/autodiff/AdaptiveImplicit.hpp>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+
+#include "SparsityPatternTestHelpers.hpp"
+
+#include <vector>
+
+typedef Dune::FieldMatrix<double, 2, 2> Block;
+typedef Dune::BCRSMatrix<Block> Matrix;
+typedef Dune::BlockVector<Dune::FieldVector<double, 2> > Vector;
+typedef Opm::AdaptiveImplicitReduction<Matrix, Vector> Reduction;
+
+const int numCells = 3;
+const int pressureIndex = 0;
+
+// A chain of three cells. The equations of the neighbours only depend on
+// the pressure of a cell unless transportCoupling is set.
+Matrix chainMatrix(double transportCoupling)
+{
+    Matrix A;
+    setupTridiagonalPattern(A, numCells);
+    for ( int i = 0; i < numCells; ++i )
+    {
+        A[i][i][0][0] = 4.0 + i;
+        A[i][i][0][1] = 1.0;
+        A[i][i][1][0] = 0.5;
+        A[i][i][1][1] = 3.0 - 0.5 * i;
+        for ( int j : { i - 1, i + 1 } )
+        {
+            if ( j < 0 || j >= numCells ) continue;
+            A[i][j] = 0.0;
+            A[i][j][0][0] = -1.0;
+            A[i][j][1][0] = -0.25 * (i + 1);
+            A[i][j][1][1] = -transportCoupling;
+        }
+    }
+    return A;
+}
+
+// Solve A x = b densely.
+Vector solveDense(const Matrix& A, const Vector& b)
+{
+    Dune::FieldMatrix<double, 2 * numCells, 2 * numCells> dense(0.0);
+    Dune::FieldVector<double, 2 * numCells> rhs, sol;
+    for ( auto row = A.begin(); row != A.end(); ++row )
+    {
+        for ( auto col = row->begin(); col != row->end(); ++col )
+        {
+            for ( int k = 0; k < 2; ++k )
+                for ( int l = 0; l < 2; ++l )
+                    dense[2 * row.index() + k][2 * col.index() + l] = (*col)[k][l];
+        }
+        for ( int k = 0; k < 2; ++k )
+            rhs[2 * row.index() + k] = b[row.index()][k];
+    }
+    dense.solve(sol, rhs);
+    Vector x(numCells);
+    for ( int i = 0; i < numCells; ++i )
+        for ( int k = 0; k < 2; ++k )
+            x[i][k] = sol[2 * i + k];
+    return x;
+}
+
+Vector residual()
+{
+    Vector r(numCells);
+    for ( int i = 0; i < numCells; ++i )
+    {
+        r[i][0] = 1.0 + i;
+        r[i][1] = 0.5 * i - 1.25;
+    }
+    return r;
+}
+
+BOOST_AUTO_TEST_CASE(ExactWithoutTransportCoupling)
+{
+    // the lagged columns are zero, hence the reduced system gives the exact update
+    const Matrix A = chainMatrix(0.0);
+    const Vector r = residual();
+    const Vector reference = solveDense(A, r);
+
+    Matrix reduced(A);
+    Vector reducedRhs(r);
+    Reduction reduction;
+    const std::vector<char> impes = { 1, 0, 1 };
+    BOOST_CHECK_EQUAL(reduction.reduce(reduced, reducedRhs, impes, pressureIndex), 2u);
+
+    // the IMPES cells only have a pressure unknown
+    BOOST_CHECK_EQUAL(reduced[0][0][1][1], 1.0);
+    BOOST_CHECK_EQUAL(reduced[0][0][0][1], 0.0);
+    BOOST_CHECK_EQUAL(reduced[0][1][1][0], 0.0);
+    BOOST_CHECK_EQUAL(reducedRhs[2][1], 0.0);
+
+    Vector x = solveDense(reduced, reducedRhs);
+    reduction.recover(x);
+    for ( int i = 0; i < numCells; ++i )
+    {
+        BOOST_CHECK_CLOSE(x[i][0], reference[i][0], 1e-10);
+        BOOST_CHECK_CLOSE(x[i][1], reference[i][1], 1e-10);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(LaggedTransportColumns)
+{
+    Matrix A = chainMatrix(0.5);
+    Vector r = residual();
+    Reduction reduction;
+    const std::vector<char> impes = { 0, 1, 0 };
+    reduction.reduce(A, r, impes, pressureIndex);
+    // the transport unknowns of the IMPES cell are dropped from the neighbours' equations
+    BOOST_CHECK_EQUAL(A[0][1][1][1], 0.0);
+    BOOST_CHECK_EQUAL(A[2][1][1][1], 0.0);
+    BOOST_CHECK_EQUAL(A[0][1][1][0], -0.25);
+    // but not those of the implicit cells
+    BOOST_CHECK_EQUAL(A[0][0][1][1], 3.0);
+    // the equations of the IMPES cell are combined into its pressure equation
+    BOOST_CHECK_EQUAL(A[1][0][1][0], 0.0);
+    BOOST_CHECK_EQUAL(A[1][0][1][1], 0.0);
+    BOOST_CHECK_EQUAL(A[1][1][1][1], 1.0);
+    BOOST_CHECK_EQUAL(A[1][1][0][0], 1.0);
+}
+
+BOOST_AUTO_TEST_CASE(ThroughputCfl)
+{
+    // two cells, accumulation a and outflow f for the second unknown of cell 0
+    Matrix A(2, 2, 4, Matrix::row_wise);
+    for ( auto row = A.createbegin(); row != A.createend(); ++row )
+    {
+        row.insert(0);
+        row.insert(1);
+    }
+    A = 0.0;
+    const double a = 2.0;
+    const double f = 0.5;
+    A[0][0][0][0] = 1.0;
+    A[1][1][0][0] = 1.0;
+    A[0][0][1][1] = a + f;
+    A[1][0][1][1] = -f;
+    A[1][1][1][1] = a;
+    const std::vector<double> cfl = Reduction::throughputCfl(A, pressureIndex);
+    BOOST_CHECK_CLOSE(cfl[0], f / a, 1e-12);
+    BOOST_CHECK_EQUAL(cfl[1], 0.0);
+}
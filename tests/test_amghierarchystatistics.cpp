@@ -0,0 +1,59 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media Project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE AmgHierarchyStatisticsTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/autodiff/AmgHierarchyStatistics.hpp>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+BOOST_AUTO_TEST_CASE(CoarsestAggregates)
+{
+    Opm::AmgHierarchyStatistics statistics;
+    statistics.levels = 4;
+    statistics.rows = { 100, 100 };
+    statistics.nonzeroes = { 500, 300 };
+    // three aggregates of 3, 1 and 2 rows, and an isolated row
+    statistics.setCoarsestAggregates({ 0, 0, 2, 1, 99, 0, 2 });
+    BOOST_CHECK_EQUAL(statistics.coarsestRows, 3);
+    BOOST_CHECK_EQUAL(statistics.aggregatedRows, 6);
+    BOOST_CHECK_EQUAL(statistics.minAggregateSize, 1);
+    BOOST_CHECK_EQUAL(statistics.maxAggregateSize, 3);
+    BOOST_CHECK_CLOSE(statistics.operatorComplexity(), 1.6, 1e-12);
+
+    std::ostringstream os;
+    statistics.report(os);
+    BOOST_CHECK(os.str().find("4 levels") != std::string::npos);
+    BOOST_CHECK(os.str().find("aggregates of 1 to 3 (mean 2.0) rows") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(WithoutCoarsening)
+{
+    // the pressure extraction keeps a row per fine row
+    Opm::AmgHierarchyStatistics statistics;
+    statistics.setCoarsestAggregates({ 0, 1, 2 });
+    BOOST_CHECK_EQUAL(statistics.coarsestRows, 3);
+    BOOST_CHECK_EQUAL(statistics.maxAggregateSize, 1);
+    BOOST_CHECK_EQUAL(statistics.operatorComplexity(), 0.0);
+}
@@ -0,0 +1,177 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media Project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE AmgSmoothersTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/autodiff/AmgSmoothers.hpp>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/operators.hh>
+#include <dune/istl/scalarproducts.hh>
+#include <dune/istl/solvers.hh>
+#include <dune/istl/paamg/pinfo.hh>
+
+#include "SparsityPatternTestHelpers.hpp"
+
+typedef Dune::FieldMatrix<double, 1, 1> Block;
+typedef Dune::BCRSMatrix<Block> Matrix;
+typedef Dune::BlockVector<Dune::FieldVector<double, 1> > Vector;
+typedef Dune::Amg::SequentialInformation Communication;
+
+// 2D Laplacian on a N x N grid
+void setupLaplacian(Matrix& A, int N)
+{
+    setupFivePointPattern(A, N);
+    for ( auto row = A.begin(); row != A.end(); ++row )
+    {
+        for ( auto col = row->begin(); col != row->end(); ++col )
+        {
+            *col = (col.index() == row.index()) ? 4.0 : -1.0;
+        }
+    }
+}
+
+// Residual norm after one application of the smoother, relative to the right hand side.
+template<class Smoother>
+double relativeResidual(const Matrix& A, Smoother& smoother, const Vector& d)
+{
+    Vector v(d.size()), r(d);
+    v = 0.0;
+    smoother.apply(v, d);
+    A.mmv(v, r);
+    return r.two_norm() / d.two_norm();
+}
+
+template<class Smoother>
+int cgIterations(const Matrix& A, Smoother& smoother, const Vector& b)
+{
+    Dune::MatrixAdapter<Matrix, Vector, Vector> op(A);
+    Dune::SeqScalarProduct<Vector> sp;
+    Dune::CGSolver<Vector> solver(op, sp, smoother, 1e-8, 500, 0);
+    Vector x(b.size()), rhs(b);
+    x = 0.0;
+    Dune::InverseOperatorResult res;
+    solver.apply(x, rhs, res);
+    BOOST_CHECK( res.converged );
+    return res.iterations;
+}
+
+BOOST_AUTO_TEST_CASE(BlockJacobiWithOneBlockIsILU0)
+{
+    Matrix A;
+    setupLaplacian(A, 12);
+    Communication comm;
+    Vector d(A.N());
+    for ( std::size_t i = 0; i < d.size(); ++i )
+    {
+        d[i] = 1.0 + (i % 5);
+    }
+
+    Opm::BlockJacobiILU0<Matrix, Vector, Vector, Communication> bj(A, comm, 1.0, Opm::MILU_VARIANT::ILU, 1);
+    Opm::ParallelOverlappingILU0<Matrix, Vector, Vector, Communication> ilu(A, comm, 0, 1.0, Opm::MILU_VARIANT::ILU);
+
+    Vector v1(A.N()), v2(A.N());
+    v1 = 0.0;
+    v2 = 0.0;
+    bj.apply(v1, d);
+    ilu.apply(v2, d);
+    for ( std::size_t i = 0; i < v1.size(); ++i )
+    {
+        BOOST_CHECK_CLOSE(v1[i][0], v2[i][0], 1e-10);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(BlockJacobiSmoothes)
+{
+    Matrix A;
+    setupLaplacian(A, 20);
+    Communication comm;
+    Vector d(A.N());
+    d = 1.0;
+
+    Opm::BlockJacobiILU0<Matrix, Vector, Vector, Communication> bj(A, comm, 1.0, Opm::MILU_VARIANT::ILU, 4);
+    BOOST_CHECK( relativeResidual(A, bj, d) < 1.0 );
+    cgIterations(A, bj, d);
+
+    // changed entries with the same sparsity pattern
+    for ( auto row = A.begin(); row != A.end(); ++row )
+    {
+        (*row)[row.index()] = 5.0;
+    }
+    bj.update();
+    BOOST_CHECK( relativeResidual(A, bj, d) < 1.0 );
+}
+
+BOOST_AUTO_TEST_CASE(ChebyshevSmoothes)
+{
+    Matrix A;
+    setupLaplacian(A, 20);
+    Communication comm;
+    Vector d(A.N());
+    d = 1.0;
+
+    Opm::ChebyshevSmoother<Matrix, Vector, Vector, Communication> cheby1(A, comm, 1);
+    Opm::ChebyshevSmoother<Matrix, Vector, Vector, Communication> cheby4(A, comm, 4);
+    const double residual1 = relativeResidual(A, cheby1, d);
+    const double residual4 = relativeResidual(A, cheby4, d);
+    BOOST_CHECK( residual1 < 1.0 );
+    BOOST_CHECK( residual4 < residual1 );
+
+    // A higher degree is a better preconditioner.
+    BOOST_CHECK( cgIterations(A, cheby4, d) < cgIterations(A, cheby1, d) );
+}
+
+BOOST_AUTO_TEST_CASE(SelectSmoother)
+{
+    BOOST_CHECK( Opm::convertString2AmgSmoother("") == Opm::AMG_SMOOTHER::ILU0 );
+    BOOST_CHECK( Opm::convertString2AmgSmoother("BlockJacobiILU0") == Opm::AMG_SMOOTHER::BLOCK_JACOBI_ILU0 );
+    BOOST_CHECK( Opm::convertString2AmgSmoother("Chebyshev") == Opm::AMG_SMOOTHER::CHEBYSHEV );
+    BOOST_CHECK_THROW( Opm::convertString2AmgSmoother("SOR"), std::invalid_argument );
+
+    Matrix A;
+    setupLaplacian(A, 10);
+    Communication comm;
+    Vector d(A.N());
+    d = 1.0;
+
+    typedef Opm::AmgLevelSmoother<Matrix, Vector, Vector, Communication> Smoother;
+    typedef Dune::Amg::SmootherTraits<Smoother>::Arguments Args;
+    for ( auto type : { Opm::AMG_SMOOTHER::ILU0, Opm::AMG_SMOOTHER::BLOCK_JACOBI_ILU0,
+                        Opm::AMG_SMOOTHER::CHEBYSHEV } )
+    {
+        Args args;
+        args.relaxationFactor = 1.0;
+        args.setSmoother(type);
+        Dune::Amg::ConstructionTraits<Smoother>::Arguments cargs;
+        cargs.setMatrix(A);
+        cargs.setComm(comm);
+        cargs.setArgs(args);
+        std::unique_ptr<Smoother> smoother(Dune::Amg::ConstructionTraits<Smoother>::construct(cargs));
+        BOOST_CHECK_EQUAL( smoother->needsMatrix(), type == Opm::AMG_SMOOTHER::CHEBYSHEV );
+        BOOST_CHECK( relativeResidual(A, *smoother, d) < 1.0 );
+        smoother->update();
+        BOOST_CHECK( relativeResidual(A, *smoother, d) < 1.0 );
+    }
+}
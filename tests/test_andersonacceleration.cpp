@@ -0,0 +1,108 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media Project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE AndersonAccelerationTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/autodiff/AndersonAcceleration.hpp>
+
+#include <dune/common/fvector.hh>
+#include <dune/istl/bvector.hh>
+
+#include <cstddef>
+#include <vector>
+
+typedef Dune::BlockVector<Dune::FieldVector<double, 1> > Vector;
+
+// The communication of a single process.
+struct SequentialComm
+{
+    template<class T>
+    void sum(T*, std::size_t) const
+    {}
+};
+
+// F(x) = A x - 1 with A = tridiag(-1.9, 2, -1.9).
+Vector residual(const Vector& x)
+{
+    const std::size_t n = x.size();
+    Vector F(n);
+    for ( std::size_t i = 0; i < n; ++i )
+    {
+        double Ax = 2.0 * x[i];
+        if ( i > 0 ) Ax -= 1.9 * x[i - 1];
+        if ( i + 1 < n ) Ax -= 1.9 * x[i + 1];
+        F[i] = Ax - 1.0;
+    }
+    return F;
+}
+
+// The residual after a number of iterations with the diagonal of A as
+// approximate Jacobian (Jacobi), which diverges without acceleration.
+double residualAfterIterations(const int iterations, const bool mix)
+{
+    const std::size_t n = 10;
+    Opm::AndersonAcceleration<Vector> anderson(5);
+    std::vector<unsigned> cells;
+    for ( std::size_t i = 0; i < n; ++i )
+    {
+        cells.push_back(i);
+    }
+    Vector x(n);
+    x = 0.0;
+    for ( int it = 0; it < iterations; ++it )
+    {
+        Vector dx = residual(x);
+        dx *= 0.5;
+        anderson.apply(dx, cells, SequentialComm(), mix);
+        x -= dx;
+    }
+    return residual(x).two_norm();
+}
+
+BOOST_AUTO_TEST_CASE(ConvergesWhereJacobiDiverges)
+{
+    BOOST_CHECK(residualAfterIterations(30, false) > 1.0);
+    BOOST_CHECK(residualAfterIterations(30, true) < 1e-10);
+}
+
+BOOST_AUTO_TEST_CASE(HistoryAndReset)
+{
+    Opm::AndersonAcceleration<Vector> anderson(2);
+    std::vector<unsigned> cells = { 0, 1, 2 };
+    Vector dx(3);
+    for ( int it = 0; it < 4; ++it )
+    {
+        dx = 1.0 + it;
+        Vector expected(dx);
+        // without mixing the updates are only recorded
+        anderson.apply(dx, cells, SequentialComm(), false);
+        BOOST_CHECK_EQUAL(dx[1], expected[1]);
+    }
+    BOOST_CHECK_EQUAL(anderson.historySize(), 2u);
+    anderson.reset();
+    BOOST_CHECK_EQUAL(anderson.historySize(), 0u);
+
+    // the first update of a time step can not be combined with others
+    dx = 3.0;
+    anderson.apply(dx, cells, SequentialComm(), true);
+    BOOST_CHECK_EQUAL(dx[0], 3.0);
+}
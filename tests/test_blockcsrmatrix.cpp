@@ -0,0 +1,120 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media Project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE BlockCSRMatrixTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/autodiff/BlockCSRMatrix.hpp>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+
+#include "SparsityPatternTestHelpers.hpp"
+
+typedef Dune::FieldMatrix<double, 3, 3> Block;
+typedef Dune::BCRSMatrix<Block> Matrix;
+typedef Dune::BlockVector<Dune::FieldVector<double, 3> > Vector;
+
+// 2D five point stencil with distinct entries in each block.
+void setupMatrix(Matrix& A, int N)
+{
+    setupFivePointPattern(A, N);
+    for ( auto row = A.begin(); row != A.end(); ++row )
+    {
+        for ( auto col = row->begin(); col != row->end(); ++col )
+        {
+            for ( int k = 0; k < 3; ++k )
+                for ( int l = 0; l < 3; ++l )
+                    (*col)[k][l] = (row.index() == col.index() && k == l ? 6.0 : -0.5)
+                        + 0.01 * (col.index() + 3 * k + l);
+        }
+    }
+}
+
+void checkClose(const Vector& x, const Vector& y)
+{
+    BOOST_REQUIRE_EQUAL(x.size(), y.size());
+    for ( std::size_t i = 0; i < x.size(); ++i )
+        for ( int k = 0; k < 3; ++k )
+            BOOST_CHECK_CLOSE(x[i][k], y[i][k], 1e-12);
+}
+
+BOOST_AUTO_TEST_CASE(ProductsMatchBCRSMatrix)
+{
+    Matrix A;
+    setupMatrix(A, 6);
+    Opm::BlockCSRMatrix<Block> compressed(A);
+    BOOST_CHECK_EQUAL(compressed.N(), A.N());
+    BOOST_CHECK_EQUAL(compressed.M(), A.M());
+    BOOST_CHECK_EQUAL(compressed.nonzeroes(), A.nonzeroes());
+
+    Vector x(A.M()), y(A.N()), yExpected(A.N());
+    for ( std::size_t i = 0; i < x.size(); ++i )
+    {
+        x[i][0] = 1.0 + i;
+        x[i][1] = -0.5 * i;
+        x[i][2] = 0.25;
+    }
+    A.mv(x, yExpected);
+    compressed.mv(x, y);
+    checkClose(y, yExpected);
+
+    y = 1.0;
+    yExpected = 1.0;
+    A.usmv(-2.0, x, yExpected);
+    compressed.usmv(-2.0, x, y);
+    checkClose(y, yExpected);
+
+    A.umv(x, yExpected);
+    compressed.umv(x, y);
+    checkClose(y, yExpected);
+}
+
+BOOST_AUTO_TEST_CASE(UpdateValues)
+{
+    Matrix A;
+    setupMatrix(A, 4);
+    Opm::BlockCSRMatrix<Block> compressed(A);
+
+    A[5][6][1][2] = 3.0;
+    A[0][0] *= 2.0;
+    compressed.updateValues(A);
+
+    Vector x(A.M()), y(A.N()), yExpected(A.N());
+    x = 1.0;
+    A.mv(x, yExpected);
+    compressed.mv(x, y);
+    checkClose(y, yExpected);
+
+    // a different pattern triggers a new setup
+    Matrix B;
+    setupMatrix(B, 5);
+    compressed.updateValues(B);
+    BOOST_CHECK_EQUAL(compressed.N(), B.N());
+    BOOST_CHECK_EQUAL(compressed.nonzeroes(), B.nonzeroes());
+    Vector xB(B.M()), yB(B.N()), yBExpected(B.N());
+    xB = 0.5;
+    B.mv(xB, yBExpected);
+    compressed.mv(xB, yB);
+    checkClose(yB, yBExpected);
+}
@@ -0,0 +1,74 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media Project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE CartesianCellIndexMapTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/autodiff/CartesianCellIndexMap.hpp>
+
+#include <stdexcept>
+#include <vector>
+
+BOOST_AUTO_TEST_CASE(OrderedCells)
+{
+    // every third cell of a grid spanning several blocks of the bitmap
+    const int numCartesian = 2000;
+    std::vector<int> globalCell;
+    for (int c = 0; c < numCartesian; c += 3) {
+        globalCell.push_back(c);
+    }
+    const Opm::CartesianCellIndexMap map(numCartesian, globalCell.size(), globalCell.data());
+
+    BOOST_CHECK_EQUAL(map.numCartesianCells(), numCartesian);
+    for (int c = 0; c < numCartesian; ++c) {
+        const int expected = c % 3 == 0 ? c / 3 : -1;
+        BOOST_CHECK_EQUAL(map.compressed(c), expected);
+        BOOST_CHECK_EQUAL(map[c], expected);
+        BOOST_CHECK_EQUAL(map.active(c), expected >= 0);
+    }
+    BOOST_CHECK_EQUAL(map.compressed(-1), -1);
+    BOOST_CHECK_EQUAL(map.compressed(numCartesian), -1);
+    BOOST_CHECK_EQUAL(map.at(999), 333);
+    BOOST_CHECK_THROW(map.at(1000), std::out_of_range);
+}
+
+BOOST_AUTO_TEST_CASE(UnorderedCells)
+{
+    const std::vector<int> globalCell = {700, 5, 64, 63, 1200, 0};
+    const Opm::CartesianCellIndexMap map(1300, globalCell.size(), globalCell.data());
+
+    for (std::size_t cell = 0; cell < globalCell.size(); ++cell) {
+        BOOST_CHECK_EQUAL(map.compressed(globalCell[cell]), static_cast<int>(cell));
+    }
+    BOOST_CHECK_EQUAL(map.compressed(1), -1);
+    BOOST_CHECK_EQUAL(map.compressed(1299), -1);
+}
+
+BOOST_AUTO_TEST_CASE(AllCellsActive)
+{
+    const Opm::CartesianCellIndexMap map(600, 600, nullptr);
+    for (int c = 0; c < 600; ++c) {
+        BOOST_CHECK_EQUAL(map.at(c), c);
+    }
+
+    const std::vector<int> outside = {3, 600};
+    BOOST_CHECK_THROW(Opm::CartesianCellIndexMap(600, outside.size(), outside.data()), std::logic_error);
+}
@@ -0,0 +1,83 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media Project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE CondensedWellSystemTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/autodiff/CondensedWellSystem.hpp>
+
+#include <dune/common/dynmatrix.hh>
+
+#include <cmath>
+
+typedef Dune::DynamicMatrix<double> Matrix;
+
+// A well matrix like the one of polymer injectivity: four core variables and
+// the water velocity and skin pressure of each perforation.
+Matrix createMatrix(const int numCore, const int numPerf)
+{
+    const int n = numCore + 2 * numPerf;
+    Matrix D(n, n, 0.0);
+    for (int r = 0; r < n; ++r) {
+        for (int c = 0; c < n; ++c) {
+            const bool perfRow = r >= numCore;
+            const bool perfCol = c >= numCore;
+            if (perfRow && perfCol && (r - numCore) % numPerf != (c - numCore) % numPerf) {
+                continue;
+            }
+            D[r][c] = std::sin(1.0 + r + 3.0 * c) + (r == c ? 5.0 : 0.0);
+        }
+    }
+    return D;
+}
+
+BOOST_AUTO_TEST_CASE(MatchesDenseInverse)
+{
+    const int numCore = 4;
+    const int numPerf = 7;
+    Matrix condensed = createMatrix(numCore, numPerf);
+    Matrix dense = condensed;
+
+    BOOST_CHECK(Opm::wellhelpers::invertCondensed(condensed, numCore, numPerf, 2));
+    dense.invert();
+
+    for (std::size_t r = 0; r < dense.N(); ++r) {
+        for (std::size_t c = 0; c < dense.M(); ++c) {
+            BOOST_CHECK_SMALL(condensed[r][c] - dense[r][c], 1e-12);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(CoupledPerforationsAreRejected)
+{
+    const int numCore = 4;
+    const int numPerf = 3;
+    Matrix D = createMatrix(numCore, numPerf);
+    D[numCore][numCore + 1] = 1.0;
+    const Matrix original = D;
+
+    BOOST_CHECK(!Opm::wellhelpers::invertCondensed(D, numCore, numPerf, 2));
+    for (std::size_t r = 0; r < D.N(); ++r) {
+        for (std::size_t c = 0; c < D.M(); ++c) {
+            BOOST_CHECK_EQUAL(D[r][c], original[r][c]);
+        }
+    }
+}
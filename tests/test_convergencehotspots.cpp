@@ -0,0 +1,87 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media Project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE ConvergenceHotSpotsTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/autodiff/ConvergenceHotSpots.hpp>
+
+#include <sstream>
+
+typedef Opm::ConvergenceHotSpots::Cell Cell;
+
+BOOST_AUTO_TEST_CASE(KeepLargest)
+{
+    std::vector<Cell> cells = { { 0, 1, 0, 0.5 }, { 1, 1, 1, 3.0 }, { 2, 1, 0, 1.0 }, { 3, 2, 2, 2.0 } };
+    Opm::ConvergenceHotSpots::keepLargest(cells, 2);
+    BOOST_REQUIRE_EQUAL(cells.size(), 2u);
+    BOOST_CHECK_EQUAL(cells[0].cartesian_index, 1);
+    BOOST_CHECK_EQUAL(cells[1].cartesian_index, 3);
+}
+
+BOOST_AUTO_TEST_CASE(SummaryOrderedByIterations)
+{
+    Opm::ConvergenceHotSpots hotSpots(2, { "Water", "Oil", "Gas" }, {{ 10, 5, 3 }});
+    // cell 27 is (8, 3, 1), cell 111 is (2, 2, 3)
+    hotSpots.addIteration({ { 27, 1, 0, 0.5 }, { 111, 2, 2, 4.0 } }, { "PROD1", "PROD1" });
+    hotSpots.addIteration({ { 111, 2, 1, 2.0 }, { 5, 1, 0, 1.0 } }, { "INJ" });
+    hotSpots.addIteration({ { 111, 2, 1, 1.5 } }, { "INJ" });
+
+    const auto index = hotSpots.ijk(111);
+    BOOST_CHECK_EQUAL(index[0], 2);
+    BOOST_CHECK_EQUAL(index[1], 2);
+    BOOST_CHECK_EQUAL(index[2], 3);
+
+    std::istringstream summary(hotSpots.summary());
+    std::string line;
+    std::getline(summary, line);
+    BOOST_CHECK(line.find("3 Newton iterations") != std::string::npos);
+    std::getline(summary, line); // header
+
+    // the cell found in the most iterations first, with its largest residual
+    int i, j, k, region, iterations;
+    std::string component;
+    double cnv;
+    summary >> i >> j >> k >> region >> iterations >> component >> cnv;
+    BOOST_CHECK_EQUAL(i, 2);
+    BOOST_CHECK_EQUAL(k, 3);
+    BOOST_CHECK_EQUAL(region, 2);
+    BOOST_CHECK_EQUAL(iterations, 3);
+    BOOST_CHECK_EQUAL(component, "Gas");
+    BOOST_CHECK_CLOSE(cnv, 4.0, 1e-10);
+
+    // of the cells found once, the one with the larger residual
+    summary >> i >> j >> k >> region >> iterations >> component >> cnv;
+    BOOST_CHECK_EQUAL(i, 5 + 1);
+    BOOST_CHECK_EQUAL(iterations, 1);
+    BOOST_CHECK_CLOSE(cnv, 1.0, 1e-10);
+
+    // a well counts once per iteration
+    std::getline(summary, line);
+    std::getline(summary, line); // header
+    std::string well;
+    summary >> well >> iterations;
+    BOOST_CHECK_EQUAL(well, "INJ");
+    BOOST_CHECK_EQUAL(iterations, 2);
+    summary >> well >> iterations;
+    BOOST_CHECK_EQUAL(well, "PROD1");
+    BOOST_CHECK_EQUAL(iterations, 1);
+}
@@ -98,3 +98,44 @@ BOOST_AUTO_TEST_CASE(deferredlogger)
     BOOST_CHECK_EQUAL(log_stream.str(), expected);
 
 }
+
+BOOST_AUTO_TEST_CASE(deferredloggerClear)
+{
+    std::ostringstream log_stream;
+    initLogger(log_stream);
+    auto deferredlogger = Opm::DeferredLogger();
+    deferredlogger.info("info 1");
+    deferredlogger.logMessages();
+    deferredlogger.clearMessages();
+    deferredlogger.warning("warning 1");
+    deferredlogger.logMessages();
+
+    auto counter = OpmLog::getBackend<CounterLog>("COUNTER");
+    BOOST_CHECK_EQUAL( 1 , counter->numMessages(Log::MessageType::Info) );
+    BOOST_CHECK_EQUAL( 1 , counter->numMessages(Log::MessageType::Warning) );
+}
+
+BOOST_AUTO_TEST_CASE(deferredloggerReuse)
+{
+    const std::string expected = Log::prefixMessage(Log::MessageType::Info, "a longer info message") + "\n"
+        + Log::prefixMessage(Log::MessageType::Debug, "debug") + "\n"
+        + Log::prefixMessage(Log::MessageType::Note, "note") + "\n";
+
+    std::ostringstream log_stream;
+    initLogger(log_stream);
+    auto deferredlogger = Opm::DeferredLogger();
+    deferredlogger.warning("tag", "warning 1");
+    deferredlogger.warning("warning 2");
+    deferredlogger.clearMessages();
+
+    // the cleared messages are overwritten and not logged
+    deferredlogger.info("a longer info message");
+    deferredlogger.debug("debug");
+    deferredlogger.note("note");
+    deferredlogger.logMessages();
+
+    auto counter = OpmLog::getBackend<CounterLog>("COUNTER");
+    BOOST_CHECK_EQUAL( 0 , counter->numMessages(Log::MessageType::Warning) );
+    BOOST_CHECK_EQUAL( 1 , counter->numMessages(Log::MessageType::Info) );
+    BOOST_CHECK_EQUAL(log_stream.str(), expected);
+}
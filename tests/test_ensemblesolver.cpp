@@ -0,0 +1,149 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media Project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE EnsembleSolverTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/autodiff/EnsembleSolver.hpp>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+
+#include "SparsityPatternTestHelpers.hpp"
+
+#include <vector>
+
+typedef Dune::FieldMatrix<double, 2, 2> Block;
+typedef Dune::BCRSMatrix<Block> Matrix;
+typedef Dune::BlockVector<Dune::FieldVector<double, 2> > Vector;
+static const int lanes = 4;
+typedef Opm::EnsembleMatrix<double, 2, lanes> LaneMatrix;
+typedef Opm::EnsembleVector<double, 2, lanes> LaneVector;
+
+// 1D diffusion with a coupling between the two unknowns, scaled per member.
+void setupMatrix(Matrix& A, int N, double scale)
+{
+    setupTridiagonalPattern(A, N);
+    for ( auto row = A.begin(); row != A.end(); ++row )
+    {
+        for ( auto col = row->begin(); col != row->end(); ++col )
+        {
+            auto& block = *col;
+            block = 0.0;
+            if ( col.index() == row.index() )
+            {
+                block[0][0] = block[1][1] = 2.5 * scale;
+                block[0][1] = 0.3;
+                block[1][0] = -0.2 * scale;
+            }
+            else
+            {
+                block[0][0] = block[1][1] = -scale;
+            }
+        }
+    }
+}
+
+Vector rightHandSide(int N, int member)
+{
+    Vector b(N);
+    for ( int i = 0; i < N; ++i )
+    {
+        b[i][0] = 1.0 + 0.1 * member * i;
+        b[i][1] = (i % 3) - member;
+    }
+    return b;
+}
+
+BOOST_AUTO_TEST_CASE(InterleavedProduct)
+{
+    const int N = 20;
+    std::vector<Matrix> matrices(lanes);
+    std::vector<const Matrix*> pointers;
+    std::vector<Vector> x;
+    for ( int r = 0; r < lanes; ++r )
+    {
+        setupMatrix(matrices[r], N, 1.0 + r);
+        pointers.push_back(&matrices[r]);
+        x.push_back(rightHandSide(N, r));
+    }
+    LaneMatrix A;
+    A.setup(pointers);
+    LaneVector laneX, laneY(N);
+    Opm::interleave<double, 2, lanes>(x, 0, laneX);
+    A.mv(laneX, laneY);
+    std::vector<Vector> y(lanes);
+    Opm::deinterleave<double, 2, lanes>(laneY, 0, y);
+
+    for ( int r = 0; r < lanes; ++r )
+    {
+        Vector expected(N);
+        matrices[r].mv(x[r], expected);
+        for ( int i = 0; i < N; ++i )
+        {
+            for ( int k = 0; k < 2; ++k )
+            {
+                BOOST_CHECK_CLOSE(y[r][i][k], expected[i][k], 1e-12);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(SolveEnsemble)
+{
+    const int N = 50;
+    // fewer members than lanes, the last lane repeats the last matrix
+    const int members = 3;
+    std::vector<Matrix> matrices(members);
+    std::vector<const Matrix*> pointers;
+    std::vector<Vector> b;
+    for ( int r = 0; r < members; ++r )
+    {
+        setupMatrix(matrices[r], N, 1.0 + 0.5 * r);
+        pointers.push_back(&matrices[r]);
+        b.push_back(rightHandSide(N, r));
+    }
+    LaneMatrix A, ilu;
+    A.setup(pointers);
+    ilu.iluDecomposition(pointers);
+
+    LaneVector laneX(N), laneB;
+    laneX = 0.0;
+    Opm::interleave<double, 2, lanes>(b, 0, laneB);
+    Opm::EnsembleBiCGSTAB<double, 2, lanes> solver(A, ilu, 1e-10, 200);
+    const auto result = solver.apply(laneX, laneB);
+    std::vector<Vector> x(members);
+    Opm::deinterleave<double, 2, lanes>(laneX, 0, x);
+
+    for ( int r = 0; r < members; ++r )
+    {
+        BOOST_CHECK(result.converged[r]);
+        BOOST_CHECK(result.reduction[r] <= 1e-10);
+        Vector residual = b[r];
+        matrices[r].mmv(x[r], residual);
+        BOOST_CHECK_SMALL(residual.two_norm(), 1e-8 * b[r].two_norm());
+    }
+    // the lane without a right hand side is zero and converged immediately
+    BOOST_CHECK(result.converged[members]);
+    BOOST_CHECK_EQUAL(result.iterations[members], 0);
+}
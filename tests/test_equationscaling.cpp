@@ -0,0 +1,216 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media Project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE EquationScalingTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/autodiff/EquationScaling.hpp>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+
+#include "SparsityPatternTestHelpers.hpp"
+
+#include <cmath>
+#include <vector>
+
+typedef Dune::FieldMatrix<double, 2, 2> Block;
+typedef Dune::BCRSMatrix<Block> Matrix;
+typedef Dune::BlockVector<Dune::FieldVector<double, 2> > Vector;
+typedef Opm::EquationScaling<Matrix, Vector> Scaling;
+
+const int numCells = 3;
+
+// A chain of three cells, with a pressure unknown of a large magnitude.
+Matrix chainMatrix()
+{
+    Matrix A;
+    setupTridiagonalPattern(A, numCells);
+    for ( int i = 0; i < numCells; ++i )
+    {
+        A[i][i][0][0] = 4e-5 * (1 + i);
+        A[i][i][0][1] = 10.0;
+        A[i][i][1][0] = 2e-6;
+        A[i][i][1][1] = 300.0 - 50.0 * i;
+        for ( int j : { i - 1, i + 1 } )
+        {
+            if ( j < 0 || j >= numCells ) continue;
+            A[i][j][0][0] = -1e-5;
+            A[i][j][1][1] = -20.0;
+        }
+    }
+    return A;
+}
+
+Vector testVector()
+{
+    Vector x(numCells);
+    for ( int i = 0; i < numCells; ++i )
+    {
+        x[i][0] = 1e5 * (1 + i);
+        x[i][1] = 0.1 - 0.05 * i;
+    }
+    return x;
+}
+
+// The wells of the test, y -= W x with a diagonal W.
+struct DiagonalWells
+{
+    void apply(const Vector& x, Vector& y) const
+    {
+        for ( int i = 0; i < numCells; ++i )
+        {
+            y[i][0] -= 2.0 * x[i][0];
+            y[i][1] -= 0.5 * i * x[i][1];
+        }
+    }
+};
+
+const std::vector<double> weights = { 2.0, 0.5 };
+const std::vector<double> poreVolumes = { 100.0, 200.0, 400.0 };
+
+BOOST_AUTO_TEST_CASE(Factors)
+{
+    const Matrix A = chainMatrix();
+    Scaling scaling;
+    scaling.update(A, weights, poreVolumes);
+    for ( int i = 0; i < numCells; ++i )
+    {
+        BOOST_CHECK_CLOSE(scaling.rowScale(i, 0), weights[0] / poreVolumes[i], 1e-12);
+        BOOST_CHECK_CLOSE(scaling.rowScale(i, 1), weights[1] / poreVolumes[i], 1e-12);
+    }
+
+    // the scaled diagonal blocks have a mean magnitude of one in each column
+    Matrix scaled(A);
+    Vector b = testVector();
+    scaling.scaleSystem(scaled, b);
+    for ( int k = 0; k < 2; ++k )
+    {
+        double mean = 0.0;
+        for ( int i = 0; i < numCells; ++i )
+        {
+            mean += std::max(std::abs(scaled[i][i][0][k]), std::abs(scaled[i][i][1][k])) / numCells;
+        }
+        BOOST_CHECK_CLOSE(mean, 1.0, 1e-10);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ScaledProduct)
+{
+    // (R A S) (S^-1 x) = R (A x)
+    const Matrix A = chainMatrix();
+    Scaling scaling;
+    scaling.update(A, weights, poreVolumes);
+    Matrix scaled(A);
+    Vector b = testVector();
+    scaling.scaleSystem(scaled, b);
+
+    const Vector x = testVector();
+    Vector y = x;
+    for ( int i = 0; i < numCells; ++i )
+        for ( int k = 0; k < 2; ++k )
+            y[i][k] /= scaling.columnScale(k);
+    Vector scaledProduct(numCells);
+    scaled.mv(y, scaledProduct);
+    Vector product(numCells);
+    A.mv(x, product);
+    for ( int i = 0; i < numCells; ++i )
+    {
+        for ( int c = 0; c < 2; ++c )
+        {
+            BOOST_CHECK_CLOSE(scaledProduct[i][c], scaling.rowScale(i, c) * product[i][c], 1e-10);
+            BOOST_CHECK_CLOSE(b[i][c], scaling.rowScale(i, c) * x[i][c], 1e-10);
+        }
+    }
+
+    // the solution of the scaled system is mapped back
+    scaling.unscaleSolution(y);
+    for ( int i = 0; i < numCells; ++i )
+        for ( int k = 0; k < 2; ++k )
+            BOOST_CHECK_CLOSE(y[i][k], x[i][k], 1e-10);
+}
+
+BOOST_AUTO_TEST_CASE(ScaledImpesWeights)
+{
+    // the rows of R A S combined with the scaled weights are those of A S
+    // combined with the original weights, e.g. the CPR pressure equation
+    const Matrix A = chainMatrix();
+    Scaling scaling;
+    scaling.update(A, weights, poreVolumes);
+    Matrix scaled(A);
+    Vector b = testVector();
+    scaling.scaleSystem(scaled, b);
+
+    Vector impesWeights(numCells);
+    for ( int i = 0; i < numCells; ++i )
+    {
+        impesWeights[i][0] = 1.0 + 0.3 * i;
+        impesWeights[i][1] = 2.0e-2 / (1 + i);
+    }
+    Vector scaledWeights = impesWeights;
+    scaling.scaleRowWeights(scaledWeights);
+
+    for ( int i = 0; i < numCells; ++i )
+    {
+        for ( int j = std::max(i - 1, 0); j <= std::min(i + 1, numCells - 1); ++j )
+        {
+            for ( int k = 0; k < 2; ++k )
+            {
+                double combined = 0.0;
+                double expected = 0.0;
+                for ( int c = 0; c < 2; ++c )
+                {
+                    combined += scaledWeights[i][c] * scaled[i][j][c][k];
+                    expected += impesWeights[i][c] * A[i][j][c][k] * scaling.columnScale(k);
+                }
+                BOOST_CHECK_CLOSE(combined, expected, 1e-10);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ScaledWells)
+{
+    const Matrix A = chainMatrix();
+    Scaling scaling;
+    scaling.update(A, weights, poreVolumes);
+
+    const Vector y = testVector();
+    Vector result(numCells);
+    result = 1.0;
+    const double alpha = -0.5;
+    scaling.applyWells(DiagonalWells(), alpha, y, result);
+
+    Vector x = y;
+    scaling.unscaleSolution(x);
+    Vector expected(numCells);
+    expected = 0.0;
+    DiagonalWells().apply(x, expected);
+    for ( int i = 0; i < numCells; ++i )
+    {
+        for ( int c = 0; c < 2; ++c )
+        {
+            BOOST_CHECK_CLOSE(result[i][c], 1.0 + alpha * scaling.rowScale(i, c) * expected[i][c], 1e-10);
+        }
+    }
+}
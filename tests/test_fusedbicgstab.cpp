@@ -0,0 +1,126 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media Project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE FusedBiCGSTABTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/autodiff/FusedBiCGSTABSolver.hpp>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/operators.hh>
+#include <dune/istl/preconditioners.hh>
+#include <dune/istl/solvers.hh>
+#include <dune/istl/paamg/pinfo.hh>
+
+#include "SparsityPatternTestHelpers.hpp"
+
+typedef Dune::FieldMatrix<double, 2, 2> Block;
+typedef Dune::BCRSMatrix<Block> Matrix;
+typedef Dune::BlockVector<Dune::FieldVector<double, 2> > Vector;
+
+// Non-symmetric 2D convection-diffusion problem with coupled components.
+void setupProblem(Matrix& A, int N)
+{
+    setupFivePointPattern(A, N);
+    for ( auto row = A.begin(); row != A.end(); ++row )
+    {
+        for ( auto col = row->begin(); col != row->end(); ++col )
+        {
+            *col = 0.0;
+            if ( col.index() == row.index() )
+            {
+                (*col)[0][0] = (*col)[1][1] = 4.5;
+                (*col)[0][1] = 0.3;
+                (*col)[1][0] = -0.2;
+            }
+            else
+            {
+                const double convection = col.index() > row.index() ? 0.3 : -0.3;
+                (*col)[0][0] = (*col)[1][1] = -1.0 + convection;
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(SolvesLikeBiCGSTAB)
+{
+    Matrix A;
+    setupProblem(A, 20);
+    typedef Dune::MatrixAdapter<Matrix, Vector, Vector> Operator;
+    Operator op(A);
+
+    Vector e(A.N()), b(A.N());
+    for ( std::size_t i = 0; i < e.size(); ++i )
+    {
+        e[i][0] = 1.0 + 0.01 * i;
+        e[i][1] = -0.5;
+    }
+    A.mv(e, b);
+
+    const double reduction = 1e-10;
+    Dune::SeqILU0<Matrix, Vector, Vector> prec(A, 1.0);
+
+    Vector x(A.N()), rhs(b);
+    x = 0.0;
+    Dune::Amg::SequentialInformation comm;
+    Opm::FusedBiCGSTABSolver<Vector, Dune::Amg::SequentialInformation> solver(op, prec, comm,
+                                                                             reduction, 200, 0);
+    Dune::InverseOperatorResult res;
+    solver.apply(x, rhs, res);
+    BOOST_CHECK( res.converged );
+    BOOST_CHECK( res.reduction <= reduction );
+
+    Vector error(x);
+    error -= e;
+    BOOST_CHECK_SMALL(error.infinity_norm(), 1e-7);
+
+    // same number of iterations as the standard implementation (up to round-off)
+    Vector x2(A.N()), rhs2(b);
+    x2 = 0.0;
+    Dune::SeqScalarProduct<Vector> sp;
+    Dune::BiCGSTABSolver<Vector> reference(op, sp, prec, reduction, 200, 0);
+    Dune::InverseOperatorResult res2;
+    reference.apply(x2, rhs2, res2);
+    BOOST_CHECK( res2.converged );
+    BOOST_CHECK( std::abs(res.iterations - std::ceil(res2.iterations)) <= 2 );
+}
+
+BOOST_AUTO_TEST_CASE(ZeroRightHandSide)
+{
+    Matrix A;
+    setupProblem(A, 4);
+    Dune::MatrixAdapter<Matrix, Vector, Vector> op(A);
+    Dune::SeqILU0<Matrix, Vector, Vector> prec(A, 1.0);
+    Dune::Amg::SequentialInformation comm;
+    Opm::FusedBiCGSTABSolver<Vector, Dune::Amg::SequentialInformation> solver(op, prec, comm,
+                                                                             1e-8, 10, 0);
+    Vector x(A.N()), b(A.N());
+    x = 0.0;
+    b = 0.0;
+    Dune::InverseOperatorResult res;
+    solver.apply(x, b, res);
+    BOOST_CHECK( res.converged );
+    BOOST_CHECK_EQUAL(res.iterations, 0);
+    BOOST_CHECK_EQUAL(x.two_norm(), 0.0);
+}
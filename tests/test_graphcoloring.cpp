@@ -99,3 +99,110 @@ BOOST_AUTO_TEST_CASE(TestWelschPowell)
                                            graph, 0);
     checkAllIndices(newOrder);
 }
+
+BOOST_AUTO_TEST_CASE(TestReverseCuthillMcKee)
+{
+    using Matrix = Dune::BCRSMatrix<Dune::FieldMatrix<double,1,1>>;
+    using Graph = Dune::Amg::MatrixGraph<Matrix>;
+    // A long and thin grid numbered along the long side first.
+    // This yields a bandwidth of nx.
+    const int nx = 20, ny = 3;
+    Matrix matrix(nx*ny, nx*ny, 5, 0.4, Matrix::implicit);
+    for( int j = 0; j < ny; j++)
+    {
+        for(int i = 0; i < nx; i++)
+        {
+            auto index = j*nx+i;
+            matrix.entry(index,index) = 1;
+            if ( i > 0 )
+            {
+                matrix.entry(index,index-1) = 1;
+            }
+            if ( i  < nx - 1)
+            {
+                matrix.entry(index,index+1) = 1;
+            }
+            if ( j > 0 )
+            {
+                matrix.entry(index,index-nx) = 1;
+            }
+            if ( j  < ny - 1)
+            {
+                matrix.entry(index,index+nx) = 1;
+            }
+        }
+    }
+    matrix.compress();
+
+    Graph graph(matrix);
+    auto newOrder = Opm::reorderVerticesReverseCuthillMcKee(graph);
+    BOOST_CHECK(newOrder.size() == matrix.N());
+    checkAllIndices(newOrder);
+
+    std::size_t bandwidth = 0, newBandwidth = 0;
+    for( auto row = matrix.begin(); row != matrix.end(); ++row )
+    {
+        for( auto col = row->begin(); col != row->end(); ++col )
+        {
+            auto distance = [](std::size_t i, std::size_t j) { return i > j ? i - j : j - i; };
+            bandwidth = std::max(bandwidth, distance(row.index(), col.index()));
+            newBandwidth = std::max(newBandwidth, distance(newOrder[row.index()],
+                                                           newOrder[col.index()]));
+        }
+    }
+    BOOST_CHECK(bandwidth == static_cast<std::size_t>(nx));
+    BOOST_CHECK(newBandwidth <= static_cast<std::size_t>(2*ny));
+}
+
+BOOST_AUTO_TEST_CASE(TestJonesPlassmann)
+{
+    using Matrix = Dune::BCRSMatrix<Dune::FieldMatrix<double,1,1>>;
+    using Graph = Dune::Amg::MatrixGraph<Matrix>;
+    int N = 10;
+    // 9-point stencil, i.e. the graph is not bipartite
+    Matrix matrix(N*N, N*N, 9, 0.4, Matrix::implicit);
+    for( int j = 0; j < N; j++)
+    {
+        for(int i = 0; i < N; i++)
+        {
+            auto index = j*N+i;
+            for( int dj = -1; dj <= 1; dj++)
+            {
+                for( int di = -1; di <= 1; di++)
+                {
+                    if ( i + di >= 0 && i + di < N && j + dj >= 0 && j + dj < N )
+                    {
+                        matrix.entry(index, index + dj*N + di) = 1;
+                    }
+                }
+            }
+        }
+    }
+    matrix.compress();
+
+    Graph graph(matrix);
+    auto colorsTuple = Opm::colorVerticesJonesPlassmann(graph);
+    const auto& colors = std::get<0>(colorsTuple);
+    const auto& verticesPerColor = std::get<2>(colorsTuple);
+    auto noColors = std::get<1>(colorsTuple);
+    BOOST_CHECK(noColors >= 4);
+    BOOST_CHECK(verticesPerColor.size() == static_cast<std::size_t>(noColors));
+    BOOST_CHECK(std::accumulate(verticesPerColor.begin(), verticesPerColor.end(),
+                                std::size_t(0)) == matrix.N());
+
+    // adjacent vertices have different colors
+    for( auto row = matrix.begin(); row != matrix.end(); ++row )
+    {
+        BOOST_CHECK(colors[row.index()] >= 0 && colors[row.index()] < noColors);
+        for( auto col = row->begin(); col != row->end(); ++col )
+        {
+            if ( col.index() != row.index() )
+            {
+                BOOST_CHECK(colors[row.index()] != colors[col.index()]);
+            }
+        }
+    }
+    auto newOrder = Opm::reorderVerticesPreserving(colors, noColors, verticesPerColor,
+                                                   graph);
+    checkAllIndices(newOrder);
+}
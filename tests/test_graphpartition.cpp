@@ -0,0 +1,144 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media Project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE GraphPartitionTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/autodiff/GraphPartition.hpp>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/istl/bcrsmatrix.hh>
+
+#include <algorithm>
+#include <vector>
+
+typedef Dune::BCRSMatrix<Dune::FieldMatrix<double, 1, 1> > Matrix;
+
+// The five-point stencil of an nx x ny grid.
+Matrix gridMatrix(int nx, int ny)
+{
+    const int N = nx * ny;
+    Matrix A(N, N, 5 * N, Matrix::row_wise);
+    for ( auto row = A.createbegin(); row != A.createend(); ++row )
+    {
+        const int i = row.index() % nx;
+        const int j = row.index() / nx;
+        if ( j > 0 ) row.insert(row.index() - nx);
+        if ( i > 0 ) row.insert(row.index() - 1);
+        row.insert(row.index());
+        if ( i < nx - 1 ) row.insert(row.index() + 1);
+        if ( j < ny - 1 ) row.insert(row.index() + nx);
+    }
+    A = 1.0;
+    return A;
+}
+
+BOOST_AUTO_TEST_CASE(ChainIsSplitIntoRanges)
+{
+    const Matrix A = gridMatrix(10, 1);
+    const std::vector<int> part = Opm::partitionMatrixGraph(A, 3);
+    const std::vector<int> expected = { 0, 0, 0, 0, 1, 1, 1, 2, 2, 2 };
+    BOOST_CHECK_EQUAL_COLLECTIONS(part.begin(), part.end(), expected.begin(), expected.end());
+}
+
+BOOST_AUTO_TEST_CASE(BalancedParts)
+{
+    const Matrix A = gridMatrix(17, 13);
+    const int numParts = 7;
+    const std::vector<int> part = Opm::partitionMatrixGraph(A, numParts);
+    std::vector<int> sizes(numParts, 0);
+    for ( const int p : part )
+    {
+        BOOST_REQUIRE(p >= 0 && p < numParts);
+        ++sizes[p];
+    }
+    const auto minmax = std::minmax_element(sizes.begin(), sizes.end());
+    BOOST_CHECK(*minmax.second - *minmax.first <= 1);
+
+    // a single part contains all cells
+    const std::vector<int> single = Opm::partitionMatrixGraph(A, 1);
+    BOOST_CHECK(std::all_of(single.begin(), single.end(), [](int p) { return p == 0; }));
+}
+
+BOOST_AUTO_TEST_CASE(DisconnectedComponents)
+{
+    // two separate chains of 4 cells: 0-1-2-3 and 4-5-6-7
+    Matrix A(8, 8, 14, Matrix::row_wise);
+    for ( auto row = A.createbegin(); row != A.createend(); ++row )
+    {
+        const int i = row.index();
+        if ( i % 4 > 0 ) row.insert(i - 1);
+        row.insert(i);
+        if ( i % 4 < 3 ) row.insert(i + 1);
+    }
+    A = 1.0;
+    const std::vector<int> part = Opm::partitionMatrixGraph(A, 2);
+    const std::vector<int> expected = { 0, 0, 0, 0, 1, 1, 1, 1 };
+    BOOST_CHECK_EQUAL_COLLECTIONS(part.begin(), part.end(), expected.begin(), expected.end());
+
+    BOOST_CHECK_THROW(Opm::partitionMatrixGraph(A, 0), std::logic_error);
+}
+
+BOOST_AUTO_TEST_CASE(WeightedPartsCutWeakConnections)
+{
+    // a 10 x 4 grid whose columns 0-4 and 5-9 are weakly connected
+    const int nx = 10;
+    const Matrix A = gridMatrix(nx, 4);
+    const auto connection = [nx](std::size_t i, std::size_t j)
+    {
+        const std::size_t left = std::min(i % nx, j % nx);
+        const std::size_t right = std::max(i % nx, j % nx);
+        return (left == 4 && right == 5) ? 0.01 : 1.0;
+    };
+    const std::vector<double> uniform(A.N(), 1.0);
+    const std::vector<int> part = Opm::partitionWeightedMatrixGraph(A, 2, uniform, connection);
+    for ( std::size_t cell = 0; cell < A.N(); ++cell )
+    {
+        BOOST_CHECK_EQUAL(part[cell], cell % nx < 5 ? 0 : 1);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(WeightedPartsBalanceCost)
+{
+    // a perforated cell of a chain costs as much as the other cells together
+    const Matrix A = gridMatrix(10, 1);
+    Opm::CellCostModel costModel;
+    costModel.perforationCost = 8.0;
+    std::vector<int> perforations(10, 0);
+    perforations[0] = 1;
+    const std::vector<double> weights = costModel.weights(std::vector<int>(10, 1), perforations, {});
+    BOOST_CHECK_CLOSE(weights[0], 9.0, 1e-12);
+
+    const auto connection = [](std::size_t, std::size_t) { return 1.0; };
+    const std::vector<int> part = Opm::partitionWeightedMatrixGraph(A, 2, weights, connection);
+    const std::vector<int> expected = { 0, 1, 1, 1, 1, 1, 1, 1, 1, 1 };
+    BOOST_CHECK_EQUAL_COLLECTIONS(part.begin(), part.end(), expected.begin(), expected.end());
+
+    // a profile twice as expensive in the second half moves the cut
+    std::vector<double> profile(10, 1.0);
+    std::fill(profile.begin() + 5, profile.end(), 2.0);
+    const std::vector<double> profiled = costModel.weights(std::vector<int>(10, 1), {}, profile);
+    const std::vector<int> profiledPart = Opm::partitionWeightedMatrixGraph(A, 2, profiled, connection);
+    BOOST_CHECK_EQUAL(std::count(profiledPart.begin(), profiledPart.end(), 0), 6);
+
+    BOOST_CHECK_THROW(Opm::partitionWeightedMatrixGraph(A, 2, std::vector<double>(3, 1.0), connection),
+                      std::logic_error);
+}
@@ -71,3 +71,38 @@ BOOST_AUTO_TEST_CASE(Invert4x4)
 
 
 
+
+template<int n>
+void checkBlockMultiply()
+{
+    Dune::MatrixBlock<double, n, n> block;
+    Dune::FieldVector<double, n> x, y, yRef;
+    for (int i = 0; i < n; ++i) {
+        x[i] = i + 1.0;
+        for (int j = 0; j < n; ++j) {
+            block[i][j] = i - 2.0*j + 0.5;
+        }
+    }
+    block.asBase().mv(x, yRef);
+    block.mv(x, y);
+    for (int i = 0; i < n; ++i) {
+        BOOST_CHECK_CLOSE(yRef[i], y[i], 1e-14);
+    }
+    block.umv(x, y);
+    block.asBase().umv(x, yRef);
+    block.mmv(x, y);
+    block.asBase().mmv(x, yRef);
+    block.usmv(0.5, x, y);
+    block.asBase().usmv(0.5, x, yRef);
+    for (int i = 0; i < n; ++i) {
+        BOOST_CHECK_CLOSE(yRef[i], y[i], 1e-14);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(BlockMultiply)
+{
+    checkBlockMultiply<1>();
+    checkBlockMultiply<2>();
+    checkBlockMultiply<3>();
+    checkBlockMultiply<4>();
+}
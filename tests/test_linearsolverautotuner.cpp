@@ -0,0 +1,67 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media Project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE LinearSolverAutoTunerTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/autodiff/LinearSolverAutoTuner.hpp>
+
+BOOST_AUTO_TEST_CASE(CandidatesWithoutDuplicates)
+{
+    Opm::FlowLinearSolverParameters parameters;
+    // The default configuration is ILU0, hence it is not added twice.
+    Opm::LinearSolverAutoTuner tuner(parameters, 2, false);
+    BOOST_CHECK_EQUAL(tuner.candidates().size(), 3u);
+    Opm::LinearSolverAutoTuner tunerCpr(parameters, 2, true);
+    BOOST_CHECK_EQUAL(tunerCpr.candidates().size(), 5u);
+    BOOST_CHECK(tunerCpr.tuning());
+    BOOST_CHECK_EQUAL(tunerCpr.current(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(SelectFastest)
+{
+    Opm::FlowLinearSolverParameters parameters;
+    Opm::LinearSolverAutoTuner tuner(parameters, 2, true);
+    const double seconds[] = { 3.0, 2.0, 1.0, 0.5, 4.0 };
+
+    // first round, the fastest candidate fails to converge
+    for ( std::size_t c = 0; c < 5; ++c )
+    {
+        BOOST_CHECK_EQUAL(tuner.current(), c);
+        BOOST_CHECK(!tuner.report(seconds[c], 10, c != 3));
+    }
+    BOOST_CHECK(tuner.candidates()[3].failed);
+
+    // second round, the failed candidate is skipped
+    const std::size_t order[] = { 0, 1, 2, 4 };
+    for ( std::size_t k = 0; k < 4; ++k )
+    {
+        BOOST_CHECK(tuner.tuning());
+        BOOST_CHECK_EQUAL(tuner.current(), order[k]);
+        BOOST_CHECK_EQUAL(tuner.report(seconds[order[k]], 10, true), k == 3);
+    }
+
+    BOOST_CHECK(!tuner.tuning());
+    BOOST_CHECK_EQUAL(tuner.current(), 2u);
+    BOOST_CHECK(tuner.parameters().ilu_redblack_);
+    BOOST_CHECK(!tuner.report(0.1, 10, true));
+    BOOST_CHECK_EQUAL(tuner.current(), 2u);
+}
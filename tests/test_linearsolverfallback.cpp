@@ -0,0 +1,63 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media Project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE LinearSolverFallbackTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/autodiff/LinearSolverFallback.hpp>
+
+#include <stdexcept>
+
+BOOST_AUTO_TEST_CASE(ParseChain)
+{
+    Opm::FlowLinearSolverParameters parameters;
+    parameters.ilu_fillin_level_ = 2;
+    parameters.linear_solver_recycle_size_ = 5;
+
+    Opm::LinearSolverFallback fallback(parameters, "ilu0, cpr,direct", true);
+    const auto& stages = fallback.stages();
+    BOOST_REQUIRE_EQUAL(stages.size(), 3u);
+    BOOST_CHECK_EQUAL(stages[0].name, "ilu0");
+    BOOST_CHECK_EQUAL(stages[0].parameters.ilu_fillin_level_, 0);
+    BOOST_CHECK_EQUAL(stages[0].parameters.linear_solver_recycle_size_, 0);
+    BOOST_CHECK(!stages[0].parameters.newton_use_gmres_);
+
+    BOOST_CHECK(stages[1].parameters.use_cpr_);
+    BOOST_CHECK(stages[1].parameters.newton_use_gmres_);
+    BOOST_CHECK(!stages[1].parameters.cpr_reuse_setup_);
+    BOOST_CHECK_EQUAL(stages[1].parameters.linear_solver_restart_, 2 * parameters.linear_solver_restart_);
+    BOOST_CHECK_EQUAL(stages[1].parameters.linear_solver_maxiter_, 2 * parameters.linear_solver_maxiter_);
+
+    BOOST_CHECK(!stages[2].parameters.use_cpr_);
+    BOOST_CHECK(stages[2].parameters.linear_solver_direct_max_cells_ > 0);
+    // the reduction is the one of the configuration
+    BOOST_CHECK_EQUAL(stages[2].parameters.linear_solver_reduction_, parameters.linear_solver_reduction_);
+}
+
+BOOST_AUTO_TEST_CASE(CprWithoutAmgAndUnknownStages)
+{
+    Opm::FlowLinearSolverParameters parameters;
+    Opm::LinearSolverFallback withoutCpr(parameters, "cpr", false);
+    BOOST_CHECK(withoutCpr.empty());
+    Opm::LinearSolverFallback none(parameters, "", true);
+    BOOST_CHECK(none.empty());
+    BOOST_CHECK_THROW(Opm::LinearSolverFallback(parameters, "ilu0,amg", true), std::invalid_argument);
+}
@@ -0,0 +1,151 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media Project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE LinearSystemIOTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/autodiff/LinearSystemIO.hpp>
+#include <opm/autodiff/PackedWellContributions.hpp>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+
+#include "SparsityPatternTestHelpers.hpp"
+
+#include <sstream>
+
+typedef Dune::FieldMatrix<double, 2, 2> Block;
+typedef Dune::BCRSMatrix<Block> Matrix;
+typedef Dune::BlockVector<Dune::FieldVector<double, 2> > Vector;
+
+// 1D Laplacian with distinct entries
+void createMatrix(Matrix& A, int N)
+{
+    setupTridiagonalPattern(A, N);
+    for ( auto row = A.begin(); row != A.end(); ++row )
+    {
+        for ( auto col = row->begin(); col != row->end(); ++col )
+        {
+            *col = (row.index() == col.index()) ? 4.0 : -1.0;
+            (*col)[0][1] += 0.1 * row.index() + 0.01 * col.index();
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(MatrixVectorRoundTrip)
+{
+    Matrix A;
+    createMatrix(A, 10);
+    Vector b(10);
+    for ( std::size_t i = 0; i < b.size(); ++i )
+    {
+        b[i][0] = i;
+        b[i][1] = -0.5 * i;
+    }
+
+    std::stringstream stream;
+    Opm::LinearSystemIO::writeHeader(stream, 2);
+    Opm::LinearSystemIO::writeMatrix(stream, A);
+    Opm::LinearSystemIO::writeVector(stream, b);
+
+    Matrix A2;
+    Vector b2;
+    Opm::LinearSystemIO::readHeader(stream, 2);
+    Opm::LinearSystemIO::readMatrix(stream, A2);
+    Opm::LinearSystemIO::readVector(stream, b2);
+
+    BOOST_REQUIRE_EQUAL(A.N(), A2.N());
+    BOOST_REQUIRE_EQUAL(A.nonzeroes(), A2.nonzeroes());
+    for ( auto row = A.begin(); row != A.end(); ++row )
+    {
+        for ( auto col = row->begin(); col != row->end(); ++col )
+        {
+            BOOST_REQUIRE( A2.exists(row.index(), col.index()) );
+            const Block& block2 = A2[row.index()][col.index()];
+            for ( int i = 0; i < 2; ++i )
+                for ( int j = 0; j < 2; ++j )
+                    BOOST_CHECK_EQUAL((*col)[i][j], block2[i][j]);
+        }
+    }
+
+    BOOST_REQUIRE_EQUAL(b.size(), b2.size());
+    for ( std::size_t i = 0; i < b.size(); ++i )
+    {
+        BOOST_CHECK_EQUAL(b[i][0], b2[i][0]);
+        BOOST_CHECK_EQUAL(b[i][1], b2[i][1]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(WrongBlockSizeThrows)
+{
+    std::stringstream stream;
+    Opm::LinearSystemIO::writeHeader(stream, 3);
+    BOOST_CHECK_THROW(Opm::LinearSystemIO::readHeader(stream, 2), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(HeaderGivesBlockSize)
+{
+    std::stringstream stream;
+    Opm::LinearSystemIO::writeHeader(stream, 3);
+    BOOST_CHECK_EQUAL(Opm::LinearSystemIO::readHeader(stream), 3);
+}
+
+BOOST_AUTO_TEST_CASE(WellsRoundTrip)
+{
+    typedef Opm::PackedWellContributions<double, 2, 3> Wells;
+    Wells wells;
+    for ( int w = 0; w < 2; ++w )
+    {
+        Wells::DiagBlock invD(0.0);
+        for ( int i = 0; i < 3; ++i )
+            invD[i][i] = 1.0 + w;
+        wells.beginWell(invD);
+        for ( int perf = 0; perf < 3; ++perf )
+        {
+            Wells::OffDiagBlock B(0.5 * perf + w), C(-0.25 * perf - w);
+            wells.addPerforation(4 * w + perf, B, C);
+        }
+    }
+
+    std::stringstream stream;
+    wells.write(stream);
+    Wells wells2;
+    wells2.read(stream);
+
+    Vector x(10);
+    for ( std::size_t i = 0; i < x.size(); ++i )
+    {
+        x[i][0] = 1.0 + i;
+        x[i][1] = 2.0 - i;
+    }
+    Vector y(10), y2(10);
+    y = 0.0;
+    y2 = 0.0;
+    wells.apply(x, y);
+    wells2.apply(x, y2);
+    for ( std::size_t i = 0; i < y.size(); ++i )
+    {
+        BOOST_CHECK_EQUAL(y[i][0], y2[i][0]);
+        BOOST_CHECK_EQUAL(y[i][1], y2[i][1]);
+    }
+}
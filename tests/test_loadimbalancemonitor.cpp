@@ -0,0 +1,83 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE LoadImbalanceMonitorTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/autodiff/LoadImbalanceMonitor.hpp>
+
+#include <algorithm>
+#include <cstddef>
+
+namespace
+{
+    // Two processes, of which the other one spends factor times the local time.
+    struct TwoProcesses
+    {
+        double factor;
+
+        int size() const
+        {
+            return 2;
+        }
+
+        void sum(double* values, std::size_t n) const
+        {
+            std::for_each(values, values + n, [this](double& v) { v += factor * v; });
+        }
+
+        void max(double* values, std::size_t n) const
+        {
+            std::for_each(values, values + n, [this](double& v) { v = std::max(v, factor * v); });
+        }
+    };
+
+    Opm::SimulatorReport stepReport(double assemble, double linearSolve, double update)
+    {
+        Opm::SimulatorReport report;
+        report.assemble_time = assemble;
+        report.linear_solve_time = linearSolve;
+        report.update_time = update;
+        return report;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ImbalanceOverWindow)
+{
+    Opm::LoadImbalanceMonitor monitor(2, 0.2);
+    const TwoProcesses balanced{ 1.0 };
+    const TwoProcesses imbalanced{ 2.0 };
+
+    BOOST_CHECK(!monitor.endReportStep(balanced, stepReport(1.0, 1.0, 1.0)));
+    BOOST_CHECK_SMALL(monitor.totalImbalance(), 1e-12);
+
+    // the largest time is 2 of a mean of 1.5, but the window is not full yet
+    monitor.reset();
+    BOOST_CHECK(!monitor.endReportStep(imbalanced, stepReport(1.0, 2.0, 0.0)));
+    BOOST_CHECK_CLOSE(monitor.totalImbalance(), 1.0 / 3.0, 1e-10);
+    BOOST_CHECK_CLOSE(monitor.imbalance(Opm::LoadImbalanceMonitor::Assembly), 1.0 / 3.0, 1e-10);
+    BOOST_CHECK_SMALL(monitor.imbalance(Opm::LoadImbalanceMonitor::Update), 1e-12);
+    BOOST_CHECK(monitor.endReportStep(imbalanced, stepReport(1.0, 2.0, 0.0)));
+
+    // a disabled monitor never asks for a repartition
+    Opm::LoadImbalanceMonitor disabled(0, 0.2);
+    BOOST_CHECK(!disabled.endReportStep(imbalanced, stepReport(1.0, 2.0, 0.0)));
+}
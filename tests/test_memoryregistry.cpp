@@ -0,0 +1,61 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media Project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE MemoryRegistryTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/autodiff/MemoryRegistry.hpp>
+
+#include <memory>
+#include <vector>
+
+BOOST_AUTO_TEST_CASE(CurrentAndPeak)
+{
+    auto& entry = Opm::MemoryRegistry::instance().entry("test.accounts");
+    BOOST_CHECK_EQUAL(&entry, &Opm::MemoryRegistry::instance().entry("test.accounts"));
+    {
+        Opm::MemoryAccount first(entry);
+        first.set(1000);
+        std::unique_ptr<Opm::MemoryAccount> second(new Opm::MemoryAccount(entry));
+        second->set(500);
+        BOOST_CHECK_EQUAL(entry.current.load(), 1500);
+
+        // shrinking keeps the peak, a copy accounts for its size again
+        first.set(200);
+        BOOST_CHECK_EQUAL(entry.current.load(), 700);
+        Opm::MemoryAccount copy(first);
+        BOOST_CHECK_EQUAL(entry.current.load(), 900);
+        second.reset();
+        BOOST_CHECK_EQUAL(entry.current.load(), 400);
+        copy = Opm::MemoryAccount(entry);
+        BOOST_CHECK_EQUAL(entry.current.load(), 200);
+    }
+    BOOST_CHECK_EQUAL(entry.current.load(), 0);
+    BOOST_CHECK_EQUAL(entry.peak.load(), 1500);
+}
+
+BOOST_AUTO_TEST_CASE(VectorBytes)
+{
+    std::vector<double> v;
+    v.reserve(16);
+    v.resize(3);
+    BOOST_CHECK_EQUAL(Opm::memoryBytes(v), 16 * sizeof(double));
+}
@@ -191,3 +191,62 @@ BOOST_AUTO_TEST_CASE(MILULaplace4)
 {
     test<4>();
 }
+
+template<int bsize>
+void testUpdate(bool redblack, int n = 0)
+{
+    using Matrix = Dune::BCRSMatrix<Dune::FieldMatrix<double, bsize, bsize> >;
+    using Vector = Dune::BlockVector<Dune::FieldVector<double, bsize> >;
+    using ILU0 = Opm::ParallelOverlappingILU0<Matrix, Vector, Vector>;
+
+    std::size_t N = 16;
+    Matrix A;
+    setupLaplacian(A, N);
+    ILU0 updated(A, n, 1.0, Opm::MILU_VARIANT::ILU, redblack);
+
+    // Change the entries but not the sparsity pattern.
+    for ( auto row = A.begin(), rend = A.end(); row != rend; ++row )
+    {
+        (*row)[row.index()] *= 2.0;
+    }
+    updated.update();
+    ILU0 fresh(A, n, 1.0, Opm::MILU_VARIANT::ILU, redblack);
+
+    Vector d(A.N()), v1(A.N()), v2(A.N());
+    for ( std::size_t i = 0, end = A.N(); i < end; ++i )
+    {
+        d[i] = 1.0 + i;
+    }
+    auto d1 = d;
+    v1 = 0;
+    v2 = 0;
+    updated.apply(v1, d1);
+    fresh.apply(v2, d);
+
+    for ( std::size_t i = 0, end = A.N(); i < end; ++i )
+    {
+        for ( int j = 0; j < bsize; ++j )
+        {
+            BOOST_CHECK_CLOSE(v1[i][j], v2[i][j], 1e-12);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ILU0Update)
+{
+    testUpdate<1>(false);
+    testUpdate<3>(false);
+}
+
+BOOST_AUTO_TEST_CASE(ILU0UpdateRedBlack)
+{
+    testUpdate<1>(true);
+    testUpdate<3>(true);
+}
+
+BOOST_AUTO_TEST_CASE(ILUNUpdateReusesPattern)
+{
+    testUpdate<1>(false, 1);
+    testUpdate<3>(false, 2);
+    testUpdate<3>(true, 1);
+}
@@ -0,0 +1,96 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media Project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE NewtonTraceTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/autodiff/NewtonTrace.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    Opm::NewtonTrace::Record makeRecord(int iteration)
+    {
+        Opm::NewtonTrace::Record record;
+        record.report_step = 2;
+        record.sub_step = 1;
+        record.iteration = iteration;
+        record.dt = 86400.0;
+        record.converged = iteration == 3;
+        record.mass_balance = { 1e-3, 2e-4 };
+        record.cnv = { 0.5, 0.25 };
+        record.well_failures = 1;
+        record.linear_iterations = 12;
+        record.relaxation = 0.9;
+        record.assemble_time = 0.5;
+        record.linear_solve_time = 1.5;
+        record.update_time = 0.125;
+        record.switched_cells = 4;
+        record.chopped_cells = 17;
+        return record;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(Format)
+{
+    std::ostringstream header;
+    Opm::NewtonTrace::writeHeader(header, { "Water", "Oil" });
+    BOOST_CHECK_EQUAL(header.str(), "report_step,sub_step,iteration,dt,converged,mb_Water,mb_Oil,cnv_Water,cnv_Oil,"
+                      "well_failures,linear_iterations,relaxation,assemble_time,linear_solve_time,update_time,switched_cells,chopped_cells\n");
+
+    std::ostringstream line;
+    Opm::NewtonTrace::writeCsv(line, makeRecord(3));
+    BOOST_CHECK_EQUAL(line.str(), "2,1,3,86400,1,0.001,0.0002,0.5,0.25,1,12,0.9,0.5,1.5,0.125,4,17\n");
+}
+
+BOOST_AUTO_TEST_CASE(AllRecordsWritten)
+{
+    const std::string fileName = "newton_trace_test.csv";
+    const int numRecords = 1000;
+    {
+        Opm::NewtonTrace trace(fileName, { "Water", "Oil" });
+        for ( int i = 0; i < numRecords; ++i )
+        {
+            trace.push(makeRecord(i));
+        }
+    }
+
+    std::ifstream file(fileName);
+    std::string line;
+    int lines = 0;
+    while ( std::getline(file, line) )
+    {
+        if ( lines > 0 )
+        {
+            std::ostringstream expected;
+            Opm::NewtonTrace::writeCsv(expected, makeRecord(lines - 1));
+            BOOST_CHECK_EQUAL(line + "\n", expected.str());
+        }
+        ++lines;
+    }
+    BOOST_CHECK_EQUAL(lines, numRecords + 1);
+    std::remove(fileName.c_str());
+}
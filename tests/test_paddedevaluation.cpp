@@ -0,0 +1,118 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media Project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE PaddedEvaluationTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/autodiff/PaddedEvaluation.hpp>
+
+#include <array>
+#include <cmath>
+
+// An expression using all operators and the common functions, for doubles
+// and evaluations alike.
+template <class T>
+T expression(const T& x, const T& y, const T& z)
+{
+    using std::exp;
+    using std::log;
+    using std::sqrt;
+    using std::pow;
+    using std::abs;
+    using Opm::PaddedAd::exp;
+    using Opm::PaddedAd::log;
+    using Opm::PaddedAd::sqrt;
+    using Opm::PaddedAd::pow;
+    using Opm::PaddedAd::abs;
+    T result = (x * y - z / x + 2.0) / (1.5 - y);
+    result += 3.0 * exp(0.1 * x) - log(z) * sqrt(y) + pow(x, 1.7) + pow(2.0, z);
+    result -= abs(y - 2.0 * z) / 4.0 + 1.0 / z;
+    result *= 0.5;
+    return -result;
+}
+
+// Checks the derivatives with respect to variables x, y and z at indices
+// 0, 1 and numDerivs - 1 against central differences.
+template <int numDerivs>
+void checkDerivatives()
+{
+    typedef Opm::PaddedAd::Evaluation<double, numDerivs> Eval;
+    BOOST_CHECK_EQUAL(Eval::length % Opm::PaddedAd::detail::simdWidth<double>(), 0);
+    BOOST_CHECK(Eval::length >= numDerivs + 1);
+
+    const std::array<double, 3> point = {{ 1.3, 0.4, 0.8 }};
+    const std::array<int, 3> index = {{ 0, 1, numDerivs - 1 }};
+    const Eval x = Eval::createVariable(point[0], index[0]);
+    const Eval y = Eval::createVariable(point[1], index[1]);
+    const Eval z = Eval::createVariable(point[2], index[2]);
+
+    const Eval result = expression(x, y, z);
+    BOOST_CHECK_CLOSE(result.value(), expression(point[0], point[1], point[2]), 1e-12);
+
+    const double h = 1e-6;
+    for (int var = 0; var < 3; ++var) {
+        std::array<double, 3> plus = point;
+        std::array<double, 3> minus = point;
+        plus[var] += h;
+        minus[var] -= h;
+        const double difference = (expression(plus[0], plus[1], plus[2])
+                                   - expression(minus[0], minus[1], minus[2])) / (2.0 * h);
+        BOOST_CHECK_CLOSE(result.derivative(index[var]), difference, 1e-6);
+    }
+    for (int i = 0; i < numDerivs; ++i) {
+        if (i != index[0] && i != index[1] && i != index[2]) {
+            BOOST_CHECK_EQUAL(result.derivative(i), 0.0);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(DerivativesOfStandardWellSizes)
+{
+    // three phases with 4 well equations, and with solvent or polymer
+    checkDerivatives<7>();
+    checkDerivatives<9>();
+    // sizes which are a multiple of the SIMD width with the value
+    checkDerivatives<3>();
+    checkDerivatives<11>();
+}
+
+BOOST_AUTO_TEST_CASE(ComparisonsAndToolbox)
+{
+    typedef Opm::PaddedAd::Evaluation<double, 5> Eval;
+    typedef Opm::MathToolbox<Eval> Toolbox;
+    const Eval x = Eval::createVariable(2.0, 1);
+
+    BOOST_CHECK(x > 1.0);
+    BOOST_CHECK(1.0 < x);
+    BOOST_CHECK(x == 2.0);
+    BOOST_CHECK_EQUAL(Toolbox::value(x), 2.0);
+    BOOST_CHECK_EQUAL(Opm::max(x, 3.0).value(), 3.0);
+    BOOST_CHECK_EQUAL(Opm::max(x, 3.0).derivative(1), 0.0);
+    BOOST_CHECK_EQUAL(Opm::max(x, 1.0).derivative(1), 1.0);
+    BOOST_CHECK_EQUAL(Toolbox::createBlank(x).value(), 0.0);
+    BOOST_CHECK(!Toolbox::isnan(x));
+    BOOST_CHECK(Toolbox::isnan(x / 0.0 * 0.0));
+
+    Eval y = x;
+    y = 4.0;
+    BOOST_CHECK_EQUAL(y.value(), 4.0);
+    BOOST_CHECK_EQUAL(y.derivative(1), 0.0);
+}
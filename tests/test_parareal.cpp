@@ -0,0 +1,95 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE PararealTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/simulators/timestepping/Parareal.hpp>
+
+#include <cmath>
+#include <vector>
+
+namespace
+{
+    // y' = -y over intervals of length h
+    const double h = 0.5;
+
+    // one explicit Euler step
+    double coarse(const int /* interval */, const double y)
+    {
+        return (1.0 - h) * y;
+    }
+
+    // the exact solution
+    std::vector<double> fine(const int /* first */, const std::vector<double>& starts)
+    {
+        std::vector<double> results;
+        for (const double y : starts) {
+            results.push_back(std::exp(-h) * y);
+        }
+        return results;
+    }
+
+    double distance(const double a, const double b)
+    {
+        return std::abs(a - b);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ExactAfterIterations)
+{
+    const int numIntervals = 10;
+    for (int iterations = 1; iterations <= 3; ++iterations) {
+        std::vector<double> states(numIntervals + 1, 0.0);
+        states[0] = 1.0;
+        const auto report = Opm::parareal(states, coarse, fine, distance, iterations, 0.0);
+        BOOST_CHECK_EQUAL(report.iterations, iterations);
+        BOOST_CHECK(!report.converged);
+        // the first intervals are the fine solution
+        for (int n = 0; n <= iterations; ++n) {
+            BOOST_CHECK_CLOSE(states[n], std::exp(-h * n), 1e-10);
+        }
+        BOOST_CHECK_GT(std::abs(states[numIntervals] - std::exp(-h * numIntervals)), 1e-10);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(Converges)
+{
+    const int numIntervals = 10;
+    std::vector<double> states(numIntervals + 1, 0.0);
+    states[0] = 1.0;
+    std::vector<int> firsts;
+    auto recordingFine = [&firsts](const int first, const std::vector<double>& starts) {
+        firsts.push_back(first);
+        BOOST_CHECK_EQUAL(starts.size(), static_cast<std::size_t>(numIntervals - first));
+        return fine(first, starts);
+    };
+    const auto report = Opm::parareal(states, coarse, recordingFine, distance, numIntervals, 1e-8);
+    BOOST_CHECK(report.converged);
+    BOOST_CHECK_LT(report.iterations, numIntervals);
+    BOOST_CHECK_LE(report.correction, 1e-8);
+    for (int k = 0; k < report.iterations; ++k) {
+        BOOST_CHECK_EQUAL(firsts[k], k);
+    }
+    for (int n = 0; n <= numIntervals; ++n) {
+        BOOST_CHECK_CLOSE(states[n], std::exp(-h * n), 1e-5);
+    }
+}
@@ -0,0 +1,138 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media Project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE PartitionedPreconditionerTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/autodiff/PartitionedPreconditioner.hpp>
+#include <opm/autodiff/ParallelOverlappingILU0.hpp>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/operators.hh>
+#include <dune/istl/solvers.hh>
+#include <dune/istl/paamg/pinfo.hh>
+
+#include "SparsityPatternTestHelpers.hpp"
+
+typedef Dune::FieldMatrix<double, 3, 3> Block;
+typedef Dune::BCRSMatrix<Block> Matrix;
+typedef Dune::BlockVector<Dune::FieldVector<double, 3> > Vector;
+typedef Dune::BCRSMatrix<Dune::FieldMatrix<double, 2, 2> > FlowMatrix;
+typedef Dune::Amg::SequentialInformation Communication;
+typedef Opm::PartitionedPreconditioner<Matrix, Vector, FlowMatrix, Communication> Partitioned;
+
+// 1D problem: two coupled flow equations and a convected third quantity
+// that depends on the flow unknowns, but does not feed back into them.
+void setupProblem(Matrix& A, int N, double feedback)
+{
+    setupTridiagonalPattern(A, N);
+    for ( auto row = A.begin(); row != A.end(); ++row )
+    {
+        for ( auto col = row->begin(); col != row->end(); ++col )
+        {
+            auto& block = *col;
+            block = 0.0;
+            if ( col.index() == row.index() )
+            {
+                block[0][0] = block[1][1] = 2.5;
+                block[0][1] = 0.4;
+                block[1][0] = -0.3;
+                block[2][0] = 0.2;
+                block[2][2] = 1.5;
+                block[0][2] = feedback;
+            }
+            else
+            {
+                block[0][0] = block[1][1] = -1.0;
+                block[2][2] = col.index() < row.index() ? -1.0 : 0.0;
+                block[2][1] = 0.1;
+            }
+        }
+    }
+}
+
+std::unique_ptr<Partitioned> createPreconditioner(const Matrix& A, const Communication& comm)
+{
+    typedef Partitioned::FlowVector FlowVector;
+    typedef Opm::ParallelOverlappingILU0<FlowMatrix, FlowVector, FlowVector, Communication> FlowILU;
+    auto createILU = [&comm](Partitioned::FlowOperator& op)
+        {
+            return std::unique_ptr<Partitioned::FlowPreconditioner>(new FlowILU(op.getmat(), comm, 1.0,
+                                                                                Opm::MILU_VARIANT::ILU));
+        };
+    return std::unique_ptr<Partitioned>(new Partitioned(A, comm, createILU));
+}
+
+BOOST_AUTO_TEST_CASE(ExactForUncoupledTransport)
+{
+    // The flow block is tridiagonal, hence ILU0 is exact for it. Without
+    // feedback from the third quantity and with its coupling only to upwind
+    // neighbours, one Gauss-Seidel sweep is exact as well.
+    Matrix A;
+    setupProblem(A, 10, 0.0);
+    Communication comm;
+    auto precond = createPreconditioner(A, comm);
+
+    Vector e(A.N()), b(A.N()), v(A.N());
+    for ( std::size_t i = 0; i < e.size(); ++i )
+    {
+        e[i][0] = 1.0 + 0.1 * i;
+        e[i][1] = -0.5;
+        e[i][2] = 0.25 * i;
+    }
+    A.mv(e, b);
+    precond->apply(v, b);
+    v -= e;
+    BOOST_CHECK_SMALL(v.infinity_norm(), 1e-10);
+}
+
+BOOST_AUTO_TEST_CASE(KrylovSolverConverges)
+{
+    Matrix A;
+    setupProblem(A, 50, 0.05);
+    Communication comm;
+    auto precond = createPreconditioner(A, comm);
+
+    Vector e(A.N()), b(A.N()), x(A.N());
+    e = 1.0;
+    A.mv(e, b);
+    x = 0.0;
+
+    Dune::MatrixAdapter<Matrix, Vector, Vector> op(A);
+    Dune::BiCGSTABSolver<Vector> solver(op, *precond, 1e-10, 50, 0);
+    Dune::InverseOperatorResult res;
+    solver.apply(x, b, res);
+    BOOST_CHECK( res.converged );
+    BOOST_CHECK( res.iterations <= 10 );
+    x -= e;
+    BOOST_CHECK_SMALL(x.infinity_norm(), 1e-8);
+
+    // update with new entries
+    A[3][3][2][2] = 3.0;
+    precond->update(A);
+    A.mv(e, b);
+    x = 0.0;
+    solver.apply(x, b, res);
+    BOOST_CHECK( res.converged );
+}
@@ -0,0 +1,133 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media Project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE PerformanceReportTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/core/simulator/PerformanceComparison.hpp>
+#include <opm/core/simulator/PerformanceReport.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace
+{
+    Opm::SimulatorReport stepReport(const double assembleTime, const unsigned newtonIterations)
+    {
+        Opm::SimulatorReport report;
+        report.assemble_time = assembleTime;
+        report.total_newton_iterations = newtonIterations;
+        return report;
+    }
+
+    std::string jsonReport(const double assembleTime, const unsigned newtonIterations, const double calibrationTime)
+    {
+        Opm::PerformanceReport performance;
+        Opm::SimulatorReport step = stepReport(assembleTime, newtonIterations);
+        step.total_linear_iterations = 10 * newtonIterations;
+        performance.addReportStep(0, step, Opm::SimulatorReport());
+        performance.setCalibrationTime(calibrationTime);
+        std::ostringstream os;
+        performance.writeJson(os, { 100.0 });
+        return os.str();
+    }
+}
+
+BOOST_AUTO_TEST_CASE(JsonTotalsAndMemory)
+{
+    Opm::PerformanceReport performance;
+    Opm::SimulatorReport failed = stepReport(0.5, 7);
+    failed.total_failed_steps = 1;
+    performance.addReportStep(0, stepReport(1.0, 3), Opm::SimulatorReport());
+    performance.addReportStep(1, stepReport(2.0, 4), failed);
+
+    std::ostringstream os;
+    performance.writeJson(os, { 100.0, 200.0 });
+    const std::string json = os.str();
+
+    BOOST_CHECK(json.find("\"report_step\": 1") != std::string::npos);
+    BOOST_CHECK(json.find("\"total\": {\n    \"solver_time\": 0,\n    \"assemble_time\": 3,") != std::string::npos);
+    BOOST_CHECK(json.find("\"failed_steps\": 1") != std::string::npos);
+    BOOST_CHECK(json.find("\"failed_newton_iterations\": 7") != std::string::npos);
+    BOOST_CHECK(json.find("\"peak_memory_bytes\": [100, 200]") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(JsonSubsystemMemory)
+{
+    Opm::PerformanceReport performance;
+    performance.addReportStep(0, stepReport(1.0, 3), Opm::SimulatorReport());
+
+    std::ostringstream os;
+    performance.writeJson(os, { 100.0, 200.0 }, { { "jacobian", { 10.0, 20.0 } }, { "wells.state", { 1.0, 2.0 } } });
+    const std::string json = os.str();
+
+    BOOST_CHECK(json.find("\"peak_memory_bytes\": [100, 200],\n") != std::string::npos);
+    BOOST_CHECK(json.find("\"peak_memory_bytes_by_subsystem\": {\n    \"jacobian\": [10, 20],\n"
+                          "    \"wells.state\": [1, 2]\n  }\n}") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(CsvLinePerStep)
+{
+    const std::string fileName = "test_performancereport.csv";
+    {
+        Opm::PerformanceReport performance(fileName);
+        performance.addReportStep(0, stepReport(1.0, 3), Opm::SimulatorReport());
+
+        // the line is written before the end of the run
+        std::ifstream csv(fileName);
+        std::string header, line;
+        std::getline(csv, header);
+        std::getline(csv, line);
+        BOOST_CHECK_EQUAL(header.substr(0, 37), "report_step,solver_time,assemble_time");
+        BOOST_CHECK_EQUAL(line.substr(0, 8), "0,0,1,0,");
+    }
+    std::remove(fileName.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(CompareWithBudgets)
+{
+    // twice the time on a machine of half the speed
+    std::istringstream reference(jsonReport(1.0, 10, 0.01));
+    std::istringstream slowerMachine(jsonReport(2.0, 10, 0.02));
+    const Opm::PerformanceComparison same(reference, slowerMachine, 0.1, 0.25);
+    BOOST_CHECK_EQUAL(same.metrics().size(), 5);
+    BOOST_CHECK(!same.regressed());
+    BOOST_CHECK_CLOSE(same.metrics()[2].reference, 100.0, 1e-10);
+    BOOST_CHECK_CLOSE(same.metrics()[2].value, 100.0, 1e-10);
+
+    // more iterations than the budget, the times are not compared without calibration
+    reference.clear();
+    reference.seekg(0);
+    std::istringstream moreIterations(jsonReport(1.0, 12, 0.0));
+    const Opm::PerformanceComparison worse(reference, moreIterations, 0.1, 0.25);
+    BOOST_CHECK_EQUAL(worse.metrics().size(), 2);
+    BOOST_CHECK(worse.metrics()[0].regressed());
+    BOOST_CHECK(worse.regressed());
+    std::ostringstream os;
+    worse.report(os);
+    BOOST_CHECK(os.str().find("REGRESSED") != std::string::npos);
+
+    std::istringstream invalid("{ \"total\": ");
+    std::istringstream valid(jsonReport(1.0, 10, 0.01));
+    BOOST_CHECK_THROW(Opm::PerformanceComparison(valid, invalid, 0.1, 0.25), std::runtime_error);
+}
@@ -0,0 +1,122 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media Project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE PressureSolverBackendTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/autodiff/PressureSolverBackend.hpp>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/operators.hh>
+#include <dune/istl/paamg/pinfo.hh>
+
+typedef Dune::BCRSMatrix<Dune::FieldMatrix<double, 1, 1> > Matrix;
+typedef Dune::BlockVector<Dune::FieldVector<double, 1> > Vector;
+typedef Dune::MatrixAdapter<Matrix, Vector, Vector> Operator;
+typedef Dune::Amg::SequentialInformation Communication;
+typedef Opm::PressureSolverRegistry<Operator, Vector, Communication> Registry;
+
+// Solves diagonal systems exactly.
+class DiagonalBackend : public Opm::PressureSolverBackend<Vector>
+{
+public:
+    explicit DiagonalBackend(const Operator& op)
+        : op_(op), updates_(0)
+    {}
+
+    void update() override
+    {
+        ++updates_;
+    }
+
+    void apply(Vector& x, Vector& b, Dune::InverseOperatorResult& res) override
+    {
+        const auto& A = op_.getmat();
+        for ( std::size_t i = 0; i < b.size(); ++i )
+        {
+            x[i] = b[i] / A[i][i];
+        }
+        res.converged = true;
+        res.iterations = 1;
+    }
+
+    int updates() const
+    {
+        return updates_;
+    }
+
+private:
+    const Operator& op_;
+    int updates_;
+};
+
+BOOST_AUTO_TEST_CASE(RegisterAndCreate)
+{
+    const int N = 5;
+    Matrix A(N, N, N, Matrix::row_wise);
+    for ( auto row = A.createbegin(); row != A.createend(); ++row )
+    {
+        row.insert(row.index());
+    }
+    for ( int i = 0; i < N; ++i )
+    {
+        A[i][i] = 2.0 + i;
+    }
+    Operator op(A);
+
+    Registry::add("diagonal",
+                  [](const Operator& o, const Communication&, const Opm::CPRParameter&)
+                  {
+                      return std::unique_ptr<Opm::PressureSolverBackend<Vector> >(new DiagonalBackend(o));
+                  });
+    BOOST_CHECK( Registry::contains("diagonal") );
+
+    Opm::CPRParameter param;
+    Communication comm;
+    auto backend = Registry::create("diagonal", op, comm, param);
+
+    Vector x(N), b(N);
+    b = 1.0;
+    x = 0.0;
+    Dune::InverseOperatorResult res;
+    backend->apply(x, b, res);
+    BOOST_CHECK( res.converged );
+    for ( int i = 0; i < N; ++i )
+    {
+        BOOST_CHECK_CLOSE(x[i][0], 1.0 / (2.0 + i), 1e-12);
+    }
+
+    backend->update();
+    BOOST_CHECK_EQUAL(static_cast<DiagonalBackend&>(*backend).updates(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(UnknownBackendThrows)
+{
+    Matrix A;
+    Operator op(A);
+    Opm::CPRParameter param;
+    Communication comm;
+    BOOST_CHECK( !Registry::contains("no-such-solver") );
+    BOOST_CHECK_THROW(Registry::create("no-such-solver", op, comm, param), std::invalid_argument);
+}
@@ -0,0 +1,72 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media Project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE ProcessTimingStatisticsTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/autodiff/ProcessTimingStatistics.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <sstream>
+
+namespace
+{
+    // Two processes, of which the other one spends factor times the local time.
+    struct TwoProcesses
+    {
+        double factor;
+
+        int size() const
+        {
+            return 2;
+        }
+
+        void sum(double* values, std::size_t n) const
+        {
+            std::for_each(values, values + n, [this](double& v) { v += factor * v; });
+        }
+
+        void max(double* values, std::size_t n) const
+        {
+            std::for_each(values, values + n, [this](double& v) { v = std::max(v, factor * v); });
+        }
+    };
+}
+
+BOOST_AUTO_TEST_CASE(MinMeanMaxOfStages)
+{
+    typedef Opm::ProcessTimingStatistics Statistics;
+    Statistics statistics;
+    statistics.compute(TwoProcesses{ 3.0 }, {{ 1.0, 0.5, 2.0, 0.0 }});
+
+    BOOST_CHECK_CLOSE(statistics.min(Statistics::Assembly), 1.0, 1e-10);
+    BOOST_CHECK_CLOSE(statistics.mean(Statistics::Assembly), 2.0, 1e-10);
+    BOOST_CHECK_CLOSE(statistics.max(Statistics::Assembly), 3.0, 1e-10);
+    BOOST_CHECK_CLOSE(statistics.imbalance(Statistics::Assembly), 0.5, 1e-10);
+    BOOST_CHECK_CLOSE(statistics.max(Statistics::Wells), 1.5, 1e-10);
+    BOOST_CHECK_CLOSE(statistics.mean(Statistics::LinearSolve), 4.0, 1e-10);
+    BOOST_CHECK_SMALL(statistics.imbalance(Statistics::CommunicationWait), 1e-12);
+
+    std::ostringstream os;
+    statistics.report(os);
+    BOOST_CHECK(os.str().find("Linear solve") != std::string::npos);
+}
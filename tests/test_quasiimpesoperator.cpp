@@ -0,0 +1,184 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media Project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE QuasiImpesOperatorTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/autodiff/BlackoilAmg.hpp>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/operators.hh>
+#include <dune/istl/paamg/pinfo.hh>
+
+#include "SparsityPatternTestHelpers.hpp"
+
+typedef Dune::FieldMatrix<double, 3, 3> Block;
+typedef Dune::BCRSMatrix<Block> Matrix;
+typedef Dune::BlockVector<Dune::FieldVector<double, 3> > Vector;
+typedef Dune::MatrixAdapter<Matrix, Vector, Vector> Operator;
+typedef Dune::Amg::SequentialInformation Communication;
+typedef Opm::Detail::QuasiImpesOperator<Operator, Communication> ScaledOperator;
+
+// 1D problem with entries that are not exactly representable after scaling.
+void createMatrix(Matrix& A, int N)
+{
+    setupTridiagonalPattern(A, N);
+    for ( auto row = A.begin(); row != A.end(); ++row )
+    {
+        for ( auto col = row->begin(); col != row->end(); ++col )
+        {
+            for ( int i = 0; i < 3; ++i )
+                for ( int j = 0; j < 3; ++j )
+                    (*col)[i][j] = (row.index() == col.index() && i == j ? 5.0 : -0.3)
+                        + 0.1 / (1.0 + row.index() + 3 * i + 7 * j);
+        }
+    }
+}
+
+void checkSameEntries(const Matrix& A, const Matrix& B)
+{
+    auto rowB = B.begin();
+    for ( auto row = A.begin(); row != A.end(); ++row, ++rowB )
+    {
+        auto colB = rowB->begin();
+        for ( auto col = row->begin(); col != row->end(); ++col, ++colB )
+        {
+            for ( int i = 0; i < 3; ++i )
+                for ( int j = 0; j < 3; ++j )
+                    BOOST_CHECK_EQUAL((*col)[i][j], (*colB)[i][j]);
+        }
+    }
+}
+
+void checkScaledOperator(bool inPlace)
+{
+    Matrix A;
+    createMatrix(A, 8);
+    const Matrix original(A);
+    Matrix scaled(A);
+    Opm::Detail::scaleMatrixEntriesQuasiImpes(scaled, 0);
+
+    Communication comm;
+    Operator op(A);
+    ScaledOperator scaledOp(op, comm, 0, inPlace);
+    checkSameEntries(scaledOp.getmat(), scaled);
+
+    scaledOp.restore();
+    checkSameEntries(A, original);
+
+    Vector x(A.N()), y(A.N()), yExpected(A.N());
+    for ( std::size_t i = 0; i < x.size(); ++i )
+    {
+        x[i][0] = 1.0 + i;
+        x[i][1] = -0.5 * i;
+        x[i][2] = 0.25;
+    }
+    scaled.mv(x, yExpected);
+    scaledOp.apply(x, y);
+    for ( std::size_t i = 0; i < y.size(); ++i )
+        for ( int k = 0; k < 3; ++k )
+            BOOST_CHECK_CLOSE(y[i][k], yExpected[i][k], 1e-9);
+
+    y = 1.0;
+    yExpected = 1.0;
+    scaled.usmv(-2.0, x, yExpected);
+    scaledOp.applyscaleadd(-2.0, x, y);
+    for ( std::size_t i = 0; i < y.size(); ++i )
+        for ( int k = 0; k < 3; ++k )
+            BOOST_CHECK_CLOSE(y[i][k], yExpected[i][k], 1e-9);
+
+    // rescaling after the entries changed
+    A[2][2][1][1] += 1.0;
+    scaled = A;
+    Opm::Detail::scaleMatrixEntriesQuasiImpes(scaled, 0);
+    scaledOp.scale(A);
+    checkSameEntries(scaledOp.getmat(), scaled);
+    scaledOp.restore();
+    BOOST_CHECK_EQUAL(A[2][2][1][1], original[2][2][1][1] + 1.0);
+    BOOST_CHECK_EQUAL(A[2][2][0][1], original[2][2][0][1]);
+}
+
+BOOST_AUTO_TEST_CASE(InPlaceScalingRestoresMatrix)
+{
+    checkScaledOperator(true);
+}
+
+BOOST_AUTO_TEST_CASE(ScalingWithCopy)
+{
+    checkScaledOperator(false);
+}
+
+BOOST_AUTO_TEST_CASE(TrueImpesWeights)
+{
+    Matrix A;
+    createMatrix(A, 8);
+
+    // unit weights are the quasi-IMPES weights
+    Vector ones(A.N());
+    ones = 1.0;
+    Matrix quasi(A), weighted(A);
+    Opm::Detail::scaleMatrixEntriesQuasiImpes(quasi, 0);
+    Opm::Detail::scaleMatrixEntriesTrueImpes(weighted, ones, 0);
+    checkSameEntries(weighted, quasi);
+
+    Vector weights(A.N());
+    for ( std::size_t i = 0; i < weights.size(); ++i )
+    {
+        weights[i][0] = 1.0;
+        weights[i][1] = 0.5 + 0.1 * i;
+        weights[i][2] = -0.25;
+    }
+    Matrix scaled(A);
+    Opm::Detail::scaleMatrixEntriesTrueImpes(scaled, weights, 0);
+    const auto& block = A[3][4];
+    const auto& scaledBlock = scaled[3][4];
+    for ( int j = 0; j < 3; ++j )
+    {
+        BOOST_CHECK_CLOSE(scaledBlock[0][j],
+                          block[0][j] + 0.8 * block[1][j] - 0.25 * block[2][j], 1e-12);
+        BOOST_CHECK_EQUAL(scaledBlock[1][j], block[1][j]);
+    }
+
+    const Matrix original(A);
+    Communication comm;
+    Operator op(A);
+    ScaledOperator scaledOp(op, comm, 0, true, &weights);
+    checkSameEntries(scaledOp.getmat(), scaled);
+    scaledOp.restore();
+    checkSameEntries(A, original);
+
+    // the scaled operator applies the same scaling to its result
+    Vector x(A.N()), y(A.N()), yExpected(A.N());
+    for ( std::size_t i = 0; i < x.size(); ++i )
+    {
+        x[i][0] = 1.0 + i;
+        x[i][1] = -0.5 * i;
+        x[i][2] = 0.25;
+    }
+    scaled.mv(x, yExpected);
+    scaledOp.apply(x, y);
+    for ( std::size_t i = 0; i < y.size(); ++i )
+        for ( int k = 0; k < 3; ++k )
+            BOOST_CHECK_CLOSE(y[i][k], yExpected[i][k], 1e-9);
+}
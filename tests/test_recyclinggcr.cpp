@@ -0,0 +1,182 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media Project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE RecyclingGCRTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/autodiff/RecyclingGCRSolver.hpp>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/operators.hh>
+#include <dune/istl/preconditioners.hh>
+#include <dune/istl/paamg/pinfo.hh>
+
+#include "SparsityPatternTestHelpers.hpp"
+
+typedef Dune::FieldMatrix<double, 2, 2> Block;
+typedef Dune::BCRSMatrix<Block> Matrix;
+typedef Dune::BlockVector<Dune::FieldVector<double, 2> > Vector;
+typedef Dune::Amg::SequentialInformation Communication;
+typedef Opm::RecyclingGCRSolver<Vector, Communication> Solver;
+
+// Non-symmetric 2D convection-diffusion problem with coupled components.
+void setupProblem(Matrix& A, int N, double diagonal)
+{
+    setupFivePointPattern(A, N);
+    for ( auto row = A.begin(); row != A.end(); ++row )
+    {
+        for ( auto col = row->begin(); col != row->end(); ++col )
+        {
+            *col = 0.0;
+            if ( col.index() == row.index() )
+            {
+                (*col)[0][0] = (*col)[1][1] = diagonal;
+                (*col)[0][1] = 0.3;
+                (*col)[1][0] = -0.2;
+            }
+            else
+            {
+                const double convection = col.index() > row.index() ? 0.3 : -0.3;
+                (*col)[0][0] = (*col)[1][1] = -1.0 + convection;
+            }
+        }
+    }
+}
+
+void setupSolution(Vector& e)
+{
+    for ( std::size_t i = 0; i < e.size(); ++i )
+    {
+        e[i][0] = 1.0 + 0.01 * i;
+        e[i][1] = -0.5;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(SolvesWithoutRecycledDirections)
+{
+    Matrix A;
+    setupProblem(A, 20, 4.5);
+    Dune::MatrixAdapter<Matrix, Vector, Vector> op(A);
+    Vector e(A.N()), b(A.N());
+    setupSolution(e);
+    A.mv(e, b);
+
+    const double reduction = 1e-10;
+    Dune::SeqILU0<Matrix, Vector, Vector> prec(A, 1.0);
+    Communication comm;
+    Opm::RecycledSubspace<Vector> subspace(10);
+    Solver solver(op, prec, comm, subspace, reduction, 20, 200, 0);
+
+    Vector x(A.N());
+    x = 0.0;
+    Dune::InverseOperatorResult res;
+    solver.apply(x, b, res);
+    BOOST_CHECK( res.converged );
+    BOOST_CHECK( res.reduction <= reduction );
+    BOOST_CHECK_EQUAL(subspace.size(), std::size_t(10));
+
+    Vector error(x);
+    error -= e;
+    BOOST_CHECK_SMALL(error.infinity_norm(), 1e-7);
+}
+
+BOOST_AUTO_TEST_CASE(RecycledDirectionsSaveIterations)
+{
+    Matrix A;
+    setupProblem(A, 20, 4.5);
+    Vector e(A.N()), b(A.N());
+    setupSolution(e);
+    A.mv(e, b);
+    const double reduction = 1e-6;
+    Communication comm;
+
+    // All directions of the first solve are kept. Solving the same system
+    // again only needs the projection onto them.
+    Opm::RecycledSubspace<Vector> subspace(200);
+    {
+        Dune::MatrixAdapter<Matrix, Vector, Vector> op(A);
+        Dune::SeqILU0<Matrix, Vector, Vector> prec(A, 1.0);
+        Solver solver(op, prec, comm, subspace, reduction, 200, 200, 0);
+        Vector x(A.N()), rhs(b);
+        x = 0.0;
+        Dune::InverseOperatorResult res;
+        solver.apply(x, rhs, res);
+        BOOST_CHECK( res.converged );
+        BOOST_CHECK( res.iterations > 1 );
+        BOOST_CHECK_EQUAL(subspace.size(), std::size_t(res.iterations));
+
+        Vector x2(A.N()), rhs2(b);
+        x2 = 0.0;
+        Dune::InverseOperatorResult res2;
+        solver.apply(x2, rhs2, res2);
+        BOOST_CHECK( res2.converged );
+        BOOST_CHECK( res2.iterations <= 1 );
+    }
+
+    // A slightly changed system still profits from the old directions.
+    Matrix A2;
+    setupProblem(A2, 20, 4.55);
+    Vector b2(A2.N());
+    A2.mv(e, b2);
+    Dune::MatrixAdapter<Matrix, Vector, Vector> op2(A2);
+    Dune::SeqILU0<Matrix, Vector, Vector> prec2(A2, 1.0);
+
+    Opm::RecycledSubspace<Vector> empty(200);
+    Solver cold(op2, prec2, comm, empty, reduction, 200, 200, 0);
+    Vector x(A2.N()), rhs(b2);
+    x = 0.0;
+    Dune::InverseOperatorResult resCold;
+    cold.apply(x, rhs, resCold);
+
+    Solver recycling(op2, prec2, comm, subspace, reduction, 200, 200, 0);
+    Vector y(A2.N()), rhs3(b2);
+    y = 0.0;
+    Dune::InverseOperatorResult resRecycled;
+    recycling.apply(y, rhs3, resRecycled);
+    BOOST_CHECK( resCold.converged );
+    BOOST_CHECK( resRecycled.converged );
+    BOOST_CHECK( resRecycled.iterations < resCold.iterations );
+}
+
+BOOST_AUTO_TEST_CASE(ChangedSizeForgetsDirections)
+{
+    Communication comm;
+    Opm::RecycledSubspace<Vector> subspace(5);
+    subspace.directions().push_back(Vector(3));
+    subspace.directions().back() = 1.0;
+
+    Matrix A;
+    setupProblem(A, 4, 4.5);
+    Dune::MatrixAdapter<Matrix, Vector, Vector> op(A);
+    Dune::SeqILU0<Matrix, Vector, Vector> prec(A, 1.0);
+    Solver solver(op, prec, comm, subspace, 1e-8, 10, 100, 0);
+    Vector x(A.N()), b(A.N());
+    x = 0.0;
+    b = 1.0;
+    Dune::InverseOperatorResult res;
+    solver.apply(x, b, res);
+    BOOST_CHECK( res.converged );
+    BOOST_CHECK( subspace.size() <= 5 );
+    BOOST_CHECK_EQUAL(subspace.directions().front().size(), A.N());
+}
@@ -0,0 +1,67 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE TestReductionBatch
+#define BOOST_TEST_NO_MAIN
+
+#include <boost/test/unit_test.hpp>
+
+#include <opm/autodiff/ReductionBatch.hpp>
+#include <dune/common/parallel/mpihelper.hh>
+
+bool
+init_unit_test_func()
+{
+    return true;
+}
+
+BOOST_AUTO_TEST_CASE(SumsAndMaxima)
+{
+    auto cc = Dune::MPIHelper::getCollectiveCommunication();
+    const int size = cc.size();
+    const int rank = cc.rank();
+
+    Opm::ReductionBatch batch;
+    // the indices of the sums and maxima are separate
+    BOOST_CHECK_EQUAL(batch.addSum(1.0), 0u);
+    BOOST_CHECK_EQUAL(batch.addMax(rank), 0u);
+    BOOST_CHECK_EQUAL(batch.addSum(rank), 1u);
+    BOOST_CHECK_EQUAL(batch.addMax(-rank), 1u);
+    batch.begin(cc);
+    batch.end();
+    BOOST_CHECK_EQUAL(batch.sum(0), size);
+    BOOST_CHECK_EQUAL(batch.sum(1), size * (size - 1) / 2);
+    BOOST_CHECK_EQUAL(batch.max(0), size - 1);
+    BOOST_CHECK_EQUAL(batch.max(1), 0.0);
+
+    // the batch can be reused with other values
+    batch.clear();
+    batch.addMax(2.0 * rank);
+    batch.begin(cc);
+    batch.end();
+    BOOST_CHECK_EQUAL(batch.max(0), 2.0 * (size - 1));
+}
+
+int main(int argc, char** argv)
+{
+    Dune::MPIHelper::instance(argc, argv);
+    return boost::unit_test::unit_test_main(&init_unit_test_func, argc, argv);
+}
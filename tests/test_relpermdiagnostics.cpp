@@ -39,6 +39,9 @@
 #include <opm/parser/eclipse/Parser/Parser.hpp>
 #include <opm/parser/eclipse/Deck/Deck.hpp>
 
+#include <numeric>
+#include <vector>
+
 BOOST_AUTO_TEST_SUITE ()
 
 BOOST_AUTO_TEST_CASE(diagnosis)
@@ -56,4 +59,31 @@ BOOST_AUTO_TEST_CASE(diagnosis)
     diagnostics.diagnosis(eclState, deck, grid);
     BOOST_CHECK_EQUAL(1, counterLog->numMessages(Log::MessageType::Warning));
 }
+
+BOOST_AUTO_TEST_CASE(splitDiagnosisAndHash)
+{
+    using namespace Opm;
+    Parser parser;
+
+    Opm::Deck deck = parser.parseFile("../tests/relpermDiagnostics.DATA");
+    EclipseState eclState(deck);
+    GridManager gm(eclState.getInputGrid());
+    const UnstructuredGrid& grid = *gm.c_grid();
+    std::shared_ptr<CounterLog> counterLog = std::make_shared<CounterLog>(Log::DefaultMessageTypes);
+    OpmLog::addBackend( "SPLITCOUNTERLOG" , counterLog );
+
+    // the tables and the cells checked separately give the warnings of diagnosis()
+    RelpermDiagnostics diagnostics;
+    diagnostics.tableDiagnosis(eclState, deck);
+    std::vector<int> cells(grid.number_of_cells);
+    std::iota(cells.begin(), cells.end(), 0);
+    diagnostics.cellDiagnosis(eclState, deck, grid, cells);
+    BOOST_CHECK_EQUAL(1, counterLog->numMessages(Log::MessageType::Warning));
+
+    // the hash only depends on the input
+    Opm::Deck otherDeck = parser.parseFile("../tests/relpermDiagnostics.DATA");
+    EclipseState otherEclState(otherDeck);
+    BOOST_CHECK_EQUAL(RelpermDiagnostics::inputHash(eclState, deck),
+                      RelpermDiagnostics::inputHash(otherEclState, otherDeck));
+}
 BOOST_AUTO_TEST_SUITE_END()
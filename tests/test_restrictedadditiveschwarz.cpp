@@ -0,0 +1,134 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media Project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE RestrictedAdditiveSchwarzTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/autodiff/RestrictedAdditiveSchwarz.hpp>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+#include <dune/istl/paamg/pinfo.hh>
+
+#include "SparsityPatternTestHelpers.hpp"
+
+typedef Dune::FieldMatrix<double, 2, 2> Block;
+typedef Dune::BCRSMatrix<Block> Matrix;
+typedef Dune::BlockVector<Dune::FieldVector<double, 2> > Vector;
+typedef Dune::Amg::SequentialInformation Communication;
+typedef Opm::RestrictedAdditiveSchwarz<Matrix, Vector, Communication> Ras;
+
+// 2D convection-diffusion problem with coupled components.
+void setupProblem(Matrix& A, int N)
+{
+    setupFivePointPattern(A, N);
+    for ( auto row = A.begin(); row != A.end(); ++row )
+    {
+        for ( auto col = row->begin(); col != row->end(); ++col )
+        {
+            *col = 0.0;
+            if ( col.index() == row.index() )
+            {
+                (*col)[0][0] = (*col)[1][1] = 4.5;
+                (*col)[0][1] = 0.3;
+                (*col)[1][0] = -0.2;
+            }
+            else
+            {
+                const double convection = col.index() > row.index() ? 0.3 : -0.3;
+                (*col)[0][0] = (*col)[1][1] = -1.0 + convection;
+            }
+        }
+    }
+}
+
+void checkSameApply(Dune::Preconditioner<Vector, Vector>& ras, Dune::Preconditioner<Vector, Vector>& reference,
+                    std::size_t size)
+{
+    Vector d(size), v(size), w(size);
+    for ( std::size_t i = 0; i < size; ++i )
+    {
+        d[i][0] = 1.0 + 0.1 * i;
+        d[i][1] = -0.5;
+    }
+    v = 0.0;
+    w = 0.0;
+    ras.apply(v, d);
+    reference.apply(w, d);
+    for ( std::size_t i = 0; i < size; ++i )
+    {
+        BOOST_CHECK_CLOSE(v[i][0], w[i][0], 1e-10);
+        BOOST_CHECK_CLOSE(v[i][1], w[i][1], 1e-10);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(SequentialILU0IsILU0)
+{
+    Matrix A;
+    setupProblem(A, 6);
+    Communication comm;
+    Ras ras(A, comm, 1, Opm::RAS_LOCAL_SOLVER::ILU0, 2, 1.0, Opm::MILU_VARIANT::ILU);
+    Opm::ParallelOverlappingILU0<Matrix, Vector, Vector> ilu(A, 0, 1.0, Opm::MILU_VARIANT::ILU);
+    checkSameApply(ras, ilu, A.N());
+}
+
+BOOST_AUTO_TEST_CASE(SequentialILUKIsILUK)
+{
+    Matrix A;
+    setupProblem(A, 6);
+    Communication comm;
+    Ras ras(A, comm, 1, Opm::RAS_LOCAL_SOLVER::ILUK, 1, 1.0, Opm::MILU_VARIANT::ILU);
+    Opm::ParallelOverlappingILU0<Matrix, Vector, Vector> ilu(A, 1, 1.0, Opm::MILU_VARIANT::ILU);
+    checkSameApply(ras, ilu, A.N());
+}
+
+#if HAVE_UMFPACK || HAVE_SUPERLU
+BOOST_AUTO_TEST_CASE(DirectLocalSolverSolves)
+{
+    Matrix A;
+    setupProblem(A, 6);
+    Communication comm;
+    Ras ras(A, comm, 1, Opm::RAS_LOCAL_SOLVER::DIRECT, 0, 1.0, Opm::MILU_VARIANT::ILU);
+
+    Vector e(A.N()), d(A.N()), v(A.N());
+    for ( std::size_t i = 0; i < e.size(); ++i )
+    {
+        e[i][0] = 1.0 + 0.01 * i;
+        e[i][1] = -0.5;
+    }
+    A.mv(e, d);
+    v = 0.0;
+    ras.apply(v, d);
+    v -= e;
+    BOOST_CHECK_SMALL(v.infinity_norm(), 1e-10);
+}
+#endif
+
+BOOST_AUTO_TEST_CASE(ConvertLocalSolver)
+{
+    BOOST_CHECK( Opm::convertString2RasLocalSolver("") == Opm::RAS_LOCAL_SOLVER::ILU0 );
+    BOOST_CHECK( Opm::convertString2RasLocalSolver("ILU0") == Opm::RAS_LOCAL_SOLVER::ILU0 );
+    BOOST_CHECK( Opm::convertString2RasLocalSolver("ILUK") == Opm::RAS_LOCAL_SOLVER::ILUK );
+    BOOST_CHECK( Opm::convertString2RasLocalSolver("Direct") == Opm::RAS_LOCAL_SOLVER::DIRECT );
+    BOOST_CHECK_THROW( Opm::convertString2RasLocalSolver("LU"), std::invalid_argument );
+}
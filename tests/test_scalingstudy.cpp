@@ -0,0 +1,81 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media Project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE ScalingStudyTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/core/simulator/PerformanceReport.hpp>
+#include <opm/core/simulator/ScalingStudy.hpp>
+
+#include <sstream>
+#include <string>
+
+namespace
+{
+    std::string jsonReport(const double solverTime, const double assemblyTime, const double communicationTime)
+    {
+        Opm::PerformanceReport performance;
+        Opm::SimulatorReport step;
+        step.solver_time = solverTime;
+        performance.addReportStep(0, step, Opm::SimulatorReport());
+        performance.setStageTimes({ { "assembly", assemblyTime }, { "wells", 0.0 },
+                                    { "linear_solve", 0.0 }, { "communication", communicationTime } });
+        std::ostringstream os;
+        performance.writeJson(os, { 100.0 });
+        return os.str();
+    }
+}
+
+BOOST_AUTO_TEST_CASE(StrongScaling)
+{
+    Opm::ScalingStudy study(Opm::ScalingStudy::Strong);
+    std::istringstream four(jsonReport(3.0, 1.0, 0.5));
+    std::istringstream one(jsonReport(8.0, 4.0, 0.0));
+    std::istringstream eight(jsonReport(2.0, 0.5, 0.5));
+    study.addRun(2, 2, four);
+    study.addRun(1, 1, one);
+    study.addRun(4, 2, eight);
+
+    BOOST_CHECK_EQUAL(study.stages()[1], "assembly");
+    BOOST_CHECK_CLOSE(study.time(0, 1), 1.0, 1e-12);
+    // against the single core run
+    BOOST_CHECK_CLOSE(study.efficiency(0, 0), 8.0 / (4 * 3.0), 1e-12);
+    BOOST_CHECK_CLOSE(study.efficiency(2, 1), 4.0 / (8 * 0.5), 1e-12);
+    BOOST_CHECK_EQUAL(study.efficiency(0, 4), 0.0);
+
+    std::ostringstream os;
+    study.report(os);
+    BOOST_CHECK(os.str().find("Strong scaling") == 0);
+}
+
+BOOST_AUTO_TEST_CASE(WeakScaling)
+{
+    Opm::ScalingStudy study(Opm::ScalingStudy::Weak);
+    std::istringstream one(jsonReport(8.0, 4.0, 0.0));
+    std::istringstream two(jsonReport(10.0, 4.0, 1.0));
+    study.addRun(1, 1, one);
+    study.addRun(2, 1, two);
+    BOOST_CHECK_CLOSE(study.efficiency(1, 0), 0.8, 1e-12);
+    BOOST_CHECK_CLOSE(study.efficiency(1, 1), 1.0, 1e-12);
+
+    std::istringstream invalid("{");
+    BOOST_CHECK_THROW(study.addRun(4, 1, invalid), std::runtime_error);
+}
@@ -0,0 +1,131 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media Project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE SegmentTreeSolverTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/autodiff/SegmentTreeSolver.hpp>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+
+#include <vector>
+
+namespace
+{
+    const int numWellEq = 3;
+    typedef Dune::FieldMatrix<double, numWellEq, numWellEq> Block;
+    typedef Dune::BCRSMatrix<Block> Matrix;
+    typedef Dune::BlockVector<Dune::FieldVector<double, numWellEq>> Vector;
+    typedef Opm::SegmentTreeSolver<Matrix, Vector> Solver;
+
+    // segment 0 is the top, segment 1 has two inlets (a lateral starts at segment 4)
+    const std::vector<std::vector<int>> inlets = { {1}, {2, 4}, {3}, {}, {5}, {} };
+
+    // couple each segment to its outlet and inlets, and optionally segments a and b
+    Matrix makeMatrix(const int a = -1, const int b = -1)
+    {
+        const int n = inlets.size();
+        std::vector<int> outlet(n, -1);
+        for (int s = 0; s < n; ++s) {
+            for (const int inlet : inlets[s]) {
+                outlet[inlet] = s;
+            }
+        }
+        Matrix D(n, n, Matrix::row_wise);
+        for (auto row = D.createbegin(); row != D.createend(); ++row) {
+            const int s = row.index();
+            row.insert(s);
+            if (outlet[s] >= 0) {
+                row.insert(outlet[s]);
+            }
+            for (const int inlet : inlets[s]) {
+                row.insert(inlet);
+            }
+            if (s == a) {
+                row.insert(b);
+            }
+        }
+        for (auto row = D.begin(); row != D.end(); ++row) {
+            for (auto col = row->begin(); col != row->end(); ++col) {
+                for (int i = 0; i < numWellEq; ++i) {
+                    for (int j = 0; j < numWellEq; ++j) {
+                        (*col)[i][j] = col.index() == row.index()
+                            ? (i == j ? 10.0 + row.index() : 0.5 * (i - j) + 0.1 * row.index())
+                            : 0.3 * (i + 1) - 0.2 * j - 0.05 * col.index();
+                    }
+                }
+            }
+        }
+        return D;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(SolveTree)
+{
+    const Matrix D = makeMatrix();
+    Vector x(D.N());
+    for (std::size_t s = 0; s < x.size(); ++s) {
+        for (int i = 0; i < numWellEq; ++i) {
+            x[s][i] = 1.0 + s - 0.7 * i;
+        }
+    }
+    Vector d(D.N());
+    D.mv(x, d);
+
+    Solver solver;
+    BOOST_REQUIRE(solver.update(D, inlets));
+    BOOST_CHECK(solver.factorized());
+    Vector v(D.N());
+    solver.apply(v, d);
+    for (std::size_t s = 0; s < x.size(); ++s) {
+        for (int i = 0; i < numWellEq; ++i) {
+            BOOST_CHECK_CLOSE(v[s][i], x[s][i], 1e-10);
+        }
+    }
+
+    // the factorization is reused for another right hand side
+    Vector d2(d);
+    d2 *= 2.0;
+    solver.apply(v, d2);
+    for (std::size_t s = 0; s < x.size(); ++s) {
+        for (int i = 0; i < numWellEq; ++i) {
+            BOOST_CHECK_CLOSE(v[s][i], 2.0 * x[s][i], 1e-10);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(RejectNonTree)
+{
+    Solver solver;
+    // a coupling between two branches
+    BOOST_CHECK(!solver.update(makeMatrix(3, 5), inlets));
+    BOOST_CHECK(!solver.factorized());
+
+    // the inlets of segment 2 contain its outlet, no top segment is left
+    const Matrix D = makeMatrix();
+    std::vector<std::vector<int>> cyclic = inlets;
+    cyclic[2].push_back(1);
+    cyclic[3].push_back(0);
+    BOOST_CHECK(!solver.update(D, cyclic));
+}
@@ -0,0 +1,111 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media Project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE SparseDirectSolverTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/autodiff/SparseDirectSolver.hpp>
+
+#include <dune/common/fmatrix.hh>
+#include <dune/common/fvector.hh>
+#include <dune/istl/bcrsmatrix.hh>
+#include <dune/istl/bvector.hh>
+
+#include "SparsityPatternTestHelpers.hpp"
+
+#if HAVE_UMFPACK
+
+typedef Dune::FieldMatrix<double, 2, 2> Block;
+typedef Dune::BCRSMatrix<Block> Matrix;
+typedef Dune::BlockVector<Dune::FieldVector<double, 2> > Vector;
+
+// Nonsymmetric 1D convection-diffusion with coupled unknowns.
+void setupMatrix(Matrix& A, int N, double scale)
+{
+    setupTridiagonalPattern(A, N);
+    for ( auto row = A.begin(); row != A.end(); ++row )
+    {
+        for ( auto col = row->begin(); col != row->end(); ++col )
+        {
+            auto& block = *col;
+            block = 0.0;
+            if ( col.index() == row.index() )
+            {
+                block[0][0] = 3.0 * scale;
+                block[1][1] = 2.5;
+                block[0][1] = 0.5;
+                block[1][0] = -0.7 * scale;
+            }
+            else
+            {
+                block[0][0] = col.index() < row.index() ? -1.5 * scale : -0.5;
+                block[1][1] = -1.0;
+                block[1][0] = 0.2;
+            }
+        }
+    }
+}
+
+void checkSolution(const Matrix& A, Opm::SparseDirectSolver<Matrix, Vector>& solver)
+{
+    Vector b(A.N()), x(A.N());
+    for ( std::size_t i = 0; i < A.N(); ++i )
+    {
+        b[i][0] = 1.0 + i;
+        b[i][1] = (i % 2) ? -1.0 : 2.0;
+    }
+    solver.apply(x, b);
+    Vector residual = b;
+    A.mmv(x, residual);
+    BOOST_CHECK_SMALL(residual.two_norm(), 1e-10 * b.two_norm());
+}
+
+BOOST_AUTO_TEST_CASE(SolvesAndReusesSymbolicFactorization)
+{
+    const int N = 30;
+    Matrix A;
+    setupMatrix(A, N, 1.0);
+    Opm::SparseDirectSolver<Matrix, Vector> solver;
+    solver.update(A);
+    checkSolution(A, solver);
+    BOOST_CHECK_EQUAL(solver.symbolicSetups(), 1);
+
+    // Same pattern, new entries: only the numeric factorization is redone.
+    setupMatrix(A, N, 2.0);
+    solver.update(A);
+    checkSolution(A, solver);
+    BOOST_CHECK_EQUAL(solver.symbolicSetups(), 1);
+
+    // New pattern.
+    Matrix B;
+    setupMatrix(B, N + 5, 1.0);
+    solver.update(B);
+    checkSolution(B, solver);
+    BOOST_CHECK_EQUAL(solver.symbolicSetups(), 2);
+}
+
+#else
+
+BOOST_AUTO_TEST_CASE(NoUmfpack)
+{
+}
+
+#endif // HAVE_UMFPACK
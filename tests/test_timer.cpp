@@ -28,6 +28,8 @@
 #include <opm/parser/eclipse/Deck/Deck.hpp>
 #include <opm/parser/eclipse/Parser/Parser.hpp>
 #include <opm/simulators/timestepping/SimulatorTimer.hpp>
+#include <opm/simulators/timestepping/AdaptiveSimulatorTimer.hpp>
+#include <opm/common/utility/parameters/ParameterGroup.hpp>
 #include <opm/parser/eclipse/Units/Units.hpp>
 
 #include <string>
@@ -113,3 +115,41 @@ BOOST_AUTO_TEST_CASE(CreateTimer)
 
     
 }
+
+
+BOOST_AUTO_TEST_CASE(PlanSubsteps)
+{
+    // a report step of 10 days
+    Opm::ParameterGroup param;
+    param.insertParameter("stepsize_days", "10");
+    Opm::SimulatorTimer simtimer;
+    simtimer.init(param);
+    const double day = Opm::unit::day;
+
+    // a step of 6.4 days growing by 3 leaves a tail step of 3.6 days
+    Opm::AdaptiveSimulatorTimer unplanned(simtimer, 6.4 * day);
+    BOOST_CHECK_CLOSE(unplanned.currentStepLength(), 6.4 * day, 1e-10);
+    ++unplanned;
+    unplanned.provideTimeStepEstimate(19.2 * day);
+    BOOST_CHECK_CLOSE(unplanned.currentStepLength(), 3.6 * day, 1e-10);
+    BOOST_CHECK(!unplanned.tailStepAvoided());
+
+    // the planned substeps are equal
+    Opm::AdaptiveSimulatorTimer planned(simtimer, 1.0 * day, std::numeric_limits<double>::max(), true);
+    planned.setPlanningGrowth(3.0);
+    planned.provideTimeStepEstimate(6.4 * day);
+    BOOST_CHECK_CLOSE(planned.currentStepLength(), 5.0 * day, 1e-10);
+    BOOST_CHECK(planned.tailStepAvoided());
+    ++planned;
+    planned.provideTimeStepEstimate(15.0 * day);
+    BOOST_CHECK_CLOSE(planned.currentStepLength(), 5.0 * day, 1e-10);
+    ++planned;
+    BOOST_CHECK(planned.done());
+
+    // the planning never lengthens a step by more than 5%
+    Opm::AdaptiveSimulatorTimer limited(simtimer, 1.0 * day, std::numeric_limits<double>::max(), true);
+    limited.provideTimeStepEstimate(2.0 * day);
+    BOOST_CHECK_CLOSE(limited.currentStepLength(), 2.0 * day, 1e-10);
+    limited.provideTimeStepEstimate(3.3 * day);
+    BOOST_CHECK_CLOSE(limited.currentStepLength(), 10.0 / 3.0 * day, 1e-10);
+}
@@ -0,0 +1,156 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media Project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE TimeStepControlTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/simulators/timestepping/TimeStepControl.hpp>
+#include <opm/simulators/timestepping/ConvergenceRiskPredictor.hpp>
+
+#include <cmath>
+#include <sstream>
+
+namespace
+{
+    // a small relative change, such that the PID controller does not limit the step size
+    struct SmallChange : public Opm::RelativeChangeInterface
+    {
+        double relativeChange() const
+        {
+            return 1e-6;
+        }
+    };
+
+    // Newton iterations growing quadratically with the step size: the least
+    // time per simulated time is at dt = sqrt(200)
+    double newtonIterations(const double dt)
+    {
+        return 2.0 + 0.01 * dt * dt;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ThroughputOptimum)
+{
+    Opm::ThroughputTimeStepControl control(1e-1, 0.75, 1.25);
+    const SmallChange change;
+
+    double dt = 1.0;
+    for (int step = 0; step < 60; ++step) {
+        const double newton = newtonIterations(dt);
+        const double linear = 10.0 * newton;
+        const double wallTime = 0.1 * newton + 0.01 * linear;
+        control.recordStepCost(dt, true, static_cast<int>(std::round(newton)),
+                               static_cast<int>(std::round(linear)), wallTime);
+        dt = control.computeTimeStepSize(dt, static_cast<int>(std::round(newton)), change, 0.0);
+    }
+    BOOST_CHECK_CLOSE(dt, std::sqrt(200.0), 20.0);
+}
+
+BOOST_AUTO_TEST_CASE(ThroughputGrowthAndFailure)
+{
+    Opm::ThroughputTimeStepControl control(1e-1, 0.75, 1.25);
+    const SmallChange change;
+
+    // without a model the step size grows
+    BOOST_CHECK_CLOSE(control.computeTimeStepSize(1.0, 3, change, 0.0), 1.25, 1e-10);
+    BOOST_CHECK_LT(control.predictedStepTime(1.0), 0.0);
+
+    // with iterations independent of the step size, larger steps are cheaper
+    control.recordStepCost(1.0, true, 3, 30, 1.0);
+    control.recordStepCost(1.25, true, 3, 30, 1.0);
+    BOOST_CHECK_CLOSE(control.predictedStepTime(2.0), 1.0, 1e-8);
+    BOOST_CHECK_CLOSE(control.computeTimeStepSize(1.25, 3, change, 0.0), 1.25 * 1.25, 1e-8);
+
+    // but not beyond a step size that failed recently
+    control.recordStepCost(1.4, false, 20, 400, 5.0);
+    BOOST_CHECK_LT(control.computeTimeStepSize(1.25, 3, change, 0.0), 1.4);
+}
+
+BOOST_AUTO_TEST_CASE(ConvergenceRiskLearning)
+{
+    Opm::ConvergenceRiskPredictor predictor;
+    Opm::ConvergenceRiskPredictor::Features features;
+    features.lastNewtonIterations = 5;
+
+    // the risk grows with the step size, and the largest growth meets the risk
+    features.growth = 1.0;
+    const double risk = predictor.risk(features);
+    features.growth = 2.0;
+    BOOST_CHECK_GT(predictor.risk(features), risk);
+    features.growth = predictor.maxGrowth(features, 0.5);
+    BOOST_CHECK_CLOSE(predictor.risk(features), 0.5, 1e-8);
+
+    // steps which double fail, unchanged steps converge
+    for (int step = 0; step < 500; ++step) {
+        features.growth = 1.0;
+        predictor.update(features, true);
+        features.growth = 2.0;
+        predictor.update(features, false);
+    }
+    const double maxGrowth = predictor.maxGrowth(features, 0.5);
+    BOOST_CHECK_GT(maxGrowth, 1.0);
+    BOOST_CHECK_LT(maxGrowth, 2.0);
+    features.growth = 1.0;
+    BOOST_CHECK_LT(predictor.risk(features), 0.1);
+    features.growth = 2.0;
+    BOOST_CHECK_GT(predictor.risk(features), 0.9);
+}
+
+BOOST_AUTO_TEST_CASE(CheckpointRoundTrip)
+{
+    Opm::ThroughputTimeStepControl control(1e-1, 0.75, 1.25);
+    Opm::ConvergenceRiskPredictor predictor;
+    const SmallChange change;
+    Opm::ConvergenceRiskPredictor::Features features;
+
+    double dt = 1.0;
+    for (int step = 0; step < 10; ++step) {
+        const double newton = newtonIterations(dt);
+        control.recordStepCost(dt, step != 4, static_cast<int>(std::round(newton)), 10, 0.1 * newton);
+        dt = control.computeTimeStepSize(dt, static_cast<int>(std::round(newton)), change, 0.0);
+        features.growth = 1.0 + 0.1 * step;
+        predictor.update(features, step % 3 != 0);
+    }
+
+    std::stringstream checkpoint;
+    control.serialize(checkpoint);
+    predictor.serialize(checkpoint);
+
+    Opm::ThroughputTimeStepControl restored(1e-1, 0.75, 1.25);
+    Opm::ConvergenceRiskPredictor restoredPredictor;
+    restored.deserialize(checkpoint);
+    restoredPredictor.deserialize(checkpoint);
+
+    // the restored controllers continue bit by bit like the original ones
+    for (int step = 0; step < 5; ++step) {
+        control.recordStepCost(dt, true, 3, 10, 0.5);
+        restored.recordStepCost(dt, true, 3, 10, 0.5);
+        const double next = control.computeTimeStepSize(dt, 3, change, 0.0);
+        BOOST_CHECK_EQUAL(restored.computeTimeStepSize(dt, 3, change, 0.0), next);
+        dt = next;
+    }
+    features.growth = 1.5;
+    BOOST_CHECK_EQUAL(restoredPredictor.risk(features), predictor.risk(features));
+
+    // a truncated checkpoint throws
+    std::stringstream truncated(checkpoint.str().substr(0, 5));
+    BOOST_CHECK_THROW(restored.deserialize(truncated), std::runtime_error);
+}
@@ -0,0 +1,90 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media Project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE TraceRecorderTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/autodiff/TimingRegistry.hpp>
+#include <opm/autodiff/TraceRecorder.hpp>
+
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    int count(const std::string& text, const std::string& pattern)
+    {
+        int result = 0;
+        for ( auto pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1) )
+        {
+            ++result;
+        }
+        return result;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(Timeline)
+{
+    auto& recorder = Opm::TraceRecorder::instance();
+    auto& outer = Opm::TimingRegistry::instance().entry("test.outer");
+    auto& inner = Opm::TimingRegistry::instance().entry("test.inner");
+
+    // nothing is recorded unless enabled
+    {
+        Opm::ScopedTiming scopedTiming(outer);
+    }
+    BOOST_CHECK_EQUAL(count(recorder.events(0), "\"ph\":\"X\""), 0);
+
+    recorder.setEnabled(true, 3);
+    {
+        Opm::ScopedTiming scopedOuter(outer);
+        Opm::ScopedTiming scopedInner(inner);
+    }
+    std::thread worker([&inner]() {
+        Opm::ScopedTiming scopedTiming(inner);
+    });
+    worker.join();
+    {
+        // beyond the capacity of the buffer of the first thread
+        Opm::ScopedTiming first(outer);
+        Opm::ScopedTiming second(outer);
+    }
+    recorder.setEnabled(false);
+    // the timings themselves are off
+    BOOST_CHECK_EQUAL(outer.calls, 0);
+
+    const std::string events = recorder.events(2);
+    BOOST_CHECK_EQUAL(count(events, "\"ph\":\"X\""), 4);
+    BOOST_CHECK_EQUAL(count(events, "\"name\":\"test.outer\""), 2);
+    BOOST_CHECK_EQUAL(count(events, "\"name\":\"test.inner\""), 2);
+    BOOST_CHECK_EQUAL(count(events, "\"pid\":2,\"tid\":1"), 1);
+    BOOST_CHECK_EQUAL(count(events, "\"name\":\"rank 2\""), 1);
+    BOOST_CHECK_EQUAL(recorder.dropped(), 1);
+
+    std::ostringstream os;
+    Opm::TraceRecorder::writeTrace(os, { events, std::string(), recorder.events(3) });
+    const std::string trace = os.str();
+    BOOST_CHECK_EQUAL(trace.find("{\"traceEvents\":["), 0);
+    BOOST_CHECK_EQUAL(count(trace, "\"ph\":\"X\""), 8);
+    BOOST_CHECK_EQUAL(count(trace, "}\n,\n{"), 0);
+}
@@ -23,6 +23,7 @@
 #define BOOST_TEST_MODULE VFPTest
 
 #include <algorithm>
+#include <array>
 #include <memory>
 #include <map>
 #include <sstream>
@@ -102,6 +103,79 @@ BOOST_AUTO_TEST_CASE(findInterpData)
     BOOST_CHECK_EQUAL(eval5.factor_, 1.0);
 }
 
+BOOST_AUTO_TEST_CASE(findInterpDataHint)
+{
+    std::vector<double> values = {1, 5, 5, 7, 9, 11, 15};
+    const std::vector<double> points = {-1, 1, 3, 5, 6, 7, 8, 9, 15, 19};
+
+    for (const double value : points) {
+        const Opm::detail::InterpData expected = Opm::detail::findInterpData(value, values);
+        for (int start = -1; start <= static_cast<int>(values.size()); ++start) {
+            int hint = start;
+            const Opm::detail::InterpData eval = Opm::detail::findInterpData(value, values, hint);
+            BOOST_CHECK_EQUAL(eval.ind_[0], expected.ind_[0]);
+            BOOST_CHECK_EQUAL(eval.ind_[1], expected.ind_[1]);
+            BOOST_CHECK_EQUAL(eval.factor_, expected.factor_);
+            BOOST_CHECK_EQUAL(hint, expected.ind_[0]);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(tableIndex)
+{
+    const int a = 1;
+    const int b = 2;
+    std::map<int, const int*> tables = {{2, &a}, {5, &b}};
+
+    const std::vector<const int*> index = Opm::detail::tableIndex(tables);
+    BOOST_CHECK_EQUAL(index.size(), 6);
+
+    BOOST_CHECK(Opm::detail::hasTable(index, 2));
+    BOOST_CHECK(Opm::detail::hasTable(index, 5));
+    BOOST_CHECK(!Opm::detail::hasTable(index, 0));
+    BOOST_CHECK(!Opm::detail::hasTable(index, 3));
+    BOOST_CHECK(!Opm::detail::hasTable(index, 6));
+    BOOST_CHECK(!Opm::detail::hasTable(index, -1));
+
+    BOOST_CHECK_EQUAL(Opm::detail::getTable(index, 2), &a);
+    BOOST_CHECK_EQUAL(Opm::detail::getTable(index, 5), &b);
+    BOOST_CHECK_THROW(Opm::detail::getTable(index, 3), std::invalid_argument);
+    BOOST_CHECK_THROW(Opm::detail::getTable(index, 7), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(findIntersectionForBhp)
+{
+    // a VFP curve with two intersections with the IPR line, the one with
+    // the bigger rate is between the last two samples
+    const std::vector<double> rates = {0.0, -1.0, -2.0, -3.0, -4.0};
+    const std::vector<double> bhps = {5.0, 3.0, 2.0, 3.0, 5.0};
+    const std::array<Opm::detail::RateBhpPair, 2> ipr{ Opm::detail::RateBhpPair{-1.0, 3.5},
+                                                       Opm::detail::RateBhpPair{-2.0, 3.5} };
+
+    int evaluations = 0;
+    auto sample_bhp = [&](const std::size_t i) {
+        ++evaluations;
+        return bhps[i];
+    };
+    double bhp = 0.0;
+    BOOST_CHECK(Opm::detail::findIntersectionForBhp(rates, sample_bhp, ipr, bhp));
+    BOOST_CHECK_CLOSE(bhp, 3.5, 1.0e-10);
+    BOOST_CHECK_EQUAL(evaluations, 2);
+
+    std::vector<Opm::detail::RateBhpPair> samples;
+    for (std::size_t i = 0; i < rates.size(); ++i) {
+        samples.push_back(Opm::detail::RateBhpPair{rates[i], bhps[i]});
+    }
+    double sample_bhp_result = 0.0;
+    BOOST_CHECK(Opm::detail::findIntersectionForBhp(samples, ipr, sample_bhp_result));
+    BOOST_CHECK_EQUAL(sample_bhp_result, bhp);
+
+    // no intersection
+    const std::array<Opm::detail::RateBhpPair, 2> low_ipr{ Opm::detail::RateBhpPair{-1.0, 1.0},
+                                                           Opm::detail::RateBhpPair{-2.0, 1.0} };
+    BOOST_CHECK(!Opm::detail::findIntersectionForBhp(samples, low_ipr, sample_bhp_result));
+}
+
 BOOST_AUTO_TEST_SUITE_END() // HelperTests
 
 
@@ -553,6 +627,83 @@ BOOST_AUTO_TEST_CASE(THPToBHPAndBackNonTrivial)
 
 
 
+/**
+ * Test that a table stored in single precision interpolates as the table in
+ * double precision, up to the rounding of the data
+ */
+BOOST_AUTO_TEST_CASE(InterpolateSinglePrecision)
+{
+    fillDataRandom();
+    initProperties();
+
+    const Opm::VFPProdTable::array_type& data = table->getTable();
+    boost::multi_array<float, 5> single(boost::extents[data.shape()[0]][data.shape()[1]]
+                                                      [data.shape()[2]][data.shape()[3]][data.shape()[4]]);
+    std::transform(data.data(), data.data() + data.num_elements(), single.data(),
+                   [](const double value) { return static_cast<float>(value); });
+
+    const int n = 5;
+    double max_diff = 0.0;
+    for (int i=0; i<=n; ++i) {
+        const double x = (i - 1) / static_cast<double>(n-2);
+        const auto flo_i = Opm::detail::findInterpData(x, table->getFloAxis());
+        const auto thp_i = Opm::detail::findInterpData(1.0 - x, table->getTHPAxis());
+        const auto wfr_i = Opm::detail::findInterpData(0.5 * x, table->getWFRAxis());
+        const auto gfr_i = Opm::detail::findInterpData(x * x, table->getGFRAxis());
+        const auto alq_i = Opm::detail::findInterpData(0.3, table->getALQAxis());
+
+        const VFPEvaluation reference = Opm::detail::interpolate(data, flo_i, thp_i, wfr_i, gfr_i, alq_i);
+        const VFPEvaluation actual = Opm::detail::interpolate(single, flo_i, thp_i, wfr_i, gfr_i, alq_i);
+        max_diff = std::max(max_diff, std::abs(actual.value - reference.value));
+        max_diff = std::max(max_diff, std::abs(actual.dflo - reference.dflo) / (1.0 + std::abs(reference.dflo)));
+    }
+
+    BOOST_CHECK_SMALL(max_diff, 1.0e-5);
+}
+
+
+
+/**
+ * Test that the batched bhp gives the same values as the bhp of each well
+ */
+BOOST_AUTO_TEST_CASE(BatchedBHP)
+{
+    fillDataRandom();
+    initProperties();
+
+    const std::vector<int> table_id = {1, -1, 1, 1};
+    const std::vector<double> aqua = {-0.5, -0.1, -0.3, -0.8};
+    const std::vector<double> liquid = {-0.9, -0.2, -0.7, -0.1};
+    const std::vector<double> vapour = {-0.1, -0.3, -0.6, -0.4};
+    const std::vector<double> thp = {50.0, 10.0, 20.0, 0.5};
+    const std::vector<double> alq = {32.9, 0.0, 1.5, 0.3};
+
+    std::vector<VFPEvaluation> bhp;
+    std::vector<Opm::detail::InterpHint> hints(table_id.size(), Opm::detail::InterpHint());
+    properties->bhp(table_id, aqua, liquid, vapour, thp, alq, bhp, &hints);
+    BOOST_REQUIRE_EQUAL(bhp.size(), table_id.size());
+
+    for (std::size_t w = 0; w < table_id.size(); ++w) {
+        if (table_id[w] < 0) {
+            BOOST_CHECK_EQUAL(bhp[w].value, -1e100);
+            continue;
+        }
+        const VFPEvaluation reference = Opm::detail::bhp(table.get(), aqua[w], liquid[w], vapour[w], thp[w], alq[w]);
+        BOOST_CHECK_EQUAL(bhp[w].value, reference.value);
+        BOOST_CHECK_EQUAL(bhp[w].dthp, reference.dthp);
+        BOOST_CHECK_EQUAL(bhp[w].dwfr, reference.dwfr);
+        BOOST_CHECK_EQUAL(bhp[w].dgfr, reference.dgfr);
+        BOOST_CHECK_EQUAL(bhp[w].dalq, reference.dalq);
+        BOOST_CHECK_EQUAL(bhp[w].dflo, reference.dflo);
+        BOOST_CHECK_EQUAL(bhp[w].value, properties->bhp(1, aqua[w], liquid[w], vapour[w], thp[w], alq[w]));
+    }
+
+    const std::vector<int> missing = {1, 2, 1, 1};
+    BOOST_CHECK_THROW(properties->bhp(missing, aqua, liquid, vapour, thp, alq, bhp), std::invalid_argument);
+}
+
+
+
 
 BOOST_AUTO_TEST_SUITE_END() // Trivial tests
 
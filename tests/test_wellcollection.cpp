@@ -71,6 +71,16 @@ BOOST_AUTO_TEST_CASE(AddWellsAndGroupToCollection) {
     BOOST_CHECK_EQUAL("G1", collection.findNode("INJ2")->getParent()->name());
     BOOST_CHECK_EQUAL("G2", collection.findNode("PROD1")->getParent()->name());
     BOOST_CHECK_EQUAL("G2", collection.findNode("PROD2")->getParent()->name());
+    BOOST_CHECK(collection.findNode("NOSUCHNODE") == NULL);
+
+    // the indices of the wells are their positions among the leaf nodes
+    const auto& leafNodes = collection.getLeafNodes();
+    for (size_t i = 0; i < leafNodes.size(); ++i) {
+        const int index = collection.findWellIndex(leafNodes[i]->name());
+        BOOST_CHECK_EQUAL(static_cast<int>(i), index);
+        BOOST_CHECK_EQUAL(leafNodes[i], &collection.wellNode(index));
+    }
+    BOOST_CHECK_EQUAL(-1, collection.findWellIndex("G1"));
 }
 
 BOOST_AUTO_TEST_CASE(EfficiencyFactor) {
@@ -0,0 +1,81 @@
+/*
+  Copyright 2018 Equinor ASA
+
+  This file is part of the Open Porous Media Project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <config.h>
+
+#define BOOST_TEST_MODULE WellWorkCostTest
+#include <boost/test/unit_test.hpp>
+
+#include <opm/autodiff/WellWorkCost.hpp>
+
+#include <vector>
+
+BOOST_AUTO_TEST_CASE(CostOfWells)
+{
+    const Opm::WellWorkCost model(2.0, 0.5);
+
+    Opm::WellWorkCost::Well standard;
+    standard.cells = {0, 1, 2};
+    BOOST_CHECK_CLOSE(model.cost(standard), 6.0, 1e-12);
+
+    Opm::WellWorkCost::Well multiSegment;
+    multiSegment.cells = {3, 4};
+    multiSegment.segments = 4;
+    multiSegment.iterations = 3.0;
+    BOOST_CHECK_CLOSE(model.cost(multiSegment), 18.0, 1e-12);
+
+    // less than one iteration does not reduce the cost
+    standard.iterations = 0.5;
+    BOOST_CHECK_CLOSE(model.cost(standard), 6.0, 1e-12);
+}
+
+BOOST_AUTO_TEST_CASE(CellWeights)
+{
+    const Opm::WellWorkCost model(1.0, 0.0);
+
+    Opm::WellWorkCost::Well first;
+    first.cells = {1, 2};
+    Opm::WellWorkCost::Well second;
+    second.cells = {2, 4, 5, 6};
+    second.iterations = 2.0;
+    Opm::WellWorkCost::Well inactive;
+
+    const auto weights = model.cellWeights(8, {first, second, inactive});
+    const std::vector<double> expected = {1.0, 2.0, 4.0, 1.0, 3.0, 3.0, 3.0, 1.0};
+    BOOST_REQUIRE_EQUAL(weights.size(), expected.size());
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        BOOST_CHECK_CLOSE(weights[i], expected[i], 1e-12);
+    }
+
+    // the total weight is the number of cells plus the costs of the wells
+    double total = 0.0;
+    for (const double w : weights) {
+        total += w;
+    }
+    BOOST_CHECK_CLOSE(total, 8.0 + model.cost(first) + model.cost(second), 1e-12);
+}
+
+BOOST_AUTO_TEST_CASE(IntegerWeights)
+{
+    const auto weights = Opm::WellWorkCost::integerWeights({1.0, 2.26, 0.0001}, 10);
+    BOOST_REQUIRE_EQUAL(weights.size(), 3u);
+    BOOST_CHECK_EQUAL(weights[0], 10);
+    BOOST_CHECK_EQUAL(weights[1], 23);
+    BOOST_CHECK_EQUAL(weights[2], 1);
+}